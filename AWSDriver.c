@@ -14,23 +14,184 @@
 
 #include "aws_iot_config.h"
 
+#include <ti/net/slnetsock.h>
+#include <ti/net/slnetutils.h>
+
 #include "AWSDriver.h"
+#include "JsonWriter.h"
+
+extern void UART_PRINT(char* label, ...);
 
 void IOT_WARN(char* label, ...) {}
 void IOT_ERROR(char* label, ...) {}
 void IOT_INFO(char* label, ...) {}
 
-static uint32_t publishCount = 0;
+// Topic and QoS of the eventList messages
+#define EVENT_TOPIC                 "sdkTest/sub"
+#define EVENT_QOS                   QOS1
+
+// Pending events, each up to EVENT_MAX_LEN characters
+#define EVENT_QUEUE_DEPTH           32
+#define EVENT_MAX_LEN               47
+
+// Default flush policy
+#define EVENT_FLUSH_MAX_EVENTS      16
+#define EVENT_FLUSH_MAX_LATENCY_MS  1000
+
+// PUBLISH overhead in the TX buffer: fixed header, topic length, packet id
+#define EVENT_PUBLISH_OVERHEAD      (5 + 2 + 2 + sizeof(EVENT_TOPIC) - 1)
+
+// Default payload limit, the largest sent in a single write of the TX buffer.
+// Larger payloads are written into the TX buffer and sent in several parts.
+#define EVENT_PAYLOAD_MAX_LEN       (AWS_IOT_MQTT_TX_BUF_LEN - 1 - EVENT_PUBLISH_OVERHEAD)
+
+// window over which the publish rate is measured
+#define EVENT_RATE_WINDOW_MS        10000
+
+#define NOW_MS()                    ((uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS))
+
+// Loopback UDP port producers signal the AWS task on when a flush is due
+#define WAKE_PORT                   1884
+#define WAKE_LOOPBACK_ADDR          0x7F000001
+
+// Time given to the MQTT client once its socket is readable or a deadline is due
+#define YIELD_MS                    20
+
+// Longest single wait, and the one used if the wake socket could not be opened
+#define WAIT_MAX_MS                 60000
+#define WAIT_NO_WAKE_MS             100
+
+#define WAIT_FOREVER                0xFFFFFFFF
+
+typedef struct
+{
+   uint32_t queuedMs;
+   uint8_t  len;
+   char     text[EVENT_MAX_LEN + 1];
+} pendingEvent_t;
 
 pthread_t awsThread;
 pthread_attr_t pthreadAttrs;
 
+// Ring of pending events. Producers only append behind g_EventCount and the
+// AWS task only consumes from g_EventHead, so the events themselves are read
+// outside of the critical section.
+static pendingEvent_t g_Events[EVENT_QUEUE_DEPTH];
+static uint16_t g_EventHead = 0;
+static uint16_t g_EventCount = 0;
+
+static AWSDriver_FlushPolicy_t g_FlushPolicy =
+{
+   EVENT_FLUSH_MAX_EVENTS,
+   EVENT_PAYLOAD_MAX_LEN,
+   EVENT_FLUSH_MAX_LATENCY_MS
+};
+
+static AWSDriver_PublishStats_t g_PublishStats;
+static uint32_t g_RateWindowStartMs;
+static uint32_t g_RateWindowEvents;
+
+// eventList message length without its events
+static uint16_t g_EventFrameLen;
+
+// wake socket and its generation, producers read both in a critical section
+static int16_t g_WakeSd = -1;
+static uint16_t g_WakeGen;
+static int16_t g_PollSd = -1;
+// MQTT socket registered in the poll set, or waited on with SlNetSock_select
+// if the poll set could not take it
+static int16_t g_PollNetSd = -1;
+static uint16_t g_PollNetGen;
+static bool g_PollNetSelect;
+static AWSDriver_LoopStats_t g_LoopStats;
+
+// time the MQTT socket was found readable, commands are timed from there
+static uint32_t g_NetworkWakeMs;
+
+// object the documents received on EVENT_TOPIC are parsed into, and its handler
+static Json_Handle g_DocObject;
+static AWSDriver_DocumentHandler_t g_DocHandler;
+static int16_t g_DocRc;
+
+/**
+ * @brief Counts a latency in its power of two histogram bucket.
+ */
+static void LatencyRecord(uint32_t* histogram, uint32_t ms)
+{
+   uint8_t bucket = 0;
+
+   while ((bucket < AWSDRIVER_LATENCY_BUCKETS - 1) && (ms >= (1UL << bucket)))
+   {
+      bucket++;
+   }
+   histogram[bucket]++;
+}
+
+/**
+ * @brief Parses a part of a document received on EVENT_TOPIC into the
+ *        application object, which is handed over after the last part.
+ *        A document that fits the MQTT RX buffer comes as a single part.
+ */
+static void DocumentPart(const unsigned char* part, size_t partLen, size_t offset, size_t docLen)
+{
+   Json_Handle object;
+   AWSDriver_DocumentHandler_t handler;
+   int16_t rc;
+
+   taskENTER_CRITICAL();
+   object = g_DocObject;
+   handler = g_DocHandler;
+   taskEXIT_CRITICAL();
+
+   if (handler == NULL)
+   {
+      return;
+   }
+
+   // a document cut short is dropped by the next one
+   if (offset == 0)
+   {
+      g_DocRc = Json_parseStreamBegin(object, 0);
+   }
+   if (g_DocRc == JSON_RC__OK)
+   {
+      g_DocRc = Json_parseStreamFeed(object, (const char*) part, (uint16_t) partLen);
+   }
+
+   if (offset + partLen == docLen)
+   {
+      rc = Json_parseStreamEnd(object, NULL, NULL);
+      handler(object, (g_DocRc == JSON_RC__OK) ? rc : g_DocRc);
+   }
+}
+
+/**
+ * @brief Takes the messages too long for the MQTT RX buffer, a buffer at a time.
+ */
+static void DocumentReader(const char* topicName, uint16_t topicNameLen, const unsigned char* part,
+                           size_t partLen, size_t offset, size_t payloadLen, void* pData)
+{
+   if ((topicNameLen != sizeof(EVENT_TOPIC) - 1) || (memcmp(topicName, EVENT_TOPIC, topicNameLen) != 0))
+   {
+      return;
+   }
+
+   if (offset + partLen == payloadLen)
+   {
+      LatencyRecord(g_LoopStats.commandLatency, NOW_MS() - g_NetworkWakeMs);
+   }
+   DocumentPart(part, partLen, offset, payloadLen);
+}
+
 static void iot_subscribe_callback_handler(AWS_IoT_Client *pClient,
                                            char *topicName, 
                                            uint16_t topicNameLen,
                                            IoT_Publish_Message_Params *params, 
                                            void *pData)
 {
+   LatencyRecord(g_LoopStats.commandLatency, NOW_MS() - g_NetworkWakeMs);
+   DocumentPart(params->payload, params->payloadLen, 0, params->payloadLen);
+
    /*
    IOT_UNUSED(pData);
    IOT_UNUSED(pClient);
@@ -71,6 +232,578 @@ static void disconnectCallbackHandler(AWS_IoT_Client *pClient, void *data)
    }
 }
 
+/**
+ * @brief Counts the oldest pending events that fit in one eventList message.
+ *
+ * @param[in]  pending    - number of pending events
+ * @param[out] payloadLen - length of the message holding them
+ * @return number of events, limited by the flush policy
+ */
+static uint16_t EventsToPack(uint16_t pending, uint16_t* payloadLen)
+{
+   uint16_t count = 0;
+   uint32_t len = g_EventFrameLen;
+
+   while ((count < pending) && (count < g_FlushPolicy.maxEvents))
+   {
+      pendingEvent_t* event = &g_Events[(g_EventHead + count) % EVENT_QUEUE_DEPTH];
+      
+      // quotes, plus the separating comma
+      uint16_t eventLen = event->len + 2 + ((count > 0) ? 1 : 0);
+
+      if (len + eventLen > g_FlushPolicy.maxBytes)
+      {
+         break;
+      }
+      len += eventLen;
+      count++;
+   }
+
+   *payloadLen = (uint16_t) len;
+   return count;
+}
+
+/**
+ * @brief Writes the eventList message of the oldest count pending events.
+ *
+ * Called again for every part of the message the TX buffer takes, so it must
+ * write the same message each time.
+ */
+static void EventsWrite(JsonWriter_t* writer, uint16_t count)
+{
+   JsonWriter_ObjectBegin(writer, NULL);
+   JsonWriter_String(writer, "method", "event", sizeof("event") - 1);
+   JsonWriter_String(writer, "collectorGroupName", "WiFiTest", sizeof("WiFiTest") - 1);
+   JsonWriter_String(writer, "collectorId", "000102030405", sizeof("000102030405") - 1);
+   JsonWriter_String(writer, "deviceId", AWS_IOT_MQTT_CLIENT_ID, sizeof(AWS_IOT_MQTT_CLIENT_ID) - 1);
+
+   JsonWriter_ArrayBegin(writer, "eventList");
+   for (uint16_t i = 0; i < count; i++)
+   {
+      pendingEvent_t* event = &g_Events[(g_EventHead + i) % EVENT_QUEUE_DEPTH];
+
+      JsonWriter_String(writer, NULL, event->text, event->len);
+   }
+   JsonWriter_ArrayEnd(writer);
+
+   JsonWriter_String(writer, "gatewayGroupName", "WiFiTest", sizeof("WiFiTest") - 1);
+   JsonWriter_String(writer, "gatewayId", "441a667801ff", sizeof("441a667801ff") - 1);
+   JsonWriter_ObjectEnd(writer);
+}
+
+/**
+ * @brief Writes the part of the eventList message the TX buffer has room for.
+ */
+static size_t EventsWritePart(unsigned char* pBuf, size_t bufLen, size_t offset, void* pData)
+{
+   JsonWriter_t writer;
+
+   JsonWriter_Init(&writer, (char *) pBuf, bufLen, offset);
+   EventsWrite(&writer, *(uint16_t *) pData);
+
+   g_PublishStats.payloadParts++;
+   return JsonWriter_Len(&writer);
+}
+
+/**
+ * @brief Publishes the pending events as long as the flush policy calls for it.
+ *
+ * Events stay pending until their publish succeeded.
+ */
+static IoT_Error_t EventsFlush(AWS_IoT_Client* pClient)
+{
+   IoT_Publish_Message_Params params;
+   IoT_Error_t rc = SUCCESS;
+
+   params.qos = EVENT_QOS;
+   params.isRetained = 0;
+   params.payload = NULL;
+
+   while (SUCCESS == rc)
+   {
+      uint16_t pending;
+      uint16_t payloadLen;
+
+      taskENTER_CRITICAL();
+      pending = g_EventCount;
+      taskEXIT_CRITICAL();
+
+      if (pending == 0)
+      {
+         break;
+      }
+
+      uint16_t count = EventsToPack(pending, &payloadLen);
+      uint32_t age = NOW_MS() - g_Events[g_EventHead].queuedMs;
+
+      // publish a full message, or whatever is pending once the oldest event is due
+      if ((count < g_FlushPolicy.maxEvents) && (count == pending) &&
+          (age < g_FlushPolicy.maxLatencyMs))
+      {
+         break;
+      }
+
+      if (count == 0)
+      {
+         // cannot fit even a single event within maxBytes
+         count = 1;
+         g_PublishStats.eventsDropped++;
+      }
+      else
+      {
+         params.payloadLen = payloadLen;
+
+         rc = aws_iot_mqtt_publish_with_writer(pClient, EVENT_TOPIC, sizeof(EVENT_TOPIC) - 1, &params,
+                                               EventsWritePart, &count);
+         if (rc == MQTT_REQUEST_TIMEOUT_ERROR)
+         {
+            IOT_WARN("QOS1 publish ack not received.\n");
+         }
+         if (SUCCESS != rc)
+         {
+            g_PublishStats.publishErrors++;
+            break;
+         }
+
+         uint32_t now = NOW_MS();
+         for (uint16_t i = 0; i < count; i++)
+         {
+            LatencyRecord(g_LoopStats.publishLatency,
+                          now - g_Events[(g_EventHead + i) % EVENT_QUEUE_DEPTH].queuedMs);
+         }
+
+         g_PublishStats.publishes++;
+         g_PublishStats.eventsPublished += count;
+         g_PublishStats.payloadBytes += params.payloadLen;
+         g_PublishStats.bytesPerEvent = g_PublishStats.payloadBytes / g_PublishStats.eventsPublished;
+         g_RateWindowEvents += count;
+      }
+
+      taskENTER_CRITICAL();
+      g_EventHead = (g_EventHead + count) % EVENT_QUEUE_DEPTH;
+      g_EventCount -= count;
+      taskEXIT_CRITICAL();
+   }
+
+   uint32_t windowMs = NOW_MS() - g_RateWindowStartMs;
+   if (windowMs >= EVENT_RATE_WINDOW_MS)
+   {
+      g_PublishStats.eventsPerSec = (g_RateWindowEvents * 1000) / windowMs;
+      g_RateWindowEvents = 0;
+      g_RateWindowStartMs += windowMs;
+   }
+
+   return rc;
+}
+
+/**
+ * @brief Returns the time until the flush policy calls for a publish.
+ */
+static uint32_t EventsFlushDueMs(void)
+{
+   uint16_t pending;
+   uint16_t payloadLen;
+
+   taskENTER_CRITICAL();
+   pending = g_EventCount;
+   taskEXIT_CRITICAL();
+
+   if (pending == 0)
+   {
+      return WAIT_FOREVER;
+   }
+
+   uint16_t count = EventsToPack(pending, &payloadLen);
+   uint32_t age = NOW_MS() - g_Events[g_EventHead].queuedMs;
+
+   if ((count == g_FlushPolicy.maxEvents) || (count < pending) ||
+       (age >= g_FlushPolicy.maxLatencyMs))
+   {
+      return 0;
+   }
+
+   return g_FlushPolicy.maxLatencyMs - age;
+}
+
+/**
+ * @brief Opens the poll set the AWS task waits on, and the loopback socket
+ * AWSDriver_QueueEvent wakes it with, on the interfaces of ifBitmap.
+ */
+static void WakeOpen(uint32_t ifBitmap)
+{
+   SlNetSock_AddrIn_t localAddr;
+   int16_t wakeSd;
+   int32_t status;
+
+   if (g_PollSd < 0)
+   {
+      g_PollSd = SlNetSock_pollCreate();
+      if (g_PollSd < 0)
+      {
+         IOT_WARN("Poll set failed, yielding every loop");
+         return;
+      }
+   }
+
+   wakeSd = SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_DGRAM, SLNETSOCK_PROTO_UDP, ifBitmap, 0);
+   if (wakeSd < 0)
+   {
+      IOT_WARN("Wake socket failed, polling every %d ms", WAIT_NO_WAKE_MS);
+      return;
+   }
+
+   memset(&localAddr, 0, sizeof(localAddr));
+   localAddr.sin_family = SLNETSOCK_AF_INET;
+   localAddr.sin_port = SlNetUtil_htons(WAKE_PORT);
+   localAddr.sin_addr.s_addr = 0;
+
+   if (SlNetSock_bind(wakeSd, (SlNetSock_Addr_t *) &localAddr, sizeof(localAddr)) < 0)
+   {
+      IOT_WARN("Wake socket bind failed, polling every %d ms", WAIT_NO_WAKE_MS);
+      SlNetSock_close(wakeSd);
+      return;
+   }
+
+   status = SlNetSock_pollCtl(g_PollSd, wakeSd, SLNETSOCK_POLL_IN);
+   if (status < 0)
+   {
+      UART_PRINT("Wake socket not in the poll set (%d), polling every %d ms\n\r", status, WAIT_NO_WAKE_MS);
+      SlNetSock_close(wakeSd);
+      return;
+   }
+
+   // producers signal it from here on
+   taskENTER_CRITICAL();
+   g_WakeSd = wakeSd;
+   SlNetSock_getGeneration(wakeSd, &g_WakeGen);
+   taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Closes the wake socket, which also takes it out of the poll set.
+ */
+static void WakeClose(void)
+{
+   int16_t wakeSd = g_WakeSd;
+
+   // producers stop signalling it first
+   taskENTER_CRITICAL();
+   g_WakeSd = -1;
+   taskEXIT_CRITICAL();
+   SlNetSock_close(wakeSd);
+}
+
+/**
+ * @brief Signals the AWS task from a producer.
+ *
+ * The AWS task may close the wake socket meanwhile, and its descriptor be
+ * given to another socket. The send is made only while the descriptor still
+ * names the wake socket of the snapshot.
+ */
+static void WakeSignal(void)
+{
+   SlNetSock_AddrIn_t wakeAddr;
+   uint8_t wake = 0;
+   int16_t wakeSd;
+   uint16_t wakeGen;
+
+   taskENTER_CRITICAL();
+   wakeSd = g_WakeSd;
+   wakeGen = g_WakeGen;
+   taskEXIT_CRITICAL();
+
+   if ((wakeSd < 0) || (SlNetSock_checkGeneration(wakeSd, wakeGen) != 0))
+   {
+      return;
+   }
+
+   memset(&wakeAddr, 0, sizeof(wakeAddr));
+   wakeAddr.sin_family = SLNETSOCK_AF_INET;
+   wakeAddr.sin_port = SlNetUtil_htons(WAKE_PORT);
+   wakeAddr.sin_addr.s_addr = SlNetUtil_htonl(WAKE_LOOPBACK_ADDR);
+
+   SlNetSock_sendTo(wakeSd, &wake, sizeof(wake), 0, (SlNetSock_Addr_t *) &wakeAddr, sizeof(wakeAddr));
+}
+
+/**
+ * @brief Registers a new MQTT socket in the poll set.
+ *
+ * A poll set only watches the sockets of one interface. If the MQTT socket
+ * is on another interface than the wake socket, the wake socket is opened
+ * again on the interface of the MQTT socket.
+ *
+ * @return false if the poll set can't take the MQTT socket, it is then
+ * waited on with SlNetSock_select
+ */
+static bool PollRegister(int16_t netSd)
+{
+   int32_t ifID;
+   int32_t status;
+
+   status = SlNetSock_pollCtl(g_PollSd, netSd, SLNETSOCK_POLL_IN | SLNETSOCK_POLL_ERR);
+   ifID = SlNetSock_getIfID(netSd);
+   if ((status == SLNETERR_RET_CODE_INVALID_INPUT) && (g_WakeSd >= 0) &&
+       (ifID > 0) && (ifID != SlNetSock_getIfID(g_WakeSd)))
+   {
+      UART_PRINT("MQTT socket on interface %d, moving the wake socket to it\n\r", ifID);
+
+      WakeClose();
+      status = SlNetSock_pollCtl(g_PollSd, netSd, SLNETSOCK_POLL_IN | SLNETSOCK_POLL_ERR);
+      WakeOpen((uint32_t) ifID);
+   }
+
+   if (status < 0)
+   {
+      UART_PRINT("MQTT socket not in the poll set (%d), waiting on it with select\n\r", status);
+      return false;
+   }
+
+   return true;
+}
+
+/**
+ * @brief Waits up to waitMs for the MQTT socket to become readable, without
+ * the poll set.
+ *
+ * @return true if the MQTT socket is readable, or the select failed
+ */
+static bool SelectNetwork(int16_t netSd, uint32_t waitMs)
+{
+   SlNetSock_SdSet_t readSds;
+   SlNetSock_Timeval_t tv;
+
+   SlNetSock_sdsClrAll(&readSds);
+   SlNetSock_sdsSet(netSd, &readSds);
+
+   tv.tv_sec = waitMs / 1000;
+   tv.tv_usec = (waitMs % 1000) * 1000;
+
+   // a failure is left to the MQTT client, as with the poll set
+   return (SlNetSock_select(netSd + 1, &readSds, NULL, NULL, &tv) != 0);
+}
+
+/**
+ * @brief Blocks until the MQTT client or the publish pipeline has work.
+ *
+ * Waits for the MQTT socket to become readable, for a producer to signal
+ * the wake socket or for the earliest of the flush, keepalive and reconnect
+ * deadlines, whichever comes first.
+ *
+ * @return true if the MQTT client is to be serviced
+ */
+static bool WaitForWork(AWS_IoT_Client* pClient)
+{
+   SlNetSock_PollEvent_t events[2];
+   SlNetSock_Timeval_t tv;
+   uint32_t waitMs = EventsFlushDueMs();
+   uint32_t clientMs = WAIT_FOREVER;
+   int16_t netSd = -1;
+   bool network = false;
+
+   if (g_PollSd < 0)
+   {
+      return true;
+   }
+
+   if (CLIENT_STATE_PENDING_RECONNECT == aws_iot_mqtt_get_client_state(pClient))
+   {
+      clientMs = left_ms(&pClient->reconnectDelayTimer);
+   }
+   else
+   {
+      TLSDataParams* tlsDataParams = &pClient->networkStack.tlsDataParams;
+
+      // bytes already read ahead from the socket won't make it readable
+      if ((tlsDataParams->skt >= 0) && (tlsDataParams->rxLen > tlsDataParams->rxOffset))
+      {
+         g_LoopStats.wakeNetwork++;
+         g_NetworkWakeMs = NOW_MS();
+         return true;
+      }
+
+      // the BSD descriptor is the SlNetSock descriptor
+      netSd = tlsDataParams->skt;
+      if (pClient->clientData.keepAliveInterval != 0)
+      {
+         clientMs = left_ms(&pClient->pingTimer);
+      }
+   }
+
+   if (clientMs < waitMs)
+   {
+      waitMs = clientMs;
+   }
+
+   // a new MQTT socket, or a reconnect that got the same descriptor back
+   if ((netSd >= 0) &&
+       ((netSd != g_PollNetSd) || (SlNetSock_checkGeneration(netSd, g_PollNetGen) != 0)))
+   {
+      // a closed MQTT socket left the poll set already
+      if ((g_PollNetSd >= 0) && !g_PollNetSelect)
+      {
+         SlNetSock_pollCtl(g_PollSd, g_PollNetSd, 0);
+      }
+      g_PollNetSd = netSd;
+      SlNetSock_getGeneration(netSd, &g_PollNetGen);
+      g_PollNetSelect = !PollRegister(netSd);
+   }
+
+   // without the wake socket in the wait, queued events are looked at often
+   if (waitMs > (((g_WakeSd < 0) || g_PollNetSelect) ? WAIT_NO_WAKE_MS : WAIT_MAX_MS))
+   {
+      waitMs = ((g_WakeSd < 0) || g_PollNetSelect) ? WAIT_NO_WAKE_MS : WAIT_MAX_MS;
+   }
+
+   if (waitMs == 0)
+   {
+      g_LoopStats.wakeDeadline++;
+      return (clientMs == 0);
+   }
+
+   if ((netSd >= 0) && g_PollNetSelect)
+   {
+      if (SelectNetwork(netSd, waitMs))
+      {
+         g_LoopStats.wakeNetwork++;
+         g_NetworkWakeMs = NOW_MS();
+         return true;
+      }
+      g_LoopStats.wakeDeadline++;
+      return (waitMs == clientMs);
+   }
+
+   tv.tv_sec = waitMs / 1000;
+   tv.tv_usec = (waitMs % 1000) * 1000;
+
+   // failures the NWP pushed for the MQTT socket come back as SLNETSOCK_POLL_ERR
+   int32_t ready = SlNetSock_pollWait(g_PollSd, events, sizeof(events) / sizeof(events[0]), &tv);
+   if (ready < 0)
+   {
+      // let the MQTT client find out what happened to its socket
+      return true;
+   }
+   if (ready == 0)
+   {
+      // deadline, whichever it was
+      g_LoopStats.wakeDeadline++;
+      return (waitMs == clientMs);
+   }
+
+   for (int32_t i = 0; i < ready; i++)
+   {
+      if (events[i].sd == g_WakeSd)
+      {
+         uint8_t wake[4];
+
+         g_LoopStats.wakePublish++;
+         SlNetSock_recv(g_WakeSd, wake, sizeof(wake), 0);
+      }
+      else if (events[i].sd == netSd)
+      {
+         network = true;
+      }
+   }
+
+   if (network)
+   {
+      g_LoopStats.wakeNetwork++;
+      g_NetworkWakeMs = NOW_MS();
+      return true;
+   }
+
+   return false;
+}
+
+/**
+ * @brief Queues a dispenser event for the next eventList publish.
+ *
+ * May be called from any task. The event is a plain string of up to
+ * EVENT_MAX_LEN characters, it is not escaped so it must not hold quotes,
+ * backslashes or control characters.
+ *
+ * @return false if the event was invalid or the pipeline was full
+ */
+bool AWSDriver_QueueEvent(const char* event)
+{
+   size_t len = strlen(event);
+   bool queued = false;
+   bool wake = false;
+
+   for (size_t i = 0; i < len; i++)
+   {
+      if ((event[i] == '"') || (event[i] == '\\') || ((uint8_t) event[i] < ' '))
+      {
+         len = 0;
+         break;
+      }
+   }
+
+   taskENTER_CRITICAL();
+   if ((len > 0) && (len <= EVENT_MAX_LEN) && (g_EventCount < EVENT_QUEUE_DEPTH))
+   {
+      pendingEvent_t* slot = &g_Events[(g_EventHead + g_EventCount) % EVENT_QUEUE_DEPTH];
+
+      slot->queuedMs = NOW_MS();
+      slot->len = (uint8_t) len;
+      memcpy(slot->text, event, len);
+      g_EventCount++;
+      g_PublishStats.eventsQueued++;
+      queued = true;
+
+      // the AWS task needs a new deadline for a first event, and to flush a full batch
+      wake = (g_EventCount == 1) || (g_EventCount == g_FlushPolicy.maxEvents);
+   }
+   else
+   {
+      g_PublishStats.eventsDropped++;
+   }
+   taskEXIT_CRITICAL();
+
+   if (wake)
+   {
+      WakeSignal();
+   }
+
+   return queued;
+}
+
+void AWSDriver_SetFlushPolicy(const AWSDriver_FlushPolicy_t* policy)
+{
+   taskENTER_CRITICAL();
+   g_FlushPolicy = *policy;
+   if (g_FlushPolicy.maxBytes == 0)
+   {
+      g_FlushPolicy.maxBytes = EVENT_PAYLOAD_MAX_LEN;
+   }
+   if (g_FlushPolicy.maxEvents == 0)
+   {
+      g_FlushPolicy.maxEvents = 1;
+   }
+   taskEXIT_CRITICAL();
+}
+
+void AWSDriver_SetDocumentHandler(Json_Handle object, AWSDriver_DocumentHandler_t handler)
+{
+   taskENTER_CRITICAL();
+   g_DocObject = object;
+   g_DocHandler = handler;
+   taskEXIT_CRITICAL();
+}
+
+void AWSDriver_GetPublishStats(AWSDriver_PublishStats_t* stats)
+{
+   taskENTER_CRITICAL();
+   *stats = g_PublishStats;
+   taskEXIT_CRITICAL();
+}
+
+void AWSDriver_GetLoopStats(AWSDriver_LoopStats_t* stats)
+{
+   taskENTER_CRITICAL();
+   *stats = g_LoopStats;
+   taskEXIT_CRITICAL();
+}
+
 void AWSDriver_Init()
 {
    // Create the AWS thread
@@ -93,20 +826,14 @@ void AWSDriver_Init()
 
 void* AWSDriver_Run(void* arg)
 {
-   bool infinitePublishFlag = true;
-   char *topicName = "sdkTest/sub";
+   char *topicName = EVENT_TOPIC;
    int topicNameLen = strlen(topicName);
-   char cPayload[100];
-   int i = 0;
    IoT_Error_t rc = FAILURE;
 
    AWS_IoT_Client client;
    IoT_Client_Init_Params mqttInitParams = iotClientInitParamsDefault;
    IoT_Client_Connect_Params connectParams = iotClientConnectParamsDefault;
 
-   IoT_Publish_Message_Params paramsQOS0;
-   IoT_Publish_Message_Params paramsQOS1;
-
    IOT_INFO("\nAWS IoT SDK Version %d.%d.%d-%s\n", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH, VERSION_TAG);
 
    mqttInitParams.enableAutoReconnect = false; // We enable this later below
@@ -128,6 +855,9 @@ void* AWSDriver_Run(void* arg)
       IOT_ERROR("aws_iot_mqtt_init returned error : %d ", rc);
    }
 
+   // documents longer than AWS_IOT_MQTT_RX_BUF_LEN are parsed as they arrive
+   aws_iot_mqtt_set_payload_reader(&client, DocumentReader, NULL);
+
    connectParams.keepAliveIntervalInSec = 600;
    connectParams.isCleanSession = true;
    connectParams.MQTTVersion = MQTT_3_1_1;
@@ -161,65 +891,42 @@ void* AWSDriver_Run(void* arg)
       IOT_ERROR("Error subscribing : %d ", rc);
    }
 
-   sprintf(cPayload, "%s : %d ", "hello from SDK", i);
-
-   paramsQOS0.qos = QOS0;
-   paramsQOS0.payload = (void *)cPayload;
-   paramsQOS0.isRetained = 0;
+   if (g_EventFrameLen == 0)
+   {
+      JsonWriter_t writer;
 
-   paramsQOS1.qos = QOS1;
-   paramsQOS1.payload = (void *)cPayload;
-   paramsQOS1.isRetained = 0;
+      // measure the message around its events
+      JsonWriter_Init(&writer, NULL, 0, 0);
+      EventsWrite(&writer, 0);
+      g_EventFrameLen = (uint16_t) JsonWriter_Total(&writer);
+   }
 
-   if (publishCount != 0)
+   g_RateWindowStartMs = NOW_MS();
+   if (g_WakeSd < 0)
    {
-      infinitePublishFlag = false;
+      WakeOpen(0);
    }
 
-   while ((NETWORK_ATTEMPTING_RECONNECT == rc || NETWORK_RECONNECTED == rc || SUCCESS == rc) &&
-          (publishCount > 0 || infinitePublishFlag))
+   while (NETWORK_ATTEMPTING_RECONNECT == rc || NETWORK_RECONNECTED == rc || SUCCESS == rc)
    {
-      // Max time the yield function will wait for read messages
-      rc = aws_iot_mqtt_yield(&client, 100);
-
-      if (NETWORK_ATTEMPTING_RECONNECT == rc)
+      // sleep until there is something to read, to publish or to keep alive
+      if (WaitForWork(&client))
       {
-         // If the client is attempting to reconnect, skip rest of the loop
-         continue;
+         rc = aws_iot_mqtt_yield(&client, YIELD_MS);
       }
 
-      IOT_INFO("-->sleep");
-      sleep(1);
-      sprintf(cPayload, "%s : %d ", "hello from SDK QOS0", i++);
-        
-      // Recalculate string len to avoid truncation in subscribe callback
-      paramsQOS0.payloadLen = strlen(cPayload);
-      rc = aws_iot_mqtt_publish(&client, topicName, topicNameLen, &paramsQOS0);
-      if (publishCount > 0)
+      if (!aws_iot_mqtt_is_client_connected(&client))
       {
-         publishCount--;
-      }
-
-      if(publishCount == 0 && !infinitePublishFlag)
-      {
-         break;
+         // If the client is attempting to reconnect, skip rest of the loop
+         continue;
       }
 
-      sprintf(cPayload, "%s : %d ", "hello from SDK QOS1", i++);
-      
-      // Recalculate string len to avoid truncation in subscribe callback
-      paramsQOS1.payloadLen = strlen(cPayload);
-
-      rc = aws_iot_mqtt_publish(&client, topicName, topicNameLen, &paramsQOS1);
+      rc = EventsFlush(&client);
       if (rc == MQTT_REQUEST_TIMEOUT_ERROR)
       {
-         IOT_WARN("QOS1 publish ack not received.\n");
+         // the events are retried with the next flush
          rc = SUCCESS;
       }
-      if (publishCount > 0)
-      {
-         publishCount--;
-      }
    }
 
    // Wait for all the messages to be received
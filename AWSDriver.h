@@ -1,6 +1,72 @@
 // Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
 // Not for further distribution.  All rights reserved.
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/utils/json/json.h>
+
 void AWSDriver_Init();
 
-void* AWSDriver_Run(void* arg);
\ No newline at end of file
+void* AWSDriver_Run(void* arg);
+
+/** @brief When the publish pipeline packs its pending events into a publish */
+typedef struct
+{
+   uint16_t maxEvents;      // publish once this many events are pending
+   uint16_t maxBytes;       // payload size limit, past AWS_IOT_MQTT_TX_BUF_LEN it is sent in parts
+   uint32_t maxLatencyMs;   // publish once the oldest pending event is this old
+} AWSDriver_FlushPolicy_t;
+
+/** @brief Publish pipeline counters */
+typedef struct
+{
+   uint32_t eventsQueued;   // events accepted by AWSDriver_QueueEvent
+   uint32_t eventsDropped;  // events refused, the pipeline was full or the event invalid
+   uint32_t eventsPublished;
+   uint32_t publishes;      // eventList messages published
+   uint32_t publishErrors;  // publishes that failed, their events are retried
+   uint32_t payloadBytes;   // payload bytes of the published messages
+   uint32_t eventsPerSec;   // events published over the last measurement window
+   uint32_t bytesPerEvent;  // payload bytes per published event
+   uint32_t payloadParts;   // payload parts written into the TX buffer, more than one per large publish
+} AWSDriver_PublishStats_t;
+
+#define AWSDRIVER_LATENCY_BUCKETS   12
+
+/** @brief AWS task wake-ups and latencies, bucket i counts latencies below 2^i ms, the last one all longer */
+typedef struct
+{
+   uint32_t wakeNetwork;    // the MQTT socket became readable
+   uint32_t wakePublish;    // a producer signalled a flush to be due
+   uint32_t wakeDeadline;   // a flush, keepalive or reconnect deadline passed
+   uint32_t commandLatency[AWSDRIVER_LATENCY_BUCKETS];  // socket readable to subscription handler
+   uint32_t publishLatency[AWSDRIVER_LATENCY_BUCKETS];  // event queued to event published
+} AWSDriver_LoopStats_t;
+
+/**
+ * @brief Called by the AWS task once a document received on the event topic
+ *        has been parsed, with the object it was parsed into and JSON_RC__OK
+ *        or the error that cut the parse short.
+ */
+typedef void (*AWSDriver_DocumentHandler_t)(Json_Handle object, int16_t rc);
+
+/**
+ * @brief Parses the documents received on the event topic into 'object', made
+ *        by the application from its template, and hands it to 'handler'.
+ *        Documents longer than the MQTT RX buffer are parsed as they arrive,
+ *        a buffer at a time. A NULL handler ignores the documents again.
+ */
+void AWSDriver_SetDocumentHandler(Json_Handle object, AWSDriver_DocumentHandler_t handler);
+
+/** @brief Queues a dispenser event for the next eventList publish, from any task */
+bool AWSDriver_QueueEvent(const char* event);
+
+/** @brief Replaces the flush policy of the publish pipeline */
+void AWSDriver_SetFlushPolicy(const AWSDriver_FlushPolicy_t* policy);
+
+/** @brief Returns a snapshot of the publish pipeline counters */
+void AWSDriver_GetPublishStats(AWSDriver_PublishStats_t* stats);
+
+/** @brief Returns a snapshot of the AWS task wake-up and latency counters */
+void AWSDriver_GetLoopStats(AWSDriver_LoopStats_t* stats);
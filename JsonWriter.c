@@ -0,0 +1,240 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+#include <string.h>
+
+#include "JsonWriter.h"
+
+static const char g_HexDigits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Appends len bytes to the document, the part inside the window is copied.
+ */
+static void Put(JsonWriter_t* writer, const char* text, uint32_t len)
+{
+   uint32_t end = writer->start + writer->size;
+
+   if ((writer->buf != NULL) && (writer->total < end) && (writer->total + len > writer->start))
+   {
+      uint32_t from = (writer->total < writer->start) ? (writer->start - writer->total) : 0;
+      uint32_t to = (writer->total + len > end) ? (end - writer->total) : len;
+
+      memcpy(&writer->buf[writer->total + from - writer->start], &text[from], to - from);
+   }
+
+   writer->total += len;
+}
+
+static void PutChar(JsonWriter_t* writer, char c)
+{
+   Put(writer, &c, 1);
+}
+
+/**
+ * @brief Writes the separator and key ahead of a value.
+ */
+static void PutKey(JsonWriter_t* writer, const char* key)
+{
+   if (writer->depth > 0)
+   {
+      uint16_t bit = (uint16_t) (1u << (writer->depth - 1));
+
+      if (writer->hasMembers & bit)
+      {
+         PutChar(writer, ',');
+      }
+      writer->hasMembers |= bit;
+   }
+
+   if (key != NULL)
+   {
+      PutChar(writer, '"');
+      Put(writer, key, strlen(key));
+      Put(writer, "\":", 2);
+   }
+}
+
+static void Open(JsonWriter_t* writer, const char* key, char bracket)
+{
+   PutKey(writer, key);
+   PutChar(writer, bracket);
+
+   if (writer->depth >= JSON_WRITER_MAX_DEPTH)
+   {
+      writer->failed = true;
+      return;
+   }
+
+   writer->depth++;
+   writer->hasMembers &= (uint16_t) ~(1u << (writer->depth - 1));
+}
+
+static void Close(JsonWriter_t* writer, char bracket)
+{
+   if (writer->depth == 0)
+   {
+      writer->failed = true;
+      return;
+   }
+
+   writer->depth--;
+   PutChar(writer, bracket);
+}
+
+void JsonWriter_Init(JsonWriter_t* writer, char* buf, uint32_t size, uint32_t start)
+{
+   writer->buf = buf;
+   writer->size = (buf != NULL) ? size : 0;
+   writer->start = start;
+   writer->total = 0;
+   writer->hasMembers = 0;
+   writer->depth = 0;
+   writer->failed = false;
+}
+
+void JsonWriter_ObjectBegin(JsonWriter_t* writer, const char* key)
+{
+   Open(writer, key, '{');
+}
+
+void JsonWriter_ObjectEnd(JsonWriter_t* writer)
+{
+   Close(writer, '}');
+}
+
+void JsonWriter_ArrayBegin(JsonWriter_t* writer, const char* key)
+{
+   Open(writer, key, '[');
+}
+
+void JsonWriter_ArrayEnd(JsonWriter_t* writer)
+{
+   Close(writer, ']');
+}
+
+void JsonWriter_String(JsonWriter_t* writer, const char* key, const char* value, uint16_t len)
+{
+   uint16_t run = 0;
+
+   PutKey(writer, key);
+   PutChar(writer, '"');
+
+   // copy runs of plain characters at once, escape the others
+   for (uint16_t i = 0; i < len; i++)
+   {
+      uint8_t c = (uint8_t) value[i];
+      char escape[6];
+      uint8_t escapeLen = 2;
+
+      if ((c >= ' ') && (c != '"') && (c != '\\'))
+      {
+         continue;
+      }
+
+      Put(writer, &value[run], i - run);
+      run = i + 1;
+
+      escape[0] = '\\';
+      switch (c)
+      {
+         case '"':  escape[1] = '"';  break;
+         case '\\': escape[1] = '\\'; break;
+         case '\n': escape[1] = 'n';  break;
+         case '\r': escape[1] = 'r';  break;
+         case '\t': escape[1] = 't';  break;
+         default:
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = g_HexDigits[c >> 4];
+            escape[5] = g_HexDigits[c & 0x0F];
+            escapeLen = 6;
+            break;
+      }
+      Put(writer, escape, escapeLen);
+   }
+
+   Put(writer, &value[run], len - run);
+   PutChar(writer, '"');
+}
+
+void JsonWriter_Hex(JsonWriter_t* writer, const char* key, const uint8_t* bytes, uint16_t len)
+{
+   PutKey(writer, key);
+   PutChar(writer, '"');
+
+   for (uint16_t i = 0; i < len; i++)
+   {
+      char hex[2];
+
+      hex[0] = g_HexDigits[bytes[i] >> 4];
+      hex[1] = g_HexDigits[bytes[i] & 0x0F];
+      Put(writer, hex, 2);
+   }
+
+   PutChar(writer, '"');
+}
+
+void JsonWriter_Int(JsonWriter_t* writer, const char* key, int32_t value)
+{
+   char digits[11];
+   uint8_t pos = sizeof(digits);
+   uint32_t magnitude = (value < 0) ? (0u - (uint32_t) value) : (uint32_t) value;
+
+   PutKey(writer, key);
+
+   do
+   {
+      digits[--pos] = (char) ('0' + (magnitude % 10));
+      magnitude /= 10;
+   } while (magnitude != 0);
+
+   if (value < 0)
+   {
+      digits[--pos] = '-';
+   }
+
+   Put(writer, &digits[pos], sizeof(digits) - pos);
+}
+
+void JsonWriter_Bool(JsonWriter_t* writer, const char* key, bool value)
+{
+   PutKey(writer, key);
+
+   if (value)
+   {
+      Put(writer, "true", 4);
+   }
+   else
+   {
+      Put(writer, "false", 5);
+   }
+}
+
+uint32_t JsonWriter_Len(const JsonWriter_t* writer)
+{
+   if (writer->total <= writer->start)
+   {
+      return 0;
+   }
+   if (writer->total - writer->start > writer->size)
+   {
+      return writer->size;
+   }
+   return writer->total - writer->start;
+}
+
+bool JsonWriter_IsFull(const JsonWriter_t* writer)
+{
+   return (writer->total > writer->start + writer->size);
+}
+
+uint32_t JsonWriter_Total(const JsonWriter_t* writer)
+{
+   return writer->total;
+}
+
+bool JsonWriter_IsDone(const JsonWriter_t* writer)
+{
+   return !writer->failed && (writer->depth == 0) && (writer->total > 0);
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Allocation free JSON writer.  The document is written straight into a
+ * caller buffer, compact, by one call per member or array element.
+ *
+ * The buffer is a window over the document: output before the window start
+ * is dropped, output past its end is counted but not written.  A document
+ * that did not fit is resumed by writing it again, with the same calls, into
+ * a window starting where the previous one ended.  With a NULL buffer the
+ * writer only measures the document.
+ */
+
+// nesting levels of objects and arrays
+#define JSON_WRITER_MAX_DEPTH    16
+
+typedef struct
+{
+   char*    buf;
+   uint32_t size;       // window size
+   uint32_t start;      // document offset of the window start
+   uint32_t total;      // document bytes written so far, in and out of the window
+   uint16_t hasMembers; // bit per nesting level, a value was written at that level
+   uint8_t  depth;
+   bool     failed;     // nesting was unbalanced or too deep
+} JsonWriter_t;
+
+/** @brief Starts a document in a window of size bytes at document offset start */
+void JsonWriter_Init(JsonWriter_t* writer, char* buf, uint32_t size, uint32_t start);
+
+/**
+ * Members of an object are written with their key, elements of an array with
+ * a NULL key.
+ */
+
+void JsonWriter_ObjectBegin(JsonWriter_t* writer, const char* key);
+
+void JsonWriter_ObjectEnd(JsonWriter_t* writer);
+
+void JsonWriter_ArrayBegin(JsonWriter_t* writer, const char* key);
+
+void JsonWriter_ArrayEnd(JsonWriter_t* writer);
+
+/** @brief Writes len characters of value as a string, escaped as needed */
+void JsonWriter_String(JsonWriter_t* writer, const char* key, const char* value, uint16_t len);
+
+/** @brief Writes len bytes as a string of upper case hex digits */
+void JsonWriter_Hex(JsonWriter_t* writer, const char* key, const uint8_t* bytes, uint16_t len);
+
+void JsonWriter_Int(JsonWriter_t* writer, const char* key, int32_t value);
+
+void JsonWriter_Bool(JsonWriter_t* writer, const char* key, bool value);
+
+/** @brief Returns the number of bytes written into the window */
+uint32_t JsonWriter_Len(const JsonWriter_t* writer);
+
+/** @brief Returns true if the document continues past the window */
+bool JsonWriter_IsFull(const JsonWriter_t* writer);
+
+/** @brief Returns the document length, the output written so far past the window included */
+uint32_t JsonWriter_Total(const JsonWriter_t* writer);
+
+/** @brief Returns true if the document is complete and well nested */
+bool JsonWriter_IsDone(const JsonWriter_t* writer);
+
+#endif
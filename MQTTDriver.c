@@ -37,11 +37,38 @@
 #define SECURED_PORT_NUM        8883
 
 #define CLEAN_SESSION            true
+// QoS1/2 publishes that can await their ACK at a time, capped by the
+// library at its buffer pool size less one
+#define PUBLISH_WINDOW           4
+
+// The library pool (CFG_SL_CL_MAX_MQP, set in the project defines) takes the
+// window, the packet being received and the two buffers that must stay free
+// for a received message to be held in place (MQTTCLIENTCORE_HOLD_RSVD_MQP)
+#define PUBLISH_POOL_MIN         (PUBLISH_WINDOW + 1 + 2)
+#if !defined(CFG_SL_CL_MAX_MQP) || (CFG_SL_CL_MAX_MQP < PUBLISH_POOL_MIN)
+#error "CFG_SL_CL_MAX_MQP is too small for PUBLISH_WINDOW and in place receive"
+#endif
 #define RETAIN_ENABLE            1
 #define SUBSCRIPTION_TOPIC_COUNT 4
 
 #define MSG_RECV_BY_CLIENT          11
 
+// Fixed blocks a received message is copied into when the MQTT library pool
+// can't spare its own buffer. A message takes the smallest free block that
+// holds its topic and payload, each NULL terminated.
+#define RECV_SLOT_SMALL_SIZE        128
+#define RECV_SLOT_SMALL_COUNT       8
+#define RECV_SLOT_LARGE_SIZE        1024
+#define RECV_SLOT_LARGE_COUNT       2
+#define RECV_SLOT_CLASSES           2
+
+// Depth of the receive queue, one entry per receive slot
+#define RECV_QUEUE_DEPTH            (RECV_SLOT_SMALL_COUNT + RECV_SLOT_LARGE_COUNT)
+#define RECV_QUEUE_MODE             0644
+
+// Stack of the MQTT library receive task
+#define MQTT_THREAD_STACK_SIZE      2048
+
 /* secured client requires time configuration, in order to verify server     */
 /* certificate validity (date).                                              */
 
@@ -118,7 +145,7 @@ MQTTClient_Will will_param =
 const char *publish_topic = { PUBLISH_TOPIC0 };
 const char *publish_data = { PUBLISH_TOPIC0_DATA };
 
-mqd_t g_PBQueue;
+mqd_t g_PBQueue = (mqd_t) -1;
 pthread_t mqttThread = (pthread_t) NULL;
 pthread_t appThread = (pthread_t) NULL;
 timer_t g_timer;
@@ -132,24 +159,117 @@ timer_t g_timer;
 char *topic[SUBSCRIPTION_TOPIC_COUNT] = { SUBSCRIPTION_TOPIC0, SUBSCRIPTION_TOPIC1, SUBSCRIPTION_TOPIC2, SUBSCRIPTION_TOPIC3 };
 
 
-typedef struct 
-{
-    uint32_t topicLen;
-    uint32_t payLen;
-    bool retain;
-    bool dup;
-    unsigned char qos;
-} publishMsgHeader_t;
-
 typedef struct
 {
     int32_t event;
-    void        *msgPtr;
-    int32_t topLen;
+    MQTT_RecvMsg_t msg;
 } msgQueue_t;
 
+typedef struct
+{
+    uint8_t *blocks;
+    uint16_t blockSize;
+    uint8_t blockCount;
+    uint32_t freeMask;
+} recvSlotClass_t;
+
+static uint8_t g_RecvSlotsSmall[RECV_SLOT_SMALL_COUNT][RECV_SLOT_SMALL_SIZE];
+static uint8_t g_RecvSlotsLarge[RECV_SLOT_LARGE_COUNT][RECV_SLOT_LARGE_SIZE];
+
+// ordered by block size
+static recvSlotClass_t g_RecvSlotClass[RECV_SLOT_CLASSES] =
+{
+    { &g_RecvSlotsSmall[0][0], RECV_SLOT_SMALL_SIZE, RECV_SLOT_SMALL_COUNT, (1UL << RECV_SLOT_SMALL_COUNT) - 1 },
+    { &g_RecvSlotsLarge[0][0], RECV_SLOT_LARGE_SIZE, RECV_SLOT_LARGE_COUNT, (1UL << RECV_SLOT_LARGE_COUNT) - 1 }
+};
+
+static pthread_mutex_t g_RecvSlotLock;
+
+static MQTT_RecvStats_t g_RecvStats;
+
 extern int32_t MQTT_SendMsgToQueue(msgQueue_t *queueElement);
 
+//*****************************************************************************
+//
+//! RecvSlotAlloc - Takes a free block of the smallest size class that holds
+//! size bytes, or of a larger class if that one is used up.
+//!
+//! \param[in] size - bytes required
+//!
+//! \return the block, or NULL if none is free
+//
+//*****************************************************************************
+static uint8_t* RecvSlotAlloc(uint32_t size)
+{
+   uint8_t *block = NULL;
+
+   pthread_mutex_lock(&g_RecvSlotLock);
+   for(uint8_t c = 0; (c < RECV_SLOT_CLASSES) && (block == NULL); c++)
+   {
+      recvSlotClass_t *slotClass = &g_RecvSlotClass[c];
+
+      if((size > slotClass->blockSize) || (slotClass->freeMask == 0))
+      {
+         continue;
+      }
+      for(uint8_t i = 0; i < slotClass->blockCount; i++)
+      {
+         if(slotClass->freeMask & (1UL << i))
+         {
+            slotClass->freeMask &= ~(1UL << i);
+            block = slotClass->blocks + (i * slotClass->blockSize);
+            break;
+         }
+      }
+   }
+   pthread_mutex_unlock(&g_RecvSlotLock);
+
+   return block;
+}
+
+//*****************************************************************************
+//
+//! RecvSlotFree - Returns a block taken through RecvSlotAlloc.
+//!
+//! \param[in] block
+//!
+//! \return none
+//
+//*****************************************************************************
+static void RecvSlotFree(uint8_t *block)
+{
+   pthread_mutex_lock(&g_RecvSlotLock);
+   for(uint8_t c = 0; c < RECV_SLOT_CLASSES; c++)
+   {
+      recvSlotClass_t *slotClass = &g_RecvSlotClass[c];
+      uint32_t span = slotClass->blockCount * slotClass->blockSize;
+
+      if((block >= slotClass->blocks) && (block < slotClass->blocks + span))
+      {
+         slotClass->freeMask |= 1UL << ((block - slotClass->blocks) / slotClass->blockSize);
+         break;
+      }
+   }
+   pthread_mutex_unlock(&g_RecvSlotLock);
+}
+
+//*****************************************************************************
+//
+//! MqttClientThread - MQTT library receive task. It reads the broker packets,
+//! the CONNACK MQTTClient_connect waits on included, and runs the callbacks.
+//!
+//! \param[in] arg - the client handle
+//!
+//! \return NULL once the connection is closed
+//
+//*****************************************************************************
+static void* MqttClientThread(void *arg)
+{
+   MQTTClient_run((MQTTClient_Handle) arg);
+
+   return NULL;
+}
+
 void MQTT_setTime()
 {
     SlDateTime_t dateTime = {0};
@@ -166,6 +286,20 @@ void MQTT_setTime()
 int MQTT_Init(uint8_t* macAddress, uint16_t length)
 {
    uint8_t Client_Mac_Name[2];
+   struct mq_attr attr;
+
+   // the queue carries message descriptors, the messages stay in their buffers
+   attr.mq_flags = 0;
+   attr.mq_maxmsg = RECV_QUEUE_DEPTH;
+   attr.mq_msgsize = sizeof(msgQueue_t);
+   attr.mq_curmsgs = 0;
+   g_PBQueue = mq_open("g_PBQueue", O_CREAT | O_RDWR, RECV_QUEUE_MODE, &attr);
+   if(g_PBQueue == (mqd_t) -1)
+   {
+      UART_PRINT("Receive queue open failed\n\r");
+      return(-1);
+   }
+   pthread_mutex_init(&g_RecvSlotLock, (const pthread_mutexattr_t *) NULL);
    
    for(uint8_t i = 0; i < SL_MAC_ADDR_LEN; i++)
    {
@@ -215,6 +349,17 @@ int MQTT_Init(uint8_t* macAddress, uint16_t length)
       //gInitState &= ~CLIENT_INIT_STATE;
       return(-1);
    }
+
+   pthread_attr_t attrs;
+   pthread_attr_init(&attrs);
+   pthread_attr_setstacksize(&attrs, MQTT_THREAD_STACK_SIZE);
+   int status = pthread_create(&mqttThread, &attrs, MqttClientThread, (void *) gMqttClient);
+   pthread_attr_destroy(&attrs);
+   if(status != 0)
+   {
+      UART_PRINT("MQTT receive task failed\n\r");
+      return(-1);
+   }
    
    MQTT_setTime();
    
@@ -223,6 +368,14 @@ int MQTT_Init(uint8_t* macAddress, uint16_t length)
    
    bool clean = CLEAN_SESSION;
    MQTTClient_set(gMqttClient, MQTTClient_CLEAN_CONNECT, (void *)&clean, sizeof(bool));
+
+   // Pipeline publishes instead of blocking each one on its ACK
+   uint16_t window = PUBLISH_WINDOW;
+   if(0 > MQTTClient_set(gMqttClient, MQTTClient_PUBLISH_WINDOW, (void *)&window, sizeof(window)))
+   {
+      MQTTClient_get(gMqttClient, MQTTClient_PUBLISH_WINDOW, (void *)&window, sizeof(window));
+      UART_PRINT("Publish window cut down to %d\n\r", window);
+   }
    
    // The return code of MQTTClient_connect is the ConnACK value that returns from the server
    int16_t lRetVal = MQTTClient_connect(gMqttClient);
@@ -253,12 +406,12 @@ void MQTT_Publish()
 //*****************************************************************************
 //
 //! MQTT_SendMsgToQueue - Utility function that receive msgQueue parameter and
-//! tries to push it the queue with minimal time for timeout of 0.
+//! tries to push it the queue.
 //! If the queue isn't full the parameter will be stored and the function
 //! will return 0.
-//! If the queue is full and the timeout expired (because the timeout parameter
-//! is 0 it will expire immediately), the parameter is thrown away and the
-//! function will return -1 as an error for full queue.
+//! If the queue is full the parameter is thrown away at once, so the receive
+//! task never stalls on a slow application, and the function will return -1
+//! as an error for full queue; the caller still owns the message buffer.
 //!
 //! \param[in] struct msgQueue *queueElement
 //!
@@ -269,20 +422,92 @@ int32_t MQTT_SendMsgToQueue(msgQueue_t *queueElement)
 {   
    struct timespec abstime = {0};
 
+   // an expired deadline, a full queue fails right away instead of waiting
    clock_gettime(CLOCK_REALTIME, &abstime);
 
-   if(g_PBQueue)
+   if((g_PBQueue != (mqd_t) -1) &&
+      (mq_timedsend(g_PBQueue, (char *) queueElement, sizeof(msgQueue_t), 0, &abstime) == 0))
    {
-      // send message to the queue
-      if(mq_timedsend(g_PBQueue, (char *) queueElement, sizeof(msgQueue_t), 0, &abstime) == 0)
-      {
-         return(0);
-      }
+      return(0);
    }
    
    return(-1);
 }
 
+//*****************************************************************************
+//
+//! MQTT_ReceiveMsg - Takes the next message received from the broker off the
+//! queue. The message must be handed back through MQTT_ReleaseMsg once
+//! processed.
+//!
+//! \param[out] MQTT_RecvMsg_t *msg
+//! \param[in]  timeoutMs - time to wait for a message
+//!
+//! \return 0 on success, -1 if no message arrived in time
+//
+//*****************************************************************************
+int32_t MQTT_ReceiveMsg(MQTT_RecvMsg_t *msg, uint32_t timeoutMs)
+{
+   struct timespec abstime = {0};
+   msgQueue_t queueElem;
+
+   clock_gettime(CLOCK_REALTIME, &abstime);
+   abstime.tv_nsec += (timeoutMs % 1000) * 1000000;
+   abstime.tv_sec += timeoutMs / 1000 + abstime.tv_nsec / 1000000000;
+   abstime.tv_nsec %= 1000000000;
+
+   if((g_PBQueue != (mqd_t) -1) &&
+      (mq_timedreceive(g_PBQueue, (char *) &queueElem, sizeof(msgQueue_t), NULL, &abstime) == sizeof(msgQueue_t)))
+   {
+      *msg = queueElem.msg;
+      return(0);
+   }
+
+   return(-1);
+}
+
+//*****************************************************************************
+//
+//! MQTT_ReleaseMsg - Releases the buffer of a message taken from the queue,
+//! either the MQTT library buffer it was held in or its heap copy.
+//!
+//! \param[in] MQTT_RecvMsg_t *msg
+//!
+//! \return none
+//
+//*****************************************************************************
+void MQTT_ReleaseMsg(MQTT_RecvMsg_t *msg)
+{
+   if(msg->recvBuffer != NULL)
+   {
+      MQTTClient_releaseRecvBuffer(msg->recvBuffer);
+      msg->recvBuffer = NULL;
+   }
+   else if(msg->topic != NULL)
+   {
+      // the topic heads the receive slot, the payload follows it
+      RecvSlotFree((uint8_t *) msg->topic);
+   }
+   msg->topic = NULL;
+   msg->payload = NULL;
+}
+
+//*****************************************************************************
+//
+//! MQTT_GetRecvStats - Copies the receive path counters, to compare messages
+//! held in place against messages copied to a receive slot and to account
+//! for the messages dropped.
+//!
+//! \param[out] MQTT_RecvStats_t *stats
+//!
+//! \return none
+//
+//*****************************************************************************
+void MQTT_GetRecvStats(MQTT_RecvStats_t *stats)
+{
+   *stats = g_RecvStats;
+}
+
 //*****************************************************************************
 //
 //! Callback in case of various event (for clients connection with remote
@@ -368,50 +593,55 @@ void MqttClientCallback(int32_t event,
     {
         MQTTClient_RecvMetaDataCB *recvMetaData =
             (MQTTClient_RecvMetaDataCB *)metaData;
-        uint32_t bufSizeReqd = 0;
-        uint32_t topicOffset;
-        uint32_t payloadOffset;
-
-        publishMsgHeader_t msgHead;
-
-        char *pubBuff = NULL;
         msgQueue_t queueElem;
 
-        topicOffset = sizeof(publishMsgHeader_t);
-        payloadOffset = sizeof(publishMsgHeader_t) +
-                        recvMetaData->topLen + 1;
-
-        bufSizeReqd += sizeof(publishMsgHeader_t);
-        bufSizeReqd += recvMetaData->topLen + 1;
-        bufSizeReqd += dataLen + 1;
-        pubBuff = (char *) malloc(bufSizeReqd);
+        g_RecvStats.publishes++;
 
-        if(pubBuff == NULL)
+        /* filling the queue element details                              */
+        queueElem.event = MSG_RECV_BY_CLIENT;
+        queueElem.msg.topicLen = recvMetaData->topLen;
+        queueElem.msg.payloadLen = dataLen;
+        queueElem.msg.qos = recvMetaData->qos;
+        queueElem.msg.retain = recvMetaData->retain;
+        queueElem.msg.dup = recvMetaData->dup;
+
+        /* hand the library buffer itself over to the main task           */
+        queueElem.msg.recvBuffer = MQTTClient_holdRecvBuffer(recvMetaData);
+        if(queueElem.msg.recvBuffer != NULL)
         {
-            UART_PRINT("malloc failed: recv_cb\n\r");
-            return;
+            queueElem.msg.topic = recvMetaData->topic;
+            queueElem.msg.payload = (const char *) data;
+            g_RecvStats.heldInPlace++;
         }
+        else
+        {
+            /* the pool can't spare the buffer, copy the message out      */
+            uint32_t bufSizeReqd = recvMetaData->topLen + 1 + dataLen + 1;
+            char *pubBuff = (char *) RecvSlotAlloc(bufSizeReqd);
 
-        msgHead.topicLen = recvMetaData->topLen;
-        msgHead.payLen = dataLen;
-        msgHead.retain = recvMetaData->retain;
-        msgHead.dup = recvMetaData->dup;
-        msgHead.qos = recvMetaData->qos;
-        memcpy((void*) pubBuff, &msgHead, sizeof(publishMsgHeader_t));
-
-        /* copying the topic name into the buffer                        */
-        memcpy((void*) (pubBuff + topicOffset),
-               (const void*)recvMetaData->topic,
-               recvMetaData->topLen);
-        memset((void*) (pubBuff + topicOffset + recvMetaData->topLen),'\0',1);
-
-        /* copying the payload into the buffer                           */
-        memcpy((void*) (pubBuff + payloadOffset), (const void*) data, dataLen);
-        memset((void*) (pubBuff + payloadOffset + dataLen), '\0', 1);
+            if(pubBuff == NULL)
+            {
+                UART_PRINT("no receive slot: recv_cb\n\r");
+                g_RecvStats.droppedNoSlot++;
+                return;
+            }
+            g_RecvStats.slotCopies++;
+            g_RecvStats.bytesCopied += recvMetaData->topLen + dataLen;
+
+            memcpy((void*) pubBuff, (const void*) recvMetaData->topic,
+                   recvMetaData->topLen);
+            pubBuff[recvMetaData->topLen] = '\0';
+            memcpy((void*) (pubBuff + recvMetaData->topLen + 1),
+                   (const void*) data, dataLen);
+            pubBuff[recvMetaData->topLen + 1 + dataLen] = '\0';
+
+            queueElem.msg.topic = pubBuff;
+            queueElem.msg.payload = pubBuff + recvMetaData->topLen + 1;
+        }
 
         UART_PRINT("\n\rMsg Recvd. by client\n\r");
-        UART_PRINT("TOPIC: %s\n\r", pubBuff + topicOffset);
-        UART_PRINT("PAYLOAD: %s\n\r", pubBuff + payloadOffset);
+        UART_PRINT("TOPIC: %.*s\n\r", (int) queueElem.msg.topicLen, queueElem.msg.topic);
+        UART_PRINT("PAYLOAD: %.*s\n\r", (int) queueElem.msg.payloadLen, queueElem.msg.payload);
         UART_PRINT("QOS: %d\n\r", recvMetaData->qos);
 
         if(recvMetaData->retain)
@@ -424,15 +654,16 @@ void MqttClientCallback(int32_t event,
             UART_PRINT("Duplicate\n\r");
         }
 
-        /* filling the queue element details                              */
-        queueElem.event = MSG_RECV_BY_CLIENT;
-        queueElem.msgPtr = pubBuff;
-        queueElem.topLen = recvMetaData->topLen;
-
         /* signal to the main task                                        */
         if(MQTT_SendMsgToQueue(&queueElem))
         {
             UART_PRINT("\n\n\rQueue is full\n\n\r");
+            g_RecvStats.droppedQueueFull++;
+            MQTT_ReleaseMsg(&queueElem.msg);
+        }
+        else
+        {
+            g_RecvStats.queued++;
         }
         break;
     }
@@ -1,6 +1,43 @@
 // Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
 // Not for further distribution.  All rights reserved.
 
+#include <stdbool.h>
+#include <stdint.h>
+
 int MQTT_Init(uint8_t* macAddress, uint16_t length);
 
-void MQTT_Publish();
\ No newline at end of file
+void MQTT_Publish();
+
+/** @brief PUBLISH message received from the broker, as queued to the application */
+typedef struct
+{
+   const char *topic;       // not NULL terminated when held in place
+   uint16_t topicLen;
+   const char *payload;     // not NULL terminated when held in place
+   uint32_t payloadLen;
+   uint8_t qos;
+   bool retain;
+   bool dup;
+   void *recvBuffer;        // MQTT library buffer held by the message, NULL for a copy in a receive slot
+} MQTT_RecvMsg_t;
+
+/** @brief Receive path counters, per received PUBLISH */
+typedef struct
+{
+   uint32_t publishes;      // PUBLISH messages received
+   uint32_t heldInPlace;    // messages queued without copying out of the library buffer
+   uint32_t slotCopies;     // messages copied into a fixed receive slot
+   uint32_t bytesCopied;    // topic and payload bytes copied out of the library buffer
+   uint32_t queued;         // messages delivered to the receive queue
+   uint32_t droppedNoSlot;  // messages dropped, no receive slot was free
+   uint32_t droppedQueueFull; // messages dropped, the queue was full
+} MQTT_RecvStats_t;
+
+/** @brief Takes the next message received from the broker, waiting up to timeoutMs */
+int32_t MQTT_ReceiveMsg(MQTT_RecvMsg_t *msg, uint32_t timeoutMs);
+
+/** @brief Releases the buffer of a message taken from the receive queue */
+void MQTT_ReleaseMsg(MQTT_RecvMsg_t *msg);
+
+/** @brief Returns a snapshot of the receive path counters */
+void MQTT_GetRecvStats(MQTT_RecvStats_t *stats);
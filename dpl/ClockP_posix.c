@@ -0,0 +1,72 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ti/drivers/dpl/ClockP.h>
+
+/*
+ *  Host (POSIX) build of the ClockP tick and sleep services, used together
+ *  with the simulated NWP. Clock objects are not provided.
+ */
+
+/* System tick period in microseconds */
+#define TICK_PERIOD_US (1000)
+
+uint32_t ClockP_tickPeriod = TICK_PERIOD_US;
+
+/*
+ *  ======== ClockP_getCpuFreq ========
+ */
+void ClockP_getCpuFreq(ClockP_FreqHz *freq)
+{
+    freq->lo = 1000000000;
+    freq->hi = 0;
+}
+
+/*
+ *  ======== ClockP_getSystemTickPeriod ========
+ */
+uint32_t ClockP_getSystemTickPeriod()
+{
+    return (TICK_PERIOD_US);
+}
+
+/*
+ *  ======== ClockP_getSystemTicks ========
+ */
+uint32_t ClockP_getSystemTicks()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint32_t)((uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000));
+}
+
+/*
+ *  ======== ClockP_sleep ========
+ */
+void ClockP_sleep(uint32_t sec)
+{
+    struct timespec delay;
+
+    delay.tv_sec = sec;
+    delay.tv_nsec = 0;
+    while (nanosleep(&delay, &delay) != 0) {
+        ;
+    }
+}
+
+/*
+ *  ======== ClockP_usleep ========
+ */
+void ClockP_usleep(uint32_t usec)
+{
+    struct timespec delay;
+
+    delay.tv_sec = usec / 1000000;
+    delay.tv_nsec = (long)(usec % 1000000) * 1000;
+    while (nanosleep(&delay, &delay) != 0) {
+        ;
+    }
+}
@@ -0,0 +1,66 @@
+#include <ti/drivers/dpl/MutexP.h>
+
+#include <pthread.h>
+#include <stdlib.h>
+
+/*
+ *  Host (POSIX) build of the MutexP module, used together with the
+ *  simulated NWP.
+ */
+
+/*
+ *  ======== MutexP_create ========
+ */
+MutexP_Handle MutexP_create(MutexP_Params *params)
+{
+    pthread_mutex_t *mutex;
+    pthread_mutexattr_t attr;
+
+    mutex = malloc(sizeof(pthread_mutex_t));
+    if (mutex == NULL) {
+        return (NULL);
+    }
+
+    /* same semantics as the FreeRTOS recursive mutex */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    return ((MutexP_Handle)mutex);
+}
+
+/*
+ *  ======== MutexP_delete ========
+ */
+void MutexP_delete(MutexP_Handle handle)
+{
+    pthread_mutex_destroy((pthread_mutex_t *)handle);
+    free(handle);
+}
+
+/*
+ *  ======== MutexP_lock ========
+ */
+uintptr_t MutexP_lock(MutexP_Handle handle)
+{
+    pthread_mutex_lock((pthread_mutex_t *)handle);
+
+    return (0);
+}
+
+/*
+ *  ======== MutexP_Params_init ========
+ */
+void MutexP_Params_init(MutexP_Params *params)
+{
+    params->callback = NULL;
+}
+
+/*
+ *  ======== MutexP_unlock ========
+ */
+void MutexP_unlock(MutexP_Handle handle, uintptr_t key)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)handle);
+}
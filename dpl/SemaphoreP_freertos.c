@@ -112,7 +112,7 @@ SemaphoreP_Status SemaphoreP_pend(SemaphoreP_Handle handle, uint32_t timeout)
  */
 void SemaphoreP_post(SemaphoreP_Handle handle)
 {
-    BaseType_t xHigherPriorityTaskWoken;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
     if (!HwiP_inISR()) {
         /* Not in ISR */
@@ -121,6 +121,9 @@ void SemaphoreP_post(SemaphoreP_Handle handle)
     else {
         xSemaphoreGiveFromISR((SemaphoreHandle_t)handle,
                 &xHigherPriorityTaskWoken);
+
+        /* Switch straight to the task that was pending, if it outranks us */
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
 }
 
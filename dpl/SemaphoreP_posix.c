@@ -0,0 +1,150 @@
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ *  Host (POSIX) build of the SemaphoreP module, used together with the
+ *  simulated NWP. A tick is one millisecond, see ClockP_posix.c.
+ */
+
+/*
+ *  Maximum count for a semaphore.
+ */
+#define MAXCOUNT 0xffff
+
+typedef struct SemaphoreP_PosixObj
+{
+    pthread_mutex_t  lock;
+    pthread_cond_t   cond;
+    unsigned int     count;
+    unsigned int     maxCount;
+} SemaphoreP_PosixObj;
+
+/*
+ *  ======== SemaphoreP_create ========
+ */
+SemaphoreP_Handle SemaphoreP_create(unsigned int count,
+                                    SemaphoreP_Params *params)
+{
+    SemaphoreP_PosixObj *sem;
+    SemaphoreP_Params semParams;
+    pthread_condattr_t attr;
+
+    if (params == NULL) {
+        params = &semParams;
+        SemaphoreP_Params_init(params);
+    }
+
+    sem = malloc(sizeof(SemaphoreP_PosixObj));
+    if (sem == NULL) {
+        return (NULL);
+    }
+
+    /* timed waits are measured on the monotonic clock */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&sem->lock, NULL);
+    pthread_cond_init(&sem->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    sem->maxCount = (params->mode == SemaphoreP_Mode_COUNTING) ? MAXCOUNT : 1;
+    sem->count = (count > sem->maxCount) ? sem->maxCount : count;
+
+    return ((SemaphoreP_Handle)sem);
+}
+
+/*
+ *  ======== SemaphoreP_createBinary ========
+ */
+SemaphoreP_Handle SemaphoreP_createBinary(unsigned int count)
+{
+    SemaphoreP_Params params;
+
+    SemaphoreP_Params_init(&params);
+    params.mode = SemaphoreP_Mode_BINARY;
+
+    return (SemaphoreP_create(count, &params));
+}
+
+/*
+ *  ======== SemaphoreP_delete ========
+ */
+void SemaphoreP_delete(SemaphoreP_Handle handle)
+{
+    SemaphoreP_PosixObj *sem = (SemaphoreP_PosixObj *)handle;
+
+    pthread_cond_destroy(&sem->cond);
+    pthread_mutex_destroy(&sem->lock);
+    free(sem);
+}
+
+/*
+ *  ======== SemaphoreP_Params_init ========
+ */
+void SemaphoreP_Params_init(SemaphoreP_Params *params)
+{
+    params->mode = SemaphoreP_Mode_COUNTING;
+    params->callback = NULL;
+}
+
+/*
+ *  ======== SemaphoreP_pend ========
+ */
+SemaphoreP_Status SemaphoreP_pend(SemaphoreP_Handle handle, uint32_t timeout)
+{
+    SemaphoreP_PosixObj *sem = (SemaphoreP_PosixObj *)handle;
+    SemaphoreP_Status status = SemaphoreP_OK;
+    struct timespec deadline;
+    int err = 0;
+
+    if ((timeout != SemaphoreP_WAIT_FOREVER) && (timeout != SemaphoreP_NO_WAIT)) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&sem->lock);
+    while ((sem->count == 0) && (err != ETIMEDOUT)) {
+        if (timeout == SemaphoreP_NO_WAIT) {
+            err = ETIMEDOUT;
+        }
+        else if (timeout == SemaphoreP_WAIT_FOREVER) {
+            pthread_cond_wait(&sem->cond, &sem->lock);
+        }
+        else {
+            err = pthread_cond_timedwait(&sem->cond, &sem->lock, &deadline);
+        }
+    }
+
+    if (sem->count > 0) {
+        sem->count--;
+    }
+    else {
+        status = SemaphoreP_TIMEOUT;
+    }
+    pthread_mutex_unlock(&sem->lock);
+
+    return (status);
+}
+
+/*
+ *  ======== SemaphoreP_post ========
+ */
+void SemaphoreP_post(SemaphoreP_Handle handle)
+{
+    SemaphoreP_PosixObj *sem = (SemaphoreP_PosixObj *)handle;
+
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->maxCount) {
+        sem->count++;
+    }
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+}
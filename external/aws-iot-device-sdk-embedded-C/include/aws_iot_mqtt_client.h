@@ -63,6 +63,25 @@ extern "C" {
 
 #define MAX_PACKET_ID 65535
 
+#ifndef AWS_IOT_MQTT_NUM_TOPIC_NODES
+#define AWS_IOT_MQTT_NUM_TOPIC_NODES (AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS * 4)
+#endif
+
+#ifndef AWS_IOT_MQTT_TOPIC_HASH_SIZE
+#define AWS_IOT_MQTT_TOPIC_HASH_SIZE 16
+#endif
+
+#if (AWS_IOT_MQTT_TOPIC_HASH_SIZE & (AWS_IOT_MQTT_TOPIC_HASH_SIZE - 1))
+#error "AWS_IOT_MQTT_TOPIC_HASH_SIZE must be a power of 2"
+#endif
+
+#ifndef AWS_IOT_MQTT_TOPIC_MAX_ACTIVE
+#define AWS_IOT_MQTT_TOPIC_MAX_ACTIVE 8
+#endif
+
+/* No topic node, also the parent of the top level nodes */
+#define AWS_IOT_MQTT_TOPIC_NODE_NONE 0xFFFF
+
 typedef struct _Client AWS_IoT_Client;
 
 /**
@@ -92,6 +111,29 @@ typedef struct {
 	size_t payloadLen;	///< Length of MQTT payload.
 } IoT_Publish_Message_Params;
 
+/**
+ * @brief Publish Payload Writer Type
+ *
+ * Defining a TYPE for callbacks writing an outgoing payload in parts.
+ * Called with the room left in the write buffer, writes the payload bytes from
+ * offset on into pBuf and returns how many it wrote, at most bufLen.
+ *
+ */
+typedef size_t (*pPayloadWriter_t)(unsigned char *pBuf, size_t bufLen, size_t offset, void *pWriterData);
+
+/**
+ * @brief Publish Payload Reader Type
+ *
+ * Defining a TYPE for callbacks reading an incoming payload in parts.
+ * Called, in order, with each part of a QoS0 message too long for the read
+ * buffer: chunkLen bytes of the payload from offset on, out of payloadLen.
+ * The message is complete once offset + chunkLen is payloadLen. A message cut
+ * short by a read error gets no more parts, the next one starts at offset 0.
+ *
+ */
+typedef void (*pPayloadReader_t)(const char *pTopicName, uint16_t topicNameLen, const unsigned char *pChunk,
+								 size_t chunkLen, size_t offset, size_t payloadLen, void *pReaderData);
+
 /**
  * @brief MQTT Version Type
  *
@@ -233,8 +275,42 @@ typedef struct _MessageHandlers {
 	QoS qos;
 	pApplicationHandler_t pApplicationHandler;
 	void *pApplicationHandlerData;
+	uint16_t topicNode;		///< Index node the topic filter ends at, AWS_IOT_MQTT_TOPIC_NODE_NONE if not indexed
+	uint16_t nextHandler;	///< Next message handler whose topic filter ends at the same node
 } MessageHandlers;   /* Message handlers are indexed by subscription topic */
 
+/**
+ * @brief Topic Index Node
+ *
+ * One level of the subscribed topic filters, '+' and '#' levels included.
+ * Nodes are hashed on their parent and level, so each level of an incoming
+ * topic is resolved with a few bucket probes whatever the number of
+ * subscriptions.
+ *
+ */
+typedef struct _TopicIndexNode {
+	uint32_t levelHash;		///< Hash of the topic level
+	uint16_t levelLen;		///< Length of the topic level
+	uint16_t parent;		///< Node one level up, AWS_IOT_MQTT_TOPIC_NODE_NONE at the top level
+	uint16_t hashNext;		///< Next node in the hash bucket
+	uint16_t refCount;		///< Topic filters running through or ending at this node, 0 if the node is free
+	uint16_t firstHandler;	///< First message handler whose topic filter ends here
+} TopicIndexNode;
+
+/**
+ * @brief Topic Index Statistics
+ *
+ * Counters of the incoming PUBLISH dispatch through the topic index
+ *
+ */
+typedef struct _TopicIndexStats {
+	uint32_t deliveries;		///< Incoming PUBLISH messages dispatched
+	uint32_t bucketProbes;		///< Hash buckets probed to resolve topic levels
+	uint32_t handlersMatched;	///< Message handlers called
+	uint32_t rejected;			///< Handlers the index yielded that the full topic filter match turned down
+	uint32_t fullScans;			///< Dispatches that scanned every message handler
+} TopicIndexStats;
+
 /**
  * @brief MQTT Client Status
  *
@@ -285,7 +361,17 @@ typedef struct _ClientData {
 	MessageHandlers messageHandlers[AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS];
 	iot_disconnect_handler disconnectHandler;
 
+	/* Index of the message handlers by topic filter level */
+	TopicIndexNode topicNodes[AWS_IOT_MQTT_NUM_TOPIC_NODES];
+	uint16_t topicNodeHash[AWS_IOT_MQTT_TOPIC_HASH_SIZE];
+	uint16_t freeTopicNodes;
+	uint16_t unindexedHandlers;		///< Handlers the index had no room for, dispatched by scanning
+	TopicIndexStats topicIndexStats;
+
 	void *disconnectHandlerData;
+
+	pPayloadReader_t payloadReader;		///< Takes the messages too long for the read buffer, or NULL
+	void *payloadReaderData;
 } ClientData;
 
 /**
@@ -411,6 +497,31 @@ uint32_t aws_iot_mqtt_get_network_disconnected_count(AWS_IoT_Client *pClient);
  */
 void aws_iot_mqtt_reset_network_disconnected_count(AWS_IoT_Client *pClient);
 
+/**
+ * @brief Set the reader of the messages too long for the read buffer
+ *
+ * Without a reader, a message longer than AWS_IOT_MQTT_RX_BUF_LEN is dropped.
+ * With one, a QoS0 PUBLISH of any length is handed to it in parts through the
+ * read buffer, whatever its topic. Longer QoS1 messages are still dropped.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pReader Reader of the payload parts, or NULL to drop such messages again
+ * @param pReaderData Reference to the data to be passed as argument when the reader is called
+ *
+ * @return IoT_Error_t Type defining successful/failed API call
+ */
+IoT_Error_t aws_iot_mqtt_set_payload_reader(AWS_IoT_Client *pClient, pPayloadReader_t pReader, void *pReaderData);
+
+/**
+ * @brief Get the topic index statistics
+ *
+ * Called to read the counters of the incoming PUBLISH dispatch
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pStats Filled with the counters
+ */
+void aws_iot_mqtt_get_topic_index_stats(AWS_IoT_Client *pClient, TopicIndexStats *pStats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -112,6 +112,8 @@ void aws_iot_mqtt_internal_write_utf8_string(unsigned char **pptr, const char *s
 
 IoT_Error_t aws_iot_mqtt_internal_flushBuffers( AWS_IoT_Client *pClient );
 IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t length, Timer *pTimer);
+IoT_Error_t aws_iot_mqtt_internal_send_packet_chunked(AWS_IoT_Client *pClient, size_t headerLen, size_t payloadLen,
+													  pPayloadWriter_t writer, void *pWriterData, Timer *pTimer);
 IoT_Error_t aws_iot_mqtt_internal_cycle_read(AWS_IoT_Client *pClient, Timer *pTimer, uint8_t *pPacketType);
 IoT_Error_t aws_iot_mqtt_internal_wait_for_read(AWS_IoT_Client *pClient, uint8_t packetType, Timer *pTimer);
 IoT_Error_t aws_iot_mqtt_internal_serialize_zero(unsigned char *pTxBuf, size_t txBufLen,
@@ -122,6 +124,10 @@ IoT_Error_t aws_iot_mqtt_internal_deserialize_publish(uint8_t *dup, QoS *qos,
 													  unsigned char **payload, size_t *payloadLen,
 													  unsigned char *pRxBuf, size_t rxBufLen);
 
+void aws_iot_mqtt_internal_topic_index_init(AWS_IoT_Client *pClient);
+void aws_iot_mqtt_internal_topic_index_add(AWS_IoT_Client *pClient, uint32_t handlerIndex);
+void aws_iot_mqtt_internal_topic_index_remove(AWS_IoT_Client *pClient, uint32_t handlerIndex);
+
 IoT_Error_t aws_iot_mqtt_set_client_state(AWS_IoT_Client *pClient, ClientState expectedCurrentState,
 										  ClientState newState);
 
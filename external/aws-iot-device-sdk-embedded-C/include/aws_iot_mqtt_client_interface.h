@@ -111,6 +111,28 @@ IoT_Error_t aws_iot_mqtt_connect(AWS_IoT_Client *pClient, IoT_Client_Connect_Par
 IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
 								 IoT_Publish_Message_Params *pParams);
 
+/**
+ * @brief Publish an MQTT message written in parts on a topic
+ *
+ * Same as aws_iot_mqtt_publish, except that the payload is written straight
+ * into the write buffer by a callback instead of being copied from
+ * pParams->payload. pParams->payloadLen gives the payload length, which may
+ * exceed the write buffer: the packet then goes out in several writes, the
+ * callback being asked for the payload from where the previous write ended.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicName Topic Name to publish to
+ * @param topicNameLen Length of the topic name
+ * @param pParams Pointer to Publish Message parameters, payload is not used
+ * @param writer Callback writing the payload
+ * @param pWriterData Passed on to the callback
+ *
+ * @return An IoT Error Type defining successful/failed publish
+ */
+IoT_Error_t aws_iot_mqtt_publish_with_writer(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+											 IoT_Publish_Message_Params *pParams, pPayloadWriter_t writer,
+											 void *pWriterData);
+
 /**
  * @brief Subscribe to an MQTT topic.
  *
@@ -18,6 +18,17 @@
 
 #include <ti/net/slnetsock.h>
 
+#ifndef IOT_TLS_READ_AHEAD_LEN
+/**
+ * @brief Size of the per socket read-ahead buffer
+ *
+ * Reads shorter than this are served from one larger receive, so the fixed
+ * header, remaining length and body of a small packet cost a single receive
+ * from the network processor.
+ */
+#define IOT_TLS_READ_AHEAD_LEN 128
+#endif
+
 /**
  * @brief TLS Connection Parameters
  *
@@ -28,6 +39,10 @@ typedef struct TLSDataParams {
     int16_t ifId;
     int skt;
     SlNetSockSecAttrib_t *secAttrib;
+    uint32_t rcvTimeoutMs;      /* SO_RCVTIMEO applied to skt, 0 if none */
+    uint16_t rxOffset;          /* next unread byte in rxBuf */
+    uint16_t rxLen;             /* bytes held in rxBuf */
+    unsigned char rxBuf[IOT_TLS_READ_AHEAD_LEN];
 } TLSDataParams;
 
 
@@ -39,6 +39,50 @@ extern void checkIfFileExists(uint8_t *certName);
 
 extern uint32_t NetWiFi_isConnected(void);
 
+/*
+ * A receive timeout already applied to the socket is reused while it is
+ * within 1/8 (and at least IOT_TLS_RCVTIMEO_SLACK_MS) of the one asked for,
+ * each setsockopt() being a round trip to the network processor.
+ */
+#define IOT_TLS_RCVTIMEO_SLACK_MS 2
+
+static void iot_tls_reset_rx(TLSDataParams *tlsDataParams)
+{
+    tlsDataParams->rcvTimeoutMs = 0;
+    tlsDataParams->rxOffset = 0;
+    tlsDataParams->rxLen = 0;
+}
+
+static int iot_tls_set_rcv_timeout(TLSDataParams *tlsDataParams,
+        uint32_t timeout)
+{
+    struct timeval tv;
+    uint32_t applied = tlsDataParams->rcvTimeoutMs;
+    uint32_t slack = timeout / 8;
+    uint32_t diff;
+
+    if (slack < IOT_TLS_RCVTIMEO_SLACK_MS) {
+        slack = IOT_TLS_RCVTIMEO_SLACK_MS;
+    }
+
+    diff = (applied > timeout) ? (applied - timeout) : (timeout - applied);
+    if ((applied != 0) && (diff <= slack)) {
+        return (0);
+    }
+
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+
+    if (setsockopt(tlsDataParams->skt, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv,
+            sizeof(struct timeval)) != 0) {
+        tlsDataParams->rcvTimeoutMs = 0;
+        return (-1);
+    }
+
+    tlsDataParams->rcvTimeoutMs = timeout;
+    return (0);
+}
+
 static void iot_tls_set_connect_params(Network *pNetwork, char *pRootCALocation,
         char *pDeviceCertLocation, char *pDevicePrivateKeyLocation,
         char *pDestinationURL, uint16_t DestinationPort, uint32_t timeout_ms,
@@ -79,6 +123,7 @@ IoT_Error_t iot_tls_init(Network *pNetwork, char *pRootCALocation,
     pNetwork->tlsDataParams.ifId = 0; /* init to invalid interface ID */
     pNetwork->tlsDataParams.skt = -1; /* INVALID socket */
     pNetwork->tlsDataParams.secAttrib = NULL;
+    iot_tls_reset_rx(&pNetwork->tlsDataParams);
 
     FUNC_EXIT_RC(SUCCESS);
 }
@@ -116,6 +161,7 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *TLSParams)
     /* Use TLS params in Network struct */
     tlsParams = &pNetwork->tlsConnectParams;
     tlsDataParams = &pNetwork->tlsDataParams;
+    iot_tls_reset_rx(tlsDataParams);
 
     /* Convert the AWS server's port number to a string */
     status = sprintf(portStr, "%d", tlsParams->DestinationPort);
@@ -352,11 +398,11 @@ IoT_Error_t iot_tls_write(Network *pNetwork, unsigned char *pMsg, size_t len,
 IoT_Error_t iot_tls_read(Network *pNetwork, unsigned char *pMsg, size_t len,
         Timer *timer, size_t *numbytes)
 {
+    TLSDataParams *tlsDataParams;
     int bytesLeft;
     int bytesRcvd = 0;
     int totalBytes = 0;
-    int skt;
-    struct timeval tv;
+    int buffered;
     uint32_t timeout;
 
     FUNC_ENTRY;
@@ -367,51 +413,76 @@ IoT_Error_t iot_tls_read(Network *pNetwork, unsigned char *pMsg, size_t len,
         FUNC_EXIT_RC(NULL_VALUE_ERROR);
     }
 
-    timeout = left_ms(timer);
-    if (timeout == 0) {
-        /* sock timeout of 0 == block forever; just read + return if expired */
-        timeout = 1;
-    }
-
-    tv.tv_sec = timeout / 1000;
-    tv.tv_usec = (timeout % 1000) * 1000;
+    tlsDataParams = &pNetwork->tlsDataParams;
 
-    skt = pNetwork->tlsDataParams.skt;
+    /* Receive all bytes requested, read-ahead bytes first */
+    bytesLeft = len;
+    while (bytesLeft > 0) {
+        buffered = tlsDataParams->rxLen - tlsDataParams->rxOffset;
+        if (buffered > 0) {
+            if (buffered > bytesLeft) {
+                buffered = bytesLeft;
+            }
+            memcpy(pMsg, &tlsDataParams->rxBuf[tlsDataParams->rxOffset],
+                    buffered);
+            tlsDataParams->rxOffset += buffered;
+            bytesLeft -= buffered;
+            totalBytes += buffered;
+            pMsg += buffered;
+            continue;
+        }
 
-    if (setsockopt(skt, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv,
-            sizeof(struct timeval)) == 0) {
+        timeout = left_ms(timer);
+        if (timeout == 0) {
+            /* sock timeout of 0 == block forever; just read + return if expired */
+            timeout = 1;
+        }
 
-        /* Receive all bytes requested */
-        bytesLeft = len;
-        while (bytesLeft > 0) {
-            bytesRcvd = recv(skt, pMsg, bytesLeft, 0);
+        if (iot_tls_set_rcv_timeout(tlsDataParams, timeout) != 0) {
+            bytesRcvd = 0;
+            break;
+        }
 
+        if (bytesLeft >= IOT_TLS_READ_AHEAD_LEN) {
+            /* Large reads go straight to the caller's buffer */
+            bytesRcvd = recv(tlsDataParams->skt, pMsg, bytesLeft, 0);
             if (bytesRcvd > 0) {
                 bytesLeft -= bytesRcvd;
                 totalBytes += bytesRcvd;
                 pMsg += bytesRcvd;
             }
-            else if (bytesRcvd < 0 && errno != EAGAIN) {
-                IOT_ERROR("recv failed (errno = %d)\n", errno);
-                break;
-            }
-            else {
-                /* recv() returned 0 */
-                break;
+        }
+        else {
+            /* Small reads take whatever else is pending with them */
+            bytesRcvd = recv(tlsDataParams->skt, tlsDataParams->rxBuf,
+                    IOT_TLS_READ_AHEAD_LEN, 0);
+            if (bytesRcvd > 0) {
+                tlsDataParams->rxOffset = 0;
+                tlsDataParams->rxLen = bytesRcvd;
             }
         }
-        /* Report back what was received, even if an error occurred. */
-        *numbytes = (size_t)totalBytes;
-        if (totalBytes == len) {
-            /* All requested bytes received, success */
-            FUNC_EXIT_RC(SUCCESS);
+
+        if (bytesRcvd < 0 && errno != EAGAIN) {
+            IOT_ERROR("recv failed (errno = %d)\n", errno);
+            break;
         }
-        else if ((bytesRcvd == -1) && (errno == EAGAIN)) {
-            /* nothing to read in the socket buffer */
-            FUNC_EXIT_RC(NETWORK_SSL_NOTHING_TO_READ);
+        else if (bytesRcvd <= 0) {
+            /* recv() returned 0, or timed out */
+            break;
         }
-        /* else recv() failed or returned 0, fall through */
     }
+
+    /* Report back what was received, even if an error occurred. */
+    *numbytes = (size_t)totalBytes;
+    if (totalBytes == len) {
+        /* All requested bytes received, success */
+        FUNC_EXIT_RC(SUCCESS);
+    }
+    else if ((bytesRcvd == -1) && (errno == EAGAIN)) {
+        /* nothing to read in the socket buffer */
+        FUNC_EXIT_RC(NETWORK_SSL_NOTHING_TO_READ);
+    }
+    /* else recv() failed or returned 0, fall through */
     FUNC_EXIT_RC(NETWORK_SSL_READ_ERROR);
 }
 
@@ -436,6 +507,7 @@ IoT_Error_t iot_tls_destroy(Network *pNetwork)
         close(pNetwork->tlsDataParams.skt);
         pNetwork->tlsDataParams.skt = -1;
     }
+    iot_tls_reset_rx(&pNetwork->tlsDataParams);
 
     if (pNetwork->tlsDataParams.secAttrib) {
         SlNetSock_secAttribDelete(pNetwork->tlsDataParams.secAttrib);
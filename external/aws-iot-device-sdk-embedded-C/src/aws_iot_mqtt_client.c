@@ -43,6 +43,7 @@ extern "C" {
 
 #include "aws_iot_log.h"
 #include "aws_iot_mqtt_client_interface.h"
+#include "aws_iot_mqtt_client_common_internal.h"
 #include "aws_iot_version.h"
 
 #if !DISABLE_METRICS
@@ -221,6 +222,7 @@ IoT_Error_t aws_iot_mqtt_init(AWS_IoT_Client *pClient, IoT_Client_Init_Params *p
 		pClient->clientData.messageHandlers[i].pApplicationHandlerData = NULL;
 		pClient->clientData.messageHandlers[i].qos = QOS0;
 	}
+	aws_iot_mqtt_internal_topic_index_init(pClient);
 
 	pClient->clientData.packetTimeoutMs = pInitParams->mqttPacketTimeout_ms;
 	pClient->clientData.commandTimeoutMs = pInitParams->mqttCommandTimeout_ms;
@@ -229,6 +231,8 @@ IoT_Error_t aws_iot_mqtt_init(AWS_IoT_Client *pClient, IoT_Client_Init_Params *p
 	pClient->clientData.counterNetworkDisconnected = 0;
 	pClient->clientData.disconnectHandler = pInitParams->disconnectHandler;
 	pClient->clientData.disconnectHandlerData = pInitParams->disconnectHandlerData;
+	pClient->clientData.payloadReader = NULL;
+	pClient->clientData.payloadReaderData = NULL;
 	pClient->clientData.nextPacketId = 1;
 
 	/* Initialize default connection options */
@@ -354,6 +358,17 @@ IoT_Error_t aws_iot_mqtt_set_disconnect_handler(AWS_IoT_Client *pClient, iot_dis
 	FUNC_EXIT_RC(SUCCESS);
 }
 
+IoT_Error_t aws_iot_mqtt_set_payload_reader(AWS_IoT_Client *pClient, pPayloadReader_t pReader, void *pReaderData) {
+	FUNC_ENTRY;
+	if(NULL == pClient) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	pClient->clientData.payloadReader = pReader;
+	pClient->clientData.payloadReaderData = pReaderData;
+	FUNC_EXIT_RC(SUCCESS);
+}
+
 uint32_t aws_iot_mqtt_get_network_disconnected_count(AWS_IoT_Client *pClient) {
 	return pClient->clientData.counterNetworkDisconnected;
 }
@@ -362,6 +377,10 @@ void aws_iot_mqtt_reset_network_disconnected_count(AWS_IoT_Client *pClient) {
 	pClient->clientData.counterNetworkDisconnected = 0;
 }
 
+void aws_iot_mqtt_get_topic_index_stats(AWS_IoT_Client *pClient, TopicIndexStats *pStats) {
+	*pStats = pClient->clientData.topicIndexStats;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -264,10 +264,47 @@ IoT_Error_t aws_iot_mqtt_internal_init_header(MQTTHeader *pHeader, MessageTypes
 	FUNC_EXIT_RC(SUCCESS);
 }
 
-IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t length, Timer *pTimer) {
+/**
+ * Writes the first length bytes of the write buffer to the network.
+ * The caller holds the TLS write mutex.
+ */
+static IoT_Error_t _aws_iot_mqtt_internal_write_buffer(AWS_IoT_Client *pClient, size_t length, Timer *pTimer) {
 
 	size_t sentLen, sent;
+	IoT_Error_t rc = SUCCESS;
+
+	sentLen = 0;
+	sent = 0;
+
+	while(sent < length && !has_timer_expired(pTimer)) {
+		rc = pClient->networkStack.write(&(pClient->networkStack),
+						 &pClient->clientData.writeBuf[sent],
+						 (length - sent),
+						 pTimer,
+						 &sentLen);
+		if(SUCCESS != rc) {
+			/* there was an error writing the data */
+			break;
+		}
+		sent += sentLen;
+	}
+
+	if(sent == length) {
+		/* record the fact that we have successfully sent the packet */
+		//countdown_sec(&c->pingTimer, c->clientData.keepAliveInterval);
+		return SUCCESS;
+	}
+
+	/* the timer ran out with the packet partly written */
+	return (SUCCESS == rc) ? NETWORK_SSL_WRITE_TIMEOUT_ERROR : rc;
+}
+
+IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t length, Timer *pTimer) {
+
 	IoT_Error_t rc;
+#ifdef _ENABLE_THREAD_SUPPORT_
+	IoT_Error_t threadRc;
+#endif
 
 	FUNC_ENTRY;
 
@@ -286,36 +323,92 @@ IoT_Error_t aws_iot_mqtt_internal_send_packet(AWS_IoT_Client *pClient, size_t le
 	}
 #endif
 
-	sentLen = 0;
-	sent = 0;
+	rc = _aws_iot_mqtt_internal_write_buffer(pClient, length, pTimer);
 
-	while(sent < length && !has_timer_expired(pTimer)) {
-		rc = pClient->networkStack.write(&(pClient->networkStack),
-						 &pClient->clientData.writeBuf[sent],
-						 (length - sent),
-						 pTimer,
-						 &sentLen);
-		if(SUCCESS != rc) {
-			/* there was an error writing the data */
-			break;
-		}
-		sent += sentLen;
+#ifdef _ENABLE_THREAD_SUPPORT_
+	threadRc = aws_iot_mqtt_client_unlock_mutex(pClient, &(pClient->clientData.tls_write_mutex));
+	if(SUCCESS != threadRc) {
+		FUNC_EXIT_RC(threadRc);
 	}
+#endif
+
+	FUNC_EXIT_RC(rc);
+}
 
+/**
+ * Sends a packet whose payload does not need to fit the write buffer.
+ *
+ * The first headerLen bytes of the write buffer hold the serialized packet
+ * up to the payload. The writer fills the rest of the buffer with payload
+ * bytes, the buffer is sent and refilled from the start until payloadLen
+ * payload bytes went out. The TLS write mutex is held for the whole packet.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param headerLen length of the serialized packet ahead of the payload
+ * @param payloadLen length of the payload
+ * @param writer callback writing the payload into the write buffer
+ * @param pWriterData passed on to the writer
+ * @param pTimer timer bounding the whole send
+ *
+ * @return An IoT Error Type defining successful/failed send
+ */
+IoT_Error_t aws_iot_mqtt_internal_send_packet_chunked(AWS_IoT_Client *pClient, size_t headerLen, size_t payloadLen,
+													  pPayloadWriter_t writer, void *pWriterData, Timer *pTimer) {
+
+	size_t offset, length, written;
+	IoT_Error_t rc = SUCCESS;
 #ifdef _ENABLE_THREAD_SUPPORT_
-	rc = aws_iot_mqtt_client_unlock_mutex(pClient, &(pClient->clientData.tls_write_mutex));
+	IoT_Error_t threadRc;
+#endif
+
+	FUNC_ENTRY;
+
+	if(NULL == pClient || NULL == writer || NULL == pTimer) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	if(headerLen >= pClient->clientData.writeBufSize) {
+		FUNC_EXIT_RC(MQTT_TX_BUFFER_TOO_SHORT_ERROR);
+	}
+
+#ifdef _ENABLE_THREAD_SUPPORT_
+	rc = aws_iot_mqtt_client_lock_mutex(pClient, &(pClient->clientData.tls_write_mutex));
 	if(SUCCESS != rc) {
 		FUNC_EXIT_RC(rc);
 	}
 #endif
 
-	if(sent == length) {
-		/* record the fact that we have successfully sent the packet */
-		//countdown_sec(&c->pingTimer, c->clientData.keepAliveInterval);
-		FUNC_EXIT_RC(SUCCESS);
+	offset = 0;
+	length = headerLen;
+
+	do {
+		/* same limit on one write as aws_iot_mqtt_internal_send_packet */
+		written = writer(&pClient->clientData.writeBuf[length], pClient->clientData.writeBufSize - 1 - length,
+						 offset, pWriterData);
+		if(written > payloadLen - offset) {
+			written = payloadLen - offset;
+		}
+		if(0 == written && offset < payloadLen) {
+			/* the writer came up short of the announced payload length */
+			rc = FAILURE;
+			break;
+		}
+
+		offset += written;
+		length += written;
+
+		rc = _aws_iot_mqtt_internal_write_buffer(pClient, length, pTimer);
+		length = 0;
+	} while(SUCCESS == rc && offset < payloadLen);
+
+#ifdef _ENABLE_THREAD_SUPPORT_
+	threadRc = aws_iot_mqtt_client_unlock_mutex(pClient, &(pClient->clientData.tls_write_mutex));
+	if(SUCCESS != threadRc) {
+		FUNC_EXIT_RC(threadRc);
 	}
+#endif
 
-	FUNC_EXIT_RC(rc) 
+	FUNC_EXIT_RC(rc);
 }
 
 static IoT_Error_t _aws_iot_mqtt_internal_readWrapper( AWS_IoT_Client *pClient, size_t offset, size_t size, Timer *pTimer, size_t * read_len ) {
@@ -378,8 +471,69 @@ static IoT_Error_t _aws_iot_mqtt_internal_decode_packet_remaining_len(AWS_IoT_Cl
 	FUNC_EXIT_RC(rc);
 }
 
+/* Reads the rest of a packet longer than the read buffer. A QoS0 PUBLISH is
+ * handed to the payload reader in parts read after its topic, anything else
+ * is read into the buffer and dropped. */
+static IoT_Error_t _aws_iot_mqtt_internal_read_long_packet(AWS_IoT_Client *pClient, size_t offset, size_t rem_len,
+															Timer *pTimer, bool *pRead) {
+	pPayloadReader_t reader = NULL;
+	unsigned char *pBuf = pClient->clientData.readBuf;
+	size_t total_bytes_read = 0;
+	size_t bytes_to_be_read, read_len, partStart;
+	uint16_t topicLen = 0;
+	IoT_Error_t rc = SUCCESS;
+
+	*pRead = false;
+	partStart = 0;
+
+	if(NULL != pClient->clientData.payloadReader && PUBLISH == MQTT_HEADER_FIELD_TYPE(pBuf[0]) &&
+	   QOS0 == MQTT_HEADER_FIELD_QOS(pBuf[0]) && rem_len >= 2) {
+		rc = _aws_iot_mqtt_internal_readWrapper(pClient, offset, 2, pTimer, &read_len);
+		if(SUCCESS != rc || 2 != read_len) {
+			return FAILURE;
+		}
+		total_bytes_read = 2;
+		topicLen = (uint16_t)((pBuf[offset] << 8) | pBuf[offset + 1]);
+
+		/* the topic stays at the start of the buffer, the parts go after it */
+		if(2 + (size_t)topicLen <= rem_len && offset + 2 + (size_t)topicLen < pClient->clientData.readBufSize) {
+			rc = _aws_iot_mqtt_internal_readWrapper(pClient, offset + 2, topicLen, pTimer, &read_len);
+			if(SUCCESS != rc || topicLen != read_len) {
+				return FAILURE;
+			}
+			total_bytes_read += topicLen;
+			partStart = offset + 2 + topicLen;
+			reader = pClient->clientData.payloadReader;
+		}
+	}
+
+	while(total_bytes_read < rem_len && SUCCESS == rc) {
+		bytes_to_be_read = pClient->clientData.readBufSize - partStart;
+		if(rem_len - total_bytes_read < bytes_to_be_read) {
+			bytes_to_be_read = rem_len - total_bytes_read;
+		}
+		rc = pClient->networkStack.read(&(pClient->networkStack), pBuf + partStart, bytes_to_be_read,
+										pTimer, &read_len);
+		if(SUCCESS == rc) {
+			if(NULL != reader) {
+				reader((const char *)&pBuf[offset + 2], topicLen, pBuf + partStart, read_len,
+					   total_bytes_read - 2 - topicLen, rem_len - 2 - topicLen,
+					   pClient->clientData.payloadReaderData);
+			}
+			total_bytes_read += read_len;
+		}
+	}
+
+	aws_iot_mqtt_internal_flushBuffers(pClient);
+	if(SUCCESS == rc) {
+		*pRead = (NULL != reader);
+	}
+	return rc;
+}
+
 static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, Timer *pTimer, uint8_t *pPacketType) {
-	size_t rem_len, total_bytes_read, bytes_to_be_read, read_len;
+	size_t rem_len, read_len;
+	bool handedOver;
 	IoT_Error_t rc;
     size_t offset = 0;
 	MQTTHeader header = {0};
@@ -388,8 +542,6 @@ static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, T
 	countdown_ms(&packetTimer, pClient->clientData.packetTimeoutMs);
 
 	rem_len = 0;
-	total_bytes_read = 0;
-	bytes_to_be_read = 0;
 	read_len = 0;
 
     rc = _aws_iot_mqtt_internal_readWrapper( pClient, offset, 1, pTimer, &read_len );
@@ -406,32 +558,15 @@ static IoT_Error_t _aws_iot_mqtt_internal_read_packet(AWS_IoT_Client *pClient, T
 		return rc;
 	} 
      
-	/* if the buffer is too short then the message will be dropped silently */
+	/* if the buffer is too short then the message will be dropped silently,
+	 * unless the payload reader takes it */
 	if((rem_len + offset) >= pClient->clientData.readBufSize) {
-		bytes_to_be_read = pClient->clientData.readBufSize;
-		do {
-			rc = pClient->networkStack.read(&(pClient->networkStack), pClient->clientData.readBuf, bytes_to_be_read,
-											pTimer, &read_len);
-			if(SUCCESS == rc) {
-				total_bytes_read += read_len;
-				if((rem_len - total_bytes_read) >= pClient->clientData.readBufSize) {
-					bytes_to_be_read = pClient->clientData.readBufSize;
-				} else {
-					bytes_to_be_read = rem_len - total_bytes_read;
-				}
-			}
-		} while(total_bytes_read < rem_len && SUCCESS == rc);
-
-        /* Check buffer was correctly emptied, otherwise, return error message. */
-        if ( total_bytes_read == rem_len )
-        {
-            aws_iot_mqtt_internal_flushBuffers( pClient );
-            return MQTT_RX_BUFFER_TOO_SHORT_ERROR;
-        }
-        else
-        {
-            return rc;
-        }
+		rc = _aws_iot_mqtt_internal_read_long_packet(pClient, offset, rem_len, pTimer, &handedOver);
+		if(SUCCESS != rc) {
+			return rc;
+		}
+		/* nothing is left in the buffer for the cycle to handle */
+		return handedOver ? MQTT_NOTHING_TO_READ : MQTT_RX_BUFFER_TOO_SHORT_ERROR;
 	}
 
 	/* 3. read the rest of the buffer using a callback to supply the rest of the data */
@@ -489,12 +624,291 @@ static bool _aws_iot_mqtt_internal_is_topic_matched(char *pTopicFilter, char *pT
 	return (curn == curn_end) && (*curf == '\0');
 }
 
+/* the exact comparison and wildcard matcher the topic index is confirmed with */
+static bool _aws_iot_mqtt_internal_is_handler_matched(MessageHandlers *pHandler, char *pTopicName,
+													  uint16_t topicNameLen) {
+	return ((topicNameLen == pHandler->topicNameLen)
+			&&
+			(strncmp(pTopicName, (char *) pHandler->topicName, topicNameLen) == 0))
+		   || _aws_iot_mqtt_internal_is_topic_matched((char *) pHandler->topicName, pTopicName, topicNameLen);
+}
+
+/* Hash of a topic level of a single character, such as "+" and "#" */
+#define TOPIC_LEVEL_HASH_CHAR(_c) ((2166136261u ^ (uint8_t) (_c)) * 16777619u)
+
+/* Hashes the topic level at pLevel, up to the next separator or pEnd, returns its length */
+static uint16_t _aws_iot_mqtt_internal_topic_level(const char *pLevel, const char *pEnd, uint32_t *pHash) {
+	uint32_t hash = 2166136261u; /* FNV-1a, as TOPIC_LEVEL_HASH_CHAR */
+	const char *cur = pLevel;
+
+	while(cur < pEnd && *cur != '/') {
+		hash = (hash ^ (uint8_t) *cur) * 16777619u;
+		cur++;
+	}
+
+	*pHash = hash;
+	return (uint16_t) (cur - pLevel);
+}
+
+static uint16_t _aws_iot_mqtt_internal_topic_bucket(uint16_t parent, uint32_t levelHash) {
+	return (uint16_t) ((levelHash ^ ((uint32_t) parent * 31u)) & (AWS_IOT_MQTT_TOPIC_HASH_SIZE - 1));
+}
+
+/* Returns the child of parent for the level, AWS_IOT_MQTT_TOPIC_NODE_NONE if there is none */
+static uint16_t _aws_iot_mqtt_internal_topic_child(AWS_IoT_Client *pClient, uint16_t parent, uint32_t levelHash,
+												   uint16_t levelLen) {
+	uint16_t node = pClient->clientData.topicNodeHash[_aws_iot_mqtt_internal_topic_bucket(parent, levelHash)];
+
+	pClient->clientData.topicIndexStats.bucketProbes++;
+
+	while(AWS_IOT_MQTT_TOPIC_NODE_NONE != node) {
+		TopicIndexNode *pNode = &pClient->clientData.topicNodes[node];
+
+		if(pNode->parent == parent && pNode->levelHash == levelHash && pNode->levelLen == levelLen) {
+			break;
+		}
+		node = pNode->hashNext;
+	}
+
+	return node;
+}
+
+void aws_iot_mqtt_internal_topic_index_init(AWS_IoT_Client *pClient) {
+	uint32_t itr;
+
+	for(itr = 0; itr < AWS_IOT_MQTT_NUM_TOPIC_NODES; ++itr) {
+		pClient->clientData.topicNodes[itr].refCount = 0;
+	}
+	for(itr = 0; itr < AWS_IOT_MQTT_TOPIC_HASH_SIZE; ++itr) {
+		pClient->clientData.topicNodeHash[itr] = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+	}
+	for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++itr) {
+		pClient->clientData.messageHandlers[itr].topicNode = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+		pClient->clientData.messageHandlers[itr].nextHandler = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+	}
+
+	pClient->clientData.freeTopicNodes = AWS_IOT_MQTT_NUM_TOPIC_NODES;
+	pClient->clientData.unindexedHandlers = 0;
+	memset(&pClient->clientData.topicIndexStats, 0, sizeof(pClient->clientData.topicIndexStats));
+}
+
+/**
+ * Enters the topic filter of a message handler into the topic index. The
+ * nodes it lacks are taken from the free ones; if there are not enough the
+ * handler is left out of the index and found by scanning instead.
+ */
+void aws_iot_mqtt_internal_topic_index_add(AWS_IoT_Client *pClient, uint32_t handlerIndex) {
+	MessageHandlers *pHandler = &pClient->clientData.messageHandlers[handlerIndex];
+	const char *pLevel = pHandler->topicName;
+	const char *pEnd = pLevel + pHandler->topicNameLen;
+	uint16_t parent = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+	uint16_t missing = 0;
+	bool found = true;
+	uint16_t levelLen;
+	uint32_t levelHash;
+	uint32_t itr = 0;
+
+	pHandler->topicNode = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+	pHandler->nextHandler = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+
+	/* count the nodes the filter needs first, the index is left untouched if they are not there */
+	for(;;) {
+		levelLen = _aws_iot_mqtt_internal_topic_level(pLevel, pEnd, &levelHash);
+		if(found) {
+			parent = _aws_iot_mqtt_internal_topic_child(pClient, parent, levelHash, levelLen);
+			found = (AWS_IOT_MQTT_TOPIC_NODE_NONE != parent);
+		}
+		if(!found) {
+			missing++;
+		}
+		pLevel += levelLen;
+		if(pLevel >= pEnd) {
+			break;
+		}
+		pLevel++;
+	}
+
+	if(missing > pClient->clientData.freeTopicNodes) {
+		pClient->clientData.unindexedHandlers++;
+		return;
+	}
+
+	pLevel = pHandler->topicName;
+	parent = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+
+	for(;;) {
+		uint16_t node;
+
+		levelLen = _aws_iot_mqtt_internal_topic_level(pLevel, pEnd, &levelHash);
+		node = _aws_iot_mqtt_internal_topic_child(pClient, parent, levelHash, levelLen);
+
+		if(AWS_IOT_MQTT_TOPIC_NODE_NONE == node) {
+			uint16_t bucket = _aws_iot_mqtt_internal_topic_bucket(parent, levelHash);
+			TopicIndexNode *pNode;
+
+			while(0 != pClient->clientData.topicNodes[itr].refCount) {
+				itr++;
+			}
+			node = (uint16_t) itr;
+			pNode = &pClient->clientData.topicNodes[node];
+
+			pNode->levelHash = levelHash;
+			pNode->levelLen = levelLen;
+			pNode->parent = parent;
+			pNode->firstHandler = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+			pNode->hashNext = pClient->clientData.topicNodeHash[bucket];
+			pClient->clientData.topicNodeHash[bucket] = node;
+			pClient->clientData.freeTopicNodes--;
+		}
+
+		pClient->clientData.topicNodes[node].refCount++;
+		parent = node;
+
+		pLevel += levelLen;
+		if(pLevel >= pEnd) {
+			break;
+		}
+		pLevel++;
+	}
+
+	pHandler->topicNode = parent;
+	pHandler->nextHandler = pClient->clientData.topicNodes[parent].firstHandler;
+	pClient->clientData.topicNodes[parent].firstHandler = (uint16_t) handlerIndex;
+}
+
+/**
+ * Removes the topic filter of a message handler from the topic index, the
+ * nodes no other filter runs through are freed.
+ */
+void aws_iot_mqtt_internal_topic_index_remove(AWS_IoT_Client *pClient, uint32_t handlerIndex) {
+	MessageHandlers *pHandler = &pClient->clientData.messageHandlers[handlerIndex];
+	uint16_t node = pHandler->topicNode;
+	uint16_t *pLink;
+
+	if(AWS_IOT_MQTT_TOPIC_NODE_NONE == node) {
+		if(0 < pClient->clientData.unindexedHandlers) {
+			pClient->clientData.unindexedHandlers--;
+		}
+		return;
+	}
+
+	pLink = &pClient->clientData.topicNodes[node].firstHandler;
+	while(*pLink != handlerIndex) {
+		pLink = &pClient->clientData.messageHandlers[*pLink].nextHandler;
+	}
+	*pLink = pHandler->nextHandler;
+
+	pHandler->topicNode = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+	pHandler->nextHandler = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+
+	while(AWS_IOT_MQTT_TOPIC_NODE_NONE != node) {
+		TopicIndexNode *pNode = &pClient->clientData.topicNodes[node];
+		uint16_t parent = pNode->parent;
+
+		if(0 == --pNode->refCount) {
+			pLink = &pClient->clientData.topicNodeHash[_aws_iot_mqtt_internal_topic_bucket(parent,
+																							 pNode->levelHash)];
+			while(*pLink != node) {
+				pLink = &pClient->clientData.topicNodes[*pLink].hashNext;
+			}
+			*pLink = pNode->hashNext;
+			pClient->clientData.freeTopicNodes++;
+		}
+
+		node = parent;
+	}
+}
+
+/* Adds the handlers whose topic filter ends at node to the list of matches */
+static void _aws_iot_mqtt_internal_topic_collect(AWS_IoT_Client *pClient, uint16_t node, uint16_t *pMatches,
+												 uint32_t *pMatchCount) {
+	uint16_t handler = pClient->clientData.topicNodes[node].firstHandler;
+
+	while(AWS_IOT_MQTT_TOPIC_NODE_NONE != handler && *pMatchCount < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS) {
+		pMatches[(*pMatchCount)++] = handler;
+		handler = pClient->clientData.messageHandlers[handler].nextHandler;
+	}
+}
+
+/**
+ * Resolves the message handlers whose topic filter may match the topic, one
+ * topic level at a time. Each level follows the exact and '+' children of the
+ * nodes the previous level reached, '#' children match the rest of the topic.
+ *
+ * @return false if the topic fanned out over more than AWS_IOT_MQTT_TOPIC_MAX_ACTIVE nodes
+ */
+static bool _aws_iot_mqtt_internal_topic_resolve(AWS_IoT_Client *pClient, char *pTopicName, uint16_t topicNameLen,
+												 uint16_t *pMatches, uint32_t *pMatchCount) {
+	uint16_t active[2][AWS_IOT_MQTT_TOPIC_MAX_ACTIVE];
+	uint32_t activeCount = 1, nextCount, itr;
+	uint32_t levelHash;
+	const char *pLevel = pTopicName;
+	const char *pEnd = pTopicName + topicNameLen;
+	uint16_t *pActive = active[0];
+	uint16_t *pNext = active[1];
+	uint16_t levelLen;
+
+	pActive[0] = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+
+	for(;;) {
+		levelLen = _aws_iot_mqtt_internal_topic_level(pLevel, pEnd, &levelHash);
+		nextCount = 0;
+
+		for(itr = 0; itr < activeCount; ++itr) {
+			uint16_t child = _aws_iot_mqtt_internal_topic_child(pClient, pActive[itr], TOPIC_LEVEL_HASH_CHAR('#'), 1);
+			uint16_t plus;
+
+			if(AWS_IOT_MQTT_TOPIC_NODE_NONE != child) {
+				_aws_iot_mqtt_internal_topic_collect(pClient, child, pMatches, pMatchCount);
+			}
+
+			child = _aws_iot_mqtt_internal_topic_child(pClient, pActive[itr], levelHash, levelLen);
+			plus = _aws_iot_mqtt_internal_topic_child(pClient, pActive[itr], TOPIC_LEVEL_HASH_CHAR('+'), 1);
+			if(plus == child) {
+				/* the level is "+" itself */
+				plus = AWS_IOT_MQTT_TOPIC_NODE_NONE;
+			}
+
+			if(nextCount + (AWS_IOT_MQTT_TOPIC_NODE_NONE != child) + (AWS_IOT_MQTT_TOPIC_NODE_NONE != plus)
+			   > AWS_IOT_MQTT_TOPIC_MAX_ACTIVE) {
+				return false;
+			}
+			if(AWS_IOT_MQTT_TOPIC_NODE_NONE != child) {
+				pNext[nextCount++] = child;
+			}
+			if(AWS_IOT_MQTT_TOPIC_NODE_NONE != plus) {
+				pNext[nextCount++] = plus;
+			}
+		}
+
+		pActive = pNext;
+		pNext = (pActive == active[0]) ? active[1] : active[0];
+		activeCount = nextCount;
+
+		pLevel += levelLen;
+		if(pLevel >= pEnd || 0 == activeCount) {
+			break;
+		}
+		pLevel++;
+	}
+
+	for(itr = 0; itr < activeCount; ++itr) {
+		_aws_iot_mqtt_internal_topic_collect(pClient, pActive[itr], pMatches, pMatchCount);
+	}
+
+	return true;
+}
+
 static IoT_Error_t _aws_iot_mqtt_internal_deliver_message(AWS_IoT_Client *pClient, char *pTopicName,
 														  uint16_t topicNameLen,
 														  IoT_Publish_Message_Params *pMessageParams) {
-	uint32_t itr;
+	uint16_t matches[AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS];
+	uint32_t matchCount = 0;
+	uint32_t itr, pos;
+	bool scanned = false;
 	IoT_Error_t rc;
 	ClientState clientState;
+	MessageHandlers *pHandler;
 
 	FUNC_ENTRY;
 
@@ -508,21 +922,49 @@ static IoT_Error_t _aws_iot_mqtt_internal_deliver_message(AWS_IoT_Client *pClien
 	clientState = aws_iot_mqtt_get_client_state(pClient);
 	aws_iot_mqtt_set_client_state(pClient, clientState, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN);
 
-	/* Find the right message handler - indexed by topic */
-	for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++itr) {
-		if(NULL != pClient->clientData.messageHandlers[itr].topicName) {
-			if(((topicNameLen == pClient->clientData.messageHandlers[itr].topicNameLen)
-				&&
-				(strncmp(pTopicName, (char *) pClient->clientData.messageHandlers[itr].topicName, topicNameLen) == 0))
-			   || _aws_iot_mqtt_internal_is_topic_matched((char *) pClient->clientData.messageHandlers[itr].topicName,
-														  pTopicName, topicNameLen)) {
-				if(NULL != pClient->clientData.messageHandlers[itr].pApplicationHandler) {
-					pClient->clientData.messageHandlers[itr].pApplicationHandler(pClient, pTopicName, topicNameLen,
-																				 pMessageParams,
-																				 pClient->clientData.messageHandlers[itr].pApplicationHandlerData);
-				}
+	pClient->clientData.topicIndexStats.deliveries++;
+
+	/* Find the right message handlers - through the topic index, unless some are not in it */
+	if(0 != pClient->clientData.unindexedHandlers
+	   || !_aws_iot_mqtt_internal_topic_resolve(pClient, pTopicName, topicNameLen, matches, &matchCount)) {
+		pClient->clientData.topicIndexStats.fullScans++;
+		scanned = true;
+		matchCount = 0;
+		for(itr = 0; itr < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++itr) {
+			if(NULL != pClient->clientData.messageHandlers[itr].topicName) {
+				matches[matchCount++] = (uint16_t) itr;
 			}
 		}
+	} else {
+		/* call the handlers in the order they are registered in, like a scan would */
+		for(itr = 1; itr < matchCount; ++itr) {
+			uint16_t handler = matches[itr];
+
+			for(pos = itr; pos > 0 && matches[pos - 1] > handler; --pos) {
+				matches[pos] = matches[pos - 1];
+			}
+			matches[pos] = handler;
+		}
+	}
+
+	for(itr = 0; itr < matchCount; ++itr) {
+		pHandler = &pClient->clientData.messageHandlers[matches[itr]];
+
+		/* a handler called before may have unsubscribed this one */
+		if(NULL == pHandler->topicName) {
+			continue;
+		}
+		if(!_aws_iot_mqtt_internal_is_handler_matched(pHandler, pTopicName, topicNameLen)) {
+			if(!scanned) {
+				pClient->clientData.topicIndexStats.rejected++;
+			}
+			continue;
+		}
+		if(NULL != pHandler->pApplicationHandler) {
+			pClient->clientData.topicIndexStats.handlersMatched++;
+			pHandler->pApplicationHandler(pClient, pTopicName, topicNameLen, pMessageParams,
+										  pHandler->pApplicationHandlerData);
+		}
 	}
 	rc = aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_WAIT_FOR_CB_RETURN, clientState);
 
@@ -535,6 +977,7 @@ static IoT_Error_t _aws_iot_mqtt_internal_handle_publish(AWS_IoT_Client *pClient
 	uint32_t len;
 	IoT_Error_t rc;
 	IoT_Publish_Message_Params msg;
+	Timer ackTimer;
 
 	FUNC_ENTRY;
 
@@ -570,7 +1013,12 @@ static IoT_Error_t _aws_iot_mqtt_internal_handle_publish(AWS_IoT_Client *pClient
 		FUNC_EXIT_RC(rc);
 	}
 
-	rc = aws_iot_mqtt_internal_send_packet(pClient, len, pTimer);
+	/* The PUBACK gets a command timeout of its own, as the PINGREQ does. The
+	 * caller's timer may be a short yield that the read of the PUBLISH ran
+	 * out, and a PUBACK not sent is a dropped connection. */
+	init_timer(&ackTimer);
+	countdown_ms(&ackTimer, pClient->clientData.commandTimeoutMs);
+	rc = aws_iot_mqtt_internal_send_packet(pClient, len, &ackTimer);
 	if(SUCCESS != rc) {
 		FUNC_EXIT_RC(rc);
 	}
@@ -69,7 +69,7 @@ static IoT_Error_t _aws_iot_mqtt_read_string_with_len(char **stringVar, uint16_t
 }
 
 /**
-  * Serializes the supplied publish data into the supplied buffer, ready for sending
+  * Serializes the supplied publish data up to its payload into the supplied buffer
   * @param pTxBuf the buffer into which the packet will be serialized
   * @param txBufLen the length in bytes of the supplied buffer
   * @param dup uint8_t - the MQTT dup flag
@@ -78,24 +78,22 @@ static IoT_Error_t _aws_iot_mqtt_read_string_with_len(char **stringVar, uint16_t
   * @param packetId uint16_t - the MQTT packet identifier
   * @param pTopicName char * - the MQTT topic in the publish
   * @param topicNameLen uint16_t - the length of the Topic Name
-  * @param pPayload byte buffer - the MQTT publish payload
-  * @param payloadLen size_t - the length of the MQTT payload
+  * @param payloadLen size_t - the length of the MQTT payload following the header
   * @param pSerializedLen uint32_t - pointer to the variable that stores serialized len
   *
   * @return An IoT Error Type defining successful/failed call
   */
-static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBuf, size_t txBufLen, uint8_t dup,
-															QoS qos, uint8_t retained, uint16_t packetId,
-															const char *pTopicName, uint16_t topicNameLen,
-															const unsigned char *pPayload, size_t payloadLen,
-															uint32_t *pSerializedLen) {
+static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish_header(unsigned char *pTxBuf, size_t txBufLen, uint8_t dup,
+																   QoS qos, uint8_t retained, uint16_t packetId,
+																   const char *pTopicName, uint16_t topicNameLen,
+																   size_t payloadLen, uint32_t *pSerializedLen) {
 	unsigned char *ptr;
 	uint32_t rem_len;
 	IoT_Error_t rc;
 	MQTTHeader header = {0};
 
 	FUNC_ENTRY;
-	if(NULL == pTxBuf || NULL == pPayload || NULL == pSerializedLen) {
+	if(NULL == pTxBuf || NULL == pSerializedLen) {
 		FUNC_EXIT_RC(NULL_VALUE_ERROR);
 	}
 
@@ -106,7 +104,7 @@ static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBu
 	if(qos > 0) {
 		rem_len += 2; /* packetId */
 	}
-	if(aws_iot_mqtt_internal_get_final_packet_length_from_remaining_length(rem_len) > txBufLen) {
+	if(aws_iot_mqtt_internal_get_final_packet_length_from_remaining_length(rem_len) - payloadLen > txBufLen) {
 		FUNC_EXIT_RC(MQTT_TX_BUFFER_TOO_SHORT_ERROR);
 	}
 
@@ -124,14 +122,56 @@ static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBu
 		aws_iot_mqtt_internal_write_uint_16(&ptr, packetId);
 	}
 
-	memcpy(ptr, pPayload, payloadLen);
-	ptr += payloadLen;
-
 	*pSerializedLen = (uint32_t) (ptr - pTxBuf);
 
 	FUNC_EXIT_RC(SUCCESS);
 }
 
+/**
+  * Serializes the supplied publish data into the supplied buffer, ready for sending
+  * @param pTxBuf the buffer into which the packet will be serialized
+  * @param txBufLen the length in bytes of the supplied buffer
+  * @param dup uint8_t - the MQTT dup flag
+  * @param qos QoS - the MQTT QoS value
+  * @param retained uint8_t - the MQTT retained flag
+  * @param packetId uint16_t - the MQTT packet identifier
+  * @param pTopicName char * - the MQTT topic in the publish
+  * @param topicNameLen uint16_t - the length of the Topic Name
+  * @param pPayload byte buffer - the MQTT publish payload
+  * @param payloadLen size_t - the length of the MQTT payload
+  * @param pSerializedLen uint32_t - pointer to the variable that stores serialized len
+  *
+  * @return An IoT Error Type defining successful/failed call
+  */
+static IoT_Error_t _aws_iot_mqtt_internal_serialize_publish(unsigned char *pTxBuf, size_t txBufLen, uint8_t dup,
+															QoS qos, uint8_t retained, uint16_t packetId,
+															const char *pTopicName, uint16_t topicNameLen,
+															const unsigned char *pPayload, size_t payloadLen,
+															uint32_t *pSerializedLen) {
+	uint32_t header_len;
+	IoT_Error_t rc;
+
+	FUNC_ENTRY;
+	if(NULL == pTxBuf || NULL == pPayload || NULL == pSerializedLen) {
+		FUNC_EXIT_RC(NULL_VALUE_ERROR);
+	}
+
+	rc = _aws_iot_mqtt_internal_serialize_publish_header(pTxBuf, txBufLen, dup, qos, retained, packetId,
+														 pTopicName, topicNameLen, payloadLen, &header_len);
+	if(SUCCESS != rc) {
+		FUNC_EXIT_RC(rc);
+	}
+	if(header_len + payloadLen > txBufLen) {
+		FUNC_EXIT_RC(MQTT_TX_BUFFER_TOO_SHORT_ERROR);
+	}
+
+	memcpy(pTxBuf + header_len, pPayload, payloadLen);
+
+	*pSerializedLen = (uint32_t) (header_len + payloadLen);
+
+	FUNC_EXIT_RC(SUCCESS);
+}
+
 /**
   * Serializes the ack packet into the supplied buffer.
   * @param pTxBuf the buffer into which the packet will be serialized
@@ -195,7 +235,8 @@ IoT_Error_t aws_iot_mqtt_internal_serialize_ack(unsigned char *pTxBuf, size_t tx
  * @return An IoT Error Type defining successful/failed publish
  */
 static IoT_Error_t _aws_iot_mqtt_internal_publish(AWS_IoT_Client *pClient, const char *pTopicName,
-												  uint16_t topicNameLen, IoT_Publish_Message_Params *pParams) {
+												  uint16_t topicNameLen, IoT_Publish_Message_Params *pParams,
+												  pPayloadWriter_t writer, void *pWriterData) {
 	Timer timer;
 	uint32_t len = 0;
 	uint16_t packet_id;
@@ -211,16 +252,30 @@ static IoT_Error_t _aws_iot_mqtt_internal_publish(AWS_IoT_Client *pClient, const
 		pParams->id = aws_iot_mqtt_get_next_packet_id(pClient);
 	}
 
-	rc = _aws_iot_mqtt_internal_serialize_publish(pClient->clientData.writeBuf, pClient->clientData.writeBufSize, 0,
-												  pParams->qos, pParams->isRetained, pParams->id, pTopicName,
-												  topicNameLen, (unsigned char *) pParams->payload,
-												  pParams->payloadLen, &len);
-	if(SUCCESS != rc) {
-		FUNC_EXIT_RC(rc);
-	}
+	if(NULL == writer) {
+		rc = _aws_iot_mqtt_internal_serialize_publish(pClient->clientData.writeBuf, pClient->clientData.writeBufSize, 0,
+													  pParams->qos, pParams->isRetained, pParams->id, pTopicName,
+													  topicNameLen, (unsigned char *) pParams->payload,
+													  pParams->payloadLen, &len);
+		if(SUCCESS != rc) {
+			FUNC_EXIT_RC(rc);
+		}
 
-	/* send the publish packet */
-	rc = aws_iot_mqtt_internal_send_packet(pClient, len, &timer);
+		/* send the publish packet */
+		rc = aws_iot_mqtt_internal_send_packet(pClient, len, &timer);
+	} else {
+		rc = _aws_iot_mqtt_internal_serialize_publish_header(pClient->clientData.writeBuf,
+															 pClient->clientData.writeBufSize, 0, pParams->qos,
+															 pParams->isRetained, pParams->id, pTopicName,
+															 topicNameLen, pParams->payloadLen, &len);
+		if(SUCCESS != rc) {
+			FUNC_EXIT_RC(rc);
+		}
+
+		/* send the publish packet, the payload as the writer produces it */
+		rc = aws_iot_mqtt_internal_send_packet_chunked(pClient, len, pParams->payloadLen, writer, pWriterData,
+													   &timer);
+	}
 	if(SUCCESS != rc) {
 		FUNC_EXIT_RC(rc);
 	}
@@ -259,8 +314,9 @@ static IoT_Error_t _aws_iot_mqtt_internal_publish(AWS_IoT_Client *pClient, const
  *
  * @return An IoT Error Type defining successful/failed publish
  */
-IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
-								 IoT_Publish_Message_Params *pParams) {
+static IoT_Error_t _aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+										 IoT_Publish_Message_Params *pParams, pPayloadWriter_t writer,
+										 void *pWriterData) {
 	IoT_Error_t rc, pubRc;
 	ClientState clientState;
 
@@ -284,7 +340,7 @@ IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName
 		FUNC_EXIT_RC(rc);
 	}
 
-	pubRc = _aws_iot_mqtt_internal_publish(pClient, pTopicName, topicNameLen, pParams);
+	pubRc = _aws_iot_mqtt_internal_publish(pClient, pTopicName, topicNameLen, pParams, writer, pWriterData);
 
 	rc = aws_iot_mqtt_set_client_state(pClient, CLIENT_STATE_CONNECTED_PUBLISH_IN_PROGRESS, clientState);
 	if(SUCCESS == pubRc && SUCCESS != rc) {
@@ -294,6 +350,36 @@ IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName
 	FUNC_EXIT_RC(pubRc);
 }
 
+IoT_Error_t aws_iot_mqtt_publish(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+								 IoT_Publish_Message_Params *pParams) {
+	return _aws_iot_mqtt_publish(pClient, pTopicName, topicNameLen, pParams, NULL, NULL);
+}
+
+/**
+ * @brief Publish an MQTT message written in parts on a topic
+ *
+ * Same as aws_iot_mqtt_publish, with the payload written straight into the
+ * write buffer by the writer, in as many parts as it takes.
+ *
+ * @param pClient Reference to the IoT Client
+ * @param pTopicName Topic Name to publish to
+ * @param topicNameLen Length of the topic name
+ * @param pParams Pointer to Publish Message parameters, payload is not used
+ * @param writer Callback writing the payload
+ * @param pWriterData Passed on to the callback
+ *
+ * @return An IoT Error Type defining successful/failed publish
+ */
+IoT_Error_t aws_iot_mqtt_publish_with_writer(AWS_IoT_Client *pClient, const char *pTopicName, uint16_t topicNameLen,
+											 IoT_Publish_Message_Params *pParams, pPayloadWriter_t writer,
+											 void *pWriterData) {
+	if(NULL == writer) {
+		return NULL_VALUE_ERROR;
+	}
+
+	return _aws_iot_mqtt_publish(pClient, pTopicName, topicNameLen, pParams, writer, pWriterData);
+}
+
 /**
   * Deserializes the supplied (wire) buffer into publish data
   * @param dup returned uint8_t - the MQTT dup flag
@@ -269,6 +269,7 @@ static IoT_Error_t _aws_iot_mqtt_internal_subscribe(AWS_IoT_Client *pClient, con
 	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].pApplicationHandlerData =
 			pApplicationHandlerData;
 	pClient->clientData.messageHandlers[indexOfFreeMessageHandler].qos = qos;
+	aws_iot_mqtt_internal_topic_index_add(pClient, indexOfFreeMessageHandler);
 
 	FUNC_EXIT_RC(SUCCESS);
 }
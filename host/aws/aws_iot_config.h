@@ -0,0 +1,30 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file aws_iot_config.h
+ * @brief AWS IoT configuration of the host AWS IoT programs
+ *
+ * Found ahead of the application configuration. Sized for a gateway
+ * subscribed to the shadow and command topics of many devices, with no
+ * credentials as the programs make no TLS connection.
+ */
+
+#ifndef AWS_IOT_CONFIG_H_
+#define AWS_IOT_CONFIG_H_
+
+#define AWS_IOT_MQTT_HOST              "localhost"
+#define AWS_IOT_MQTT_PORT              8883
+#define AWS_IOT_MQTT_CLIENT_ID         "aws_sub_bench"
+#define AWS_IOT_ROOT_CA_FILENAME       ""
+#define AWS_IOT_CERTIFICATE_FILENAME   ""
+#define AWS_IOT_PRIVATE_KEY_FILENAME   ""
+
+#define AWS_IOT_MQTT_TX_BUF_LEN 512
+#define AWS_IOT_MQTT_RX_BUF_LEN 512
+#define AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS 128
+
+#define AWS_IOT_MQTT_MIN_RECONNECT_WAIT_INTERVAL 1000
+#define AWS_IOT_MQTT_MAX_RECONNECT_WAIT_INTERVAL 128000
+
+#endif /* AWS_IOT_CONFIG_H_ */
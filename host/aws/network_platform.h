@@ -0,0 +1,22 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file network_platform.h
+ * @brief Network platform of the host AWS IoT programs
+ *
+ * Each program is the network layer, the connection keeps no TLS state.
+ */
+
+#ifndef HOST_AWS_NETWORK_PLATFORM_H_
+#define HOST_AWS_NETWORK_PLATFORM_H_
+
+#include <stdint.h>
+
+typedef struct TLSDataParams {
+    int skt;
+    uint16_t rxLen;             /* bytes read ahead, as on the target */
+    uint16_t rxOffset;
+} TLSDataParams;
+
+#endif
@@ -0,0 +1,303 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the documents the AWS driver receives on its event topic.
+ *
+ * The AWS driver is built into the test, and its MQTT client runs over a
+ * network layer that is a minimal broker serving the PUBLISH messages queued
+ * by the test. A shadow document that fits the MQTT RX buffer and one several
+ * times its size both reach the application handler parsed into its object,
+ * the long one a buffer at a time. A long document on another topic, and a
+ * long QoS1 document, are read off the network without reaching it.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+
+#include "../AWSDriver.c"
+#include "aws_iot_mqtt_client_common_internal.h"
+#include "host_util.h"
+
+#define TEST_TEXT_MAX                  (8192)
+#define TEST_LONG_META                 (60)
+
+#define TEST_TEMPLATE                  \
+   "{"                                 \
+      "\"state\":{"                    \
+         "\"reported\":{"              \
+            "\"temp\":int32,"          \
+            "\"fw\":string"            \
+         "}"                           \
+      "},"                             \
+      "\"version\":int32"              \
+   "}"
+
+static AWS_IoT_Client test_Client;
+
+// what the broker has for the client to read
+static unsigned char test_Rx[TEST_TEXT_MAX + 64];
+static size_t test_RxLen;
+static size_t test_RxOff;
+
+static char test_Text[TEST_TEXT_MAX];
+static uint32_t test_Handled;
+static int16_t test_DocRc;
+static int32_t test_Version;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+void UART_PRINT(char *label, ...)
+{
+}
+
+static IoT_Error_t net_Connect(Network *pNetwork, TLSConnectParams *pParams)
+{
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Read(Network *pNetwork, unsigned char *pBuf, size_t len, Timer *pTimer,
+                            size_t *pReadLen)
+{
+   size_t n = test_RxLen - test_RxOff;
+
+   if(0 == n)
+   {
+      *pReadLen = 0;
+      return (NETWORK_SSL_NOTHING_TO_READ);
+   }
+   if(n > len)
+   {
+      n = len;
+   }
+   memcpy(pBuf, test_Rx + test_RxOff, n);
+   test_RxOff += n;
+   if(test_RxOff == test_RxLen)
+   {
+      test_RxOff = 0;
+      test_RxLen = 0;
+   }
+   *pReadLen = n;
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Write(Network *pNetwork, unsigned char *pBuf, size_t len, Timer *pTimer,
+                             size_t *pWritten)
+{
+   static const unsigned char connack[] = { CONNACK << 4, 2, 0, 0 };
+   static unsigned char suback[] = { SUBACK << 4, 3, 0, 0, 0 };
+   size_t off = 1;
+
+   switch(pBuf[0] >> 4)
+   {
+      case CONNECT:
+         memcpy(test_Rx + test_RxLen, connack, sizeof(connack));
+         test_RxLen += sizeof(connack);
+         break;
+      case SUBSCRIBE:
+         // the packet id, past the remaining length
+         while(pBuf[off++] & 0x80)
+         {
+         }
+         suback[2] = pBuf[off];
+         suback[3] = pBuf[off + 1];
+         memcpy(test_Rx + test_RxLen, suback, sizeof(suback));
+         test_RxLen += sizeof(suback);
+         break;
+      default:
+         break;
+   }
+   *pWritten = len;
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Disconnect(Network *pNetwork)
+{
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_IsConnected(Network *pNetwork)
+{
+   return (NETWORK_PHYSICAL_LAYER_CONNECTED);
+}
+
+static IoT_Error_t net_Destroy(Network *pNetwork)
+{
+   return (SUCCESS);
+}
+
+// the network layer of the client
+IoT_Error_t iot_tls_init(Network *pNetwork, char *pRootCALocation, char *pDeviceCertLocation,
+                         char *pDevicePrivateKeyLocation, char *pDestinationURL,
+                         uint16_t DestinationPort, uint32_t timeout_ms, bool ServerVerificationFlag)
+{
+   pNetwork->connect = net_Connect;
+   pNetwork->read = net_Read;
+   pNetwork->write = net_Write;
+   pNetwork->disconnect = net_Disconnect;
+   pNetwork->isConnected = net_IsConnected;
+   pNetwork->destroy = net_Destroy;
+
+   return (SUCCESS);
+}
+
+static void test_Handler(Json_Handle object, int16_t rc)
+{
+   uint16_t size = sizeof(test_Version);
+
+   test_Handled++;
+   test_DocRc = rc;
+   test_Version = -1;
+   if(rc == JSON_RC__OK)
+   {
+      Json_getValue(object, "\"version\"", &test_Version, &size);
+   }
+}
+
+// shadow document of 'version' with 'nMeta' skipped metadata entries
+static int test_TextMake(int version, int nMeta)
+{
+   int len;
+   int i;
+
+   len = snprintf(test_Text, sizeof(test_Text),
+                  "{\"state\":{\"reported\":{\"temp\":215,\"fw\":\"1.4.2\"}},\"metadata\":{");
+   for(i = 0; i < nMeta; i++)
+   {
+      len += snprintf(test_Text + len, sizeof(test_Text) - len,
+                      "%s\"k%04d\":{\"timestamp\":%d}", i ? "," : "", i, 1600000000 + i);
+   }
+   len += snprintf(test_Text + len, sizeof(test_Text) - len, "},\"version\":%d}", version);
+
+   return ((len < (int)sizeof(test_Text) - 1) ? len : -1);
+}
+
+// the broker sends 'len' bytes of test_Text on 'topic', which the client reads
+static IoT_Error_t test_Publish(const char *topic, QoS qos, int len)
+{
+   uint16_t topicLen = (uint16_t)strlen(topic);
+   size_t remLen = 2 + topicLen + ((qos == QOS0) ? 0 : 2) + len;
+   unsigned char *p = test_Rx;
+   uint8_t packetType = 0;
+   Timer timer;
+
+   *p++ = (unsigned char)((PUBLISH << 4) | (qos << 1));
+   p += aws_iot_mqtt_internal_write_len_to_buffer(p, (uint32_t)remLen);
+   *p++ = (unsigned char)(topicLen >> 8);
+   *p++ = (unsigned char)topicLen;
+   memcpy(p, topic, topicLen);
+   p += topicLen;
+   if(qos != QOS0)
+   {
+      *p++ = 0;
+      *p++ = 1;
+   }
+   memcpy(p, test_Text, len);
+   test_RxLen = (p - test_Rx) + len;
+   test_RxOff = 0;
+
+   init_timer(&timer);
+   countdown_ms(&timer, 100);
+   return (aws_iot_mqtt_internal_cycle_read(&test_Client, &timer, &packetType));
+}
+
+static int test_Setup(Json_Handle *pObject)
+{
+   IoT_Client_Init_Params initParams = iotClientInitParamsDefault;
+   IoT_Client_Connect_Params connectParams = iotClientConnectParamsDefault;
+   Json_Handle tmpl;
+
+   initParams.pHostURL = AWS_IOT_MQTT_HOST;
+   initParams.port = AWS_IOT_MQTT_PORT;
+   initParams.pRootCALocation = "";
+   initParams.pDeviceCertLocation = "";
+   initParams.pDevicePrivateKeyLocation = "";
+   initParams.mqttCommandTimeout_ms = 1000;
+   initParams.mqttPacketTimeout_ms = 1000;
+   CHECK(aws_iot_mqtt_init(&test_Client, &initParams) == SUCCESS);
+   connectParams.pClientID = AWS_IOT_MQTT_CLIENT_ID;
+   connectParams.clientIDLen = (uint16_t)strlen(AWS_IOT_MQTT_CLIENT_ID);
+   CHECK(aws_iot_mqtt_connect(&test_Client, &connectParams) == SUCCESS);
+
+   // as AWSDriver_Run sets the client up
+   CHECK(aws_iot_mqtt_set_payload_reader(&test_Client, DocumentReader, NULL) == SUCCESS);
+   CHECK(aws_iot_mqtt_subscribe(&test_Client, EVENT_TOPIC, sizeof(EVENT_TOPIC) - 1, QOS0,
+                                iot_subscribe_callback_handler, NULL) == SUCCESS);
+
+   CHECK(Json_createTemplate(&tmpl, TEST_TEMPLATE, sizeof(TEST_TEMPLATE) - 1) == JSON_RC__OK);
+   CHECK(Json_createObject(pObject, tmpl, 0) == JSON_RC__OK);
+   AWSDriver_SetDocumentHandler(*pObject, test_Handler);
+
+   return (0);
+}
+
+// a document in one buffer, then one several buffers long
+static int test_Parsed(void)
+{
+   int len;
+
+   len = test_TextMake(3, 4);
+   CHECK((len > 0) && (len < AWS_IOT_MQTT_RX_BUF_LEN - 32));
+   CHECK(test_Publish(EVENT_TOPIC, QOS0, len) == SUCCESS);
+   CHECK(test_Handled == 1);
+   CHECK(test_DocRc == JSON_RC__OK);
+   CHECK(test_Version == 3);
+
+   len = test_TextMake(17, TEST_LONG_META);
+   CHECK(len > 4 * AWS_IOT_MQTT_RX_BUF_LEN);
+   CHECK(test_Publish(EVENT_TOPIC, QOS0, len) == SUCCESS);
+   CHECK(test_RxLen == 0);
+   CHECK(test_Handled == 2);
+   CHECK(test_DocRc == JSON_RC__OK);
+   CHECK(test_Version == 17);
+   printf("document of %d bytes parsed through the %d byte RX buffer\n", len, AWS_IOT_MQTT_RX_BUF_LEN);
+
+   return (0);
+}
+
+// long messages the driver does not take are read off the network
+static int test_Others(void)
+{
+   int len = test_TextMake(18, TEST_LONG_META);
+
+   CHECK(test_Publish("other/topic", QOS0, len) == SUCCESS);
+   CHECK(test_RxLen == 0);
+   CHECK(test_Handled == 2);
+
+   CHECK(test_Publish(EVENT_TOPIC, QOS1, len) == MQTT_RX_BUFFER_TOO_SHORT_ERROR);
+   CHECK(test_RxLen == 0);
+   CHECK(test_Handled == 2);
+
+   // the client reads on as before
+   len = test_TextMake(19, 2);
+   CHECK(test_Publish(EVENT_TOPIC, QOS0, len) == SUCCESS);
+   CHECK(test_Handled == 3);
+   CHECK(test_Version == 19);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   Json_Handle object;
+
+   if((test_Setup(&object) != 0) || (test_Parsed() != 0))
+   {
+      return (1);
+   }
+   printf("PASS documents past the MQTT RX buffer are parsed as they arrive\n");
+
+   if(test_Others() != 0)
+   {
+      return (1);
+   }
+   printf("PASS other long messages are read off the network and dropped\n");
+
+   return (0);
+}
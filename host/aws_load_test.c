@@ -0,0 +1,332 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host load test of the AWS IoT MQTT client over its SimpleLink network port.
+ *
+ * Each simulated device is a task running its own AWS IoT client, over the
+ * network_sl.c port of the target and the BSD layer of SlNetSock, on the
+ * POSIX SlNetIf with TLS stood in. The broker is the MQTT server, over the
+ * same interface. Each device subscribes to its own topic and, once all are
+ * subscribed, publishes a run of QoS 1 messages to the topic of the next
+ * device. Every device must get each message of its neighbour exactly once,
+ * in order. Reports the connect time and the message rate.
+ *
+ *    aws_load_test [devices [messages]]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/net/mqtt/server/server_core.h>
+#include <ti/net/slnetutils.h>
+
+#include "aws_iot_mqtt_client_interface.h"
+#include "host_util.h"
+
+#define LOAD_PORT                      (45874)
+#define LOAD_HOST                      "127.0.0.1"
+#define LOAD_MAX_DEVICES               (64)
+#define LOAD_DEVICES                   (16)
+#define LOAD_MESSAGES                  (100)
+#define LOAD_YIELD_MS                  (10)
+#define LOAD_WAIT_MS                   (10000)
+#define LOAD_SETTLE_MS                 (100)
+
+extern int32_t MQTTNet_commOpen(uint32_t nwconnOpts, const char *serverAddr, uint16_t portNumber, const MQTT_SecureConn_t *nwSecurity);
+extern int32_t MQTTNet_tcpSend(int32_t comm, const uint8_t *buf, uint32_t len, void *ctx);
+extern int32_t MQTTNet_tcpRecv(int32_t comm, uint8_t *buf, uint32_t len, uint32_t waitSecs, bool *timedOut, void *ctx);
+extern int32_t MQTTNet_sendTo(int32_t comm, const uint8_t *buf, uint32_t len, uint16_t destPort, const uint8_t *destIP, uint32_t ipLen);
+extern int32_t MQTTNet_recvFrom(int32_t comm, uint8_t *buf, uint32_t len, uint16_t *fromPort, uint8_t *fromIP, uint32_t *ipLen);
+extern int32_t MQTTNet_commClose(int32_t comm);
+extern int32_t MQTTNet_tcpListen(uint32_t nwconnInfo, uint16_t portNumber, const MQTT_SecureConn_t *nwSecurity);
+extern int32_t MQTTNet_tcpAccept(uint32_t nwconnInfo, int32_t listenHnd, uint8_t *clientIP, uint32_t *ipLen);
+extern int32_t MQTTNet_tcpSelect(int32_t *recvCvec, int32_t *sendCvec, int32_t *rsvdCvec, uint32_t waitSecs);
+extern uint32_t MQTTNet_rtcSecs(void);
+
+static const MQTT_DeviceNetServices_t load_NetOps =
+{
+   MQTTNet_commOpen, MQTTNet_tcpSend, MQTTNet_tcpRecv, MQTTNet_sendTo,
+   MQTTNet_recvFrom, MQTTNet_commClose, MQTTNet_tcpListen,
+   MQTTNet_tcpAccept, MQTTNet_tcpSelect, MQTTNet_rtcSecs
+};
+
+typedef struct
+{
+   pthread_t      thread;
+   AWS_IoT_Client client;
+   int            id;
+   char           topic[32];     // the client keeps a pointer to its topics
+   uint32_t       received;
+   uint32_t       outOfOrder;
+   uint64_t       connectNs;
+   int            result;
+} load_Device_t;
+
+static pthread_mutex_t load_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t *load_pMutex = &load_Mutex;
+static pthread_barrier_t load_Barrier;
+
+static load_Device_t load_Devices[LOAD_MAX_DEVICES];
+static int load_NumDevices = LOAD_DEVICES;
+static uint32_t load_Messages = LOAD_MESSAGES;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static void load_MutexLock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_lock(pMutex);
+}
+
+static void load_MutexUnlock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_unlock(pMutex);
+}
+
+static void *load_ServerTask(void *pArg)
+{
+   MQTTServerPkts_run(1);
+   return (NULL);
+}
+
+static int load_ServerStart(void)
+{
+   static const uint32_t cipher = 0;
+   MQTTServerPkts_LibCfg_t libCfg;
+   MQTTServerCore_AppCfg_t appCfg = { NULL };
+   pthread_t thread;
+
+   memset(&libCfg, 0, sizeof(libCfg));
+   libCfg.listenerPort = LOAD_PORT;
+   libCfg.mutex = &load_pMutex;
+   libCfg.mutexLockin = load_MutexLock;
+   libCfg.mutexUnlock = load_MutexUnlock;
+   libCfg.secure.cipher = (void *)&cipher;
+   CHECK(MQTTServerCore_init(&libCfg, &appCfg) == 0);
+   CHECK(MQTTServerPkts_registerNetSvc(&load_NetOps) == 0);
+   CHECK(pthread_create(&thread, NULL, load_ServerTask, NULL) == 0);
+
+   // give the server task time to listen
+   usleep(100000);
+   return (0);
+}
+
+static void load_Topic(char *pTopic, size_t size, int id)
+{
+   snprintf(pTopic, size, "load/%d/cmd", id);
+}
+
+// messages of the neighbour, numbered from zero
+static void load_Handler(AWS_IoT_Client *pClient, char *pTopicName, uint16_t topicNameLen,
+                         IoT_Publish_Message_Params *pParams, void *pClientData)
+{
+   load_Device_t *pDevice = pClientData;
+   char text[16];
+   size_t len = (pParams->payloadLen < sizeof(text)) ? pParams->payloadLen : sizeof(text) - 1;
+
+   memcpy(text, pParams->payload, len);
+   text[len] = '\0';
+   if(strtoul(text, NULL, 10) != pDevice->received)
+   {
+      pDevice->outOfOrder++;
+   }
+   pDevice->received++;
+}
+
+// serves the client for 'ms', or until the neighbour's messages are in
+static void load_Yield(load_Device_t *pDevice, uint32_t ms, bool untilAll)
+{
+   uint64_t end = Host_Nsec() + (uint64_t)ms * 1000000u;
+
+   while((Host_Nsec() < end) && (!untilAll || (pDevice->received < load_Messages)))
+   {
+      aws_iot_mqtt_yield(&pDevice->client, LOAD_YIELD_MS);
+   }
+}
+
+// connects and subscribes to the device topic
+static int load_Connect(load_Device_t *pDevice)
+{
+   IoT_Client_Init_Params initParams = iotClientInitParamsDefault;
+   IoT_Client_Connect_Params connectParams = iotClientConnectParamsDefault;
+   char clientID[16];
+   uint64_t start;
+
+   initParams.enableAutoReconnect = false;
+   initParams.pHostURL = LOAD_HOST;
+   initParams.port = LOAD_PORT;
+   initParams.pRootCALocation = AWS_IOT_ROOT_CA_FILENAME;
+   initParams.pDeviceCertLocation = AWS_IOT_CERTIFICATE_FILENAME;
+   initParams.pDevicePrivateKeyLocation = AWS_IOT_PRIVATE_KEY_FILENAME;
+   initParams.mqttCommandTimeout_ms = LOAD_WAIT_MS;
+   initParams.tlsHandshakeTimeout_ms = LOAD_WAIT_MS;
+   initParams.isSSLHostnameVerify = false;
+   CHECK(aws_iot_mqtt_init(&pDevice->client, &initParams) == SUCCESS);
+
+   snprintf(clientID, sizeof(clientID), "dev%d", pDevice->id);
+   connectParams.keepAliveIntervalInSec = 600;
+   connectParams.isCleanSession = true;
+   connectParams.MQTTVersion = MQTT_3_1_1;
+   connectParams.pClientID = clientID;
+   connectParams.clientIDLen = (uint16_t)strlen(clientID);
+   start = Host_Nsec();
+   CHECK(aws_iot_mqtt_connect(&pDevice->client, &connectParams) == SUCCESS);
+   pDevice->connectNs = Host_Nsec() - start;
+
+   load_Topic(pDevice->topic, sizeof(pDevice->topic), pDevice->id);
+   CHECK(aws_iot_mqtt_subscribe(&pDevice->client, pDevice->topic, (uint16_t)strlen(pDevice->topic), QOS1,
+                                load_Handler, pDevice) == SUCCESS);
+
+   return (0);
+}
+
+// a QoS 1 publish waits for its PUBACK, the messages in meanwhile are handled
+static int load_Publish(load_Device_t *pDevice)
+{
+   IoT_Publish_Message_Params params;
+   char peerTopic[32];
+   char payload[16];
+   uint32_t i;
+
+   load_Topic(peerTopic, sizeof(peerTopic), (pDevice->id + 1) % load_NumDevices);
+   memset(&params, 0, sizeof(params));
+   params.qos = QOS1;
+   for(i = 0; i < load_Messages; i++)
+   {
+      params.payloadLen = snprintf(payload, sizeof(payload), "%u", i);
+      params.payload = payload;
+      CHECK(aws_iot_mqtt_publish(&pDevice->client, peerTopic, (uint16_t)strlen(peerTopic), &params) == SUCCESS);
+   }
+   load_Yield(pDevice, LOAD_WAIT_MS, true);
+
+   return (0);
+}
+
+static int load_Check(load_Device_t *pDevice)
+{
+   CHECK(aws_iot_mqtt_disconnect(&pDevice->client) == SUCCESS);
+   CHECK(pDevice->received == load_Messages);
+   CHECK(pDevice->outOfOrder == 0);
+
+   return (0);
+}
+
+// a device that fails still meets the others at each barrier
+static void *load_DeviceTask(void *pArg)
+{
+   load_Device_t *pDevice = pArg;
+
+   pDevice->result = load_Connect(pDevice);
+
+   // every device is subscribed before the first message
+   pthread_barrier_wait(&load_Barrier);
+   if(pDevice->result == 0)
+   {
+      pDevice->result = load_Publish(pDevice);
+   }
+
+   // no device leaves while another one still sends to it, and late copies show up
+   pthread_barrier_wait(&load_Barrier);
+   if(pDevice->result == 0)
+   {
+      load_Yield(pDevice, LOAD_SETTLE_MS, false);
+   }
+   pthread_barrier_wait(&load_Barrier);
+   if(pDevice->result == 0)
+   {
+      pDevice->result = load_Check(pDevice);
+   }
+
+   if(pDevice->result != 0)
+   {
+      printf("FAIL device %d, %u of %u messages, %u out of order\n", pDevice->id,
+             pDevice->received, load_Messages, pDevice->outOfOrder);
+   }
+   return (NULL);
+}
+
+static int load_Run(void)
+{
+   SlNetIf_Stats_t before;
+   SlNetIf_Stats_t after;
+   uint64_t connectNs = 0;
+   uint64_t start;
+   uint64_t elapsed;
+   int i;
+
+   CHECK(pthread_barrier_init(&load_Barrier, NULL, load_NumDevices) == 0);
+   CHECK(SlNetIf_getStats(SLNETIF_ID_1, &before) == 0);
+
+   start = Host_Nsec();
+   for(i = 0; i < load_NumDevices; i++)
+   {
+      load_Devices[i].id = i;
+      CHECK(pthread_create(&load_Devices[i].thread, NULL, load_DeviceTask, &load_Devices[i]) == 0);
+   }
+   for(i = 0; i < load_NumDevices; i++)
+   {
+      pthread_join(load_Devices[i].thread, NULL);
+   }
+   elapsed = Host_Nsec() - start - (uint64_t)LOAD_SETTLE_MS * 1000000u;
+   CHECK(SlNetIf_getStats(SLNETIF_ID_1, &after) == 0);
+
+   for(i = 0; i < load_NumDevices; i++)
+   {
+      CHECK(load_Devices[i].result == 0);
+      connectNs += load_Devices[i].connectNs;
+   }
+
+   printf("%d devices, %u QoS 1 messages each: connect %.2f ms on average, "
+          "%.0f messages/s, %u bytes sent on the interface, %u errors\n",
+          load_NumDevices, load_Messages, (double)connectNs / load_NumDevices / 1000000.0,
+          (double)load_NumDevices * load_Messages * 1000000000.0 / elapsed,
+          after.txBytes - before.txBytes, after.errors - before.errors);
+
+   pthread_barrier_destroy(&load_Barrier);
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(int argc, char *argv[])
+{
+   setvbuf(stdout, NULL, _IONBF, 0);
+
+   if(argc > 1)
+   {
+      load_NumDevices = atoi(argv[1]);
+   }
+   if(argc > 2)
+   {
+      load_Messages = (uint32_t)atoi(argv[2]);
+   }
+   if((load_NumDevices < 2) || (load_NumDevices > LOAD_MAX_DEVICES) || (load_Messages == 0))
+   {
+      printf("usage: aws_load_test [devices, 2 to %d [messages]]\n", LOAD_MAX_DEVICES);
+      return (1);
+   }
+
+   if((SlNetIf_init(0) != 0) ||
+      (SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5) != 0) ||
+      (SlNetSock_init(0) != 0) ||
+      (SlNetUtil_init(0) != 0) ||
+      (load_ServerStart() != 0))
+   {
+      printf("FAIL setup\n");
+      return (1);
+   }
+
+   if(load_Run() != 0)
+   {
+      return (1);
+   }
+   printf("PASS every device got the messages of its neighbour once, in order\n");
+
+   return (0);
+}
@@ -0,0 +1,302 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host micro-benchmark of the AWS IoT MQTT client PUBLISH dispatch.
+ *
+ * The client runs over a network layer that is a minimal broker: it answers
+ * the CONNECT, SUBSCRIBE and UNSUBSCRIBE the client writes, and serves the
+ * PUBLISH messages queued by the benchmark. The client subscribes to the
+ * shadow and command topics of a set of devices, plus a '+' and a '#'
+ * filter, through the public API. Every device topic is then published and
+ * read back through the client RX path. Times the dispatch, checks every
+ * handler got its messages, and reports the topic index bucket probes made
+ * per PUBLISH. Built with no topic index nodes the client scans every
+ * handler, as it did before the index.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <aws_iot_mqtt_client_interface.h>
+#include <aws_iot_mqtt_client_common_internal.h>
+
+#include "host_util.h"
+
+#define BENCH_DEVICES                  (40)
+#define BENCH_TOPICS                   (BENCH_DEVICES * 3)
+#define BENCH_FILTERS                  (BENCH_TOPICS + 2)
+#define BENCH_ROUNDS                   (2000)
+
+#define BENCH_PLUS_FILTER              "$aws/things/+/shadow/update/delta"
+#define BENCH_HASH_FILTER              "cmd/#"
+
+static AWS_IoT_Client bench_Client;
+
+// what the broker has for the client to read
+static unsigned char bench_Rx[256];
+static size_t bench_RxLen;
+static size_t bench_RxOff;
+
+// the filters are kept by the client, not copied
+static char bench_Filters[BENCH_FILTERS][48];
+static uint32_t bench_Delivered[BENCH_FILTERS];
+static char bench_Topics[BENCH_TOPICS][48];
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static void bench_RxQueue(const unsigned char *pBuf, size_t len)
+{
+   memcpy(bench_Rx + bench_RxLen, pBuf, len);
+   bench_RxLen += len;
+}
+
+// the ACK of a SUBSCRIBE or UNSUBSCRIBE, with the packet id of 'pBuf'
+static void broker_Ack(const unsigned char *pBuf, unsigned char type, unsigned char len)
+{
+   unsigned char ack[5];
+   size_t off = 1;
+
+   // past the remaining length
+   while(pBuf[off++] & 0x80)
+   {
+   }
+
+   ack[0] = (unsigned char)(type << 4);
+   ack[1] = len;
+   ack[2] = pBuf[off];
+   ack[3] = pBuf[off + 1];
+   ack[4] = 0;   // granted QoS 0
+   bench_RxQueue(ack, 2 + len);
+}
+
+static IoT_Error_t net_Connect(Network *pNetwork, TLSConnectParams *pParams)
+{
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Read(Network *pNetwork, unsigned char *pBuf, size_t len, Timer *pTimer,
+                            size_t *pReadLen)
+{
+   size_t n = bench_RxLen - bench_RxOff;
+
+   if(0 == n)
+   {
+      *pReadLen = 0;
+      return (NETWORK_SSL_NOTHING_TO_READ);
+   }
+   if(n > len)
+   {
+      n = len;
+   }
+   memcpy(pBuf, bench_Rx + bench_RxOff, n);
+   bench_RxOff += n;
+   if(bench_RxOff == bench_RxLen)
+   {
+      bench_RxOff = 0;
+      bench_RxLen = 0;
+   }
+   *pReadLen = n;
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Write(Network *pNetwork, unsigned char *pBuf, size_t len, Timer *pTimer,
+                             size_t *pWritten)
+{
+   static const unsigned char connack[] = { CONNACK << 4, 2, 0, 0 };
+
+   switch(pBuf[0] >> 4)
+   {
+      case CONNECT:
+         bench_RxQueue(connack, sizeof(connack));
+         break;
+      case SUBSCRIBE:
+         broker_Ack(pBuf, SUBACK, 3);
+         break;
+      case UNSUBSCRIBE:
+         broker_Ack(pBuf, UNSUBACK, 2);
+         break;
+      default:
+         break;
+   }
+   *pWritten = len;
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_Disconnect(Network *pNetwork)
+{
+   return (SUCCESS);
+}
+
+static IoT_Error_t net_IsConnected(Network *pNetwork)
+{
+   return (NETWORK_PHYSICAL_LAYER_CONNECTED);
+}
+
+static IoT_Error_t net_Destroy(Network *pNetwork)
+{
+   return (SUCCESS);
+}
+
+// the network layer of the client
+IoT_Error_t iot_tls_init(Network *pNetwork, char *pRootCALocation, char *pDeviceCertLocation,
+                         char *pDevicePrivateKeyLocation, char *pDestinationURL,
+                         uint16_t DestinationPort, uint32_t timeout_ms, bool ServerVerificationFlag)
+{
+   pNetwork->connect = net_Connect;
+   pNetwork->read = net_Read;
+   pNetwork->write = net_Write;
+   pNetwork->disconnect = net_Disconnect;
+   pNetwork->isConnected = net_IsConnected;
+   pNetwork->destroy = net_Destroy;
+
+   return (SUCCESS);
+}
+
+static void bench_Handler(AWS_IoT_Client *pClient, char *pTopicName, uint16_t topicNameLen,
+                          IoT_Publish_Message_Params *pParams, void *pData)
+{
+   (*(uint32_t *)pData)++;
+}
+
+// the broker sends 'topic', which the client reads and dispatches
+static int bench_Publish(const char *topic)
+{
+   static const char payload[] = "21.5";
+   unsigned char pkt[4 + sizeof(bench_Topics[0]) + sizeof(payload)];
+   uint16_t topicLen = (uint16_t)strlen(topic);
+   uint8_t packetType = 0;
+   Timer timer;
+
+   pkt[0] = PUBLISH << 4;
+   pkt[1] = (unsigned char)(2 + topicLen + sizeof(payload) - 1);
+   pkt[2] = 0;
+   pkt[3] = (unsigned char)topicLen;
+   memcpy(&pkt[4], topic, topicLen);
+   memcpy(&pkt[4 + topicLen], payload, sizeof(payload) - 1);
+   bench_RxQueue(pkt, 4 + topicLen + sizeof(payload) - 1);
+
+   init_timer(&timer);
+   countdown_ms(&timer, 100);
+   CHECK(aws_iot_mqtt_internal_cycle_read(&bench_Client, &timer, &packetType) == SUCCESS);
+   CHECK(packetType == PUBLISH);
+   CHECK(bench_RxLen == 0);
+
+   return (0);
+}
+
+static int bench_Setup(void)
+{
+   IoT_Client_Init_Params initParams = iotClientInitParamsDefault;
+   IoT_Client_Connect_Params connectParams = iotClientConnectParamsDefault;
+   int d;
+   int i;
+
+   initParams.pHostURL = AWS_IOT_MQTT_HOST;
+   initParams.port = AWS_IOT_MQTT_PORT;
+   initParams.pRootCALocation = "";
+   initParams.pDeviceCertLocation = "";
+   initParams.pDevicePrivateKeyLocation = "";
+   initParams.mqttCommandTimeout_ms = 1000;
+   initParams.mqttPacketTimeout_ms = 1000;
+   CHECK(aws_iot_mqtt_init(&bench_Client, &initParams) == SUCCESS);
+
+   connectParams.pClientID = AWS_IOT_MQTT_CLIENT_ID;
+   connectParams.clientIDLen = (uint16_t)strlen(AWS_IOT_MQTT_CLIENT_ID);
+   CHECK(aws_iot_mqtt_connect(&bench_Client, &connectParams) == SUCCESS);
+
+   for(d = 0; d < BENCH_DEVICES; d++)
+   {
+      i = d * 3;
+      snprintf(bench_Filters[i], sizeof(bench_Filters[i]), "$aws/things/dev%03d/shadow/update/delta", d);
+      snprintf(bench_Filters[i + 1], sizeof(bench_Filters[i + 1]), "$aws/things/dev%03d/shadow/get/accepted", d);
+      snprintf(bench_Filters[i + 2], sizeof(bench_Filters[i + 2]), "cmd/dev%03d/+", d);
+
+      strcpy(bench_Topics[i], bench_Filters[i]);
+      strcpy(bench_Topics[i + 1], bench_Filters[i + 1]);
+      snprintf(bench_Topics[i + 2], sizeof(bench_Topics[i + 2]), "cmd/dev%03d/reboot", d);
+   }
+   strcpy(bench_Filters[BENCH_TOPICS], BENCH_PLUS_FILTER);
+   strcpy(bench_Filters[BENCH_TOPICS + 1], BENCH_HASH_FILTER);
+
+   for(i = 0; i < BENCH_FILTERS; i++)
+   {
+      CHECK(aws_iot_mqtt_subscribe(&bench_Client, bench_Filters[i], (uint16_t)strlen(bench_Filters[i]),
+                                   QOS0, bench_Handler, &bench_Delivered[i]) == SUCCESS);
+   }
+
+   return (0);
+}
+
+static int bench_Dispatch(void)
+{
+   TopicIndexStats before;
+   TopicIndexStats after;
+   uint32_t routed;
+   uint64_t start;
+   uint64_t ns;
+   int round;
+   int i;
+
+   memset(bench_Delivered, 0, sizeof(bench_Delivered));
+   aws_iot_mqtt_get_topic_index_stats(&bench_Client, &before);
+   start = Host_Nsec();
+   for(round = 0; round < BENCH_ROUNDS; round++)
+   {
+      for(i = 0; i < BENCH_TOPICS; i++)
+      {
+         CHECK(bench_Publish(bench_Topics[i]) == 0);
+      }
+   }
+   ns = Host_Nsec() - start;
+   aws_iot_mqtt_get_topic_index_stats(&bench_Client, &after);
+
+   routed = BENCH_ROUNDS * BENCH_TOPICS;
+   for(i = 0; i < BENCH_TOPICS; i++)
+   {
+      CHECK(bench_Delivered[i] == BENCH_ROUNDS);
+   }
+   CHECK(bench_Delivered[BENCH_TOPICS] == BENCH_ROUNDS * BENCH_DEVICES);
+   CHECK(bench_Delivered[BENCH_TOPICS + 1] == BENCH_ROUNDS * BENCH_DEVICES);
+   CHECK(after.deliveries - before.deliveries == routed);
+   CHECK(after.handlersMatched - before.handlersMatched == routed + (2 * BENCH_ROUNDS * BENCH_DEVICES));
+   CHECK(after.rejected == before.rejected);
+
+   printf("%d filters, %d topics: %6.0f ns per PUBLISH, %u of %u by scan, "
+          "%.1f bucket probes per PUBLISH\n",
+          BENCH_FILTERS, BENCH_TOPICS, (double)ns / routed,
+          after.fullScans - before.fullScans, routed,
+          (double)(after.bucketProbes - before.bucketProbes) / routed);
+
+   return (0);
+}
+
+// every filter goes, and with it every index node
+static int bench_Teardown(void)
+{
+   int i;
+
+   for(i = 0; i < BENCH_FILTERS; i++)
+   {
+      CHECK(aws_iot_mqtt_unsubscribe(&bench_Client, bench_Filters[i],
+                                     (uint16_t)strlen(bench_Filters[i])) == SUCCESS);
+   }
+   CHECK(bench_Client.clientData.freeTopicNodes == AWS_IOT_MQTT_NUM_TOPIC_NODES);
+   CHECK(bench_Client.clientData.unindexedHandlers == 0);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if((bench_Setup() != 0) || (bench_Dispatch() != 0) || (bench_Teardown() != 0))
+   {
+      return (1);
+   }
+
+   return (0);
+}
@@ -0,0 +1,284 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the AWS task wait, over two POSIX SlNetIf interfaces on the
+ * loopback.
+ *
+ * The AWS driver is built into the test, which drives its wait directly.
+ * The MQTT socket is opened on the other interface than the wake socket: the
+ * wake socket moves to the interface of the MQTT socket, and both wake the
+ * task. A reconnect that gets the same descriptor back is registered again.
+ * A producer that took the wake socket before it was closed does not send on
+ * the socket its descriptor was given to next.
+ * A poll set that can't take the MQTT socket leaves the task waiting on it
+ * with select, and looking at queued events every WAIT_NO_WAKE_MS.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/net/slneterr.h>
+
+#include "../AWSDriver.c"
+#include "host_util.h"
+
+#define TEST_PORT                      (45872)
+
+static AWS_IoT_Client test_Client;
+static SlNetSock_AddrIn_t test_Addr;
+static int16_t test_Listener = -1;
+static int16_t test_Peer = -1;
+static uint32_t test_Logs;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+void UART_PRINT(char *label, ...)
+{
+   va_list args;
+
+   va_start(args, label);
+   printf("   log: ");
+   vprintf(label, args);
+   va_end(args);
+   test_Logs++;
+}
+
+// the client is never connected, its network layer is not used
+IoT_Error_t iot_tls_init(Network *pNetwork, char *pRootCALocation, char *pDeviceCertLocation,
+                         char *pDevicePrivateKeyLocation, char *pDestinationURL,
+                         uint16_t DestinationPort, uint32_t timeout_ms, bool ServerVerificationFlag)
+{
+   return (SUCCESS);
+}
+
+// the MQTT socket, connected on interface 2 to a peer the test writes from
+static int test_Connect(void)
+{
+   int16_t sd;
+
+   sd = SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_STREAM, SLNETSOCK_PROTO_TCP, SLNETIF_ID_2, 0);
+   CHECK(sd >= 0);
+   CHECK(SlNetSock_connect(sd, (SlNetSock_Addr_t *)&test_Addr, sizeof(test_Addr)) == 0);
+   test_Peer = SlNetSock_accept(test_Listener, NULL, NULL);
+   CHECK(test_Peer >= 0);
+
+   test_Client.networkStack.tlsDataParams.skt = sd;
+   return (0);
+}
+
+// the last sd freed is the first given out again, the MQTT socket gets its sd back
+static void test_Disconnect(void)
+{
+   SlNetSock_close(test_Peer);
+   SlNetSock_close(test_Client.networkStack.tlsDataParams.skt);
+   test_Client.networkStack.tlsDataParams.skt = -1;
+   test_Peer = -1;
+}
+
+// the broker sends a byte, the wait returns for the client to read it
+static int test_NetworkWake(void)
+{
+   uint32_t wakeNetwork = g_LoopStats.wakeNetwork;
+   char c;
+
+   CHECK(SlNetSock_send(test_Peer, "x", 1, 0) == 1);
+   CHECK(WaitForWork(&test_Client));
+   CHECK(g_LoopStats.wakeNetwork == wakeNetwork + 1);
+   CHECK(SlNetSock_recv(test_Client.networkStack.tlsDataParams.skt, &c, 1, 0) == 1);
+
+   return (0);
+}
+
+// a producer signals, the wait returns with nothing for the client
+static int test_PublishWake(void)
+{
+   uint32_t wakePublish = g_LoopStats.wakePublish;
+
+   WakeSignal();
+   CHECK(!WaitForWork(&test_Client));
+   CHECK(g_LoopStats.wakePublish == wakePublish + 1);
+
+   return (0);
+}
+
+static int test_Setup(void)
+{
+   int32_t reuse = 1;
+
+   CHECK(SlNetIf_init(0) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_2, "lo", &SlNetIfConfigPosix, 5) == 0);
+   CHECK(SlNetSock_init(0) == 0);
+   CHECK(SlNetUtil_init(0) == 0);
+
+   test_Addr.sin_family = SLNETSOCK_AF_INET;
+   test_Addr.sin_addr.s_addr = SlNetUtil_htonl(WAKE_LOOPBACK_ADDR);
+   test_Addr.sin_port = SlNetUtil_htons(TEST_PORT);
+
+   test_Listener = SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_STREAM, SLNETSOCK_PROTO_TCP, SLNETIF_ID_2, 0);
+   CHECK(test_Listener >= 0);
+   CHECK(SlNetSock_setOpt(test_Listener, SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_REUSEADDR,
+                          &reuse, sizeof(reuse)) == 0);
+   CHECK(SlNetSock_bind(test_Listener, (SlNetSock_Addr_t *)&test_Addr, sizeof(test_Addr)) == 0);
+   CHECK(SlNetSock_listen(test_Listener, 2) == 0);
+
+   // as AWSDriver_Run opens it, but on the interface the MQTT socket is not on
+   WakeOpen(SLNETIF_ID_1);
+   CHECK(g_WakeSd >= 0);
+   CHECK(SlNetSock_getIfID(g_WakeSd) == SLNETIF_ID_1);
+
+   test_Client.networkStack.tlsDataParams.skt = -1;
+   return (0);
+}
+
+static int test_WakeMoves(void)
+{
+   CHECK(test_Connect() == 0);
+   CHECK(test_NetworkWake() == 0);
+   CHECK(!g_PollNetSelect);
+   CHECK(SlNetSock_getIfID(g_WakeSd) == SLNETIF_ID_2);
+   CHECK(test_PublishWake() == 0);
+   CHECK(test_NetworkWake() == 0);
+
+   return (0);
+}
+
+static int test_SameSd(void)
+{
+   int16_t sd = test_Client.networkStack.tlsDataParams.skt;
+
+   test_Disconnect();
+   CHECK(test_Connect() == 0);
+   CHECK(test_Client.networkStack.tlsDataParams.skt == sd);
+   CHECK(test_NetworkWake() == 0);
+   CHECK(test_PublishWake() == 0);
+
+   return (0);
+}
+
+// a datagram reached the wake port, waiting up to 100 ms for it
+static bool test_WakeSent(int16_t rxSd)
+{
+   uint8_t wake;
+   int i;
+
+   for(i = 0; i < 100; i++)
+   {
+      if(SlNetSock_recv(rxSd, &wake, sizeof(wake), SLNETSOCK_MSG_DONTWAIT) == sizeof(wake))
+      {
+         return (true);
+      }
+      usleep(1000);
+   }
+   return (false);
+}
+
+static int test_StaleWake(void)
+{
+   SlNetSock_AddrIn_t addr;
+   int16_t wakeSd = g_WakeSd;
+   uint16_t wakeGen = g_WakeGen;
+   int32_t ifID = SlNetSock_getIfID(wakeSd);
+   int16_t reusedSd;
+   int16_t rxSd;
+   bool sent;
+
+   WakeClose();
+   reusedSd = SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_DGRAM, SLNETSOCK_PROTO_UDP, ifID, 0);
+   CHECK(reusedSd == wakeSd);
+
+   // a socket on the wake port sees what a signal would send
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = SLNETSOCK_AF_INET;
+   addr.sin_port = SlNetUtil_htons(WAKE_PORT);
+   rxSd = SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_DGRAM, SLNETSOCK_PROTO_UDP, ifID, 0);
+   CHECK(rxSd >= 0);
+   CHECK(SlNetSock_bind(rxSd, (SlNetSock_Addr_t *)&addr, sizeof(addr)) == 0);
+
+   // the snapshot of a producer that was preempted before the close
+   g_WakeSd = wakeSd;
+   g_WakeGen = wakeGen;
+   WakeSignal();
+   sent = test_WakeSent(rxSd);
+
+   // the same sd with its current generation is signalled
+   CHECK(SlNetSock_getGeneration(reusedSd, &g_WakeGen) == 0);
+   CHECK(g_WakeGen != wakeGen);
+   WakeSignal();
+   CHECK(test_WakeSent(rxSd));
+   CHECK(!sent);
+
+   g_WakeSd = -1;
+   SlNetSock_close(rxSd);
+   SlNetSock_close(reusedSd);
+   WakeOpen((uint32_t) ifID);
+   CHECK(g_WakeSd >= 0);
+   CHECK(test_PublishWake() == 0);
+
+   return (0);
+}
+
+static int test_Select(void)
+{
+   uint32_t wakeDeadline = g_LoopStats.wakeDeadline;
+   uint32_t logs = test_Logs;
+   uint32_t start;
+
+   // the poll set takes no socket any more
+   CHECK(SlNetSock_pollClose(g_PollSd) == 0);
+   test_Disconnect();
+   CHECK(test_Connect() == 0);
+
+   CHECK(test_NetworkWake() == 0);
+   CHECK(g_PollNetSelect);
+   CHECK(test_Logs > logs);
+
+   start = NOW_MS();
+   CHECK(!WaitForWork(&test_Client));
+   CHECK(g_LoopStats.wakeDeadline == wakeDeadline + 1);
+   CHECK(NOW_MS() - start < 10 * WAIT_NO_WAKE_MS);
+
+   // logged once for the socket, not on every wait
+   logs = test_Logs;
+   CHECK(test_NetworkWake() == 0);
+   CHECK(test_Logs == logs);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if((test_Setup() != 0) || (test_WakeMoves() != 0))
+   {
+      return (1);
+   }
+   printf("PASS wake socket moved to the interface of the MQTT socket\n");
+
+   if(test_SameSd() != 0)
+   {
+      return (1);
+   }
+   printf("PASS MQTT socket registered again on a reconnect to the same sd\n");
+
+   if(test_StaleWake() != 0)
+   {
+      return (1);
+   }
+   printf("PASS wake signal not sent on a closed wake socket whose sd was reused\n");
+
+   if(test_Select() != 0)
+   {
+      return (1);
+   }
+   printf("PASS MQTT socket waited on with select outside of the poll set\n");
+
+   test_Disconnect();
+   return (0);
+}
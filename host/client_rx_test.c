@@ -0,0 +1,320 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the MQTT client group RX loop.
+ *
+ * The client network services run over Linux socketpairs: the broker is the
+ * far end of a stream pair and the loopback is a datagram pair. The broker
+ * writes a burst of small PUBLISH messages in one go, so the RX buffer of the
+ * context holds complete packets for most of it. A loopback wake sent on the
+ * first PUBLISH must be served on the next pass of the RX loop, and the burst
+ * must be read in fewer network reads than it has packets.
+ */
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <ti/net/mqtt/client/client_core.h>
+
+#include "host_util.h"
+
+#define TEST_PUBS                      (100)
+#define TEST_TOPIC                     "t/1"
+#define TEST_PAYLOAD                   "21.5"
+#define TEST_PUB_LEN                   (2 + 2 + 3 + 4)
+#define TEST_LOOPBACK_PORT             (1882)
+#define TEST_MQP_NUM                   (4)
+#define TEST_MQP_LEN                   (256)
+
+// owned by the MQTTClient interface, which the test drives the core without
+int32_t MQTTClient_closeContext = 0;
+
+static pthread_mutex_t test_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static MQTT_Packet_t test_Mqps[TEST_MQP_NUM];
+static uint8_t test_Bufs[TEST_MQP_NUM * TEST_MQP_LEN];
+
+static int test_BrokerFd = -1;      // far end of the client connection
+static int test_LoopbPeerFd = -1;   // far end of the loopback
+static int test_LoopbFd = -1;
+
+static uint32_t test_Connacks;
+static uint32_t test_Pubs;
+static uint32_t test_LoopbReads;
+static uint32_t test_PubsAtWake;    // PUBLISH delivered when the wake was read
+static uint32_t test_Disconns;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int32_t net_Open(uint32_t nwconnOpts, const char *serverAddr, uint16_t portNumber,
+                        const MQTT_SecureConn_t *nwSecurity)
+{
+   int fds[2];
+   int type = (nwconnOpts & MQTT_DEV_NETCONN_OPT_UDP) ? SOCK_DGRAM : SOCK_STREAM;
+
+   if(socketpair(AF_UNIX, type, 0, fds) != 0)
+   {
+      return (-1);
+   }
+   if(SOCK_DGRAM == type)
+   {
+      test_LoopbFd = fds[0];
+      test_LoopbPeerFd = fds[1];
+   }
+   else
+   {
+      test_BrokerFd = fds[1];
+   }
+   return (fds[0]);
+}
+
+static int32_t net_Send(int32_t comm, const uint8_t *buf, uint32_t len, void *ctx)
+{
+   return ((int32_t)send(comm, buf, len, 0));
+}
+
+static int32_t net_Recv(int32_t comm, uint8_t *buf, uint32_t len, uint32_t waitSecs,
+                        bool *timedOut, void *ctx)
+{
+   struct pollfd pfd = { comm, POLLIN, 0 };
+
+   *timedOut = false;
+   if(poll(&pfd, 1, (int)waitSecs * 1000) == 0)
+   {
+      *timedOut = true;
+      return (0);
+   }
+   return ((int32_t)recv(comm, buf, len, 0));
+}
+
+static int32_t net_SendTo(int32_t comm, const uint8_t *buf, uint32_t len, uint16_t destPort,
+                          const uint8_t *destIP, uint32_t ipLen)
+{
+   // the wake is sent from the far end, so that the loopback reads it
+   return ((int32_t)send(test_LoopbPeerFd, buf, len, 0));
+}
+
+static int32_t net_RecvFrom(int32_t comm, uint8_t *buf, uint32_t len, uint16_t *fromPort,
+                            uint8_t *fromIP, uint32_t *ipLen)
+{
+   if(comm == test_LoopbFd)
+   {
+      test_LoopbReads++;
+      if((test_Pubs > 0) && (0 == test_PubsAtWake))
+      {
+         test_PubsAtWake = test_Pubs;
+      }
+   }
+   return ((int32_t)recv(comm, buf, len, 0));
+}
+
+static int32_t net_Close(int32_t comm)
+{
+   return (close(comm));
+}
+
+static int32_t net_IoMon(int32_t *recvCvec, int32_t *sendCvec, int32_t *rsvdCvec, uint32_t waitSecs)
+{
+   struct pollfd pfds[8];
+   int n = 0;
+   int rv;
+   int i;
+
+   while((-1 != recvCvec[n]) && (n < 8))
+   {
+      pfds[n].fd = recvCvec[n];
+      pfds[n].events = POLLIN;
+      pfds[n].revents = 0;
+      n++;
+   }
+
+   rv = poll(pfds, n, (int)waitSecs * 1000);
+   if(rv <= 0)
+   {
+      return (rv);
+   }
+
+   rv = 0;
+   for(i = 0; i < n; i++)
+   {
+      if(pfds[i].revents)
+      {
+         recvCvec[rv++] = pfds[i].fd;
+      }
+   }
+   recvCvec[rv] = -1;
+   return (rv);
+}
+
+static uint32_t net_Time(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((uint32_t)ts.tv_sec);
+}
+
+static const MQTT_DeviceNetServices_t test_NetOps =
+{
+   net_Open, net_Send, net_Recv, net_SendTo, net_RecvFrom,
+   net_Close, NULL, NULL, net_IoMon, net_Time
+};
+
+static void test_MutexLock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_lock(pMutex);
+}
+
+static void test_MutexUnlock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_unlock(pMutex);
+}
+
+static bool test_PublishRx(void *app, bool dup, MQTT_QOS qos, bool retain, MQTT_Packet_t *mqp)
+{
+   static const uint8_t wake[] = { 0xBE };
+
+   test_Pubs++;
+   if(1 == test_Pubs)
+   {
+      // as another task does to get the RX task to look at a closing 'ctx'
+      send(test_LoopbPeerFd, wake, sizeof(wake), 0);
+   }
+   return (true);
+}
+
+static void test_AckNotify(void *app, uint8_t msgType, uint16_t msgID, uint8_t *buf, uint32_t len)
+{
+   if(MQTT_CONNACK == msgType)
+   {
+      test_Connacks++;
+   }
+}
+
+static void test_DisconnCB(void *app, int32_t cause)
+{
+   test_Disconns++;
+}
+
+static int posix_RecvAll(int fd, uint8_t *pBuff, int len)
+{
+   int got = 0;
+   ssize_t n;
+
+   while(got < len)
+   {
+      n = recv(fd, pBuff + got, len - got, 0);
+      if(n <= 0)
+      {
+         return (-1);
+      }
+      got += (int)n;
+   }
+   return (got);
+}
+
+// reads the CONNECT, then answers with the CONNACK and the burst, in one write
+static int broker_Burst(void)
+{
+   static uint8_t tx[4 + (TEST_PUBS * TEST_PUB_LEN)];
+   uint8_t rx[128];
+   uint8_t *p;
+   int len;
+   int i;
+
+   CHECK(posix_RecvAll(test_BrokerFd, rx, 2) == 2);
+   CHECK((rx[0] >> 4) == MQTT_CONNECT);
+   len = rx[1];
+   CHECK(len < sizeof(rx));
+   CHECK(posix_RecvAll(test_BrokerFd, rx, len) == len);
+
+   p = tx;
+   *p++ = MQTT_CONNACK << 4;
+   *p++ = 2;
+   *p++ = 0;
+   *p++ = 0;
+   for(i = 0; i < TEST_PUBS; i++)
+   {
+      *p++ = MQTT_PUBLISH << 4;
+      *p++ = TEST_PUB_LEN - 2;
+      *p++ = 0;
+      *p++ = sizeof(TEST_TOPIC) - 1;
+      memcpy(p, TEST_TOPIC, sizeof(TEST_TOPIC) - 1);
+      p += sizeof(TEST_TOPIC) - 1;
+      memcpy(p, TEST_PAYLOAD, sizeof(TEST_PAYLOAD) - 1);
+      p += sizeof(TEST_PAYLOAD) - 1;
+   }
+   CHECK(send(test_BrokerFd, tx, sizeof(tx), 0) == sizeof(tx));
+   return (0);
+}
+
+static int test_GroupRx(void)
+{
+   static const MQTTClientCore_CtxCBs_t cbs = { test_PublishRx, test_AckNotify, test_DisconnCB };
+   MQTTClientCore_LibCfg_t libCfg;
+   MQTTClientCore_CtxCfg_t ctxCfg;
+   MQTT_UTF8String_t clientId = { "rx_test", 7 };
+   void *ctx = NULL;
+   uint32_t nPkts;
+   uint32_t nReads;
+
+   memset(&libCfg, 0, sizeof(libCfg));
+   libCfg.loopbackPort = TEST_LOOPBACK_PORT;
+   libCfg.grpUsesCbfn = true;
+   libCfg.mutex = &test_Mutex;
+   libCfg.mutexLockin = test_MutexLock;
+   libCfg.mutexUnlock = test_MutexUnlock;
+   CHECK(MQTTClientCore_initLib(&libCfg) == 0);
+   CHECK(MQTTClientCore_registerBuffers(TEST_MQP_NUM, test_Mqps, TEST_MQP_LEN, test_Bufs) == 0);
+   CHECK(MQTTClientCore_registerNetSvc(&test_NetOps) == 0);
+
+   memset(&ctxCfg, 0, sizeof(ctxCfg));
+   ctxCfg.configOpts = MQTTCLIENTCORE_CFG_APP_HAS_RTSK | MQTTCLIENTCORE_CFG_MK_GROUP_CTX;
+   ctxCfg.serverAddr = "broker";
+   ctxCfg.portNumber = 1883;
+   CHECK(MQTTClientCore_createCtx(&ctxCfg, &cbs, NULL, &ctx) == 0);
+   CHECK(MQTTClientCore_registerCtxInfo(ctx, &clientId, NULL, NULL) == 0);
+
+   // opens the loopback, which the CONNECT of a group 'ctx' wakes
+   CHECK(MQTTClientCore_run(0) == MQTT_PACKET_ERR_TIMEOUT);
+   CHECK(MQTTClientCore_sendConnectMsg(ctx, true, 0) > 0);
+   CHECK(broker_Burst() == 0);
+
+   CHECK(MQTTClientCore_run(1) == MQTT_PACKET_ERR_TIMEOUT);
+   MQTTClientCore_rxStatsGet(ctx, &nPkts, &nReads);
+
+   printf("%u PUBLISH in %u packets and %u reads, loopback read %u times, "
+          "first after %u PUBLISH\n",
+          test_Pubs, nPkts, nReads, test_LoopbReads, test_PubsAtWake);
+
+   CHECK(test_Connacks == 1);
+   CHECK(test_Pubs == TEST_PUBS);
+   CHECK(test_Disconns == 0);
+   CHECK(nPkts == TEST_PUBS + 1);
+   CHECK(nReads < nPkts / 4);
+   // the CONNECT wake, then the one sent on the first PUBLISH
+   CHECK(test_LoopbReads == 2);
+   // on the next pass, not once the packets in the RX buffer are all out
+   CHECK(test_PubsAtWake == 1);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if(test_GroupRx() != 0)
+   {
+      return (1);
+   }
+   printf("PASS group rx, loopback served during a %d PUBLISH burst\n", TEST_PUBS);
+
+   return (0);
+}
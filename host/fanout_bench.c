@@ -0,0 +1,421 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host benchmark of the MQTT server PUBLISH fan-out.
+ *
+ * Runs the server over the POSIX SlNetIf and connects, over loopback TCP,
+ * persistent sessions subscribed to one topic at QoS 0, 1 and 2, plus a
+ * publisher. Every round the publisher sends one QoS 2 PUBLISH, and the
+ * round ends when each subscriber has the message and has completed its
+ * acknowledgement. Subscribers are added in steps, up to past the first
+ * words of the server client maps, and after each step every subscriber
+ * must have had each message exactly once. Reports, for each step, the time
+ * per round and per delivery, and the server packets and buffer bytes
+ * allocated per fan-out.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/net/mqtt/server/client_mgmt.h>
+#include <ti/net/mqtt/server/server_core.h>
+
+#include "host_util.h"
+
+#define BENCH_PORT                     (18830)
+#define BENCH_SUBS_MAX                 (120)
+#define BENCH_ROUNDS                   (200)
+#define BENCH_PAYLOAD_LEN              (256)
+#define BENCH_TOPIC                    "fan/out"
+
+#define BENCH_FRAME_MAX                (BENCH_PAYLOAD_LEN + 64)
+#define BENCH_MSG_TYPE(fhByte)         ((fhByte) >> 4)
+
+extern int32_t MQTTNet_commOpen(uint32_t nwconnOpts, const char *serverAddr, uint16_t portNumber, const MQTT_SecureConn_t *nwSecurity);
+extern int32_t MQTTNet_tcpSend(int32_t comm, const uint8_t *buf, uint32_t len, void *ctx);
+extern int32_t MQTTNet_tcpRecv(int32_t comm, uint8_t *buf, uint32_t len, uint32_t waitSecs, bool *timedOut, void *ctx);
+extern int32_t MQTTNet_sendTo(int32_t comm, const uint8_t *buf, uint32_t len, uint16_t destPort, const uint8_t *destIP, uint32_t ipLen);
+extern int32_t MQTTNet_recvFrom(int32_t comm, uint8_t *buf, uint32_t len, uint16_t *fromPort, uint8_t *fromIP, uint32_t *ipLen);
+extern int32_t MQTTNet_commClose(int32_t comm);
+extern int32_t MQTTNet_tcpListen(uint32_t nwconnInfo, uint16_t portNumber, const MQTT_SecureConn_t *nwSecurity);
+extern int32_t MQTTNet_tcpAccept(uint32_t nwconnInfo, int32_t listenHnd, uint8_t *clientIP, uint32_t *ipLen);
+extern int32_t MQTTNet_tcpSelect(int32_t *recvCvec, int32_t *sendCvec, int32_t *rsvdCvec, uint32_t waitSecs);
+extern uint32_t MQTTNet_rtcSecs(void);
+
+static const MQTT_DeviceNetServices_t bench_NetOps =
+{
+   MQTTNet_commOpen, MQTTNet_tcpSend, MQTTNet_tcpRecv, MQTTNet_sendTo,
+   MQTTNet_recvFrom, MQTTNet_commClose, MQTTNet_tcpListen,
+   MQTTNet_tcpAccept, MQTTNet_tcpSelect, MQTTNet_rtcSecs
+};
+
+static pthread_mutex_t bench_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t *bench_pMutex = &bench_Mutex;
+
+typedef struct
+{
+   int fd;
+   uint8_t qos;
+   uint32_t received;
+} bench_Client_t;
+
+static bench_Client_t bench_Subs[BENCH_SUBS_MAX];
+static bench_Client_t bench_Publisher = { -1, MQTT_QOS2, 0 };
+static int bench_NumSubs;
+static uint16_t bench_MsgID;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static void bench_MutexLock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_lock(pMutex);
+}
+
+static void bench_MutexUnlock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_unlock(pMutex);
+}
+
+static void *bench_ServerTask(void *pArg)
+{
+   MQTTServerPkts_run(1);
+   return (NULL);
+}
+
+static int bench_Recv(int fd, uint8_t *pBuff, int len)
+{
+   int got = 0;
+   ssize_t n;
+
+   while(got < len)
+   {
+      n = recv(fd, pBuff + got, len - got, 0);
+      if(n <= 0)
+      {
+         return (-1);
+      }
+      got += (int)n;
+   }
+   return (got);
+}
+
+static int bench_SendFrame(int fd, uint8_t fhByte, const uint8_t *pBody, int len)
+{
+   uint8_t frame[BENCH_FRAME_MAX];
+   int n = 0;
+   int rem = len;
+
+   frame[n++] = fhByte;
+   do
+   {
+      frame[n] = rem & 0x7F;
+      rem >>= 7;
+      if(rem != 0)
+      {
+         frame[n] |= 0x80;
+      }
+      n++;
+   } while(rem != 0);
+   memcpy(frame + n, pBody, len);
+   n += len;
+
+   return ((send(fd, frame, n, 0) == n) ? 0 : -1);
+}
+
+static int bench_RecvFrame(int fd, uint8_t *pFhByte, uint8_t *pBody, int size)
+{
+   uint8_t byte;
+   int len = 0;
+   int shift = 0;
+
+   if(bench_Recv(fd, pFhByte, 1) != 1)
+   {
+      return (-1);
+   }
+   do
+   {
+      if(bench_Recv(fd, &byte, 1) != 1)
+      {
+         return (-1);
+      }
+      len |= (byte & 0x7F) << shift;
+      shift += 7;
+   } while(byte & 0x80);
+
+   if((len > size) || ((len > 0) && (bench_Recv(fd, pBody, len) != len)))
+   {
+      return (-1);
+   }
+   return (len);
+}
+
+static int bench_PutString(uint8_t *pBuff, const char *pStr)
+{
+   int len = strlen(pStr);
+
+   pBuff[0] = len >> 8;
+   pBuff[1] = len & 0xFF;
+   memcpy(pBuff + 2, pStr, len);
+   return (len + 2);
+}
+
+static int bench_SendAck(int fd, uint8_t fhByte, const uint8_t *pMsgID)
+{
+   return (bench_SendFrame(fd, fhByte, pMsgID, 2));
+}
+
+static int bench_Connect(bench_Client_t *pClient, const char *pClientID)
+{
+   static const uint8_t header[] = { 0, 4, 'M', 'Q', 'T', 'T', 4, 0x00, 0, 60 };
+   struct sockaddr_in addr;
+   uint8_t body[64];
+   uint8_t fhByte;
+   int len;
+
+   pClient->fd = socket(AF_INET, SOCK_STREAM, 0);
+   CHECK(pClient->fd >= 0);
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_port = htons(BENCH_PORT);
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   CHECK(connect(pClient->fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+
+   // persistent session, so QoS 1 and 2 messages are held for the acks
+   memcpy(body, header, sizeof(header));
+   len = sizeof(header) + bench_PutString(body + sizeof(header), pClientID);
+   CHECK(bench_SendFrame(pClient->fd, MQTT_MAKE_FH_BYTE1(MQTT_CONNECT, 0), body, len) == 0);
+   CHECK(bench_RecvFrame(pClient->fd, &fhByte, body, sizeof(body)) == 2);
+   CHECK((BENCH_MSG_TYPE(fhByte) == MQTT_CONNACK) && (body[1] == 0));
+
+   return (0);
+}
+
+static int bench_Subscribe(bench_Client_t *pClient)
+{
+   uint8_t body[32];
+   uint8_t fhByte;
+   int len = 0;
+
+   body[len++] = 0;
+   body[len++] = 1;
+   len += bench_PutString(body + len, BENCH_TOPIC);
+   body[len++] = pClient->qos;
+   CHECK(bench_SendFrame(pClient->fd, MQTT_MAKE_FH_BYTE1(MQTT_SUBSCRIBE, MQTT_MAKE_FH_FLAGS(false, MQTT_QOS1, false)), body, len) == 0);
+   CHECK(bench_RecvFrame(pClient->fd, &fhByte, body, sizeof(body)) == 3);
+   CHECK((BENCH_MSG_TYPE(fhByte) == MQTT_SUBACK) && (body[2] == pClient->qos));
+
+   return (0);
+}
+
+static int bench_Publish(bench_Client_t *pPublisher, uint16_t msgID, const uint8_t *pPayload)
+{
+   uint8_t body[BENCH_FRAME_MAX];
+   uint8_t fhByte;
+   int len;
+
+   len = bench_PutString(body, BENCH_TOPIC);
+   body[len++] = msgID >> 8;
+   body[len++] = msgID & 0xFF;
+   memcpy(body + len, pPayload, BENCH_PAYLOAD_LEN);
+   len += BENCH_PAYLOAD_LEN;
+   CHECK(bench_SendFrame(pPublisher->fd, MQTT_MAKE_FH_BYTE1(MQTT_PUBLISH, MQTT_MAKE_FH_FLAGS(false, MQTT_QOS2, false)), body, len) == 0);
+
+   CHECK(bench_RecvFrame(pPublisher->fd, &fhByte, body, sizeof(body)) == 2);
+   CHECK(BENCH_MSG_TYPE(fhByte) == MQTT_PUBREC);
+   CHECK(bench_SendAck(pPublisher->fd, MQTT_MAKE_FH_BYTE1(MQTT_PUBREL, MQTT_MAKE_FH_FLAGS(false, MQTT_QOS1, false)), body) == 0);
+   CHECK(bench_RecvFrame(pPublisher->fd, &fhByte, body, sizeof(body)) == 2);
+   CHECK(BENCH_MSG_TYPE(fhByte) == MQTT_PUBCOMP);
+
+   return (0);
+}
+
+static int bench_Deliver(bench_Client_t *pClient, const uint8_t *pPayload)
+{
+   uint8_t body[BENCH_FRAME_MAX];
+   uint8_t fhByte;
+   uint8_t qos;
+   int len;
+   int ofs;
+
+   len = bench_RecvFrame(pClient->fd, &fhByte, body, sizeof(body));
+   CHECK((len > 0) && (BENCH_MSG_TYPE(fhByte) == MQTT_PUBLISH));
+   qos = MQTT_FH_BYTE1_QOS(fhByte);
+   CHECK(qos == pClient->qos);
+
+   ofs = 2 + ((body[0] << 8) | body[1]);
+   CHECK(memcmp(body + 2, BENCH_TOPIC, ofs - 2) == 0);
+   if(qos != MQTT_QOS0)
+   {
+      ofs += 2;
+   }
+   CHECK((len - ofs == BENCH_PAYLOAD_LEN) && (memcmp(body + ofs, pPayload, BENCH_PAYLOAD_LEN) == 0));
+   pClient->received++;
+
+   if(qos == MQTT_QOS1)
+   {
+      CHECK(bench_SendAck(pClient->fd, MQTT_MAKE_FH_BYTE1(MQTT_PUBACK, 0), body + ofs - 2) == 0);
+   }
+   else if(qos == MQTT_QOS2)
+   {
+      CHECK(bench_SendAck(pClient->fd, MQTT_MAKE_FH_BYTE1(MQTT_PUBREC, 0), body + ofs - 2) == 0);
+      CHECK(bench_RecvFrame(pClient->fd, &fhByte, body, sizeof(body)) == 2);
+      CHECK(BENCH_MSG_TYPE(fhByte) == MQTT_PUBREL);
+      CHECK(bench_SendAck(pClient->fd, MQTT_MAKE_FH_BYTE1(MQTT_PUBCOMP, 0), body) == 0);
+   }
+
+   return (0);
+}
+
+static void bench_StatsGet(MQTTServerUtil_MqpStats_t *pMqp, MQTTClientMgmt_DispatchStats_t *pDispatch)
+{
+   // let the server finish with the last acks before reading its counters
+   usleep(50000);
+   pthread_mutex_lock(&bench_Mutex);
+   MQTTServerUtil_mqpStatsGet(pMqp);
+   MQTTClientMgmt_dispatchStatsGet(pDispatch);
+   pthread_mutex_unlock(&bench_Mutex);
+}
+
+// nothing more is queued to the subscriber, past the messages it acknowledged
+static int bench_NoDuplicate(bench_Client_t *pClient)
+{
+   uint8_t byte;
+
+   CHECK((recv(pClient->fd, &byte, 1, MSG_DONTWAIT) < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)));
+
+   return (0);
+}
+
+// subscribers up to 'numSubs', a third at each QoS, then the rounds
+static int bench_Fanout(int numSubs)
+{
+   static uint8_t payload[BENCH_PAYLOAD_LEN];
+   MQTTServerUtil_MqpStats_t mqpBefore;
+   MQTTServerUtil_MqpStats_t mqpAfter;
+   MQTTClientMgmt_DispatchStats_t dispBefore;
+   MQTTClientMgmt_DispatchStats_t dispAfter;
+   char clientID[16];
+   uint64_t start;
+   uint64_t elapsed;
+   int round;
+   int i;
+
+   for(i = bench_NumSubs; i < numSubs; i++)
+   {
+      snprintf(clientID, sizeof(clientID), "sub%d", i);
+      bench_Subs[i].qos = i % 3;
+      CHECK(bench_Connect(&bench_Subs[i], clientID) == 0);
+      CHECK(bench_Subscribe(&bench_Subs[i]) == 0);
+   }
+   bench_NumSubs = numSubs;
+   for(i = 0; i < numSubs; i++)
+   {
+      bench_Subs[i].received = 0;
+   }
+
+   bench_StatsGet(&mqpBefore, &dispBefore);
+   start = Host_Nsec();
+   for(round = 0; round < BENCH_ROUNDS; round++)
+   {
+      for(i = 0; i < BENCH_PAYLOAD_LEN; i++)
+      {
+         payload[i] = (uint8_t)(i + round);
+      }
+      bench_MsgID = (bench_MsgID % 0xFFFF) + 1;
+      CHECK(bench_Publish(&bench_Publisher, bench_MsgID, payload) == 0);
+      for(i = 0; i < numSubs; i++)
+      {
+         CHECK(bench_Deliver(&bench_Subs[i], payload) == 0);
+      }
+   }
+   elapsed = Host_Nsec() - start;
+   bench_StatsGet(&mqpAfter, &dispAfter);
+
+   for(i = 0; i < numSubs; i++)
+   {
+      CHECK(bench_Subs[i].received == BENCH_ROUNDS);
+      CHECK(bench_NoDuplicate(&bench_Subs[i]) == 0);
+   }
+   CHECK(dispAfter.sessionDrops == dispBefore.sessionDrops);
+   CHECK(dispAfter.deliveries - dispBefore.deliveries == (uint32_t)(numSubs * BENCH_ROUNDS));
+
+   printf("%3d subscribers (%d per QoS), %d byte payload: %6.1f us per fan-out, "
+          "%.2f us per delivery, %.2f packets allocated (%.0f bytes), %.2f views, "
+          "%.2f wait-listed per fan-out\n",
+          numSubs, numSubs / 3, BENCH_PAYLOAD_LEN,
+          (double)elapsed / BENCH_ROUNDS / 1000.0,
+          (double)elapsed / BENCH_ROUNDS / numSubs / 1000.0,
+          (double)(mqpAfter.allocs - mqpBefore.allocs) / BENCH_ROUNDS,
+          (double)(mqpAfter.allocBytes - mqpBefore.allocBytes) / BENCH_ROUNDS,
+          (double)(mqpAfter.views - mqpBefore.views) / BENCH_ROUNDS,
+          (double)(dispAfter.waitListed - dispBefore.waitListed) / BENCH_ROUNDS);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   static const uint32_t cipher = 0;
+   static const int numSubs[] = { 30, 60, BENCH_SUBS_MAX };
+   MQTTServerPkts_LibCfg_t libCfg;
+   MQTTServerCore_AppCfg_t appCfg = { NULL };
+   pthread_t thread;
+   int i;
+
+   setvbuf(stdout, NULL, _IONBF, 0);
+
+   SlNetIf_init(0);
+   SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5);
+   SlNetSock_init(0);
+   SlNetUtil_init(0);
+
+   memset(&libCfg, 0, sizeof(libCfg));
+   libCfg.listenerPort = BENCH_PORT;
+   libCfg.mutex = &bench_pMutex;
+   libCfg.mutexLockin = bench_MutexLock;
+   libCfg.mutexUnlock = bench_MutexUnlock;
+   libCfg.secure.cipher = (void *)&cipher;
+   if((MQTTServerCore_init(&libCfg, &appCfg) != 0) ||
+      (MQTTServerPkts_registerNetSvc(&bench_NetOps) != 0) ||
+      (pthread_create(&thread, NULL, bench_ServerTask, NULL) != 0))
+   {
+      printf("FAIL server start\n");
+      return (1);
+   }
+   // give the server task time to listen
+   usleep(100000);
+
+   if(bench_Connect(&bench_Publisher, "pub") != 0)
+   {
+      return (1);
+   }
+
+   // with the publisher, 31 clients fit the first client map word, the
+   // steps after spread over two and four words
+   for(i = 0; i < (int)(sizeof(numSubs) / sizeof(numSubs[0])); i++)
+   {
+      if(bench_Fanout(numSubs[i]) != 0)
+      {
+         return (1);
+      }
+   }
+
+   for(i = 0; i < bench_NumSubs; i++)
+   {
+      close(bench_Subs[i].fd);
+   }
+   close(bench_Publisher.fd);
+   return (0);
+}
@@ -0,0 +1,19 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file FreeRTOS.h
+ * @brief The little of FreeRTOS the application sources use, on the host
+ */
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+#include <stdint.h>
+
+#define portTICK_PERIOD_MS          1
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+typedef uint32_t TickType_t;
+
+#endif
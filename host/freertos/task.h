@@ -0,0 +1,33 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file task.h
+ * @brief FreeRTOS tick count and critical sections, on the host
+ *
+ * Ticks are milliseconds of the monotonic clock, and a critical section is
+ * a process wide lock.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H_
+#define HOST_FREERTOS_TASK_H_
+
+#include <pthread.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+
+static pthread_mutex_t host_CriticalLock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline TickType_t xTaskGetTickCount(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((TickType_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000));
+}
+
+#define taskENTER_CRITICAL()        pthread_mutex_lock(&host_CriticalLock)
+#define taskEXIT_CRITICAL()         pthread_mutex_unlock(&host_CriticalLock)
+
+#endif
@@ -0,0 +1,36 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Helpers shared by the host tests and benchmarks.
+ */
+
+#ifndef __HOST_UTIL_H__
+#define __HOST_UTIL_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define CHECK(cond)                                                           \
+   do                                                                         \
+   {                                                                          \
+      if(!(cond))                                                             \
+      {                                                                       \
+         printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);               \
+         return (-1);                                                         \
+      }                                                                       \
+   } while(0)
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+static inline uint64_t Host_Nsec(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return ((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+#endif // __HOST_UTIL_H__
@@ -0,0 +1,251 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host benchmark of the streaming JSON parse against the one-shot Json_parse().
+ *
+ * Parses shadow documents of a few sizes into the same template object, whole
+ * and in MQTT RX buffer sized chunks. The documents carry the few values the
+ * template asks for plus metadata that is skipped. Reports the RAM each way
+ * needs, which is the text held by the caller plus the heap peak of the parse,
+ * and the parse throughput. Heap use is taken by wrapping malloc() and free()
+ * at link time.
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/utils/json/json.h>
+
+#include "host_util.h"
+
+#define BENCH_CHUNK_LEN                (512)   // AWS_IOT_MQTT_RX_BUF_LEN
+#define BENCH_SMALL_CHUNK_LEN          (64)
+#define BENCH_TEXT_MAX                 (60000)
+#define BENCH_TEXT_BYTES               (8 * 1024 * 1024)
+
+#define BENCH_TEMPLATE                 \
+   "{"                                 \
+      "\"state\":{"                    \
+         "\"reported\":{"              \
+            "\"temp\":int32,"          \
+            "\"humidity\":int32,"      \
+            "\"fw\":string"            \
+         "}"                           \
+      "},"                             \
+      "\"version\":int32"              \
+   "}"
+
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+
+static size_t bench_HeapNow;
+static size_t bench_HeapPeak;
+
+static char bench_Text[BENCH_TEXT_MAX];
+static char bench_Chunk[BENCH_CHUNK_LEN];
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+void *__wrap_malloc(size_t size)
+{
+   void *ptr = __real_malloc(size);
+
+   if(ptr != NULL)
+   {
+      bench_HeapNow += malloc_usable_size(ptr);
+      if(bench_HeapNow > bench_HeapPeak)
+      {
+         bench_HeapPeak = bench_HeapNow;
+      }
+   }
+   return (ptr);
+}
+
+void __wrap_free(void *ptr)
+{
+   if(ptr != NULL)
+   {
+      bench_HeapNow -= malloc_usable_size(ptr);
+   }
+   __real_free(ptr);
+}
+
+// heap peak from here on, over what is in use now
+static void bench_HeapMark(void)
+{
+   bench_HeapPeak = bench_HeapNow;
+}
+
+static size_t bench_HeapPeakAbove(size_t base)
+{
+   return (bench_HeapPeak - base);
+}
+
+// shadow document with 'nMeta' skipped metadata entries
+static int bench_TextMake(int nMeta)
+{
+   int len;
+   int i;
+
+   len = snprintf(bench_Text, sizeof(bench_Text),
+                  "{\"state\":{\"reported\":{\"temp\":215,\"humidity\":48,\"fw\":\"1.4.2\","
+                  "\"log\":[");
+   for(i = 0; i < nMeta; i++)
+   {
+      len += snprintf(bench_Text + len, sizeof(bench_Text) - len, "%s\"evt %04d ok\"",
+                      i ? "," : "", i);
+   }
+   len += snprintf(bench_Text + len, sizeof(bench_Text) - len, "]}},\"metadata\":{");
+   for(i = 0; i < nMeta; i++)
+   {
+      len += snprintf(bench_Text + len, sizeof(bench_Text) - len,
+                      "%s\"k%04d\":{\"timestamp\":%d}", i ? "," : "", i, 1600000000 + i);
+   }
+   len += snprintf(bench_Text + len, sizeof(bench_Text) - len,
+                   "},\"version\":17,\"timestamp\":1600000123}");
+
+   return ((len < (int)sizeof(bench_Text) - 1) ? len : -1);
+}
+
+static int bench_Check(Json_Handle obj)
+{
+   char fw[16];
+   int32_t value;
+   uint16_t size;
+
+   size = sizeof(value);
+   CHECK(Json_getValue(obj, "\"state\".\"reported\".\"temp\"", &value, &size) == JSON_RC__OK);
+   CHECK(value == 215);
+   size = sizeof(value);
+   CHECK(Json_getValue(obj, "\"state\".\"reported\".\"humidity\"", &value, &size) == JSON_RC__OK);
+   CHECK(value == 48);
+   size = sizeof(value);
+   CHECK(Json_getValue(obj, "\"version\"", &value, &size) == JSON_RC__OK);
+   CHECK(value == 17);
+   size = sizeof(fw);
+   CHECK(Json_getValue(obj, "\"state\".\"reported\".\"fw\"", fw, &size) == JSON_RC__OK);
+   CHECK((size == 5) && (memcmp(fw, "1.4.2", 5) == 0));
+
+   return (0);
+}
+
+// the text arrives in 'chunkLen' pieces, through a buffer of that size
+static int bench_ParseStream(Json_Handle obj, int len, int chunkLen, uint16_t *pPeakWindow)
+{
+   uint32_t total = 0;
+   int off;
+   int n;
+
+   CHECK(Json_parseStreamBegin(obj, 0) == JSON_RC__OK);
+   for(off = 0; off < len; off += n)
+   {
+      n = ((len - off) < chunkLen) ? (len - off) : chunkLen;
+      memcpy(bench_Chunk, bench_Text + off, n);
+      CHECK(Json_parseStreamFeed(obj, bench_Chunk, (uint16_t)n) == JSON_RC__OK);
+   }
+   CHECK(Json_parseStreamEnd(obj, &total, pPeakWindow) == JSON_RC__OK);
+   CHECK(total == (uint32_t)len);
+
+   return (0);
+}
+
+static int bench_Document(Json_Handle obj, int nMeta)
+{
+   size_t base;
+   size_t oneShotHeap;
+   size_t streamHeap;
+   uint16_t peakWindow = 0;
+   uint64_t start;
+   uint64_t oneShotNs;
+   uint64_t streamNs;
+   uint64_t smallNs;
+   int rounds;
+   int len;
+   int i;
+
+   len = bench_TextMake(nMeta);
+   CHECK(len > 0);
+   rounds = BENCH_TEXT_BYTES / len;
+
+   // RAM, on a first parse each way
+   base = bench_HeapNow;
+   bench_HeapMark();
+   CHECK(Json_parse(obj, bench_Text, (uint16_t)len) == JSON_RC__OK);
+   oneShotHeap = bench_HeapPeakAbove(base);
+   CHECK(bench_Check(obj) == 0);
+
+   base = bench_HeapNow;
+   bench_HeapMark();
+   CHECK(bench_ParseStream(obj, len, BENCH_CHUNK_LEN, &peakWindow) == 0);
+   streamHeap = bench_HeapPeakAbove(base);
+   CHECK(bench_Check(obj) == 0);
+
+   // throughput
+   start = Host_Nsec();
+   for(i = 0; i < rounds; i++)
+   {
+      CHECK(Json_parse(obj, bench_Text, (uint16_t)len) == JSON_RC__OK);
+   }
+   oneShotNs = Host_Nsec() - start;
+
+   start = Host_Nsec();
+   for(i = 0; i < rounds; i++)
+   {
+      CHECK(bench_ParseStream(obj, len, BENCH_CHUNK_LEN, NULL) == 0);
+   }
+   streamNs = Host_Nsec() - start;
+
+   start = Host_Nsec();
+   for(i = 0; i < rounds; i++)
+   {
+      CHECK(bench_ParseStream(obj, len, BENCH_SMALL_CHUNK_LEN, NULL) == 0);
+   }
+   smallNs = Host_Nsec() - start;
+   CHECK(bench_Check(obj) == 0);
+
+   printf("%5d byte document:\n", len);
+   printf("   one-shot          RAM %5d text + %4zu heap, %6.1f MB/s\n",
+          len, oneShotHeap, (double)len * rounds * 1000.0 / oneShotNs);
+   printf("   stream %3d chunks RAM %5d text + %4zu heap, %6.1f MB/s, %u window bytes used\n",
+          BENCH_CHUNK_LEN, BENCH_CHUNK_LEN, streamHeap,
+          (double)len * rounds * 1000.0 / streamNs, peakWindow);
+   printf("   stream %3d chunks                            %6.1f MB/s\n",
+          BENCH_SMALL_CHUNK_LEN, (double)len * rounds * 1000.0 / smallNs);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   static const int nMeta[] = { 4, 64, 1024 };
+   Json_Handle tmpl;
+   Json_Handle obj;
+   int i;
+
+   if((Json_createTemplate(&tmpl, BENCH_TEMPLATE, strlen(BENCH_TEMPLATE)) != JSON_RC__OK) ||
+      (Json_createObject(&obj, tmpl, 0) != JSON_RC__OK))
+   {
+      printf("FAIL template or object\n");
+      return (1);
+   }
+
+   for(i = 0; i < (int)(sizeof(nMeta) / sizeof(nMeta[0])); i++)
+   {
+      if(bench_Document(obj, nMeta[i]) != 0)
+      {
+         return (1);
+      }
+   }
+
+   Json_destroyObject(obj);
+   Json_destroyTemplate(tmpl);
+
+   return (0);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host generator of the compiled JSON templates of the application.
+ *
+ * Compiles each template text of json_templates.h with the TI JSON library
+ * and writes json_templates.c, holding every compiled template as a const
+ * array for Json_createTemplateFromCompiled(). The compiled form holds 16
+ * and 32 bit fields in host order, the same little endian order as the
+ * target.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/utils/json/json.h>
+
+#include "../json_templates.h"
+#include "host_util.h"
+
+typedef struct
+{
+   const char *name;
+   const char *text;
+} gen_Template_t;
+
+static const gen_Template_t gen_Templates[] =
+{
+   { "JsonTemplate_Example", JSON_TEMPLATE_EXAMPLE },
+   { "JsonTemplate_EventMessage", JSON_TEMPLATE_EVENT_MESSAGE },
+};
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+// the lines of the file end as in the rest of the application sources
+static void gen_Line(const char *line)
+{
+   printf("%s\r\n", line);
+}
+
+static int gen_Template(const gen_Template_t *pTemplate)
+{
+   Json_Handle tmpl;
+   uint8_t *pData;
+   uint16_t len = 0;
+   char line[128];
+   int pos;
+   int i;
+   int j;
+
+   CHECK(Json_createTemplate(&tmpl, pTemplate->text, (uint16_t)strlen(pTemplate->text)) == JSON_RC__OK);
+   CHECK(Json_getCompiledTemplate(tmpl, NULL, &len) == JSON_RC__OK);
+   pData = malloc(len);
+   CHECK(pData != NULL);
+   CHECK(Json_getCompiledTemplate(tmpl, pData, &len) == JSON_RC__OK);
+
+   gen_Line("");
+   snprintf(line, sizeof(line), "static const union { uint32_t align; uint8_t bytes[%u]; } %sData =", len, pTemplate->name);
+   gen_Line(line);
+   gen_Line("{");
+   gen_Line("   .bytes =");
+   gen_Line("   {");
+   for(i = 0; i < len; i += 12)
+   {
+      pos = snprintf(line, sizeof(line), "     ");
+      for(j = i; (j < len) && (j < i + 12); j++)
+      {
+         pos += snprintf(line + pos, sizeof(line) - pos, " 0x%02x,", pData[j]);
+      }
+      gen_Line(line);
+   }
+   gen_Line("   }");
+   gen_Line("};");
+   gen_Line("");
+   snprintf(line, sizeof(line), "const JsonTemplate_Compiled_t %s = { %sData.bytes, %u };",
+            pTemplate->name, pTemplate->name, len);
+   gen_Line(line);
+
+   free(pData);
+   Json_destroyTemplate(tmpl);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   size_t i;
+
+   gen_Line("// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products");
+   gen_Line("// Not for further distribution.  All rights reserved.");
+   gen_Line("");
+   gen_Line("// Written by host/json_template_gen from the texts of json_templates.h, do not edit.");
+   gen_Line("");
+   gen_Line("#include \"json_templates.h\"");
+
+   for(i = 0; i < sizeof(gen_Templates) / sizeof(gen_Templates[0]); i++)
+   {
+      if(gen_Template(&gen_Templates[i]) != 0)
+      {
+         return (1);
+      }
+   }
+
+   return (0);
+}
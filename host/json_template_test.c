@@ -0,0 +1,153 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the compiled JSON templates the application boots from.
+ *
+ * Each compiled template of json_templates.c is checked to be what the TI
+ * JSON library compiles from its text today, so that a text changed without
+ * running the generator fails here. The same document is then parsed with
+ * the template made from the text and with the one loaded from the compiled
+ * form, and both objects must hold the same values and build the same text.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/utils/json/json.h>
+
+#include "../json_templates.h"
+#include "host_util.h"
+
+typedef struct
+{
+   const char *name;
+   const char *text;
+   const JsonTemplate_Compiled_t *pCompiled;
+   const char *document;
+   const char *keys[8];
+} test_Template_t;
+
+static const test_Template_t test_Templates[] =
+{
+   {
+      "JsonTemplate_Example", JSON_TEMPLATE_EXAMPLE, &JsonTemplate_Example,
+      "{\"method\": \"event\", \"gatewayId\": 123456, \"collectorId\": -78910, \"deviceId\": true, "
+      "\"eventList\": [\"7E0155FF14167E\", \"7E814101EE2A7E\", \"7E0146014CE77E\"]}",
+      { "\"method\"", "\"gatewayId\"", "\"collectorId\"", "\"deviceId\"",
+        "\"eventList\".[0]", "\"eventList\".[2]", NULL },
+   },
+   {
+      "JsonTemplate_EventMessage", JSON_TEMPLATE_EVENT_MESSAGE, &JsonTemplate_EventMessage,
+      "{\"method\":\"event\",\"gatewayId\":\"98765\",\"collectorId\":\"1234\",\"deviceId\":\"554\","
+      "\"eventList\":[\"7E0155FF14167E\",\"7E814101EE2A7E\",\"7E0146014CE77E\","
+      "\"7E815603548C7E\",\"7E81430098697E\",\"7E814103CE687E\"]}",
+      { "\"method\"", "\"gatewayId\"", "\"collectorId\"", "\"deviceId\"",
+        "\"eventList\".[0]", "\"eventList\".[5]", NULL },
+   },
+};
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+// the checked in compiled template is the one the text compiles to
+static int test_Current(const test_Template_t *pTest)
+{
+   Json_Handle tmpl;
+   uint8_t *pData;
+   uint16_t len = 0;
+   int same;
+
+   CHECK(Json_createTemplate(&tmpl, pTest->text, (uint16_t)strlen(pTest->text)) == JSON_RC__OK);
+   CHECK(Json_getCompiledTemplate(tmpl, NULL, &len) == JSON_RC__OK);
+   pData = malloc(len);
+   CHECK(pData != NULL);
+   CHECK(Json_getCompiledTemplate(tmpl, pData, &len) == JSON_RC__OK);
+
+   same = (len == pTest->pCompiled->len) && (memcmp(pData, pTest->pCompiled->data, len) == 0);
+   free(pData);
+   Json_destroyTemplate(tmpl);
+   if(!same)
+   {
+      printf("%s is stale, run make -C host templates\n", pTest->name);
+   }
+   CHECK(same);
+
+   return (0);
+}
+
+// the library may work on the text in place, it gets a copy
+static int test_Parse(Json_Handle tmpl, const char *document, Json_Handle *pObj)
+{
+   char text[512];
+
+   CHECK(strlen(document) < sizeof(text));
+   strcpy(text, document);
+   CHECK(Json_createObject(pObj, tmpl, 0) == JSON_RC__OK);
+   CHECK(Json_parse(*pObj, text, (uint16_t)strlen(text)) == JSON_RC__OK);
+
+   return (0);
+}
+
+// a document parsed with either template holds the same values
+static int test_RoundTrip(const test_Template_t *pTest)
+{
+   Json_Handle textTmpl;
+   Json_Handle compiledTmpl;
+   Json_Handle textObj;
+   Json_Handle compiledObj;
+   char textBuf[512];
+   char compiledBuf[512];
+   uint16_t textLen;
+   uint16_t compiledLen;
+   int i;
+
+   CHECK(Json_createTemplate(&textTmpl, pTest->text, (uint16_t)strlen(pTest->text)) == JSON_RC__OK);
+   CHECK(Json_createTemplateFromCompiled(&compiledTmpl, pTest->pCompiled->data, pTest->pCompiled->len) == JSON_RC__OK);
+   CHECK(test_Parse(textTmpl, pTest->document, &textObj) == 0);
+   CHECK(test_Parse(compiledTmpl, pTest->document, &compiledObj) == 0);
+
+   for(i = 0; pTest->keys[i] != NULL; i++)
+   {
+      textLen = sizeof(textBuf);
+      compiledLen = sizeof(compiledBuf);
+      CHECK(Json_getValue(textObj, pTest->keys[i], textBuf, &textLen) == JSON_RC__OK);
+      CHECK(Json_getValue(compiledObj, pTest->keys[i], compiledBuf, &compiledLen) == JSON_RC__OK);
+      CHECK(textLen == compiledLen);
+      CHECK(memcmp(textBuf, compiledBuf, textLen) == 0);
+   }
+
+   textLen = sizeof(textBuf);
+   compiledLen = sizeof(compiledBuf);
+   CHECK(Json_build(textObj, textBuf, &textLen) == JSON_RC__OK);
+   CHECK(Json_build(compiledObj, compiledBuf, &compiledLen) == JSON_RC__OK);
+   CHECK(textLen == compiledLen);
+   CHECK(memcmp(textBuf, compiledBuf, textLen) == 0);
+
+   Json_destroyObject(textObj);
+   Json_destroyObject(compiledObj);
+   Json_destroyTemplate(textTmpl);
+   Json_destroyTemplate(compiledTmpl);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   size_t i;
+
+   for(i = 0; i < sizeof(test_Templates) / sizeof(test_Templates[0]); i++)
+   {
+      if((test_Current(&test_Templates[i]) != 0) || (test_RoundTrip(&test_Templates[i]) != 0))
+      {
+         return (1);
+      }
+      printf("PASS %s, %u bytes, parses as its text\n", test_Templates[i].name, test_Templates[i].pCompiled->len);
+   }
+
+   return (0);
+}
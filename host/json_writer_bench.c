@@ -0,0 +1,294 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host benchmark of the ways the application can write its eventList message.
+ *
+ * The same message, with a few event counts, is written by JsonWriter into a
+ * caller buffer, built as a cJSON tree and printed with cJSON_Print() and
+ * cJSON_PrintUnformatted(), and set into a TI JSON object and written with
+ * Json_build(). Each way is checked to hold the values of the JsonWriter
+ * text. Reports the time per message and the RAM each way needs: the caller
+ * buffer and state, plus the heap peak while the message is written. For
+ * Json_build() the template and object are made once, the heap they hold is
+ * reported apart. Heap use is taken by wrapping malloc() and free() at link
+ * time.
+ */
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/utils/json/json.h>
+
+#include "../JsonWriter.h"
+#include "../external/cJSON/cJSON.h"
+#include "host_util.h"
+
+#define BENCH_EVENTS_MAX               (32)
+#define BENCH_EVENT_LEN                (14)
+#define BENCH_TEXT_MAX                 (2048)
+#define BENCH_ROUNDS                   (20000)
+
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+
+static size_t bench_HeapNow;
+static size_t bench_HeapPeak;
+
+static const char *bench_Events[BENCH_EVENTS_MAX];
+static char bench_EventText[BENCH_EVENTS_MAX][BENCH_EVENT_LEN + 1];
+
+static char bench_Text[BENCH_TEXT_MAX];
+static uint32_t bench_TextLen;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+void *__wrap_malloc(size_t size)
+{
+   void *ptr = __real_malloc(size);
+
+   if(ptr != NULL)
+   {
+      bench_HeapNow += malloc_usable_size(ptr);
+      if(bench_HeapNow > bench_HeapPeak)
+      {
+         bench_HeapPeak = bench_HeapNow;
+      }
+   }
+   return (ptr);
+}
+
+void __wrap_free(void *ptr)
+{
+   if(ptr != NULL)
+   {
+      bench_HeapNow -= malloc_usable_size(ptr);
+   }
+   __real_free(ptr);
+}
+
+// heap peak from here on, over what is in use now
+static size_t bench_HeapMark(void)
+{
+   bench_HeapPeak = bench_HeapNow;
+   return (bench_HeapNow);
+}
+
+static double bench_NsPer(uint64_t start)
+{
+   return ((double)(Host_Nsec() - start) / BENCH_ROUNDS);
+}
+
+// the message of JsonWriter_TestMessage(), with 'nEvents' events
+static void bench_Writer(JsonWriter_t *pWriter, int nEvents)
+{
+   int i;
+
+   JsonWriter_Init(pWriter, bench_Text, sizeof(bench_Text), 0);
+   JsonWriter_ObjectBegin(pWriter, NULL);
+   JsonWriter_String(pWriter, "method", "event", 5);
+   JsonWriter_String(pWriter, "gatewayId", "98765", 5);
+   JsonWriter_String(pWriter, "collectorId", "1234", 4);
+   JsonWriter_String(pWriter, "deviceId", "554", 3);
+   JsonWriter_ArrayBegin(pWriter, "eventList");
+   for(i = 0; i < nEvents; i++)
+   {
+      JsonWriter_String(pWriter, NULL, bench_Events[i], BENCH_EVENT_LEN);
+   }
+   JsonWriter_ArrayEnd(pWriter);
+   JsonWriter_ObjectEnd(pWriter);
+}
+
+static char *bench_CJSON(int nEvents, bool formatted)
+{
+   cJSON *json = cJSON_CreateObject();
+   char *text;
+
+   cJSON_AddItemToObject(json, "method", cJSON_CreateString("event"));
+   cJSON_AddItemToObject(json, "gatewayId", cJSON_CreateString("98765"));
+   cJSON_AddItemToObject(json, "collectorId", cJSON_CreateString("1234"));
+   cJSON_AddItemToObject(json, "deviceId", cJSON_CreateString("554"));
+   cJSON_AddItemToObject(json, "eventList", cJSON_CreateStringArray(bench_Events, nEvents));
+   text = formatted ? cJSON_Print(json) : cJSON_PrintUnformatted(json);
+   cJSON_Delete(json);
+
+   return (text);
+}
+
+static int bench_JsonBuild(Json_Handle obj, int nEvents, char *pText, uint16_t *pLen)
+{
+   char key[24];
+   int i;
+
+   CHECK(Json_setValue(obj, "\"method\"", "event", 5) == JSON_RC__OK);
+   CHECK(Json_setValue(obj, "\"gatewayId\"", "98765", 5) == JSON_RC__OK);
+   CHECK(Json_setValue(obj, "\"collectorId\"", "1234", 4) == JSON_RC__OK);
+   CHECK(Json_setValue(obj, "\"deviceId\"", "554", 3) == JSON_RC__OK);
+   for(i = 0; i < nEvents; i++)
+   {
+      snprintf(key, sizeof(key), "\"eventList\".[%d]", i);
+      CHECK(Json_setValue(obj, key, (void *)bench_Events[i], BENCH_EVENT_LEN) == JSON_RC__OK);
+   }
+   CHECK(Json_build(obj, pText, pLen) == JSON_RC__OK);
+
+   return (0);
+}
+
+// 'text' holds the values of the JsonWriter text, as cJSON reads both
+static int bench_Same(const char *text)
+{
+   cJSON *json = cJSON_Parse(text);
+   cJSON *expected = cJSON_Parse(bench_Text);
+   char *strJson;
+   char *strExpected;
+   int same;
+
+   CHECK((json != NULL) && (expected != NULL));
+   strJson = cJSON_PrintUnformatted(json);
+   strExpected = cJSON_PrintUnformatted(expected);
+   same = (strJson != NULL) && (strExpected != NULL) && (strcmp(strJson, strExpected) == 0);
+   free(strJson);
+   free(strExpected);
+   cJSON_Delete(json);
+   cJSON_Delete(expected);
+   CHECK(same);
+
+   return (0);
+}
+
+static int bench_Message(int nEvents)
+{
+   JsonWriter_t writer;
+   Json_Handle tmpl;
+   Json_Handle obj;
+   char tmplText[512];
+   char built[BENCH_TEXT_MAX];
+   uint16_t builtLen;
+   char *text;
+   size_t base;
+   size_t printHeap;
+   size_t printFmtHeap;
+   size_t buildHeap;
+   size_t objectHeap;
+   uint64_t start;
+   double writerNs;
+   double printNs;
+   double printFmtNs;
+   double buildNs;
+   int len;
+   int i;
+
+   // JsonWriter, the reference text
+   base = bench_HeapMark();
+   bench_Writer(&writer, nEvents);
+   CHECK(JsonWriter_IsDone(&writer) && !JsonWriter_IsFull(&writer));
+   CHECK(bench_HeapPeak == base);
+   bench_TextLen = JsonWriter_Len(&writer);
+   bench_Text[bench_TextLen] = '\0';
+
+   start = Host_Nsec();
+   for(i = 0; i < BENCH_ROUNDS; i++)
+   {
+      bench_Writer(&writer, nEvents);
+   }
+   writerNs = bench_NsPer(start);
+
+   // cJSON, tree and printed text on the heap
+   base = bench_HeapMark();
+   text = bench_CJSON(nEvents, false);
+   printHeap = bench_HeapPeak - base;
+   CHECK((text != NULL) && (strcmp(text, bench_Text) == 0));
+   free(text);
+
+   base = bench_HeapMark();
+   text = bench_CJSON(nEvents, true);
+   printFmtHeap = bench_HeapPeak - base;
+   CHECK((text != NULL) && (bench_Same(text) == 0));
+   free(text);
+
+   start = Host_Nsec();
+   for(i = 0; i < BENCH_ROUNDS; i++)
+   {
+      free(bench_CJSON(nEvents, false));
+   }
+   printNs = bench_NsPer(start);
+
+   start = Host_Nsec();
+   for(i = 0; i < BENCH_ROUNDS; i++)
+   {
+      free(bench_CJSON(nEvents, true));
+   }
+   printFmtNs = bench_NsPer(start);
+
+   // Json_build(), over a template and object made once
+   len = snprintf(tmplText, sizeof(tmplText),
+                  "{\"method\":string,\"gatewayId\":string,\"collectorId\":string,"
+                  "\"deviceId\":string,\"eventList\":[");
+   for(i = 0; i < nEvents; i++)
+   {
+      len += snprintf(tmplText + len, sizeof(tmplText) - len, "%sstring", i ? "," : "");
+   }
+   snprintf(tmplText + len, sizeof(tmplText) - len, "]}");
+
+   base = bench_HeapMark();
+   CHECK(Json_createTemplate(&tmpl, tmplText, (uint16_t)strlen(tmplText)) == JSON_RC__OK);
+   CHECK(Json_createObject(&obj, tmpl, 0) == JSON_RC__OK);
+   objectHeap = bench_HeapNow - base;
+
+   base = bench_HeapMark();
+   builtLen = sizeof(built) - 1;
+   CHECK(bench_JsonBuild(obj, nEvents, built, &builtLen) == 0);
+   buildHeap = bench_HeapPeak - base;
+   built[builtLen] = '\0';
+   CHECK(bench_Same(built) == 0);
+
+   start = Host_Nsec();
+   for(i = 0; i < BENCH_ROUNDS; i++)
+   {
+      builtLen = sizeof(built) - 1;
+      CHECK(bench_JsonBuild(obj, nEvents, built, &builtLen) == 0);
+   }
+   buildNs = bench_NsPer(start);
+
+   Json_destroyObject(obj);
+   Json_destroyTemplate(tmpl);
+
+   printf("%2d events, %u byte message:\n", nEvents, bench_TextLen);
+   printf("   JsonWriter              %7.0f ns, RAM %4u buffer + %2zu state, no heap\n",
+          writerNs, bench_TextLen, sizeof(writer));
+   printf("   cJSON_PrintUnformatted  %7.0f ns, RAM %4zu heap\n", printNs, printHeap);
+   printf("   cJSON_Print             %7.0f ns, RAM %4zu heap\n", printFmtNs, printFmtHeap);
+   printf("   Json_build              %7.0f ns, RAM %4u buffer + %4zu heap, %4zu held by the object\n",
+          buildNs, builtLen, buildHeap, objectHeap);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   static const int nEvents[] = { 6, 16, BENCH_EVENTS_MAX };
+   int i;
+
+   for(i = 0; i < BENCH_EVENTS_MAX; i++)
+   {
+      snprintf(bench_EventText[i], sizeof(bench_EventText[i]), "7E81%04X%02X%04X", 0x4101 + i, i, 0xEE2A);
+      bench_Events[i] = bench_EventText[i];
+   }
+
+   for(i = 0; i < (int)(sizeof(nEvents) / sizeof(nEvents[0])); i++)
+   {
+      if(bench_Message(nEvents[i]) != 0)
+      {
+         return (1);
+      }
+   }
+
+   return (0);
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host run of the JsonWriter self test the application makes at start.
+ *
+ * The writer output is checked against the expected text, against itself
+ * written in parts, and against the same message built by cJSON and by the
+ * TI JSON library.
+ */
+
+#include <stdio.h>
+
+#include "json_test.h"
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if(!JsonWriter_Test())
+   {
+      printf("FAIL JsonWriter_Test()\n");
+      return (1);
+   }
+   printf("PASS json writer, same text as cJSON and Json_build()\n");
+
+   return (0);
+}
@@ -0,0 +1,281 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the MQTT driver receive path, with the buffer pool of the
+ * firmware build.
+ *
+ * The driver and the MQTT client library run over the POSIX SlNetIf, against
+ * a broker that is a socket of the test. The broker sends PUBLISH messages,
+ * which the test takes off the driver receive queue as the application task
+ * does. While the application keeps up, every message reaches it in the
+ * library buffer it was received in, without a copy. An application that
+ * holds on to its messages runs the pool down to its reserve: the messages
+ * past that are copied into receive slots, and once the application releases
+ * its buffers they are held in place again.
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/drivers/net/wifi/simplelink.h>
+#include <ti/net/mqtt/mqttclient.h>
+#include <ti/net/slnetutils.h>
+
+#include "../MQTTDriver.h"
+#include "host_util.h"
+
+#define TEST_PORT                      (45873)
+#define TEST_TOPIC                     "/Broker/To/cc32xx"
+#define TEST_PAYLOAD                   "toggle"
+#define TEST_ROUNDS                    (50)
+#define TEST_HELD                      (8)
+#define TEST_WAIT_MS                   (2000)
+
+mqd_t __real_mq_open(const char *name, int oflag, ...);
+
+extern MQTTClient_ConnParams Mqtt_ClientCtx;
+
+static int test_ListenFd = -1;
+static int test_BrokerFd = -1;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+void UART_PRINT(char *label, ...)
+{
+}
+
+// the date set for the certificate checks, the test makes no TLS connection
+int16_t sl_DeviceSet(const _u8 DeviceSetId, const _u8 Option, const _u16 ConfigLen, const _u8 *pValues)
+{
+   return (0);
+}
+
+// Linux queue names start with a '/', those of the TI POSIX layer don't
+mqd_t __wrap_mq_open(const char *name, int oflag, ...)
+{
+   struct mq_attr *attr;
+   char hostName[64];
+   mode_t mode;
+   va_list args;
+
+   snprintf(hostName, sizeof(hostName), "/%s.%d", name, (int)getpid());
+   va_start(args, oflag);
+   mode = va_arg(args, mode_t);
+   attr = va_arg(args, struct mq_attr *);
+   va_end(args);
+
+   mq_unlink(hostName);
+   return (__real_mq_open(hostName, oflag, mode, attr));
+}
+
+static int broker_Read(uint8_t *pBuf, size_t len)
+{
+   size_t off = 0;
+   ssize_t n;
+
+   while(off < len)
+   {
+      n = read(test_BrokerFd, pBuf + off, len - off);
+      if(n <= 0)
+      {
+         return (-1);
+      }
+      off += n;
+   }
+   return (0);
+}
+
+// one packet, of less than 128 bytes past its fixed header
+static int broker_ReadPacket(uint8_t *pType)
+{
+   uint8_t hdr[2];
+   uint8_t body[128];
+
+   CHECK(broker_Read(hdr, sizeof(hdr)) == 0);
+   CHECK((hdr[1] & 0x80) == 0);
+   CHECK(broker_Read(body, hdr[1]) == 0);
+   *pType = hdr[0] >> 4;
+
+   return (0);
+}
+
+static int broker_Publish(int n)
+{
+   uint8_t pkt[4 + sizeof(TEST_TOPIC) + sizeof(TEST_PAYLOAD)];
+   size_t topicLen = sizeof(TEST_TOPIC) - 1;
+   size_t len = 2 + topicLen + sizeof(TEST_PAYLOAD) - 1;
+   int i;
+
+   pkt[0] = 0x30;   // PUBLISH, QoS 0
+   pkt[1] = (uint8_t)len;
+   pkt[2] = 0;
+   pkt[3] = (uint8_t)topicLen;
+   memcpy(&pkt[4], TEST_TOPIC, topicLen);
+   memcpy(&pkt[4 + topicLen], TEST_PAYLOAD, sizeof(TEST_PAYLOAD) - 1);
+
+   for(i = 0; i < n; i++)
+   {
+      CHECK(write(test_BrokerFd, pkt, 2 + len) == (ssize_t)(2 + len));
+   }
+   return (0);
+}
+
+// the client connects, and the broker accepts it
+static void *broker_Thread(void *arg)
+{
+   static const uint8_t connack[] = { 0x20, 2, 0, 0 };
+   uint8_t type = 0;
+
+   test_BrokerFd = accept(test_ListenFd, NULL, NULL);
+   if((test_BrokerFd < 0) || (broker_ReadPacket(&type) != 0) || (type != 1))
+   {
+      printf("FAIL no CONNECT\n");
+      return (NULL);
+   }
+   if(write(test_BrokerFd, connack, sizeof(connack)) != sizeof(connack))
+   {
+      printf("FAIL CONNACK\n");
+   }
+   return (NULL);
+}
+
+static int test_Check(const MQTT_RecvMsg_t *pMsg)
+{
+   CHECK(pMsg->topicLen == sizeof(TEST_TOPIC) - 1);
+   CHECK(memcmp(pMsg->topic, TEST_TOPIC, pMsg->topicLen) == 0);
+   CHECK(pMsg->payloadLen == sizeof(TEST_PAYLOAD) - 1);
+   CHECK(memcmp(pMsg->payload, TEST_PAYLOAD, pMsg->payloadLen) == 0);
+
+   return (0);
+}
+
+static int test_Setup(void)
+{
+   static uint8_t mac[SL_MAC_ADDR_LEN] = { 0x34, 0x03, 0xde, 0x11, 0xd3, 0xba };
+   struct sockaddr_in addr;
+   pthread_t broker;
+   int one = 1;
+
+   CHECK(SlNetIf_init(0) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5) == 0);
+   CHECK(SlNetSock_init(0) == 0);
+   CHECK(SlNetUtil_init(0) == 0);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   addr.sin_port = htons(TEST_PORT);
+   test_ListenFd = socket(AF_INET, SOCK_STREAM, 0);
+   CHECK(test_ListenFd >= 0);
+   setsockopt(test_ListenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+   CHECK(bind(test_ListenFd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+   CHECK(listen(test_ListenFd, 1) == 0);
+   CHECK(pthread_create(&broker, NULL, broker_Thread, NULL) == 0);
+
+   // plain TCP to the test broker
+   Mqtt_ClientCtx.netconnFlags = MQTTCLIENT_NETCONN_IP4;
+   Mqtt_ClientCtx.serverAddr = "127.0.0.1";
+   Mqtt_ClientCtx.port = TEST_PORT;
+
+   CHECK(MQTT_Init(mac, sizeof(mac)) == 0);
+   pthread_join(broker, NULL);
+   CHECK(test_BrokerFd >= 0);
+
+   return (0);
+}
+
+// the application keeps up, no message is copied
+static int test_InPlace(void)
+{
+   MQTT_RecvStats_t stats;
+   MQTT_RecvMsg_t msg;
+   int i;
+
+   for(i = 0; i < TEST_ROUNDS; i++)
+   {
+      CHECK(broker_Publish(1) == 0);
+      CHECK(MQTT_ReceiveMsg(&msg, TEST_WAIT_MS) == 0);
+      CHECK(msg.recvBuffer != NULL);
+      CHECK(test_Check(&msg) == 0);
+      MQTT_ReleaseMsg(&msg);
+   }
+
+   MQTT_GetRecvStats(&stats);
+   CHECK(stats.publishes == TEST_ROUNDS);
+   CHECK(stats.heldInPlace == TEST_ROUNDS);
+   CHECK(stats.slotCopies == 0);
+   CHECK(stats.bytesCopied == 0);
+
+   return (0);
+}
+
+// the application holds its messages, the pool keeps its reserve
+static int test_PoolReserve(void)
+{
+   MQTT_RecvMsg_t msgs[TEST_HELD];
+   MQTT_RecvStats_t before;
+   MQTT_RecvStats_t after;
+   int held = 0;
+   int i;
+
+   MQTT_GetRecvStats(&before);
+   CHECK(broker_Publish(TEST_HELD) == 0);
+   for(i = 0; i < TEST_HELD; i++)
+   {
+      CHECK(MQTT_ReceiveMsg(&msgs[i], TEST_WAIT_MS) == 0);
+      CHECK(test_Check(&msgs[i]) == 0);
+      held += (msgs[i].recvBuffer != NULL);
+   }
+   MQTT_GetRecvStats(&after);
+
+   printf("%d of %d messages held in place, %u copied to receive slots\n",
+          held, TEST_HELD, after.slotCopies - before.slotCopies);
+   CHECK(held > 0);
+   CHECK(after.heldInPlace - before.heldInPlace == (uint32_t)held);
+   CHECK(after.slotCopies - before.slotCopies == (uint32_t)(TEST_HELD - held));
+   CHECK(held < TEST_HELD);
+
+   for(i = 0; i < TEST_HELD; i++)
+   {
+      MQTT_ReleaseMsg(&msgs[i]);
+   }
+
+   // the buffers are back in the pool
+   CHECK(broker_Publish(1) == 0);
+   CHECK(MQTT_ReceiveMsg(&msgs[0], TEST_WAIT_MS) == 0);
+   CHECK(msgs[0].recvBuffer != NULL);
+   MQTT_ReleaseMsg(&msgs[0]);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if((test_Setup() != 0) || (test_InPlace() != 0))
+   {
+      return (1);
+   }
+   printf("PASS %d messages reached the application in the library buffer\n", TEST_ROUNDS);
+
+   if(test_PoolReserve() != 0)
+   {
+      return (1);
+   }
+   printf("PASS held messages leave the pool its reserve, and come back to it\n");
+
+   return (0);
+}
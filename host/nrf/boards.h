@@ -0,0 +1,12 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file boards.h
+ * @brief Included by the CC3135 port, nothing of it is used on the host
+ */
+
+#ifndef HOST_BOARDS_H_
+#define HOST_BOARDS_H_
+
+#endif
@@ -0,0 +1,83 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file nrf_drv_gpiote.h
+ * @brief GPIOTE calls of the CC3135 port, which do nothing on the host
+ */
+
+#ifndef HOST_NRF_DRV_GPIOTE_H_
+#define HOST_NRF_DRV_GPIOTE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nrf_gpio.h"
+
+typedef uint32_t nrf_drv_gpiote_pin_t;
+typedef uint32_t nrf_gpiote_events_t;
+
+typedef enum
+{
+   NRF_GPIOTE_POLARITY_LOTOHI = 1,
+   NRF_GPIOTE_POLARITY_HITOLO,
+   NRF_GPIOTE_POLARITY_TOGGLE
+} nrf_gpiote_polarity_t;
+
+typedef struct
+{
+   nrf_gpiote_polarity_t sense;
+   nrf_gpio_pin_pull_t pull;
+   bool hi_accuracy;
+} nrf_drv_gpiote_in_config_t;
+
+typedef struct
+{
+   bool init_state;
+} nrf_drv_gpiote_out_config_t;
+
+#define GPIOTE_CONFIG_IN_SENSE_LOTOHI(hi_accu) \
+   { .sense = NRF_GPIOTE_POLARITY_LOTOHI, .pull = NRF_GPIO_PIN_NOPULL, .hi_accuracy = (hi_accu) }
+#define GPIOTE_CONFIG_IN_SENSE_HITOLO(hi_accu) \
+   { .sense = NRF_GPIOTE_POLARITY_HITOLO, .pull = NRF_GPIO_PIN_NOPULL, .hi_accuracy = (hi_accu) }
+#define GPIOTE_CONFIG_OUT_SIMPLE(init_high) \
+   { .init_state = (init_high) }
+
+typedef void (*nrf_drv_gpiote_evt_handler_t)(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action);
+
+static inline bool nrf_drv_gpiote_is_init(void)
+{
+   return (true);
+}
+
+static inline uint32_t nrf_drv_gpiote_init(void)
+{
+   return (0);
+}
+
+static inline uint32_t nrf_drv_gpiote_in_init(nrf_drv_gpiote_pin_t pin,
+                                              nrf_drv_gpiote_in_config_t const *p_config,
+                                              nrf_drv_gpiote_evt_handler_t evt_handler)
+{
+   return (0);
+}
+
+static inline void nrf_drv_gpiote_in_event_enable(nrf_drv_gpiote_pin_t pin, bool int_enable)
+{
+}
+
+static inline void nrf_drv_gpiote_in_event_disable(nrf_drv_gpiote_pin_t pin)
+{
+}
+
+static inline uint32_t nrf_drv_gpiote_out_init(nrf_drv_gpiote_pin_t pin,
+                                               nrf_drv_gpiote_out_config_t const *p_config)
+{
+   return (0);
+}
+
+static inline void nrf_gpiote_event_clear(nrf_gpiote_events_t event)
+{
+}
+
+#endif
@@ -0,0 +1,25 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file nrf_gpio.h
+ * @brief GPIO pin writes of the CC3135 port, which do nothing on the host
+ */
+
+#ifndef HOST_NRF_GPIO_H_
+#define HOST_NRF_GPIO_H_
+
+#include <stdint.h>
+
+typedef enum
+{
+   NRF_GPIO_PIN_NOPULL,
+   NRF_GPIO_PIN_PULLDOWN,
+   NRF_GPIO_PIN_PULLUP = 3
+} nrf_gpio_pin_pull_t;
+
+static inline void nrf_gpio_pin_write(uint32_t pin_number, uint32_t value)
+{
+}
+
+#endif
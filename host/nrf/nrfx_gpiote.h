@@ -0,0 +1,12 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file nrfx_gpiote.h
+ * @brief Included by the CC3135 port, nothing of it is used on the host
+ */
+
+#ifndef HOST_NRFX_GPIOTE_H_
+#define HOST_NRFX_GPIOTE_H_
+
+#endif
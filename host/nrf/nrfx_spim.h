@@ -0,0 +1,120 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * @file nrfx_spim.h
+ * @brief The SPIM driver calls of the CC3135 port, served on the host by the
+ *        SPI stand-in of spi_sim.c
+ */
+
+#ifndef HOST_NRFX_SPIM_H_
+#define HOST_NRFX_SPIM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+   NRFX_SUCCESS = 0,
+   NRFX_ERROR_INVALID_STATE,
+   NRFX_ERROR_INVALID_LENGTH,
+   NRFX_ERROR_NULL,
+   NRFX_ERROR_INVALID_ADDR,
+   NRFX_ERROR_BUSY
+} nrfx_err_t;
+
+// the stand-in clocks the bus at the configured rate, so the values are Hz
+typedef enum
+{
+   NRF_SPIM_FREQ_125K = 125000,
+   NRF_SPIM_FREQ_250K = 250000,
+   NRF_SPIM_FREQ_500K = 500000,
+   NRF_SPIM_FREQ_1M   = 1000000,
+   NRF_SPIM_FREQ_2M   = 2000000,
+   NRF_SPIM_FREQ_4M   = 4000000,
+   NRF_SPIM_FREQ_8M   = 8000000
+} nrf_spim_frequency_t;
+
+typedef struct
+{
+   uint8_t drv_inst_idx;
+} nrfx_spim_t;
+
+#define NRFX_SPIM_INSTANCE(id)                 { .drv_inst_idx = (id) }
+
+#define NRFX_SPIM_PIN_NOT_USED                 0xFF
+#define NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY  6
+
+typedef struct
+{
+   uint8_t sck_pin;
+   uint8_t mosi_pin;
+   uint8_t miso_pin;
+   uint8_t ss_pin;
+   uint8_t irq_priority;
+   nrf_spim_frequency_t frequency;
+} nrfx_spim_config_t;
+
+#define NRFX_SPIM_DEFAULT_CONFIG                             \
+{                                                            \
+   .sck_pin      = NRFX_SPIM_PIN_NOT_USED,                   \
+   .mosi_pin     = NRFX_SPIM_PIN_NOT_USED,                   \
+   .miso_pin     = NRFX_SPIM_PIN_NOT_USED,                   \
+   .ss_pin       = NRFX_SPIM_PIN_NOT_USED,                   \
+   .irq_priority = NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY,    \
+   .frequency    = NRF_SPIM_FREQ_4M,                         \
+}
+
+#define NRFX_SPIM_FLAG_TX_POSTINC              (1UL << 0)
+#define NRFX_SPIM_FLAG_RX_POSTINC              (1UL << 1)
+
+typedef struct
+{
+   uint8_t const * p_tx_buffer;
+   size_t          tx_length;
+   uint8_t       * p_rx_buffer;
+   size_t          rx_length;
+} nrfx_spim_xfer_desc_t;
+
+#define NRFX_SPIM_XFER_TRX(p_tx, tx_len, p_rx, rx_len)       \
+{                                                            \
+   .p_tx_buffer = (uint8_t const *)(p_tx),                   \
+   .tx_length = (tx_len),                                    \
+   .p_rx_buffer = (p_rx),                                    \
+   .rx_length = (rx_len),                                    \
+}
+
+typedef enum
+{
+   NRFX_SPIM_EVENT_DONE
+} nrfx_spim_evt_type_t;
+
+typedef struct
+{
+   nrfx_spim_evt_type_t  type;
+   nrfx_spim_xfer_desc_t xfer_desc;
+} nrfx_spim_evt_t;
+
+typedef void (*nrfx_spim_evt_handler_t)(nrfx_spim_evt_t const *p_event, void *p_context);
+
+nrfx_err_t nrfx_spim_init(nrfx_spim_t const * const p_instance,
+                          nrfx_spim_config_t const *p_config,
+                          nrfx_spim_evt_handler_t handler,
+                          void *p_context);
+
+void nrfx_spim_uninit(nrfx_spim_t const * const p_instance);
+
+nrfx_err_t nrfx_spim_xfer(nrfx_spim_t const * const p_instance,
+                          nrfx_spim_xfer_desc_t const *p_xfer_desc,
+                          uint32_t flags);
+
+// the address of the START task, wide enough for a host pointer
+uintptr_t nrfx_spim_start_task_get(nrfx_spim_t const *p_instance);
+
+void nrfx_spim_abort(nrfx_spim_t const *p_instance);
+
+// false for the regions the program declared as flash with SpiSim_SetFlash()
+bool nrfx_is_in_ram(void const *p_object);
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Benchmark of the SimpleLink driver pool objects.
+ *
+ * Times taking and releasing pool objects, the work every API that waits for
+ * an async event does under ProtectionLockObj. Built once per
+ * MAX_CONCURRENT_ACTIONS value, so the cost can be compared across pool sizes.
+ */
+
+#include <pthread.h>
+
+#include "sl_host.h"
+
+#include <ti/drivers/net/wifi/source/driver.h>
+
+#define BENCH_ITERATIONS               (200000)
+#define BENCH_MAX_THREADS              (8)
+
+typedef struct
+{
+   uint8_t sd;
+   uint32_t failed;
+} bench_Thread_t;
+
+static void *bench_TakeRelease(void *pArg)
+{
+   bench_Thread_t *pThread = (bench_Thread_t *)pArg;
+   _SlReturnVal_t objIdx;
+   int i;
+
+   for(i = 0; i < BENCH_ITERATIONS; i++)
+   {
+      objIdx = _SlDrvWaitForPoolObj(RECV_ID, pThread->sd);
+      if((objIdx < 0) || (objIdx >= MAX_CONCURRENT_ACTIONS))
+      {
+         pThread->failed++;
+         continue;
+      }
+      _SlDrvReleasePoolObj((uint8_t)objIdx);
+   }
+   return (NULL);
+}
+
+// take and release on a socket each, from several threads at once
+static int bench_Threads(int threads)
+{
+   bench_Thread_t ctx[BENCH_MAX_THREADS];
+   pthread_t thread[BENCH_MAX_THREADS];
+   uint64_t start;
+   uint64_t elapsed;
+   int i;
+
+   start = Host_Nsec();
+   for(i = 0; i < threads; i++)
+   {
+      ctx[i].sd = (uint8_t)i;
+      ctx[i].failed = 0;
+      CHECK(pthread_create(&thread[i], NULL, bench_TakeRelease, &ctx[i]) == 0);
+   }
+   for(i = 0; i < threads; i++)
+   {
+      pthread_join(thread[i], NULL);
+      CHECK(ctx[i].failed == 0);
+   }
+   elapsed = Host_Nsec() - start;
+
+   printf("  %d thread(s): %6.1f ns per take+release, %5.2f M pairs/s\n", threads,
+          (double)elapsed / ((double)BENCH_ITERATIONS * threads),
+          (double)BENCH_ITERATIONS * threads * 1000.0 / (double)elapsed);
+   return (0);
+}
+
+// release and take back the oldest select while all the others stay active,
+// the case that used to scan the whole pool
+static int bench_Select(void)
+{
+   _SlReturnVal_t objIdx[MAX_CONCURRENT_ACTIONS];
+   int active = MAX_CONCURRENT_ACTIONS - 1;
+   uint64_t start;
+   uint64_t elapsed;
+   int oldest = 0;
+   int i;
+
+   for(i = 0; i < active; i++)
+   {
+      objIdx[i] = _SlDrvWaitForPoolObj(SELECT_ID, SL_MAX_SOCKETS);
+      CHECK((objIdx[i] >= 0) && (objIdx[i] < MAX_CONCURRENT_ACTIONS));
+   }
+
+   start = Host_Nsec();
+   for(i = 0; i < BENCH_ITERATIONS; i++)
+   {
+      _SlDrvReleasePoolObj((uint8_t)objIdx[oldest]);
+      objIdx[oldest] = _SlDrvWaitForPoolObj(SELECT_ID, SL_MAX_SOCKETS);
+      CHECK((objIdx[oldest] >= 0) && (objIdx[oldest] < MAX_CONCURRENT_ACTIONS));
+      oldest = (oldest + 1) % active;
+   }
+   elapsed = Host_Nsec() - start;
+
+   for(i = 0; i < active; i++)
+   {
+      _SlDrvReleasePoolObj((uint8_t)objIdx[i]);
+   }
+
+   printf("  %d selects active: %6.1f ns per release+take\n", active,
+          (double)elapsed / BENCH_ITERATIONS);
+   return (0);
+}
+
+int main(void)
+{
+   int threads;
+
+   if(SlHost_Start() < 0)
+   {
+      printf("FAIL sl_Start\n");
+      return (1);
+   }
+
+   printf("pool objects, MAX_CONCURRENT_ACTIONS %d\n", MAX_CONCURRENT_ACTIONS);
+   // every thread holds a pool object while it works
+   for(threads = 1; (threads <= BENCH_MAX_THREADS) && (threads <= MAX_CONCURRENT_ACTIONS); threads *= 2)
+   {
+      if(bench_Threads(threads) != 0)
+      {
+         return (1);
+      }
+   }
+   if(bench_Select() != 0)
+   {
+      return (1);
+   }
+
+   SlHost_Stop();
+   return (0);
+}
@@ -0,0 +1,215 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host micro-benchmark of the MQTT server topic routing.
+ *
+ * Three server applications enroll one exact filter per building and floor,
+ * plus a '+' and a '#' filter, then publish to every building and floor.
+ * Times the routing of topics that miss the route cache and of one hot topic
+ * that hits it, checks every filter got its messages, and reports the child
+ * index probes made per routed topic.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ti/net/mqtt/server/server_core.h>
+
+#include "host_util.h"
+
+#define BENCH_BUILDINGS                (8)
+#define BENCH_FLOORS                   (16)
+#define BENCH_TOPICS                   (BENCH_BUILDINGS * BENCH_FLOORS)
+#define BENCH_ROUNDS                   (2000)
+
+#define BENCH_PLUS_FLOOR               (3)
+#define BENCH_HASH_BUILDING            (2)
+#define BENCH_PLUS_FILTER              "bld/+/flr/3/#"
+#define BENCH_HASH_FILTER              "bld/2/#"
+
+enum
+{
+   BENCH_APP_EXACT,
+   BENCH_APP_PLUS,
+   BENCH_APP_HASH,
+   BENCH_APPS
+};
+
+static pthread_mutex_t bench_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t *bench_pMutex = &bench_Mutex;
+static uint32_t bench_Delivered[BENCH_APPS];
+static char bench_Topics[BENCH_TOPICS][32];
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static void bench_MutexLock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_lock(pMutex);
+}
+
+static void bench_MutexUnlock(pthread_mutex_t *pMutex)
+{
+   pthread_mutex_unlock(pMutex);
+}
+
+static void bench_PublishExact(const MQTT_UTF8String_t *topic, const uint8_t *payload,
+                               uint32_t payLen, bool dup, uint8_t qos, bool retain)
+{
+   bench_Delivered[BENCH_APP_EXACT]++;
+}
+
+static void bench_PublishPlus(const MQTT_UTF8String_t *topic, const uint8_t *payload,
+                              uint32_t payLen, bool dup, uint8_t qos, bool retain)
+{
+   bench_Delivered[BENCH_APP_PLUS]++;
+}
+
+static void bench_PublishHash(const MQTT_UTF8String_t *topic, const uint8_t *payload,
+                              uint32_t payLen, bool dup, uint8_t qos, bool retain)
+{
+   bench_Delivered[BENCH_APP_HASH]++;
+}
+
+static int bench_Enroll(void *app, const char *filter)
+{
+   MQTT_UTF8String_t topic;
+
+   topic.buffer = (char *)filter;
+   topic.length = strlen(filter);
+   return (MQTTServerCore_topicEnroll(app, &topic, MQTT_QOS_0));
+}
+
+static int bench_Publish(const char *name)
+{
+   static const uint8_t payload[] = "21.5";
+   MQTT_UTF8String_t topic;
+
+   topic.buffer = (char *)name;
+   topic.length = strlen(name);
+   return (MQTTServerCore_pubSend(&topic, payload, sizeof(payload) - 1, MQTT_QOS_0, false));
+}
+
+static int bench_Setup(void)
+{
+   static const MQTTServerCore_AppCBs_t cbs[BENCH_APPS] =
+   {
+      { NULL, bench_PublishExact, NULL },
+      { NULL, bench_PublishPlus, NULL },
+      { NULL, bench_PublishHash, NULL }
+   };
+   MQTTServerPkts_LibCfg_t libCfg;
+   MQTTServerCore_AppCfg_t appCfg = { NULL };
+   void *apps[BENCH_APPS];
+   int b;
+   int f;
+   int i;
+
+   memset(&libCfg, 0, sizeof(libCfg));
+   libCfg.listenerPort = 1883;
+   libCfg.mutex = &bench_pMutex;
+   libCfg.mutexLockin = bench_MutexLock;
+   libCfg.mutexUnlock = bench_MutexUnlock;
+   CHECK(MQTTServerCore_init(&libCfg, &appCfg) == 0);
+
+   for(i = 0; i < BENCH_APPS; i++)
+   {
+      apps[i] = MQTTServerCore_appRegister(&cbs[i], "bench");
+      CHECK(apps[i] != NULL);
+   }
+
+   for(b = 0; b < BENCH_BUILDINGS; b++)
+   {
+      for(f = 0; f < BENCH_FLOORS; f++)
+      {
+         i = (b * BENCH_FLOORS) + f;
+         snprintf(bench_Topics[i], sizeof(bench_Topics[i]), "bld/%d/flr/%d/temp", b, f);
+         CHECK(bench_Enroll(apps[BENCH_APP_EXACT], bench_Topics[i]) >= 0);
+      }
+   }
+   CHECK(bench_Enroll(apps[BENCH_APP_PLUS], BENCH_PLUS_FILTER) >= 0);
+   CHECK(bench_Enroll(apps[BENCH_APP_HASH], BENCH_HASH_FILTER) >= 0);
+
+   return (0);
+}
+
+static int bench_Routing(void)
+{
+   MQTTServerCore_RouteStats_t before;
+   MQTTServerCore_RouteStats_t after;
+   uint32_t routed;
+   uint32_t searched;
+   uint64_t start;
+   uint64_t coldNs;
+   uint64_t hotNs;
+   int round;
+   int i;
+
+   // every topic in turn, more of them than the cache holds
+   memset(bench_Delivered, 0, sizeof(bench_Delivered));
+   MQTTServerCore_routeStatsGet(&before);
+   start = Host_Nsec();
+   for(round = 0; round < BENCH_ROUNDS; round++)
+   {
+      for(i = 0; i < BENCH_TOPICS; i++)
+      {
+         CHECK(bench_Publish(bench_Topics[i]) >= 0);
+      }
+   }
+   coldNs = Host_Nsec() - start;
+   MQTTServerCore_routeStatsGet(&after);
+
+   routed = BENCH_ROUNDS * BENCH_TOPICS;
+   CHECK(bench_Delivered[BENCH_APP_EXACT] == routed);
+   CHECK(bench_Delivered[BENCH_APP_PLUS] == BENCH_ROUNDS * BENCH_BUILDINGS);
+   CHECK(bench_Delivered[BENCH_APP_HASH] == BENCH_ROUNDS * BENCH_FLOORS);
+   CHECK(after.pubs - before.pubs == routed);
+   CHECK(after.stackFull == before.stackFull);
+
+   searched = routed - (after.cacheHits - before.cacheHits);
+   printf("%d filters, %d topics: %6.0f ns per topic, %u of %u from cache, "
+          "%.1f probes and %.1f node visits per searched topic\n",
+          BENCH_TOPICS + 2, BENCH_TOPICS, (double)coldNs / routed,
+          after.cacheHits - before.cacheHits, routed,
+          searched ? (double)(after.hashProbes - before.hashProbes) / searched : 0.0,
+          searched ? (double)(after.nodeVisits - before.nodeVisits) / searched : 0.0);
+
+   // one hot topic, matching all three applications
+   i = (BENCH_HASH_BUILDING * BENCH_FLOORS) + BENCH_PLUS_FLOOR;
+   memset(bench_Delivered, 0, sizeof(bench_Delivered));
+   MQTTServerCore_routeStatsGet(&before);
+   start = Host_Nsec();
+   for(round = 0; round < BENCH_ROUNDS * BENCH_TOPICS; round++)
+   {
+      CHECK(bench_Publish(bench_Topics[i]) >= 0);
+   }
+   hotNs = Host_Nsec() - start;
+   MQTTServerCore_routeStatsGet(&after);
+
+   CHECK(bench_Delivered[BENCH_APP_EXACT] == routed);
+   CHECK(bench_Delivered[BENCH_APP_PLUS] == routed);
+   CHECK(bench_Delivered[BENCH_APP_HASH] == routed);
+
+   printf("%d filters, 1 hot topic: %6.0f ns per topic, %u of %u from cache\n",
+          BENCH_TOPICS + 2, (double)hotNs / routed,
+          after.cacheHits - before.cacheHits, routed);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if((bench_Setup() != 0) || (bench_Routing() != 0))
+   {
+      return (1);
+   }
+
+   MQTTServerCore_topicNodeExit();
+
+   return (0);
+}
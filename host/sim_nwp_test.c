@@ -0,0 +1,422 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the SimpleLink driver running against the simulated NWP.
+ *
+ * Starts the driver, then moves data both ways over a TCP connection between
+ * an sl_ socket and a POSIX loopback listener. A burst of async events is
+ * then raised by the simulator, all of which must reach the host through the
+ * spawn drain without one being handled out of the staging list. Last, the
+ * simulated link and response latencies are set, and commands and events
+ * must take at least that long to complete.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+#include <ti/drivers/net/wifi/source/driver.h>
+
+#include "sl_host.h"
+
+#define TEST_PAYLOAD_LEN               (1000)
+#define TEST_ROUNDS                    (50)
+
+// sent against a reader slower than the link, so the simulator has to wait
+#define TEST_BACKPRESSURE_LEN          (256 * 1024)
+#define TEST_BACKPRESSURE_RCVBUF       (4096)
+
+// async events raised at once, more than the driver can stage in one wake
+#define TEST_BURST_EVENTS              (24)
+#define TEST_BURST_WAIT_MS             (2000)
+
+// commands timed against each simulated latency
+#define TEST_LATENCY_ROUNDS            (20)
+#define TEST_IF_LATENCY_USEC           (500)
+#define TEST_RESP_LATENCY_USEC         (2000)
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int posix_Listen(uint16_t *pPort)
+{
+   struct sockaddr_in addr;
+   socklen_t len = sizeof(addr);
+   int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   if((fd < 0) ||
+      (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+      (listen(fd, 1) != 0) ||
+      (getsockname(fd, (struct sockaddr *)&addr, &len) != 0))
+   {
+      return (-1);
+   }
+   *pPort = ntohs(addr.sin_port);
+   return (fd);
+}
+
+static int posix_RecvAll(int fd, uint8_t *pBuff, int len)
+{
+   int got = 0;
+   ssize_t n;
+
+   while(got < len)
+   {
+      n = recv(fd, pBuff + got, len - got, 0);
+      if(n <= 0)
+      {
+         return (-1);
+      }
+      got += (int)n;
+   }
+   return (got);
+}
+
+static int sl_RecvAll(int16_t sd, uint8_t *pBuff, int len)
+{
+   int got = 0;
+   int n;
+
+   while(got < len)
+   {
+      n = sl_Recv(sd, pBuff + got, len - got, 0);
+      if(n <= 0)
+      {
+         return (-1);
+      }
+      got += n;
+   }
+   return (got);
+}
+
+static int test_TcpEcho(void)
+{
+   static uint8_t tx[TEST_PAYLOAD_LEN];
+   static uint8_t rx[TEST_PAYLOAD_LEN];
+   SlSockAddrIn_t addr;
+   uint16_t port = 0;
+   int listenFd;
+   int peerFd;
+   int16_t sd;
+   int round;
+   int i;
+
+   listenFd = posix_Listen(&port);
+   CHECK(listenFd >= 0);
+
+   sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
+   CHECK(sd >= 0);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = SL_AF_INET;
+   addr.sin_port = sl_Htons(port);
+   addr.sin_addr.s_addr = sl_Htonl(SL_IPV4_VAL(127, 0, 0, 1));
+   CHECK(sl_Connect(sd, (SlSockAddr_t *)&addr, sizeof(addr)) == 0);
+
+   peerFd = accept(listenFd, NULL, NULL);
+   CHECK(peerFd >= 0);
+
+   for(round = 0; round < TEST_ROUNDS; round++)
+   {
+      for(i = 0; i < TEST_PAYLOAD_LEN; i++)
+      {
+         tx[i] = (uint8_t)(i + round);
+      }
+
+      CHECK(sl_Send(sd, tx, TEST_PAYLOAD_LEN, 0) == TEST_PAYLOAD_LEN);
+      CHECK(posix_RecvAll(peerFd, rx, TEST_PAYLOAD_LEN) == TEST_PAYLOAD_LEN);
+      CHECK(memcmp(tx, rx, TEST_PAYLOAD_LEN) == 0);
+
+      CHECK(send(peerFd, tx, TEST_PAYLOAD_LEN, 0) == TEST_PAYLOAD_LEN);
+      CHECK(sl_RecvAll(sd, rx, TEST_PAYLOAD_LEN) == TEST_PAYLOAD_LEN);
+      CHECK(memcmp(tx, rx, TEST_PAYLOAD_LEN) == 0);
+   }
+
+   CHECK(sl_Close(sd) == 0);
+   close(peerFd);
+   close(listenFd);
+   return (0);
+}
+
+typedef struct
+{
+   int fd;
+   int got;
+   int bad;
+} test_Reader_t;
+
+static void *test_SlowReader(void *pArg)
+{
+   test_Reader_t *pReader = (test_Reader_t *)pArg;
+   uint8_t buff[512];
+   ssize_t n;
+   int i;
+
+   while(pReader->got < TEST_BACKPRESSURE_LEN)
+   {
+      n = recv(pReader->fd, buff, sizeof(buff), 0);
+      if(n <= 0)
+      {
+         break;
+      }
+      for(i = 0; i < n; i++)
+      {
+         if(buff[i] != (uint8_t)((pReader->got + i) % 251))
+         {
+            pReader->bad++;
+         }
+      }
+      pReader->got += (int)n;
+      usleep(200);
+   }
+   return (NULL);
+}
+
+static int test_SendBackpressure(void)
+{
+   static uint8_t tx[TEST_PAYLOAD_LEN];
+   test_Reader_t reader = { -1, 0, 0 };
+   SlSockAddrIn_t addr;
+   pthread_t thread;
+   uint16_t port = 0;
+   int rcvBuf = TEST_BACKPRESSURE_RCVBUF;
+   int listenFd;
+   int16_t sd;
+   int sent = 0;
+   int len;
+   int i;
+
+   listenFd = posix_Listen(&port);
+   CHECK(listenFd >= 0);
+   CHECK(setsockopt(listenFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf)) == 0);
+
+   sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
+   CHECK(sd >= 0);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = SL_AF_INET;
+   addr.sin_port = sl_Htons(port);
+   addr.sin_addr.s_addr = sl_Htonl(SL_IPV4_VAL(127, 0, 0, 1));
+   CHECK(sl_Connect(sd, (SlSockAddr_t *)&addr, sizeof(addr)) == 0);
+
+   reader.fd = accept(listenFd, NULL, NULL);
+   CHECK(reader.fd >= 0);
+   CHECK(pthread_create(&thread, NULL, test_SlowReader, &reader) == 0);
+
+   while(sent < TEST_BACKPRESSURE_LEN)
+   {
+      len = TEST_BACKPRESSURE_LEN - sent;
+      if(len > TEST_PAYLOAD_LEN)
+      {
+         len = TEST_PAYLOAD_LEN;
+      }
+      for(i = 0; i < len; i++)
+      {
+         tx[i] = (uint8_t)((sent + i) % 251);
+      }
+      CHECK(sl_Send(sd, tx, len, 0) == len);
+      sent += len;
+   }
+
+   pthread_join(thread, NULL);
+   CHECK(reader.got == TEST_BACKPRESSURE_LEN);
+   CHECK(reader.bad == 0);
+
+   CHECK(sl_Close(sd) == 0);
+   close(reader.fd);
+   close(listenFd);
+   return (0);
+}
+
+static int test_EventBurst(void)
+{
+   SimNwp_Config_t config = { 0, 0, TEST_BURST_WAIT_MS * 100, 4 };
+   SimNwp_Stats_t simBefore;
+   SimNwp_Stats_t simAfter;
+   _SlSpawnDrainStats_t before = g_SlSpawnDrainStats;
+   _SlSpawnDrainStats_t after;
+   SlIpV4AcquiredAsync_t ip;
+   uint32_t events = SlHost_NetAppEvents();
+   int waited = 0;
+   int i;
+
+   SimNwpGetStats(&simBefore);
+
+   // the events are all queued before the first is raised
+   SimNwpConfigure(&config);
+   memset(&ip, 0, sizeof(ip));
+   for(i = 0; i < TEST_BURST_EVENTS; i++)
+   {
+      ip.Ip = SL_IPV4_VAL(10, 0, 0, i + 1);
+      CHECK(SimNwpInjectEvent(SL_OPCODE_NETAPP_IPACQUIRED, &ip, sizeof(ip)) == 0);
+   }
+   config.respLatencyUsec = 0;
+   SimNwpConfigure(&config);
+
+   while((SlHost_NetAppEvents() - events < TEST_BURST_EVENTS) && (waited < TEST_BURST_WAIT_MS))
+   {
+      usleep(1000);
+      waited++;
+   }
+   after = g_SlSpawnDrainStats;
+   SimNwpGetStats(&simAfter);
+
+   printf("burst of %d events: %u wakes, %u messages, at most %u per wake, %u full stops\n",
+          TEST_BURST_EVENTS, after.Wakes - before.Wakes, after.Msgs - before.Msgs,
+          after.MaxMsgsPerWake, after.Overflows - before.Overflows);
+   CHECK(SlHost_NetAppEvents() - events == TEST_BURST_EVENTS);
+   CHECK(simAfter.events - simBefore.events == TEST_BURST_EVENTS);
+   CHECK(simAfter.dropped == simBefore.dropped);
+   CHECK(after.Msgs - before.Msgs >= TEST_BURST_EVENTS);
+   CHECK(after.StagedEvents - before.StagedEvents == TEST_BURST_EVENTS);
+   CHECK(after.MaxMsgsPerWake <= SL_SPAWN_DRAIN_MAX_MSGS);
+
+   return (0);
+}
+
+// microseconds one sl_Socket() and sl_Close() pair takes, two commands
+static int test_CommandUsec(SimNwp_Config_t const *pConfig, uint64_t *pUsec)
+{
+   uint64_t start;
+   int16_t sd;
+   int i;
+
+   SimNwpConfigure(pConfig);
+   start = Host_Nsec();
+   for(i = 0; i < TEST_LATENCY_ROUNDS; i++)
+   {
+      sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
+      CHECK(sd >= 0);
+      CHECK(sl_Close(sd) == 0);
+   }
+   *pUsec = (Host_Nsec() - start) / 1000 / TEST_LATENCY_ROUNDS;
+
+   return (0);
+}
+
+static int test_Latency(void)
+{
+   SimNwp_Config_t none = { 0, 0, 0, 4 };
+   SimNwp_Config_t link = { TEST_IF_LATENCY_USEC, 0, 0, 4 };
+   SimNwp_Config_t resp = { 0, 0, TEST_RESP_LATENCY_USEC, 4 };
+   uint64_t noneUsec;
+   uint64_t linkUsec;
+   uint64_t respUsec;
+   uint64_t start;
+   uint32_t events;
+   SlIpV4AcquiredAsync_t ip;
+   int rc;
+
+   rc = test_CommandUsec(&none, &noneUsec);
+   if(rc == 0)
+   {
+      rc = test_CommandUsec(&link, &linkUsec);
+   }
+   if(rc == 0)
+   {
+      rc = test_CommandUsec(&resp, &respUsec);
+   }
+   SimNwpConfigure(&none);
+   CHECK(rc == 0);
+
+   printf("socket and close: %llu us, %llu us with %d us link latency, "
+          "%llu us with %d us response latency\n",
+          (unsigned long long)noneUsec, (unsigned long long)linkUsec, TEST_IF_LATENCY_USEC,
+          (unsigned long long)respUsec, TEST_RESP_LATENCY_USEC);
+
+   // each command is written to the link and has its response read back
+   CHECK(linkUsec >= 4 * TEST_IF_LATENCY_USEC);
+   CHECK(respUsec >= 2 * TEST_RESP_LATENCY_USEC);
+
+   // an event is raised no earlier than a response would be
+   SimNwpConfigure(&resp);
+   memset(&ip, 0, sizeof(ip));
+   events = SlHost_NetAppEvents();
+   start = Host_Nsec();
+   rc = SimNwpInjectEvent(SL_OPCODE_NETAPP_IPACQUIRED, &ip, sizeof(ip));
+   while((rc == 0) && (SlHost_NetAppEvents() == events) && (Host_Nsec() - start < 1000000000u))
+   {
+      usleep(100);
+   }
+   SimNwpConfigure(&none);
+   CHECK(rc == 0);
+   CHECK(SlHost_NetAppEvents() == events + 1);
+   CHECK(Host_Nsec() - start >= TEST_RESP_LATENCY_USEC * 1000u);
+
+   // not an event, refused
+   CHECK(SimNwpInjectEvent(SL_OPCODE_NETAPP_IPACQUIRED | SL_OPCODE_SYNC, &ip, sizeof(ip)) == -1);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   SimNwp_Stats_t stats;
+   int16_t role;
+   int failed = 0;
+
+   role = SlHost_Start();
+   if(role < 0)
+   {
+      printf("FAIL sl_Start %d\n", role);
+      return (1);
+   }
+   printf("sl_Start role %d\n", role);
+
+   if(test_TcpEcho() != 0)
+   {
+      failed++;
+   }
+   else
+   {
+      printf("PASS tcp echo, %d rounds of %d bytes\n", TEST_ROUNDS, TEST_PAYLOAD_LEN);
+   }
+
+   if(test_SendBackpressure() != 0)
+   {
+      failed++;
+   }
+   else
+   {
+      printf("PASS send backpressure, %d bytes to a slow reader\n", TEST_BACKPRESSURE_LEN);
+   }
+
+   if(test_EventBurst() != 0)
+   {
+      failed++;
+   }
+   else
+   {
+      printf("PASS event burst, %d events staged and dispatched\n", TEST_BURST_EVENTS);
+   }
+
+   if(test_Latency() != 0)
+   {
+      failed++;
+   }
+   else
+   {
+      printf("PASS link and response latency, on commands and events\n");
+   }
+
+   SimNwpGetStats(&stats);
+   printf("sim nwp: %u cmds, %u msgs, %u irqs, %u credit msgs, %u dropped, "
+          "%u bytes written, %u bytes read\n",
+          stats.cmds, stats.msgs, stats.irqs, stats.creditMsgs, stats.dropped,
+          stats.bytesWritten, stats.bytesRead);
+
+   SlHost_Stop();
+
+   return (failed != 0);
+}
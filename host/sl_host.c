@@ -0,0 +1,85 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Common start-up of the host programs that run on the simulated NWP.
+ */
+
+#include <pthread.h>
+
+#include "sl_host.h"
+
+// written by the spawn thread only
+static volatile uint32_t host_NetAppEvents;
+
+/****************************************************************************
+   DRIVER CALLBACKS
+****************************************************************************/
+void SimpleLinkFatalErrorEventHandler(SlDeviceFatal_t *slFatalErrorEvent)
+{
+   printf("fatal error %lu\n", (unsigned long)slFatalErrorEvent->Id);
+}
+
+void SimpleLinkGeneralEventHandler(SlDeviceEvent_t *pDevEvent)
+{
+}
+
+void SimpleLinkWlanEventHandler(SlWlanEvent_t *pWlanEvent)
+{
+}
+
+void SimpleLinkNetAppEventHandler(SlNetAppEvent_t *pNetAppEvent)
+{
+   host_NetAppEvents++;
+}
+
+void SimpleLinkHttpServerEventHandler(SlNetAppHttpServerEvent_t *pHttpEvent,
+                                      SlNetAppHttpServerResponse_t *pHttpResponse)
+{
+}
+
+void SimpleLinkNetAppRequestEventHandler(SlNetAppRequest_t *pNetAppRequest,
+                                         SlNetAppResponse_t *pNetAppResponse)
+{
+}
+
+void SimpleLinkNetAppRequestMemFreeEventHandler(uint8_t *buffer)
+{
+}
+
+void SimpleLinkSockEventHandler(SlSockEvent_t *pSock)
+{
+}
+
+/****************************************************************************
+   INTERFACE FUNCTIONS
+****************************************************************************/
+int16_t SlHost_Start(void)
+{
+   SimNwp_Config_t config = { 0, 0, 0, 4 };
+   pthread_t spawnThread;
+
+   setvbuf(stdout, NULL, _IONBF, 0);
+
+   // no interface or response latency, the programs measure the driver only
+   SimNwpConfigure(&config);
+
+   if(pthread_create(&spawnThread, NULL, sl_Task, NULL) != 0)
+   {
+      return (-1);
+   }
+   // the spawn thread must own its sync object before the NWP is started
+   SimNwpWaitSpawnTask();
+
+   return (sl_Start(NULL, NULL, NULL));
+}
+
+void SlHost_Stop(void)
+{
+   sl_Stop(200);
+}
+
+uint32_t SlHost_NetAppEvents(void)
+{
+   return (host_NetAppEvents);
+}
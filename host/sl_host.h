@@ -0,0 +1,35 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Common start-up of the host programs that run the SimpleLink driver on the
+ * simulated NWP. Also provides the driver event callbacks, which do nothing
+ * but count the NetApp events.
+ */
+
+#ifndef __SL_HOST_H__
+#define __SL_HOST_H__
+
+#include <stdint.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+
+#include "host_util.h"
+
+/**
+ * @brief Starts the spawn thread and the driver, with no simulated latency.
+ * @return the role reported by sl_Start, negative on failure.
+ */
+int16_t SlHost_Start(void);
+
+/**
+ * @brief Stops the driver.
+ */
+void SlHost_Stop(void);
+
+/**
+ * @brief Returns the NetApp events the driver has dispatched to the host.
+ */
+uint32_t SlHost_NetAppEvents(void);
+
+#endif // __SL_HOST_H__
@@ -0,0 +1,413 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the SlNetIf interface health and failover, over two POSIX
+ * SlNetIf interfaces on the loopback.
+ *
+ * New sockets are spread over two healthy interfaces of the same priority.
+ * Refused connects degrade an interface: new sockets then go to the other
+ * one, but for a probe every SLNETIF_DEGRADED_PROBE_INTERVAL sockets, and a
+ * probe that connects restores it. A link drop fails the new sockets over
+ * the same way. Tasks then open, connect and close sockets on both
+ * interfaces at once, and the counts of the statistics must add up. Last,
+ * one interface is slowed down: new connections go to the faster one, and
+ * the send rates of the statistics tell the two apart.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/net/slneterr.h>
+#include <ti/net/slnetutils.h>
+
+#include "host_util.h"
+
+#define TEST_PORT                      (45871)
+#define TEST_REFUSED_PORT              (1)
+#define TEST_TASKS                     (4)
+#define TEST_TASK_ROUNDS               (500)
+#define TEST_DELAY_USEC                (20000)
+#define TEST_RATE_DELAY_USEC           (1000)
+#define TEST_RATE_CHUNK                (1000)
+#define TEST_RATE_WINDOWS              (3)
+
+typedef struct
+{
+   pthread_t thread;
+   uint16_t  ifID;
+   int       failures;
+} test_Task_t;
+
+static SlNetSock_AddrIn_t test_Addr;
+static SlNetSock_AddrIn_t test_RefusedAddr;
+static int16_t test_Listener = -1;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int16_t test_Open(uint32_t ifBitmap)
+{
+   return (SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_STREAM, SLNETSOCK_PROTO_TCP, ifBitmap, 0));
+}
+
+static int32_t test_Connect(int16_t sd, const SlNetSock_AddrIn_t *pAddr)
+{
+   return (SlNetSock_connect(sd, (const SlNetSock_Addr_t *)pAddr, sizeof(*pAddr)));
+}
+
+static SlNetIf_Stats_t test_Stats(uint16_t ifID)
+{
+   SlNetIf_Stats_t stats;
+
+   memset(&stats, 0, sizeof(stats));
+   SlNetIf_getStats(ifID, &stats);
+   return (stats);
+}
+
+// a connect to the listener, accepted and closed
+static int test_ConnectOk(int16_t sd)
+{
+   int16_t peer;
+
+   CHECK(test_Connect(sd, &test_Addr) == 0);
+   peer = SlNetSock_accept(test_Listener, NULL, NULL);
+   CHECK(peer >= 0);
+   SlNetSock_close(peer);
+
+   return (0);
+}
+
+static int test_Setup(void)
+{
+   int32_t reuse = 1;
+
+   CHECK(SlNetIf_init(0) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_2, "lo", &SlNetIfConfigPosix, 5) == 0);
+   CHECK(SlNetIf_add(SLNETIF_ID_2, "lo", &SlNetIfConfigPosix, 5) < 0);
+   CHECK(SlNetSock_init(0) == 0);
+   CHECK(SlNetUtil_init(0) == 0);
+
+   test_Addr.sin_family = SLNETSOCK_AF_INET;
+   test_Addr.sin_addr.s_addr = SlNetUtil_htonl(0x7F000001);
+   test_Addr.sin_port = SlNetUtil_htons(TEST_PORT);
+   test_RefusedAddr = test_Addr;
+   test_RefusedAddr.sin_port = SlNetUtil_htons(TEST_REFUSED_PORT);
+
+   // the accepted sockets are on interface 2, and counted there
+   test_Listener = test_Open(SLNETIF_ID_2);
+   CHECK(test_Listener >= 0);
+   // the port of the connections closed by the last run may still be held
+   CHECK(SlNetSock_setOpt(test_Listener, SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_REUSEADDR,
+                          &reuse, sizeof(reuse)) == 0);
+   CHECK(SlNetSock_bind(test_Listener, (SlNetSock_Addr_t *)&test_Addr, sizeof(test_Addr)) == 0);
+   CHECK(SlNetSock_listen(test_Listener, TEST_TASKS * 2) == 0);
+
+   return (0);
+}
+
+static int test_Balance(void)
+{
+   int16_t sds[6];
+   uint16_t if1Open;
+   uint16_t if2Open;
+   int i;
+
+   for(i = 0; i < 6; i++)
+   {
+      sds[i] = test_Open(0);
+      CHECK(sds[i] >= 0);
+   }
+   // the listener is open on interface 2 as well
+   if1Open = test_Stats(SLNETIF_ID_1).openSockets;
+   if2Open = test_Stats(SLNETIF_ID_2).openSockets;
+   CHECK(if1Open + if2Open == 6 + 1);
+   CHECK((if1Open == if2Open + 1) || (if2Open == if1Open + 1));
+
+   for(i = 0; i < 6; i++)
+   {
+      CHECK(SlNetSock_close(sds[i]) == 0);
+   }
+   CHECK(test_Stats(SLNETIF_ID_1).openSockets == 0);
+   CHECK(test_Stats(SLNETIF_ID_2).openSockets == 1);
+
+   return (0);
+}
+
+static int test_DegradeAndProbe(void)
+{
+   int16_t sd;
+   int i;
+
+   for(i = 0; i < SLNETIF_DEGRADED_ERRORS; i++)
+   {
+      sd = test_Open(SLNETIF_ID_1);
+      CHECK(sd >= 0);
+      CHECK(test_Connect(sd, &test_RefusedAddr) < 0);
+      SlNetSock_close(sd);
+   }
+   CHECK(test_Stats(SLNETIF_ID_1).consecutiveErrors == SLNETIF_DEGRADED_ERRORS);
+   CHECK(test_Stats(SLNETIF_ID_1).errors == SLNETIF_DEGRADED_ERRORS);
+
+   // the healthy interface, then the degraded one as a probe
+   for(i = 1; i < SLNETIF_DEGRADED_PROBE_INTERVAL; i++)
+   {
+      sd = test_Open(0);
+      CHECK(SlNetSock_getIfID(sd) == SLNETIF_ID_2);
+      SlNetSock_close(sd);
+   }
+   sd = test_Open(0);
+   CHECK(SlNetSock_getIfID(sd) == SLNETIF_ID_1);
+
+   // the probe connects, the interface is healthy again
+   CHECK(test_ConnectOk(sd) == 0);
+   SlNetSock_close(sd);
+   CHECK(test_Stats(SLNETIF_ID_1).consecutiveErrors == 0);
+
+   return (0);
+}
+
+static int test_LinkDrop(void)
+{
+   int16_t sd;
+   int i;
+
+   CHECK(SlNetIf_getConnectionStatus(SLNETIF_ID_1) == SLNETIF_STATUS_CONNECTED);
+   CHECK(SlNetIfPosix_setConnectionStatus(SLNETIF_ID_1, SLNETIF_STATUS_DISCONNECTED) == 0);
+
+   for(i = 0; i < SLNETIF_DEGRADED_PROBE_INTERVAL * 2; i++)
+   {
+      sd = test_Open(0);
+      CHECK(SlNetSock_getIfID(sd) == SLNETIF_ID_2);
+      SlNetSock_close(sd);
+   }
+   CHECK(test_Stats(SLNETIF_ID_1).disconnects == 1);
+   CHECK(test_Stats(SLNETIF_ID_1).consecutiveErrors >= SLNETIF_DEGRADED_ERRORS);
+
+   // back up, the first socket call that works on it clears it
+   CHECK(SlNetIfPosix_setConnectionStatus(SLNETIF_ID_1, SLNETIF_STATUS_CONNECTED) == 0);
+   sd = test_Open(SLNETIF_ID_1);
+   CHECK(SlNetSock_getIfID(sd) == SLNETIF_ID_1);
+   CHECK(test_ConnectOk(sd) == 0);
+   SlNetSock_close(sd);
+   CHECK(test_Stats(SLNETIF_ID_1).consecutiveErrors == 0);
+   CHECK(test_Stats(SLNETIF_ID_1).disconnects == 1);
+
+   return (0);
+}
+
+// socket calls of one task on one interface, every other connect refused
+static void *test_TaskThread(void *arg)
+{
+   test_Task_t *pTask = arg;
+   bool refused;
+   int16_t sd;
+   int16_t peer;
+   int i;
+
+   for(i = 0; i < TEST_TASK_ROUNDS; i++)
+   {
+      refused = (0 == (i & 1));
+      sd = test_Open(pTask->ifID);
+      if((sd < 0) || (SlNetSock_getIfID(sd) != pTask->ifID))
+      {
+         pTask->failures++;
+         continue;
+      }
+      if((test_Connect(sd, refused ? &test_RefusedAddr : &test_Addr) < 0) != refused)
+      {
+         pTask->failures++;
+      }
+      else if(!refused)
+      {
+         // the connection in the backlog, this one or that of another task
+         peer = SlNetSock_accept(test_Listener, NULL, NULL);
+         if(peer < 0)
+         {
+            pTask->failures++;
+         }
+         SlNetSock_close(peer);
+      }
+      SlNetSock_close(sd);
+   }
+   return (NULL);
+}
+
+static int test_Concurrent(void)
+{
+   test_Task_t tasks[TEST_TASKS];
+   SlNetIf_Stats_t before[2];
+   SlNetIf_Stats_t after[2];
+   int i;
+
+   before[0] = test_Stats(SLNETIF_ID_1);
+   before[1] = test_Stats(SLNETIF_ID_2);
+
+   for(i = 0; i < TEST_TASKS; i++)
+   {
+      tasks[i].ifID = (i & 1) ? SLNETIF_ID_2 : SLNETIF_ID_1;
+      tasks[i].failures = 0;
+      CHECK(pthread_create(&tasks[i].thread, NULL, test_TaskThread, &tasks[i]) == 0);
+   }
+   for(i = 0; i < TEST_TASKS; i++)
+   {
+      pthread_join(tasks[i].thread, NULL);
+      CHECK(tasks[i].failures == 0);
+   }
+
+   after[0] = test_Stats(SLNETIF_ID_1);
+   after[1] = test_Stats(SLNETIF_ID_2);
+
+   printf("if1 %u errors, if2 %u errors, open %u and %u\n",
+          after[0].errors - before[0].errors, after[1].errors - before[1].errors,
+          after[0].openSockets, after[1].openSockets);
+
+   // none of the updates of the tasks was lost
+   for(i = 0; i < 2; i++)
+   {
+      CHECK(after[i].errors - before[i].errors == (TEST_TASKS / 2) * (TEST_TASK_ROUNDS / 2));
+      CHECK(after[i].openSockets == before[i].openSockets);
+   }
+
+   return (0);
+}
+
+// connections one at a time go to the faster interface
+static int test_Faster(void)
+{
+   SlNetIf_Stats_t if1;
+   SlNetIf_Stats_t if2;
+   int16_t sd;
+   int i;
+
+   CHECK(SlNetIfPosix_setDelay(SLNETIF_ID_1, TEST_DELAY_USEC) == 0);
+   for(i = 0; i < 8; i++)
+   {
+      sd = test_Open(SLNETIF_ID_1);
+      CHECK(test_ConnectOk(sd) == 0);
+      SlNetSock_close(sd);
+      sd = test_Open(SLNETIF_ID_2);
+      CHECK(test_ConnectOk(sd) == 0);
+      SlNetSock_close(sd);
+   }
+   if1 = test_Stats(SLNETIF_ID_1);
+   if2 = test_Stats(SLNETIF_ID_2);
+   printf("connect time if1 %u ms, if2 %u ms\n", if1.connectTime, if2.connectTime);
+   CHECK(if1.connectTime > if2.connectTime);
+
+   // the listener keeps one socket open on interface 2, it still wins
+   CHECK(if1.openSockets < if2.openSockets);
+   for(i = 0; i < SLNETIF_DEGRADED_PROBE_INTERVAL * 2; i++)
+   {
+      sd = test_Open(0);
+      CHECK(SlNetSock_getIfID(sd) == SLNETIF_ID_2);
+      CHECK(test_ConnectOk(sd) == 0);
+      SlNetSock_close(sd);
+   }
+   CHECK(SlNetIfPosix_setDelay(SLNETIF_ID_1, 0) == 0);
+
+   return (0);
+}
+
+// 'sd' sends to 'peer' for a few rate windows
+static int test_Stream(int16_t sd, int16_t peer)
+{
+   static char chunk[TEST_RATE_CHUNK];
+   uint64_t end = Host_Nsec() + (uint64_t)TEST_RATE_WINDOWS * SLNETIF_RATE_WINDOW_MS * 1000000u;
+
+   while(Host_Nsec() < end)
+   {
+      CHECK(SlNetSock_send(sd, chunk, sizeof(chunk), 0) == sizeof(chunk));
+      CHECK(SlNetSock_recv(peer, chunk, sizeof(chunk), SLNETSOCK_MSG_WAITALL) == sizeof(chunk));
+   }
+   return (0);
+}
+
+static int test_Rates(void)
+{
+   SlNetIf_Stats_t if1;
+   SlNetIf_Stats_t if2;
+   int16_t slowSd;
+   int16_t fastSd;
+   int16_t slowPeer;
+   int16_t fastPeer;
+
+   slowSd = test_Open(SLNETIF_ID_1);
+   CHECK(test_Connect(slowSd, &test_Addr) == 0);
+   slowPeer = SlNetSock_accept(test_Listener, NULL, NULL);
+   CHECK(slowPeer >= 0);
+   fastSd = test_Open(SLNETIF_ID_2);
+   CHECK(test_Connect(fastSd, &test_Addr) == 0);
+   fastPeer = SlNetSock_accept(test_Listener, NULL, NULL);
+   CHECK(fastPeer >= 0);
+
+   CHECK(SlNetIfPosix_setDelay(SLNETIF_ID_1, TEST_RATE_DELAY_USEC) == 0);
+   CHECK(test_Stream(slowSd, slowPeer) == 0);
+   if1 = test_Stats(SLNETIF_ID_1);
+   CHECK(SlNetIfPosix_setDelay(SLNETIF_ID_1, 0) == 0);
+   CHECK(test_Stream(fastSd, fastPeer) == 0);
+   if2 = test_Stats(SLNETIF_ID_2);
+
+   printf("send rate if1 %u bytes/s, if2 %u bytes/s\n", if1.txRate, if2.txRate);
+   // one chunk per delay at most
+   CHECK(if1.txRate > 0);
+   CHECK(if1.txRate <= (uint64_t)TEST_RATE_CHUNK * 1000000u / TEST_RATE_DELAY_USEC);
+   CHECK(if2.txRate > if1.txRate);
+   // what interface 1 sent, interface 2 received
+   CHECK(if2.rxRate > 0);
+
+   SlNetSock_close(slowSd);
+   SlNetSock_close(slowPeer);
+   SlNetSock_close(fastSd);
+   SlNetSock_close(fastPeer);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   if((test_Setup() != 0) || (test_Balance() != 0))
+   {
+      return (1);
+   }
+   printf("PASS new sockets spread over two healthy interfaces\n");
+
+   if(test_DegradeAndProbe() != 0)
+   {
+      return (1);
+   }
+   printf("PASS degraded interface probed every %d sockets, and restored\n",
+          SLNETIF_DEGRADED_PROBE_INTERVAL);
+
+   if(test_LinkDrop() != 0)
+   {
+      return (1);
+   }
+   printf("PASS new sockets fail over on a link drop\n");
+
+   if(test_Concurrent() != 0)
+   {
+      return (1);
+   }
+   printf("PASS statistics of %d tasks on two interfaces add up\n", TEST_TASKS);
+
+   if(test_Faster() != 0)
+   {
+      return (1);
+   }
+   printf("PASS new connections go to the faster interface\n");
+
+   if(test_Rates() != 0)
+   {
+      return (1);
+   }
+   printf("PASS send rates of a slow and a fast interface\n");
+
+   return (0);
+}
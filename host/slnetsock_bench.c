@@ -0,0 +1,240 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host benchmark of the SlNetSock socket lookup, over the POSIX SlNetIf.
+ *
+ * Reader threads look up a set of open UDP sockets, as every SlNetSock call
+ * does, while a churn thread creates and closes sockets on the other sds.
+ * Times the lookups per reader count, with and without the churn. Each
+ * reader checks its sockets still have the generation taken when they were
+ * opened, and the churn thread checks that the generation it held for an
+ * sd is refused once the sd names a new socket.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+#include <ti/net/slneterr.h>
+#include <ti/net/slnetutils.h>
+
+#include "host_util.h"
+
+#define BENCH_STABLE_SOCKETS           (16)
+#define BENCH_MAX_READERS              (8)
+#define BENCH_LOOKUPS                  (4000000)
+
+typedef struct
+{
+   pthread_t thread;
+   int       lookups;
+   int       failures;
+} bench_Reader_t;
+
+static int16_t bench_Stable[BENCH_STABLE_SOCKETS];
+static uint16_t bench_StableGen[BENCH_STABLE_SOCKETS];
+
+static volatile int bench_Stop;
+static uint32_t bench_Reuses;         // stale generations refused
+static uint32_t bench_ChurnFailures;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int16_t bench_Open(void)
+{
+   return (SlNetSock_create(SLNETSOCK_AF_INET, SLNETSOCK_SOCK_DGRAM, SLNETSOCK_PROTO_UDP, 0, 0));
+}
+
+// two lookups per round, the interface of the socket and its generation
+static void *bench_ReaderThread(void *arg)
+{
+   bench_Reader_t *pReader = arg;
+   int i;
+   int s;
+
+   for(i = 0; i < pReader->lookups; i += 2)
+   {
+      s = i % BENCH_STABLE_SOCKETS;
+      if((SlNetSock_getIfID(bench_Stable[s]) != SLNETIF_ID_1) ||
+         (SlNetSock_checkGeneration(bench_Stable[s], bench_StableGen[s]) != 0))
+      {
+         pReader->failures++;
+      }
+   }
+   return (NULL);
+}
+
+static void *bench_ChurnThread(void *arg)
+{
+   static uint16_t lastGen[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+   static bool seen[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+   uint16_t gen;
+   int16_t sd;
+   int s;
+
+   while(!bench_Stop)
+   {
+      sd = bench_Open();
+      if(sd < 0)
+      {
+         bench_ChurnFailures++;
+         continue;
+      }
+      for(s = 0; s < BENCH_STABLE_SOCKETS; s++)
+      {
+         if(sd == bench_Stable[s])
+         {
+            bench_ChurnFailures++;
+         }
+      }
+
+      if(seen[sd])
+      {
+         // an sd kept from before the close must not reach this socket
+         if(SlNetSock_checkGeneration(sd, lastGen[sd]) == SLNETERR_BSD_EBADF)
+         {
+            bench_Reuses++;
+         }
+         else
+         {
+            bench_ChurnFailures++;
+         }
+      }
+      if(SlNetSock_getGeneration(sd, &gen) != 0)
+      {
+         bench_ChurnFailures++;
+      }
+      lastGen[sd] = gen;
+      seen[sd] = true;
+
+      SlNetSock_close(sd);
+      if(SlNetSock_checkGeneration(sd, gen) == 0)
+      {
+         bench_ChurnFailures++;
+      }
+   }
+   return (NULL);
+}
+
+static int bench_Lookups(int nReaders, bool churn)
+{
+   bench_Reader_t readers[BENCH_MAX_READERS];
+   pthread_t churnThread;
+   uint32_t reuses = bench_Reuses;
+   uint64_t start;
+   uint64_t ns;
+   int i;
+
+   bench_Stop = 0;
+   if(churn)
+   {
+      CHECK(pthread_create(&churnThread, NULL, bench_ChurnThread, NULL) == 0);
+   }
+
+   start = Host_Nsec();
+   for(i = 0; i < nReaders; i++)
+   {
+      readers[i].lookups = BENCH_LOOKUPS / nReaders;
+      readers[i].failures = 0;
+      CHECK(pthread_create(&readers[i].thread, NULL, bench_ReaderThread, &readers[i]) == 0);
+   }
+   for(i = 0; i < nReaders; i++)
+   {
+      pthread_join(readers[i].thread, NULL);
+   }
+   ns = Host_Nsec() - start;
+
+   if(churn)
+   {
+      bench_Stop = 1;
+      pthread_join(churnThread, NULL);
+   }
+
+   for(i = 0; i < nReaders; i++)
+   {
+      CHECK(readers[i].failures == 0);
+   }
+   CHECK(bench_ChurnFailures == 0);
+
+   printf("%d reader%s, %s: %6.1f ns per lookup",
+          nReaders, (nReaders > 1) ? "s" : " ", churn ? "churn   " : "no churn",
+          (double)ns / BENCH_LOOKUPS);
+   if(churn)
+   {
+      printf(", %u reused sds refused a stale generation", bench_Reuses - reuses);
+   }
+   printf("\n");
+
+   return (0);
+}
+
+// the generation held for an sd no longer matches once the sd is reused
+static int bench_Reuse(void)
+{
+   uint16_t oldGen;
+   uint16_t newGen;
+   int16_t sd;
+
+   sd = bench_Open();
+   CHECK(sd >= 0);
+   CHECK(SlNetSock_getGeneration(sd, &oldGen) == 0);
+   CHECK(SlNetSock_checkGeneration(sd, oldGen) == 0);
+   CHECK(SlNetSock_close(sd) == 0);
+   CHECK(SlNetSock_checkGeneration(sd, oldGen) == SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE);
+
+   // the last sd freed is the first given out again
+   CHECK(bench_Open() == sd);
+   CHECK(SlNetSock_checkGeneration(sd, oldGen) == SLNETERR_BSD_EBADF);
+   CHECK(SlNetSock_getGeneration(sd, &newGen) == 0);
+   CHECK(newGen != oldGen);
+   CHECK(SlNetSock_close(sd) == 0);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   static const int nReaders[] = { 1, 2, 4, 8 };
+   int i;
+
+   SlNetIf_init(0);
+   SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5);
+   SlNetSock_init(0);
+   SlNetUtil_init(0);
+
+   for(i = 0; i < BENCH_STABLE_SOCKETS; i++)
+   {
+      bench_Stable[i] = bench_Open();
+      if((bench_Stable[i] < 0) || (SlNetSock_getGeneration(bench_Stable[i], &bench_StableGen[i]) != 0))
+      {
+         printf("FAIL socket %d\n", i);
+         return (1);
+      }
+   }
+
+   if(bench_Reuse() != 0)
+   {
+      return (1);
+   }
+
+   for(i = 0; i < (int)(sizeof(nReaders) / sizeof(nReaders[0])); i++)
+   {
+      if((bench_Lookups(nReaders[i], false) != 0) || (bench_Lookups(nReaders[i], true) != 0))
+      {
+         return (1);
+      }
+   }
+
+   for(i = 0; i < BENCH_STABLE_SOCKETS; i++)
+   {
+      SlNetSock_close(bench_Stable[i]);
+   }
+
+   return (0);
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Benchmark of concurrent sl_Send() and sl_Recv() on the simulated NWP.
+ *
+ * Each thread owns a TCP connection between an sl_ socket and a POSIX
+ * loopback peer that echoes what it reads. The threads send a message and
+ * wait for its echo, all at once, so their sl_Recv() calls hold pool objects
+ * side by side and the sends and receives contend for the driver locks.
+ * Built once per MAX_CONCURRENT_ACTIONS value, so the round trip rate can be
+ * compared with threads past the pool size and within it. Past it, an
+ * sl_Recv() that finds the pool empty is called again, as the application
+ * has to, and the retries are counted.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sl_host.h"
+
+#include <ti/drivers/net/wifi/source/driver.h>
+
+#define BENCH_MSG_LEN                  (256)
+#define BENCH_ROUNDS                   (400)
+#define BENCH_MAX_THREADS              (SL_MAX_SOCKETS - 1)
+
+typedef struct
+{
+   int16_t sd;
+   int peerFd;
+   uint32_t failed;
+   uint32_t poolEmpty;
+   pthread_barrier_t *pStart;
+} bench_Conn_t;
+
+static int bench_ListenFd = -1;
+static uint16_t bench_Port;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int bench_Listen(void)
+{
+   struct sockaddr_in addr;
+   socklen_t len = sizeof(addr);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   bench_ListenFd = socket(AF_INET, SOCK_STREAM, 0);
+   CHECK(bench_ListenFd >= 0);
+   CHECK(bind(bench_ListenFd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+   CHECK(listen(bench_ListenFd, BENCH_MAX_THREADS) == 0);
+   CHECK(getsockname(bench_ListenFd, (struct sockaddr *)&addr, &len) == 0);
+   bench_Port = ntohs(addr.sin_port);
+
+   return (0);
+}
+
+static int bench_Connect(bench_Conn_t *pConn)
+{
+   SlSockAddrIn_t addr;
+
+   pConn->sd = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, 0);
+   CHECK(pConn->sd >= 0);
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = SL_AF_INET;
+   addr.sin_port = sl_Htons(bench_Port);
+   addr.sin_addr.s_addr = sl_Htonl(SL_IPV4_VAL(127, 0, 0, 1));
+   CHECK(sl_Connect(pConn->sd, (SlSockAddr_t *)&addr, sizeof(addr)) == 0);
+
+   pConn->peerFd = accept(bench_ListenFd, NULL, NULL);
+   CHECK(pConn->peerFd >= 0);
+   pConn->failed = 0;
+   pConn->poolEmpty = 0;
+
+   return (0);
+}
+
+// the POSIX peer, echoes until the sl_ socket is closed
+static void *bench_Echo(void *pArg)
+{
+   bench_Conn_t *pConn = (bench_Conn_t *)pArg;
+   uint8_t buff[BENCH_MSG_LEN];
+   ssize_t n;
+
+   while((n = recv(pConn->peerFd, buff, sizeof(buff), 0)) > 0)
+   {
+      if(send(pConn->peerFd, buff, n, 0) != n)
+      {
+         break;
+      }
+   }
+   return (NULL);
+}
+
+static void *bench_RoundTrips(void *pArg)
+{
+   bench_Conn_t *pConn = (bench_Conn_t *)pArg;
+   uint8_t tx[BENCH_MSG_LEN];
+   uint8_t rx[BENCH_MSG_LEN];
+   int round;
+   int got;
+   int n;
+
+   pthread_barrier_wait(pConn->pStart);
+   for(round = 0; round < BENCH_ROUNDS; round++)
+   {
+      memset(tx, (uint8_t)(round + pConn->sd), sizeof(tx));
+      if(sl_Send(pConn->sd, tx, sizeof(tx), 0) != sizeof(tx))
+      {
+         pConn->failed++;
+         break;
+      }
+      got = 0;
+      while(got < BENCH_MSG_LEN)
+      {
+         n = sl_Recv(pConn->sd, rx + got, BENCH_MSG_LEN - got, 0);
+         if(n == SL_POOL_IS_EMPTY)
+         {
+            pConn->poolEmpty++;
+            sched_yield();
+            continue;
+         }
+         if(n <= 0)
+         {
+            break;
+         }
+         got += n;
+      }
+      if((got != BENCH_MSG_LEN) || (memcmp(tx, rx, sizeof(rx)) != 0))
+      {
+         pConn->failed++;
+         break;
+      }
+   }
+   return (NULL);
+}
+
+static int bench_Threads(int threads)
+{
+   bench_Conn_t conn[BENCH_MAX_THREADS];
+   pthread_t echo[BENCH_MAX_THREADS];
+   pthread_t thread[BENCH_MAX_THREADS];
+   pthread_barrier_t startBarrier;
+   _SlSpawnDrainStats_t before = g_SlSpawnDrainStats;
+   uint64_t start;
+   uint64_t elapsed;
+   uint32_t failed = 0;
+   uint32_t poolEmpty = 0;
+   uint32_t wakes;
+   int i;
+
+   CHECK(pthread_barrier_init(&startBarrier, NULL, threads + 1) == 0);
+   for(i = 0; i < threads; i++)
+   {
+      CHECK(bench_Connect(&conn[i]) == 0);
+      conn[i].pStart = &startBarrier;
+      CHECK(pthread_create(&echo[i], NULL, bench_Echo, &conn[i]) == 0);
+      CHECK(pthread_create(&thread[i], NULL, bench_RoundTrips, &conn[i]) == 0);
+   }
+
+   pthread_barrier_wait(&startBarrier);
+   start = Host_Nsec();
+   for(i = 0; i < threads; i++)
+   {
+      pthread_join(thread[i], NULL);
+      failed += conn[i].failed;
+      poolEmpty += conn[i].poolEmpty;
+   }
+   elapsed = Host_Nsec() - start;
+
+   for(i = 0; i < threads; i++)
+   {
+      sl_Close(conn[i].sd);
+      pthread_join(echo[i], NULL);
+      close(conn[i].peerFd);
+   }
+   pthread_barrier_destroy(&startBarrier);
+   CHECK(failed == 0);
+   wakes = g_SlSpawnDrainStats.Wakes - before.Wakes;
+
+   printf("  %2d thread(s): %6.1f us per round trip, %6.0f round trips/s, %5.2f pool empty retries "
+          "per round trip, %4.2f messages per spawn wake\n",
+          threads, (double)elapsed / 1000.0 / ((double)BENCH_ROUNDS * threads),
+          (double)BENCH_ROUNDS * threads * 1e9 / (double)elapsed,
+          (double)poolEmpty / ((double)BENCH_ROUNDS * threads),
+          (wakes != 0) ? (double)(g_SlSpawnDrainStats.Msgs - before.Msgs) / wakes : 0.0);
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   static const int threads[] = { 1, 2, 4, 8, BENCH_MAX_THREADS };
+   size_t i;
+
+   if(SlHost_Start() < 0)
+   {
+      printf("FAIL sl_Start\n");
+      return (1);
+   }
+   if(bench_Listen() != 0)
+   {
+      return (1);
+   }
+
+   printf("%d byte sl_Send and sl_Recv round trips, MAX_CONCURRENT_ACTIONS %d\n",
+          BENCH_MSG_LEN, MAX_CONCURRENT_ACTIONS);
+   for(i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+   {
+      if(bench_Threads(threads[i]) != 0)
+      {
+         return (1);
+      }
+   }
+
+   close(bench_ListenFd);
+   SlHost_Stop();
+   return (0);
+}
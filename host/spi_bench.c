@@ -0,0 +1,197 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host benchmark of the CC3135 SPI port (cc_pal.c) over the SPI stand-in.
+ *
+ * Sends the same data frames through the earlier transport, which started
+ * every maxDMASize chunk from the calling task and spun on a completion flag,
+ * and through spi_WriteV, which chains the chunks from the SPI event and
+ * blocks the calling task. A second task counts loops for as long as the
+ * frames are sent: the work it gets done, against that of an idle link, is
+ * the CPU time the transport leaves to the rest of the system.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+#include "nrf/nrfx_spim.h"
+
+#include "spi_sim.h"
+#include "host_util.h"
+
+#define BENCH_FRAMES                   (200)
+#define BENCH_HDR_LEN                  (8)
+#define BENCH_FRAME_LEN                (1460)
+#define BENCH_MAX_DMA                  (1024)
+
+typedef struct
+{
+   uint64_t nsec;        // wall time of the frames
+   uint64_t cpuNsec;     // CPU time of the sending task
+   uint64_t otherLoops;  // loops of the other task meanwhile
+} bench_Result_t;
+
+static const nrfx_spim_t bench_Spi = NRFX_SPIM_INSTANCE(0);
+static volatile bool bench_XferDone;
+static volatile bool bench_Stop;
+static volatile uint64_t bench_OtherLoops;
+
+static uint8_t bench_Hdr[BENCH_HDR_LEN];
+static uint8_t bench_Frame[BENCH_FRAME_LEN];
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static uint64_t bench_CpuNsec(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+// another task of the same priority, with work to do
+static void *bench_OtherTask(void *arg)
+{
+   while(!bench_Stop)
+   {
+      bench_OtherLoops++;
+   }
+   return (NULL);
+}
+
+static void bench_SpinHandler(nrfx_spim_evt_t const *p_event, void *p_context)
+{
+   bench_XferDone = true;
+}
+
+// the earlier spi_Write: one chunk at a time, spinning until it is done
+static int bench_SpinWrite(const uint8_t *pBuff, int len)
+{
+   nrfx_spim_xfer_desc_t desc;
+   int chunk;
+
+   while(len > 0)
+   {
+      chunk = (len > BENCH_MAX_DMA) ? BENCH_MAX_DMA : len;
+      desc = (nrfx_spim_xfer_desc_t)NRFX_SPIM_XFER_TRX(pBuff, chunk, NULL, 0);
+      bench_XferDone = false;
+      CHECK(nrfx_spim_xfer(&bench_Spi, &desc, 0) == NRFX_SUCCESS);
+      while(!bench_XferDone)
+      {
+      }
+      len -= chunk;
+      pBuff += chunk;
+   }
+   return (0);
+}
+
+// the earlier transport had no gathered write, the header went on its own
+static int bench_SendSpin(Fd_t fd)
+{
+   int i;
+
+   for(i = 0; i < BENCH_FRAMES; i++)
+   {
+      CHECK(bench_SpinWrite(bench_Hdr, BENCH_HDR_LEN) == 0);
+      CHECK(bench_SpinWrite(bench_Frame, BENCH_FRAME_LEN) == 0);
+   }
+   return (0);
+}
+
+static int bench_SendBlocking(Fd_t fd)
+{
+   SlIfIoVec_t iov[] = { { bench_Hdr, BENCH_HDR_LEN }, { bench_Frame, BENCH_FRAME_LEN } };
+   int i;
+
+   for(i = 0; i < BENCH_FRAMES; i++)
+   {
+      CHECK(spi_WriteV(fd, iov, 2) == BENCH_HDR_LEN + BENCH_FRAME_LEN);
+   }
+   return (0);
+}
+
+// sends the frames, or sleeps for idleNsec, with the other task running
+static int bench_Run(int (*send)(Fd_t), Fd_t fd, uint64_t idleNsec, bench_Result_t *pResult)
+{
+   struct timespec ts = { (time_t)(idleNsec / 1000000000ULL), (long)(idleNsec % 1000000000ULL) };
+   pthread_t other;
+   uint64_t start;
+   uint64_t cpu;
+   int ret = 0;
+
+   bench_Stop = false;
+   bench_OtherLoops = 0;
+   CHECK(pthread_create(&other, NULL, bench_OtherTask, NULL) == 0);
+
+   start = Host_Nsec();
+   cpu = bench_CpuNsec();
+   if(send != NULL)
+   {
+      ret = send(fd);
+   }
+   else
+   {
+      nanosleep(&ts, NULL);
+   }
+   pResult->cpuNsec = bench_CpuNsec() - cpu;
+   pResult->nsec = Host_Nsec() - start;
+   pResult->otherLoops = bench_OtherLoops;
+
+   bench_Stop = true;
+   pthread_join(other, NULL);
+
+   return (ret);
+}
+
+static void bench_Print(const char *name, const bench_Result_t *pResult, const bench_Result_t *pIdle)
+{
+   double sec = pResult->nsec / 1e9;
+   double otherRate = pResult->otherLoops / sec;
+   double idleRate = pIdle->otherLoops / (pIdle->nsec / 1e9);
+
+   printf("%-10s %8.1f ms %8.1f KB/s %10.1f us CPU/frame %7.1f %% of the idle work done\n",
+          name, pResult->nsec / 1e6,
+          (double)BENCH_FRAMES * (BENCH_HDR_LEN + BENCH_FRAME_LEN) / 1024 / sec,
+          pResult->cpuNsec / 1e3 / BENCH_FRAMES,
+          100.0 * otherRate / idleRate);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   nrfx_spim_config_t config = NRFX_SPIM_DEFAULT_CONFIG;
+   bench_Result_t spin;
+   bench_Result_t blocking;
+   bench_Result_t idle;
+   SpiSim_Stats_t sim;
+   Fd_t fd;
+
+   printf("%d frames of %d + %d bytes, SPI at %d Hz\n",
+          BENCH_FRAMES, BENCH_HDR_LEN, BENCH_FRAME_LEN, (int)config.frequency);
+
+   CHECK(nrfx_spim_init(&bench_Spi, &config, bench_SpinHandler, NULL) == NRFX_SUCCESS);
+   CHECK(bench_Run(bench_SendSpin, -1, 0, &spin) == 0);
+   nrfx_spim_uninit(&bench_Spi);
+
+   fd = spi_Open(NULL, 0);
+   CHECK(fd >= 0);
+   SpiSim_ResetStats();
+   CHECK(bench_Run(bench_SendBlocking, fd, 0, &blocking) == 0);
+   SpiSim_GetStats(&sim);
+   spi_Close(fd);
+
+   CHECK(bench_Run(NULL, -1, blocking.nsec, &idle) == 0);
+
+   bench_Print("spin", &spin, &idle);
+   bench_Print("blocking", &blocking, &idle);
+   printf("blocking: %u chunks, %u DMA setups, %u START tasks, bus busy %.1f %% of the time\n",
+          sim.chunks, sim.dmaSetups, sim.startTasks, 100.0 * sim.busNsec / blocking.nsec);
+
+   return (0);
+}
@@ -0,0 +1,292 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * SPIM peripheral stand-in for the host builds of the CC3135 SPI port, see
+ * spi_sim.h.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "nrf/nrfx_spim.h"
+#include "spi_sim.h"
+#include "host_util.h"
+
+// EasyDMA MAXCNT of the nRF52840 SPIM
+#define SIM_MAX_CHUNK                  (0xFFFF)
+
+static pthread_mutex_t sim_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_Cond = PTHREAD_COND_INITIALIZER;
+static pthread_t sim_Thread;
+static bool sim_Running;                // initialized, the thread runs
+static nrfx_spim_evt_handler_t sim_Handler;
+static void *sim_Context;
+static uint32_t sim_Hz;
+static nrfx_spim_xfer_desc_t sim_Desc;  // chunk programmed or repeated
+static uint32_t sim_Flags;              // post-increment flags of sim_Desc
+static bool sim_Pending;                // a chunk waits to be clocked
+static bool sim_Busy;                   // a chunk is being clocked
+static bool sim_Aborted;                // the chunk in flight raises no event
+static volatile uint32_t sim_StartTask; // the START task register
+
+static const uint8_t *sim_FlashStart;
+static size_t sim_FlashLen;
+static uint8_t *sim_CaptureBuf;
+static size_t sim_CaptureSize;
+static size_t sim_Captured;
+static SpiSim_Stats_t sim_Stats;
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+// time on the bus of one chunk
+static void sim_Clock(const nrfx_spim_xfer_desc_t *pDesc)
+{
+   size_t len = (pDesc->tx_length > pDesc->rx_length) ? pDesc->tx_length : pDesc->rx_length;
+   uint64_t nsec = (uint64_t)len * 8 * 1000000000ULL / sim_Hz;
+   struct timespec ts = { (time_t)(nsec / 1000000000ULL), (long)(nsec % 1000000000ULL) };
+
+   nanosleep(&ts, NULL);
+}
+
+// the bytes of a chunk that has been clocked, under the lock
+static void sim_Move(const nrfx_spim_xfer_desc_t *pDesc)
+{
+   size_t i;
+
+   for(i = 0; i < pDesc->tx_length; i++)
+   {
+      if(sim_Captured < sim_CaptureSize)
+      {
+         sim_CaptureBuf[sim_Captured++] = pDesc->p_tx_buffer[i];
+      }
+   }
+   for(i = 0; i < pDesc->rx_length; i++)
+   {
+      pDesc->p_rx_buffer[i] = SpiSim_MisoByte(sim_Stats.bytesIn + i);
+   }
+   sim_Stats.bytesOut += pDesc->tx_length;
+   sim_Stats.bytesIn += pDesc->rx_length;
+}
+
+static void *sim_Peripheral(void *arg)
+{
+   nrfx_spim_evt_t evt;
+   nrfx_spim_xfer_desc_t desc;
+   uint32_t flags;
+   uint64_t start;
+
+   pthread_mutex_lock(&sim_Lock);
+   while(sim_Running)
+   {
+      if(!sim_Pending)
+      {
+         pthread_cond_wait(&sim_Cond, &sim_Lock);
+         continue;
+      }
+
+      desc = sim_Desc;
+      flags = sim_Flags;
+      sim_Pending = false;
+      sim_Busy = true;
+      sim_Aborted = false;
+      pthread_mutex_unlock(&sim_Lock);
+
+      start = Host_Nsec();
+      sim_Clock(&desc);
+
+      pthread_mutex_lock(&sim_Lock);
+      sim_Move(&desc);
+      sim_Busy = false;
+      sim_Stats.chunks++;
+      sim_Stats.busNsec += Host_Nsec() - start;
+      if(sim_Aborted)
+      {
+         continue;
+      }
+      pthread_mutex_unlock(&sim_Lock);
+
+      // the END interrupt, which may program the next chunk or trigger START
+      sim_StartTask = 0;
+      evt.type = NRFX_SPIM_EVENT_DONE;
+      evt.xfer_desc = desc;
+      sim_Handler(&evt, sim_Context);
+
+      pthread_mutex_lock(&sim_Lock);
+      if(sim_StartTask != 0)
+      {
+         sim_StartTask = 0;
+         if(flags & NRFX_SPIM_FLAG_TX_POSTINC)
+         {
+            desc.p_tx_buffer += desc.tx_length;
+         }
+         if(flags & NRFX_SPIM_FLAG_RX_POSTINC)
+         {
+            desc.p_rx_buffer += desc.rx_length;
+         }
+         sim_Desc = desc;
+         sim_Flags = flags;
+         sim_Pending = true;
+         sim_Stats.startTasks++;
+      }
+   }
+   pthread_mutex_unlock(&sim_Lock);
+
+   return (NULL);
+}
+
+/****************************************************************************
+   SPIM DRIVER
+****************************************************************************/
+nrfx_err_t nrfx_spim_init(nrfx_spim_t const * const p_instance,
+                          nrfx_spim_config_t const *p_config,
+                          nrfx_spim_evt_handler_t handler,
+                          void *p_context)
+{
+   if(sim_Running)
+   {
+      return (NRFX_ERROR_INVALID_STATE);
+   }
+
+   sim_Handler = handler;
+   sim_Context = p_context;
+   sim_Hz = p_config->frequency;
+   sim_Pending = false;
+   sim_Busy = false;
+   sim_Running = true;
+   if(pthread_create(&sim_Thread, NULL, sim_Peripheral, NULL) != 0)
+   {
+      sim_Running = false;
+      return (NRFX_ERROR_INVALID_STATE);
+   }
+
+   return (NRFX_SUCCESS);
+}
+
+void nrfx_spim_uninit(nrfx_spim_t const * const p_instance)
+{
+   pthread_mutex_lock(&sim_Lock);
+   if(!sim_Running)
+   {
+      pthread_mutex_unlock(&sim_Lock);
+      return;
+   }
+   sim_Running = false;
+   pthread_cond_signal(&sim_Cond);
+   pthread_mutex_unlock(&sim_Lock);
+
+   pthread_join(sim_Thread, NULL);
+}
+
+nrfx_err_t nrfx_spim_xfer(nrfx_spim_t const * const p_instance,
+                          nrfx_spim_xfer_desc_t const *p_xfer_desc,
+                          uint32_t flags)
+{
+   nrfx_err_t err = NRFX_SUCCESS;
+
+   pthread_mutex_lock(&sim_Lock);
+   if(!sim_Running)
+   {
+      err = NRFX_ERROR_INVALID_STATE;
+   }
+   else if(sim_Pending || sim_Busy)
+   {
+      err = NRFX_ERROR_BUSY;
+   }
+   else if((p_xfer_desc->tx_length > SIM_MAX_CHUNK) || (p_xfer_desc->rx_length > SIM_MAX_CHUNK))
+   {
+      err = NRFX_ERROR_INVALID_LENGTH;
+   }
+   else if(((p_xfer_desc->tx_length != 0) && !nrfx_is_in_ram(p_xfer_desc->p_tx_buffer)) ||
+           ((p_xfer_desc->rx_length != 0) && !nrfx_is_in_ram(p_xfer_desc->p_rx_buffer)))
+   {
+      err = NRFX_ERROR_INVALID_ADDR;
+   }
+
+   if(err == NRFX_SUCCESS)
+   {
+      sim_Desc = *p_xfer_desc;
+      sim_Flags = flags;
+      sim_Pending = true;
+      sim_Stats.dmaSetups++;
+      pthread_cond_signal(&sim_Cond);
+   }
+   else
+   {
+      sim_Stats.rejected++;
+   }
+   pthread_mutex_unlock(&sim_Lock);
+
+   return (err);
+}
+
+uintptr_t nrfx_spim_start_task_get(nrfx_spim_t const *p_instance)
+{
+   return ((uintptr_t)&sim_StartTask);
+}
+
+void nrfx_spim_abort(nrfx_spim_t const *p_instance)
+{
+   pthread_mutex_lock(&sim_Lock);
+   sim_Pending = false;
+   sim_Aborted = sim_Busy;
+   pthread_mutex_unlock(&sim_Lock);
+}
+
+bool nrfx_is_in_ram(void const *p_object)
+{
+   const uint8_t *p = p_object;
+
+   return ((p < sim_FlashStart) || (p >= sim_FlashStart + sim_FlashLen));
+}
+
+/****************************************************************************
+   STAND-IN CONTROL
+****************************************************************************/
+void SpiSim_SetFlash(const void *pStart, size_t len)
+{
+   sim_FlashStart = pStart;
+   sim_FlashLen = len;
+}
+
+void SpiSim_Capture(uint8_t *pBuf, size_t size)
+{
+   pthread_mutex_lock(&sim_Lock);
+   sim_CaptureBuf = pBuf;
+   sim_CaptureSize = size;
+   sim_Captured = 0;
+   pthread_mutex_unlock(&sim_Lock);
+}
+
+size_t SpiSim_Captured(void)
+{
+   size_t captured;
+
+   pthread_mutex_lock(&sim_Lock);
+   captured = sim_Captured;
+   pthread_mutex_unlock(&sim_Lock);
+
+   return (captured);
+}
+
+uint8_t SpiSim_MisoByte(uint64_t n)
+{
+   return ((uint8_t)(n ^ (n >> 8) ^ 0x5A));
+}
+
+void SpiSim_GetStats(SpiSim_Stats_t *pStats)
+{
+   pthread_mutex_lock(&sim_Lock);
+   *pStats = sim_Stats;
+   pthread_mutex_unlock(&sim_Lock);
+}
+
+void SpiSim_ResetStats(void)
+{
+   pthread_mutex_lock(&sim_Lock);
+   memset(&sim_Stats, 0, sizeof(sim_Stats));
+   pthread_mutex_unlock(&sim_Lock);
+}
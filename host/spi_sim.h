@@ -0,0 +1,56 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * SPI stand-in for the host builds of the CC3135 SPI port (cc_pal.c).
+ *
+ * A thread plays the SPIM peripheral: it clocks each chunk handed to it at the
+ * configured bus frequency, records the bytes sent, fills the receive buffer
+ * from a pattern, and raises the end of chunk event from its own context, as
+ * the interrupt would. EasyDMA restrictions are kept: buffers the program
+ * declared as flash are refused, and a START task repeats the last chunk with
+ * the pointers post-incremented when the transfer asked for it.
+ */
+
+#ifndef __SPI_SIM_H__
+#define __SPI_SIM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+   uint32_t dmaSetups;     // chunks programmed through nrfx_spim_xfer
+   uint32_t startTasks;    // chunks started by the START task alone
+   uint32_t chunks;        // chunks clocked to the end
+   uint32_t rejected;      // transfers refused, e.g. buffers in flash
+   uint64_t bytesOut;      // bytes clocked out
+   uint64_t bytesIn;       // bytes clocked in
+   uint64_t busNsec;       // time the bus was clocking
+} SpiSim_Stats_t;
+
+/**
+ * @brief Declares a region that EasyDMA cannot reach.
+ */
+void SpiSim_SetFlash(const void *pStart, size_t len);
+
+/**
+ * @brief Records the bytes clocked out from now on in pBuf, up to size.
+ */
+void SpiSim_Capture(uint8_t *pBuf, size_t size);
+
+/**
+ * @brief Number of bytes recorded since SpiSim_Capture().
+ */
+size_t SpiSim_Captured(void);
+
+/**
+ * @brief The n-th byte clocked in, counted from the last SpiSim_ResetStats().
+ */
+uint8_t SpiSim_MisoByte(uint64_t n);
+
+void SpiSim_GetStats(SpiSim_Stats_t *pStats);
+
+void SpiSim_ResetStats(void);
+
+#endif // __SPI_SIM_H__
@@ -0,0 +1,134 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Host test of the CC3135 SPI port (cc_pal.c) over the SPI stand-in.
+ *
+ * A gathered write mixes buffers in RAM, which are sent in place in
+ * maxDMASize chunks, with constant buffers in flash, which EasyDMA cannot
+ * reach and are sent through the bounce buffer a piece at a time. The bytes
+ * clocked out must be those of the segments, in order, and chunks of the
+ * size of the one before must be started by the START task alone. A read
+ * longer than maxDMASize must fill the buffer with the bytes clocked in.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+
+#include "spi_sim.h"
+#include "host_util.h"
+
+#define TEST_MAX_DMA                   (1024)
+#define TEST_BOUNCE                    (64)
+#define TEST_RAM_LEN                   (3000)
+#define TEST_READ_LEN                  (2500)
+
+// constant data of the host driver, e.g. a command header kept in flash
+static const uint8_t test_Flash[200 + 10] = { 0x21, 0x43, 0x65, 0x87 };
+
+static uint8_t test_Ram[TEST_RAM_LEN];
+static uint8_t test_Out[4 + sizeof(test_Flash) + TEST_RAM_LEN];
+static uint8_t test_In[TEST_READ_LEN];
+
+/****************************************************************************
+   LOCAL FUNCTIONS
+****************************************************************************/
+static int test_GatheredWrite(Fd_t fd)
+{
+   static uint8_t hdr[4] = { 0xde, 0xad, 0xbe, 0xef };
+   SlIfIoVec_t iov[] =
+   {
+      { hdr, sizeof(hdr) },
+      { (unsigned char *)test_Flash, 200 },
+      { test_Ram, TEST_RAM_LEN },
+      { (unsigned char *)test_Flash + 200, 10 },
+   };
+   uint8_t expected[sizeof(test_Out)];
+   SpiSim_Stats_t sim;
+   SPI_Stats_t stats;
+   size_t off = 0;
+   size_t i;
+
+   for(i = 0; i < TEST_RAM_LEN; i++)
+   {
+      test_Ram[i] = (uint8_t)(i * 13);
+   }
+   for(i = 0; i < sizeof(iov) / sizeof(iov[0]); i++)
+   {
+      memcpy(&expected[off], iov[i].pBuff, iov[i].len);
+      off += iov[i].len;
+   }
+
+   spi_ResetStats();
+   SpiSim_ResetStats();
+   SpiSim_Capture(test_Out, sizeof(test_Out));
+   CHECK(spi_WriteV(fd, iov, sizeof(iov) / sizeof(iov[0])) == (int)off);
+   CHECK(SpiSim_Captured() == off);
+   CHECK(memcmp(test_Out, expected, off) == 0);
+
+   spi_GetStats(&stats);
+   SpiSim_GetStats(&sim);
+   printf("write of %d bytes: %u chunks, %u DMA setups, %u START tasks\n",
+          (int)off, sim.chunks, sim.dmaSetups, sim.startTasks);
+   CHECK(stats.transfers == 1);
+   CHECK(stats.segments == 4);
+   CHECK(stats.errors == 0);
+   CHECK(sim.rejected == 0);
+   // 4, flash 64+64+64+8, RAM 1024+1024+952, flash 10
+   CHECK(sim.chunks == 1 + (200 + TEST_BOUNCE - 1) / TEST_BOUNCE +
+                       (TEST_RAM_LEN + TEST_MAX_DMA - 1) / TEST_MAX_DMA + 1);
+   CHECK(stats.chunks == sim.chunks);
+   CHECK(stats.dmaSetups == sim.dmaSetups);
+   CHECK(sim.startTasks == 2 + 1);
+   CHECK(sim.dmaSetups + sim.startTasks == sim.chunks);
+
+   return (0);
+}
+
+static int test_Read(Fd_t fd)
+{
+   SpiSim_Stats_t sim;
+   int i;
+
+   SpiSim_ResetStats();
+   memset(test_In, 0, sizeof(test_In));
+   CHECK(spi_Read(fd, test_In, TEST_READ_LEN) == TEST_READ_LEN);
+   for(i = 0; i < TEST_READ_LEN; i++)
+   {
+      CHECK(test_In[i] == SpiSim_MisoByte(i));
+   }
+
+   SpiSim_GetStats(&sim);
+   CHECK(sim.chunks == (TEST_READ_LEN + TEST_MAX_DMA - 1) / TEST_MAX_DMA);
+   CHECK(sim.bytesOut == 0);
+
+   return (0);
+}
+
+/****************************************************************************
+   MAIN
+****************************************************************************/
+int main(void)
+{
+   Fd_t fd;
+
+   SpiSim_SetFlash(test_Flash, sizeof(test_Flash));
+   fd = spi_Open(NULL, 0);
+   if((fd < 0) || (test_GatheredWrite(fd) != 0))
+   {
+      return (1);
+   }
+   printf("PASS flash segments past the bounce buffer are sent a piece at a time\n");
+
+   if(test_Read(fd) != 0)
+   {
+      return (1);
+   }
+   printf("PASS a read is clocked in maxDMASize chunks\n");
+
+   spi_Close(fd);
+
+   return (0);
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+// Written by host/json_template_gen from the texts of json_templates.h, do not edit.
+
+#include "json_templates.h"
+
+static const union { uint32_t align; uint8_t bytes[168]; } JsonTemplate_ExampleData =
+{
+   .bytes =
+   {
+      0x01, 0x30, 0x26, 0x00, 0x02, 0x00, 0x10, 0x00, 0x06, 0x00, 0x02, 0x00,
+      0xa0, 0xfe, 0x3b, 0xa5, 0x59, 0xfd, 0x3b, 0xa5, 0xcf, 0xf4, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xa0, 0x14, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xb8, 0x38, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0x3b, 0xa5, 0xc4, 0x5a, 0x02, 0x10, 0x3b, 0xa5, 0x26, 0x00, 0x3b, 0xa5,
+      0x26, 0x80, 0xa0, 0x14, 0x08, 0x01, 0x59, 0xfd, 0x1f, 0x03, 0xb8, 0x38,
+      0x1f, 0x03, 0xcf, 0xf4, 0x00, 0x04, 0xa0, 0xfe, 0x12, 0x40, 0x03, 0x00,
+      0xd1, 0xae, 0x08, 0x01, 0x24, 0x85, 0x08, 0x01, 0x2d, 0xe5, 0x08, 0x01,
+      0x6d, 0x65, 0x74, 0x68, 0x6f, 0x64, 0x00, 0x67, 0x61, 0x74, 0x65, 0x77,
+      0x61, 0x79, 0x49, 0x64, 0x00, 0x63, 0x6f, 0x6c, 0x6c, 0x65, 0x63, 0x74,
+      0x6f, 0x72, 0x49, 0x64, 0x00, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x49,
+      0x64, 0x00, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x00,
+   }
+};
+
+const JsonTemplate_Compiled_t JsonTemplate_Example = { JsonTemplate_ExampleData.bytes, 168 };
+
+static const union { uint32_t align; uint8_t bytes[180]; } JsonTemplate_EventMessageData =
+{
+   .bytes =
+   {
+      0x01, 0x30, 0x32, 0x00, 0x02, 0x00, 0x10, 0x00, 0x06, 0x00, 0x02, 0x00,
+      0xa0, 0xfe, 0x3b, 0xa5, 0x59, 0xfd, 0x3b, 0xa5, 0xcf, 0xf4, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xa0, 0x14, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xb8, 0x38, 0x3b, 0xa5,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0x3b, 0xa5, 0xc4, 0x5a, 0x02, 0x10, 0x3b, 0xa5, 0x32, 0x00, 0x3b, 0xa5,
+      0x32, 0x80, 0xa0, 0x14, 0x08, 0x01, 0x59, 0xfd, 0x08, 0x01, 0xb8, 0x38,
+      0x08, 0x01, 0xcf, 0xf4, 0x08, 0x01, 0xa0, 0xfe, 0x1e, 0x40, 0x06, 0x00,
+      0xd1, 0xae, 0x08, 0x01, 0x24, 0x85, 0x08, 0x01, 0x2d, 0xe5, 0x08, 0x01,
+      0x8b, 0x80, 0x08, 0x01, 0x88, 0x1a, 0x08, 0x01, 0x7b, 0x3b, 0x08, 0x01,
+      0x6d, 0x65, 0x74, 0x68, 0x6f, 0x64, 0x00, 0x67, 0x61, 0x74, 0x65, 0x77,
+      0x61, 0x79, 0x49, 0x64, 0x00, 0x63, 0x6f, 0x6c, 0x6c, 0x65, 0x63, 0x74,
+      0x6f, 0x72, 0x49, 0x64, 0x00, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x49,
+      0x64, 0x00, 0x65, 0x76, 0x65, 0x6e, 0x74, 0x4c, 0x69, 0x73, 0x74, 0x00,
+   }
+};
+
+const JsonTemplate_Compiled_t JsonTemplate_EventMessage = { JsonTemplate_EventMessageData.bytes, 180 };
@@ -0,0 +1,46 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+#ifndef JSON_TEMPLATES_H
+#define JSON_TEMPLATES_H
+
+#include <stdint.h>
+
+/**
+ * JSON templates of the application, as text and compiled.
+ *
+ * The compiled templates in json_templates.c are written by the host
+ * generator (make -C host templates) from the texts below, and are used at
+ * boot with Json_createTemplateFromCompiled() instead of parsing the text.
+ * Regenerate them whenever a text changes; the host json_template_test fails
+ * on a compiled template that no longer matches its text.
+ */
+
+// example message of the JSON library tests
+#define JSON_TEMPLATE_EXAMPLE                                   \
+   "{\n\"method\": string,"                                     \
+   "\"gatewayId\": int32,"                                      \
+   "\"collectorId\": int32,"                                    \
+   "\"deviceId\": boolean,"                                     \
+   "\"eventList\": [string, string, string]"                    \
+   "}"
+
+// eventList message, as the AWS driver publishes it
+#define JSON_TEMPLATE_EVENT_MESSAGE                             \
+   "{\"method\":string,"                                        \
+   "\"gatewayId\":string,"                                      \
+   "\"collectorId\":string,"                                    \
+   "\"deviceId\":string,"                                       \
+   "\"eventList\":[string,string,string,string,string,string]"  \
+   "}"
+
+typedef struct
+{
+   const void* data;    // compiled template, aligned as the library reads it
+   uint16_t    len;
+} JsonTemplate_Compiled_t;
+
+extern const JsonTemplate_Compiled_t JsonTemplate_Example;
+extern const JsonTemplate_Compiled_t JsonTemplate_EventMessage;
+
+#endif
@@ -1,4 +1,5 @@
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -6,16 +7,13 @@
 #include "external/cJSON/cJSON.h"
 #include "external/JSMN/jsmn.h"
 #include <ti/utils/json/json.h>
+#include "JsonWriter.h"
+#include "json_templates.h"
 
 #include "json_test.h"
 
 //struct record {const char *precision;double lat,lon;const char *address,*city,*state,*zip,*country; };
-const char* EXAMPLE_TEMPLATE = "{\n\"method\": string,"  \
-                               "\"gatewayId\": int32,"   \
-                               "\"collectorId\": int32," \
-                               "\"deviceId\": boolean"   \
-                               "\"eventList\": [string, string, string]" \
-                               "}";
+const char* EXAMPLE_TEMPLATE = JSON_TEMPLATE_EXAMPLE;
 
 static char* jsonText = "{\n\"method\": \"event\", " \
                          "\n\"gatewayId\": \"0123456\", " \
@@ -124,8 +122,8 @@ void TISL_JSON_TEST()
    char        deviceIdBuffer[32];
    uint16_t    deviceIdBufferSize = sizeof(deviceIdBuffer);
     
-   // Create an internal representation of the template for the library's use
-   Json_createTemplate(&templateHandle, EXAMPLE_TEMPLATE, strlen(EXAMPLE_TEMPLATE));
+   // Load the template the host generator compiled from EXAMPLE_TEMPLATE
+   Json_createTemplateFromCompiled(&templateHandle, JsonTemplate_Example.data, JsonTemplate_Example.len);
     
    // Allocate memory needed for an object matching the generated template
    Json_createObject(&objectHandle, templateHandle, 0);
@@ -138,3 +136,161 @@ void TISL_JSON_TEST()
    fieldName = "\"method\"";
    Json_getValue(objectHandle, fieldName, &deviceIdBuffer, &deviceIdBufferSize);
 }
+
+static void JsonWriter_TestMessage(JsonWriter_t* writer)
+{
+   JsonWriter_ObjectBegin(writer, NULL);
+   JsonWriter_String(writer, "method", "event", strlen("event"));
+   JsonWriter_String(writer, "gatewayId", "98765", strlen("98765"));
+   JsonWriter_String(writer, "collectorId", "1234", strlen("1234"));
+   JsonWriter_String(writer, "deviceId", "554", strlen("554"));
+   JsonWriter_ArrayBegin(writer, "eventList");
+   for (uint8_t i = 0; i < sizeof(dispenserEvents) / sizeof(dispenserEvents[0]); i++)
+   {
+      JsonWriter_String(writer, NULL, dispenserEvents[i], strlen(dispenserEvents[i]));
+   }
+   JsonWriter_ArrayEnd(writer);
+   JsonWriter_ObjectEnd(writer);
+}
+
+// the message JsonWriter_TestMessage() writes
+static const char* JsonWriter_Expected =
+   "{\"method\":\"event\",\"gatewayId\":\"98765\",\"collectorId\":\"1234\",\"deviceId\":\"554\","
+   "\"eventList\":[\"7E0155FF14167E\",\"7E814101EE2A7E\",\"7E0146014CE77E\","
+   "\"7E815603548C7E\",\"7E81430098697E\",\"7E814103CE687E\"]}";
+
+// both documents, parsed and printed again by cJSON, come out the same
+static bool JsonWriter_SamePrint(const char* text, const char* otherText)
+{
+   bool   same = false;
+   cJSON* json = cJSON_Parse(text);
+   cJSON* otherJson = cJSON_Parse(otherText);
+   
+   if ((NULL != json) && (NULL != otherJson))
+   {
+      char* strJson = cJSON_Print(json);
+      char* strOther = cJSON_Print(otherJson);
+      
+      same = (NULL != strJson) && (NULL != strOther) && (strcmp(strJson, strOther) == 0);
+      free(strJson);
+      free(strOther);
+   }
+   cJSON_Delete(json);
+   cJSON_Delete(otherJson);
+   
+   return same;
+}
+
+// the same message built as a cJSON tree prints as 'text'
+static bool JsonWriter_SameAsCJSON(const char* text)
+{
+   bool   same;
+   cJSON* outJson = cJSON_CreateObject();
+   
+   cJSON_AddItemToObject(outJson, "method", cJSON_CreateString("event"));
+   cJSON_AddItemToObject(outJson, "gatewayId", cJSON_CreateString("98765"));
+   cJSON_AddItemToObject(outJson, "collectorId", cJSON_CreateString("1234"));
+   cJSON_AddItemToObject(outJson, "deviceId", cJSON_CreateString("554"));
+   cJSON_AddItemToObject(outJson, "eventList",
+                         cJSON_CreateStringArray(dispenserEvents,
+                                                 sizeof(dispenserEvents) / sizeof(dispenserEvents[0])));
+   
+   char* strJson = cJSON_PrintUnformatted(outJson);
+   char* strFormatted = cJSON_Print(outJson);
+   
+   same = (NULL != strJson) && (strcmp(strJson, text) == 0) &&
+          (NULL != strFormatted) && JsonWriter_SamePrint(strFormatted, text);
+   
+   cJSON_Delete(outJson);
+   free(strJson);
+   free(strFormatted);
+   
+   return same;
+}
+
+// the same message built by the TI library holds the same values as 'text',
+// Json_build() spaces its output so the two are compared through cJSON
+static bool JsonWriter_SameAsJsonBuild(const char* text)
+{
+   Json_Handle templateHandle;
+   Json_Handle objectHandle;
+   char        builtText[512];
+   uint16_t    builtLen = sizeof(builtText) - 1;
+   char        key[24];
+   bool        same = false;
+   
+   if (Json_createTemplateFromCompiled(&templateHandle, JsonTemplate_EventMessage.data,
+                                       JsonTemplate_EventMessage.len) != JSON_RC__OK)
+   {
+      return false;
+   }
+   
+   if (Json_createObject(&objectHandle, templateHandle, 0) == JSON_RC__OK)
+   {
+      int16_t rc = JSON_RC__OK;
+      
+      rc |= Json_setValue(objectHandle, "\"method\"", "event", strlen("event"));
+      rc |= Json_setValue(objectHandle, "\"gatewayId\"", "98765", strlen("98765"));
+      rc |= Json_setValue(objectHandle, "\"collectorId\"", "1234", strlen("1234"));
+      rc |= Json_setValue(objectHandle, "\"deviceId\"", "554", strlen("554"));
+      for (uint8_t i = 0; i < sizeof(dispenserEvents) / sizeof(dispenserEvents[0]); i++)
+      {
+         snprintf(key, sizeof(key), "\"eventList\".[%u]", i);
+         rc |= Json_setValue(objectHandle, key, (void*)dispenserEvents[i], strlen(dispenserEvents[i]));
+      }
+      
+      if ((JSON_RC__OK == rc) && (Json_build(objectHandle, builtText, &builtLen) == JSON_RC__OK))
+      {
+         builtText[builtLen] = '\0';
+         same = JsonWriter_SamePrint(builtText, text);
+      }
+      Json_destroyObject(objectHandle);
+   }
+   Json_destroyTemplate(templateHandle);
+   
+   return same;
+}
+
+bool JsonWriter_Test()
+{
+   JsonWriter_t writer;
+   char         outputBuffer[256];
+   char         partBuffer[32];
+   uint32_t     offset = 0;
+   
+   // 1. Encode the message straight into the buffer, no tree and no allocation
+   JsonWriter_Init(&writer, outputBuffer, sizeof(outputBuffer) - 1, 0);
+   JsonWriter_TestMessage(&writer);
+   
+   if (!JsonWriter_IsDone(&writer) || JsonWriter_IsFull(&writer))
+   {
+      return false;
+   }
+   outputBuffer[JsonWriter_Len(&writer)] = '\0';
+   
+   if (strcmp(outputBuffer, JsonWriter_Expected) != 0)
+   {
+      return false;
+   }
+   
+   // 2. Encode it again in parts through a buffer too small for the whole message
+   do
+   {
+      JsonWriter_Init(&writer, partBuffer, sizeof(partBuffer), offset);
+      JsonWriter_TestMessage(&writer);
+      
+      if (memcmp(partBuffer, &outputBuffer[offset], JsonWriter_Len(&writer)) != 0)
+      {
+         return false;
+      }
+      offset += JsonWriter_Len(&writer);
+   } while (JsonWriter_IsFull(&writer));
+   
+   if (offset != strlen(outputBuffer))
+   {
+      return false;
+   }
+   
+   // 3. The other libraries write the same message
+   return JsonWriter_SameAsCJSON(outputBuffer) && JsonWriter_SameAsJsonBuild(outputBuffer);
+}
@@ -1,6 +1,8 @@
 #ifndef JSON_TEST_H
 #define JSON_TEST_H
 
+#include <stdbool.h>
+
 
 // test basic functionality of each of the JSON libraries
 // 1. encode a JSON message
@@ -12,4 +14,8 @@ void JSMN_Test();
 
 void TISL_JSON_TEST();
 
+// returns true when the JsonWriter output is the expected text, written the
+// same by cJSON and the TI library
+bool JsonWriter_Test();
+
 #endif
\ No newline at end of file
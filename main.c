@@ -147,6 +147,12 @@ int main(void)
 
 void* mainThread(void* arg)
 {   
+   // the telemetry is encoded by the JsonWriter, check it against the libraries
+   if (!JsonWriter_Test())
+   {
+      UART_PRINT("JsonWriter test failed\n");
+   }
+   
    /* Initializes the SPI interface to the Network
       Processor and peripheral SPI (if defined in the board file) */
    //WiFi_init();
@@ -179,9 +185,12 @@ void* mainThread(void* arg)
             {
                // TODO: ping Polka Palace every 10ish seconds
                //WiFiDriver_Send(TEST_MQTT);
+               // blocks, waking only for MQTT traffic, queued events and
+               // keepalives, until the MQTT session is lost
                AWSDriver_Run(NULL);
             
-               // flash LED 1 indicating the ping went out.
+               // flash LED 1 indicating the session ended, pause for a beat
+               // before starting a new one.
                bsp_board_led_invert(BSP_BOARD_LED_1);
                usleep(100000 - 1);
                taskYIELD();
@@ -2,6 +2,8 @@
 #include <stdint.h>
 
 #include <ti/drivers/net/wifi/simplelink.h>
+#include <ti/net/slnetif.h>
+#include <ti/net/slnetsock.h>
 
 #include <pthread.h>
 #include <mqueue.h>
@@ -477,7 +479,30 @@ void SimpleLinkGeneralEventHandler(SlDeviceEvent_t *pDevEvent)
  */
 void SimpleLinkSockEventHandler(SlSockEvent_t *pSock)
 {
-    /* Unused in this application */
+    /* Push failures of a socket to its SlNetSock poll sets, so the task
+       waiting on it finds out without waiting for its next select. The NWP
+       is the SLNETIF_ID_1 interface added by WiFiDriver */
+    switch(pSock->Event)
+    {
+    case SL_SOCKET_TX_FAILED_EVENT:
+        SlNetSock_pollNotifyIf(SLNETIF_ID_1,
+                               pSock->SocketAsyncEvent.SockTxFailData.Sd,
+                               SLNETSOCK_POLL_ERR);
+        break;
+
+    case SL_SOCKET_ASYNC_EVENT:
+        if(pSock->SocketAsyncEvent.SockAsyncData.Type !=
+           SL_SSL_NOTIFICATION_CONNECTED_SECURED)
+        {
+            SlNetSock_pollNotifyIf(SLNETIF_ID_1,
+                                   pSock->SocketAsyncEvent.SockAsyncData.Sd,
+                                   SLNETSOCK_POLL_ERR);
+        }
+        break;
+
+    default:
+        break;
+    }
 }
 
 /*!
@@ -0,0 +1,1480 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/*****************************************************************************/
+/* Include files                                                             */
+/*****************************************************************************/
+
+/* RTLD_NEXT                                                                 */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <ifaddrs.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include <ti/drivers/net/posix/slnetifposix.h>
+
+/*****************************************************************************/
+/* Macro declarations                                                        */
+/*****************************************************************************/
+
+/* Look up a host call past the executable, so that a ti/net/bsd function
+   of the same name doesn't shadow it                                        */
+#define SLNETIFPOSIX_RESOLVE(fxn)   (NULL != (*(void **)&HostCalls.fxn = dlsym(RTLD_NEXT, #fxn)))
+
+#define SLNETIFPOSIX_MAX_HOST_NAME  (256)
+
+/* Parameters of the SlNetIf_Config_t calls the host has no use for          */
+#define SLNETIFPOSIX_UNUSED(arg)    ((void)(arg))
+
+/*****************************************************************************/
+/* Structure/Enum declarations                                               */
+/*****************************************************************************/
+
+/* Interface data                                                            */
+typedef struct SlNetIfPosix_Context_t
+{
+    const char        *ifName;          /* host network device              */
+    volatile int32_t   connectionStatus;
+    volatile uint32_t  delayUsec;       /* added to each connect, send and
+                                           receive of its sockets           */
+} SlNetIfPosix_Context_t;
+
+/* Host socket calls                                                         */
+typedef struct SlNetIfPosix_HostCalls_t
+{
+    int     (*socket)      (int domain, int type, int protocol);
+    int     (*close)       (int fd);
+    int     (*shutdown)    (int fd, int how);
+    int     (*accept)      (int fd, struct sockaddr *addr, socklen_t *addrlen);
+    int     (*bind)        (int fd, const struct sockaddr *addr, socklen_t addrlen);
+    int     (*listen)      (int fd, int backlog);
+    int     (*connect)     (int fd, const struct sockaddr *addr, socklen_t addrlen);
+    int     (*getpeername) (int fd, struct sockaddr *addr, socklen_t *addrlen);
+    int     (*getsockname) (int fd, struct sockaddr *addr, socklen_t *addrlen);
+    int     (*setsockopt)  (int fd, int level, int optname, const void *optval, socklen_t optlen);
+    int     (*getsockopt)  (int fd, int level, int optname, void *optval, socklen_t *optlen);
+    ssize_t (*recvfrom)    (int fd, void *buf, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen);
+    ssize_t (*sendto)      (int fd, const void *buf, size_t len, int flags, const struct sockaddr *to, socklen_t tolen);
+    int     (*poll)        (struct pollfd *fds, nfds_t nfds, int timeout);
+    int     (*fcntl)       (int fd, int cmd, ...);
+    int     (*getaddrinfo) (const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res);
+    void    (*freeaddrinfo)(struct addrinfo *res);
+} SlNetIfPosix_HostCalls_t;
+
+/* How an option value is translated between SlNetSock and the host         */
+typedef enum
+{
+    SLNETIFPOSIX_OPT_INT,               /* uint32_t or int, host int        */
+    SLNETIFPOSIX_OPT_UINT8,
+    SLNETIFPOSIX_OPT_TIMEVAL,           /* same type on both sides          */
+    SLNETIFPOSIX_OPT_LINGER,
+    SLNETIFPOSIX_OPT_MREQ,
+    SLNETIFPOSIX_OPT_NONBLOCK,          /* fcntl O_NONBLOCK                 */
+    SLNETIFPOSIX_OPT_ERROR              /* read only, SLNETERR_BSD_ code    */
+} SlNetIfPosix_OptType_e;
+
+typedef struct SlNetIfPosix_Opt_t
+{
+    int16_t                level;
+    int16_t                optname;
+    int                    hostLevel;
+    int                    hostOptname;
+    SlNetIfPosix_OptType_e type;
+    SlNetSocklen_t         optlen;      /* SlNetSock value size             */
+} SlNetIfPosix_Opt_t;
+
+/*****************************************************************************/
+/* Global declarations                                                       */
+/*****************************************************************************/
+
+/*!
+    SlNetIfConfigPosix structure contains all the function callbacks that are expected to be filled by the relevant network stack interface
+    Each interface has different capabilities, so not all the API's must be supported.
+    Interface that is not supporting a non-mandatory API are set to NULL
+*/
+SlNetIf_Config_t SlNetIfConfigPosix =
+{
+    SlNetIfPosix_socket,              // Callback function sockCreate in slnetif module
+    SlNetIfPosix_close,               // Callback function sockClose in slnetif module
+    SlNetIfPosix_shutdown,            // Callback function sockShutdown in slnetif module
+    SlNetIfPosix_accept,              // Callback function sockAccept in slnetif module
+    SlNetIfPosix_bind,                // Callback function sockBind in slnetif module
+    SlNetIfPosix_listen,              // Callback function sockListen in slnetif module
+    SlNetIfPosix_connect,             // Callback function sockConnect in slnetif module
+    SlNetIfPosix_getPeerName,         // Callback function sockGetPeerName in slnetif module
+    SlNetIfPosix_getSockName,         // Callback function sockGetLocalName in slnetif module
+    SlNetIfPosix_select,              // Callback function sockSelect in slnetif module
+    SlNetIfPosix_setSockOpt,          // Callback function sockSetOpt in slnetif module
+    SlNetIfPosix_getSockOpt,          // Callback function sockGetOpt in slnetif module
+    SlNetIfPosix_recv,                // Callback function sockRecv in slnetif module
+    SlNetIfPosix_recvFrom,            // Callback function sockRecvFrom in slnetif module
+    SlNetIfPosix_send,                // Callback function sockSend in slnetif module
+    SlNetIfPosix_sendTo,              // Callback function sockSendTo in slnetif module
+#if SLNETIFPOSIX_TLS_STANDIN
+    SlNetIfPosix_sockstartSec,        // Callback function sockstartSec in slnetif module
+#else
+    NULL,                             // Callback function sockstartSec in slnetif module
+#endif
+    SlNetIfPosix_getHostByName,       // Callback function utilGetHostByName in slnetif module
+    SlNetIfPosix_getIPAddr,           // Callback function ifGetIPAddr in slnetif module
+    SlNetIfPosix_getConnectionStatus, // Callback function ifGetConnectionStatus in slnetif module
+#if SLNETIFPOSIX_TLS_STANDIN
+    SlNetIfPosix_loadSecObj,          // Callback function ifLoadSecObj in slnetif module
+#else
+    NULL,                             // Callback function ifLoadSecObj in slnetif module
+#endif
+    SlNetIfPosix_CreateContext        // Callback function ifCreateContext in slnetif module
+};
+
+static const SlNetIfPosix_Opt_t SockOpts[] =
+{
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_RCV_BUF,        SOL_SOCKET,  SO_RCVBUF,          SLNETIFPOSIX_OPT_INT,      sizeof(SlNetSock_Winsize_t)     },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_SND_BUF,        SOL_SOCKET,  SO_SNDBUF,          SLNETIFPOSIX_OPT_INT,      sizeof(int32_t)                 },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_RCV_TIMEO,      SOL_SOCKET,  SO_RCVTIMEO,        SLNETIFPOSIX_OPT_TIMEVAL,  sizeof(SlNetSock_Timeval_t)     },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_SND_TIMEO,      SOL_SOCKET,  SO_SNDTIMEO,        SLNETIFPOSIX_OPT_TIMEVAL,  sizeof(SlNetSock_Timeval_t)     },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_KEEPALIVE,      SOL_SOCKET,  SO_KEEPALIVE,       SLNETIFPOSIX_OPT_INT,      sizeof(SlNetSock_Keepalive_t)   },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_KEEPALIVE_TIME, IPPROTO_TCP, TCP_KEEPIDLE,       SLNETIFPOSIX_OPT_INT,      sizeof(uint32_t)                },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_LINGER,         SOL_SOCKET,  SO_LINGER,          SLNETIFPOSIX_OPT_LINGER,   sizeof(SlNetSock_linger_t)      },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_NON_BLOCKING,   0,           0,                  SLNETIFPOSIX_OPT_NONBLOCK, sizeof(SlNetSock_Nonblocking_t) },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_ERROR,          SOL_SOCKET,  SO_ERROR,           SLNETIFPOSIX_OPT_ERROR,    sizeof(int32_t)                 },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_BROADCAST,      SOL_SOCKET,  SO_BROADCAST,       SLNETIFPOSIX_OPT_INT,      sizeof(SlNetSock_Broadcast_t)   },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_REUSEADDR,      SOL_SOCKET,  SO_REUSEADDR,       SLNETIFPOSIX_OPT_INT,      sizeof(int32_t)                 },
+    { SLNETSOCK_LVL_SOCKET, SLNETSOCK_OPSOCK_REUSEPORT,      SOL_SOCKET,  SO_REUSEPORT,       SLNETIFPOSIX_OPT_INT,      sizeof(int32_t)                 },
+    { SLNETSOCK_LVL_IP,     SLNETSOCK_OPIP_MULTICAST_TTL,    IPPROTO_IP,  IP_MULTICAST_TTL,   SLNETIFPOSIX_OPT_UINT8,    sizeof(uint8_t)                 },
+    { SLNETSOCK_LVL_IP,     SLNETSOCK_OPIP_ADD_MEMBERSHIP,   IPPROTO_IP,  IP_ADD_MEMBERSHIP,  SLNETIFPOSIX_OPT_MREQ,     sizeof(SlNetSock_IpMreq_t)      },
+    { SLNETSOCK_LVL_IP,     SLNETSOCK_OPIP_DROP_MEMBERSHIP,  IPPROTO_IP,  IP_DROP_MEMBERSHIP, SLNETIFPOSIX_OPT_MREQ,     sizeof(SlNetSock_IpMreq_t)      }
+};
+
+static SlNetIfPosix_HostCalls_t HostCalls;
+static pthread_once_t           HostInitOnce = PTHREAD_ONCE_INIT;
+static bool                     HostInitialized = false;
+
+/* Host descriptors by real sd, -1 when free, the interface of each, and the
+   stack of free real sd                                                     */
+static int                     HostSockets[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+static SlNetIfPosix_Context_t *HostSocketsIf[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+static int16_t                 HostSocketsFree[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+static uint16_t                HostSocketsFreeTop;
+static pthread_mutex_t         HostSocketsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************/
+/* Function prototypes                                                       */
+/*****************************************************************************/
+
+//*****************************************************************************
+//
+// SlNetIfPosix_hostInit - Resolve the host calls and empty the socket table
+//
+//*****************************************************************************
+static void SlNetIfPosix_hostInit(void)
+{
+    int16_t sd = SLNETSOCK_MAX_CONCURRENT_SOCKETS;
+
+    HostInitialized = SLNETIFPOSIX_RESOLVE(socket)      &&
+                      SLNETIFPOSIX_RESOLVE(close)       &&
+                      SLNETIFPOSIX_RESOLVE(shutdown)    &&
+                      SLNETIFPOSIX_RESOLVE(accept)      &&
+                      SLNETIFPOSIX_RESOLVE(bind)        &&
+                      SLNETIFPOSIX_RESOLVE(listen)      &&
+                      SLNETIFPOSIX_RESOLVE(connect)     &&
+                      SLNETIFPOSIX_RESOLVE(getpeername) &&
+                      SLNETIFPOSIX_RESOLVE(getsockname) &&
+                      SLNETIFPOSIX_RESOLVE(setsockopt)  &&
+                      SLNETIFPOSIX_RESOLVE(getsockopt)  &&
+                      SLNETIFPOSIX_RESOLVE(recvfrom)    &&
+                      SLNETIFPOSIX_RESOLVE(sendto)      &&
+                      SLNETIFPOSIX_RESOLVE(poll)        &&
+                      SLNETIFPOSIX_RESOLVE(fcntl)       &&
+                      SLNETIFPOSIX_RESOLVE(getaddrinfo) &&
+                      SLNETIFPOSIX_RESOLVE(freeaddrinfo);
+
+    /* Stack the real sd so that the lowest is allocated first               */
+    HostSocketsFreeTop = 0;
+    while (sd--)
+    {
+        HostSockets[sd] = -1;
+        HostSocketsFree[HostSocketsFreeTop++] = sd;
+    }
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_errorCode - Translate a host errno into a SLNETERR_BSD_ code
+//
+//*****************************************************************************
+static int32_t SlNetIfPosix_errorCode(int error)
+{
+    switch (error)
+    {
+        case ENXIO:           return SLNETERR_BSD_ENXIO;
+        case EBADF:           return SLNETERR_BSD_EBADF;
+        case EMFILE:
+        case ENFILE:          return SLNETERR_BSD_ENSOCK;
+        case EINTR:
+        case EAGAIN:          return SLNETERR_BSD_EAGAIN;
+        case ENOMEM:          return SLNETERR_BSD_ENOMEM;
+        case EPERM:
+        case EACCES:          return SLNETERR_BSD_EACCES;
+        case EFAULT:          return SLNETERR_BSD_EFAULT;
+        case EINVAL:          return SLNETERR_BSD_EINVAL;
+        case ENOTSOCK:        return SLNETERR_BSD_ENOTSOCK;
+        case EDESTADDRREQ:    return SLNETERR_BSD_EDESTADDRREQ;
+        case EMSGSIZE:        return SLNETERR_BSD_EMSGSIZE;
+        case EPROTOTYPE:      return SLNETERR_BSD_EPROTOTYPE;
+        case ENOPROTOOPT:     return SLNETERR_BSD_ENOPROTOOPT;
+        case EPROTONOSUPPORT: return SLNETERR_BSD_EPROTONOSUPPORT;
+        case ESOCKTNOSUPPORT: return SLNETERR_BSD_ESOCKTNOSUPPORT;
+        case EOPNOTSUPP:      return SLNETERR_BSD_EOPNOTSUPP;
+        case EAFNOSUPPORT:    return SLNETERR_BSD_EAFNOSUPPORT;
+        case EADDRINUSE:      return SLNETERR_BSD_EADDRINUSE;
+        case EADDRNOTAVAIL:   return SLNETERR_BSD_EADDRNOTAVAIL;
+        case ENETDOWN:        return SLNETERR_BSD_ENETDOWN;
+        case ENETUNREACH:     return SLNETERR_BSD_ENETUNREACH;
+        case ECONNABORTED:    return SLNETERR_BSD_ECONNABORTED;
+        case ECONNRESET:      return SLNETERR_BSD_ECONNRESET;
+        case ENOBUFS:         return SLNETERR_BSD_ENOBUFS;
+        case EISCONN:         return SLNETERR_BSD_EISCONN;
+        case ENOTCONN:        return SLNETERR_BSD_ENOTCONN;
+        case EPIPE:
+        case ESHUTDOWN:       return SLNETERR_BSD_ESHUTDOWN;
+        case ETIMEDOUT:       return SLNETERR_BSD_ETIMEDOUT;
+        case ECONNREFUSED:    return SLNETERR_BSD_ECONNREFUSED;
+        case EHOSTDOWN:       return SLNETERR_BSD_EHOSTDOWN;
+        case EHOSTUNREACH:    return SLNETERR_BSD_EHOSTUNREACH;
+        /* A non blocking connect is reported in progress as on the NWP     */
+        case EINPROGRESS:
+        case EALREADY:        return SLNETERR_BSD_EALREADY;
+        default:              return SLNETERR_RET_CODE_FUNCTION_FAILED;
+    }
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_hostSd - Return the host descriptor of a real sd, or -1
+//
+//*****************************************************************************
+static int SlNetIfPosix_hostSd(int16_t sd)
+{
+    if ( (sd < 0) || (sd >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) )
+    {
+        return -1;
+    }
+    return HostSockets[sd];
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_allocSd - Give a host descriptor of an interface a real sd
+//
+//*****************************************************************************
+static int16_t SlNetIfPosix_allocSd(int fd, SlNetIfPosix_Context_t *context)
+{
+    int16_t sd = SLNETERR_BSD_ENSOCK;
+
+    pthread_mutex_lock(&HostSocketsLock);
+
+    if (HostSocketsFreeTop > 0)
+    {
+        sd = HostSocketsFree[--HostSocketsFreeTop];
+        HostSockets[sd]   = fd;
+        HostSocketsIf[sd] = context;
+    }
+
+    pthread_mutex_unlock(&HostSocketsLock);
+
+    return sd;
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_freeSd - Return a real sd to the free stack
+//
+//*****************************************************************************
+static void SlNetIfPosix_freeSd(int16_t sd)
+{
+    pthread_mutex_lock(&HostSocketsLock);
+
+    if (HostSockets[sd] >= 0)
+    {
+        HostSockets[sd]   = -1;
+        HostSocketsIf[sd] = NULL;
+        HostSocketsFree[HostSocketsFreeTop++] = sd;
+    }
+
+    pthread_mutex_unlock(&HostSocketsLock);
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_delay - Hold a call on a real sd for the delay of its
+//                      interface, a slower link
+//
+//*****************************************************************************
+static void SlNetIfPosix_delay(int16_t sd)
+{
+    SlNetIfPosix_Context_t *context = HostSocketsIf[sd];
+
+    if ( (NULL != context) && (0 != context->delayUsec) )
+    {
+        usleep(context->delayUsec);
+    }
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_msgFlags - Translate SLNETSOCK_MSG_ flags into host flags,
+//                         the security bits in the upper byte are dropped
+//
+//*****************************************************************************
+static int SlNetIfPosix_msgFlags(uint32_t flags)
+{
+    /* A peer closing must not raise SIGPIPE in the host process             */
+    int hostFlags = MSG_NOSIGNAL;
+
+    if (flags & SLNETSOCK_MSG_OOB)       hostFlags |= MSG_OOB;
+    if (flags & SLNETSOCK_MSG_PEEK)      hostFlags |= MSG_PEEK;
+    if (flags & SLNETSOCK_MSG_WAITALL)   hostFlags |= MSG_WAITALL;
+    if (flags & SLNETSOCK_MSG_DONTWAIT)  hostFlags |= MSG_DONTWAIT;
+    if (flags & SLNETSOCK_MSG_DONTROUTE) hostFlags |= MSG_DONTROUTE;
+
+    return hostFlags;
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_toHostAddr - Translate a SlNetSock address into a host one
+//
+//*****************************************************************************
+static int32_t SlNetIfPosix_toHostAddr(const SlNetSock_Addr_t *addr, SlNetSocklen_t addrlen, struct sockaddr_storage *hostAddr, socklen_t *hostAddrlen)
+{
+    memset(hostAddr, 0, sizeof(*hostAddr));
+
+    if (NULL == addr)
+    {
+        return SLNETERR_BSD_EFAULT;
+    }
+
+    if ( (SLNETSOCK_AF_INET == addr->sa_family) && (addrlen >= sizeof(SlNetSock_AddrIn_t)) )
+    {
+        const SlNetSock_AddrIn_t *in     = (const SlNetSock_AddrIn_t *)addr;
+        struct sockaddr_in       *hostIn = (struct sockaddr_in *)hostAddr;
+
+        /* Port and address are in network order on both sides               */
+        hostIn->sin_family      = AF_INET;
+        hostIn->sin_port        = in->sin_port;
+        hostIn->sin_addr.s_addr = in->sin_addr.s_addr;
+        *hostAddrlen            = sizeof(struct sockaddr_in);
+    }
+    else if ( (SLNETSOCK_AF_INET6 == addr->sa_family) && (addrlen >= sizeof(SlNetSock_AddrIn6_t)) )
+    {
+        const SlNetSock_AddrIn6_t *in6     = (const SlNetSock_AddrIn6_t *)addr;
+        struct sockaddr_in6       *hostIn6 = (struct sockaddr_in6 *)hostAddr;
+
+        hostIn6->sin6_family   = AF_INET6;
+        hostIn6->sin6_port     = in6->sin6_port;
+        hostIn6->sin6_flowinfo = in6->sin6_flowinfo;
+        hostIn6->sin6_scope_id = in6->sin6_scope_id;
+        memcpy(&hostIn6->sin6_addr, &in6->sin6_addr, sizeof(hostIn6->sin6_addr));
+        *hostAddrlen           = sizeof(struct sockaddr_in6);
+    }
+    else if ( (SLNETSOCK_AF_INET == addr->sa_family) || (SLNETSOCK_AF_INET6 == addr->sa_family) )
+    {
+        return SLNETERR_BSD_EINVAL;
+    }
+    else
+    {
+        return SLNETERR_BSD_EAFNOSUPPORT;
+    }
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_fromHostAddr - Translate a host address into a SlNetSock one,
+//                             truncated to *addrlen as BSD sockets do
+//
+//*****************************************************************************
+static void SlNetIfPosix_fromHostAddr(const struct sockaddr_storage *hostAddr, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen)
+{
+    union
+    {
+        SlNetSock_AddrIn_t  in;
+        SlNetSock_AddrIn6_t in6;
+    } sockAddr;
+    SlNetSocklen_t sockAddrlen;
+
+    if ( (NULL == addr) || (NULL == addrlen) )
+    {
+        return;
+    }
+
+    memset(&sockAddr, 0, sizeof(sockAddr));
+
+    if (AF_INET == hostAddr->ss_family)
+    {
+        const struct sockaddr_in *hostIn = (const struct sockaddr_in *)hostAddr;
+
+        sockAddr.in.sin_family      = SLNETSOCK_AF_INET;
+        sockAddr.in.sin_port        = hostIn->sin_port;
+        sockAddr.in.sin_addr.s_addr = hostIn->sin_addr.s_addr;
+        sockAddrlen                 = sizeof(SlNetSock_AddrIn_t);
+    }
+    else if (AF_INET6 == hostAddr->ss_family)
+    {
+        const struct sockaddr_in6 *hostIn6 = (const struct sockaddr_in6 *)hostAddr;
+
+        sockAddr.in6.sin6_family   = SLNETSOCK_AF_INET6;
+        sockAddr.in6.sin6_port     = hostIn6->sin6_port;
+        sockAddr.in6.sin6_flowinfo = hostIn6->sin6_flowinfo;
+        sockAddr.in6.sin6_scope_id = hostIn6->sin6_scope_id;
+        memcpy(&sockAddr.in6.sin6_addr, &hostIn6->sin6_addr, sizeof(sockAddr.in6.sin6_addr));
+        sockAddrlen                = sizeof(SlNetSock_AddrIn6_t);
+    }
+    else
+    {
+        sockAddr.in.sin_family = SLNETSOCK_AF_UNSPEC;
+        sockAddrlen            = sizeof(SlNetSock_Addr_t);
+    }
+
+    memcpy(addr, &sockAddr, (*addrlen < sockAddrlen) ? *addrlen : sockAddrlen);
+    *addrlen = sockAddrlen;
+}
+
+//*****************************************************************************
+//
+// SlNetIfPosix_findOpt - Search the option translation table
+//
+//*****************************************************************************
+static const SlNetIfPosix_Opt_t *SlNetIfPosix_findOpt(int16_t level, int16_t optname)
+{
+    uint16_t i;
+
+    for (i = 0; i < sizeof(SockOpts) / sizeof(SockOpts[0]); i++)
+    {
+        if ( (SockOpts[i].level == level) && (SockOpts[i].optname == optname) )
+        {
+            return &SockOpts[i];
+        }
+    }
+    return NULL;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_socket - Create an endpoint for communication
+//
+//*****************************************************************************
+int16_t SlNetIfPosix_socket(void *ifContext, int16_t Domain, int16_t Type, int16_t Protocol, void **sdContext)
+{
+    int     hostDomain;
+    int     hostType;
+    int     hostProtocol;
+    int     fd;
+    int     one = 1;
+    int16_t sd;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (false == HostInitialized)
+    {
+        return SLNETERR_RET_CODE_FUNCTION_FAILED;
+    }
+
+    switch (Domain)
+    {
+        case SLNETSOCK_AF_INET:  hostDomain = AF_INET;  break;
+        case SLNETSOCK_AF_INET6: hostDomain = AF_INET6; break;
+        default:                 return SLNETERR_BSD_EAFNOSUPPORT;
+    }
+
+    switch (Type)
+    {
+        case SLNETSOCK_SOCK_STREAM: hostType = SOCK_STREAM; break;
+        case SLNETSOCK_SOCK_DGRAM:  hostType = SOCK_DGRAM;  break;
+        case SLNETSOCK_SOCK_RAW:    hostType = SOCK_RAW;    break;
+        default:                    return SLNETERR_BSD_ESOCKTNOSUPPORT;
+    }
+
+    switch (Protocol)
+    {
+        case 0:                    hostProtocol = 0;            break;
+        case SLNETSOCK_PROTO_TCP:  hostProtocol = IPPROTO_TCP;  break;
+        case SLNETSOCK_PROTO_UDP:  hostProtocol = IPPROTO_UDP;  break;
+        case SLNETSOCK_PROTO_RAW:  hostProtocol = IPPROTO_RAW;  break;
+#if SLNETIFPOSIX_TLS_STANDIN
+        /* Secured sockets are plain TCP sockets                             */
+        case SLNETSOCK_PROTO_SECURE: hostProtocol = IPPROTO_TCP; break;
+#endif
+        default:                   return SLNETERR_BSD_EPROTONOSUPPORT;
+    }
+
+    fd = HostCalls.socket(hostDomain, hostType, hostProtocol);
+    if (fd < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    /* The NWP binds a port again as soon as it is closed. Every host socket  */
+    /* is made reusable, for the TIME_WAIT of its connections not to hold up  */
+    /* a later bind() to the same port                                        */
+    HostCalls.setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sd = SlNetIfPosix_allocSd(fd, (SlNetIfPosix_Context_t *)ifContext);
+    if (sd < 0)
+    {
+        HostCalls.close(fd);
+    }
+    return sd;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_close - Gracefully close socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_close(int16_t sd, void *sdContext)
+{
+    int     fd     = SlNetIfPosix_hostSd(sd);
+    int32_t retVal = SLNETERR_RET_CODE_OK;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    if (HostCalls.close(fd) < 0)
+    {
+        retVal = SlNetIfPosix_errorCode(errno);
+    }
+
+    /* The host descriptor is gone whatever close returned                   */
+    SlNetIfPosix_freeSd(sd);
+
+    return retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_shutdown - Shut down part of a full-duplex connection
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_shutdown(int16_t sd, void *sdContext, int16_t how)
+{
+    int fd = SlNetIfPosix_hostSd(sd);
+    int hostHow;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    switch (how)
+    {
+        case SLNETSOCK_SHUT_RD:   hostHow = SHUT_RD;   break;
+        case SLNETSOCK_SHUT_WR:   hostHow = SHUT_WR;   break;
+        case SLNETSOCK_SHUT_RDWR: hostHow = SHUT_RDWR; break;
+        default:                  return SLNETERR_BSD_EINVAL;
+    }
+
+    if (HostCalls.shutdown(fd, hostHow) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_accept - Accept a connection on a socket
+//
+//*****************************************************************************
+int16_t SlNetIfPosix_accept(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen, uint8_t flags, void **acceptedSdContext)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen = sizeof(hostAddr);
+    int                     fd          = SlNetIfPosix_hostSd(sd);
+    int                     acceptedFd;
+    int16_t                 acceptedSd;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+    SLNETIFPOSIX_UNUSED(flags);
+    SLNETIFPOSIX_UNUSED(acceptedSdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    memset(&hostAddr, 0, sizeof(hostAddr));
+    acceptedFd = HostCalls.accept(fd, (struct sockaddr *)&hostAddr, &hostAddrlen);
+    if (acceptedFd < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    /* The accepted socket is on the interface of the listening one          */
+    acceptedSd = SlNetIfPosix_allocSd(acceptedFd, HostSocketsIf[sd]);
+    if (acceptedSd < 0)
+    {
+        HostCalls.close(acceptedFd);
+        return acceptedSd;
+    }
+
+    SlNetIfPosix_fromHostAddr(&hostAddr, addr, addrlen);
+    return acceptedSd;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_bind - Assign a name to a socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_bind(int16_t sd, void *sdContext, const SlNetSock_Addr_t *addr, int16_t addrlen)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen;
+    int                     fd     = SlNetIfPosix_hostSd(sd);
+    int32_t                 retVal;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    retVal = SlNetIfPosix_toHostAddr(addr, addrlen, &hostAddr, &hostAddrlen);
+    if (retVal < SLNETERR_RET_CODE_OK)
+    {
+        return retVal;
+    }
+
+    if (HostCalls.bind(fd, (const struct sockaddr *)&hostAddr, hostAddrlen) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_listen - Listen for connections on a socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_listen(int16_t sd, void *sdContext, int16_t backlog)
+{
+    int fd = SlNetIfPosix_hostSd(sd);
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    if (HostCalls.listen(fd, backlog) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_connect - Initiate a connection on a socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_connect(int16_t sd, void *sdContext, const SlNetSock_Addr_t *addr, SlNetSocklen_t addrlen, uint8_t flags)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen;
+    int                     fd     = SlNetIfPosix_hostSd(sd);
+    int32_t                 retVal;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+    SLNETIFPOSIX_UNUSED(flags);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    retVal = SlNetIfPosix_toHostAddr(addr, addrlen, &hostAddr, &hostAddrlen);
+    if (retVal < SLNETERR_RET_CODE_OK)
+    {
+        return retVal;
+    }
+
+    SlNetIfPosix_delay(sd);
+    if (HostCalls.connect(fd, (const struct sockaddr *)&hostAddr, hostAddrlen) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getPeerName - Return address info about the remote side of
+//                            the connection
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getPeerName(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen = sizeof(hostAddr);
+    int                     fd          = SlNetIfPosix_hostSd(sd);
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    memset(&hostAddr, 0, sizeof(hostAddr));
+    if (HostCalls.getpeername(fd, (struct sockaddr *)&hostAddr, &hostAddrlen) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    SlNetIfPosix_fromHostAddr(&hostAddr, addr, addrlen);
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getSockName - Returns the local address info of the socket
+//                            descriptor
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getSockName(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen = sizeof(hostAddr);
+    int                     fd          = SlNetIfPosix_hostSd(sd);
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    memset(&hostAddr, 0, sizeof(hostAddr));
+    if (HostCalls.getsockname(fd, (struct sockaddr *)&hostAddr, &hostAddrlen) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    SlNetIfPosix_fromHostAddr(&hostAddr, addr, addrlen);
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_select - Monitor socket activity, by a host poll on the host
+//                       descriptors of the sets
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_select(void *ifContext, int16_t nfds, SlNetSock_SdSet_t *readsds, SlNetSock_SdSet_t *writesds, SlNetSock_SdSet_t *exceptsds, SlNetSock_Timeval_t *timeout)
+{
+    struct pollfd fds[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+    int16_t       fdSd[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+    nfds_t        fdsCount  = 0;
+    int           timeoutMs = -1;
+    int32_t       retVal    = 0;
+    int16_t       sd;
+    nfds_t        i;
+
+    SLNETIFPOSIX_UNUSED(ifContext);
+
+    if (nfds > SLNETSOCK_MAX_CONCURRENT_SOCKETS)
+    {
+        nfds = SLNETSOCK_MAX_CONCURRENT_SOCKETS;
+    }
+
+    /* Collect the host descriptors of the sockets set                       */
+    for (sd = 0; sd < nfds; sd++)
+    {
+        short events = 0;
+
+        if ( (NULL != readsds) && (1 == SlNetSock_sdsIsSet(sd, readsds)) )
+        {
+            events |= POLLIN;
+        }
+        if ( (NULL != writesds) && (1 == SlNetSock_sdsIsSet(sd, writesds)) )
+        {
+            events |= POLLOUT;
+        }
+        if ( (NULL != exceptsds) && (1 == SlNetSock_sdsIsSet(sd, exceptsds)) )
+        {
+            events |= POLLPRI;
+        }
+
+        if (0 != events)
+        {
+            fds[fdsCount].fd      = SlNetIfPosix_hostSd(sd);
+            fds[fdsCount].events  = events;
+            fds[fdsCount].revents = 0;
+            fdSd[fdsCount]        = sd;
+
+            if (fds[fdsCount].fd < 0)
+            {
+                return SLNETERR_BSD_EBADF;
+            }
+            fdsCount++;
+        }
+    }
+
+    /* A NULL timeout blocks, otherwise round up to the next millisecond     */
+    if (NULL != timeout)
+    {
+        timeoutMs = (int)(timeout->tv_sec * 1000) + (int)((timeout->tv_usec + 999) / 1000);
+    }
+
+    if (HostCalls.poll(fds, fdsCount, timeoutMs) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    if (NULL != readsds)   SlNetSock_sdsClrAll(readsds);
+    if (NULL != writesds)  SlNetSock_sdsClrAll(writesds);
+    if (NULL != exceptsds) SlNetSock_sdsClrAll(exceptsds);
+
+    /* Like select, a hang up or error makes the socket readable and
+       writable so that the next call reports it, count each set bit         */
+    for (i = 0; i < fdsCount; i++)
+    {
+        short revents = fds[i].revents;
+
+        if ( (fds[i].events & POLLIN) && (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) )
+        {
+            SlNetSock_sdsSet(fdSd[i], readsds);
+            retVal++;
+        }
+        if ( (fds[i].events & POLLOUT) && (revents & (POLLOUT | POLLHUP | POLLERR | POLLNVAL)) )
+        {
+            SlNetSock_sdsSet(fdSd[i], writesds);
+            retVal++;
+        }
+        if ( (fds[i].events & POLLPRI) && (revents & POLLPRI) )
+        {
+            SlNetSock_sdsSet(fdSd[i], exceptsds);
+            retVal++;
+        }
+    }
+
+    return retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_setSockOpt - Set socket options
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_setSockOpt(int16_t sd, void *sdContext, int16_t level, int16_t optname, void *optval, SlNetSocklen_t optlen)
+{
+    const SlNetIfPosix_Opt_t *opt = SlNetIfPosix_findOpt(level, optname);
+    int                       fd  = SlNetIfPosix_hostSd(sd);
+    int                       status;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+    if (NULL == opt)
+    {
+        return SLNETERR_BSD_ENOPROTOOPT;
+    }
+    if ( (NULL == optval) || (optlen < opt->optlen) )
+    {
+        return SLNETERR_BSD_EINVAL;
+    }
+
+    switch (opt->type)
+    {
+        case SLNETIFPOSIX_OPT_INT:
+        {
+            int32_t value;
+            int     hostValue;
+
+            memcpy(&value, optval, sizeof(value));
+            hostValue = value;
+            status = HostCalls.setsockopt(fd, opt->hostLevel, opt->hostOptname, &hostValue, sizeof(hostValue));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_UINT8:
+        {
+            unsigned char hostValue = *(uint8_t *)optval;
+
+            status = HostCalls.setsockopt(fd, opt->hostLevel, opt->hostOptname, &hostValue, sizeof(hostValue));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_TIMEVAL:
+        {
+            status = HostCalls.setsockopt(fd, opt->hostLevel, opt->hostOptname, optval, sizeof(struct timeval));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_LINGER:
+        {
+            SlNetSock_linger_t *linger = (SlNetSock_linger_t *)optval;
+            struct linger       hostLinger;
+
+            hostLinger.l_onoff  = linger->l_onoff;
+            hostLinger.l_linger = linger->l_linger;
+            status = HostCalls.setsockopt(fd, opt->hostLevel, opt->hostOptname, &hostLinger, sizeof(hostLinger));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_MREQ:
+        {
+            SlNetSock_IpMreq_t *mreq = (SlNetSock_IpMreq_t *)optval;
+            struct ip_mreq      hostMreq;
+
+            hostMreq.imr_multiaddr.s_addr = mreq->imr_multiaddr.s_addr;
+            hostMreq.imr_interface.s_addr = mreq->imr_interface;
+            status = HostCalls.setsockopt(fd, opt->hostLevel, opt->hostOptname, &hostMreq, sizeof(hostMreq));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_NONBLOCK:
+        {
+            SlNetSock_Nonblocking_t *nonBlocking = (SlNetSock_Nonblocking_t *)optval;
+            int                      fileFlags   = HostCalls.fcntl(fd, F_GETFL, 0);
+
+            status = fileFlags;
+            if (fileFlags >= 0)
+            {
+                fileFlags = nonBlocking->nonBlockingEnabled ? (fileFlags | O_NONBLOCK) : (fileFlags & ~O_NONBLOCK);
+                status = HostCalls.fcntl(fd, F_SETFL, fileFlags);
+            }
+            break;
+        }
+        default:
+            /* Read only option                                              */
+            return SLNETERR_BSD_EINVAL;
+    }
+
+    if (status < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getSockOpt - Get socket options
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getSockOpt(int16_t sd, void *sdContext, int16_t level, int16_t optname, void *optval, SlNetSocklen_t *optlen)
+{
+    const SlNetIfPosix_Opt_t *opt = SlNetIfPosix_findOpt(level, optname);
+    int                       fd  = SlNetIfPosix_hostSd(sd);
+    int                       status;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+    if (NULL == opt)
+    {
+        return SLNETERR_BSD_ENOPROTOOPT;
+    }
+    if ( (NULL == optval) || (NULL == optlen) || (*optlen < opt->optlen) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    switch (opt->type)
+    {
+        case SLNETIFPOSIX_OPT_INT:
+        case SLNETIFPOSIX_OPT_ERROR:
+        {
+            int       hostValue    = 0;
+            socklen_t hostValuelen = sizeof(hostValue);
+            int32_t   value;
+
+            status = HostCalls.getsockopt(fd, opt->hostLevel, opt->hostOptname, &hostValue, &hostValuelen);
+            value  = hostValue;
+            if ( (SLNETIFPOSIX_OPT_ERROR == opt->type) && (0 != hostValue) )
+            {
+                value = SlNetIfPosix_errorCode(hostValue);
+            }
+            memcpy(optval, &value, sizeof(value));
+            break;
+        }
+        case SLNETIFPOSIX_OPT_UINT8:
+        {
+            unsigned char hostValue    = 0;
+            socklen_t     hostValuelen = sizeof(hostValue);
+
+            status = HostCalls.getsockopt(fd, opt->hostLevel, opt->hostOptname, &hostValue, &hostValuelen);
+            *(uint8_t *)optval = hostValue;
+            break;
+        }
+        case SLNETIFPOSIX_OPT_TIMEVAL:
+        {
+            socklen_t hostValuelen = sizeof(struct timeval);
+
+            status = HostCalls.getsockopt(fd, opt->hostLevel, opt->hostOptname, optval, &hostValuelen);
+            break;
+        }
+        case SLNETIFPOSIX_OPT_LINGER:
+        {
+            SlNetSock_linger_t *linger       = (SlNetSock_linger_t *)optval;
+            struct linger       hostLinger   = { 0, 0 };
+            socklen_t           hostValuelen = sizeof(hostLinger);
+
+            status = HostCalls.getsockopt(fd, opt->hostLevel, opt->hostOptname, &hostLinger, &hostValuelen);
+            linger->l_onoff  = hostLinger.l_onoff;
+            linger->l_linger = hostLinger.l_linger;
+            break;
+        }
+        case SLNETIFPOSIX_OPT_NONBLOCK:
+        {
+            SlNetSock_Nonblocking_t *nonBlocking = (SlNetSock_Nonblocking_t *)optval;
+
+            status = HostCalls.fcntl(fd, F_GETFL, 0);
+            nonBlocking->nonBlockingEnabled = (status >= 0) && (status & O_NONBLOCK);
+            break;
+        }
+        default:
+            /* Write only option                                             */
+            return SLNETERR_BSD_EINVAL;
+    }
+
+    if (status < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    *optlen = opt->optlen;
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_recv - Read data from TCP socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_recv(int16_t sd, void *sdContext, void *buf, uint32_t len, uint32_t flags)
+{
+    return SlNetIfPosix_recvFrom(sd, sdContext, buf, len, flags, NULL, NULL);
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_recvFrom - Read data from socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_recvFrom(int16_t sd, void *sdContext, void *buf, uint32_t len, uint32_t flags, SlNetSock_Addr_t *from, SlNetSocklen_t *fromlen)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen = sizeof(hostAddr);
+    int                     fd          = SlNetIfPosix_hostSd(sd);
+    ssize_t                 retVal;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    memset(&hostAddr, 0, sizeof(hostAddr));
+    SlNetIfPosix_delay(sd);
+    retVal = HostCalls.recvfrom(fd, buf, len, SlNetIfPosix_msgFlags(flags), (struct sockaddr *)&hostAddr, &hostAddrlen);
+    if (retVal < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    SlNetIfPosix_fromHostAddr(&hostAddr, from, fromlen);
+    return (int32_t)retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_send - Write data to TCP socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_send(int16_t sd, void *sdContext, const void *buf, uint32_t len, uint32_t flags)
+{
+    int     fd = SlNetIfPosix_hostSd(sd);
+    ssize_t retVal;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    SlNetIfPosix_delay(sd);
+    retVal = HostCalls.sendto(fd, buf, len, SlNetIfPosix_msgFlags(flags), NULL, 0);
+    if (retVal < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return (int32_t)retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_sendTo - Write data to socket
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_sendTo(int16_t sd, void *sdContext, const void *buf, uint32_t len, uint32_t flags, const SlNetSock_Addr_t *to, SlNetSocklen_t tolen)
+{
+    struct sockaddr_storage hostAddr;
+    socklen_t               hostAddrlen;
+    int                     fd = SlNetIfPosix_hostSd(sd);
+    ssize_t                 retVal;
+
+    SLNETIFPOSIX_UNUSED(sdContext);
+
+    if (fd < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    retVal = SlNetIfPosix_toHostAddr(to, tolen, &hostAddr, &hostAddrlen);
+    if (retVal < SLNETERR_RET_CODE_OK)
+    {
+        return (int32_t)retVal;
+    }
+
+    SlNetIfPosix_delay(sd);
+    retVal = HostCalls.sendto(fd, buf, len, SlNetIfPosix_msgFlags(flags), (const struct sockaddr *)&hostAddr, hostAddrlen);
+    if (retVal < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+    return (int32_t)retVal;
+}
+
+
+#if SLNETIFPOSIX_TLS_STANDIN
+//*****************************************************************************
+//
+// SlNetIfPosix_sockstartSec - Start a security session on an opened socket,
+//                             the attributes are dropped and the session
+//                             carries on in plain text
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_sockstartSec(int16_t sd, void *sdContext, SlNetSockSecAttrib_t *secAttrib, uint8_t flags)
+{
+    SLNETIFPOSIX_UNUSED(sdContext);
+    SLNETIFPOSIX_UNUSED(secAttrib);
+    SLNETIFPOSIX_UNUSED(flags);
+
+    if (SlNetIfPosix_hostSd(sd) < 0)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+#endif
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getHostByName - Obtain the IP Address of machine on network,
+//                              by machine name
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getHostByName(void *ifContext, char *name, const uint16_t nameLen, uint32_t *ipAddr, uint16_t *ipAddrLen, const uint8_t family)
+{
+    char             hostName[SLNETIFPOSIX_MAX_HOST_NAME];
+    struct addrinfo  hints;
+    struct addrinfo *results = NULL;
+    struct addrinfo *result;
+    uint16_t         count   = 0;
+    int              status;
+
+    SLNETIFPOSIX_UNUSED(ifContext);
+
+    if ( (NULL == name) || (nameLen >= sizeof(hostName)) || (NULL == ipAddr) || (NULL == ipAddrLen) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    if ( (SLNETSOCK_AF_INET != family) && (SLNETSOCK_AF_INET6 != family) )
+    {
+        return SLNETERR_BSD_EAFNOSUPPORT;
+    }
+    if (false == HostInitialized)
+    {
+        return SLNETERR_RET_CODE_FUNCTION_FAILED;
+    }
+
+    memcpy(hostName, name, nameLen);
+    hostName[nameLen] = '\0';
+
+    /* One result per address                                                */
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = (SLNETSOCK_AF_INET6 == family) ? AF_INET6 : AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    status = HostCalls.getaddrinfo(hostName, NULL, &hints, &results);
+    if (0 != status)
+    {
+        switch (status)
+        {
+            case EAI_NONAME: return SLNETERR_NET_APP_DNS_QUERY_FAILED;
+            case EAI_AGAIN:  return SLNETERR_NET_APP_DNS_QUERY_NO_RESPONSE;
+            default:         return SLNETERR_NET_APP_DNS_ERROR;
+        }
+    }
+
+    /* Addresses are returned in host byte order, IPv4 as one uint32_t and
+       IPv6 as eight uint16_t                                                */
+    for (result = results; (NULL != result) && (count < *ipAddrLen); result = result->ai_next)
+    {
+        if (AF_INET == result->ai_family)
+        {
+            ipAddr[count] = ntohl(((struct sockaddr_in *)result->ai_addr)->sin_addr.s_addr);
+        }
+        else
+        {
+            const uint8_t *bytes = ((struct sockaddr_in6 *)result->ai_addr)->sin6_addr.s6_addr;
+            uint16_t      *words = (uint16_t *)&ipAddr[count * 4];
+            uint8_t        i;
+
+            for (i = 0; i < 8; i++)
+            {
+                words[i] = (uint16_t)((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+            }
+        }
+        count++;
+    }
+
+    HostCalls.freeaddrinfo(results);
+
+    if (0 == count)
+    {
+        return SLNETERR_NET_APP_DNS_QUERY_FAILED;
+    }
+
+    *ipAddrLen = count;
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getIPAddr - Get IP Address of specific interface, the address
+//                          of the host network device named as the interface
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getIPAddr(void *ifContext, SlNetIfAddressType_e addrType, uint16_t *addrConfig, uint32_t *ipAddr)
+{
+    SlNetIfPosix_Context_t *context = (SlNetIfPosix_Context_t *)ifContext;
+    struct ifaddrs         *hostAddrs;
+    struct ifaddrs         *hostAddr;
+    int32_t                 retVal  = SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
+
+    if ( (NULL == context) || (NULL == context->ifName) || (NULL == ipAddr) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    if (getifaddrs(&hostAddrs) < 0)
+    {
+        return SlNetIfPosix_errorCode(errno);
+    }
+
+    for (hostAddr = hostAddrs; NULL != hostAddr; hostAddr = hostAddr->ifa_next)
+    {
+        if ( (NULL == hostAddr->ifa_addr) || (0 != strcmp(hostAddr->ifa_name, context->ifName)) )
+        {
+            continue;
+        }
+
+        if ( (SLNETIF_IPV4_ADDR == addrType) && (AF_INET == hostAddr->ifa_addr->sa_family) )
+        {
+            ipAddr[0] = ntohl(((struct sockaddr_in *)hostAddr->ifa_addr)->sin_addr.s_addr);
+            retVal = SLNETERR_RET_CODE_OK;
+            break;
+        }
+        if ( (SLNETIF_IPV4_ADDR != addrType) && (AF_INET6 == hostAddr->ifa_addr->sa_family) )
+        {
+            const struct in6_addr *in6       = &((struct sockaddr_in6 *)hostAddr->ifa_addr)->sin6_addr;
+            bool                   linkLocal = IN6_IS_ADDR_LINKLOCAL(in6);
+
+            if (linkLocal == (SLNETIF_IPV6_ADDR_LOCAL == addrType))
+            {
+                uint8_t i;
+
+                for (i = 0; i < 4; i++)
+                {
+                    uint32_t word;
+
+                    memcpy(&word, &in6->s6_addr[4 * i], sizeof(word));
+                    ipAddr[i] = ntohl(word);
+                }
+                retVal = SLNETERR_RET_CODE_OK;
+                break;
+            }
+        }
+    }
+
+    freeifaddrs(hostAddrs);
+
+    if ( (SLNETERR_RET_CODE_OK == retVal) && (NULL != addrConfig) )
+    {
+        *addrConfig = SLNETIF_ADDR_CFG_UNKNOWN;
+    }
+    return retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_getConnectionStatus - Get interface connection status
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_getConnectionStatus(void *ifContext)
+{
+    SlNetIfPosix_Context_t *context = (SlNetIfPosix_Context_t *)ifContext;
+
+    if (NULL == context)
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    return context->connectionStatus;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_setConnectionStatus - Set the connection status reported for
+//                                    an interface
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_setConnectionStatus(uint16_t ifID, int32_t status)
+{
+    SlNetIf_t *netIf = SlNetIf_getIfByID(ifID);
+
+    if ( (NULL == netIf) || (&SlNetIfConfigPosix != netIf->ifConf) || (NULL == netIf->ifContext) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    ((SlNetIfPosix_Context_t *)netIf->ifContext)->connectionStatus = status;
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_setDelay - Set the delay added to the socket calls of an
+//                         interface
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_setDelay(uint16_t ifID, uint32_t delayUsec)
+{
+    SlNetIf_t *netIf = SlNetIf_getIfByID(ifID);
+
+    if ( (NULL == netIf) || (&SlNetIfConfigPosix != netIf->ifConf) || (NULL == netIf->ifContext) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    ((SlNetIfPosix_Context_t *)netIf->ifContext)->delayUsec = delayUsec;
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+#if SLNETIFPOSIX_TLS_STANDIN
+//*****************************************************************************
+//
+// SlNetIfPosix_loadSecObj - Load secured buffer to the network stack, the
+//                           stand in has no use for it
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_loadSecObj(void *ifContext, uint16_t objType, char *objName, int16_t objNameLen, uint8_t *objBuff, int16_t objBuffLen)
+{
+    SLNETIFPOSIX_UNUSED(ifContext);
+    SLNETIFPOSIX_UNUSED(objType);
+    SLNETIFPOSIX_UNUSED(objNameLen);
+    SLNETIFPOSIX_UNUSED(objBuffLen);
+
+    if ((NULL == objName) || (NULL == objBuff))
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    return SLNETERR_RET_CODE_OK;
+}
+#endif
+
+
+//*****************************************************************************
+//
+// SlNetIfPosix_CreateContext - Allocate and store interface data
+//
+//*****************************************************************************
+int32_t SlNetIfPosix_CreateContext(uint16_t ifID, const char *ifName, void **ifContext)
+{
+    SlNetIfPosix_Context_t *context;
+
+    SLNETIFPOSIX_UNUSED(ifID);
+
+    pthread_once(&HostInitOnce, SlNetIfPosix_hostInit);
+    if (false == HostInitialized)
+    {
+        return SLNETERR_RET_CODE_FUNCTION_FAILED;
+    }
+
+    context = (SlNetIfPosix_Context_t *)calloc(1, sizeof(SlNetIfPosix_Context_t));
+    if (NULL == context)
+    {
+        return SLNETERR_RET_CODE_MALLOC_ERROR;
+    }
+
+    /* SlNetIf keeps its copy of the name for the life of the interface      */
+    context->ifName           = ifName;
+    context->connectionStatus = SLNETIF_STATUS_CONNECTED;
+
+    *ifContext = context;
+    return SLNETERR_RET_CODE_OK;
+}
@@ -0,0 +1,171 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/*****************************************************************************/
+/* Include files                                                             */
+/*****************************************************************************/
+#include <ti/net/slnetsock.h>
+#include <ti/net/slnetif.h>
+#include <ti/net/slneterr.h>
+#include <ti/net/slnetutils.h>
+
+#ifndef __SLNETIFPOSIX_H__
+#define __SLNETIFPOSIX_H__
+
+#ifdef    __cplusplus
+extern "C" {
+#endif
+
+/*!
+    \defgroup POSIX Socket Stack
+    \short SlNetIf interface backed by the BSD sockets of a POSIX host
+
+    Lets SlNetSock, ti/net/bsd, the MQTT client and the AWS network_sl.c
+    port run unmodified on a Linux host, e.g. to load test the upper stack
+    with many simulated devices in one process:
+
+    \code
+        SlNetIf_init(0);
+        SlNetIf_add(SLNETIF_ID_1, "lo", &SlNetIfConfigPosix, 5);
+        SlNetSock_init(0);
+        SlNetUtil_init(0);
+    \endcode
+
+    The interface name given to SlNetIf_add is the host network device
+    whose address SlNetIf_getIPAddr reports.
+
+    The host socket calls are resolved past the executable, so the
+    ti/net/bsd socket(), send(), getaddrinfo() etc. may be linked in the
+    same image. The backend source itself must be built without ti/net/bsd
+    on the include path.
+
+    Real socket descriptors handed to SlNetSock are indexes of a table of
+    host descriptors, so they fit the SlNetSock_SdSet_t bitmaps whatever
+    the host descriptor values are. The number of sockets is bounded by
+    SLNETSOCK_MAX_CONCURRENT_SOCKETS, which a host build may raise.
+*/
+/*!
+    \addtogroup POSIX
+    @{
+*/
+
+/*****************************************************************************/
+/* Macro declarations                                                        */
+/*****************************************************************************/
+
+/* When set, SlNetSock_startSec succeeds and the session carries on in plain
+   text, security objects are accepted and dropped. Lets the TLS users of
+   the stack run against a local plain TCP server. When clear, the interface
+   doesn't support security                                                  */
+#ifndef SLNETIFPOSIX_TLS_STANDIN
+#define SLNETIFPOSIX_TLS_STANDIN    (0)
+#endif
+
+/* prototype ifConf */
+extern SlNetIf_Config_t SlNetIfConfigPosix;
+
+/*****************************************************************************/
+/* Structure/Enum declarations                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Function prototypes                                                       */
+/*****************************************************************************/
+
+/*!
+    \brief Set the connection status reported for an interface
+
+    Simulates the link going down and up, as seen by SlNetIf_queryIf and
+    SlNetIf_getConnectionStatus. Open sockets of the interface are left as
+    they are.
+
+    \param[in] ifID       Interface identifier, SLNETIF_ID_
+    \param[in] status     SLNETIF_STATUS_CONNECTED or
+                          SLNETIF_STATUS_DISCONNECTED
+
+    \return               Zero on success, or negative error code on failure
+*/
+int32_t SlNetIfPosix_setConnectionStatus(uint16_t ifID, int32_t status);
+
+/*!
+    \brief Set the delay added to the socket calls of an interface
+
+    Simulates a slower link: each connect, send and receive on a socket of
+    the interface, accepted ones included, is held that long before the host
+    call. Zero, the default, adds no delay.
+
+    \param[in] ifID       Interface identifier, SLNETIF_ID_
+    \param[in] delayUsec  Delay in microseconds
+
+    \return               Zero on success, or negative error code on failure
+*/
+int32_t SlNetIfPosix_setDelay(uint16_t ifID, uint32_t delayUsec);
+
+/*!
+    \brief The SlNetIf_Config_t functions of the interface
+
+    They follow the SlNetIfWifi_ functions of the same name, on a host
+    socket. Host errors are returned as SLNETERR_BSD_ codes.
+*/
+int16_t SlNetIfPosix_socket(void *ifContext, int16_t Domain, int16_t Type, int16_t Protocol, void **sdContext);
+
+int32_t SlNetIfPosix_close(int16_t sd, void *sdContext);
+
+int32_t SlNetIfPosix_shutdown(int16_t sd, void *sdContext, int16_t how);
+
+int16_t SlNetIfPosix_accept(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen, uint8_t flags, void **acceptedSdContext);
+
+int32_t SlNetIfPosix_bind(int16_t sd, void *sdContext, const SlNetSock_Addr_t *addr, int16_t addrlen);
+
+int32_t SlNetIfPosix_listen(int16_t sd, void *sdContext, int16_t backlog);
+
+int32_t SlNetIfPosix_connect(int16_t sd, void *sdContext, const SlNetSock_Addr_t *addr, SlNetSocklen_t addrlen, uint8_t flags);
+
+int32_t SlNetIfPosix_getPeerName(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen);
+
+int32_t SlNetIfPosix_getSockName(int16_t sd, void *sdContext, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen);
+
+int32_t SlNetIfPosix_select(void *ifContext, int16_t nfds, SlNetSock_SdSet_t *readsds, SlNetSock_SdSet_t *writesds, SlNetSock_SdSet_t *exceptsds, SlNetSock_Timeval_t *timeout);
+
+int32_t SlNetIfPosix_setSockOpt(int16_t sd, void *sdContext, int16_t level, int16_t optname, void *optval, SlNetSocklen_t optlen);
+
+int32_t SlNetIfPosix_getSockOpt(int16_t sd, void *sdContext, int16_t level, int16_t optname, void *optval, SlNetSocklen_t *optlen);
+
+int32_t SlNetIfPosix_recv(int16_t sd, void *sdContext, void *buf, uint32_t len, uint32_t flags);
+
+int32_t SlNetIfPosix_recvFrom(int16_t sd, void *sdContext, void *buf, uint32_t len, uint32_t flags, SlNetSock_Addr_t *from, SlNetSocklen_t *fromlen);
+
+int32_t SlNetIfPosix_send(int16_t sd, void *sdContext, const void *buf, uint32_t len, uint32_t flags);
+
+int32_t SlNetIfPosix_sendTo(int16_t sd, void *sdContext, const void *buf, uint32_t len, uint32_t flags, const SlNetSock_Addr_t *to, SlNetSocklen_t tolen);
+
+#if SLNETIFPOSIX_TLS_STANDIN
+int32_t SlNetIfPosix_sockstartSec(int16_t sd, void *sdContext, SlNetSockSecAttrib_t *secAttrib, uint8_t flags);
+#endif
+
+int32_t SlNetIfPosix_getHostByName(void *ifContext, char *name, const uint16_t nameLen, uint32_t *ipAddr, uint16_t *ipAddrLen, const uint8_t family);
+
+int32_t SlNetIfPosix_getIPAddr(void *ifContext, SlNetIfAddressType_e addrType, uint16_t *addrConfig, uint32_t *ipAddr);
+
+int32_t SlNetIfPosix_getConnectionStatus(void *ifContext);
+
+#if SLNETIFPOSIX_TLS_STANDIN
+int32_t SlNetIfPosix_loadSecObj(void *ifContext, uint16_t objType, char *objName, int16_t objNameLen, uint8_t *objBuff, int16_t objBuffLen);
+#endif
+
+int32_t SlNetIfPosix_CreateContext(uint16_t ifID, const char *ifName, void **ifContext);
+
+
+/*!
+
+ Close the Doxygen group.
+ @}
+
+ */
+
+
+#ifdef  __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SLNETIFPOSIX_H__ */
@@ -7,18 +7,26 @@
  */
 
 #include <unistd.h>
+#include <string.h>
 
+#ifndef SL_PORT_SIMULATED_NWP
 #include "boards.h"
 #include "FreeRTOS.h"
 #include "SIMPLELINKWIFI.h"
+#endif
 #include "../simplelink.h"
-#include "nrf_drv_spi.h"
+#ifndef SL_PORT_SIMULATED_NWP
+#include "nrfx_spim.h"
 #include "nrf_gpio.h"
 #include "nrf_drv_gpiote.h"
 #include "nrfx_gpiote.h"
+#endif
 
 #include "cc_pal.h"
 
+// host builds take the interface from sim_nwp.c and keep only the OS glue
+#ifndef SL_PORT_SIMULATED_NWP
+
 /*
 The following are the pins as defined in the LORA system.  Will likely migrate
 to these or similar on the prototype hardware.
@@ -28,7 +36,7 @@ to these or similar on the prototype hardware.
 #define WIFI_SPI_SS_PIN                39 // P1.07
 #define WIFI_DETECT_PIN                37 // P1.05
 */
-#define WIFI_SPI_IRQ_PRIORITY          NRFX_SPI_DEFAULT_CONFIG_IRQ_PRIORITY
+#define WIFI_SPI_IRQ_PRIORITY          NRFX_SPIM_DEFAULT_CONFIG_IRQ_PRIORITY
 #define WIFI_SPI_FREQ                  NRF_DRV_SPI_FREQ_250K
 #define WIFI_SPI_MODE                  NRF_DRV_SPI_MODE_0
 #define WIFI_SPI_BIT_ORDER             NRF_DRV_SPI_BIT_ORDER_MSB_FIRST
@@ -55,9 +63,17 @@ to these or similar on the prototype hardware.
 
 #define WIFI_RADIO_NHIB_GPIO_PIN       35 // P1.03
 
+// longest time a caller will stay blocked on a single SPI transfer
+#define WIFI_SPI_XFER_TIMEOUT_MS       1000
+
+// EasyDMA can only reach data RAM; constant (flash resident) buffers written
+// by the host driver are bounced through a RAM buffer, a chunk of at most this
+// size at a time.
+#define WIFI_SPI_BOUNCE_SIZE           64
+
 // define the NRF52840 SPI interface to use.
 #define SPI_INSTANCE                    0
-static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE(SPI_INSTANCE);
+static const nrfx_spim_t spi = NRFX_SPIM_INSTANCE(SPI_INSTANCE);
 
 /****************************************************************************
    GLOBAL VARIABLES
@@ -65,8 +81,31 @@ static const nrf_drv_spi_t spi = NRF_DRV_SPI_INSTANCE(SPI_INSTANCE);
 volatile Fd_t g_SpiFd = 0;
 SL_P_EVENT_HANDLER g_Host_irq_Hndlr = NULL;
 
-// indicate that SPI instance completed the transfer
-static volatile bool spi_xfer_done;
+// Transfer currently owned by the SPIM peripheral.  A transfer is a list of
+// segments (a single one for spi_Read/spi_Write) that are clocked in
+// maxDMASize chunks under one chip select.  Chunks and segments are chained
+// from the SPI event handler, so the calling task sleeps on spi_xfer_sem until
+// the last chunk has completed.
+typedef struct
+{
+   SlIfIoVec_t const * pIov;  // segments of the transfer
+   int iovCnt;                // number of segments
+   int iovIdx;                // segment currently in flight
+   bool read;                 // segments are filled rather than sent
+   uint8_t const * pTx;       // data of the segment to send, NULL when reading
+   uint8_t const * pFlash;    // flash data sent through spi_bounce, else NULL
+   uint8_t * pRx;             // destination of the segment, NULL when writing
+   uint32_t length;           // number of bytes in the segment
+   uint32_t offset;           // bytes of the segment handed to the SPIM so far
+   uint32_t chunk;            // size of the chunk currently in flight
+   volatile bool failed;      // a chunk could not be started
+   volatile bool active;      // events belong to this transfer, cleared on abort
+} spi_Xfer_t;
+
+static spi_Xfer_t spi_xfer;
+static SemaphoreP_Handle spi_xfer_sem = NULL;
+static uint8_t spi_bounce[WIFI_SPI_BOUNCE_SIZE];
+static SPI_Stats_t spi_stats;
 
 /****************************************************************************
    CONFIGURATION VARIABLES
@@ -139,137 +178,310 @@ void WiFi_init()
    LOCAL FUNCTION DEFINITIONS
 ****************************************************************************/
 /**
- * @brief SPI user event handler.
- * @param event
+ * @brief Hands the next chunk of the current segment to the SPIM.
+ *
+ * The transfer runs in EasyDMA list mode, so after every chunk the SPIM has
+ * already advanced its buffer pointers.  Chunks of the same size are started by
+ * triggering the START task only; the first and the (shorter) tail chunk of a
+ * segment are reprogrammed.
+ * @return NRFX_SUCCESS if the chunk was started.
  */
-void spi_event_handler(nrf_drv_spi_evt_t const * p_event, void* p_context)
+static nrfx_err_t spi_xfer_next(void)
 {
-    spi_xfer_done = true;
-}
+   uint32_t chunk = spi_xfer.length - spi_xfer.offset;
+   uint32_t flags = 0;
+   nrfx_err_t err = NRFX_SUCCESS;
 
+   if(chunk > curDeviceConfiguration->maxDMASize)
+   {
+      chunk = curDeviceConfiguration->maxDMASize;
+   }
 
-Fd_t spi_Open(char *ifName, unsigned long flags)
-{
-   // Initialize the WiFi driver
-   WiFi_init();
-  
-   // If we could not initialize the device bail out with an error code
-   if(curDeviceConfiguration == NULL)
+   // the SPIM is idle, so the bounce buffer can take the next piece.  Its
+   // pointer is not post-incremented, same sized pieces still need START only.
+   if(spi_xfer.pFlash != NULL)
    {
-      return (-1);
-   }  
-   
-   nrf_drv_spi_config_t spi_config = NRF_DRV_SPI_DEFAULT_CONFIG;
-   spi_config.ss_pin   = WIFI_SPI_SS_PIN;
-   spi_config.miso_pin = WIFI_SPI_MISO_PIN;
-   spi_config.mosi_pin = WIFI_SPI_MOSI_PIN;
-   spi_config.sck_pin  = WIFI_SPI_SCK_PIN;
-   
-   return nrf_drv_spi_init(&spi, &spi_config, spi_event_handler, NULL);   
-}
+      if(chunk > sizeof(spi_bounce))
+      {
+         chunk = sizeof(spi_bounce);
+      }
+      memcpy(spi_bounce, spi_xfer.pFlash + spi_xfer.offset, chunk);
+   }
 
-int spi_Close(Fd_t fd)
-{
-   nrf_drv_spi_uninit(&spi);
-   return (0);
-}
+   if((spi_xfer.offset != 0) && (chunk == spi_xfer.chunk))
+   {
+      *(volatile uint32_t *)nrfx_spim_start_task_get(&spi) = 1;
+   }
+   else
+   {
+      nrfx_spim_xfer_desc_t desc = NRFX_SPIM_XFER_TRX(NULL, 0, NULL, 0);
 
-int spi_Read(Fd_t fd, unsigned char *pBuff, int len)
-{
-   int read_size = 0;
-   
-   ASSERT_CS();
+      if(spi_xfer.pFlash != NULL)
+      {
+         desc.p_tx_buffer = spi_bounce;
+         desc.tx_length = chunk;
+      }
+      else if(spi_xfer.pTx != NULL)
+      {
+         desc.p_tx_buffer = spi_xfer.pTx + spi_xfer.offset;
+         desc.tx_length = chunk;
+         flags |= NRFX_SPIM_FLAG_TX_POSTINC;
+      }
+      if(spi_xfer.pRx != NULL)
+      {
+         desc.p_rx_buffer = spi_xfer.pRx + spi_xfer.offset;
+         desc.rx_length = chunk;
+         flags |= NRFX_SPIM_FLAG_RX_POSTINC;
+      }
+      err = nrfx_spim_xfer(&spi, &desc, flags);
+      spi_stats.dmaSetups++;
+   }
 
-   // check if the link SPI has been initialized successfully
-   if(fd < 0)
+   if(err == NRFX_SUCCESS)
    {
-      DEASSERT_CS();
-      return (-1);
+      spi_xfer.chunk = chunk;
+      spi_xfer.offset += chunk;
    }
-    
-   uint16_t currentReadLength = len;
-   while (len > 0)
+
+   return (err);
+}
+
+/**
+ * @brief Starts the first chunk of the next non empty segment.
+ * @return NRFX_SUCCESS if a chunk was started, NRFX_ERROR_NULL when there are
+ *         no segments left.
+ */
+static nrfx_err_t spi_xfer_segment(void)
+{
+   SlIfIoVec_t const *pIov;
+
+   while(++spi_xfer.iovIdx < spi_xfer.iovCnt)
    {
-      if(len > curDeviceConfiguration->maxDMASize)
+      pIov = &spi_xfer.pIov[spi_xfer.iovIdx];
+      if(pIov->len <= 0)
       {
-         currentReadLength = curDeviceConfiguration->maxDMASize;
+         continue;
       }
-      else
+
+      spi_xfer.pTx = NULL;
+      spi_xfer.pFlash = NULL;
+      spi_xfer.pRx = NULL;
+      spi_xfer.length = pIov->len;
+      spi_xfer.offset = 0;
+      spi_xfer.chunk = 0;
+
+      if(spi_xfer.read)
       {
-         currentReadLength = len;
+         spi_xfer.pRx = pIov->pBuff;
       }
-      
-      if (NRF_SUCCESS == nrf_drv_spi_transfer(&spi, NULL, 0, pBuff, len))
+      else if(nrfx_is_in_ram(pIov->pBuff))
       {
-         read_size += len;
-         len = len - currentReadLength;
-         pBuff = pBuff + currentReadLength;
+         spi_xfer.pTx = pIov->pBuff;
       }
       else
       {
-         DEASSERT_CS();
-         read_size = -1; 
-      }
-      
-      while (!spi_xfer_done)
-      {
-         __WFE();
+         spi_xfer.pFlash = pIov->pBuff;
       }
-   }
-   
-   
 
-   DEASSERT_CS();
+      spi_stats.segments++;
+      return (spi_xfer_next());
+   }
 
-   return (read_size);
+   return (NRFX_ERROR_NULL);
 }
 
-int spi_Write(Fd_t fd, unsigned char *pBuff, int len)
+/**
+ * @brief Moves a list of segments across the SPI link under a single chip
+ *        select.  The calling task is blocked (other tasks run) until the
+ *        last segment has been transferred.
+ * @return number of bytes transferred, or -1 on failure.
+ */
+static int spi_Transfer(Fd_t fd, SlIfIoVec_t const *pIov, int iovCnt, bool read)
 {
-   int write_size = 0;
-
-   ASSERT_CS();
+   int xfer_size = 0;
+   uint32_t start;
+   int i;
 
    // check if the link SPI has been initialized successfully
    if(fd < 0)
    {
-      DEASSERT_CS();
       return (-1);
    }
-    
-   uint16_t currentWriteLength = len;
-   while (len > 0)
+
+   for(i = 0; i < iovCnt; i++)
    {
-      if(len > curDeviceConfiguration->maxDMASize)
-      {
-         currentWriteLength = curDeviceConfiguration->maxDMASize;
-      }
-      else
-      {
-         currentWriteLength = len;
-      }
-    
-      if (NRF_SUCCESS == nrf_drv_spi_transfer(&spi, pBuff, currentWriteLength, NULL, 0))
+      if(pIov[i].len > 0)
       {
-         write_size += len;
-         len = len - currentWriteLength;
-         pBuff = pBuff + currentWriteLength;
+         xfer_size += pIov[i].len;
       }
-      else
-      {
-         DEASSERT_CS();
-         write_size = -1;       
-      }
-       
-      while (!spi_xfer_done)
+   }
+
+   if(xfer_size == 0)
+   {
+      return (0);
+   }
+
+   spi_xfer.pIov = pIov;
+   spi_xfer.iovCnt = iovCnt;
+   spi_xfer.iovIdx = -1;
+   spi_xfer.read = read;
+   spi_xfer.failed = false;
+
+   // a completion posted after an earlier abort must not end this transfer
+   while(SemaphoreP_pend(spi_xfer_sem, SemaphoreP_NO_WAIT) == SemaphoreP_OK)
+   {
+   }
+   spi_xfer.active = true;
+
+   ASSERT_CS();
+
+   start = ClockP_getSystemTicks();
+   if(spi_xfer_segment() != NRFX_SUCCESS)
+   {
+      spi_xfer.active = false;
+      xfer_size = -1;
+   }
+   else if(SemaphoreP_pend(spi_xfer_sem,
+                           pdMS_TO_TICKS(WIFI_SPI_XFER_TIMEOUT_MS)) != SemaphoreP_OK)
+   {
+      // disown the transfer before aborting it, then take back a completion
+      // the handler may have posted meanwhile
+      spi_xfer.active = false;
+      nrfx_spim_abort(&spi);
+      SemaphoreP_pend(spi_xfer_sem, SemaphoreP_NO_WAIT);
+      xfer_size = -1;
+   }
+   else if(spi_xfer.failed)
+   {
+      xfer_size = -1;
+   }
+   spi_stats.blockedTicks += ClockP_getSystemTicks() - start;
+
+   DEASSERT_CS();
+
+   if(xfer_size < 0)
+   {
+      spi_stats.errors++;
+   }
+   else
+   {
+      spi_stats.transfers++;
+      spi_stats.bytes += xfer_size;
+   }
+
+   return (xfer_size);
+}
+
+/**
+ * @brief SPI user event handler.  Chains the next chunk or segment of the
+ *        current transfer, and wakes the caller once the last chunk is done.
+ * @param event
+ */
+void spi_event_handler(nrfx_spim_evt_t const * p_event, void* p_context)
+{
+   nrfx_err_t err;
+
+   // late event of an aborted transfer
+   if(!spi_xfer.active)
+   {
+      return;
+   }
+
+   spi_stats.chunks++;
+
+   if(spi_xfer.offset < spi_xfer.length)
+   {
+      err = spi_xfer_next();
+   }
+   else
+   {
+      err = spi_xfer_segment();
+   }
+
+   if(err == NRFX_SUCCESS)
+   {
+      return;
+   }
+   else if(err != NRFX_ERROR_NULL)
+   {
+      spi_xfer.failed = true;
+   }
+
+   spi_xfer.active = false;
+   SemaphoreP_post(spi_xfer_sem);
+}
+
+
+Fd_t spi_Open(char *ifName, unsigned long flags)
+{
+   // Initialize the WiFi driver
+   WiFi_init();
+  
+   // If we could not initialize the device bail out with an error code
+   if(curDeviceConfiguration == NULL)
+   {
+      return (-1);
+   }  
+   
+   if(spi_xfer_sem == NULL)
+   {
+      spi_xfer_sem = SemaphoreP_createBinary(0);
+      if(spi_xfer_sem == NULL)
       {
-         __WFE();
+         return (-1);
       }
    }
+   
+   // the chip select is driven by ASSERT_CS/DEASSERT_CS for the whole
+   // transfer, not by the SPIM driver for every chunk.
+   nrfx_spim_config_t spi_config = NRFX_SPIM_DEFAULT_CONFIG;
+   spi_config.ss_pin       = NRFX_SPIM_PIN_NOT_USED;
+   spi_config.miso_pin     = WIFI_SPI_MISO_PIN;
+   spi_config.mosi_pin     = WIFI_SPI_MOSI_PIN;
+   spi_config.sck_pin      = WIFI_SPI_SCK_PIN;
+   spi_config.irq_priority = WIFI_SPI_IRQ_PRIORITY;
+   
+   if(NRFX_SUCCESS != nrfx_spim_init(&spi, &spi_config, spi_event_handler, NULL))
+   {
+      return (-1);
+   }
 
-   DEASSERT_CS();
+   return (0);
+}
 
-   return (write_size);
+int spi_Close(Fd_t fd)
+{
+   nrfx_spim_uninit(&spi);
+   return (0);
+}
+
+int spi_Read(Fd_t fd, unsigned char *pBuff, int len)
+{
+   SlIfIoVec_t iov = { pBuff, len };
+
+   return (spi_Transfer(fd, &iov, 1, true));
+}
+
+int spi_Write(Fd_t fd, unsigned char *pBuff, int len)
+{
+   SlIfIoVec_t iov = { pBuff, len };
+
+   return (spi_Transfer(fd, &iov, 1, false));
+}
+
+int spi_WriteV(Fd_t fd, SlIfIoVec_t const *pIov, int iovCnt)
+{
+   return (spi_Transfer(fd, pIov, iovCnt, false));
+}
+
+void spi_GetStats(SPI_Stats_t *pStats)
+{
+   *pStats = spi_stats;
+}
+
+void spi_ResetStats(void)
+{
+   memset(&spi_stats, 0, sizeof(spi_stats));
 }
 
 int NwpRegisterInterruptHandler(P_EVENT_HANDLER InterruptHdl, void* pValue)
@@ -345,6 +557,8 @@ void NwpPowerOff(void)
    ClockP_usleep(5000);
 }
 
+#endif // SL_PORT_SIMULATED_NWP
+
 int Semaphore_create_handle(SemaphoreP_Handle* pSemHandle)
 {
     SemaphoreP_Params params;
@@ -47,7 +47,9 @@ extern "C" {
 #include <ti/drivers/dpl/ClockP.h>
 #include <time.h>
    
+#ifndef SL_PORT_SIMULATED_NWP
 #include "nrf_drv_gpiote.h"
+#endif
 
 #define MAX_QUEUE_SIZE                    (4)
 #define OS_WAIT_FOREVER                   (0xFFFFFFFF)
@@ -180,6 +182,68 @@ extern int spi_Write(Fd_t fd,
                      unsigned char *pBuff,
                      int len);
 
+/*!
+    \brief one segment of a gathered write, see spi_WriteV
+ */
+typedef struct
+{
+    unsigned char *pBuff;   /* first location of the segment */
+    int len;                /* number of bytes in the segment */
+} SlIfIoVec_t;
+
+/*!
+    \brief writes a list of buffers to the SPI channel as a single transaction
+
+    \param             fd            -    file descriptor of an opened SPI channel
+
+    \param            pIov        -     points to the list of segments to send, in order
+
+    \param            iovCnt        -    number of segments in the list
+
+    \return            upon successful completion, the function shall return the total
+                    number of bytes written. Otherwise, -1 shall be returned
+
+    \sa             spi_Open , spi_Write
+    \note            All segments are clocked out under one chip select assertion,
+                    and buffers in RAM are sent in place without being copied.
+                    Constant buffers in flash are copied through a small RAM
+                    buffer, a piece at a time.
+    \warning
+ */
+extern int spi_WriteV(Fd_t fd,
+                      SlIfIoVec_t const *pIov,
+                      int iovCnt);
+
+/*!
+    \brief SPI link statistics, accumulated by spi_Read, spi_Write and spi_WriteV.
+ */
+typedef struct
+{
+    uint32_t transfers;     /* completed transfers, one chip select each     */
+    uint32_t segments;      /* buffers moved, several per spi_WriteV call    */
+    uint32_t dmaSetups;     /* times the SPIM EasyDMA had to be reprogrammed */
+    uint32_t chunks;        /* maxDMASize chunks clocked by the SPIM         */
+    uint32_t bytes;         /* bytes moved across the link                   */
+    uint32_t blockedTicks;  /* system ticks callers spent blocked on the SPI */
+    uint32_t errors;        /* transfers that failed or timed out            */
+} SPI_Stats_t;
+
+/*!
+    \brief returns a snapshot of the SPI link statistics
+
+    \param            pStats        -    points to the structure receiving the statistics
+
+    \sa             spi_ResetStats
+ */
+extern void spi_GetStats(SPI_Stats_t *pStats);
+
+/*!
+    \brief clears the SPI link statistics
+
+    \sa             spi_GetStats
+ */
+extern void spi_ResetStats(void);
+
 /*!
     \brief register an interrupt handler for the host IRQ
 
@@ -265,7 +329,9 @@ extern void NwpPowerOff(void);
 
     \warning
  */
+#ifndef SL_PORT_SIMULATED_NWP
 extern void HostIrqGPIO_callback(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t polarity);
+#endif
 
 /*!
     \brief Creates a semaphore handle, using the driver porting layer of the core SDK.
@@ -0,0 +1,1574 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Simulated SimpleLink network processor for host (Linux) builds.
+ *
+ * The host driver talks to this file exactly as it talks to the CC3135 over
+ * SPI: framed commands are written with sim_Write/sim_WriteV, responses and
+ * events are read back with sim_Read after the host IRQ fired.  The socket
+ * commands are executed on POSIX sockets, so sl_Socket/sl_Send/sl_Recv (and the
+ * SlNetSock, MQTT and AWS layers above them) work against loopback servers.
+ *
+ * What is simulated:
+ *   - the H2N/N2H framing, the TX buffer flow control and one IRQ per message
+ *   - device start (init complete as a station) and stop
+ *   - IPv4 socket, close, bind, listen, accept, connect, select, send(to),
+ *     recv(from), and the non blocking / receive timeout socket options
+ * Anything else is acknowledged with a zeroed response carrying status 0.
+ * Secure sockets are opened as plain TCP sockets.  Network events (WLAN
+ * connection, IP acquired, ...) are scripted with SimNwpInjectEvent.
+ */
+
+#ifdef SL_PORT_SIMULATED_NWP
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+#include <ti/drivers/net/wifi/source/protocol.h>
+
+#include "sim_nwp.h"
+
+#define SIM_NWP_FD                      (1)
+
+// default timing, roughly a CC3135 on a 20 MHz SPI link
+#define SIM_NWP_IF_LATENCY_USEC         (20)
+#define SIM_NWP_IF_BYTES_PER_SEC        (2500000)
+#define SIM_NWP_RESP_LATENCY_USEC       (200)
+#define SIM_NWP_TX_POOL_CNT             (24)
+
+// minimum TX payload size reported to the host, as the CC3135 does
+#define SIM_NWP_MIN_TX_PAYLOAD          (1536)
+
+// largest socket payload returned by a single receive
+#define SIM_NWP_MAX_RX_PAYLOAD          (1460)
+
+// messages the NWP can hold for the host, and the size of each one
+#define SIM_NWP_MSG_SLOTS               (32)
+#define SIM_NWP_MSG_SIZE                (SIM_NWP_MAX_RX_PAYLOAD + 64)
+
+// the longest host message accepted, a full TX payload plus its descriptor
+#define SIM_NWP_H2N_BUF_SIZE            (4096)
+
+// arguments returned for commands the simulator does not know; long enough to
+// cover the response descriptor of any command, the host skips the remainder
+#define SIM_NWP_GENERIC_RSP_SIZE        (64)
+
+// longest time the simulator thread sleeps without checking its sockets
+#define SIM_NWP_POLL_MS                 (50)
+
+// time a send may wait for room in the POSIX socket before it is failed
+#define SIM_NWP_SEND_TIMEOUT_MS         (1000)
+
+#define SIM_NWP_NO_DEADLINE             (UINT64_MAX)
+
+#define SIM_NWP_ALIGN(len)              (((len) + 3) & ~3)
+#define SIM_NWP_H2N_SYNC                ((uint32_t)0x12344321)
+#define SIM_NWP_OPCODE_CMD              ((uint16_t)0x8000)
+#define SIM_NWP_OPCODE_V6               ((uint16_t)0x0200)
+
+// flow control floor of the host driver, see flowcont.h
+#define SIM_NWP_FLOW_CONT_MIN           (2)
+
+// init complete status of a station, indexes StartResponseLUT in device.c
+#define SIM_NWP_INIT_STATUS_STA         (1)
+
+/****************************************************************************
+   LOCAL TYPES
+****************************************************************************/
+// message queued to the host, read back as a byte stream
+typedef struct
+{
+   uint8_t data[SIM_NWP_MSG_SIZE];
+   uint16_t len;              // bytes in data, including sync and padding
+   uint16_t offset;           // bytes already read by the host
+   uint64_t readyUsec;        // time at which the NWP raises the IRQ
+} SimNwp_Msg_t;
+
+// socket owned by the simulated NWP
+typedef struct
+{
+   int fd;                    // POSIX socket, -1 when the entry is free
+   bool stream;               // TCP, otherwise UDP
+   bool nonBlocking;          // SL_SO_NONBLOCKING
+   uint32_t rcvTimeoutMs;     // SL_SO_RCVTIMEO, 0 waits forever
+
+   // operations waiting for the POSIX socket
+   bool recvPending;
+   bool recvFrom;             // reply with the peer address
+   uint16_t recvLen;          // bytes requested by the host
+   uint64_t recvDeadline;
+   bool acceptPending;
+   uint64_t acceptDeadline;
+   bool connectPending;
+} SimNwp_Socket_t;
+
+// select issued by the host, only one runs at any time
+typedef struct
+{
+   bool pending;
+   uint16_t readFds;
+   uint16_t writeFds;
+   uint64_t deadline;
+} SimNwp_Select_t;
+
+/****************************************************************************
+   LOCAL VARIABLES
+****************************************************************************/
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+// serializes host writes, so sim_lock can be dropped while a send waits
+static pthread_mutex_t sim_write_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t sim_thread;
+static bool sim_running = false;
+static int sim_wake[2] = { -1, -1 };
+
+static SimNwp_Config_t const sim_defaults =
+{
+   .ifLatencyUsec = SIM_NWP_IF_LATENCY_USEC,
+   .ifBytesPerSec = SIM_NWP_IF_BYTES_PER_SEC,
+   .respLatencyUsec = SIM_NWP_RESP_LATENCY_USEC,
+   .txPoolCnt = SIM_NWP_TX_POOL_CNT
+};
+static SimNwp_Config_t sim_config =
+{
+   .ifLatencyUsec = SIM_NWP_IF_LATENCY_USEC,
+   .ifBytesPerSec = SIM_NWP_IF_BYTES_PER_SEC,
+   .respLatencyUsec = SIM_NWP_RESP_LATENCY_USEC,
+   .txPoolCnt = SIM_NWP_TX_POOL_CNT
+};
+static SimNwp_Stats_t sim_stats;
+
+// host IRQ line
+static P_EVENT_HANDLER sim_irq_hndlr = NULL;
+static bool sim_masked = false;
+static bool sim_powered = false;
+
+// messages to the host; the first sim_raised of them have had their IRQ
+static SimNwp_Msg_t sim_msgs[SIM_NWP_MSG_SLOTS];
+static uint32_t sim_msg_head = 0;
+static uint32_t sim_msg_cnt = 0;
+static uint32_t sim_raised = 0;
+
+// host messages being reassembled from the interface writes
+static uint8_t sim_h2n[SIM_NWP_H2N_BUF_SIZE];
+static uint32_t sim_h2n_len = 0;
+static bool sim_h2n_synced = false;
+
+// transmit buffers the host driver believes it has left
+static int sim_host_credits = 0;
+
+static SimNwp_Socket_t sim_sockets[SL_MAX_SOCKETS];
+static SimNwp_Select_t sim_select;
+static uint16_t sim_tx_failure = 0;
+
+static uint64_t sim_epoch_usec = 0;
+
+// set once the spawn task has made its sync object
+static pthread_cond_t sim_spawn_cond = PTHREAD_COND_INITIALIZER;
+static bool sim_spawn_ready = false;
+
+/****************************************************************************
+   LOCAL FUNCTION DEFINITIONS
+****************************************************************************/
+static uint64_t sim_NowUsec(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+/**
+ * @brief Charges the time the transfer of len bytes takes on the link.
+ */
+static void sim_LinkDelay(int len)
+{
+   uint64_t usec = sim_config.ifLatencyUsec;
+
+   if(sim_config.ifBytesPerSec != 0)
+   {
+      usec += ((uint64_t)len * 1000000u) / sim_config.ifBytesPerSec;
+   }
+   if(usec != 0)
+   {
+      usleep((useconds_t)usec);
+   }
+}
+
+/**
+ * @brief Wakes the simulator thread to look at its queue and sockets again.
+ */
+static void sim_Wake(void)
+{
+   uint8_t b = 0;
+
+   if(sim_wake[1] >= 0)
+   {
+      (void)write(sim_wake[1], &b, 1);
+   }
+}
+
+static uint16_t sim_SocketNonBlockingMap(void)
+{
+   uint16_t map = 0;
+   int sd;
+
+   for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+   {
+      if((sim_sockets[sd].fd >= 0) && sim_sockets[sd].nonBlocking)
+      {
+         map |= (uint16_t)(1u << sd);
+      }
+   }
+   return (map);
+}
+
+/**
+ * @brief Queues one message to the host: sync pattern, response header,
+ *        arguments and payload, each padded to 4 bytes.
+ * @return 0 once queued, -1 if the message was dropped.
+ */
+static int sim_QueueMsg(uint16_t opcode, void const *pArgs, uint16_t argsLen,
+                        void const *pData, uint16_t dataLen)
+{
+   SimNwp_Msg_t *pMsg;
+   _SlResponseHeader_t hdr;
+   uint32_t sync = N2H_SYNC_PATTERN;
+   uint32_t len = sizeof(sync) + sizeof(hdr) +
+                  SIM_NWP_ALIGN(argsLen) + SIM_NWP_ALIGN(dataLen);
+
+   if((sim_msg_cnt == SIM_NWP_MSG_SLOTS) || (len > SIM_NWP_MSG_SIZE))
+   {
+      sim_stats.dropped++;
+      return (-1);
+   }
+
+   pMsg = &sim_msgs[(sim_msg_head + sim_msg_cnt) % SIM_NWP_MSG_SLOTS];
+   memset(pMsg->data, 0, len);
+
+   // the header also refreshes the flow control state of the host
+   memset(&hdr, 0, sizeof(hdr));
+   hdr.GenHeader.Opcode = opcode;
+   hdr.GenHeader.Len = (_u16)(_SL_RESP_SPEC_HDR_SIZE + SIM_NWP_ALIGN(argsLen) + dataLen);
+   hdr.TxPoolCnt = sim_config.txPoolCnt;
+   hdr.MinMaxPayload = SIM_NWP_MIN_TX_PAYLOAD;
+   hdr.SocketTXFailure = sim_tx_failure;
+   hdr.SocketNonBlocking = sim_SocketNonBlockingMap();
+
+   memcpy(&pMsg->data[0], &sync, sizeof(sync));
+   memcpy(&pMsg->data[sizeof(sync)], &hdr, sizeof(hdr));
+   if(argsLen != 0)
+   {
+      memcpy(&pMsg->data[sizeof(sync) + sizeof(hdr)], pArgs, argsLen);
+   }
+   if(dataLen != 0)
+   {
+      memcpy(&pMsg->data[sizeof(sync) + sizeof(hdr) + SIM_NWP_ALIGN(argsLen)], pData, dataLen);
+   }
+   pMsg->len = (uint16_t)len;
+   pMsg->offset = 0;
+   pMsg->readyUsec = sim_NowUsec() + sim_config.respLatencyUsec;
+
+   sim_msg_cnt++;
+   sim_host_credits = sim_config.txPoolCnt;
+   sim_stats.msgs++;
+
+   sim_Wake();
+   return (0);
+}
+
+static void sim_QueueSocketRsp(uint16_t opcode, int16_t status, uint8_t sd)
+{
+   SlSocketResponse_t rsp;
+
+   memset(&rsp, 0, sizeof(rsp));
+   rsp.StatusOrLen = status;
+   rsp.Sd = sd;
+   (void)sim_QueueMsg(opcode, &rsp, sizeof(rsp), NULL, 0);
+}
+
+static void sim_QueueBasicRsp(uint16_t opcode, int16_t status)
+{
+   _BasicResponse_t rsp;
+
+   memset(&rsp, 0, sizeof(rsp));
+   rsp.status = status;
+   (void)sim_QueueMsg(opcode, &rsp, sizeof(rsp), NULL, 0);
+}
+
+/**
+ * @brief Accounts for the transmit buffers a host message consumed, and hands
+ *        them back with a dummy message before the host has to wait for them.
+ */
+static void sim_ConsumeCredits(int pkts)
+{
+   sim_host_credits -= pkts;
+   if(sim_host_credits < ((sim_config.txPoolCnt / 2) + SIM_NWP_FLOW_CONT_MIN))
+   {
+      if(sim_QueueMsg(SL_OPCODE_DEVICE_DEVICEASYNCDUMMY, NULL, 0, NULL, 0) == 0)
+      {
+         sim_stats.creditMsgs++;
+      }
+   }
+}
+
+static int16_t sim_MapErrno(int err)
+{
+   switch(err)
+   {
+      case EAGAIN:         return (SL_ERROR_BSD_EAGAIN);
+      case EINPROGRESS:
+      case EALREADY:       return (SL_ERROR_BSD_EALREADY);
+      case EBADF:          return (SL_ERROR_BSD_EBADF);
+      case EINVAL:         return (SL_ERROR_BSD_EINVAL);
+      case ENOMEM:
+      case ENOBUFS:        return (SL_ERROR_BSD_ENOBUFS);
+      case EADDRINUSE:     return (SL_ERROR_BSD_EADDRINUSE);
+      case EADDRNOTAVAIL:  return (SL_ERROR_BSD_EADDRNOTAVAIL);
+      case ENETUNREACH:
+      case EHOSTUNREACH:   return (SL_ERROR_BSD_ENETUNREACH);
+      case EISCONN:        return (SL_ERROR_BSD_EISCONN);
+      case ENOTCONN:
+      case ECONNRESET:
+      case EPIPE:          return (SL_ERROR_BSD_ENOTCONN);
+      case ETIMEDOUT:      return (SL_ERROR_BSD_ETIMEDOUT);
+      case ECONNREFUSED:   return (SL_ERROR_BSD_ECONNREFUSED);
+      default:             return (SL_ERROR_BSD_SOC_ERROR);
+   }
+}
+
+static SimNwp_Socket_t *sim_GetSocket(uint8_t sd)
+{
+   sd &= SL_BSD_SOCKET_ID_MASK;
+   if((sd >= SL_MAX_SOCKETS) || (sim_sockets[sd].fd < 0))
+   {
+      return (NULL);
+   }
+   return (&sim_sockets[sd]);
+}
+
+static int sim_AllocSocket(int fd, bool stream)
+{
+   int sd;
+
+   for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+   {
+      if(sim_sockets[sd].fd < 0)
+      {
+         memset(&sim_sockets[sd], 0, sizeof(sim_sockets[sd]));
+         sim_sockets[sd].fd = fd;
+         sim_sockets[sd].stream = stream;
+         (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+         return (sd);
+      }
+   }
+   return (-1);
+}
+
+static uint64_t sim_Deadline(SimNwp_Socket_t const *pSock)
+{
+   if(pSock->nonBlocking)
+   {
+      return (0);
+   }
+   if(pSock->rcvTimeoutMs != 0)
+   {
+      return (sim_NowUsec() + (uint64_t)pSock->rcvTimeoutMs * 1000u);
+   }
+   return (SIM_NWP_NO_DEADLINE);
+}
+
+static void sim_FillAddr(struct sockaddr_in *pAddr, SlSocketAddrIPv4Command_t const *pCmd)
+{
+   memset(pAddr, 0, sizeof(*pAddr));
+   pAddr->sin_family = AF_INET;
+   // port and address are kept in network order on both sides
+   pAddr->sin_port = pCmd->Port;
+   pAddr->sin_addr.s_addr = pCmd->Address;
+}
+
+/**
+ * @brief Completes the operation pending on a socket, if the POSIX socket is
+ *        ready or its deadline has passed.
+ */
+static void sim_ServiceSocket(uint8_t sd, uint64_t now)
+{
+   SimNwp_Socket_t *pSock = &sim_sockets[sd];
+
+   if(pSock->connectPending)
+   {
+      struct pollfd pfd = { pSock->fd, POLLOUT, 0 };
+      int err = 0;
+      socklen_t errLen = sizeof(err);
+
+      if((poll(&pfd, 1, 0) > 0) && (pfd.revents != 0))
+      {
+         (void)getsockopt(pSock->fd, SOL_SOCKET, SO_ERROR, &err, &errLen);
+         pSock->connectPending = false;
+         sim_QueueSocketRsp(SL_OPCODE_SOCKET_CONNECTASYNCRESPONSE,
+                            (err == 0) ? 0 : sim_MapErrno(err), sd);
+      }
+   }
+
+   if(pSock->acceptPending)
+   {
+      SlSocketAddrAsyncIPv4Response_t rsp;
+      struct sockaddr_in addr;
+      socklen_t addrLen = sizeof(addr);
+      int fd = accept(pSock->fd, (struct sockaddr *)&addr, &addrLen);
+      int newSd;
+
+      memset(&rsp, 0, sizeof(rsp));
+      rsp.Sd = sd;
+      rsp.Family = SL_AF_INET;
+      if(fd >= 0)
+      {
+         newSd = sim_AllocSocket(fd, true);
+         if(newSd < 0)
+         {
+            close(fd);
+            rsp.StatusOrLen = SL_ERROR_BSD_ENSOCK;
+         }
+         else
+         {
+            rsp.StatusOrLen = (int16_t)newSd;
+            rsp.Port = addr.sin_port;
+            rsp.Address = addr.sin_addr.s_addr;
+         }
+      }
+      else if((errno != EAGAIN) || (now >= pSock->acceptDeadline))
+      {
+         rsp.StatusOrLen = sim_MapErrno(errno);
+      }
+
+      if((fd >= 0) || (rsp.StatusOrLen != 0))
+      {
+         pSock->acceptPending = false;
+         (void)sim_QueueMsg(SL_OPCODE_SOCKET_ACCEPTASYNCRESPONSE, &rsp, sizeof(rsp), NULL, 0);
+      }
+   }
+
+   if(pSock->recvPending)
+   {
+      static uint8_t buf[SIM_NWP_MAX_RX_PAYLOAD];
+      SlSocketAddrAsyncIPv4Response_t rsp;
+      struct sockaddr_in addr;
+      socklen_t addrLen = sizeof(addr);
+      uint16_t len = pSock->recvLen;
+      ssize_t got;
+
+      if(len > sizeof(buf))
+      {
+         len = sizeof(buf);
+      }
+      memset(&addr, 0, sizeof(addr));
+      got = recvfrom(pSock->fd, buf, len, 0, (struct sockaddr *)&addr, &addrLen);
+      if((got < 0) && (errno == EAGAIN) && (now < pSock->recvDeadline))
+      {
+         return;
+      }
+
+      memset(&rsp, 0, sizeof(rsp));
+      rsp.StatusOrLen = (got >= 0) ? (int16_t)got : sim_MapErrno(errno);
+      rsp.Sd = sd;
+      rsp.Family = SL_AF_INET;
+      rsp.Port = addr.sin_port;
+      rsp.Address = addr.sin_addr.s_addr;
+      if(got < 0)
+      {
+         got = 0;
+      }
+
+      pSock->recvPending = false;
+      if(pSock->recvFrom)
+      {
+         (void)sim_QueueMsg(SL_OPCODE_SOCKET_RECVFROMASYNCRESPONSE, &rsp, sizeof(rsp),
+                            buf, (uint16_t)got);
+      }
+      else
+      {
+         (void)sim_QueueMsg(SL_OPCODE_SOCKET_RECVASYNCRESPONSE, &rsp, sizeof(SlSocketResponse_t),
+                            buf, (uint16_t)got);
+      }
+      sim_stats.rxBytes += (uint32_t)got;
+   }
+}
+
+/**
+ * @brief Completes the pending select once one of its sockets is ready or
+ *        its timeout has passed.
+ */
+static void sim_ServiceSelect(uint64_t now)
+{
+   SlSelectAsyncResponse_t rsp;
+   struct pollfd pfd;
+   uint8_t sd;
+
+   if(!sim_select.pending)
+   {
+      return;
+   }
+
+   memset(&rsp, 0, sizeof(rsp));
+   for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+   {
+      uint16_t bit = (uint16_t)(1u << sd);
+
+      if(((sim_select.readFds | sim_select.writeFds) & bit) == 0)
+      {
+         continue;
+      }
+      if(sim_sockets[sd].fd < 0)
+      {
+         // a closed socket reads as ready, the next call on it fails
+         rsp.ReadFds |= (sim_select.readFds & bit);
+         continue;
+      }
+
+      pfd.fd = sim_sockets[sd].fd;
+      pfd.events = ((sim_select.readFds & bit) ? POLLIN : 0) |
+                   ((sim_select.writeFds & bit) ? POLLOUT : 0);
+      pfd.revents = 0;
+      if(poll(&pfd, 1, 0) > 0)
+      {
+         if((sim_select.readFds & bit) && (pfd.revents & (POLLIN | POLLHUP | POLLERR)))
+         {
+            rsp.ReadFds |= bit;
+         }
+         if((sim_select.writeFds & bit) && (pfd.revents & (POLLOUT | POLLERR)))
+         {
+            rsp.WriteFds |= bit;
+         }
+      }
+   }
+
+   rsp.ReadFdsCount = (uint8_t)__builtin_popcount(rsp.ReadFds);
+   rsp.WriteFdsCount = (uint8_t)__builtin_popcount(rsp.WriteFds);
+   rsp.Status = (uint16_t)(rsp.ReadFdsCount + rsp.WriteFdsCount);
+
+   if((rsp.Status != 0) || (now >= sim_select.deadline))
+   {
+      sim_select.pending = false;
+      (void)sim_QueueMsg(SL_OPCODE_SOCKET_SELECTASYNCRESPONSE, &rsp, sizeof(rsp), NULL, 0);
+   }
+}
+
+static void sim_ServiceAll(void)
+{
+   uint64_t now = sim_NowUsec();
+   uint8_t sd;
+
+   for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+   {
+      if(sim_sockets[sd].fd >= 0)
+      {
+         sim_ServiceSocket(sd, now);
+      }
+   }
+   sim_ServiceSelect(now);
+}
+
+static void sim_CloseSocket(uint8_t sd)
+{
+   SimNwp_Socket_t *pSock = &sim_sockets[sd];
+
+   // whoever still waits on the socket is released with an error
+   if(pSock->recvPending)
+   {
+      sim_QueueSocketRsp(pSock->recvFrom ? SL_OPCODE_SOCKET_RECVFROMASYNCRESPONSE :
+                                            SL_OPCODE_SOCKET_RECVASYNCRESPONSE,
+                         SL_ERROR_BSD_ENOTCONN, sd);
+   }
+   if(pSock->acceptPending || pSock->connectPending)
+   {
+      sim_QueueSocketRsp(pSock->acceptPending ? SL_OPCODE_SOCKET_ACCEPTASYNCRESPONSE :
+                                                SL_OPCODE_SOCKET_CONNECTASYNCRESPONSE,
+                         SL_ERROR_BSD_ENOTCONN, sd);
+   }
+
+   close(pSock->fd);
+   memset(pSock, 0, sizeof(*pSock));
+   pSock->fd = -1;
+   sim_tx_failure &= (uint16_t)~(1u << sd);
+}
+
+/**
+ * @brief Returns the NWP to its power-on state.
+ */
+static void sim_Reset(void)
+{
+   uint8_t sd;
+
+   for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+   {
+      if(sim_sockets[sd].fd >= 0)
+      {
+         close(sim_sockets[sd].fd);
+      }
+      memset(&sim_sockets[sd], 0, sizeof(sim_sockets[sd]));
+      sim_sockets[sd].fd = -1;
+   }
+   memset(&sim_select, 0, sizeof(sim_select));
+   sim_tx_failure = 0;
+   sim_msg_head = 0;
+   sim_msg_cnt = 0;
+   sim_raised = 0;
+   sim_h2n_len = 0;
+   sim_h2n_synced = false;
+   sim_host_credits = sim_config.txPoolCnt;
+}
+
+/****************************************************************************
+   COMMAND HANDLERS
+****************************************************************************/
+static void sim_CmdSocket(uint8_t const *pArgs)
+{
+   SlSocketCommand_t cmd;
+   int type;
+   int fd;
+   int sd;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+
+   if(cmd.Domain != SL_AF_INET)
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETRESPONSE, SL_ERROR_BSD_EAFNOSUPPORT, 0);
+      return;
+   }
+   if(cmd.Type == SL_SOCK_STREAM)
+   {
+      type = SOCK_STREAM;
+   }
+   else if(cmd.Type == SL_SOCK_DGRAM)
+   {
+      type = SOCK_DGRAM;
+   }
+   else
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETRESPONSE, SL_ERROR_BSD_EPROTONOSUPPORT, 0);
+      return;
+   }
+
+   // secure sockets are not simulated, SL_SEC_SOCKET is opened as plain TCP
+   fd = socket(AF_INET, type, 0);
+   if(fd < 0)
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETRESPONSE, sim_MapErrno(errno), 0);
+      return;
+   }
+   if(type == SOCK_STREAM)
+   {
+      int on = 1;
+      (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+   }
+
+   sd = sim_AllocSocket(fd, (type == SOCK_STREAM));
+   if(sd < 0)
+   {
+      close(fd);
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETRESPONSE, SL_ERROR_BSD_ENSOCK, 0);
+      return;
+   }
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETRESPONSE, (int16_t)sd, (uint8_t)sd);
+}
+
+static void sim_CmdClose(uint8_t const *pArgs)
+{
+   SlCloseCommand_t cmd;
+   uint8_t sd;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   sd = cmd.Sd & SL_BSD_SOCKET_ID_MASK;
+
+   if(sim_GetSocket(sd) == NULL)
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_CLOSERESPONSE, SL_ERROR_BSD_EBADF, cmd.Sd);
+      return;
+   }
+
+   sim_CloseSocket(sd);
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_CLOSERESPONSE, 0, cmd.Sd);
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_SOCKETCLOSEASYNCEVENT, 0, cmd.Sd);
+}
+
+static void sim_CmdBind(uint8_t const *pArgs)
+{
+   SlSocketAddrIPv4Command_t cmd;
+   SimNwp_Socket_t *pSock;
+   struct sockaddr_in addr;
+   int16_t status = 0;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      status = SL_ERROR_BSD_EBADF;
+   }
+   else
+   {
+      sim_FillAddr(&addr, &cmd);
+      if(bind(pSock->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+      {
+         status = sim_MapErrno(errno);
+      }
+   }
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_BINDRESPONSE, status, cmd.Sd);
+}
+
+static void sim_CmdListen(uint8_t const *pArgs)
+{
+   SlListenCommand_t cmd;
+   SimNwp_Socket_t *pSock;
+   int16_t status = 0;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      status = SL_ERROR_BSD_EBADF;
+   }
+   else if(listen(pSock->fd, cmd.Backlog) < 0)
+   {
+      status = sim_MapErrno(errno);
+   }
+   sim_QueueBasicRsp(SL_OPCODE_SOCKET_LISTENRESPONSE, status);
+}
+
+static void sim_CmdAccept(uint8_t const *pArgs)
+{
+   SlAcceptCommand_t cmd;
+   SimNwp_Socket_t *pSock;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_ACCEPTRESPONSE, SL_ERROR_BSD_EBADF, cmd.Sd);
+      return;
+   }
+
+   // the connection itself is reported by the async response
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_ACCEPTRESPONSE, 0, cmd.Sd);
+   pSock->acceptPending = true;
+   pSock->acceptDeadline = sim_Deadline(pSock);
+}
+
+static void sim_CmdConnect(uint8_t const *pArgs)
+{
+   SlSocketAddrIPv4Command_t cmd;
+   SimNwp_Socket_t *pSock;
+   struct sockaddr_in addr;
+   int16_t status = 0;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_CONNECTRESPONSE, SL_ERROR_BSD_EBADF, cmd.Sd);
+      return;
+   }
+
+   sim_FillAddr(&addr, &cmd);
+   if(connect(pSock->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+   {
+      // a repeated call on a connected non blocking socket succeeds
+      status = (errno == EISCONN) ? 0 : sim_MapErrno(errno);
+   }
+
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_CONNECTRESPONSE, 0, cmd.Sd);
+   if((status == SL_ERROR_BSD_EALREADY) && !pSock->nonBlocking)
+   {
+      pSock->connectPending = true;
+   }
+   else
+   {
+      sim_QueueSocketRsp(SL_OPCODE_SOCKET_CONNECTASYNCRESPONSE, status, cmd.Sd);
+   }
+}
+
+static void sim_CmdSelect(uint8_t const *pArgs)
+{
+   SlSelectCommand_t cmd;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+
+   // a new select replaces the running one, the host only issues it after
+   // waking the previous one through its control socket
+   sim_select.pending = true;
+   sim_select.readFds = cmd.ReadFds;
+   sim_select.writeFds = cmd.WriteFds;
+   if(cmd.tv_sec == 0xFFFF)
+   {
+      sim_select.deadline = SIM_NWP_NO_DEADLINE;
+   }
+   else
+   {
+      // the host sends the microseconds divided by 1024
+      sim_select.deadline = sim_NowUsec() + (uint64_t)cmd.tv_sec * 1000000u +
+                            (uint64_t)cmd.tv_usec * 1024u;
+   }
+   sim_QueueBasicRsp(SL_OPCODE_SOCKET_SELECTRESPONSE, 0);
+}
+
+static void sim_CmdSetSockOpt(uint8_t const *pArgs, uint16_t len)
+{
+   SlSetSockOptCommand_t cmd;
+   SimNwp_Socket_t *pSock;
+   uint8_t const *pVal = pArgs + SIM_NWP_ALIGN(sizeof(cmd));
+   int16_t status = 0;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      status = SL_ERROR_BSD_EBADF;
+   }
+   else if(len < SIM_NWP_ALIGN(sizeof(cmd)) + cmd.OptionLen)
+   {
+      status = SL_ERROR_BSD_EINVAL;
+   }
+   else if((cmd.Level == SL_SOL_SOCKET) && (cmd.OptionName == SL_SO_NONBLOCKING) &&
+           (cmd.OptionLen >= sizeof(SlSockNonblocking_t)))
+   {
+      SlSockNonblocking_t nb;
+
+      memcpy(&nb, pVal, sizeof(nb));
+      pSock->nonBlocking = (nb.NonBlockingEnabled != 0);
+   }
+   else if((cmd.Level == SL_SOL_SOCKET) && (cmd.OptionName == SL_SO_RCVTIMEO) &&
+           (cmd.OptionLen >= sizeof(SlTimeval_t)))
+   {
+      SlTimeval_t tv;
+
+      memcpy(&tv, pVal, sizeof(tv));
+      pSock->rcvTimeoutMs = (uint32_t)tv.tv_sec * 1000u + (uint32_t)tv.tv_usec / 1000u;
+   }
+   else if((cmd.Level == SL_SOL_SOCKET) && (cmd.OptionName == SL_SO_KEEPALIVE) &&
+           (cmd.OptionLen >= sizeof(_u32)))
+   {
+      _u32 on;
+
+      memcpy(&on, pVal, sizeof(on));
+      (void)setsockopt(pSock->fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+   }
+   // every other option (security, TX power, ...) is accepted and ignored
+
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_SETSOCKOPTRESPONSE, status, cmd.Sd);
+}
+
+static void sim_CmdGetSockOpt(uint8_t const *pArgs)
+{
+   SlGetSockOptCommand_t cmd;
+   SlGetSockOptResponse_t rsp;
+   SimNwp_Socket_t *pSock;
+   union
+   {
+      SlSockNonblocking_t nb;
+      SlTimeval_t tv;
+   } val;
+   uint16_t valLen = 0;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+   memset(&rsp, 0, sizeof(rsp));
+   memset(&val, 0, sizeof(val));
+   rsp.Sd = cmd.Sd;
+
+   if(pSock == NULL)
+   {
+      rsp.Status = SL_ERROR_BSD_EBADF;
+   }
+   else if((cmd.Level == SL_SOL_SOCKET) && (cmd.OptionName == SL_SO_NONBLOCKING))
+   {
+      val.nb.NonBlockingEnabled = pSock->nonBlocking ? 1 : 0;
+      valLen = sizeof(val.nb);
+   }
+   else if((cmd.Level == SL_SOL_SOCKET) && (cmd.OptionName == SL_SO_RCVTIMEO))
+   {
+      val.tv.tv_sec = (SlTime_t)(pSock->rcvTimeoutMs / 1000u);
+      val.tv.tv_usec = (SlSuseconds_t)((pSock->rcvTimeoutMs % 1000u) * 1000u);
+      valLen = sizeof(val.tv);
+   }
+   else
+   {
+      rsp.Status = SL_ERROR_BSD_ENOPROTOOPT;
+   }
+
+   rsp.OptionLen = (uint8_t)valLen;
+   (void)sim_QueueMsg(SL_OPCODE_SOCKET_GETSOCKOPTRESPONSE, &rsp, sizeof(rsp), &val, valLen);
+}
+
+static void sim_CmdRecv(uint8_t const *pArgs, bool from)
+{
+   SlSendRecvCommand_t cmd;
+   SimNwp_Socket_t *pSock;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   pSock = sim_GetSocket(cmd.Sd);
+
+   if(pSock == NULL)
+   {
+      sim_QueueSocketRsp(from ? SL_OPCODE_SOCKET_RECVFROMASYNCRESPONSE :
+                                SL_OPCODE_SOCKET_RECVASYNCRESPONSE,
+                         SL_ERROR_BSD_EBADF, cmd.Sd);
+      return;
+   }
+
+   // no response, the data (or the error) comes with the async response
+   pSock->recvPending = true;
+   pSock->recvFrom = from;
+   pSock->recvLen = cmd.StatusOrLen;
+   pSock->recvDeadline = sim_Deadline(pSock);
+}
+
+/**
+ * @brief Writes a payload to a POSIX socket, waiting a bounded time for room.
+ *        sim_lock is released while waiting, so the host can keep reading
+ *        its messages. Failures are reported the way the NWP does, in the TX
+ *        failure bitmap of the next header and with a TX failed event.
+ */
+static void sim_SocketSend(uint8_t sd, uint8_t const *pData, uint16_t len,
+                           struct sockaddr_in const *pTo)
+{
+   SimNwp_Socket_t *pSock = sim_GetSocket(sd);
+   uint16_t sent = 0;
+   ssize_t n;
+   int err = EBADF;
+
+   while(pSock != NULL)
+   {
+      n = sendto(pSock->fd, pData + sent, len - sent, MSG_NOSIGNAL,
+                 (struct sockaddr const *)pTo, (pTo != NULL) ? sizeof(*pTo) : 0);
+      if(n >= 0)
+      {
+         sent += (uint16_t)n;
+         if(sent == len)
+         {
+            sim_stats.txBytes += len;
+            return;
+         }
+      }
+      else if(errno == EAGAIN)
+      {
+         struct pollfd pfd = { pSock->fd, POLLOUT, 0 };
+         int ready;
+
+         pthread_mutex_unlock(&sim_lock);
+         ready = poll(&pfd, 1, SIM_NWP_SEND_TIMEOUT_MS);
+         pthread_mutex_lock(&sim_lock);
+
+         // the socket may have been closed or reset meanwhile
+         pSock = sim_GetSocket(sd);
+         if((pSock == NULL) || (pSock->fd != pfd.fd))
+         {
+            err = EBADF;
+            break;
+         }
+         if(ready <= 0)
+         {
+            err = ETIMEDOUT;
+            break;
+         }
+      }
+      else
+      {
+         err = errno;
+         break;
+      }
+   }
+
+   sd &= SL_BSD_SOCKET_ID_MASK;
+   if(sd < SL_MAX_SOCKETS)
+   {
+      sim_tx_failure |= (uint16_t)(1u << sd);
+   }
+   sim_QueueSocketRsp(SL_OPCODE_SOCKET_TXFAILEDASYNCRESPONSE, sim_MapErrno(err), sd);
+}
+
+static void sim_CmdSend(uint8_t const *pArgs, uint16_t len)
+{
+   SlSendRecvCommand_t cmd;
+   uint16_t dataLen;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   dataLen = cmd.StatusOrLen;
+   if(dataLen > len - sizeof(cmd))
+   {
+      dataLen = len - sizeof(cmd);
+   }
+   sim_SocketSend(cmd.Sd, pArgs + sizeof(cmd), dataLen, NULL);
+}
+
+static void sim_CmdSendTo(uint8_t const *pArgs, uint16_t len)
+{
+   SlSocketAddrIPv4Command_t cmd;
+   struct sockaddr_in addr;
+   uint16_t dataLen;
+
+   memcpy(&cmd, pArgs, sizeof(cmd));
+   dataLen = (uint16_t)cmd.LenOrPadding;
+   if(dataLen > len - sizeof(cmd))
+   {
+      dataLen = len - sizeof(cmd);
+   }
+   sim_FillAddr(&addr, &cmd);
+   sim_SocketSend(cmd.Sd, pArgs + sizeof(cmd), dataLen, &addr);
+}
+
+/**
+ * @brief Executes one complete host message.
+ */
+static void sim_Dispatch(uint16_t opcode, uint8_t const *pArgs, uint16_t len)
+{
+   uint8_t rsp[SIM_NWP_GENERIC_RSP_SIZE];
+   int pkts = 1;
+
+   sim_stats.cmds++;
+
+   switch(opcode)
+   {
+      case SL_OPCODE_SOCKET_SOCKET:       sim_CmdSocket(pArgs);             break;
+      case SL_OPCODE_SOCKET_CLOSE:        sim_CmdClose(pArgs);              break;
+      case SL_OPCODE_SOCKET_BIND:         sim_CmdBind(pArgs);               break;
+      case SL_OPCODE_SOCKET_LISTEN:       sim_CmdListen(pArgs);             break;
+      case SL_OPCODE_SOCKET_ACCEPT:       sim_CmdAccept(pArgs);             break;
+      case SL_OPCODE_SOCKET_CONNECT:      sim_CmdConnect(pArgs);            break;
+      case SL_OPCODE_SOCKET_SELECT:       sim_CmdSelect(pArgs);             break;
+      case SL_OPCODE_SOCKET_SETSOCKOPT:   sim_CmdSetSockOpt(pArgs, len);    break;
+      case SL_OPCODE_SOCKET_GETSOCKOPT:   sim_CmdGetSockOpt(pArgs);         break;
+      case SL_OPCODE_SOCKET_RECV:         sim_CmdRecv(pArgs, false);        break;
+      case SL_OPCODE_SOCKET_RECVFROM:     sim_CmdRecv(pArgs, true);         break;
+
+      case SL_OPCODE_SOCKET_SEND:
+      case SL_OPCODE_SOCKET_SENDTO:
+         // data messages take one transmit buffer per MinTxPayloadSize bytes
+         if(len > SIM_NWP_MIN_TX_PAYLOAD)
+         {
+            pkts = 1 + (len - 1) / SIM_NWP_MIN_TX_PAYLOAD;
+         }
+         if(opcode == SL_OPCODE_SOCKET_SEND)
+         {
+            sim_CmdSend(pArgs, len);
+         }
+         else
+         {
+            sim_CmdSendTo(pArgs, len);
+         }
+         break;
+
+      case SL_OPCODE_DEVICE_STOP_COMMAND:
+         sim_QueueBasicRsp(SL_OPCODE_DEVICE_STOP_RESPONSE, 0);
+         sim_QueueBasicRsp(SL_OPCODE_DEVICE_STOP_ASYNC_RESPONSE, 0);
+         break;
+
+      default:
+         // unknown command: acknowledge it so the host does not stall; the
+         // response is cleared, the IPv6 variants of socket commands share
+         // the response opcode of the IPv4 ones
+         sim_stats.unknownCmds++;
+         if((opcode & SL_OPCODE_SILO_MASK) == SL_OPCODE_SILO_SOCKET)
+         {
+            opcode &= (uint16_t)~SIM_NWP_OPCODE_V6;
+         }
+         memset(rsp, 0, sizeof(rsp));
+         (void)sim_QueueMsg((uint16_t)(opcode & ~SIM_NWP_OPCODE_CMD), rsp, sizeof(rsp), NULL, 0);
+         break;
+   }
+
+   sim_ServiceAll();
+   sim_ConsumeCredits(pkts);
+}
+
+/**
+ * @brief Reassembles host messages from the bytes written to the interface.
+ *        Only the short sync pattern starts a message; the CNYS pattern that
+ *        precedes every read and the idle pattern are dropped.
+ */
+static void sim_Parse(void)
+{
+   uint32_t pos = 0;
+   uint32_t word;
+   _SlGenericHeader_t hdr;
+   uint32_t need;
+
+   while(sim_h2n_len - pos >= sizeof(word))
+   {
+      if(!sim_h2n_synced)
+      {
+         memcpy(&word, &sim_h2n[pos], sizeof(word));
+         pos += sizeof(word);
+         sim_h2n_synced = (word == SIM_NWP_H2N_SYNC);
+         continue;
+      }
+
+      memcpy(&hdr, &sim_h2n[pos], sizeof(hdr));
+      need = sizeof(hdr) + SIM_NWP_ALIGN(hdr.Len);
+      if(need > sizeof(sim_h2n))
+      {
+         // cannot be held, drop it and look for the next sync
+         sim_stats.dropped++;
+         sim_h2n_synced = false;
+         pos += sizeof(hdr);
+         continue;
+      }
+      if(sim_h2n_len - pos < need)
+      {
+         break;
+      }
+
+      sim_Dispatch(hdr.Opcode, &sim_h2n[pos + sizeof(hdr)], hdr.Len);
+      if(sim_h2n_len == 0)
+      {
+         // powered off while a send waited, the buffer is gone
+         return;
+      }
+      pos += need;
+      sim_h2n_synced = false;
+   }
+
+   if(pos != 0)
+   {
+      memmove(sim_h2n, &sim_h2n[pos], sim_h2n_len - pos);
+      sim_h2n_len -= pos;
+   }
+}
+
+/**
+ * @brief Simulator thread: raises the host IRQ for every message whose
+ *        response time has come, and completes the socket operations that
+ *        wait for the POSIX sockets.
+ */
+static void *sim_Task(void *pArg)
+{
+   struct pollfd pfds[SL_MAX_SOCKETS + 1];
+   P_EVENT_HANDLER hndlr;
+   uint64_t now;
+   uint64_t next;
+   int timeout;
+   int nfds;
+   int sd;
+   uint8_t drain[16];
+
+   (void)pArg;
+
+   pthread_mutex_lock(&sim_lock);
+   while(sim_running)
+   {
+      now = sim_NowUsec();
+      next = now + (uint64_t)SIM_NWP_POLL_MS * 1000u;
+
+      if(sim_powered && (sim_irq_hndlr != NULL) && !sim_masked &&
+         (sim_raised < sim_msg_cnt))
+      {
+         SimNwp_Msg_t *pMsg = &sim_msgs[(sim_msg_head + sim_raised) % SIM_NWP_MSG_SLOTS];
+
+         if(pMsg->readyUsec <= now)
+         {
+            // the line stays masked until the host has read the message
+            sim_masked = true;
+            sim_raised++;
+            sim_stats.irqs++;
+            hndlr = sim_irq_hndlr;
+
+            pthread_mutex_unlock(&sim_lock);
+            hndlr(0);
+            pthread_mutex_lock(&sim_lock);
+            continue;
+         }
+         if(pMsg->readyUsec < next)
+         {
+            next = pMsg->readyUsec;
+         }
+      }
+
+      // wait on the wake pipe and on every socket with a pending operation
+      nfds = 0;
+      pfds[nfds].fd = sim_wake[0];
+      pfds[nfds].events = POLLIN;
+      nfds++;
+      for(sd = 0; sd < SL_MAX_SOCKETS; sd++)
+      {
+         SimNwp_Socket_t *pSock = &sim_sockets[sd];
+
+         if(pSock->fd < 0)
+         {
+            continue;
+         }
+         if(pSock->recvPending || pSock->acceptPending || pSock->connectPending ||
+            (sim_select.pending && (((sim_select.readFds | sim_select.writeFds) >> sd) & 1)))
+         {
+            pfds[nfds].fd = pSock->fd;
+            pfds[nfds].events = (pSock->connectPending ? POLLOUT : POLLIN) |
+                                (((sim_select.writeFds >> sd) & 1) ? POLLOUT : 0);
+            nfds++;
+         }
+         if(pSock->recvPending && (pSock->recvDeadline < next))
+         {
+            next = pSock->recvDeadline;
+         }
+         if(pSock->acceptPending && (pSock->acceptDeadline < next))
+         {
+            next = pSock->acceptDeadline;
+         }
+      }
+      if(sim_select.pending && (sim_select.deadline < next))
+      {
+         next = sim_select.deadline;
+      }
+
+      timeout = (next > now) ? (int)((next - now + 999u) / 1000u) : 0;
+
+      pthread_mutex_unlock(&sim_lock);
+      (void)poll(pfds, (nfds_t)nfds, timeout);
+      while(read(sim_wake[0], drain, sizeof(drain)) > 0)
+      {
+      }
+      pthread_mutex_lock(&sim_lock);
+
+      if(sim_powered)
+      {
+         sim_ServiceAll();
+      }
+   }
+   pthread_mutex_unlock(&sim_lock);
+
+   return (NULL);
+}
+
+/****************************************************************************
+   INTERFACE FUNCTIONS
+****************************************************************************/
+Fd_t sim_Open(char *ifName, unsigned long flags)
+{
+   (void)ifName;
+   (void)flags;
+
+   pthread_mutex_lock(&sim_lock);
+   if(!sim_running)
+   {
+      if(pipe(sim_wake) < 0)
+      {
+         pthread_mutex_unlock(&sim_lock);
+         return (-1);
+      }
+      (void)fcntl(sim_wake[0], F_SETFL, O_NONBLOCK);
+      (void)fcntl(sim_wake[1], F_SETFL, O_NONBLOCK);
+
+      sim_Reset();
+      if(sim_epoch_usec == 0)
+      {
+         sim_epoch_usec = sim_NowUsec();
+      }
+
+      sim_running = true;
+      if(pthread_create(&sim_thread, NULL, sim_Task, NULL) != 0)
+      {
+         sim_running = false;
+         close(sim_wake[0]);
+         close(sim_wake[1]);
+         sim_wake[0] = -1;
+         sim_wake[1] = -1;
+         pthread_mutex_unlock(&sim_lock);
+         return (-1);
+      }
+   }
+   pthread_mutex_unlock(&sim_lock);
+
+   return (SIM_NWP_FD);
+}
+
+int sim_Close(Fd_t fd)
+{
+   bool running;
+
+   if(fd != SIM_NWP_FD)
+   {
+      return (-1);
+   }
+
+   pthread_mutex_lock(&sim_lock);
+   running = sim_running;
+   sim_running = false;
+   sim_Wake();
+   pthread_mutex_unlock(&sim_lock);
+
+   if(running)
+   {
+      pthread_join(sim_thread, NULL);
+   }
+
+   pthread_mutex_lock(&sim_lock);
+   sim_Reset();
+   if(sim_wake[0] >= 0)
+   {
+      close(sim_wake[0]);
+      close(sim_wake[1]);
+      sim_wake[0] = -1;
+      sim_wake[1] = -1;
+   }
+   pthread_mutex_unlock(&sim_lock);
+
+   return (0);
+}
+
+int sim_Read(Fd_t fd, unsigned char *pBuff, int len)
+{
+   SimNwp_Msg_t *pMsg;
+   int done = 0;
+   int chunk;
+
+   if((fd != SIM_NWP_FD) || (len < 0))
+   {
+      return (-1);
+   }
+
+   sim_LinkDelay(len);
+
+   pthread_mutex_lock(&sim_lock);
+   while(done < len)
+   {
+      if(sim_msg_cnt == 0)
+      {
+         // nothing queued, the NWP clocks out the idle pattern
+         memset(&pBuff[done], 0xFF, len - done);
+         sim_stats.idleBytes += (uint32_t)(len - done);
+         done = len;
+         break;
+      }
+
+      pMsg = &sim_msgs[sim_msg_head];
+      chunk = pMsg->len - pMsg->offset;
+      if(chunk > len - done)
+      {
+         chunk = len - done;
+      }
+      memcpy(&pBuff[done], &pMsg->data[pMsg->offset], chunk);
+      pMsg->offset += (uint16_t)chunk;
+      done += chunk;
+
+      if(pMsg->offset == pMsg->len)
+      {
+         sim_msg_head = (sim_msg_head + 1) % SIM_NWP_MSG_SLOTS;
+         sim_msg_cnt--;
+         if(sim_raised != 0)
+         {
+            sim_raised--;
+         }
+      }
+   }
+   sim_stats.bytesRead += (uint32_t)len;
+   pthread_mutex_unlock(&sim_lock);
+
+   return (len);
+}
+
+int sim_WriteV(Fd_t fd, SlIfIoVec_t const *pIov, int iovCnt)
+{
+   int total = 0;
+   int i;
+
+   if(fd != SIM_NWP_FD)
+   {
+      return (-1);
+   }
+
+   for(i = 0; i < iovCnt; i++)
+   {
+      if(pIov[i].len > 0)
+      {
+         total += pIov[i].len;
+      }
+   }
+   sim_LinkDelay(total);
+
+   pthread_mutex_lock(&sim_write_lock);
+   pthread_mutex_lock(&sim_lock);
+   for(i = 0; i < iovCnt; i++)
+   {
+      unsigned char const *pBuff = pIov[i].pBuff;
+      int left = pIov[i].len;
+      int chunk;
+
+      while(left > 0)
+      {
+         chunk = (int)(sizeof(sim_h2n) - sim_h2n_len);
+         if(chunk > left)
+         {
+            chunk = left;
+         }
+         memcpy(&sim_h2n[sim_h2n_len], pBuff, chunk);
+         sim_h2n_len += (uint32_t)chunk;
+         pBuff += chunk;
+         left -= chunk;
+
+         if(sim_powered)
+         {
+            sim_Parse();
+         }
+         if(sim_h2n_len == sizeof(sim_h2n))
+         {
+            // nothing parsable in a full buffer, start over
+            sim_stats.dropped++;
+            sim_h2n_len = 0;
+            sim_h2n_synced = false;
+         }
+      }
+   }
+   sim_stats.bytesWritten += (uint32_t)total;
+   pthread_mutex_unlock(&sim_lock);
+   pthread_mutex_unlock(&sim_write_lock);
+
+   return (total);
+}
+
+int sim_Write(Fd_t fd, unsigned char *pBuff, int len)
+{
+   SlIfIoVec_t iov = { pBuff, len };
+
+   return (sim_WriteV(fd, &iov, 1));
+}
+
+/****************************************************************************
+   HOST IRQ, POWER AND TIME
+****************************************************************************/
+int SimNwpRegisterInterruptHandler(P_EVENT_HANDLER InterruptHdl, void* pValue)
+{
+   (void)pValue;
+
+   pthread_mutex_lock(&sim_lock);
+   sim_irq_hndlr = InterruptHdl;
+   sim_masked = false;
+   sim_Wake();
+   pthread_mutex_unlock(&sim_lock);
+
+   return (0);
+}
+
+void SimNwpMaskInterrupt(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   sim_masked = true;
+   pthread_mutex_unlock(&sim_lock);
+}
+
+void SimNwpUnMaskInterrupt(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   sim_masked = false;
+   sim_Wake();
+   pthread_mutex_unlock(&sim_lock);
+}
+
+void SimNwpPowerOn(void)
+{
+   InitComplete_t init;
+
+   pthread_mutex_lock(&sim_lock);
+   sim_Reset();
+   sim_powered = true;
+
+   // boot straight into station role
+   memset(&init, 0, sizeof(init));
+   init.Status = SIM_NWP_INIT_STATUS_STA;
+   (void)sim_QueueMsg(SL_OPCODE_DEVICE_INITCOMPLETE, &init, sizeof(init), NULL, 0);
+   pthread_mutex_unlock(&sim_lock);
+}
+
+void SimNwpPowerOff(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   sim_powered = false;
+   sim_Reset();
+   pthread_mutex_unlock(&sim_lock);
+}
+
+uint32_t SimNwpGetTimestamp(void)
+{
+   if(sim_epoch_usec == 0)
+   {
+      sim_epoch_usec = sim_NowUsec();
+   }
+   return ((uint32_t)((sim_NowUsec() - sim_epoch_usec) / 1000u));
+}
+
+void SimNwpSpawnTaskReady(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   sim_spawn_ready = true;
+   pthread_cond_broadcast(&sim_spawn_cond);
+   pthread_mutex_unlock(&sim_lock);
+}
+
+void SimNwpWaitSpawnTask(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   while(!sim_spawn_ready)
+   {
+      pthread_cond_wait(&sim_spawn_cond, &sim_lock);
+   }
+   pthread_mutex_unlock(&sim_lock);
+}
+
+/****************************************************************************
+   SIMULATION CONTROL
+****************************************************************************/
+void SimNwpConfigure(SimNwp_Config_t const *pConfig)
+{
+   pthread_mutex_lock(&sim_lock);
+   sim_config = (pConfig != NULL) ? *pConfig : sim_defaults;
+   if(sim_config.txPoolCnt <= (2 * SIM_NWP_FLOW_CONT_MIN + 2))
+   {
+      sim_config.txPoolCnt = 2 * SIM_NWP_FLOW_CONT_MIN + 2;
+   }
+   pthread_mutex_unlock(&sim_lock);
+}
+
+int SimNwpInjectEvent(uint16_t opcode, void const *pArgs, uint16_t len)
+{
+   int ret = -1;
+
+   if((opcode & (SL_OPCODE_SYNC | SIM_NWP_OPCODE_CMD)) != 0)
+   {
+      return (-1);
+   }
+
+   pthread_mutex_lock(&sim_lock);
+   if(sim_powered && (sim_QueueMsg(opcode, pArgs, len, NULL, 0) == 0))
+   {
+      sim_stats.events++;
+      ret = 0;
+   }
+   pthread_mutex_unlock(&sim_lock);
+
+   return (ret);
+}
+
+void SimNwpGetStats(SimNwp_Stats_t *pStats)
+{
+   pthread_mutex_lock(&sim_lock);
+   *pStats = sim_stats;
+   pthread_mutex_unlock(&sim_lock);
+}
+
+void SimNwpResetStats(void)
+{
+   pthread_mutex_lock(&sim_lock);
+   memset(&sim_stats, 0, sizeof(sim_stats));
+   pthread_mutex_unlock(&sim_lock);
+}
+
+#endif // SL_PORT_SIMULATED_NWP
@@ -0,0 +1,187 @@
+// Copyright (c) 2020 Confidential Information Georgia-Pacific Consumer Products
+// Not for further distribution.  All rights reserved.
+
+/**
+ * Simulated SimpleLink network processor for host (Linux) builds.
+ *
+ * Stands in for the CC3135 behind the sl_If* interface hooks, so the unmodified
+ * host driver and everything above it can run against POSIX loopback sockets.
+ * Selected by defining SL_PORT_SIMULATED_NWP, see user.h. host/Makefile builds
+ * it with the POSIX SemaphoreP, MutexP and ClockP modules from dpl/.
+ */
+
+#ifndef __SIM_NWP_H__
+#define __SIM_NWP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <ti/drivers/net/wifi/porting/cc_pal.h>
+
+/*!
+    \brief timing and resources of the simulated network processor
+ */
+typedef struct
+{
+    uint32_t ifLatencyUsec;     /* fixed cost of every interface transfer          */
+    uint32_t ifBytesPerSec;     /* interface throughput, 0 for an unlimited link   */
+    uint32_t respLatencyUsec;   /* NWP time between a command and its response     */
+    uint8_t  txPoolCnt;         /* transmit buffers advertised to the host driver  */
+} SimNwp_Config_t;
+
+/*!
+    \brief counters kept by the simulated network processor
+ */
+typedef struct
+{
+    uint32_t cmds;          /* messages parsed from the host                     */
+    uint32_t unknownCmds;   /* commands acknowledged with a generic response     */
+    uint32_t msgs;          /* messages queued to the host                       */
+    uint32_t irqs;          /* host IRQs raised                                  */
+    uint32_t events;        /* events injected through SimNwpInjectEvent         */
+    uint32_t creditMsgs;    /* flow control messages returning transmit buffers  */
+    uint32_t dropped;       /* messages lost because the host queue was full     */
+    uint32_t bytesWritten;  /* bytes written by the host                         */
+    uint32_t bytesRead;     /* bytes read by the host                            */
+    uint32_t idleBytes;     /* bytes read while nothing was queued to the host   */
+    uint32_t txBytes;       /* socket payload handed to the POSIX stack          */
+    uint32_t rxBytes;       /* socket payload returned to the host               */
+} SimNwp_Stats_t;
+
+/*!
+    \brief opens the simulated interface, see sl_IfOpen
+
+    \return         a non-negative file descriptor, or -1 if the simulator
+                    thread could not be started
+ */
+extern Fd_t sim_Open(char *ifName,
+                     unsigned long flags);
+
+/*!
+    \brief closes the simulated interface and every socket still open, see sl_IfClose
+ */
+extern int sim_Close(Fd_t fd);
+
+/*!
+    \brief reads bytes queued by the simulated NWP, see sl_IfRead
+
+    \return         number of bytes read, or -1 on failure
+    \note           Reads past the queued messages return the idle (0xFF) pattern,
+                    as the SPI link would.
+ */
+extern int sim_Read(Fd_t fd,
+                    unsigned char *pBuff,
+                    int len);
+
+/*!
+    \brief writes host bytes to the simulated NWP, see sl_IfWrite
+
+    \return         number of bytes written, or -1 on failure
+    \note           Every complete message is executed before the call returns;
+                    its response is raised after respLatencyUsec.
+ */
+extern int sim_Write(Fd_t fd,
+                     unsigned char *pBuff,
+                     int len);
+
+/*!
+    \brief writes a list of buffers as a single transaction, see sl_IfWriteV
+ */
+extern int sim_WriteV(Fd_t fd,
+                      SlIfIoVec_t const *pIov,
+                      int iovCnt);
+
+/*!
+    \brief registers the host IRQ handler, see sl_IfRegIntHdlr
+
+    \note           The handler runs on the simulator thread, once per message.
+ */
+extern int SimNwpRegisterInterruptHandler(P_EVENT_HANDLER InterruptHdl,
+                                          void* pValue);
+
+/*!
+    \brief masks the host IRQ, see sl_IfMaskIntHdlr
+ */
+extern void SimNwpMaskInterrupt(void);
+
+/*!
+    \brief unmasks the host IRQ, see sl_IfUnMaskIntHdlr
+ */
+extern void SimNwpUnMaskInterrupt(void);
+
+/*!
+    \brief boots the simulated NWP, which then reports init complete as a station
+ */
+extern void SimNwpPowerOn(void);
+
+/*!
+    \brief turns the simulated NWP off, closing its sockets and dropping queued messages
+ */
+extern void SimNwpPowerOff(void);
+
+/*!
+    \brief returns a free running millisecond counter, see slcb_GetTimestamp
+ */
+extern uint32_t SimNwpGetTimestamp(void);
+
+/*!
+    \brief reports that the internal spawn task can take entries, see
+           slcb_SpawnTaskReady
+
+    \sa             SimNwpWaitSpawnTask
+ */
+extern void SimNwpSpawnTaskReady(void);
+
+/*!
+    \brief blocks until the internal spawn task has reported it is ready
+
+    \note           sl_Start must not be called before, the NWP interrupts it
+                    raises are handed to the spawn task.
+ */
+extern void SimNwpWaitSpawnTask(void);
+
+/*!
+    \brief replaces the timing of the simulated NWP
+
+    \param          pConfig     -   new configuration, NULL restores the defaults
+ */
+extern void SimNwpConfigure(SimNwp_Config_t const *pConfig);
+
+/*!
+    \brief queues an asynchronous event to the host, as if sent by the NWP
+
+    \param          opcode      -   event opcode, from protocol.h
+    \param          pArgs       -   event arguments, may be NULL when len is 0
+    \param          len         -   number of bytes in pArgs
+
+    \return         0 once queued, -1 if the opcode is not an event, the NWP is
+                    off or the host queue is full
+    \note           Used to script events the simulator does not produce by
+                    itself, such as WLAN connection and IP acquisition.
+ */
+extern int SimNwpInjectEvent(uint16_t opcode,
+                             void const *pArgs,
+                             uint16_t len);
+
+/*!
+    \brief returns a snapshot of the simulator counters
+
+    \sa             SimNwpResetStats
+ */
+extern void SimNwpGetStats(SimNwp_Stats_t *pStats);
+
+/*!
+    \brief clears the simulator counters
+
+    \sa             SimNwpGetStats
+ */
+extern void SimNwpResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_NWP_H__
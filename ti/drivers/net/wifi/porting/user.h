@@ -124,7 +124,7 @@ typedef signed int _SlFd_t;
     \def        MAX_CONCURRENT_ACTIONS
 
     \brief      Defines the maximum number of concurrent action in the system
-                Min:1 , Max: 32
+                Min:1 , Max: 254
 
                 Actions which has async events as return, will be blocked until the event arrive
 
@@ -140,17 +140,21 @@ typedef signed int _SlFd_t;
                 allocated and handled in spawn context. If MAX_CONCURRENT_ACTIONS
                 is high, there will be more events which might arrive during this period.
                 Due to memory constrains MAX_CONCURRENT_ACTIONS is lower in static allocation mode.
+                Free and active actions are tracked in bitmaps and per socket / per action
+                tables, so a high value does not slow down issuing or completing an action.
 
 
     \warning    In case of setting to one, recommend to use non-blocking recv\recvfrom to allow
                 multiple socket recv
  */
 
+#ifndef MAX_CONCURRENT_ACTIONS
 #ifdef SL_MEMORY_MGMT_DYNAMIC
-#define MAX_CONCURRENT_ACTIONS 18
+#define MAX_CONCURRENT_ACTIONS 32
 #else
 #define MAX_CONCURRENT_ACTIONS 5
 #endif
+#endif
 
 /*!
    \def        SL_MAX_ASYNC_BUFFERS
@@ -175,6 +179,25 @@ typedef signed int _SlFd_t;
  */
 
 #define SL_MAX_ASYNC_BUFFERS  MAX_CONCURRENT_ACTIONS
+
+/*!
+   \def        SL_SPAWN_DRAIN_MAX_MSGS
+
+   \brief      Defines the maximum number of pending NWP messages the spawn task
+            reads in a single hold of the global lock. The async events read are
+            staged in the SL_MAX_ASYNC_BUFFERS buffers and dispatched once the
+            lock is released.
+   value:      1 (one message per wake, events handled under the lock) up to
+            SL_MAX_ASYNC_BUFFERS
+
+   \sa
+
+   \note       Only used with SL_PLATFORM_MULTI_THREADED.
+            The coalescing achieved is reported in g_SlSpawnDrainStats.
+
+ */
+
+#define SL_SPAWN_DRAIN_MAX_MSGS  SL_MAX_ASYNC_BUFFERS
 /*!
         \def		CPU_FREQ_IN_MHZ
     \brief      Defines CPU frequency for Host side, for better accuracy of busy loops, if any
@@ -601,6 +624,36 @@ typedef signed int _SlFd_t;
  */
 #define sl_IfWrite                          spi_Write
 
+/*!
+    \brief attempts to write a list of buffers to the communication channel
+                as a single transaction
+
+        \param	    fd      -   file descriptor of an opened communication channel
+
+        \param		pIov    -   pointer to the list of segments (buffer and length) to
+                            send over the communication channel, in order
+
+        \param      cnt     -   number of segments in the list
+
+        \return     upon successful completion, the function shall return the total
+                number of sent bytes. Otherwise, 0 shall be returned
+
+    \sa         sl_IfWrite
+
+        \note       Optional. When defined, the driver gathers the sync pattern, the
+                command header, the descriptors and the payload of every message
+                into one call, instead of calling sl_IfWrite for each of them.
+                The buffers must be sent in place, without copying.
+
+               The prototype of the function is as follow:
+                    int xxx_IfWriteV(Fd_t Fd , const SlIfIoVec_t* pIov , int Cnt);
+
+    \note       belongs to \ref configuration_sec
+
+    \warning
+ */
+#define sl_IfWriteV                         spi_WriteV
+
 /*!
     \brief      register an interrupt handler routine for the host IRQ
 
@@ -701,6 +754,52 @@ typedef signed int _SlFd_t;
 /* A timer must be started before using this function */
 #define slcb_GetTimestamp           TimerGetCurrentTimestamp
 
+/*!
+    \brief      Host (Linux) builds run against a simulated network processor
+
+                When SL_PORT_SIMULATED_NWP is defined, the interface, IRQ, power
+                and timestamp hooks are served by sim_nwp.c instead of the SPI
+                port, so the driver and the stacks above it can be exercised
+                on POSIX loopback sockets. The internal spawn task reports
+                through slcb_SpawnTaskReady once it can take entries, so the
+                host can start the driver without guessing when that is.
+
+    \sa         sim_nwp.h
+
+    \note       belongs to \ref porting_sec
+ */
+#ifdef SL_PORT_SIMULATED_NWP
+#include <ti/drivers/net/wifi/porting/sim_nwp.h>
+
+#undef sl_IfOpen
+#undef sl_IfClose
+#undef sl_IfRead
+#undef sl_IfWrite
+#undef sl_IfWriteV
+#undef sl_IfRegIntHdlr
+#undef sl_IfMaskIntHdlr
+#undef sl_IfUnMaskIntHdlr
+#undef sl_DeviceEnable
+#undef sl_DeviceDisable
+#undef slcb_GetTimestamp
+#undef slcb_SpawnTaskReady
+
+#define sl_IfOpen                           sim_Open
+#define sl_IfClose                          sim_Close
+#define sl_IfRead                           sim_Read
+#define sl_IfWrite                          sim_Write
+#define sl_IfWriteV                         sim_WriteV
+#define sl_IfRegIntHdlr(InterruptHdl, \
+                        pValue)          SimNwpRegisterInterruptHandler( \
+        InterruptHdl, pValue)
+#define sl_IfMaskIntHdlr()                  SimNwpMaskInterrupt()
+#define sl_IfUnMaskIntHdlr()                SimNwpUnMaskInterrupt()
+#define sl_DeviceEnable()                   SimNwpPowerOn()
+#define sl_DeviceDisable()                  SimNwpPowerOff()
+#define slcb_GetTimestamp                   SimNwpGetTimestamp
+#define slcb_SpawnTaskReady()               SimNwpSpawnTaskReady()
+#endif
+
 /*!
     \brief      This macro wait for the NWP to raise a ready for shutdown indication.
 
@@ -234,8 +234,14 @@ Please see the rest of the page for more details about the different steps.
 #define _i8  signed char
 #define _u16 unsigned short
 #define _i16 signed short
+#ifndef SL_PORT_SIMULATED_NWP
 #define _u32 unsigned long
 #define _i32 signed long
+#else
+/* the protocol structures need 32-bit types on LP64 hosts as well */
+typedef unsigned int _u32;
+typedef signed int   _i32;
+#endif
 
 #define _volatile volatile
 #define _const    const
@@ -91,11 +91,26 @@ support backward sync pattern */
 /*  Actual size of Recv/Recvfrom response data  */
 #define ACT_DATA_SIZE(_ptr)   (((SlSocketAddrResponse_u *)(_ptr))->IpV4.StatusOrLen)
 
+#if (SL_SPAWN_DRAIN_MAX_MSGS > 1)
+#define _SL_SPAWN_MSG_LIST_HAS_ROOM()   (_SlSpawnMsgListGetCount() < SL_MAX_ASYNC_BUFFERS)
+#else
+#define _SL_SPAWN_MSG_LIST_HAS_ROOM()   (FALSE)
+#endif
+
 #if (defined(SL_PLATFORM_MULTI_THREADED) && !defined(slcb_SocketTriggerEventHandler))
 #define MULTI_SELECT_MASK     (~(1 << SELECT_ID))
 #else
 #define MULTI_SELECT_MASK     (0xFFFFFFFF)
 #endif
+
+/* Pool object bitmap access, Idx is an index to g_pCB->ObjPool */
+#define _SL_POOL_BITMAP_SET(pBitmap, Idx)    ((pBitmap)[(Idx) >> 5] |= ((_u32)1 << ((Idx) & 0x1F)))
+#define _SL_POOL_BITMAP_CLR(pBitmap, Idx)    ((pBitmap)[(Idx) >> 5] &= ~((_u32)1 << ((Idx) & 0x1F)))
+#define _SL_POOL_BITMAP_IS_SET(pBitmap, Idx) (0 != ((pBitmap)[(Idx) >> 5] & ((_u32)1 << ((Idx) & 0x1F))))
+
+/* Bit in ActiveActionsBitmap of an action: the socket if the action is on
+   a socket, otherwise the action itself */
+#define _SL_POOL_OBJ_RESOURCE(ActionID, SocketID)   ((SL_MAX_SOCKETS > (SocketID)) ? (SocketID) : (ActionID))
 /* Internal function prototype declaration */
 
       
@@ -508,7 +523,10 @@ typedef struct
 {
     _u32 Align;
 #ifdef SL_PLATFORM_MULTI_THREADED
+    /* FIFO ring of async events waiting to be handled in spawn context */
     _SlAsyncRespBuf_t AsyncBufPool[SL_MAX_ASYNC_BUFFERS];
+    _u8 AsyncBufHead;
+    _u8 AsyncBufCnt;
 #endif
     _u8 AsyncRespBuf[SL_ASYNC_MAX_MSG_LEN];
 }_SlStatMem_t;
@@ -530,6 +548,7 @@ _volatile _u8           RxIrqCnt;
 
 _u16            g_SlDeviceStatus = 0;
 _SlLockObj_t    GlobalLockObj;
+_SlSpawnDrainStats_t g_SlSpawnDrainStats;
 
 const _SlActionLookup_t _SlActionLookupTable[] = 
 {
@@ -602,7 +621,9 @@ static _SlReturnVal_t _SlDrvMsgReadCmdCtx(_u16 cmdOpcode, _u8 IsLockRequired);
 static _SlReturnVal_t _SlDrvClassifyRxMsg(_SlOpcode_t Opcode );
 static _SlReturnVal_t _SlDrvRxHdrRead(_u8 *pBuf);
 static void           _SlDrvAsyncEventGenericHandler(_u8 bInCmdContext, _u8 *pAsyncBuffer);
-static void           _SlDrvRemoveFromList(_u8* ListIndex, _u8 ItemIndex);
+static void           _SlDrvPoolObjReset(void);
+static _u8            _SlDrvPoolBitmapFirstSet(const _u32 *pBitmap);
+static _u8            _SlDrvIsActionAsyncOpcode(_u8 ObjIdx, _SlOpcode_t Opcode);
 static _SlReturnVal_t _SlDrvFindAndSetActiveObj(_SlOpcode_t  Opcode, _u8 Sd);
 
 /*****************************************************************************/
@@ -645,20 +666,18 @@ _SlReturnVal_t _SlDrvDriverCBInit(void)
 #endif
     /* Init Drv object */
     _SlDrvMemZero(&g_pCB->ObjPool[0], (_u16)(MAX_CONCURRENT_ACTIONS*sizeof(_SlPoolObj_t)));
-    /* place all Obj in the free list*/
-    g_pCB->FreePoolIdx = 0;
 
     for (Idx = 0 ; Idx < MAX_CONCURRENT_ACTIONS ; Idx++)
     {
-        g_pCB->ObjPool[Idx].NextIndex = Idx + 1;
+        g_pCB->ObjPool[Idx].NextIndex = MAX_CONCURRENT_ACTIONS;
         g_pCB->ObjPool[Idx].AdditionalData = SL_MAX_SOCKETS;
 
         OSI_RET_OK_CHECK( sl_SyncObjCreate(&g_pCB->ObjPool[Idx].SyncObj, "SyncObj"));
         SL_DRV_SYNC_OBJ_CLEAR(&g_pCB->ObjPool[Idx].SyncObj);
     }
 
-     g_pCB->ActivePoolIdx = MAX_CONCURRENT_ACTIONS;
-     g_pCB->PendingPoolIdx = MAX_CONCURRENT_ACTIONS;
+    /* place all Obj in the free pool */
+    _SlDrvPoolObjReset();
 
 #ifdef SL_PLATFORM_MULTI_THREADED
 
@@ -671,7 +690,10 @@ _SlReturnVal_t _SlDrvDriverCBInit(void)
         g_StatMem.AsyncBufPool[Idx].ActionIndex = 0xFF;
         g_StatMem.AsyncBufPool[Idx].AsyncHndlr = NULL;
     }
+    g_StatMem.AsyncBufHead = 0;
+    g_StatMem.AsyncBufCnt = 0;
 #endif
+    _SlDrvMemZero(&g_SlSpawnDrainStats, (_u16)sizeof(g_SlSpawnDrainStats));
 #else
     /* clear the global lock owner */
     _SlDrvSetGlobalLockOwner(GLOBAL_LOCK_CONTEXT_OWNER_APP);
@@ -718,9 +740,7 @@ _SlReturnVal_t _SlDrvDriverCBDeinit(void)
 
     OSI_RET_OK_CHECK( sl_LockObjDelete(&g_pCB->ProtectionLockObj) );
    
-    g_pCB->FreePoolIdx = 0;
-    g_pCB->PendingPoolIdx = MAX_CONCURRENT_ACTIONS;
-    g_pCB->ActivePoolIdx = MAX_CONCURRENT_ACTIONS;
+    _SlDrvPoolObjReset();
 
 #ifdef SL_MEMORY_MGMT_DYNAMIC
     /* Release linked list of async buffers */
@@ -1112,9 +1132,28 @@ _SlReturnVal_t _SlDrvDataWriteOp(
 /* ******************************************************************************/
 /*  _SlDrvMsgWrite */
 /* ******************************************************************************/
+#ifdef sl_IfWriteV
+/* The message is gathered into a list of segments (sync pattern, header,
+   descriptors, Rx payload sent as Tx and up to 3 payload parts) which is
+   written to the interface as one transaction, without copying the buffers */
+#define SL_IF_WRITE_MAX_SEGMENTS                (7)
+#define _SL_DRV_MSG_WRITE(pBuf, Len)            { IoVec[IoVecCnt].pBuff = (_u8 *)(pBuf); \
+                                                  IoVec[IoVecCnt].len = (Len); \
+                                                  IoVecLen += (Len); \
+                                                  IoVecCnt++; }
+#else
+#define _SL_DRV_MSG_WRITE(pBuf, Len)            NWP_IF_WRITE_CHECK(g_pCB->FD, (pBuf), (Len))
+#endif
+
 static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdExt, _u8 *pTxRxDescBuff)
 {
     _u8 sendRxPayload = FALSE;
+    _u8 BuffInTheMiddle[4];
+#ifdef sl_IfWriteV
+    SlIfIoVec_t IoVec[SL_IF_WRITE_MAX_SEGMENTS];
+    _i16 IoVecCnt = 0;
+    _i16 IoVecLen = 0;
+#endif
     _SL_ASSERT_ERROR(NULL != pCmdCtrl, SL_API_ABORTED);
 
     g_pCB->FunctionParams.pCmdCtrl = pCmdCtrl;
@@ -1137,20 +1176,20 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
 
 #ifdef SL_IF_TYPE_UART
     /*  Write long sync pattern */
-    NWP_IF_WRITE_CHECK(g_pCB->FD, (_u8 *)&g_H2NSyncPattern.Long, 2*SYNC_PATTERN_LEN);
+    _SL_DRV_MSG_WRITE((_u8 *)&g_H2NSyncPattern.Long, 2*SYNC_PATTERN_LEN);
 #else
     /*  Write short sync pattern */
-    NWP_IF_WRITE_CHECK(g_pCB->FD, (_u8 *)&g_H2NSyncPattern.Short, SYNC_PATTERN_LEN);
+    _SL_DRV_MSG_WRITE((_u8 *)&g_H2NSyncPattern.Short, SYNC_PATTERN_LEN);
 #endif
 
     /*  Header */
-    NWP_IF_WRITE_CHECK(g_pCB->FD, (_u8 *)&g_pCB->TempProtocolHeader, _SL_CMD_HDR_SIZE);
+    _SL_DRV_MSG_WRITE((_u8 *)&g_pCB->TempProtocolHeader, _SL_CMD_HDR_SIZE);
 
     /*  Descriptors */
     if (pTxRxDescBuff && pCmdCtrl->TxDescLen > 0)
     {
-        NWP_IF_WRITE_CHECK(g_pCB->FD, pTxRxDescBuff, 
-                           _SL_PROTOCOL_ALIGN_SIZE(pCmdCtrl->TxDescLen));
+        _SL_DRV_MSG_WRITE(pTxRxDescBuff, 
+                          _SL_PROTOCOL_ALIGN_SIZE(pCmdCtrl->TxDescLen));
     }
 
     /*  A special mode where Rx payload and Rx length are used as Tx as well */
@@ -1158,7 +1197,7 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
     /*  transceiver mode */
     if (sendRxPayload == TRUE )
     {
-         NWP_IF_WRITE_CHECK(g_pCB->FD, pCmdExt->pRxPayload, 
+         _SL_DRV_MSG_WRITE(pCmdExt->pRxPayload, 
                            _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->RxPayloadLen));
     }
 
@@ -1173,7 +1212,6 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
         /* In case two seperated buffers were supplied we should merge the two buffers*/
         if ((pCmdExt->TxPayload1Len > 0) && (pCmdExt->TxPayload2Len > 0))
         {    
-            _u8 BuffInTheMiddle[4]; 
             _u8 FirstPayloadReminder = 0;
             _u8 SecondPayloadOffset = 0;
 
@@ -1183,7 +1221,7 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
             pCmdExt->TxPayload1Len -= FirstPayloadReminder;
             
             /* writing the first transaction*/
-            NWP_IF_WRITE_CHECK(g_pCB->FD, pCmdExt->pTxPayload1, pCmdExt->TxPayload1Len);
+            _SL_DRV_MSG_WRITE(pCmdExt->pTxPayload1, pCmdExt->TxPayload1Len);
             
             /* Only if we the first payload is not aligned we need the intermediate transaction */
             if (FirstPayloadReminder != 0)
@@ -1198,7 +1236,7 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
                 sl_Memcpy(&BuffInTheMiddle[FirstPayloadReminder], pCmdExt->pTxPayload2, SecondPayloadOffset);
             
                 /* write the second transaction of the 4-bytes buffer */
-                NWP_IF_WRITE_CHECK(g_pCB->FD, &BuffInTheMiddle[0], 4);
+                _SL_DRV_MSG_WRITE(&BuffInTheMiddle[0], 4);
             }
 
             
@@ -1206,27 +1244,30 @@ static _SlReturnVal_t _SlDrvMsgWrite(_SlCmdCtrl_t  *pCmdCtrl,_SlCmdExt_t  *pCmdE
             if (pCmdExt->TxPayload2Len > SecondPayloadOffset)
             {
                 /* write the third transaction (truncated second payload) */
-                NWP_IF_WRITE_CHECK(g_pCB->FD, 
-                                   pCmdExt->pTxPayload2 + SecondPayloadOffset,
-                                   _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload2Len - SecondPayloadOffset));
+                _SL_DRV_MSG_WRITE(pCmdExt->pTxPayload2 + SecondPayloadOffset,
+                                  _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload2Len - SecondPayloadOffset));
             }
         
         }
         else if (pCmdExt->TxPayload1Len > 0)
         {
             /* Only 1 payload supplied (Payload1) so just align to 4 bytes and send it */
-            NWP_IF_WRITE_CHECK(g_pCB->FD, pCmdExt->pTxPayload1, 
-                            _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload1Len));
+            _SL_DRV_MSG_WRITE(pCmdExt->pTxPayload1, 
+                              _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload1Len));
         }
         else if (pCmdExt->TxPayload2Len > 0)
         {
             /* Only 1 payload supplied (Payload2) so just align to 4 bytes and send it */
-            NWP_IF_WRITE_CHECK(g_pCB->FD, pCmdExt->pTxPayload2, 
-                            _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload2Len));
+            _SL_DRV_MSG_WRITE(pCmdExt->pTxPayload2, 
+                              _SL_PROTOCOL_ALIGN_SIZE(pCmdExt->TxPayload2Len));
         
         }
     }
 
+#ifdef sl_IfWriteV
+    NWP_IF_WRITEV_CHECK(g_pCB->FD, IoVec, IoVecCnt, IoVecLen);
+#endif
+
     _SL_DBG_CNT_INC(MsgCnt.Write);
 
 #ifdef SL_START_WRITE_STAT
@@ -1753,6 +1794,7 @@ static _SlReturnVal_t _SlDrvMsgReadCmdCtx(_u16 cmdOpcode, _u8 IsLockRequired)
                 RetVal = _SlSpawnMsgListInsert(outMsgLen, pAsyncBuf);
                 if (SL_RET_CODE_NO_FREE_ASYNC_BUFFERS_ERROR == RetVal)
                 {
+                     g_SlSpawnDrainStats.Overflows++;
                      _SlFindAndReleasePendingCmd();
                 }
 
@@ -1831,6 +1873,22 @@ _SlReturnVal_t _SlDrvMsgReadSpawnCtx(void *pValue)
     _SlReturnVal_t RetVal = SL_OS_RET_CODE_OK;
     _u16 outMsgLen = 0;
     _u8  *pAsyncBuf = NULL;
+    _u16 DrainCnt = 0;
+#if (SL_SPAWN_DRAIN_MAX_MSGS > 1)
+    _u8  DrainFull = FALSE;
+#endif
+#ifdef slcb_GetTimestamp
+    _u32 LockTimestamp;
+#endif
+
+#if ((SL_SPAWN_DRAIN_MAX_MSGS > 1) && !defined(SL_POLLING_MODE_USED))
+    /*  A previous drain may already have read the message this request was */
+    /*  raised for. Do not contend for the global lock in that case. */
+    if(FALSE == (_SL_PENDING_RX_MSG(g_pCB)))
+    {
+        return SL_RET_CODE_OK;
+    }
+#endif
 
 #ifdef SL_POLLING_MODE_USED
 
@@ -1859,6 +1917,10 @@ _SlReturnVal_t _SlDrvMsgReadSpawnCtx(void *pValue)
     SL_DRV_LOCK_GLOBAL_LOCK_FOREVER(GLOBAL_LOCK_FLAGS_NONE);
 #endif
 
+#ifdef slcb_GetTimestamp
+    LockTimestamp = slcb_GetTimestamp();
+#endif
+
 #ifndef SL_PLATFORM_MULTI_THREADED
     /* set the global lock owner (spawn context) */
     _SlDrvSetGlobalLockOwner(GLOBAL_LOCK_CONTEXT_OWNER_SPAWN);
@@ -1881,62 +1943,126 @@ _SlReturnVal_t _SlDrvMsgReadSpawnCtx(void *pValue)
    
     if (SL_IS_DEVICE_STARTED || SL_IS_DEVICE_START_IN_PROGRESS)
     {
-
-        RetVal = _SlDrvMsgRead(&outMsgLen, &pAsyncBuf);
-
-        if (RetVal != SL_OS_RET_CODE_OK)
+        /* Drain the pending messages: keep reading while the NWP has more to
+           deliver, up to SL_SPAWN_DRAIN_MAX_MSGS per hold of the global lock.
+           Async events are staged in the spawn message list and dispatched
+           once the lock is released. */
+        do
         {
-            if (RetVal != SL_API_ABORTED)
+        #if (SL_SPAWN_DRAIN_MAX_MSGS > 1)
+            /* Leave the message pending when there is no buffer to stage
+               its event in. It is read once the staged events are handled. */
+            if (!_SL_SPAWN_MSG_LIST_HAS_ROOM())
             {
-    #ifndef SL_PLATFORM_MULTI_THREADED
-                /* clear the global lock owner (spawn context) */
-                _SlDrvSetGlobalLockOwner(GLOBAL_LOCK_CONTEXT_OWNER_APP);
-    #endif
-                SL_DRV_LOCK_GLOBAL_UNLOCK(FALSE);
+                g_SlSpawnDrainStats.Overflows++;
+                DrainFull = TRUE;
+                break;
             }
-            return SL_API_ABORTED;
-        }
+        #endif
 
-        g_pCB->RxDoneCnt++;
+            RetVal = _SlDrvMsgRead(&outMsgLen, &pAsyncBuf);
 
-        switch(g_pCB->FunctionParams.AsyncExt.RxMsgClass)
-        {
-        case ASYNC_EVT_CLASS:
-            /*  If got here and protected by LockObj a message is waiting  */
-            /*  to be read */
-            VERIFY_PROTOCOL(NULL != pAsyncBuf);
+            if (RetVal != SL_OS_RET_CODE_OK)
+            {
+                if (RetVal != SL_API_ABORTED)
+                {
+        #ifndef SL_PLATFORM_MULTI_THREADED
+                    /* clear the global lock owner (spawn context) */
+                    _SlDrvSetGlobalLockOwner(GLOBAL_LOCK_CONTEXT_OWNER_APP);
+        #endif
+                    SL_DRV_LOCK_GLOBAL_UNLOCK(FALSE);
+                }
+                return SL_API_ABORTED;
+            }
 
+            g_pCB->RxDoneCnt++;
+            DrainCnt++;
 
-            _SlDrvAsyncEventGenericHandler(FALSE, pAsyncBuf);
+            switch(g_pCB->FunctionParams.AsyncExt.RxMsgClass)
+            {
+            case ASYNC_EVT_CLASS:
+                /*  If got here and protected by LockObj a message is waiting  */
+                /*  to be read */
+                VERIFY_PROTOCOL(NULL != pAsyncBuf);
 
-    #ifdef SL_MEMORY_MGMT_DYNAMIC
-            sl_Free(pAsyncBuf);
-    #else
-            pAsyncBuf = NULL;
-    #endif
-            break;
-        case DUMMY_MSG_CLASS:
-        case RECV_RESP_CLASS:
-            /* These types are legal in this context. Do nothing */
-            break;
-        case CMD_RESP_CLASS:
-            /* Command response is illegal in this context -  */
-            /* One exception exists though: 'Select' response (SL_OPCODE_SOCKET_SELECTRESPONSE) Opcode = 0x1407 */
-            break;
-    #if (defined(SL_PLATFORM_MULTI_THREADED) && !defined(slcb_SocketTriggerEventHandler))
-        case MULTI_SELECT_RESP_CLASS:
-            /* If everything's OK, we signal for any other joiners to call 'Select'.*/
-            sl_SyncObjSignal(&g_pCB->MultiSelectCB.SelectSyncObj);
-            break;
-    #endif
-        default:
-            _SL_ASSERT_ERROR(0, SL_API_ABORTED);
+        #if (SL_SPAWN_DRAIN_MAX_MSGS > 1)
+                RetVal = _SlSpawnMsgListInsert(outMsgLen, pAsyncBuf);
+                if (SL_RET_CODE_NO_FREE_ASYNC_BUFFERS_ERROR == RetVal)
+                {
+                    /* no buffer could be allocated, handle it in place */
+                    g_SlSpawnDrainStats.Overflows++;
+                    _SlDrvAsyncEventGenericHandler(FALSE, pAsyncBuf);
+                }
+                else
+                {
+                    g_SlSpawnDrainStats.StagedEvents++;
+                }
+        #else
+                _SlDrvAsyncEventGenericHandler(FALSE, pAsyncBuf);
+        #endif
+
+        #ifdef SL_MEMORY_MGMT_DYNAMIC
+                sl_Free(pAsyncBuf);
+        #else
+                pAsyncBuf = NULL;
+        #endif
+                break;
+            case DUMMY_MSG_CLASS:
+            case RECV_RESP_CLASS:
+                /* These types are legal in this context. Do nothing */
+                break;
+            case CMD_RESP_CLASS:
+                /* Command response is illegal in this context -  */
+                /* One exception exists though: 'Select' response (SL_OPCODE_SOCKET_SELECTRESPONSE) Opcode = 0x1407 */
+                break;
+        #if (defined(SL_PLATFORM_MULTI_THREADED) && !defined(slcb_SocketTriggerEventHandler))
+            case MULTI_SELECT_RESP_CLASS:
+                /* If everything's OK, we signal for any other joiners to call 'Select'.*/
+                sl_SyncObjSignal(&g_pCB->MultiSelectCB.SelectSyncObj);
+                break;
+        #endif
+            default:
+                _SL_ASSERT_ERROR(0, SL_API_ABORTED);
+            }
         }
+        while ((DrainCnt < SL_SPAWN_DRAIN_MAX_MSGS) &&
+               (_SL_PENDING_RX_MSG(g_pCB)));
+
     #ifndef SL_PLATFORM_MULTI_THREADED
         /* clear the global lock owner (spawn context) */
         _SlDrvSetGlobalLockOwner(GLOBAL_LOCK_CONTEXT_OWNER_APP);
     #endif
+
+        /* update the coalescing statistics while still owning the lock */
+        g_SlSpawnDrainStats.Wakes++;
+        g_SlSpawnDrainStats.Msgs += DrainCnt;
+        if (DrainCnt > g_SlSpawnDrainStats.MaxMsgsPerWake)
+        {
+            g_SlSpawnDrainStats.MaxMsgsPerWake = DrainCnt;
+        }
+#ifdef slcb_GetTimestamp
+        LockTimestamp = slcb_GetTimestamp() - LockTimestamp;
+        g_SlSpawnDrainStats.LockHoldTicks += LockTimestamp;
+        if (LockTimestamp > g_SlSpawnDrainStats.MaxLockHoldTicks)
+        {
+            g_SlSpawnDrainStats.MaxLockHoldTicks = LockTimestamp;
+        }
+#endif
         SL_DRV_LOCK_GLOBAL_UNLOCK(FALSE);
+
+#if (SL_SPAWN_DRAIN_MAX_MSGS > 1)
+        /* dispatch the async events staged above */
+        if (_SlSpawnMsgListGetCount() > 0)
+        {
+            _SlSpawnMsgListProcess();
+        }
+
+        /* the drain stopped on a full list, continue with the rest */
+        if ((TRUE == DrainFull) && (_SL_PENDING_RX_MSG(g_pCB)))
+        {
+            sl_Spawn((_SlSpawnEntryFunc_t)_SlDrvMsgReadSpawnCtx, NULL, SL_SPAWN_FLAG_FROM_CMD_CTX);
+        }
+#endif
         return(SL_RET_CODE_OK);
     }
     return(SL_RET_CODE_INTERFACE_CLOSED);
@@ -2296,9 +2422,9 @@ _SlReturnVal_t _SlDrvProtectAsyncRespSetting(_u8 *pAsyncRsp, _SlActionID_e Actio
     }
     else
     {
-        SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
+        /* The obj is owned by this caller until released and the async event
+           can not arrive before the command is sent, a plain store is enough */
         g_pCB->ObjPool[ObjIdx].pRespArgs = pAsyncRsp;
-        SL_DRV_PROTECTION_OBJ_UNLOCK();
     }
 
     return ObjIdx;
@@ -2320,35 +2446,72 @@ _u8 _SlDrvIsSpawnOwnGlobalLock()
 }
 #endif
 /* ***************************************************************************** */
-/*  _SlDrvWaitForPoolObj */
+/*  _SlDrvPoolObjReset */
 /* ***************************************************************************** */
-_SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
+static void _SlDrvPoolObjReset(void)
 {
-    _u8 CurrObjIndex = MAX_CONCURRENT_ACTIONS;
+    _u8 Idx;
 
-    /* Get free object  */
-    SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
-    
-    if (MAX_CONCURRENT_ACTIONS > g_pCB->FreePoolIdx)
+    /* mark all objs as free, none active or pending */
+    _SlDrvMemZero(g_pCB->FreePoolBitmap, (_u16)sizeof(g_pCB->FreePoolBitmap));
+    _SlDrvMemZero(g_pCB->ActivePoolBitmap, (_u16)sizeof(g_pCB->ActivePoolBitmap));
+    _SlDrvMemZero(g_pCB->MultiActiveBitmap, (_u16)sizeof(g_pCB->MultiActiveBitmap));
+    for (Idx = 0 ; Idx < MAX_CONCURRENT_ACTIONS ; Idx++)
     {
-        /* save the current obj index */
-        CurrObjIndex = g_pCB->FreePoolIdx;
-        /* set the new free index */
-        if (MAX_CONCURRENT_ACTIONS > g_pCB->ObjPool[CurrObjIndex].NextIndex)
-        {
-            g_pCB->FreePoolIdx = g_pCB->ObjPool[CurrObjIndex].NextIndex;
-        }
-        else
+        _SL_POOL_BITMAP_SET(g_pCB->FreePoolBitmap, Idx);
+    }
+    for (Idx = 0 ; Idx < _SL_MAX_ACTION_RESOURCES ; Idx++)
+    {
+        g_pCB->ActiveObjIdx[Idx] = MAX_CONCURRENT_ACTIONS;
+        g_pCB->PendingObjIdx[Idx] = MAX_CONCURRENT_ACTIONS;
+    }
+    g_pCB->ActiveActionsBitmap = 0;
+}
+
+/* ***************************************************************************** */
+/*  _SlDrvPoolBitmapFirstSet */
+/* ***************************************************************************** */
+static _u8 _SlDrvPoolBitmapFirstSet(const _u32 *pBitmap)
+{
+    /* position of the lowest set bit, indexed by the de Bruijn sequence 0x077CB531 */
+    static const _u8 BitPos[32] =
+    {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    _u8 Word;
+
+    for (Word = 0 ; Word < _SL_POOL_BITMAP_WORDS ; Word++)
+    {
+        if (0 != pBitmap[Word])
         {
-            /* No further free actions available */
-            g_pCB->FreePoolIdx = MAX_CONCURRENT_ACTIONS;
+            /* the product is taken modulo 2^32, also where unsigned long is wider */
+            return (_u8)((Word << 5) + BitPos[(_u32)((pBitmap[Word] & (0 - pBitmap[Word])) * 0x077CB531UL) >> 27]);
         }
     }
-    else
+    return MAX_CONCURRENT_ACTIONS;
+}
+
+/* ***************************************************************************** */
+/*  _SlDrvWaitForPoolObj */
+/* ***************************************************************************** */
+_SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
+{
+    _u8 CurrObjIndex;
+    _u8 Resource = _SL_POOL_OBJ_RESOURCE(ActionID, SocketID);
+
+    /* Get free object  */
+    SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
+
+    CurrObjIndex = _SlDrvPoolBitmapFirstSet(g_pCB->FreePoolBitmap);
+    if (MAX_CONCURRENT_ACTIONS == CurrObjIndex)
     {
+        /* No free actions available */
         SL_DRV_PROTECTION_OBJ_UNLOCK();
         return CurrObjIndex;
     }
+    _SL_POOL_BITMAP_CLR(g_pCB->FreePoolBitmap, CurrObjIndex);
+
     g_pCB->ObjPool[CurrObjIndex].ActionID = (_u8)ActionID;
     if (SL_MAX_SOCKETS > SocketID)
     {
@@ -2356,8 +2519,7 @@ _SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
     }
     /*In case this action is socket related, SocketID bit will be on
     In case SocketID is set to SL_MAX_SOCKETS, the socket is not relevant to the action. In that case ActionID bit will be on */
-    while ( ( (SL_MAX_SOCKETS > SocketID) && (g_pCB->ActiveActionsBitmap & (1<<SocketID)) ) || 
-            ( (g_pCB->ActiveActionsBitmap & ( MULTI_SELECT_MASK & (1<<ActionID))) && (SL_MAX_SOCKETS == SocketID) ) )
+    while (g_pCB->ActiveActionsBitmap & (MULTI_SELECT_MASK & ((_u32)1 << Resource)))
     {
         /* If we are in spawn context, this is an API which was called from event handler,
         return error since there is no option to block the spawn context on the pending sync obj */
@@ -2366,14 +2528,14 @@ _SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
         {
             g_pCB->ObjPool[CurrObjIndex].ActionID = 0;
             g_pCB->ObjPool[CurrObjIndex].AdditionalData = SL_MAX_SOCKETS;
-            g_pCB->FreePoolIdx = CurrObjIndex;
+            _SL_POOL_BITMAP_SET(g_pCB->FreePoolBitmap, CurrObjIndex);
             SL_DRV_PROTECTION_OBJ_UNLOCK();
             return MAX_CONCURRENT_ACTIONS;
         }
 #endif
-        /* action in progress - move to pending list */
-        g_pCB->ObjPool[CurrObjIndex].NextIndex = g_pCB->PendingPoolIdx;
-        g_pCB->PendingPoolIdx = CurrObjIndex;
+        /* action in progress - move to the pending list of the socket / action */
+        g_pCB->ObjPool[CurrObjIndex].NextIndex = g_pCB->PendingObjIdx[Resource];
+        g_pCB->PendingObjIdx[Resource] = CurrObjIndex;
         SL_DRV_PROTECTION_OBJ_UNLOCK();
         
         /* wait for action to be free */
@@ -2387,22 +2549,19 @@ _SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
             return SL_RET_CODE_STOP_IN_PROGRESS;
         }
 
-        /* set params and move to active (remove from pending list at _SlDrvReleasePoolObj) */
+        /* set params and move to active (removed from pending list at _SlDrvReleasePoolObj) */
         SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
     }
 
     /* mark as active. Set socket as active if action is on socket, otherwise mark action as active */
-    if (SL_MAX_SOCKETS > SocketID)
-    {
-        g_pCB->ActiveActionsBitmap |= (1<<SocketID);
-    }
-    else
+    g_pCB->ActiveActionsBitmap |= ((_u32)1 << Resource);
+    g_pCB->ActiveObjIdx[Resource] = CurrObjIndex;
+    g_pCB->ObjPool[CurrObjIndex].NextIndex = MAX_CONCURRENT_ACTIONS;
+    _SL_POOL_BITMAP_SET(g_pCB->ActivePoolBitmap, CurrObjIndex);
+    if (0 == (MULTI_SELECT_MASK & ((_u32)1 << Resource)))
     {
-        g_pCB->ActiveActionsBitmap |= (1<<ActionID);
+        _SL_POOL_BITMAP_SET(g_pCB->MultiActiveBitmap, CurrObjIndex);
     }
-    /* move to active list  */
-    g_pCB->ObjPool[CurrObjIndex].NextIndex = g_pCB->ActivePoolIdx;
-    g_pCB->ActivePoolIdx = CurrObjIndex;    
     
     /* unlock */
     SL_DRV_PROTECTION_OBJ_UNLOCK();
@@ -2420,12 +2579,15 @@ _SlReturnVal_t _SlDrvWaitForPoolObj(_u8 ActionID, _u8 SocketID)
 _SlReturnVal_t _SlDrvReleasePoolObj(_u8 ObjIdx)
 {
     _u8 PendingIndex;
+    _u8 Resource;
 
     /* Delete sync obj in case stop in progress and return */
     if (SL_IS_DEVICE_STOP_IN_PROGRESS)
     {
         OSI_RET_OK_CHECK(sl_SyncObjDelete(&g_pCB->ObjPool[ObjIdx].SyncObj));
         SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
+        /* no longer active, _SlDrvReleaseAllActivePendingPoolObj must not signal it */
+        _SL_POOL_BITMAP_CLR(g_pCB->ActivePoolBitmap, ObjIdx);
         g_pCB->NumOfDeletedSyncObj++;
         SL_DRV_PROTECTION_OBJ_UNLOCK();
         return SL_RET_CODE_OK;
@@ -2433,33 +2595,44 @@ _SlReturnVal_t _SlDrvReleasePoolObj(_u8 ObjIdx)
 
     SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
 
-    /* go over the pending list and release other pending action if needed */
-    PendingIndex = g_pCB->PendingPoolIdx;
-        
-    while(MAX_CONCURRENT_ACTIONS > PendingIndex)
+    /* In case this action is socket related, SocketID is in use, otherwise will be set to SL_MAX_SOCKETS */
+    Resource = _SL_POOL_OBJ_RESOURCE(g_pCB->ObjPool[ObjIdx].ActionID,
+                                     g_pCB->ObjPool[ObjIdx].AdditionalData & SL_BSD_SOCKET_ID_MASK);
+
+    /* release the last action pending on this socket / action */
+    PendingIndex = g_pCB->PendingObjIdx[Resource];
+    if (MAX_CONCURRENT_ACTIONS > PendingIndex)
     {
-        /* In case this action is socket related, SocketID is in use, otherwise will be set to SL_MAX_SOCKETS */
-        if ( (g_pCB->ObjPool[PendingIndex].ActionID == g_pCB->ObjPool[ObjIdx].ActionID) && 
-            ( (SL_MAX_SOCKETS == (g_pCB->ObjPool[PendingIndex].AdditionalData & SL_BSD_SOCKET_ID_MASK)) || 
-            ((SL_MAX_SOCKETS > (g_pCB->ObjPool[ObjIdx].AdditionalData & SL_BSD_SOCKET_ID_MASK)) && ( (g_pCB->ObjPool[PendingIndex].AdditionalData & SL_BSD_SOCKET_ID_MASK) == (g_pCB->ObjPool[ObjIdx].AdditionalData & SL_BSD_SOCKET_ID_MASK) ))) )
-        {
-            /* remove from pending list */
-            _SlDrvRemoveFromList(&g_pCB->PendingPoolIdx, PendingIndex);
-             SL_DRV_SYNC_OBJ_SIGNAL(&g_pCB->ObjPool[PendingIndex].SyncObj);
-             break;
-        }
-        PendingIndex = g_pCB->ObjPool[PendingIndex].NextIndex;
+        g_pCB->PendingObjIdx[Resource] = g_pCB->ObjPool[PendingIndex].NextIndex;
+        g_pCB->ObjPool[PendingIndex].NextIndex = MAX_CONCURRENT_ACTIONS;
+        SL_DRV_SYNC_OBJ_SIGNAL(&g_pCB->ObjPool[PendingIndex].SyncObj);
     }
 
-    if (SL_MAX_SOCKETS > (g_pCB->ObjPool[ObjIdx].AdditionalData & SL_BSD_SOCKET_ID_MASK))
+    _SL_POOL_BITMAP_CLR(g_pCB->ActivePoolBitmap, ObjIdx);
+
+    if (0 == (MULTI_SELECT_MASK & ((_u32)1 << Resource)))
     {
-    /* unset socketID  */
-        g_pCB->ActiveActionsBitmap &= ~(1<<(g_pCB->ObjPool[ObjIdx].AdditionalData & SL_BSD_SOCKET_ID_MASK));
+        /* Actions outside MULTI_SELECT_MASK may be active in several objs.
+           The action stays active while one of them is, and another one of
+           them is kept reachable for its async event */
+        _SL_POOL_BITMAP_CLR(g_pCB->MultiActiveBitmap, ObjIdx);
+        if (g_pCB->ActiveObjIdx[Resource] == ObjIdx)
+        {
+            g_pCB->ActiveObjIdx[Resource] = _SlDrvPoolBitmapFirstSet(g_pCB->MultiActiveBitmap);
+        }
+        if (MAX_CONCURRENT_ACTIONS == g_pCB->ActiveObjIdx[Resource])
+        {
+            g_pCB->ActiveActionsBitmap &= ~((_u32)1 << Resource);
+        }
     }
     else
     {
-    /* unset actionID  */
-        g_pCB->ActiveActionsBitmap &= ~(1<<g_pCB->ObjPool[ObjIdx].ActionID);
+        /* unset socketID / actionID */
+        g_pCB->ActiveActionsBitmap &= ~((_u32)1 << Resource);
+        if (g_pCB->ActiveObjIdx[Resource] == ObjIdx)
+        {
+            g_pCB->ActiveObjIdx[Resource] = MAX_CONCURRENT_ACTIONS;
+        }
     }
 
     /* delete old data */
@@ -2467,12 +2640,8 @@ _SlReturnVal_t _SlDrvReleasePoolObj(_u8 ObjIdx)
     g_pCB->ObjPool[ObjIdx].ActionID = 0;
     g_pCB->ObjPool[ObjIdx].AdditionalData = SL_MAX_SOCKETS;
 
-    /* remove from active list */
-    _SlDrvRemoveFromList(&g_pCB->ActivePoolIdx, ObjIdx);
-
-    /* move to free list */
-    g_pCB->ObjPool[ObjIdx].NextIndex = g_pCB->FreePoolIdx;
-    g_pCB->FreePoolIdx = ObjIdx;
+    /* move to free pool */
+    _SL_POOL_BITMAP_SET(g_pCB->FreePoolBitmap, ObjIdx);
 
     SL_DRV_PROTECTION_OBJ_UNLOCK();
 
@@ -2488,14 +2657,17 @@ _SlReturnVal_t _SlDrvReleasePoolObj(_u8 ObjIdx)
 _SlReturnVal_t _SlDrvReleaseAllActivePendingPoolObj()
 {     
     _u8 ActiveIndex;
+    _u8 Resource;
 
     SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
 
-    /* go over the active list and release each action with error */
-    ActiveIndex = g_pCB->ActivePoolIdx;
-
-    while (MAX_CONCURRENT_ACTIONS > ActiveIndex)
+    /* go over the active objs and release each action with error */
+    for (ActiveIndex = 0 ; ActiveIndex < MAX_CONCURRENT_ACTIONS ; ActiveIndex++)
     {
+        if (!_SL_POOL_BITMAP_IS_SET(g_pCB->ActivePoolBitmap, ActiveIndex))
+        {
+            continue;
+        }
         /* Set error in case sync objects release due to stop device command */
         if (g_pCB->ObjPool[ActiveIndex].ActionID == NETUTIL_CMD_ID)
         {
@@ -2512,27 +2684,30 @@ _SlReturnVal_t _SlDrvReleaseAllActivePendingPoolObj()
         }
         /* Signal the pool obj*/
         SL_DRV_SYNC_OBJ_SIGNAL(&g_pCB->ObjPool[ActiveIndex].SyncObj);
-        ActiveIndex = g_pCB->ObjPool[ActiveIndex].NextIndex;
     }
 
-    /* go over the pending list and release each action */
-    ActiveIndex = g_pCB->PendingPoolIdx;
-
-    while (MAX_CONCURRENT_ACTIONS > ActiveIndex)
+    /* go over the pending lists and release each action */
+    for (Resource = 0 ; Resource < _SL_MAX_ACTION_RESOURCES ; Resource++)
     {
-        /* Signal the pool obj*/
-        SL_DRV_SYNC_OBJ_SIGNAL(&g_pCB->ObjPool[ActiveIndex].SyncObj);
-        ActiveIndex = g_pCB->ObjPool[ActiveIndex].NextIndex;
+        ActiveIndex = g_pCB->PendingObjIdx[Resource];
+
+        while (MAX_CONCURRENT_ACTIONS > ActiveIndex)
+        {
+            /* Signal the pool obj*/
+            SL_DRV_SYNC_OBJ_SIGNAL(&g_pCB->ObjPool[ActiveIndex].SyncObj);
+            ActiveIndex = g_pCB->ObjPool[ActiveIndex].NextIndex;
+        }
     }
 
-    /* Delete only unoccupied objects from the Free list, other obj (pending and active)
+    /* Delete only unoccupied objects from the Free pool, other obj (pending and active)
     will be deleted from the relevant context */
-    ActiveIndex = g_pCB->FreePoolIdx;
-    while(MAX_CONCURRENT_ACTIONS > ActiveIndex)
+    for (ActiveIndex = 0 ; ActiveIndex < MAX_CONCURRENT_ACTIONS ; ActiveIndex++)
     {
-        OSI_RET_OK_CHECK(sl_SyncObjDelete(&g_pCB->ObjPool[ActiveIndex].SyncObj));
-        g_pCB->NumOfDeletedSyncObj++;
-        ActiveIndex = g_pCB->ObjPool[ActiveIndex].NextIndex;
+        if (_SL_POOL_BITMAP_IS_SET(g_pCB->FreePoolBitmap, ActiveIndex))
+        {
+            OSI_RET_OK_CHECK(sl_SyncObjDelete(&g_pCB->ObjPool[ActiveIndex].SyncObj));
+            g_pCB->NumOfDeletedSyncObj++;
+        }
     }
     /* In case trigger select in progress, delete the sync obj */
 #if defined(slcb_SocketTriggerEventHandler)
@@ -2547,58 +2722,39 @@ _SlReturnVal_t _SlDrvReleaseAllActivePendingPoolObj()
 }
 
 /* ******************************************************************************/
-/* _SlDrvRemoveFromList  */
+/*  _SlDrvIsActionAsyncOpcode                                                     */
 /* ******************************************************************************/
-static void _SlDrvRemoveFromList(_u8 *ListIndex, _u8 ItemIndex)
+static _u8 _SlDrvIsActionAsyncOpcode(_u8 ObjIdx, _SlOpcode_t Opcode)
 {
-    _u8 Idx;
-        
-    if (MAX_CONCURRENT_ACTIONS == g_pCB->ObjPool[*ListIndex].NextIndex)
-    {
-        *ListIndex = MAX_CONCURRENT_ACTIONS;
-    }
-    /* need to remove the first item in the list and therefore update the global which holds this index */
-    else if (*ListIndex == ItemIndex)
+    _u8 LookupIdx = g_pCB->ObjPool[ObjIdx].ActionID - MAX_SOCKET_ENUM_IDX;
+
+    /* unset the Ipv4\IPv6 bit in the opcode if family bit was set  */
+    if (g_pCB->ObjPool[ObjIdx].AdditionalData & SL_NETAPP_FAMILY_MASK)
     {
-        *ListIndex = g_pCB->ObjPool[ItemIndex].NextIndex;
+        Opcode &= ~SL_OPCODE_IPV6;
     }
-    else
-    {
-        Idx = *ListIndex;
-      
-        while(MAX_CONCURRENT_ACTIONS > Idx)
-        {
-            /* remove from list */
-            if (g_pCB->ObjPool[Idx].NextIndex == ItemIndex)
-            {
-                g_pCB->ObjPool[Idx].NextIndex = g_pCB->ObjPool[ItemIndex].NextIndex;
-                break;
-            }
 
-            Idx = g_pCB->ObjPool[Idx].NextIndex;
-        }
-    }
+    return (LookupIdx < (sizeof(_SlActionLookupTable) / sizeof(_SlActionLookupTable[0]))) &&
+           (_SlActionLookupTable[LookupIdx].ActionAsyncOpcode == Opcode);
 }
 
-
 /* ******************************************************************************/
 /*  _SlDrvFindAndSetActiveObj                                                     */
 /* ******************************************************************************/
 static _SlReturnVal_t _SlDrvFindAndSetActiveObj(_SlOpcode_t  Opcode, _u8 Sd)
 {
-    _u8 ActiveIndex;
-
-    ActiveIndex = g_pCB->ActivePoolIdx;
-    /* go over the active list if exist to find obj waiting for this Async event */
+    _u8 ActiveIndex = MAX_CONCURRENT_ACTIONS;
+    _u8 Resource;
+    _u32 ActiveActions;
 
-    while (MAX_CONCURRENT_ACTIONS > ActiveIndex)
+    /* A socket has at most one action in progress: look it up directly */
+    if (SL_MAX_SOCKETS > Sd)
     {
-        /* unset the Ipv4\IPv6 bit in the opcode if family bit was set  */
-        if (g_pCB->ObjPool[ActiveIndex].AdditionalData & SL_NETAPP_FAMILY_MASK)
-        {
-            Opcode &= ~SL_OPCODE_IPV6;
-        }
+        ActiveIndex = g_pCB->ActiveObjIdx[Sd];
+    }
 
+    if (MAX_CONCURRENT_ACTIONS > ActiveIndex)
+    {
         if ((g_pCB->ObjPool[ActiveIndex].ActionID == RECV_ID) && (Sd == g_pCB->ObjPool[ActiveIndex].AdditionalData) && 
                         ( (SL_OPCODE_SOCKET_RECVASYNCRESPONSE == Opcode) || (SL_OPCODE_SOCKET_RECVFROMASYNCRESPONSE == Opcode)
                         || (SL_OPCODE_SOCKET_RECVFROMASYNCRESPONSE_V6 == Opcode))
@@ -2607,16 +2763,33 @@ static _SlReturnVal_t _SlDrvFindAndSetActiveObj(_SlOpcode_t  Opcode, _u8 Sd)
             g_pCB->FunctionParams.AsyncExt.ActionIndex = ActiveIndex;
             return SL_RET_CODE_OK;
         }
-        /* In case this action is socket related, SocketID is in use, otherwise will be set to SL_MAX_SOCKETS */
-        if ( (_SlActionLookupTable[ g_pCB->ObjPool[ActiveIndex].ActionID - MAX_SOCKET_ENUM_IDX].ActionAsyncOpcode == Opcode) && 
-            ( ((Sd == (g_pCB->ObjPool[ActiveIndex].AdditionalData & SL_BSD_SOCKET_ID_MASK) ) && (SL_MAX_SOCKETS > Sd)) || (SL_MAX_SOCKETS == (g_pCB->ObjPool[ActiveIndex].AdditionalData & SL_BSD_SOCKET_ID_MASK)) ) )
+        if (_SlDrvIsActionAsyncOpcode(ActiveIndex, Opcode))
+        {
+            /* set handler */
+            g_pCB->FunctionParams.AsyncExt.AsyncEvtHandler = _SlActionLookupTable[ g_pCB->ObjPool[ActiveIndex].ActionID - MAX_SOCKET_ENUM_IDX].AsyncEventHandler;
+            g_pCB->FunctionParams.AsyncExt.ActionIndex = ActiveIndex;
+            return SL_RET_CODE_OK;
+        }
+    }
+
+    /* go over the active actions which are not related to a socket */
+    ActiveActions = g_pCB->ActiveActionsBitmap >> MAX_SOCKET_ENUM_IDX;
+    Resource = MAX_SOCKET_ENUM_IDX;
+
+    while (0 != ActiveActions)
+    {
+        ActiveIndex = g_pCB->ActiveObjIdx[Resource];
+
+        if ((ActiveActions & 1) && (MAX_CONCURRENT_ACTIONS > ActiveIndex) &&
+            _SlDrvIsActionAsyncOpcode(ActiveIndex, Opcode))
         {
             /* set handler */
             g_pCB->FunctionParams.AsyncExt.AsyncEvtHandler = _SlActionLookupTable[ g_pCB->ObjPool[ActiveIndex].ActionID - MAX_SOCKET_ENUM_IDX].AsyncEventHandler;
             g_pCB->FunctionParams.AsyncExt.ActionIndex = ActiveIndex;
             return SL_RET_CODE_OK;
         }
-        ActiveIndex = g_pCB->ObjPool[ActiveIndex].NextIndex;
+        ActiveActions >>= 1;
+        Resource++;
     }
 
     return SL_RET_OBJ_NOT_SET;
@@ -3000,16 +3173,11 @@ _SlReturnVal_t _SlDrvWaitForInternalAsyncEvent(_u8 ObjIdx , _u32 Timeout, _SlOpc
 #if (defined(SL_PLATFORM_MULTI_THREADED) && !defined(SL_MEMORY_MGMT_DYNAMIC))
 _SlAsyncRespBuf_t* _SlGetStatSpawnListItem(_u16 AsyncEventLen)
 {
-    _u8 Idx = 0;
-    /* Find free buffer from the pool */
-    while (Idx < SL_MAX_ASYNC_BUFFERS)
+    /* The pool is used as a FIFO ring so the events are handled in the
+       order they were read from the NWP. Return the slot after the tail. */
+    if (g_StatMem.AsyncBufCnt < SL_MAX_ASYNC_BUFFERS)
     {
-        if (0xFF == g_StatMem.AsyncBufPool[Idx].ActionIndex)
-        {
-            /* copy buffer */
-            return &g_StatMem.AsyncBufPool[Idx];
-        }
-        Idx++;
+        return &g_StatMem.AsyncBufPool[(g_StatMem.AsyncBufHead + g_StatMem.AsyncBufCnt) % SL_MAX_ASYNC_BUFFERS];
     }
     return NULL;
 }
@@ -3071,6 +3239,9 @@ _SlReturnVal_t _SlSpawnMsgListInsert(_u16 AsyncEventLen, _u8 *pAsyncBuf)
         pItem->AsyncHndlr = g_pCB->FunctionParams.AsyncExt.AsyncEvtHandler;
         /* copy the async event that we read to the buffer */
         sl_Memcpy(pItem->Buffer, pAsyncBuf, AsyncEventLen);
+#ifndef SL_MEMORY_MGMT_DYNAMIC
+        g_StatMem.AsyncBufCnt++;
+#endif
     }
     else
     {
@@ -3115,30 +3286,31 @@ _SlReturnVal_t _SlSpawnMsgListProcess()
     }
 
 #else
-    _u8 i;
+    _SlAsyncRespBuf_t* pItem;
 
-    for (i = 0; i < SL_MAX_ASYNC_BUFFERS; i++)
+    /* only the spawn context removes items, so the head is stable here */
+    while (g_StatMem.AsyncBufCnt > 0)
     {
-        if (0xFF != g_StatMem.AsyncBufPool[i].ActionIndex)
-        {
-            /* lock during action */
-        
-            SL_DRV_LOCK_GLOBAL_LOCK_FOREVER(GLOBAL_LOCK_FLAGS_NONE);
+        pItem = &g_StatMem.AsyncBufPool[g_StatMem.AsyncBufHead];
 
-            /* load the async event params */
-            g_pCB->FunctionParams.AsyncExt.ActionIndex = g_StatMem.AsyncBufPool[i].ActionIndex;
-            g_pCB->FunctionParams.AsyncExt.AsyncEvtHandler = g_StatMem.AsyncBufPool[i].AsyncHndlr;
+        /* lock during action */
+        SL_DRV_LOCK_GLOBAL_LOCK_FOREVER(GLOBAL_LOCK_FLAGS_NONE);
 
-            /* Handle async event: here we are in spawn context, after context
-            * switch from command context. */
-            _SlDrvAsyncEventGenericHandler(FALSE, (unsigned char *)&(g_StatMem.AsyncBufPool[i].Buffer));
+        /* load the async event params */
+        g_pCB->FunctionParams.AsyncExt.ActionIndex = pItem->ActionIndex;
+        g_pCB->FunctionParams.AsyncExt.AsyncEvtHandler = pItem->AsyncHndlr;
 
-            SL_DRV_LOCK_GLOBAL_UNLOCK(FALSE);
+        /* Handle async event: here we are in spawn context, after context
+        * switch from command context. */
+        _SlDrvAsyncEventGenericHandler(FALSE, (unsigned char *)&(pItem->Buffer));
 
-            SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
-            g_StatMem.AsyncBufPool[i].ActionIndex = 0xFF;
-            SL_DRV_PROTECTION_OBJ_UNLOCK();
-        }
+        SL_DRV_LOCK_GLOBAL_UNLOCK(FALSE);
+
+        SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
+        pItem->ActionIndex = 0xFF;
+        g_StatMem.AsyncBufHead = (g_StatMem.AsyncBufHead + 1) % SL_MAX_ASYNC_BUFFERS;
+        g_StatMem.AsyncBufCnt--;
+        SL_DRV_PROTECTION_OBJ_UNLOCK();
     }
 #endif
     return SL_OS_RET_CODE_OK;
@@ -3161,17 +3333,9 @@ _u16 _SlSpawnMsgListGetCount()
     SL_DRV_PROTECTION_OBJ_UNLOCK();
 
 #else
-    _u8 i;
     /* protect counting parameters  */
     SL_DRV_PROTECTION_OBJ_LOCK_FOREVER();
-
-    for (i = 0; i < SL_MAX_ASYNC_BUFFERS; i++)
-    {
-        if (0xFF != g_StatMem.AsyncBufPool[i].ActionIndex)
-        {
-            NumOfItems++;
-        }
-    }
+    NumOfItems = g_StatMem.AsyncBufCnt;
     SL_DRV_PROTECTION_OBJ_UNLOCK();
 #endif
     return NumOfItems;
@@ -179,10 +179,28 @@ if (retVal)         \
 
 #define _SL_PENDING_RX_MSG(pDriverCB)   (RxIrqCnt != (pDriverCB)->RxDoneCnt)
 
+/* Draining several NWP messages per wake requires the spawn message list */
+#if (!defined(SL_SPAWN_DRAIN_MAX_MSGS) || !defined(SL_PLATFORM_MULTI_THREADED))
+#undef SL_SPAWN_DRAIN_MAX_MSGS
+#define SL_SPAWN_DRAIN_MAX_MSGS         (1)
+#endif
+
 /*****************************************************************************/
 /* Structure/Enum declarations                                               */
 /*****************************************************************************/
 
+/* Coalescing statistics of the spawn context message drain */
+typedef struct
+{
+    _u32  Wakes;              /* times the spawn context took the lock to read */
+    _u32  Msgs;               /* NWP messages read by the spawn context        */
+    _u32  StagedEvents;       /* async events dispatched after the lock hold   */
+    _u32  MaxMsgsPerWake;     /* most messages read in a single lock hold      */
+    _u32  LockHoldTicks;      /* slcb_GetTimestamp ticks the lock was held     */
+    _u32  MaxLockHoldTicks;   /* longest single lock hold                      */
+    _u32  Overflows;          /* async events that found the staging list full */
+} _SlSpawnDrainStats_t;
+
 typedef struct _SlSpawnMsgItem_s
 {
     _SlSpawnEntryFunc_t      AsyncHndlr;
@@ -274,6 +292,12 @@ typedef enum
     RECV_ID /* Please note!! this member must be the last in this action enum */
 }_SlActionID_e;
 
+/* Sockets and actions which own a bit in ActiveActionsBitmap */
+#define _SL_MAX_ACTION_RESOURCES    (RECV_ID + 1)
+
+/* Words of the pool object bitmaps, one bit per ObjPool entry */
+#define _SL_POOL_BITMAP_WORDS       ((MAX_CONCURRENT_ACTIONS + 31) / 32)
+
 typedef struct _SlActionLookup_t
 {
     _u8                     ActionID;
@@ -372,9 +396,11 @@ typedef struct
     P_INIT_CALLBACK         pInitCallback;
 
     _SlPoolObj_t            ObjPool[MAX_CONCURRENT_ACTIONS];
-    _u8                     FreePoolIdx;
-    _u8                     PendingPoolIdx;
-    _u8                     ActivePoolIdx;
+    _u32                    FreePoolBitmap[_SL_POOL_BITMAP_WORDS];
+    _u32                    ActivePoolBitmap[_SL_POOL_BITMAP_WORDS];
+    _u32                    MultiActiveBitmap[_SL_POOL_BITMAP_WORDS]; /* active objs of actions outside MULTI_SELECT_MASK */
+    _u8                     ActiveObjIdx[_SL_MAX_ACTION_RESOURCES];  /* active obj of each socket / action */
+    _u8                     PendingObjIdx[_SL_MAX_ACTION_RESOURCES]; /* head of the objs pending on each socket / action */
     _u32                    ActiveActionsBitmap;
     _SlLockObj_t            ProtectionLockObj;
 
@@ -417,6 +443,7 @@ typedef struct
 extern _volatile _u8    RxIrqCnt;
 
 extern _SlLockObj_t        GlobalLockObj;
+extern _SlSpawnDrainStats_t g_SlSpawnDrainStats;
 extern _u16                g_SlDeviceStatus;
 
 extern _SlDriverCb_t* g_pCB;
@@ -459,7 +486,9 @@ extern _u8 _SlDrvIsTimeoutExpired(_SlTimeoutParams_t *pTimeoutInfo);
 extern void _SlDrvSleep(_u16 DurationInMsec);
 #endif
 
-#if defined(SL_PLATFORM_MULTI_THREADED)
+#if defined(SL_PORT_SIMULATED_NWP)
+#include <pthread.h>
+#elif defined(SL_PLATFORM_MULTI_THREADED)
 extern void * pthread_self(void);
 #endif
 
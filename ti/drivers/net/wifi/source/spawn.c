@@ -103,6 +103,11 @@ void* _SlInternalSpawnTaskEntry()
     g_SlInternalSpawnCB.IrqReadCnt = 0;
     g_SlInternalSpawnCB.pIrqFuncValue = NULL;
 
+#ifdef slcb_SpawnTaskReady
+    /* the sync object exists, the driver may be started */
+    slcb_SpawnTaskReady();
+#endif
+
     /* here we ready to execute entries */
     while (TRUE)
     {
@@ -116,12 +116,15 @@ extern "C" {
 #if (SL_NWP_IF_HANDLING == SL_HANDLING_ASSERT)
 #define NWP_IF_WRITE_CHECK(fd,pBuff,len)       { _i16 RetSize, ExpSize = (_i16)(len); RetSize = sl_IfWrite((fd),(pBuff),ExpSize); _SL_ASSERT(ExpSize == RetSize)}
 #define NWP_IF_READ_CHECK(fd,pBuff,len)        { _i16 RetSize, ExpSize = (_i16)(len); RetSize = sl_IfRead((fd),(pBuff),ExpSize);  _SL_ASSERT(ExpSize == RetSize)}
+#define NWP_IF_WRITEV_CHECK(fd,pIov,cnt,len)   { _i16 RetSize, ExpSize = (_i16)(len); RetSize = sl_IfWriteV((fd),(pIov),(cnt)); _SL_ASSERT(ExpSize == RetSize)}
 #elif (SL_NWP_IF_HANDLING == SL_HANDLING_ERROR)
 #define NWP_IF_WRITE_CHECK(fd,pBuff,len)       { _SL_ERROR((len == sl_IfWrite((fd),(pBuff),(len))), SL_RET_CODE_NWP_IF_ERROR);}
 #define NWP_IF_READ_CHECK(fd,pBuff,len)        { _SL_ERROR((len == sl_IfRead((fd),(pBuff),(len))),  SL_RET_CODE_NWP_IF_ERROR);}
+#define NWP_IF_WRITEV_CHECK(fd,pIov,cnt,len)   { _SL_ERROR((len == sl_IfWriteV((fd),(pIov),(cnt))), SL_RET_CODE_NWP_IF_ERROR);}
 #else
 #define NWP_IF_WRITE_CHECK(fd,pBuff,len)       { sl_IfWrite((fd),(pBuff),(len));}
 #define NWP_IF_READ_CHECK(fd,pBuff,len)        { sl_IfRead((fd),(pBuff),(len));}
+#define NWP_IF_WRITEV_CHECK(fd,pIov,cnt,len)   { sl_IfWriteV((fd),(pIov),(cnt));}
 #endif
 
 #if (SL_OSI_RET_OK_HANDLING == SL_HANDLING_ASSERT)
@@ -56,6 +56,17 @@
 #define MQTTCLIENTCORE_MAX_NWCONN CFG_CL_MQTT_CTXS
 #endif
 
+/* Messages (PUBLISH, SUBSCRIBE, UNSUBSCRIBE) that a context can have awaiting
+ a Level 1 ACK at a time. The buffer pool must have MQP(s) to back them. */
+#ifndef CFG_CL_MQTT_MAX_INFLT
+#define MQTTCLIENTCORE_MAX_INFLT 16
+#else
+#define MQTTCLIENTCORE_MAX_INFLT CFG_CL_MQTT_MAX_INFLT
+#endif
+
+/* Slots in the Message-ID index to the Wait-List, kept at most half full */
+#define MQTTCLIENTCORE_ACK_IDX_LEN (MQTTCLIENTCORE_MAX_INFLT * 2)
+
 #define MQTTCLIENTCORE_CLEAN_SESSION_FLAG    0x00010000
 #define MQTTCLIENTCORE_CONNACK_AWAIT_FLAG    0x00020000
 #define MQTTCLIENTCORE_NOW_CONNECTED_FLAG    0x00040000
@@ -131,6 +142,16 @@ typedef struct _MQTTClientCore_txPartPkt_t_
     uint32_t offset; /* Next data for sending */
 }MQTTClientCore_txPartPkt_t;
 
+/* Slot of the open addressed index to the Wait-List for Level 1 ACK(s). The
+ Message-IDs are consecutive odd numbers, so each MQP mostly sits in its home
+ slot and an ACK is matched without walking the Wait-List.
+ */
+typedef struct _MQTTClientCore_AckIdx_t_
+{
+    MQTT_Packet_t *mqp;  /* MQP awaiting ACK, NULL if the slot is free */
+    MQTT_Packet_t *prev; /* MQP ahead of it in Wait-List, NULL at head */
+}MQTTClientCore_AckIdx_t;
+
 
 typedef struct _MQTTClientCore_ClientDesc_t_
 {
@@ -145,6 +166,9 @@ typedef struct _MQTTClientCore_ClientDesc_t_
 
     /* Wait-List for Level 1 ACK(s), which are PUBACK, PUBREC, UN/SUBACK */
     MQTT_AckWlist_t qosAck1WaitList;
+    MQTTClientCore_AckIdx_t ackIdx[MQTTCLIENTCORE_ACK_IDX_LEN];
+    uint16_t nAckAwaited; /* MQP(s) in the Wait-List             */
+    uint16_t nPubAwaited; /* PUBLISH MQP(s) among the ones above */
 
     /* Circular queue to track QOS2 PUBLISH packets from the server. They
      are tracked for the duration of PUBLISH-RX to PUBREL-RX.
@@ -160,6 +184,9 @@ typedef struct _MQTTClientCore_ClientDesc_t_
 
     MQTTClientCore_txPartPkt_t txPart;/* Reference to partial TX PKT */
     MQTT_Packet_t *mqpRx; /* Reference to partial RX PKT */
+    MQTT_RxBuf_t rxBuf;   /* Staged RX data from the network */
+    int32_t usedIdx;      /* Slot in group heap, -1 if not in it */
+    MQTTClientCore_CtxStats_t stats;
     void *app;
 
     uint32_t nwconnOpts;
@@ -174,6 +201,7 @@ typedef struct _MQTTClientCore_ClientDesc_t_
 //*****************************************************************************
 
 static MQTT_Packet_t *MQTTClientCore_freeList = NULL;
+static uint32_t MQTTClientCore_freeCnt = 0;
 
 MQTTClientCore_ClientDesc_t clients[MQTTCLIENTCORE_MAX_NWCONN];
 
@@ -191,15 +219,25 @@ static uint16_t MQTTClientCore_loopbPortid = 0;
 static bool MQTTClientCore_grpHasCBFn = false;
 
 static MQTT_ClientCtx_t *MQTTClientCore_freeCtxs = NULL; /* CTX construct available */
-static MQTT_ClientCtx_t *MQTTClientCore_usedCtxs = NULL; /* Relevant only for group */
 static MQTT_ClientCtx_t *MQTTClientCore_connCtxs = NULL; /* Relevant only for group */
 
+/* Group 'ctx'(s) served by the RX task, kept as a min-heap of their timeout.
+ The interest set for ioMon() holds the nets of the heap in the same order,
+ with a trailing -1, and is maintained along with the heap.
+ */
+static MQTT_ClientCtx_t *MQTTClientCore_usedHeap[MQTTCLIENTCORE_MAX_NWCONN];
+static int32_t MQTTClientCore_usedNets[MQTTCLIENTCORE_MAX_NWCONN + 1] = { -1 };
+static uint32_t MQTTClientCore_nUsed = 0;
+static bool MQTTClientCore_closeReq = false; /* TX asked RX to close 'ctx' */
+
 /* Define protocol information for the supported versions */
 static uint8_t MQTTClientCore_mqtt310[] = { 0x00, 0x06, 'M', 'Q', 'I', 's', 'd', 'p', 0x03 };
 static uint8_t MQTTClientCore_mqtt311[] = { 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04 };
 
 /* GROUP LISTEN PORT + VEC END */
 static int32_t MQTTClientCore_recvHvec[MQTTCLIENTCORE_MAX_NWCONN + 1 + 1];
+/* Nets w/ a complete packet in their RX buffer + VEC END */
+static int32_t MQTTClientCore_bufdHvec[MQTTCLIENTCORE_MAX_NWCONN + 1];
 static int32_t MQTTClientCore_sendHvec = -1;
 static int32_t MQTTClientCore_rsvdHvec = -1;
 
@@ -212,6 +250,167 @@ static inline uint16_t assignNewMsgID(void)
     return (MQTTClientCore_msgID += 2);
 }
 
+static inline uint32_t ackIdxHome(uint16_t msgID)
+{
+    return ((msgID >> 1) % MQTTCLIENTCORE_ACK_IDX_LEN);
+}
+
+static inline uint32_t ackIdxNext(uint32_t idx)
+{
+    return ((idx + 1 < MQTTCLIENTCORE_ACK_IDX_LEN) ? (idx + 1) : 0);
+}
+
+static MQTTClientCore_AckIdx_t *ackIdxFind(MQTTClientCore_ClientDesc_t *client, uint16_t msgID)
+{
+    uint32_t idx = ackIdxHome(msgID);
+
+    while (NULL != client->ackIdx[idx].mqp)
+    {
+        if (msgID == client->ackIdx[idx].mqp->msgID)
+        {
+            return client->ackIdx + idx;
+        }
+        idx = ackIdxNext(idx);
+    }
+
+    return NULL;
+}
+
+static void ackIdxDelete(MQTTClientCore_ClientDesc_t *client, MQTTClientCore_AckIdx_t *ackIdx)
+{
+    uint32_t hole = ackIdx - client->ackIdx;
+    uint32_t idx;
+    uint32_t home;
+
+    /* Pull back the following entries of the probe run to fill the hole,
+     unless their home slot lies after the hole (cyclically) */
+    for (idx = ackIdxNext(hole); NULL != client->ackIdx[idx].mqp; idx = ackIdxNext(idx))
+    {
+        home = ackIdxHome(client->ackIdx[idx].mqp->msgID);
+        if ((hole <= idx) ? ((hole < home) && (home <= idx)) : ((hole < home) || (home <= idx)))
+        {
+            continue;
+        }
+        client->ackIdx[hole] = client->ackIdx[idx];
+        hole = idx;
+    }
+    client->ackIdx[hole].mqp = NULL;
+    client->ackIdx[hole].prev = NULL;
+
+    return;
+}
+
+//*****************************************************************************
+//
+//! \brief Enlist MQP into Wait-List for Level 1 ACK(s) and index it.
+//! Returns false, if the context already has the maximum in-flight messages
+//
+//*****************************************************************************
+static bool ackWlAppend(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqp)
+{
+    MQTTClientCore_ClientDesc_t *client = CLIENT(clCtx);
+    uint32_t idx = ackIdxHome(mqp->msgID);
+
+    if (MQTTCLIENTCORE_MAX_INFLT <= client->nAckAwaited)
+    {
+        return false;
+    }
+    while (NULL != client->ackIdx[idx].mqp)
+    {
+        idx = ackIdxNext(idx);
+    }
+    client->ackIdx[idx].mqp = mqp;
+    client->ackIdx[idx].prev = client->qosAck1WaitList.tail;
+
+    MQTT_packetAckWlistAppend(&client->qosAck1WaitList, mqp);
+
+    client->nAckAwaited++;
+    if (MQTT_PUBLISH == mqp->msgType)
+    {
+        client->nPubAwaited++;
+    }
+
+    return true;
+}
+
+//*****************************************************************************
+//
+//! \brief Remove the MQP with specified msgID from Wait-List for Level 1 ACK(s)
+//! in constant time. Returns, on success, the MQP, otherwise NULL.
+//
+//*****************************************************************************
+static MQTT_Packet_t *ackWlRemove(MQTT_ClientCtx_t *clCtx, uint16_t msgID)
+{
+    MQTTClientCore_ClientDesc_t *client = CLIENT(clCtx);
+    MQTT_AckWlist_t *wl = &client->qosAck1WaitList;
+    MQTTClientCore_AckIdx_t *ackIdx = ackIdxFind(client, msgID);
+    MQTT_Packet_t *mqp;
+    MQTT_Packet_t *prev;
+
+    if (NULL == ackIdx)
+    {
+        return NULL;
+    }
+    mqp = ackIdx->mqp;
+    prev = ackIdx->prev;
+
+    if (prev)
+    {
+        prev->next = mqp->next;
+    }
+    else
+    {
+        wl->head = mqp->next;
+    }
+    if (wl->tail == mqp)
+    {
+        wl->tail = prev;
+    }
+    else
+    {
+        /* The MQP behind now follows the one ahead */
+        ackIdxFind(client, mqp->next->msgID)->prev = prev;
+    }
+    mqp->next = NULL;
+
+    ackIdxDelete(client, ackIdx);
+
+    client->nAckAwaited--;
+    if (MQTT_PUBLISH == mqp->msgType)
+    {
+        client->nPubAwaited--;
+    }
+
+    return mqp;
+}
+
+static void ackWlPurge(MQTT_ClientCtx_t *clCtx)
+{
+    MQTTClientCore_ClientDesc_t *client = CLIENT(clCtx);
+
+    MQTT_packetAckWlistPurge(&client->qosAck1WaitList);
+
+    memset(client->ackIdx, 0, sizeof(client->ackIdx));
+    client->nAckAwaited = 0;
+    client->nPubAwaited = 0;
+
+    return;
+}
+
+static bool ack1WlRmfree(MQTT_ClientCtx_t *clCtx, uint16_t msgID)
+{
+    MQTT_Packet_t *mqp = ackWlRemove(clCtx, msgID);
+
+    if (NULL != mqp)
+    {
+        MQTT_packetFree(mqp);
+        return true;
+    }
+
+    /* Err: Unexpected ACK  */
+    return false;
+}
+
 static bool txPartSetup(MQTTClientCore_txPartPkt_t *txPart, const uint8_t *buffer, uint32_t length, MQTT_Packet_t *mqpTx)
 {
     if (mqpTx)
@@ -288,7 +487,7 @@ static void clientReset(MQTTClientCore_ClientDesc_t *client)
     }
     client->willOpts = 0;
 
-    MQTT_packetAckWlistPurge(&client->qosAck1WaitList);
+    ackWlPurge((MQTT_ClientCtx_t *)(client));
 
     MQTT_qos2PubCqReset(&client->rxQos2CircularQueue);
     MQTT_qos2PubCqReset(&client->txQos2CircularQueue);
@@ -299,6 +498,9 @@ static void clientReset(MQTTClientCore_ClientDesc_t *client)
 
     txPartReset(&client->txPart);
     client->mqpRx = NULL;
+    MQTT_rxBufReset(&client->rxBuf);
+    client->usedIdx = -1;
+    memset(&client->stats, 0, sizeof(MQTTClientCore_CtxStats_t));
     client->app = NULL;
 
     client->nwconnOpts = 0;
@@ -375,7 +577,7 @@ static void session311fix(MQTT_ClientCtx_t *clCtx)
         next = elem->next;
         if (MQTT_PUBLISH != elem->msgType)
         {
-            MQTT_packetAckWlistRemove(wl, elem->msgID);
+            ack1WlRmfree(clCtx, elem->msgID);
         }
         elem = next;
     }
@@ -391,7 +593,7 @@ static void sessionDelete(MQTT_ClientCtx_t *clCtx)
     MQTT_qos2PubCqReset(&client->rxQos2CircularQueue);
     MQTT_qos2PubCqReset(&client->txQos2CircularQueue);
 
-    MQTT_packetAckWlistPurge(&client->qosAck1WaitList);
+    ackWlPurge(clCtx);
 
     return;
 }
@@ -437,6 +639,97 @@ static void doNetClose(MQTT_ClientCtx_t *clCtx)
     return;
 }
 
+static void usedHeapSet(uint32_t idx, MQTT_ClientCtx_t *clCtx)
+{
+    MQTTClientCore_usedHeap[idx] = clCtx;
+    MQTTClientCore_usedNets[idx] = clCtx->net;
+    CLIENT(clCtx)->usedIdx = idx;
+}
+
+static void usedHeapSiftUp(uint32_t idx)
+{
+    MQTT_ClientCtx_t *clCtx = MQTTClientCore_usedHeap[idx];
+    uint32_t parent;
+
+    while (idx > 0)
+    {
+        parent = (idx - 1) >> 1;
+        if (MQTTClientCore_usedHeap[parent]->timeout <= clCtx->timeout)
+        {
+            break;
+        }
+        usedHeapSet(idx, MQTTClientCore_usedHeap[parent]);
+        idx = parent;
+    }
+    usedHeapSet(idx, clCtx);
+}
+
+static void usedHeapSiftDown(uint32_t idx)
+{
+    MQTT_ClientCtx_t *clCtx = MQTTClientCore_usedHeap[idx];
+    uint32_t child;
+
+    while ((child = (idx << 1) + 1) < MQTTClientCore_nUsed)
+    {
+        if (((child + 1) < MQTTClientCore_nUsed) &&
+            (MQTTClientCore_usedHeap[child + 1]->timeout < MQTTClientCore_usedHeap[child]->timeout))
+        {
+            child++;
+        }
+        if (clCtx->timeout <= MQTTClientCore_usedHeap[child]->timeout)
+        {
+            break;
+        }
+        usedHeapSet(idx, MQTTClientCore_usedHeap[child]);
+        idx = child;
+    }
+    usedHeapSet(idx, clCtx);
+}
+
+//*****************************************************************************
+//
+//! \brief Restore the heap order after the timeout of 'clCtx' has changed
+//!
+//*****************************************************************************
+static void usedHeapFix(MQTT_ClientCtx_t *clCtx)
+{
+    if (-1 == CLIENT(clCtx)->usedIdx)
+    {
+        return; /* Not (yet) served by the RX task */
+    }
+    usedHeapSiftUp(CLIENT(clCtx)->usedIdx);
+    usedHeapSiftDown(CLIENT(clCtx)->usedIdx);
+}
+
+static void usedHeapInsert(MQTT_ClientCtx_t *clCtx)
+{
+    uint32_t idx = MQTTClientCore_nUsed++;
+
+    MQTTClientCore_usedNets[MQTTClientCore_nUsed] = -1;
+    usedHeapSet(idx, clCtx);
+    usedHeapSiftUp(idx);
+}
+
+static void usedHeapRemove(MQTT_ClientCtx_t *clCtx)
+{
+    int32_t idx = CLIENT(clCtx)->usedIdx;
+    MQTT_ClientCtx_t *last;
+
+    if (-1 == idx)
+    {
+        return;
+    }
+    CLIENT(clCtx)->usedIdx = -1;
+
+    last = MQTTClientCore_usedHeap[--MQTTClientCore_nUsed];
+    MQTTClientCore_usedNets[MQTTClientCore_nUsed] = -1;
+    if (last != clCtx)
+    {
+        usedHeapSet(idx, last);
+        usedHeapFix(last);
+    }
+}
+
 static void doNetCloseRx(MQTT_ClientCtx_t *clCtx, int32_t cause)
 {
     MQTTClientCore_CtxCBs_t *ctxCBs = MQTTClientCore_ctxCBsPtr(clCtx);
@@ -449,7 +742,7 @@ static void doNetCloseRx(MQTT_ClientCtx_t *clCtx, int32_t cause)
     }
     if (MQTTClientCore_groupMember(clCtx))
     {
-        MQTT_clCtxRemove(&MQTTClientCore_usedCtxs, clCtx);
+        usedHeapRemove(clCtx);
     }
     return;
 }
@@ -462,6 +755,7 @@ static void doNetCloseTx(MQTT_ClientCtx_t *clCtx, char *cause)
         clCtx->flags |= MQTTCLIENTCORE_NETWORK_CLOSE_FLAG;
         if (MQTTClientCore_groupMember(clCtx))
         {
+            MQTTClientCore_closeReq = true;
             loopbTrigger();
         }
     }
@@ -545,12 +839,6 @@ static bool isConnected(MQTT_ClientCtx_t *clCtx)
  * MQTT TX Routines
  *--------------------------------------------------------------------------*/
 
-static void usedCtxsTOSort(MQTT_ClientCtx_t *cl_ctx_TO)
-{
-    MQTT_clCtxRemove(&MQTTClientCore_usedCtxs, cl_ctx_TO);
-    MQTT_clCtxTimeoutInsert(&MQTTClientCore_usedCtxs, cl_ctx_TO);
-}
-
 static inline int32_t netSend(int32_t net, const uint8_t *buf, uint32_t len, void *ctx)
 {
     int32_t rv = MQTTClientCore_netOps->send(net, buf, len, ctx);
@@ -584,7 +872,7 @@ static int32_t clCtxPartSend(MQTT_ClientCtx_t *clCtx)
             /* After update, 'CTX'(s) sorting is a must */
             if (MQTTClientCore_groupMember(clCtx))
             {
-                usedCtxsTOSort(clCtx);
+                usedHeapFix(clCtx);
             }
         }
 
@@ -714,6 +1002,9 @@ static int32_t netConnect(MQTT_ClientCtx_t *clCtx)
     clCtx->net = MQTTClientCore_netOps->open(client->nwconnOpts | MQTT_DEV_NETCONN_OPT_TCP,
                 client->serverAddr, client->portNumber, &client->nwSecurity);
 
+    MQTT_rxBufReset(&client->rxBuf); /* Nothing is carried over connections */
+    memset(&client->stats, 0, sizeof(MQTTClientCore_CtxStats_t));
+
     return clCtx->net;
 }
 
@@ -825,6 +1116,14 @@ static int32_t _msgDispatch(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqp, MQTT_QO
 
     MQTTClientCore_mutexLockin();
 
+    if (not_qos0 && (MQTTCLIENTCORE_MAX_INFLT <= CLIENT(clCtx)->nAckAwaited))
+    {
+        /* Window of in-flight messages is full: wait for an ACK */
+        MQTT_packetFree(mqp);
+        MQTTClientCore_mutexUnlock();
+
+        return MQTT_PACKET_ERR_PKT_AVL;
+    }
     if (not_qos0)
     {
         mqp->nRefs++; /* Need to enlist, do not free-up MQP */
@@ -844,9 +1143,13 @@ static int32_t _msgDispatch(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqp, MQTT_QO
     {
         rv = msgID; /* Make progress for a good send to the server  */
 
-        if (not_qos0) /* Enlist non QOS0 MQP to await ACK from server */
+        /* Enlist non QOS0 MQP to await ACK from server */
+        if (not_qos0 && (false == ackWlAppend(clCtx, mqp)))
         {
-            MQTT_packetAckWlistAppend(&CLIENT(clCtx)->qosAck1WaitList, mqp);
+            /* Not tracked, its ACK can't be matched: drop the reference
+               taken to enlist it and report the window as full */
+            MQTT_packetFree(mqp);
+            rv = MQTT_PACKET_ERR_PKT_AVL;
         }
     }
 
@@ -1015,13 +1318,19 @@ static bool ack1WlMqpDispatch(MQTT_ClientCtx_t *clCtx)
 
 static bool ack2MsgIdDispatch(MQTT_ClientCtx_t *clCtx)
 {
-    MQTT_PubQOS2CQ_t     *tx_cq = &CLIENT(clCtx)->txQos2CircularQueue;
-    MQTT_ListPubQOS2CQ_t *rdIdx = tx_cq->rdIdx;
-    bool                  rv    = true;
+    MQTT_PubQOS2CQ_t *tx_cq = &CLIENT(clCtx)->txQos2CircularQueue;
+    bool              rv    = true;
+    uint16_t          msgID;
+    uint16_t          n;
 
-    for (; (NULL != rdIdx) && (true == rv); rdIdx = rdIdx->next)
+    for (n = 0; (n < tx_cq->nSpan) && (true == rv); n++)
     {
-        if (vhMsgSend(clCtx, MQTT_PUBREL, MQTT_QOS1,true, rdIdx->msgID) <= 0)
+        msgID = MQTT_qos2PubCqPeek(tx_cq, n);
+        if (0 == msgID)
+        {
+            continue; /* Already completed, out of order */
+        }
+        if (vhMsgSend(clCtx, MQTT_PUBREL, MQTT_QOS1,true, msgID) <= 0)
         {
             rv = false;
         }
@@ -1040,32 +1349,19 @@ static void sessionResume(MQTT_ClientCtx_t *clCtx)
     return;
 }
 
-static bool ack1WlRmfree(MQTT_AckWlist_t *wl, uint16_t msgID)
-{
-    MQTT_Packet_t *mqp = MQTT_packetAckWlistRemove(wl, msgID);
-
-    if (NULL != mqp)
-    {
-        MQTT_packetFree(mqp);
-        return true;
-    }
-
-    /* Err: Unexpected ACK  */
-    return false;
-}
-
 static bool _procPubRecRx(MQTT_ClientCtx_t *clCtx, uint16_t msgID)
 {
-    /* Follow-up messages for QOS2 PUB must be transacted in the
-     same order as the initial sequence of QOS2 PUB dispatches.
-     Therefore, checking the first entry should be OK
+    /* Follow-up messages for QOS2 PUB are transacted in the order of the
+     QOS2 PUB dispatches, but other messages awaiting ACK can be ahead of
+     the QOS2 PUB in the Wait-List. Therefore, look it up by msgID.
      */
-    MQTT_Packet_t *mqp = CLIENT(clCtx)->qosAck1WaitList.head;
+    MQTTClientCore_AckIdx_t *ackIdx = ackIdxFind(CLIENT(clCtx), msgID);
 
-    if ((msgID == mqp->msgID) && ack2MsgIdLogup(clCtx, msgID))
+    if ((NULL != ackIdx) && (MQTT_PUBLISH == ackIdx->mqp->msgType) &&
+        ack2MsgIdLogup(clCtx, msgID))
     {
 
-        ack1WlRmfree(&CLIENT(clCtx)->qosAck1WaitList, msgID);
+        ack1WlRmfree(clCtx, msgID);
 
         vhMsgSend(clCtx, MQTT_PUBREL, MQTT_QOS1, true, msgID);
 
@@ -1102,7 +1398,7 @@ static bool _procAckMsgRx(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqpRaw)
     uint32_t len = mqpRaw->plLen;
 
     /* Caters to SUB-ACK, UNSUB-ACK and PUB-ACK Messages */
-    if (false == ack1WlRmfree(&client->qosAck1WaitList, msgID))
+    if (false == ack1WlRmfree(clCtx, msgID))
     {
         return false; /* Err: MSG_ID was not awaited */
     }
@@ -1225,6 +1521,10 @@ static bool procConnackRx(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqpRaw)
     {
         clCtx->flags |= MQTTCLIENTCORE_NOW_CONNECTED_FLAG;
         MQTT_clCtxTimeoutUpdate(clCtx, MQTTClientCore_netOps->time()); /* start KA */
+        if (MQTTClientCore_groupMember(clCtx))
+        {
+            usedHeapFix(clCtx);
+        }
 
         /* Check if the client has the Clean session flag set
            or if the server doesn't have a session stored */
@@ -1342,7 +1642,7 @@ static bool processRecv(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqpRaw)
 static int32_t netRecv(int32_t net, MQTT_Packet_t *mqp, uint32_t waitSecs, void *ctx)
 {
     bool timedOut = false;
-    int32_t rv = MQTT_PacketRecv(net, MQTTClientCore_netOps, mqp, waitSecs, &timedOut, ctx);
+    int32_t rv = MQTT_packetRecvBuf(net, MQTTClientCore_netOps, &CLIENT(ctx)->rxBuf, mqp, waitSecs, &timedOut, ctx);
 
     if (rv <= 0)
     {
@@ -1367,31 +1667,49 @@ static int32_t netRecv(int32_t net, MQTT_Packet_t *mqp, uint32_t waitSecs, void
  expected to be disconnected due to in-activity of MQTT messages. Value
  of 'waitSecs' is assumed to be quite smaller than (non-zero) 'kaSecs'.
  */
+static void connackTimeoutSet(MQTT_ClientCtx_t *clCtx, uint32_t waitSecs)
+{
+    if (MQTTClientCore_awaitsConnack(clCtx) && MQTTClientCore_cfgConnackTo(clCtx))
+    {
+        clCtx->timeout += waitSecs; /* Set CONNACK timeout value */
+        clCtx->flags &= ~MQTTCLIENTCORE_DO_CONNACK_TO_FLAG;
+    }
+}
+
 static void conn2usedCtxs(uint32_t waitSecs)
 {
+    MQTTClientCore_mutexLockin();
     while (MQTTClientCore_connCtxs)
     {
         MQTT_ClientCtx_t *clCtx = MQTTClientCore_connCtxs;
         MQTTClientCore_connCtxs = MQTTClientCore_connCtxs->next;
+        clCtx->next = NULL;
 
-        MQTT_clCtxTimeoutInsert(&MQTTClientCore_usedCtxs, clCtx);
+        connackTimeoutSet(clCtx, waitSecs);
+        usedHeapInsert(clCtx);
     }
+    MQTTClientCore_mutexUnlock();
 }
 
 static int32_t singleCtxKaSequence(MQTT_ClientCtx_t *clCtx, uint32_t waitSecs)
 {
+    MQTTClientCore_CtxStats_t *stats = &CLIENT(clCtx)->stats;
     uint32_t nowSecs = MQTTClientCore_netOps->time();
 
-    if (MQTTClientCore_awaitsConnack(clCtx) && MQTTClientCore_cfgConnackTo(clCtx))
-    {
-        clCtx->timeout += waitSecs; /* Set CONNACK timeout value */
-        clCtx->flags &= ~MQTTCLIENTCORE_DO_CONNACK_TO_FLAG;
-    }
+    connackTimeoutSet(clCtx, waitSecs);
 
     if (clCtx->timeout > nowSecs)
     {
         return 1; /* Still have time for next message transaction */
     }
+
+    /* Deadline has fallen due, track how late it is being serviced */
+    stats->nKaRuns++;
+    stats->sumKaLate += nowSecs - clCtx->timeout;
+    if (stats->maxKaLate < (nowSecs - clCtx->timeout))
+    {
+        stats->maxKaLate = nowSecs - clCtx->timeout;
+    }
     if (isConnected(clCtx))
     {
         /* Timeout has happened. Check for PINGRESP if PINGREQ done.
@@ -1559,25 +1877,88 @@ static int32_t clCtxRecv(MQTT_ClientCtx_t *clCtx, MQTT_Packet_t *mqp, uint32_t w
     return rv;
 }
 
+//*****************************************************************************
+//
+//! \brief Close the 'ctx'(s) that TX has asked to. All used 'ctx'(s) are
+//! checked, so it is done only after such a request has been made.
+//!
+//*****************************************************************************
+static MQTT_ClientCtx_t *groupCtxsCloseReqSequence(uint32_t waitSecs)
+{
+    MQTT_ClientCtx_t *ctxs[MQTTCLIENTCORE_MAX_NWCONN];
+    MQTT_ClientCtx_t *ctxErr = NULL;
+    uint32_t nCtxs, i;
+
+    MQTTClientCore_mutexLockin();
+    MQTTClientCore_closeReq = false;
+    nCtxs = MQTTClientCore_nUsed;
+    for (i = 0; i < nCtxs; i++)
+    {
+        ctxs[i] = MQTTClientCore_usedHeap[i]; /* Heap changes on close */
+    }
+
+    for (i = 0; i < nCtxs; i++)
+    {
+        if (MQTTClientCore_needNetClose(ctxs[i]) &&
+            (singleCtxRxPrep(ctxs[i], &waitSecs) < 0) && (NULL == ctxErr))
+        {
+            ctxErr = ctxs[i];
+        }
+    }
+    MQTTClientCore_mutexUnlock();
+
+    return ctxErr;
+}
+
+//*****************************************************************************
+//
+//! \brief Run the keep alive sequence of the 'ctx'(s) whose timeout has
+//! fallen due. These are taken from the top of the heap, so the 'ctx'(s)
+//! that still have time are not visited at all.
+//!
+//*****************************************************************************
 static MQTT_ClientCtx_t *groupCtxsKaSequence(uint32_t waitSecs)
 {
-    MQTT_ClientCtx_t *clCtx = MQTTClientCore_usedCtxs;
-    MQTT_ClientCtx_t *next;
+    MQTT_ClientCtx_t *clCtx = NULL;
+    uint32_t nowSecs = MQTTClientCore_netOps->time();
+    uint32_t nCtxs, secs2wait;
+    int32_t rv;
 
-    while (clCtx)
+    if (MQTTClientCore_closeReq)
     {
-        next = clCtx->next;
-        if (singleCtxRxPrepLocked(clCtx, &waitSecs) < 0)
+        clCtx = groupCtxsCloseReqSequence(waitSecs);
+        if (clCtx && (false == MQTTClientCore_grpHasCBFn))
         {
-            /* 'CTX' no more eligible for operation
-             and has been removed from used_list */
-            if (false == MQTTClientCore_grpHasCBFn)
-            {
-                return clCtx;
-            }
+            return clCtx;
+        }
+    }
+
+    /* A 'ctx' is either moved down the heap or removed from it on each
+     iteration, so no more than all of them need to be serviced. */
+    for (nCtxs = MQTTClientCore_nUsed; nCtxs > 0; nCtxs--)
+    {
+        MQTTClientCore_mutexLockin();
+        clCtx = MQTTClientCore_nUsed ? MQTTClientCore_usedHeap[0] : NULL;
+        if ((NULL == clCtx) || (clCtx->timeout > nowSecs))
+        {
+            MQTTClientCore_mutexUnlock();
+            break;
+        }
+
+        secs2wait = waitSecs;
+        rv = singleCtxRxPrep(clCtx, &secs2wait);
+        if (rv > 0)
+        {
+            usedHeapFix(clCtx);
         }
+        MQTTClientCore_mutexUnlock();
 
-        clCtx = next;
+        if ((rv < 0) && (false == MQTTClientCore_grpHasCBFn))
+        {
+            /* 'CTX' no more eligible for operation
+             and has been removed from used heap */
+            return clCtx;
+        }
     }
 
     return NULL;
@@ -1585,31 +1966,83 @@ static MQTT_ClientCtx_t *groupCtxsKaSequence(uint32_t waitSecs)
 
 static uint32_t groupCtxsAdjWaitSecsGet(uint32_t waitSecs)
 {
-    return (MQTTClientCore_usedCtxs ? singleCtxAdjWaitSecsGet(MQTTClientCore_usedCtxs, waitSecs) : waitSecs);
+    return (MQTTClientCore_nUsed ? singleCtxAdjWaitSecsGet(MQTTClientCore_usedHeap[0], waitSecs) : waitSecs);
 }
 
 //*****************************************************************************
 //
-//! \brief Caller must ensure atomic environment for execution of this routine
+//! \brief Load handles of the contexts that have a complete packet in their
+//! RX buffer. The network won't report these as readable, as their data has
+//! already been read out of it.
 //!
 //*****************************************************************************
-static void recvHvecLoad(int32_t *hvec_recv, uint32_t size, MQTT_ClientCtx_t *list)
+static int32_t recvHvecLoadBuffered(int32_t *hvec_recv)
 {
-    int32_t i = 0;
+    MQTT_ClientCtx_t *clCtx;
+    int32_t n = 0;
+    uint32_t i;
 
-    for (i = 0; (i < size) && (NULL != list); i++, list = list->next)
+    for (i = 0; i < MQTTClientCore_nUsed; i++)
     {
-        hvec_recv[i] = list->net;
+        clCtx = MQTTClientCore_usedHeap[i];
+        if ((-1 != clCtx->net) && MQTT_rxBufPktReady(&CLIENT(clCtx)->rxBuf))
+        {
+            hvec_recv[n++] = clCtx->net;
+        }
     }
-    hvec_recv[i] = -1;
+    hvec_recv[n] = -1;
 
-    return;
+    return n;
+}
+
+//*****************************************************************************
+//
+//! \brief Load the interest set, as ioMon() overwrites the vector with the
+//! handles that are ready. It is a copy, the set itself is kept up to date
+//! as 'ctx'(s) are added to and removed from the used heap.
+//!
+//*****************************************************************************
+static void recvHvecLoad(int32_t *hvec_recv)
+{
+    uint32_t i;
+
+    hvec_recv[0] = MQTTClientCore_loopbNet;
+    for (i = 0; i <= MQTTClientCore_nUsed; i++)
+    {
+        hvec_recv[i + 1] = MQTTClientCore_usedNets[i];
+    }
+}
+
+//*****************************************************************************
+//
+//! \brief Add the buffered handles, that ioMon() did not report as ready, to
+//! the 'n_hnds' ready handles. Returns the number of handles to be processed.
+//!
+//*****************************************************************************
+static int32_t recvHvecMergeBuffered(int32_t *hvec_recv, int32_t n_hnds, const int32_t *hvec_bufd)
+{
+    int32_t i, j;
+
+    for (i = 0; -1 != hvec_bufd[i]; i++)
+    {
+        for (j = 0; (j < n_hnds) && (hvec_recv[j] != hvec_bufd[i]); j++)
+        {
+        }
+        if (j == n_hnds)
+        {
+            hvec_recv[n_hnds++] = hvec_bufd[i];
+        }
+    }
+    hvec_recv[n_hnds] = -1;
+
+    return n_hnds;
 }
 
 static int32_t groupCtxsRxPrep(uint32_t waitSecs, void **app)
 {
     /* CHK 'used ctx'(s) have live connection w/ server. If not, drop it */
     MQTT_ClientCtx_t *ctx_kaTO = groupCtxsKaSequence(waitSecs);
+    int32_t n_bufd;
     int32_t n_hnds;
 
     if (ctx_kaTO)
@@ -1620,19 +2053,28 @@ static int32_t groupCtxsRxPrep(uint32_t waitSecs, void **app)
 
     conn2usedCtxs(waitSecs); /* Now, add new 'ctx'(s) to 'used ctxs' */
 
-    MQTTClientCore_recvHvec[0] = MQTTClientCore_loopbNet;
-    recvHvecLoad(&MQTTClientCore_recvHvec[1], MQTTCLIENTCORE_MAX_NWCONN + 1, MQTTClientCore_usedCtxs);
+    MQTTClientCore_mutexLockin();
 
-    waitSecs = groupCtxsAdjWaitSecsGet(waitSecs);
+    /* Packets already in RX buffers are processed w/o waiting on network,
+       which is still polled so that the loopback and the other 'ctx'(s)
+       are served along with them */
+    n_bufd = recvHvecLoadBuffered(MQTTClientCore_bufdHvec);
+    recvHvecLoad(MQTTClientCore_recvHvec);
+    waitSecs = (n_bufd > 0) ? 0 : groupCtxsAdjWaitSecsGet(waitSecs);
+
+    MQTTClientCore_mutexUnlock();
 
     n_hnds = MQTTClientCore_netOps->ioMon(MQTTClientCore_recvHvec, &MQTTClientCore_sendHvec, &MQTTClientCore_rsvdHvec, waitSecs);
-    if (0 == n_hnds)
+    if (n_hnds < 0)
     {
-        n_hnds = MQTT_PACKET_ERR_TIMEOUT;
+        return MQTT_PACKET_ERR_LIBQUIT;
     }
-    else if (n_hnds < 0)
+
+    /* On time-out, ioMon() leaves the vector as it was loaded */
+    n_hnds = recvHvecMergeBuffered(MQTTClientCore_recvHvec, n_hnds, MQTTClientCore_bufdHvec);
+    if (0 == n_hnds)
     {
-        n_hnds = MQTT_PACKET_ERR_LIBQUIT;
+        n_hnds = MQTT_PACKET_ERR_TIMEOUT;
     }
     return n_hnds;
 }
@@ -1654,18 +2096,26 @@ static int32_t procLoopbackRecv(int32_t net)
 
 static MQTT_ClientCtx_t *netClCtxFind(int32_t net)
 {
-    MQTT_ClientCtx_t *clCtx = MQTTClientCore_usedCtxs;
+    MQTT_ClientCtx_t *clCtx = NULL;
+    uint32_t i;
 
-    while (clCtx && (net != clCtx->net))
+    MQTTClientCore_mutexLockin();
+    for (i = 0; i < MQTTClientCore_nUsed; i++)
     {
-        clCtx = clCtx->next;
+        if (net == MQTTClientCore_usedNets[i])
+        {
+            clCtx = MQTTClientCore_usedHeap[i];
+            break;
+        }
     }
+    MQTTClientCore_mutexUnlock();
+
     return clCtx;
 }
 
 static int32_t procNetDataRecv(int32_t net, MQTT_Packet_t *mqp, void **app)
 {
-    /* Note: MQTTClientCore_usedCtxs are always managed by a single RX task */
+    /* Note: used heap is always drained by a single RX task */
     MQTT_ClientCtx_t *clCtx = netClCtxFind(net);
     int32_t rv = MQTT_PACKET_ERR_NOTCONN;
 
@@ -1673,6 +2123,7 @@ static int32_t procNetDataRecv(int32_t net, MQTT_Packet_t *mqp, void **app)
     {
         return rv; /* TX removed it interim, mustn't happen */
     }
+    CLIENT(clCtx)->stats.nWakes++;
     return mqpSetupProcCtxDataRecv(clCtx, mqp, 1, app);
 }
 
@@ -1738,6 +2189,7 @@ static MQTT_Packet_t *mqpAllocAtomic(void)
     if (mqp)
     {
         MQTTClientCore_freeList = mqp->next;
+        MQTTClientCore_freeCnt--;
     }
     MQTTClientCore_mutexUnlock();
 
@@ -1749,6 +2201,7 @@ static void mqpFree(MQTT_Packet_t *mqp)
     /* Must be used in a locked state */
     mqp->next = MQTTClientCore_freeList;
     MQTTClientCore_freeList = mqp;
+    MQTTClientCore_freeCnt++;
 }
 
 static void clCtxSetup(MQTT_ClientCtx_t *clCtx, /* WR Object */
@@ -1795,6 +2248,33 @@ bool MQTTClientCore_isConnected(void *ctx)
     return isConnected((MQTT_ClientCtx_t *)(ctx));
 }
 
+uint32_t MQTTClientCore_pubInflight(void *ctx)
+{
+    MQTTClientCore_ClientDesc_t *client = CLIENT(ctx);
+
+    if (NULL == ctx)
+    {
+        return 0;
+    }
+
+    return (client->nPubAwaited + MQTT_qos2PubCqCount(&client->txQos2CircularQueue));
+}
+
+void MQTTClientCore_ctxStatsGet(void *ctx, MQTTClientCore_CtxStats_t *stats)
+{
+    MQTTClientCore_mutexLockin();
+    MQTT_bufWrNbytes((uint8_t *)stats, (uint8_t *)&CLIENT(ctx)->stats, sizeof(MQTTClientCore_CtxStats_t));
+    MQTTClientCore_mutexUnlock();
+}
+
+void MQTTClientCore_rxStatsGet(void *ctx, uint32_t *nPkts, uint32_t *nReads)
+{
+    MQTT_RxBuf_t *rxBuf = &CLIENT(ctx)->rxBuf;
+
+    *nPkts = rxBuf->nPkts;
+    *nReads = rxBuf->nReads;
+}
+
 int32_t MQTTClientCore_sendProgress(void *ctx)
 {
     MQTT_ClientCtx_t *clCtx = (MQTT_ClientCtx_t *)(ctx);
@@ -2032,10 +2512,30 @@ int32_t MQTTClientCore_registerBuffers(uint32_t mqpNum, MQTT_Packet_t *mqpVec, u
         mqp->next = MQTTClientCore_freeList;
         MQTTClientCore_freeList = mqp;
     }
+    MQTTClientCore_freeCnt = mqpNum;
 
     return 0;
 }
 
+bool MQTTClientCore_holdRecv(MQTT_Packet_t *mqp)
+{
+    /* Invoked from the publishRx callback, i.e. in a locked state. Keep
+     enough of the pool free for the next RX and for a TX, otherwise the
+     app would starve the connection of buffers. */
+    if ((NULL == mqp->free) || (MQTTClientCore_freeCnt < MQTTCLIENTCORE_HOLD_RSVD_MQP))
+    {
+        return false;
+    }
+    mqp->nRefs++;
+
+    return true;
+}
+
+void MQTTClientCore_releaseRecv(MQTT_Packet_t *mqp)
+{
+    mqpFreeLocked(mqp);
+}
+
 int32_t MQTTClientCore_registerWillInfo(void *ctx, const MQTT_UTF8String_t *willTop, const MQTT_UTF8String_t *willMsg, MQTT_QOS willQos, bool retain)
 {
     uint8_t B = 0;
@@ -2170,7 +2670,9 @@ int32_t MQTTClientCore_initLib(const MQTTClientCore_LibCfg_t *lib_cfg_local)
     }
 
     MQTTClientCore_msgID = 0xFFFF;
-    MQTTClientCore_usedCtxs = NULL;
+    MQTTClientCore_nUsed = 0;
+    MQTTClientCore_usedNets[0] = -1;
+    MQTTClientCore_closeReq = false;
     MQTTClientCore_freeCtxs = NULL;
     MQTTClientCore_connCtxs = NULL;
     MQTTClientCore_loopbNet = -1;
@@ -224,6 +224,15 @@ typedef struct _MQTTClientCore_CtxCfg_t_
         MQTT_SecureConn_t *nwSecurity;  /**< Refer to @ref mqtt_netsec_grp */
 }MQTTClientCore_CtxCfg_t;
 
+/** Run time statistics of a context, cleared on each connect */
+typedef struct _MQTTClientCore_CtxStats_t_
+{
+        uint32_t   nWakes;     /**< Group RX loop wakes that served the context */
+        uint32_t   nKaRuns;    /**< Keep alive / CONNACK deadlines fallen due   */
+        uint32_t   maxKaLate;  /**< Max secs a deadline was served past its time */
+        uint32_t   sumKaLate;  /**< Sum of the above over all nKaRuns, in secs  */
+}MQTTClientCore_CtxStats_t;
+
 
 /** Contruct / Data to initialize MQTT Client Library */
 typedef struct _MQTTClientCore_LibCfg_t_
@@ -280,6 +289,51 @@ uint16_t MQTTClientCore_newMsgID(void);
 */
 bool MQTTClientCore_isConnected(void *ctx);
 
+/** Count PUBLISH messages of the context that are still in-flight.
+    A QoS1 message is in-flight until its PUBACK is received, a QoS2 message
+    until its PUBCOMP is received. Up to CFG_CL_MQTT_MAX_INFLT (default 16)
+    messages, including SUBSCRIBE and UNSUBSCRIBE, can await a PUBACK, PUBREC,
+    SUBACK or UNSUBACK at a time. Beyond that, a send of such a message fails
+    with MQTT_PACKET_ERR_PKT_AVL. The ACK(s) are matched in constant time.
+
+    The count is read without the LIB lock, so it is a snapshot. The count
+    drops before the ackNotify callback reports the PUBACK or PUBCOMP, which
+    lets the app pipeline messages up to a window of its own choice.
+
+    @param[in] ctx handle to the underlying network context in the LIB
+    @see MQTTClientCore_createCtx
+
+    @return number of QoS1 and QoS2 PUBLISH messages awaiting completion
+*/
+uint32_t MQTTClientCore_pubInflight(void *ctx);
+
+/** Get the RX counters of the context, which are cleared on each connect.
+    Data is read from the network into a per context buffer of MQTT_RXBUF_LEN
+    bytes, as much as is available at a time. A small packet thus usually
+    takes a single read, and a read may also fetch the packets that follow.
+    The ratio of reads to packets tells the number of network round trips,
+    e.g. sl_Recv() commands to the NWP, that each packet has cost.
+
+    @param[in] ctx handle to the underlying network context in the LIB
+    @param[out] nPkts number of MQTT packets received
+    @param[out] nReads number of network reads that returned data
+    @see MQTTClientCore_createCtx
+*/
+void MQTTClientCore_rxStatsGet(void *ctx, uint32_t *nPkts, uint32_t *nReads);
+
+/** Get the run time statistics of the context.
+    The grouped contexts are served by a single RX loop. It waits on one
+    ioMon() over a persistent interest set and keeps the contexts in a
+    min-heap of keep alive deadlines, so a wake costs O(log N) timer work
+    for each context that is due, and none for the others. The lateness of
+    deadlines is kept at the resolution of the time() net service.
+
+    @param[in] ctx handle to the underlying network context in the LIB
+    @param[out] stats place to copy the statistics of the context to
+    @see MQTTClientCore_createCtx
+*/
+void MQTTClientCore_ctxStatsGet(void *ctx, MQTTClientCore_CtxStats_t *stats);
+
 /** Send the CONNECT message to the server (and don't wait for CONNACK).
     This routine accomplishes multiple sequences. As a first step, it tries
     to establish a network connection with the server. Then, it populates
@@ -765,6 +819,31 @@ static inline MQTT_Packet_t *MQTTClientCore_allocRecv(uint8_t msgType)
         return MQTTClientCore_alloc(msgType, 0);
 }
 
+/** Number of pool buffers that must remain free for the app to hold a
+    received packet, one for the next RX and one for a TX.
+*/
+#define MQTTCLIENTCORE_HOLD_RSVD_MQP 2
+
+/** Retain a received PUBLISH packet beyond the publishRx callback.
+    The app can use this service, only from within the publishRx callback, to
+    defer the processing of the packet to another context without copying its
+    contents. The packet stays out of the pool until it is handed back through
+    MQTTClientCore_releaseRecv( ).
+
+    @param[in] mqp packet presented to the publishRx callback.
+    @return true if the packet is now held by the app, false if the pool can't
+    spare the buffer; the app must then consume the data in the callback.
+
+    @see MQTTClientCore_releaseRecv
+*/
+bool MQTTClientCore_holdRecv(MQTT_Packet_t *mqp);
+
+/** Return a packet held through MQTTClientCore_holdRecv( ) to the pool.
+
+    @param[in] mqp packet held by the app.
+*/
+void MQTTClientCore_releaseRecv(MQTT_Packet_t *mqp);
+
 /** Create a pool of MQTT Packet Buffers for the client library.
     This routine creates a pool of free MQTT Packet Buffers by attaching a buffer
     (buf) to a packet holder (mqp). The count of mqp elements and buf elements in
@@ -362,6 +362,163 @@ int32_t MQTT_PacketRecv(int32_t net, const MQTT_DeviceNetServices_t *netOps, MQT
     return (fhLen + remlen);
 }
 
+//*****************************************************************************
+//
+//! \brief  Parse the fixed header at the read index of the staging buffer.
+//! Returns length of the fixed header, once all of its bytes are available,
+//! 0 if more bytes are needed, or -1 if the remaining length is malformed.
+//
+//*****************************************************************************
+static int32_t rxBufFhParse(const MQTT_RxBuf_t *rxBuf, uint32_t *remlen)
+{
+    const uint8_t *buf = rxBuf->buf + rxBuf->rdIdx;
+    uint32_t avl = rxBuf->wrIdx - rxBuf->rdIdx;
+    uint32_t fhLen = 1;
+
+    do
+    {
+        if (fhLen > MQTT_MAX_REMLEN_BYTES)
+        {
+            return -1;
+        }
+        if (fhLen >= avl)
+        {
+            return 0; /* Yet to receive rest of FH */
+        }
+    } while (buf[fhLen++] & 0x80);
+
+    MQTT_packetBufRdRemlen((uint8_t *)buf + 1, remlen);
+
+    return fhLen;
+}
+
+//*****************************************************************************
+//
+//! \brief  Read as many bytes as the network has and the staging buffer can
+//! take. Unconsumed bytes are first moved to the start of the buffer.
+//
+//*****************************************************************************
+static int32_t rxBufFill(int32_t net, const MQTT_DeviceNetServices_t *netOps, MQTT_RxBuf_t *rxBuf, uint32_t waitSecs, bool *timedOut, void *ctx)
+{
+    int32_t rv;
+
+    if (0 != rxBuf->rdIdx)
+    {
+        rxBuf->wrIdx = MQTT_bufWrNbytes(rxBuf->buf, rxBuf->buf + rxBuf->rdIdx, rxBuf->wrIdx - rxBuf->rdIdx);
+        rxBuf->rdIdx = 0;
+    }
+
+    rv = netOps->recv(net, rxBuf->buf + rxBuf->wrIdx, MQTT_RXBUF_LEN - rxBuf->wrIdx, waitSecs, timedOut, ctx);
+    if (rv < 1)
+    {
+        return MQTT_PACKET_ERR_NETWORK;
+    }
+
+    rxBuf->wrIdx += rv;
+    rxBuf->nReads++;
+
+    return rv;
+}
+
+//*****************************************************************************
+//
+//! \brief  Buffered variant of MQTT_PacketRecv(). The fixed header is parsed
+//! out of the staging buffer and moved into the MQP only once it is complete,
+//! so a partial RX leaves mqp->fhLen at 0 and its bytes in the buffer. The
+//! body is drained from the buffer; a remainder that is larger than the
+//! buffer is read straight into the MQP, asking for no more than the packet
+//! needs. Any bytes past the packet stay in the buffer for the next call.
+//
+//*****************************************************************************
+int32_t MQTT_packetRecvBuf(int32_t net, const MQTT_DeviceNetServices_t *netOps, MQTT_RxBuf_t *rxBuf, MQTT_Packet_t *mqp, uint32_t waitSecs, bool *timedOut, void *ctx)
+{
+    uint8_t *buf = MQTT_PACKET_FHEADER_BUF(mqp);
+    int32_t fhLen = mqp->fhLen;
+    uint32_t plLen = mqp->plLen, remlen = 0, n;
+    int32_t rv;
+
+    if (0 == fhLen)
+    {
+        while (0 == (fhLen = rxBufFhParse(rxBuf, &remlen)))
+        {
+            rv = rxBufFill(net, netOps, rxBuf, waitSecs, timedOut, ctx);
+            if (rv < 1)
+            {
+                return rv;
+            }
+        }
+        if (fhLen < 0)
+        {
+            return MQTT_PACKET_ERR_NOT_DEF;
+        }
+        if (mqp->maxlen < (remlen + fhLen))
+        {
+            return MQTT_PACKET_ERR_PKT_LEN; /* Inadequate free buffer */
+        }
+        rxBuf->rdIdx += MQTT_bufWrNbytes(buf, rxBuf->buf + rxBuf->rdIdx, fhLen);
+        mqp->fhLen = fhLen;
+    }
+    else
+    {
+        MQTT_packetBufRdRemlen(buf + 1, &remlen);
+    }
+
+    buf += fhLen;
+    while (plLen < remlen)
+    {
+        n = rxBuf->wrIdx - rxBuf->rdIdx;
+        if (0 != n)
+        {
+            n = MQTT_MIN(n, remlen - plLen);
+            rxBuf->rdIdx += MQTT_bufWrNbytes(buf + plLen, rxBuf->buf + rxBuf->rdIdx, n);
+            mqp->plLen = plLen += n;
+        }
+        else if ((remlen - plLen) < MQTT_RXBUF_LEN)
+        {
+            rv = rxBufFill(net, netOps, rxBuf, waitSecs, timedOut, ctx);
+            if (rv < 1)
+            {
+                return rv;
+            }
+        }
+        else
+        {
+            RET_IF_ERR_IN_NET_RECV(net, buf + plLen, remlen - plLen, waitSecs, timedOut, ctx);
+
+            rxBuf->nReads++;
+            mqp->plLen = plLen += rv;
+        }
+    }
+
+    if (rxBuf->rdIdx == rxBuf->wrIdx)
+    {
+        rxBuf->rdIdx = rxBuf->wrIdx = 0;
+    }
+    rxBuf->nPkts++;
+
+    /* Set up MQTT Packet for received data from broker */
+    buf = MQTT_PACKET_FHEADER_BUF(mqp);
+    mqp->fhByte1 = *buf;
+    mqp->msgType = MSG_TYPE(*buf);
+
+    return (fhLen + remlen);
+}
+
+void MQTT_rxBufReset(MQTT_RxBuf_t *rxBuf)
+{
+    rxBuf->rdIdx = rxBuf->wrIdx = 0;
+    rxBuf->nPkts = rxBuf->nReads = 0;
+}
+
+bool MQTT_rxBufPktReady(const MQTT_RxBuf_t *rxBuf)
+{
+    uint32_t remlen = 0;
+    int32_t fhLen = rxBufFhParse(rxBuf, &remlen);
+
+    /* A malformed header is reported as ready, so that it gets processed */
+    return ((fhLen < 0) || ((fhLen > 0) && ((fhLen + remlen) <= (rxBuf->wrIdx - rxBuf->rdIdx))));
+}
+
 void MQTT_secureConnStructInit(MQTT_SecureConn_t *nwSecurity)
 {
     nwSecurity->method = nwSecurity->cipher = NULL;
@@ -375,47 +532,95 @@ void MQTT_secureConnStructInit(MQTT_SecureConn_t *nwSecurity)
 //! \brief QoS2 PUB RX Message handling mechanism and associated house-keeping
 //
 //*****************************************************************************
-void MQTT_qos2PubCqReset(MQTT_PubQOS2CQ_t *cq)
+static inline uint16_t qos2PubCqNext(uint16_t idx)
+{
+    return ((idx + 1 < MQTT_MAX_PUBREL_INFLT) ? (idx + 1) : 0);
+}
+
+static inline uint16_t *qos2PubCqBucket(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
 {
-    MQTT_ListPubQOS2CQ_t *temp;
+    /* Message-IDs are mostly sequential, so low bits spread them well */
+    return (cq->hash + (msgID & (MQTT_QOS2CQ_HASH_SIZE - 1)));
+}
 
-    cq->nFree = MQTT_MAX_PUBREL_INFLT;
-    cq->rdIdx = NULL;
-    cq->wrIdx = NULL;
-    while (NULL != cq->idVec)
+/* Find the hash link that refers to the slot of 'msgID', NULL if absent */
+static uint16_t *qos2PubCqFind(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
+{
+    uint16_t *link = qos2PubCqBucket(cq, msgID);
+
+    while (MQTT_QOS2CQ_NIL != *link)
     {
-        temp = cq->idVec;
-        cq->idVec = cq->idVec->next;
-        free(temp);
+        if (msgID == cq->idVec[*link].msgID)
+        {
+            return link;
+        }
+        link = &cq->idVec[*link].hnext;
     }
 
-    return;
+    return NULL;
 }
 
-bool MQTT_qos2PubCqLogup(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
+/* Close up the holes left by out-of-order unlogs and re-hash the slots */
+static void qos2PubCqCompact(MQTT_PubQOS2CQ_t *cq)
 {
-    MQTT_ListPubQOS2CQ_t * temp;
-    if (0 != cq->nFree)
+    uint16_t rdIdx = cq->rdIdx;
+    uint16_t wrIdx = cq->rdIdx;
+    uint16_t *bucket;
+    uint16_t n;
+
+    memset(cq->hash, 0xFF, sizeof(cq->hash));
+    for (n = 0; n < cq->nSpan; n++, rdIdx = qos2PubCqNext(rdIdx))
     {
-        temp = (MQTT_ListPubQOS2CQ_t *)calloc(1, sizeof(MQTT_ListPubQOS2CQ_t));
-        /* Check if memory allocation was successful */
-        if (NULL == temp )
+        if (0 == cq->idVec[rdIdx].msgID)
         {
-            return false;
+            continue;
         }
+        cq->idVec[wrIdx].msgID = cq->idVec[rdIdx].msgID;
 
-        temp->msgID = msgID;
-        if ( (NULL == cq->wrIdx) || (NULL == cq->idVec) )
-        {
-            cq->idVec = temp;
-            cq->wrIdx = cq->idVec;
-        }
-        else
+        bucket = qos2PubCqBucket(cq, cq->idVec[wrIdx].msgID);
+        cq->idVec[wrIdx].hnext = *bucket;
+        *bucket = wrIdx;
+
+        wrIdx = qos2PubCqNext(wrIdx);
+    }
+
+    cq->wrIdx = wrIdx;
+    cq->nSpan = MQTT_qos2PubCqCount(cq);
+
+    return;
+}
+
+void MQTT_qos2PubCqReset(MQTT_PubQOS2CQ_t *cq)
+{
+    cq->nFree = MQTT_MAX_PUBREL_INFLT;
+    cq->nSpan = 0;
+    cq->rdIdx = 0;
+    cq->wrIdx = 0;
+    memset(cq->hash, 0xFF, sizeof(cq->hash));
+
+    return;
+}
+
+bool MQTT_qos2PubCqLogup(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
+{
+    uint16_t *bucket;
+
+    /* A Message-ID of 0 is not valid in MQTT and marks an unlogged slot */
+    if ((0 != cq->nFree) && (0 != msgID))
+    {
+        if (MQTT_MAX_PUBREL_INFLT == cq->nSpan)
         {
-            cq->wrIdx->next = temp;
-            temp->prev = cq->wrIdx;
-            cq->wrIdx = temp;
+            /* Ring is wrapped around onto holes of unlogged IDs */
+            qos2PubCqCompact(cq);
         }
+
+        bucket = qos2PubCqBucket(cq, msgID);
+        cq->idVec[cq->wrIdx].msgID = msgID;
+        cq->idVec[cq->wrIdx].hnext = *bucket;
+        *bucket = cq->wrIdx;
+
+        cq->wrIdx = qos2PubCqNext(cq->wrIdx);
+        cq->nSpan++;
         cq->nFree--;
         return true;
     }
@@ -433,98 +638,36 @@ bool MQTT_qos2PubCqLogup(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
 
 bool MQTT_qos2PubCqUnlog(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
 {
-    MQTT_ListPubQOS2CQ_t * temp;
+    uint16_t *link = (0 != msgID) ? qos2PubCqFind(cq, msgID) : NULL;
+    uint16_t idx;
 
-    /* Simple implementation. Should be good for embedded system */
-    if (cq->nFree < MQTT_MAX_PUBREL_INFLT)
+    if (NULL == link)
     {
-        /* Follow-up messages for QOS2 PUB must be transacted in the
-         same order as the initial sequence of QOS2 PUB dispatches.
-         Therefore, checking the first entry should be OK
-         */
-        if (NULL == cq->rdIdx)
-        {
-            cq->rdIdx = cq->idVec;
-        }
-        if (msgID == cq->rdIdx->msgID)
-        {
-            if (NULL != cq->rdIdx->next)
-            {
-                if (NULL != cq->rdIdx->prev)
-                {
-                    cq->rdIdx->prev->next = cq->rdIdx->next;
-                    cq->rdIdx->next->prev = cq->rdIdx->prev;
-                }
-                else
-                {
-                    cq->rdIdx->next->prev = NULL;
-                }
-                temp = cq->rdIdx->next;
-            }
-            else
-            {
-                if (NULL != cq->rdIdx->prev)
-                {
-                    cq->rdIdx->prev->next = NULL;
-                }
-                else
-                {
-                    cq->idVec = NULL;
-                }
-                temp = cq->idVec;
-            }
-            free(cq->rdIdx);
-            cq->rdIdx = temp;
-            cq->nFree++;
-            return true;
-        }
-        else
-        {
-            if (NULL == cq->rdIdx->next)
-            {
-                cq->rdIdx = cq->idVec;
-            }
-            else
-            {
-                cq->rdIdx = cq->rdIdx->next;
-            }
-        }
+        return false;
     }
-    return false;
-}
 
-bool MQTT_qos2PubCqCheck(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
-{
-    uint8_t nFree = cq->nFree;
-    uint8_t i = 0;
-    bool    msgEql = false;
+    /* Follow-ups are mostly transacted in the order of the QOS2 PUB
+       dispatches, so the slot is usually the oldest one. Otherwise it
+       is left as a hole, which is skipped once it becomes the oldest.
+     */
+    idx = *link;
+    *link = cq->idVec[idx].hnext;
+    cq->idVec[idx].msgID = 0;
+    cq->nFree++;
 
-    /* Go through the vector to see if packet ID is still active */
-    for (i = 0; i < (MQTT_MAX_PUBREL_INFLT - nFree); i++)
+    while ((0 != cq->nSpan) && (0 == cq->idVec[cq->rdIdx].msgID))
     {
-        if (NULL == cq->rdIdx)
-        {
-            cq->rdIdx = cq->idVec;
-        }
-        if (msgID == cq->rdIdx->msgID)
-        {
-            msgEql = true;
-        }
-        if (NULL == cq->rdIdx->next)
-        {
-            cq->rdIdx = cq->idVec;
-        }
-        else
-        {
-            cq->rdIdx = cq->rdIdx->next;
-        }
-        if (true == msgEql)
-        {
-            return true;
-        }
+        cq->rdIdx = qos2PubCqNext(cq->rdIdx);
+        cq->nSpan--;
     }
 
-    return false;
+    return true;
+}
+
+bool MQTT_qos2PubCqCheck(MQTT_PubQOS2CQ_t *cq, uint16_t msgID)
+{
+    /* Is the packet ID still active */
+    return ((0 != msgID) && (NULL != qos2PubCqFind(cq, msgID)));
 }
 
 //*****************************************************************************
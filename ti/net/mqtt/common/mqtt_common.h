@@ -216,7 +216,43 @@ extern "C" {
 #define MQTT_DEV_NETCONN_OPT_SKIP_DATE_VERIFICATION                0x80  /**< Assert to skip date verification       */
  /** @} */
 
+/* Number of QoS2 message-IDs that can be in-flight at a time, per direction
+   and per client. Each one costs 4 bytes of the owning context, so windows
+   of several hundred or thousand messages are affordable where RAM permits.
+*/
+#ifndef MQTT_MAX_PUBREL_INFLT
 #define MQTT_MAX_PUBREL_INFLT 32
+#endif
+
+/* Number of hash buckets used to look up an in-flight QoS2 message-ID, must
+   be a power of 2. Scale it with MQTT_MAX_PUBREL_INFLT to keep lookups short.
+*/
+#ifndef MQTT_QOS2CQ_HASH_SIZE
+#define MQTT_QOS2CQ_HASH_SIZE 16
+#endif
+
+#if (MQTT_MAX_PUBREL_INFLT < 1) || (MQTT_MAX_PUBREL_INFLT > 0xFFFE)
+#error "MQTT_MAX_PUBREL_INFLT must be in the range 1 to 65534"
+#endif
+
+#if (MQTT_QOS2CQ_HASH_SIZE & (MQTT_QOS2CQ_HASH_SIZE - 1)) != 0
+#error "MQTT_QOS2CQ_HASH_SIZE must be a power of 2"
+#endif
+
+#define MQTT_QOS2CQ_NIL 0xFFFF  /* No slot, ends a hash bucket chain */
+
+/* Size of the per-connection staging buffer used by MQTT_packetRecvBuf(). A
+   single network read fills it with as many bytes as are available, which
+   typically covers the fixed header and the body of a small packet and may
+   carry the start of the next one. Must hold at least a full fixed header.
+*/
+#ifndef MQTT_RXBUF_LEN
+#define MQTT_RXBUF_LEN 128
+#endif
+
+#if (MQTT_RXBUF_LEN < MQTT_MAX_FH_LEN) || (MQTT_RXBUF_LEN > 0xFFFF)
+#error "MQTT_RXBUF_LEN must be in the range MQTT_MAX_FH_LEN to 65535"
+#endif
 
 #define MQTT_KA_TIMEOUT_NONE 0xffffffff  /* Different than KA SECS = 0 */
 
@@ -530,25 +566,40 @@ typedef struct _MQTT_DeviceNetServices_t_
 
 /** @} */ /* MQTT_DeviceNetServices_t */
 
-/* List structure which hold the QoS2 PUB RX Message-IDs */
-typedef struct _MQTT_ListPubQOS2CQ_t_
+/* Slot of the QoS2 Message-ID ring */
+typedef struct _MQTT_SlotPubQOS2CQ_t_
 {
-    uint16_t msgID;                      /* Buffer to store RX Message-IDs */
-    struct _MQTT_ListPubQOS2CQ_t_ *next; /* Index to next Message-ID       */
-    struct _MQTT_ListPubQOS2CQ_t_ *prev; /* Index to previous Message-ID   */
-}MQTT_ListPubQOS2CQ_t;
-
+    uint16_t msgID;  /* Logged Message-ID, 0 once it has been unlogged */
+    uint16_t hnext;  /* Next slot in the same hash bucket              */
+}MQTT_SlotPubQOS2CQ_t;
 
 /* Data structure for managing the QoS2 PUB RX packets and follow-ups */
-/* Circular Queue CQ to track QOS2 PUB RX messages */
+/* Circular Queue CQ to track QOS2 PUB RX messages. The ring keeps the
+   Message-IDs in the order of logging, the hash buckets find any of them
+   in constant time. Nothing is allocated from the heap.
+*/
 typedef struct _MQTT_PubQOS2CQ_t_
 {
-    MQTT_ListPubQOS2CQ_t *idVec;  /* Vector to store RX Message-IDs */
-    MQTT_ListPubQOS2CQ_t *rdIdx;  /* Index to Read  next Message-ID */
-    MQTT_ListPubQOS2CQ_t *wrIdx;  /* Index to Write next Message-ID */
-    uint8_t  nFree;               /* Num of free elements in vector */
+    MQTT_SlotPubQOS2CQ_t idVec[MQTT_MAX_PUBREL_INFLT]; /* Ring of Message-IDs */
+    uint16_t hash[MQTT_QOS2CQ_HASH_SIZE];  /* Head slot of each hash bucket  */
+    uint16_t rdIdx;               /* Index to Read  next Message-ID */
+    uint16_t wrIdx;               /* Index to Write next Message-ID */
+    uint16_t nSpan;               /* Num of slots from rdIdx to wrIdx */
+    uint16_t nFree;               /* Num of free elements in vector */
 }MQTT_PubQOS2CQ_t;
 
+/* Staging buffer of a connection for received data. Bytes from rdIdx to
+   wrIdx have been read from the network but not consumed by a packet yet.
+*/
+typedef struct _MQTT_RxBuf_t_
+{
+    uint8_t  buf[MQTT_RXBUF_LEN];
+    uint16_t rdIdx;               /* Index of next byte to be consumed */
+    uint16_t wrIdx;               /* Index past the last byte received */
+    uint32_t nPkts;               /* Num of packets received so far    */
+    uint32_t nReads;              /* Num of network reads made for them */
+}MQTT_RxBuf_t;
+
 typedef struct _MQTT_ClientCtx_t_
 {
     void                        *usr;  /* Client Usr */
@@ -800,6 +851,21 @@ int32_t MQTT_packetPrepFh(MQTT_Packet_t *mqp, uint8_t flags);
 int32_t MQTT_PacketRecv(int32_t  net,     const MQTT_DeviceNetServices_t *netOps,
              MQTT_Packet_t *mqp, uint32_t waitSecs, bool *timedOut,void *ctx);
 
+/* Receive data from the specified network through the staging buffer 'rxBuf'
+   and read into the 'mqp'. Same as MQTT_PacketRecv(), except that each read
+   asks the network for as many bytes as the staging buffer can take. Bytes
+   following the packet are kept in 'rxBuf' for the next invocation.
+*/
+int32_t MQTT_packetRecvBuf(int32_t net, const MQTT_DeviceNetServices_t *netOps,
+                           MQTT_RxBuf_t *rxBuf, MQTT_Packet_t *mqp,
+                           uint32_t waitSecs, bool *timedOut, void *ctx);
+
+/* Drop buffered data and clear the counters of the staging buffer */
+void MQTT_rxBufReset(MQTT_RxBuf_t *rxBuf);
+
+/* Does the staging buffer hold at least one complete packet ? */
+bool MQTT_rxBufPktReady(const MQTT_RxBuf_t *rxBuf);
+
 /* Initialize the MQTT_SecureConn_t data */
 void MQTT_secureConnStructInit(MQTT_SecureConn_t *nwSecurity);
 
@@ -809,7 +875,7 @@ void MQTT_qos2PubCqReset(MQTT_PubQOS2CQ_t *cq);
 /* Append the message-id into the CQ tail. Return true on success, else false */
 bool MQTT_qos2PubCqLogup(MQTT_PubQOS2CQ_t *cq, uint16_t msgID);
 
-/* Remove the message-id from the CQ head. Return true on success, else false */
+/* Remove the message-id from the CQ. Return true on success, else false */
 bool MQTT_qos2PubCqUnlog(MQTT_PubQOS2CQ_t *cq, uint16_t msgID);
 
 /* Is the message-id available in the CQ ? Return true on success, else false */
@@ -821,6 +887,21 @@ static inline int32_t MQTT_qos2PubCqCount(MQTT_PubQOS2CQ_t *cq)
     return (MQTT_MAX_PUBREL_INFLT - cq->nFree);
 }
 
+/* Get the n-th oldest slot of the CQ, for 'n' less than cq->nSpan. A slot
+   holds either a message-id or 0, if that message-id has been unlogged.
+*/
+static inline uint16_t MQTT_qos2PubCqPeek(MQTT_PubQOS2CQ_t *cq, uint16_t n)
+{
+    uint32_t idx = (uint32_t)cq->rdIdx + n;
+
+    if (idx >= MQTT_MAX_PUBREL_INFLT)
+    {
+        idx -= MQTT_MAX_PUBREL_INFLT;
+    }
+
+    return (cq->idVec[idx].msgID);
+}
+
 void MQTT_clCtxReset(MQTT_ClientCtx_t *clCtx);
 
 void MQTT_clCtxTimeoutInsert(MQTT_ClientCtx_t **head,MQTT_ClientCtx_t *elem);
@@ -125,6 +125,12 @@ typedef struct _MQTTClient_Ctx_t_
     bool blockingSend;
     bool connectedState;
 
+    /* Pipelined PUBLISH: QoS1/2 messages in-flight at a time, 0 to disable */
+    uint16_t pubWindow;
+    uint16_t pubSending;   /* Publishers past the window check, not sent yet */
+    uint16_t pubWaiters;   /* Publishers blocked on a full window            */
+    sem_t *pubWindowObj;   /* Signals room in the window to a waiter         */
+
 }MQTTClient_Ctx_t;
 
 MQTTClient_LibCfg_t MQTTClient_clientCfg =
@@ -138,6 +144,9 @@ MQTTClient_Ctx_t *MQTTClient_clientContext = NULL;
 
 static MQTTClient_Ctx_t MQTTClient_ctx[MQTTCLIENT_MAX_SIMULTANEOUS_SERVER_CONN];
 
+/* Packet presented to the app through the receive callback, if any */
+static MQTT_Packet_t *MQTTClient_rxCbPacket = NULL;
+
 /* Creating a pool of MQTT constructs that can be used by the MQTT Lib
  MQTTClient_packet => pointer to a pool of the mqtt packet constructs
  MQTTClient_buffer => the buffer area which is attached with each of MQTTClient_packet*/
@@ -192,6 +201,16 @@ static inline void SetCondAwaitedAckLocked(MQTTClient_Ctx_t *clientCtx, char con
     MQTTClient_mutexUnlock();
 }
 
+/* Wake up a publisher awaiting room in the window, called locked */
+static inline void pubWindowSignal(MQTTClient_Ctx_t *clientCtx)
+{
+    if (0 != clientCtx->pubWaiters)
+    {
+        clientCtx->pubWaiters--;
+        sem_post(clientCtx->pubWindowObj);
+    }
+}
+
 static void mutexLockup(pthread_mutex_t *mqttLibLock)
 {
     pthread_mutex_lock(mqttLibLock); //forever
@@ -267,6 +286,8 @@ static void processNotifyAckCB(void *app, uint8_t msgType, uint16_t msgID, uint8
 
     MQTTClient_mutexLock();
 
+    eventCB.msgID = msgID;
+
     switch (msgType)
     {
 
@@ -298,6 +319,20 @@ static void processNotifyAckCB(void *app, uint8_t msgType, uint16_t msgID, uint8
                 clientCtx->appCBs( MQTTClient_OPERATION_CB_EVENT, (void *)&eventCB, sizeof(eventCB), (void *)buf, len);
             }
             break;
+        case MQTT_PUBACK:
+        case MQTT_PUBCOMP:
+            if (0 != clientCtx->pubWindow)
+            {
+                /* Pipelined PUBLISH is complete, the core has retired it
+                 from the count of in-flight messages */
+                pubWindowSignal(clientCtx);
+
+                eventCB.messageType = msgType;
+                clientCtx->appCBs( MQTTClient_OPERATION_CB_EVENT, (void *)&eventCB, sizeof(eventCB), (void *)MQTTCLIENT_ACK, strlen(MQTTCLIENT_ACK));
+                break;
+            }
+            /* Not pipelined, same as the other ACK(s) */
+            /* fall-through */
         default:
             if (true == clientCtx->blockingSend)
             {
@@ -338,8 +373,11 @@ static bool processPublishRxCB(void *app, bool dup, MQTT_QOS qos, bool retain, M
         metaData.dup    = dup;
         metaData.qos    = MQTTClient_mqpPubQos(mqp);
         metaData.retain = retain;
+        metaData.recvBuffer = (void *)mqp;
 
+        MQTTClient_rxCbPacket = mqp;
         clientCtx->appCBs(MQTTClient_RECV_CB_EVENT, &metaData, sizeof(metaData), MQTT_PACKET_PUB_PAY_BUF(mqp), MQTT_PACKET_PUB_PAY_LEN(mqp));
+        MQTTClient_rxCbPacket = NULL;
     }
 
     MQTTClient_mutexUnlock();
@@ -357,6 +395,11 @@ static void processDisconnCB(void *app, int32_t cause)
         clientCtx->awaitedAck = MQTT_DISCONNECT;
         MQTTClient_ackRxSignalPost(clientCtx->ackSyncObj);
     }
+    /* Publishers awaiting room in the window now fail with NOTCONN */
+    while (0 != clientCtx->pubWaiters)
+    {
+        pubWindowSignal(clientCtx);
+    }
     clientCtx->appCBs(MQTTClient_DISCONNECT_CB_EVENT, NULL,0,NULL,0);
 
     MQTTClient_mutexUnlock();
@@ -423,6 +466,17 @@ int32_t MqttClientCtxCreate(const MQTTClient_Params *ctxCfg)
     }
     sem_trywait(clientCtxPtr->ackSyncObj);
 
+    /* Create the sync object to signal room in the window of PUBLISH */
+    clientCtxPtr->pubWindowObj = (sem_t *)malloc(sizeof(sem_t));
+    if ((NULL == clientCtxPtr->pubWindowObj) ||
+        (0 != sem_init(clientCtxPtr->pubWindowObj, 0, 0)))
+    {
+        free(clientCtxPtr->pubWindowObj);
+        clientCtxPtr->pubWindowObj = NULL;
+        clientCtxPtr->inUse = false;
+        return -1;
+    }
+
     /* Initialize the ACK awaited */
     clientCtxPtr->awaitedAck = MQTT_DISCONNECT;
 
@@ -536,6 +590,9 @@ int32_t MqttClientCtxDelete(void)
         sem_destroy(clientCtx->ackSyncObj);
         free(clientCtx->ackSyncObj);
         clientCtx->ackSyncObj = NULL;
+        sem_destroy(clientCtx->pubWindowObj);
+        free(clientCtx->pubWindowObj);
+        clientCtx->pubWindowObj = NULL;
         /* Free up the context */
         memset(clientCtx, 0, sizeof(MQTTClient_Ctx_t));
     }
@@ -1043,6 +1100,50 @@ int16_t MQTTClient_disconnect(MQTTClient_Handle handle)
     return ((retval >= 0) ? 0 : retval);
 }
 
+//*****************************************************************************
+//
+//! \brief Send a QoS1/2 PUBLISH without awaiting its ACK, once the window of
+//! in-flight messages has room. Completion is reported through the callback.
+//
+//*****************************************************************************
+static int32_t pubWindowSend(MQTTClient_Ctx_t *clientCtx, const MQTT_UTF8String_t *topic, void *pData, uint16_t DataLen, uint8_t qosLevel, bool retain)
+{
+    int32_t ret = MQTT_PACKET_ERR_NOTCONN;
+
+    /* The core counts in-flight messages under its own lock, which the RX
+     task holds while it takes the mutex to notify the ACK. Hence, the count
+     is read as a snapshot here; an ACK that retires a message afterwards is
+     always followed by a signal to the waiters. */
+    MQTTClient_mutexLock();
+    while ((MQTT_DISCONNECT != clientCtx->awaitedAck) && (0 != clientCtx->pubWindow) &&
+           ((MQTTClientCore_pubInflight(clientCtx->cliHndl) + clientCtx->pubSending) >= clientCtx->pubWindow))
+    {
+        clientCtx->pubWaiters++;
+        MQTTClient_mutexUnlock();
+        sem_wait(clientCtx->pubWindowObj);
+        MQTTClient_mutexLock();
+    }
+    if (MQTT_DISCONNECT == clientCtx->awaitedAck)
+    {
+        MQTTClient_mutexUnlock();
+        return ret;
+    }
+    clientCtx->pubSending++;
+    MQTTClient_mutexUnlock();
+
+    ret = MQTTClientCore_sendPubMsg(clientCtx->cliHndl, topic, pData, DataLen, MQTTClient_qos[qosLevel], retain);
+
+    MQTTClient_mutexLock();
+    clientCtx->pubSending--;
+    if (ret < 0)
+    {
+        pubWindowSignal(clientCtx); /* Message is not in-flight */
+    }
+    MQTTClient_mutexUnlock();
+
+    return ret;
+}
+
 uint16_t MqttClient_send(MQTTClient_Handle hdl, void *pMeta, uint16_t MetaLen, void *pData, uint16_t DataLen, uint32_t flags)
 {
     int32_t ret = MQTT_PACKET_ERR_FNPARAM;
@@ -1055,6 +1156,12 @@ uint16_t MqttClient_send(MQTTClient_Handle hdl, void *pMeta, uint16_t MetaLen, v
 
     MQTTClient_str2UTFConv(topicUTF8, pMeta);
 
+    if ((0 != qosLevel) && (0 != clientCtx->pubWindow))
+    {
+        ret = pubWindowSend(clientCtx, &topicUTF8, pData, DataLen, qosLevel, retain);
+        return ((ret >= 0) ? 0 : ret);
+    }
+
     awaitedAck = awaitedAcks[qosLevel];
     ret = MQTT_PACKET_ERR_NOTCONN;
 
@@ -1093,8 +1200,48 @@ int16_t MQTTClient_unsubscribe(MQTTClient_Handle handle, MQTTClient_UnsubscribeP
     return (MqttClientUnsub((MQTTClient_UnsubscribeParams *)value, numberOfTopics));
 }
 
+void *MQTTClient_holdRecvBuffer(MQTTClient_RecvMetaDataCB *metaData)
+{
+    MQTT_Packet_t *mqp = (MQTT_Packet_t *)metaData->recvBuffer;
+
+    /* Invoked from the receive callback, the library is locked */
+    if ((NULL == mqp) || (false == MQTTClientCore_holdRecv(mqp)))
+    {
+        return NULL;
+    }
+
+    return (void *)mqp;
+}
+
+void MQTTClient_releaseRecvBuffer(void *recvBuffer)
+{
+    if (NULL == recvBuffer)
+    {
+        return;
+    }
+
+    if (recvBuffer == (void *)MQTTClient_rxCbPacket)
+    {
+        /* Undone from within the receive callback: the library is already
+         locked and the RX context still references the packet */
+        MQTT_packetFree((MQTT_Packet_t *)recvBuffer);
+    }
+    else
+    {
+        MQTTClientCore_releaseRecv((MQTT_Packet_t *)recvBuffer);
+    }
+}
+
 int16_t MQTTClient_get(MQTTClient_Handle handle, uint16_t option, void *value, uint16_t valueLength)
 {
+    switch (option)
+    {
+        case MQTTClient_PUBLISH_WINDOW:
+            *((uint16_t *)value) = MQTTClient_clientContext->pubWindow;
+            break;
+        default:
+            break;
+    }
     return  0;
 }
 
@@ -1103,6 +1250,7 @@ int16_t MQTTClient_set(MQTTClient_Handle handle, uint16_t option, void *value, u
     int32_t   retVal = 0;
     uint16_t *keep_alive;
     bool     *clean;
+    uint16_t  window;
 
     switch (option)
     {
@@ -1129,6 +1277,23 @@ int16_t MQTTClient_set(MQTTClient_Handle handle, uint16_t option, void *value, u
             clean = (bool *)value;
             MQTTClient_connectCfg.clean = *clean;
             break;
+        case MQTTClient_PUBLISH_WINDOW:
+            window = *((uint16_t *)value);
+            /* In-flight messages hold their MQP until acknowledged, leave
+             one in the pool to receive the ACK(s) */
+            if (window > (MQTTCLIENT_MAX_MQP - 1))
+            {
+                window = MQTTCLIENT_MAX_MQP - 1;
+                retVal = MQTTCLIENT_ERR_FNPARAM;
+            }
+            MQTTClient_mutexLock();
+            MQTTClient_clientContext->pubWindow = window;
+            while (0 != MQTTClient_clientContext->pubWaiters)
+            {
+                pubWindowSignal(MQTTClient_clientContext);
+            }
+            MQTTClient_mutexUnlock();
+            break;
         default:
             break;
     }
@@ -68,6 +68,8 @@
  * - <b> CFG_SL_CL_STACK: </b> Max stack (bytes) for RX Task executed by SL-MQTT. \n\n
  * - <b> CFG_CL_MQTT_CTXS: </b> the max number of simultaneous network connections
  to one or more servers. \n\n
+ * - <b> CFG_CL_MQTT_MAX_INFLT: </b> the max number of messages awaiting an ACK
+ on a connection, which bounds #MQTTClient_PUBLISH_WINDOW. \n\n
 
  * \note An app that has chosen not to await an ACK from the server for an
  scheduled transaction can benefit from the availability of control to
@@ -154,7 +156,8 @@ typedef enum
     MQTTClient_CALLBACKS      = 3,
     MQTTClient_KEEPALIVE_TIME = 4,
     MQTTClient_CLEAN_CONNECT  = 5,
-    MQTTClient_MAX_PARAM      = 6
+    MQTTClient_PUBLISH_WINDOW = 6,
+    MQTTClient_MAX_PARAM      = 7
 } MQTTClient_Option;
 
 /* callbacks   */
@@ -169,6 +172,7 @@ typedef enum
 typedef struct MQTTClient_OperationMetaDataCB
 {
     uint32_t messageType;
+    uint16_t msgID;       /**< transaction Message ID of the acknowledged message */
 } MQTTClient_OperationMetaDataCB;
 
 typedef struct MQTTClient_RecvMetaDataCB
@@ -178,6 +182,7 @@ typedef struct MQTTClient_RecvMetaDataCB
     bool dup;
     uint8_t qos;
     bool retain;
+    void *recvBuffer; /**< library buffer holding topic and payload, see MQTTClient_holdRecvBuffer() */
 } MQTTClient_RecvMetaDataCB;
 
 
@@ -329,6 +334,12 @@ int16_t MQTTClient_disconnect(MQTTClient_Handle handle);
  the MQTT implementation will notify the app about the subscription
  through the callback routine.
 
+ With a window set through #MQTTClient_PUBLISH_WINDOW, QoS1 and QoS2
+ messages are pipelined, whatever the choice of blocking: the routine returns
+ once the message is sent and blocks only while the window is full. Each
+ completion (PUBACK or PUBCOMP) is reported through the callback with the
+ Message ID of the message.
+
  \param[in] handle         handle to the MQTTClient instance
  \param[in] topic  topic of the data to be published. It is NULL terminated.
  \param[in] topicLen  topic length.
@@ -384,8 +395,14 @@ int16_t MQTTClient_unsubscribe(MQTTClient_Handle handle, MQTTClient_UnsubscribeP
  \brief     Set client parameters
 
  This function can set different parameters to the client.
- Will message params, user name and password, keep alive time and
- clean/persistent session.
+ Will message params, user name and password, keep alive time,
+ clean/persistent session and the window of pipelined PUBLISH messages.
+
+ #MQTTClient_PUBLISH_WINDOW takes a uint16_t count of QoS1/2 messages that
+ can await their ACK at a time, 0 (default) to disable pipelining. Each one
+ holds a buffer of the pool until acknowledged, so the window is limited to
+ CFG_SL_CL_MAX_MQP - 1, leaving a buffer to receive the ACK(s). A larger
+ window is cut down to that limit and #MQTTCLIENT_ERR_FNPARAM is returned.
 
  \param[in] handle      handle to the MQTTClient instance
  \param[in] option      Define the actual option to set. Applicable values:
@@ -394,6 +411,7 @@ int16_t MQTTClient_unsubscribe(MQTTClient_Handle handle, MQTTClient_UnsubscribeP
                            - #MQTTClient_WILL_PARAM
                            - #MQTTClient_KEEPALIVE_TIME
                            - #MQTTClient_CLEAN_CONNECT
+                           - #MQTTClient_PUBLISH_WINDOW
  \param[in] value       Specifies a value for the option
  \param[in] valueLength Specifies the length of the value
 
@@ -417,6 +435,7 @@ int16_t MQTTClient_set(MQTTClient_Handle handle, uint16_t option, void *value, u
                            - #MQTTClient_WILL_PARAM
                            - #MQTTClient_KEEPALIVE_TIME
                            - #MQTTClient_CLEAN_CONNECT
+                           - #MQTTClient_PUBLISH_WINDOW
  \param[in] value       Specifies a value for the option
  \param[in] valueLength Specifies the length of the value
 
@@ -426,6 +445,39 @@ int16_t MQTTClient_set(MQTTClient_Handle handle, uint16_t option, void *value, u
  */
 int16_t MQTTClient_get(MQTTClient_Handle handle, uint16_t option, void *value, uint16_t valueLength);
 
+/**
+ \brief     Keep the buffer of a received message after the callback returns
+
+ The topic and data presented with #MQTTClient_RECV_CB_EVENT point into a
+ buffer of the library pool, which is reused once the callback returns. An
+ app that processes the message in another context can hold that buffer
+ instead of copying the message out of it. This routine must be invoked from
+ within the callback.
+
+ The held buffer is not available to the library for further transactions,
+ hence CFG_SL_CL_MAX_MQP must allow for the number of messages the app holds
+ at a time. The request is declined when the pool can not spare the buffer.
+
+ \param[in] metaData       meta data presented with #MQTTClient_RECV_CB_EVENT
+
+ \return Success (handle of the held buffer) or Failure (NULL)
+
+ \sa MQTTClient_releaseRecvBuffer()
+ */
+void *MQTTClient_holdRecvBuffer(MQTTClient_RecvMetaDataCB *metaData);
+
+/**
+ \brief     Return a held receive buffer to the library pool
+
+ It may also be invoked from within the receive callback, to undo the hold of
+ the message being presented, e.g. when the app fails to queue it.
+
+ \param[in] recvBuffer     handle returned by MQTTClient_holdRecvBuffer()
+
+ \sa MQTTClient_holdRecvBuffer()
+ */
+void MQTTClient_releaseRecvBuffer(void *recvBuffer);
+
 /*! @} */
 #ifdef __cplusplus
 }
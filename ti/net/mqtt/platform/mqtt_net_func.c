@@ -37,7 +37,11 @@
 
 #include "mqtt_net_func.h"
 
+/* Connections the listener holds ahead of accept(); a broker that many
+ * devices connect to at once needs more */
+#ifndef LISTEN_QUE_SIZE
 #define LISTEN_QUE_SIZE 2
+#endif
 
 //*****************************************************************************
 //
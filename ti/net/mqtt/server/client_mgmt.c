@@ -40,14 +40,10 @@
 #define MAX_CLIENT_ID_LEN CFG_SR_MAX_CL_ID_SIZE
 #endif
 
-#ifndef CFG_SR_MAX_NUM_CLIENT
-#define MAX_CLIENTS       16 /* Must not exceed 32 */
-#else
-#define MAX_CLIENTS       CFG_SR_MAX_NUM_CLIENT
+#define MAX_CLIENTS       MQTTSERVERUTIL_MAX_CLIENTS
 
-#if (CFG_SR_MAX_NUM_CLIENT > 32)
-#error "CFG_SR_MAX_NUM_CLIENT must not exceed 32"
-#endif
+#if (MAX_CLIENTS > 4096)
+#error "CFG_SR_MAX_NUM_CLIENT must not exceed 4096"
 #endif
 
 #define MQTTCLIENTMGMT_MQ_CONNECT_FLAG  0x00000001
@@ -62,11 +58,9 @@
           ((MQTT_QOS0 == qos)))?                           \
          false : true)
 
-#define MQTTClientMgmt_mqpMapGet(mqp)        (mqp->sessionDataPresent)
-#define MQTTClientMgmt_mqpMapSet(mqp, clMap) (mqp->sessionDataPresent |=  clMap)
-#define MQTTClientMgmt_mqpMapClr(mqp, clMap) (mqp->sessionDataPresent &= ~clMap)
-
-#define MQTTClientMgmt_bmap(usr)             (1 << usr->index)
+#define MQTTClientMgmt_mqpMapHas(mqp, usr)   MQTTServerUtil_clMapTest(MQTTServerUtil_mqpClMap(mqp), usr->index)
+#define MQTTClientMgmt_mqpMapClr(mqp, usr)   MQTTServerUtil_clMapClr(MQTTServerUtil_mqpClMap(mqp), usr->index)
+#define MQTTClientMgmt_mqpMapIsEmpty(mqp)    MQTTServerUtil_clMapIsEmpty(MQTTServerUtil_mqpClMap(mqp))
 
 //*****************************************************************************
 // typedefs
@@ -108,6 +102,8 @@ static MQTT_AckWlist_t *MQTTClientMgmt_pWlQosAck1 = &MQTTClientMgmt_wlQosAck1;
 static MQTT_AckWlist_t MQTTClientMgmt_wlMqpSess = { NULL, NULL };
 static MQTT_AckWlist_t *MQTTClientMgmt_pWlMqpSess = &MQTTClientMgmt_wlMqpSess;
 
+static MQTTClientMgmt_DispatchStats_t MQTTClientMgmt_stats;
+
 
 //*****************************************************************************
 // Internal Routines
@@ -326,13 +322,19 @@ static inline bool qos2PubRxIsDone(MQTTClientMgmt_usr_t *usr, uint16_t msgID)
 //*****************************************************************************
 static void ack2MsgIdDispatch(MQTTClientMgmt_usr_t *usr)
 {
-    MQTT_PubQOS2CQ_t     *tx_cq = &usr->qos2_tx_cq;
-    MQTT_ListPubQOS2CQ_t *rdIdx = tx_cq->rdIdx;
+    MQTT_PubQOS2CQ_t *tx_cq = &usr->qos2_tx_cq;
+    uint16_t          msgID;
+    uint16_t          n;
 
-    for (; NULL != rdIdx; rdIdx = rdIdx->next)
+    for (n = 0; n < tx_cq->nSpan; n++)
     {
+        msgID = MQTT_qos2PubCqPeek(tx_cq, n);
+        if (0 == msgID)
+        {
+            continue; /* Already completed, out of order */
+        }
         if (MQTTServerPkts_sendVhMsg(usr->ctx, MQTT_PUBREL, MQTT_QOS1,
-                            true, rdIdx->msgID) <= 0)
+                            true, msgID) <= 0)
         {
             break;
         }
@@ -374,7 +376,7 @@ static void ack1WlMqpDispatch(MQTTClientMgmt_usr_t *usr)
 
     for (mqp = MQTTClientMgmt_pWlQosAck1->head; NULL != mqp; mqp = mqp->next)
     {
-        if (MQTTClientMgmt_mqpMapGet(mqp) & MQTTClientMgmt_bmap(usr))
+        if (MQTTClientMgmt_mqpMapHas(mqp, usr))
         {
             _pubDispatch(usr, mqp, true);
         }
@@ -386,66 +388,90 @@ static void ack1WlMqpDispatch(MQTTClientMgmt_usr_t *usr)
 //! \brief
 //
 //*****************************************************************************
-static inline uint32_t _clBmapGet(void *usrCl)
+static inline uint32_t _clIndexGet(void *usrCl)
 {
     MQTTClientMgmt_usr_t *usr = (MQTTClientMgmt_usr_t *)usrCl;
 
-    return (MQTTClientMgmt_isClUsrFree(usr) ? 0 : MQTTClientMgmt_bmap(usr));
+    return (MQTTClientMgmt_isClUsrFree(usr) ? MQTTCLIENTMGMT_NO_INDEX : usr->index);
 }
 
 //*****************************************************************************
 //
-//! \brief
+//! \brief Sends 'mqp' to each client in 'clMap'. The clients that must still
+//! acknowledge the message are left in the map of 'mqp', which is then
+//! wait-listed; a copy is kept for the inactive clients with a session.
 //
 //*****************************************************************************
-static void pubDispatch(uint32_t clMap, MQTT_Packet_t *mqp)
+static void pubDispatch(const MQTTServerUtil_ClMap_t *clMap, MQTT_Packet_t *mqp)
 {
-    uint32_t sp_map = 0; /* client Map for sessions present */
+    MQTTServerUtil_ClMap_t sp_map; /* client Map for sessions present */
+    MQTTServerUtil_ClMap_t *wl_map = MQTTServerUtil_mqpClMap(mqp);
     MQTT_QOS qos = MQTT_FH_BYTE1_QOS(mqp->fhByte1);/* QOS */
-    int32_t i = 0;
+    uint32_t w = 0;
+    uint32_t i = 0;
+    uint32_t bits;
+    bool sessions = false;
     MQTT_Packet_t *cpy;
     MQTTClientMgmt_usr_t *usr;
 
-    for (i = 0; i < MAX_CLIENTS; i++)
+    MQTTServerUtil_clMapZero(&sp_map);
+    MQTTClientMgmt_stats.pubs++;
+
+    for (w = 0; w < MQTTSERVERUTIL_CLMAP_WORDS; w++)
     {
-        if (clMap & (1 << i))
+        /* Skip a whole word of clients that are not in the map */
+        bits = clMap->word[w];
+        MQTTClientMgmt_stats.wordsScanned++;
+
+        for (i = w * 32; 0 != bits; i++, bits >>= 1)
         {
+            if (0 == (bits & 1))
+            {
+                continue;
+            }
+
             usr = users + i;
             if (isConnected(usr))
             {
-                if ((_pubDispatch(usr, mqp, false) > 0) && MQTTClientMgmt_needToWaitListPublish(qos, usr))
+                if (_pubDispatch(usr, mqp, false) > 0)
                 {
-                    continue;/* Processing done; next CL */
+                    MQTTClientMgmt_stats.deliveries++;
+                    if (MQTTClientMgmt_needToWaitListPublish(qos, usr))
+                    {
+                        /* Processing done; next CL */
+                        MQTTServerUtil_clMapSet(wl_map, i);
+                        continue;
+                    }
                 }
             }
             /* CL: unconnected / PUB Err / QOS1 PKT (clean sess) */
-            clMap &= ~(1 << i);
-
             if (MQTTClientMgmt_isClInactive(usr))
             {
-                sp_map |= (1 << i); /* CL: Maintain session */
+                MQTTServerUtil_clMapSet(&sp_map, i); /* CL: Maintain session */
+                sessions = true;
             }
         }
     }
 
-    if (sp_map)
+    if (sessions)
     {
-        cpy = MQTTServerUtil_mqpCopy(mqp); /* Make copy */
+        cpy = MQTTServerUtil_mqpView(mqp); /* Share the buffer */
         if (cpy)
         {
-            MQTTClientMgmt_mqpMapSet(cpy, sp_map);
+            *MQTTServerUtil_mqpClMap(cpy) = sp_map;
             MQTT_packetAckWlistAppend(MQTTClientMgmt_pWlMqpSess, cpy);
+            MQTTClientMgmt_stats.sessionViews++;
         }
         else
         {
-            sp_map = 0;
+            MQTTClientMgmt_stats.sessionDrops++;
         }
     }
 
-    if (clMap)
+    if (false == MQTTServerUtil_clMapIsEmpty(wl_map))
     { /* Wait List Publish */
-        MQTTClientMgmt_mqpMapSet(mqp, clMap);
         MQTT_packetAckWlistAppend(MQTTClientMgmt_pWlQosAck1, mqp);
+        MQTTClientMgmt_stats.waitListed++;
     }
     else
     {
@@ -505,9 +531,12 @@ static void sessWlMqpDispatch(MQTTClientMgmt_usr_t *usr)
     MQTT_Packet_t *prev = NULL;
     MQTT_Packet_t *next = NULL;
     MQTT_Packet_t *cpy;
-    uint32_t clMap = MQTTClientMgmt_bmap(usr);
+    MQTTServerUtil_ClMap_t clMap;
     uint32_t freeMsgCounter = MQTT_MAX_PUBREL_INFLT;    /* This variable will count the messages for the specific client */
 
+    MQTTServerUtil_clMapZero(&clMap);
+    MQTTServerUtil_clMapSet(&clMap, usr->index);
+
     for (mqp = MQTTClientMgmt_pWlMqpSess->head; NULL != mqp; prev = mqp, mqp = next)
     {
         cpy = NULL;
@@ -515,17 +544,17 @@ static void sessWlMqpDispatch(MQTTClientMgmt_usr_t *usr)
         next = mqp->next; /* Store the next node pointer */
 
         /* Check if the MQP is associated with this client */
-        if (0 == (MQTTClientMgmt_mqpMapGet(mqp) & clMap))
+        if (false == MQTTClientMgmt_mqpMapHas(mqp, usr))
         {
             continue; /* MQP & CL: no association */
         }
         /* MQP has associated client(s) -  process it */
 
         /* Dissociate this client from MQP */
-        MQTTClientMgmt_mqpMapClr(mqp, clMap);
+        MQTTClientMgmt_mqpMapClr(mqp, usr);
 
         /* Check if mqp is not associated with other clients */
-        if (0 == MQTTClientMgmt_mqpMapGet(mqp))
+        if (MQTTClientMgmt_mqpMapIsEmpty(mqp))
         {
             /* MQP w/ no clients,  remove from WL */
             wlRemove(MQTTClientMgmt_pWlMqpSess, prev, mqp);
@@ -537,22 +566,22 @@ static void sessWlMqpDispatch(MQTTClientMgmt_usr_t *usr)
         else
         {
             /* MQP is associated w/ other clients */
-            cpy = MQTTServerUtil_mqpCopy(mqp);
+            cpy = MQTTServerUtil_mqpView(mqp);
 
             if (NULL == cpy)
             {
                 continue;
             }
 
-            /* use the copied mqp only for the specific client */
-            MQTTClientMgmt_mqpMapGet(cpy) = 0;
+            /* use the view of mqp only for the specific client,
+               its map of clients starts empty */
         }
 
         /* Check if there is no more free space for publish messages */
         if (0 == freeMsgCounter)
         {
             /* if there is no free space and no more receptions for the message, delete it */
-            if (0 == MQTTClientMgmt_mqpMapGet(cpy))
+            if (MQTTClientMgmt_mqpMapIsEmpty(cpy))
             {
                 MQTT_packetFree(cpy); /* PUB MQP now has no more use because we have reached maximum PUB allowed; must be freed */
             }
@@ -566,7 +595,7 @@ static void sessWlMqpDispatch(MQTTClientMgmt_usr_t *usr)
         }
 
         /* Got packet from session, dispatch it to CL */
-        pubDispatch(clMap, cpy);
+        pubDispatch(&clMap, cpy);
     }
 
     return;
@@ -584,10 +613,10 @@ static MQTT_Packet_t *wlMqpUnmapFind(MQTT_AckWlist_t *wl, MQTTClientMgmt_usr_t *
     *prev = NULL;
     for (mqp = wl->head; NULL != mqp; *prev = mqp, mqp = mqp->next)
     {
-        if (msgID == mqp->msgID)
+        if ((msgID == mqp->msgID) && MQTTClientMgmt_mqpMapHas(mqp, usr))
         {
-            /* Found a MQP whose msgID matches with input */
-            MQTTClientMgmt_mqpMapClr(mqp, MQTTClientMgmt_bmap(usr));
+            /* Found a MQP of this client whose msgID matches with input */
+            MQTTClientMgmt_mqpMapClr(mqp, usr);
             return mqp;
         }
     }
@@ -602,7 +631,7 @@ static MQTT_Packet_t *wlMqpUnmapFind(MQTT_AckWlist_t *wl, MQTTClientMgmt_usr_t *
 //*****************************************************************************
 static bool wlRmfreeTry(MQTT_AckWlist_t *wl, MQTT_Packet_t *prev, MQTT_Packet_t *mqp)
 {
-    if (0 == MQTTClientMgmt_mqpMapGet(mqp))
+    if (MQTTClientMgmt_mqpMapIsEmpty(mqp))
     {
         wlRemove(wl, prev, mqp);
         MQTT_packetFree(mqp);
@@ -645,7 +674,6 @@ static void wlPurge(MQTT_AckWlist_t *wl, MQTTClientMgmt_usr_t *usr)
     MQTT_Packet_t *mqp = NULL;
     MQTT_Packet_t *prev = NULL;
     MQTT_Packet_t *next = NULL;
-    uint32_t bmap = MQTTClientMgmt_bmap(usr);
 
     for (mqp = wl->head; NULL != mqp; prev = mqp, mqp = next)
     {
@@ -656,7 +684,7 @@ static void wlPurge(MQTT_AckWlist_t *wl, MQTTClientMgmt_usr_t *usr)
          moment, blind clearing of the bit has been implemented and
          it has no side effects.
          */
-        MQTTClientMgmt_mqpMapClr(mqp, bmap);
+        MQTTClientMgmt_mqpMapClr(mqp, usr);
 
         /* MQP with no clients has no more use, so try deleting MQP */
         if (wlRmfreeTry(wl, prev, mqp))
@@ -719,7 +747,6 @@ static void sessionDelete(MQTTClientMgmt_usr_t *usr)
 //*****************************************************************************
 static bool hasSessionData(MQTTClientMgmt_usr_t *usr)
 {
-    uint32_t map = MQTTClientMgmt_bmap(usr);
     MQTT_Packet_t *elem;
 
     if (usr->n_sub)
@@ -729,7 +756,7 @@ static bool hasSessionData(MQTTClientMgmt_usr_t *usr)
     elem = MQTTClientMgmt_pWlQosAck1->head;
     while (elem)
     {
-        if (MQTTClientMgmt_mqpMapGet(elem) & map)
+        if (MQTTClientMgmt_mqpMapHas(elem, usr))
         {
             return true;
         }
@@ -739,7 +766,7 @@ static bool hasSessionData(MQTTClientMgmt_usr_t *usr)
     elem = MQTTClientMgmt_pWlMqpSess->head;
     while (elem)
     {
-        if (MQTTClientMgmt_mqpMapGet(elem) & map)
+        if (MQTTClientMgmt_mqpMapHas(elem, usr))
         {
             return true;
         }
@@ -805,9 +832,16 @@ static void assignClIndexAsId(MQTTClientMgmt_usr_t *usr)
     clientID[2] = 'l';
     clientID[3] = 'f';
     clientID[4] = '-';
+#if (MAX_CLIENTS > 256)
+    clientID[5] = ((usr->index & 0xf00) >> 8) + 0x30;
+    clientID[6] = ((usr->index & 0x0f0) >> 4) + 0x30;
+    clientID[7] = ((usr->index & 0x00f)) + 0x30;
+    clientID[8] = '\0';
+#else
     clientID[5] = ((usr->index & 0xf0) >> 4) + 0x30;
     clientID[6] = ((usr->index & 0x0f)) + 0x30;
     clientID[7] = '\0';
+#endif
 
     /* Make sure that above array size is with in MAX_CLIENT_ID_LEN */
 
@@ -932,9 +966,9 @@ bool MQTTClientMgmt_qos2PubRxUpdate(void *usrCl, uint16_t msgID)
 //! \brief
 //
 //*****************************************************************************
-uint32_t MQTTClientMgmt_bmapGet(void *usrCl)
+uint32_t MQTTClientMgmt_indexGet(void *usrCl)
 {
-    return (usrCl ? _clBmapGet(usrCl) : 0);
+    return (usrCl ? _clIndexGet(usrCl) : MQTTCLIENTMGMT_NO_INDEX);
 }
 
 //*****************************************************************************
@@ -966,12 +1000,22 @@ void *MQTTClientMgmt_willHndlGet(void *usrCl)
 //! \brief
 //
 //*****************************************************************************
-void MQTTClientMgmt_pubDispatch(uint32_t clMap, MQTT_Packet_t *mqp)
+void MQTTClientMgmt_pubDispatch(const MQTTServerUtil_ClMap_t *clMap, MQTT_Packet_t *mqp)
 {
     pubDispatch(clMap, mqp);
     return;
 }
 
+//*****************************************************************************
+//
+//! \brief
+//
+//*****************************************************************************
+void MQTTClientMgmt_dispatchStatsGet(MQTTClientMgmt_DispatchStats_t *stats)
+{
+    *stats = MQTTClientMgmt_stats;
+}
+
 //*****************************************************************************
 //
 //! \brief
@@ -979,6 +1023,7 @@ void MQTTClientMgmt_pubDispatch(uint32_t clMap, MQTT_Packet_t *mqp)
 //*****************************************************************************
 int32_t MQTTClientMgmt_pubMsgSend(void *usrCl, const MQTT_UTF8String_t *topic, const uint8_t *dataBuf, uint32_t dataLen, MQTT_QOS qos, bool retain)
 {
+    MQTTServerUtil_ClMap_t clMap;
     MQTT_Packet_t *mqp = NULL;
 
     if ((NULL == topic) || ((dataLen > 0) && (NULL == dataBuf)) || (NULL == usrCl))
@@ -996,7 +1041,12 @@ int32_t MQTTClientMgmt_pubMsgSend(void *usrCl, const MQTT_UTF8String_t *topic, c
     }
     MQTT_packetPrepFh(mqp, MQTT_MAKE_FH_FLAGS(false, qos, retain));
 
-    pubDispatch(_clBmapGet(usrCl), mqp);
+    MQTTServerUtil_clMapZero(&clMap);
+    if (MQTTCLIENTMGMT_NO_INDEX != _clIndexGet(usrCl))
+    {
+        MQTTServerUtil_clMapSet(&clMap, _clIndexGet(usrCl));
+    }
+    pubDispatch(&clMap, mqp);
 
     return MQTT_PACKET_CONTENT_LEN(mqp);
 }
@@ -1170,6 +1220,7 @@ int32_t MQTTClientMgmt_init(void)
 {
     /* Initialize the user list */
     clUsrInit();
+    memset(&MQTTClientMgmt_stats, 0, sizeof(MQTTClientMgmt_stats));
     /* Reset the Message ID counter */
     MQTTServerUtil_resetMsgID();
 
@@ -35,11 +35,29 @@
 
 #include <ti/net/mqtt/common/mqtt_common.h>
 
+#include "server_util.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-uint32_t MQTTClientMgmt_bmapGet(void *usrCl);
+/* Index returned by MQTTClientMgmt_indexGet() for an unassigned client */
+#define MQTTCLIENTMGMT_NO_INDEX     0xFFFFFFFF
+
+/* Counters of the PUBLISH fan-out to the clients, see MQTTClientMgmt_pubDispatch() */
+typedef struct _MQTTClientMgmt_DispatchStats_t_
+{
+    uint32_t pubs;          /* PUBLISH messages dispatched               */
+    uint32_t deliveries;    /* PUBLISH messages sent to a client         */
+    uint32_t wordsScanned;  /* words of client maps walked by dispatch   */
+    uint32_t waitListed;    /* messages held until acknowledged          */
+    uint32_t sessionViews;  /* views kept for inactive sessions          */
+    uint32_t sessionDrops;  /* session views lost for want of memory     */
+
+}MQTTClientMgmt_DispatchStats_t;
+
+/* Index of the client in the maps of subscribers, MQTTCLIENTMGMT_NO_INDEX if none */
+uint32_t MQTTClientMgmt_indexGet(void *usrCl);
 
 void *MQTTClientMgmt_appHndlGet(void *usrCl);
 
@@ -53,7 +71,9 @@ void MQTTClientMgmt_subCountDel(void *usrCl);
 
 bool MQTTClientMgmt_qos2PubRxUpdate(void *usrCl, uint16_t msgID);
 
-void MQTTClientMgmt_pubDispatch(uint32_t clMap, MQTT_Packet_t *mqp);
+void MQTTClientMgmt_pubDispatch(const MQTTServerUtil_ClMap_t *clMap, MQTT_Packet_t *mqp);
+
+void MQTTClientMgmt_dispatchStatsGet(MQTTClientMgmt_DispatchStats_t *stats);
 
 int32_t MQTTClientMgmt_pubMsgSend(void *usrCl,
                     const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
@@ -66,6 +66,34 @@
 #define MAX_STACK_NODES  CFG_SR_MAX_STACK_NODE
 #endif
 
+/* Definition for the number of buckets of the
+   hashed child index, must be a power of 2.
+   Nodes are hashed on their parent node and
+   sub-topic, so that a child is found without
+   walking its list of neighbors */
+#ifndef CFG_SR_NODE_HASH_SIZE
+#define NODE_HASH_SIZE  64
+#else
+#define NODE_HASH_SIZE  CFG_SR_NODE_HASH_SIZE
+#endif
+
+#if (NODE_HASH_SIZE & (NODE_HASH_SIZE - 1))
+#error "CFG_SR_NODE_HASH_SIZE must be a power of 2"
+#endif
+
+/* Definition for the number of PUB topics, whose
+   matching SUB leaves are remembered. Topics that
+   are longer than PUB_CACHE_TOPLEN or that match
+   more than PUB_CACHE_LEAVES leaves are not cached */
+#ifndef CFG_SR_PUB_CACHE_SIZE
+#define PUB_CACHE_SIZE  8
+#else
+#define PUB_CACHE_SIZE  CFG_SR_PUB_CACHE_SIZE
+#endif
+
+#define PUB_CACHE_TOPLEN  64
+#define PUB_CACHE_LEAVES  4
+
 #define TNODE_PROP_RETAIN_DATA  0x04
 #define WBUF_LEN   MQP_SERVER_RX_LEN /* Assignment to ease implementation */
 #define NODE_DATA_RESET_PARAMS  NULL, 0, 0, false
@@ -146,7 +174,10 @@ typedef struct _MQTTServerCore_TopicNode_t_
     struct _MQTTServerCore_TopicNode_t_ *dnHier; /* Down Link Hierarchy node */
     struct _MQTTServerCore_TopicNode_t_ *upHier; /* Up   Link Hierarchy node */
 
-    uint32_t clMap[3]; /* Subscribers for each QOS */
+    struct _MQTTServerCore_TopicNode_t_ *parent; /* Node one level up, NULL at top */
+    struct _MQTTServerCore_TopicNode_t_ *hnext;  /* Next node in the hash bucket */
+
+    MQTTServerUtil_ClMap_t clMap[3]; /* Subscribers for each QOS */
 
     uint8_t *myData;   /* Leaf node: retained data */
     uint32_t myDlen;
@@ -158,6 +189,7 @@ typedef struct _MQTTServerCore_TopicNode_t_
     uint8_t  pgMap;    /* Map: application plugins */
 
     uint16_t toplen;   /* Length of node sub-topic */
+    uint16_t hash;     /* Hash of node sub-topic */
     char    *subtop;   /* NULL terminated sub-topic */
 
 }MQTTServerCore_TopicNode_t;
@@ -168,7 +200,7 @@ typedef struct _MQTTServerCore_TopicNode_t_
 typedef struct _MQTTServerCore_NodeStack_t_
 {
     MQTTServerCore_TopicNode_t *node;
-    uint32_t val1;
+    uintptr_t val1;
     uint32_t val2;
 
 }MQTTServerCore_NodeStack_t;
@@ -193,6 +225,21 @@ typedef struct _MQTTServerCore_WillParams_t_
 
 }MQTTServerCore_WillParams_t;
 
+/*
+ A PUB topic and the SUB leaves that it matched, valid until the topic tree
+ changes shape (generation).
+ */
+typedef struct _MQTTServerCore_PubCache_t_
+{
+    uint32_t gen;                                       /* 0: entry not in use */
+    uint16_t hash;
+    uint16_t toplen;
+    uint8_t  nLeaves;
+    MQTTServerCore_TopicNode_t *leaves[PUB_CACHE_LEAVES];
+    char     topic[PUB_CACHE_TOPLEN];
+
+}MQTTServerCore_PubCache_t;
+
 /* Stack Index */
 static int32_t MQTTServerCore_stackIdx = 0;
 
@@ -210,6 +257,16 @@ static char MQTTServerCore_workBuf[WBUF_LEN];
 
 static MQTTServerCore_NodeStack_t node_stack[MAX_STACK_NODES];
 
+/* Hashed index of the children of each node */
+static MQTTServerCore_TopicNode_t *MQTTServerCore_nodeHash[NODE_HASH_SIZE];
+
+/* Bumped whenever a node is added to or removed from the tree */
+static uint32_t MQTTServerCore_treeGen = 1;
+
+static MQTTServerCore_PubCache_t MQTTServerCore_pubCache[PUB_CACHE_SIZE];
+
+static MQTTServerCore_RouteStats_t MQTTServerCore_routeStats;
+
 static void try_node_delete(MQTTServerCore_TopicNode_t *node);
 
 //*****************************************************************************
@@ -221,7 +278,7 @@ static void try_node_delete(MQTTServerCore_TopicNode_t *node);
 //! \brief
 //
 //*****************************************************************************
-static void stack_add(MQTTServerCore_TopicNode_t *node, uint32_t val1, uint32_t val2)
+static void stack_add(MQTTServerCore_TopicNode_t *node, uintptr_t val1, uint32_t val2)
 {
     node_stack[MQTTServerCore_stackIdx].node = node;
     node_stack[MQTTServerCore_stackIdx].val1 = val1;
@@ -324,8 +381,12 @@ static void node_reset(MQTTServerCore_TopicNode_t *node)
     node->upNhbr = NULL;
     node->dnHier = NULL;
     node->upHier = NULL;
+    node->parent = NULL;
+    node->hnext  = NULL;
 
-    node->clMap[0] = node->clMap[1] = node->clMap[2] = 0;
+    MQTTServerUtil_clMapZero(&node->clMap[0]);
+    MQTTServerUtil_clMapZero(&node->clMap[1]);
+    MQTTServerUtil_clMapZero(&node->clMap[2]);
     node->myData = NULL;
     node->myDlen = 0;
     node->willCl = 0;
@@ -333,6 +394,145 @@ static void node_reset(MQTTServerCore_TopicNode_t *node)
 
     node->pgMap = PG_MAP_ALL_DFLTS;
     node->toplen = 0;
+    node->hash = 0;
+}
+
+//*****************************************************************************
+//
+//! \brief Hash the first sub-topic in 'topstr', up to and including the '/'.
+//! The length of the sub-topic is provided in 'len'.
+//
+//*****************************************************************************
+static uint16_t subtop_hash(const char *topstr, uint16_t *len)
+{
+    uint32_t hash = 2166136261u; /* FNV-1a */
+    uint16_t idx = 0;
+    char c;
+
+    do
+    {
+        c = topstr[idx];
+        if ('\0' == c)
+        {
+            break;
+        }
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+        idx++;
+
+    } while ('/' != c);
+
+    *len = idx;
+
+    return ((uint16_t)(hash ^ (hash >> 16)));
+}
+
+//*****************************************************************************
+//
+//! \brief Invalidate the PUB cache, the shape of the topic tree has changed
+//
+//*****************************************************************************
+static inline void tree_gen_bump(void)
+{
+    /* Generation 0 marks an unused PUB cache entry */
+    if (0 == ++MQTTServerCore_treeGen)
+    {
+        MQTTServerCore_treeGen = 1;
+    }
+}
+
+//*****************************************************************************
+//
+//! \brief Return the sub-topic that follows the first one in 'topstr', NULL
+//! if there is none. A '\0' after '/' ends the topic.
+//
+//*****************************************************************************
+static const char *next_subtop_get(const char *topstr)
+{
+    uint16_t len;
+
+    subtop_hash(topstr, &len);
+
+    return (((0 != len) && ('/' == topstr[len - 1]) && ('\0' != topstr[len])) ? topstr + len : NULL);
+}
+
+//*****************************************************************************
+//
+//! \brief Bucket, in the child index, of the child of 'parent' whose sub-topic
+//! hashes to 'hash'. The root level nodes have a NULL 'parent'.
+//
+//*****************************************************************************
+static inline uint32_t node_hash_idx(const MQTTServerCore_TopicNode_t *parent, uint16_t hash)
+{
+    return ((((uint32_t)((uintptr_t)parent >> 3)) * 31 + hash) & (NODE_HASH_SIZE - 1));
+}
+
+//*****************************************************************************
+//
+//! \brief Enter a node, whose parent has been set, into the child index
+//
+//*****************************************************************************
+static void node_hash_add(MQTTServerCore_TopicNode_t *node)
+{
+    uint16_t len;
+    uint32_t idx;
+
+    node->hash = subtop_hash(node->subtop, &len);
+    idx = node_hash_idx(node->parent, node->hash);
+
+    node->hnext = MQTTServerCore_nodeHash[idx];
+    MQTTServerCore_nodeHash[idx] = node;
+
+    tree_gen_bump();
+}
+
+//*****************************************************************************
+//
+//! \brief Remove a node, if present, from the child index
+//
+//*****************************************************************************
+static void node_hash_del(MQTTServerCore_TopicNode_t *node)
+{
+    MQTTServerCore_TopicNode_t **link = MQTTServerCore_nodeHash + node_hash_idx(node->parent, node->hash);
+
+    while (NULL != *link)
+    {
+        if (node == *link)
+        {
+            *link = node->hnext;
+            break;
+        }
+        link = &((*link)->hnext);
+    }
+
+    tree_gen_bump();
+}
+
+//*****************************************************************************
+//
+//! \brief Find the child of 'parent' that matches first subtopic in 'topstr'.
+//! Additionally, on success, pointer to next subtopic in 'topstr' is provided.
+//
+//*****************************************************************************
+static MQTTServerCore_TopicNode_t *child_node_find(const MQTTServerCore_TopicNode_t *parent,
+                                                   const char *topstr, char const **next_subtop)
+{
+    MQTTServerCore_TopicNode_t *node;
+    uint16_t len;
+    uint16_t hash = subtop_hash(topstr, &len);
+
+    for (node = MQTTServerCore_nodeHash[node_hash_idx(parent, hash)]; NULL != node; node = node->hnext)
+    {
+        MQTTServerCore_routeStats.hashProbes++;
+
+        if ((parent == node->parent) && (hash == node->hash) && (len == node->toplen) &&
+            (0 == strncmp(node->subtop, topstr, len)))
+        {
+            *next_subtop = next_subtop_get(topstr);
+            return node;
+        }
+    }
+
+    return NULL;
 }
 
 //*****************************************************************************
@@ -379,6 +579,9 @@ static void free_node(MQTTServerCore_TopicNode_t *node)
         free(node->myData);
     }
 
+    /* Remove the node from the child index */
+    node_hash_del(node);
+
     /* Free the allocated subtop memory */
     free(node->subtop);
 
@@ -537,17 +740,8 @@ bool is_first_subtop(const char *subtop, const char *topstr, char const **next_s
 MQTTServerCore_TopicNode_t *subtop_nhbr_node_find(const MQTTServerCore_TopicNode_t *root_nh,
                                                 const char *topstr, char const **next_subtop)
 {
-    /* This routine does not make use of 'next_subtop' */
-    while (root_nh)
-    {
-        if (true == is_first_subtop(root_nh->subtop, topstr, next_subtop))
-        {
-            break;
-        }
-        root_nh = root_nh->dnNhbr;
-    }
-
-    return (MQTTServerCore_TopicNode_t *)root_nh;/* Bad: const from pointer removed */
+    /* All the neighbors share the parent of 'root_nh' */
+    return ((NULL != root_nh) ? child_node_find(root_nh->parent, topstr, next_subtop) : NULL);
 }
 
 //*****************************************************************************
@@ -619,7 +813,8 @@ MQTTServerCore_TopicNode_t *leaf_node_find(const char *topstr)
 //! The routine returns a start node of hierarchy and also provides leaf node.
 //
 //*****************************************************************************
-static MQTTServerCore_TopicNode_t *hier_nodes_create(const char *topstr, MQTTServerCore_TopicNode_t **leaf)
+static MQTTServerCore_TopicNode_t *hier_nodes_create(const char *topstr, MQTTServerCore_TopicNode_t *parent,
+                                                     MQTTServerCore_TopicNode_t **leaf)
 {
     MQTTServerCore_TopicNode_t *base = NULL;
     MQTTServerCore_TopicNode_t *node = NULL;
@@ -646,12 +841,15 @@ static MQTTServerCore_TopicNode_t *hier_nodes_create(const char *topstr, MQTTSer
         if (NULL == prev)
         {
             base = node; /* First node of hierarchy */
+            node->parent = parent;
         }
         else
         {
             prev->dnHier = node;
             node->upHier = prev;
+            node->parent = prev;
         }
+        node_hash_add(node);
 
         prev = node;
         topstr = next_subtop;
@@ -722,7 +920,7 @@ MQTTServerCore_TopicNode_t *topic_node_create(const char *topstr)
      found for 'topstr'. Now, let's create remaining branches for string
      'next_subtop' and assign them to appropriately to topic tree.
      */
-    node = hier_nodes_create(next_subtop, &leaf);
+    node = hier_nodes_create(next_subtop, (NULL == base) ? NULL : (flag_nh ? base->parent : base), &leaf);
     if (node)
     {
         if (NULL == base)
@@ -973,7 +1171,7 @@ static MQTTServerCore_TopicNode_t *pub_hier_search(const char *topSUB, const MQT
         }
         if (node->dnNhbr)
         {
-            stack_add(node->dnNhbr, (uint32_t) topSUB, mk_pubtop->offset);
+            stack_add(node->dnNhbr, (uintptr_t) topSUB, mk_pubtop->offset);
         }
         if (false == is_node_SUB_subtop(node, subtop))
         {
@@ -1006,74 +1204,83 @@ static MQTTServerCore_TopicNode_t *pub_hier_search(const char *topSUB, const MQT
 
 //*****************************************************************************
 //
-//! \brief
+//! \brief Log a SUB node that matches the first sub-topic of 'topPUB', so that
+//! its hierarchy is searched by a subsequent iteration.
 //
 //*****************************************************************************
-static bool is_node_PUB_subtop(const MQTTServerCore_TopicNode_t *node, const char *subtop, bool endtop)
+static void SUB_node_log(const MQTTServerCore_TopicNode_t *node, const char *topPUB)
 {
-    /* Assumes that subtop hasn't got any wildcard character */
-    return (((0 == strcmp(subtop, node->subtop)) || (!endtop && (0 == strcmp("+/", node->subtop))) ||
-            (endtop && (0 == strcmp("+", node->subtop)))) ?
-    true : false);
+    if (NULL == node)
+    {
+        return;
+    }
+
+    if (MAX_STACK_NODES == MQTTServerCore_stackIdx)
+    {
+        MQTTServerCore_routeStats.stackFull++;
+        return;
+    }
+
+    stack_add((MQTTServerCore_TopicNode_t *)node, (uintptr_t) topPUB, 0);
 }
 
 //*****************************************************************************
 //
-//! \brief Search node tree, created by subscriptions, for the branch combo, whose
-//! sub-topic sequence 'matches', in entirety, the absolute topic, to which
-//! data has been published. The 'match' criteria is met either through the
-//! wildcard sub-topics or exact compare.
-//! The hierarchical search starts at the specified 'base' node and ends at
-//! the leaf node. If the sequence of 'base-to-leaf' sub-topics 'match' the
-//! 'topPUB', then the leaf node is returned, otherwise a NULL is returned.
-//! As part of hierarchical search, neighboring nodes, if any, are logged
-//! for subsequent iteration of the routine
+//! \brief Search the children of 'parent', in the node tree created by
+//! subscriptions, for the nodes that match the first sub-topic of 'topPUB'.
+//! The 'match' criteria is met either through an exact compare or through the
+//! '+' wildcard; the matching nodes are logged for subsequent iteration. A '#'
+//! child matches rest of 'topPUB' and is returned as a leaf.
 //
 //*****************************************************************************
-static MQTTServerCore_TopicNode_t *SUB_leaf_search(const char *topPUB, const MQTTServerCore_TopicNode_t *base)
+static MQTTServerCore_TopicNode_t *SUB_level_search(const MQTTServerCore_TopicNode_t *parent, const char *topPUB)
 {
-    const MQTTServerCore_TopicNode_t *node = base;
-    const MQTTServerCore_TopicNode_t *prev = NULL;
-    const char *next_subtop = topPUB;
-    char *subtop = NULL;
+    const char *next_subtop = NULL;
+    bool endtop = (NULL == next_subtop_get(topPUB)) ? true : false;
 
-    while (next_subtop && node)
-    {
-        if (subtop_read(topPUB, &subtop, MAX_SUBTOP_LEN, &next_subtop) < 0)
-        {
-            break;
-        }
-        if (node->dnNhbr)
-        {
-            stack_add(node->dnNhbr, (uint32_t) topPUB, 0);
-        }
-        if (0 == strcmp("#", node->subtop))
-        {
-            free(subtop);
-            return (MQTTServerCore_TopicNode_t *)node;
-        }
+    /* Assumes that topPUB hasn't got any wildcard character */
+    SUB_node_log(child_node_find(parent, topPUB, &next_subtop), topPUB);
+    SUB_node_log(child_node_find(parent, endtop ? "+" : "+/", &next_subtop), topPUB);
 
-        if (false == is_node_PUB_subtop(node, subtop, !next_subtop))
-        {
-            free(subtop);
-            break; /* Node doesn't form part of published topic */
-        }
-        prev = node;
-        node = node->dnHier;
+    return (child_node_find(parent, "#", &next_subtop));
+}
 
-        topPUB = next_subtop;
-        free(subtop);
-    }
+//*****************************************************************************
+//
+//! \brief Find the PUB cache entry of 'topPUB', if it is still valid
+//
+//*****************************************************************************
+static MQTTServerCore_PubCache_t *pub_cache_find(const char *topPUB, uint32_t toplen, uint16_t hash)
+{
+    MQTTServerCore_PubCache_t *entry = MQTTServerCore_pubCache + (hash % PUB_CACHE_SIZE);
 
-    if (NULL != next_subtop)
+    if ((MQTTServerCore_treeGen == entry->gen) && (hash == entry->hash) &&
+        (toplen == entry->toplen) && (0 == memcmp(entry->topic, topPUB, toplen)))
     {
-        node = NULL;
+        return entry;
     }
-    else
+
+    return NULL;
+}
+
+//*****************************************************************************
+//
+//! \brief Hash a complete PUB topic
+//
+//*****************************************************************************
+static uint16_t pub_topic_hash(const char *topPUB, uint32_t *toplen)
+{
+    uint32_t hash = 2166136261u; /* FNV-1a */
+    uint32_t idx = 0;
+
+    for (idx = 0; '\0' != topPUB[idx]; idx++)
     {
-        node = prev;
+        hash = (hash ^ (uint8_t)topPUB[idx]) * 16777619u;
     }
-    return (MQTTServerCore_TopicNode_t *)node; // Bad
+
+    *toplen = idx;
+
+    return ((uint16_t)(hash ^ (hash >> 16)));
 }
 
 /*-------------------------------------------------------------------------
@@ -1091,7 +1298,9 @@ static void try_node_delete(MQTTServerCore_TopicNode_t *node)
     while (node)
     {
         if (is_node_retain(node) || is_node_willed(node) || enrolls_plugin(node) ||
-            node->clMap[0] || node->clMap[1] || node->clMap[2])
+            (false == MQTTServerUtil_clMapIsEmpty(&node->clMap[0])) ||
+            (false == MQTTServerUtil_clMapIsEmpty(&node->clMap[1])) ||
+            (false == MQTTServerUtil_clMapIsEmpty(&node->clMap[2])))
         {
             break;
         }
@@ -1101,11 +1310,11 @@ static void try_node_delete(MQTTServerCore_TopicNode_t *node)
 
 //*****************************************************************************
 //
-//! \brief
+//! \brief Encode a PUBLISH message, NULL if it could not be allocated
 //
 //*****************************************************************************
-static void pub_msg_send(const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
-                        uint32_t dataLen, uint8_t fh_flags, uint32_t clMap)
+static MQTT_Packet_t *pub_msg_build(const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
+                                    uint32_t dataLen, uint8_t fh_flags)
 {
     MQTT_QOS qos = MQTT_FH_BYTE1_QOS(fh_flags);
     MQTT_Packet_t *mqp = NULL;
@@ -1113,24 +1322,93 @@ static void pub_msg_send(const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
     mqp = MQTTServerUtil_mqpAlloc(MQTT_PUBLISH, 2 + topic->length + 2 + dataLen);
     if (NULL == mqp)
     {
-        return;
+        return NULL;
     }
     if ((0 > MQTT_packetPubAppendTopic(mqp, topic, qos ? MQTTServerUtil_setMsgID() : 0)) ||
         (dataLen && (0 > MQTT_packetPubAppendData(mqp, dataBuf, dataLen))))
     {
         MQTT_packetFree(mqp);
-        return;
+        return NULL;
     }
 
     MQTT_packetPrepFh(mqp, fh_flags);
 
-    if (clMap)
+    return mqp;
+}
+
+//*****************************************************************************
+//
+//! \brief
+//
+//*****************************************************************************
+static void pub_msg_send(const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
+                        uint32_t dataLen, uint8_t fh_flags, const MQTTServerUtil_ClMap_t *clMap)
+{
+    MQTT_Packet_t *mqp = pub_msg_build(topic, dataBuf, dataLen, fh_flags);
+
+    if (NULL != mqp)
     {
         MQTTClientMgmt_pubDispatch(clMap, mqp);
     }
-    else
+    return;
+}
+
+//*****************************************************************************
+//
+//! \brief Send a PUBLISH message to the subscribers collected, by QOS, from
+//! all the matching leaves. A client with more than one matching subscription
+//! gets the message once, at the highest QOS. The message is encoded once for
+//! QOS0 and once for QOS1 / QOS2, which share the buffer and differ only in the
+//! fixed header and MSG ID.
+//
+//*****************************************************************************
+static void pub_fanout_send(const MQTT_UTF8String_t *topic, const uint8_t *dataBuf, uint32_t dataLen,
+                            bool dup, bool retain, MQTTServerUtil_ClMap_t *clMap)
+{
+    MQTT_Packet_t *mqp = NULL;
+    MQTT_Packet_t *view = NULL;
+    uint8_t hi_qid;
+
+    MQTTServerUtil_clMapAndNot(&clMap[1], &clMap[2]);
+    MQTTServerUtil_clMapAndNot(&clMap[0], &clMap[2]);
+    MQTTServerUtil_clMapAndNot(&clMap[0], &clMap[1]);
+
+    if (false == MQTTServerUtil_clMapIsEmpty(&clMap[0]))
     {
-        MQTT_packetFree(mqp);
+        pub_msg_send(topic, dataBuf, dataLen, MQTT_MAKE_FH_FLAGS(dup, MQTT_QOS0, retain), &clMap[0]);
+    }
+
+    hi_qid = MQTTServerUtil_clMapIsEmpty(&clMap[2]) ? 1 : 2;
+    if (MQTTServerUtil_clMapIsEmpty(&clMap[hi_qid]))
+    {
+        return; /* No QOS1 or QOS2 subscribers */
+    }
+
+    mqp = pub_msg_build(topic, dataBuf, dataLen, MQTT_MAKE_FH_FLAGS(dup, MK_QOS_ENUM(hi_qid), retain));
+    if (NULL == mqp)
+    {
+        return;
+    }
+
+    if ((2 == hi_qid) && (false == MQTTServerUtil_clMapIsEmpty(&clMap[1])))
+    {
+        /* QOS1 subscribers share the buffer of the QOS2 message */
+        view = MQTTServerUtil_mqpView(mqp);
+        if (NULL != view)
+        {
+            view->fhByte1 = MQTT_MAKE_FH_BYTE1(MQTT_PUBLISH, MQTT_MAKE_FH_FLAGS(dup, MQTT_QOS1, retain));
+            view->msgID = MQTTServerUtil_setMsgID();
+        }
+        else
+        {
+            pub_msg_send(topic, dataBuf, dataLen, MQTT_MAKE_FH_FLAGS(dup, MQTT_QOS1, retain), &clMap[1]);
+        }
+    }
+
+    MQTTClientMgmt_pubDispatch(&clMap[hi_qid], mqp);
+    if (NULL != view)
+    {
+        MQTTClientMgmt_pubDispatch(&clMap[1], view);
     }
     return;
 }
@@ -1144,19 +1422,23 @@ static MQTTServerCore_TopicNode_t *SUB_node_create(const char *topSUB, uint8_t q
 {
     MQTTServerCore_TopicNode_t *leaf = topic_node_create(topSUB);
     uint8_t j;
-    uint32_t map;
+    uint32_t index;
 
     if (leaf)
     {
         j = 0;
-        map = MQTTClientMgmt_bmapGet(usrCl);
+        index = MQTTClientMgmt_indexGet(usrCl);
+        if (MQTTCLIENTMGMT_NO_INDEX == index)
+        {
+            return leaf;
+        }
 
         for (j = 0; j < 3; j++)
         {
             /* Client: clear QOS of existing sub, if any */
-            leaf->clMap[j] &= ~map;
+            MQTTServerUtil_clMapClr(&leaf->clMap[j], index);
         }
-        leaf->clMap[qid] |= map;
+        MQTTServerUtil_clMapSet(&leaf->clMap[qid], index);
 
         MQTTClientMgmt_subCountAdd(usrCl);
     }
@@ -1172,6 +1454,8 @@ static MQTTServerCore_TopicNode_t *SUB_node_create(const char *topSUB, uint8_t q
 static uint8_t proc_pub_leaf(MQTTServerCore_TopicNode_t *leaf, const MQTT_UTF8String_t *topic, MQTT_QOS qos, void *usrCl)
 {
     uint8_t qid = QOS_VALUE(qos);
+    uint32_t index = MQTTClientMgmt_indexGet(usrCl);
+    MQTTServerUtil_ClMap_t map;
 
     if (is_node_retain(leaf))
     {
@@ -1180,7 +1464,12 @@ static uint8_t proc_pub_leaf(MQTTServerCore_TopicNode_t *leaf, const MQTT_UTF8St
         qid = MQTT_MIN(node_qid_get(leaf), qid);
 
         /* Publish the retained data to this client */
-        pub_msg_send(topic, leaf->myData, leaf->myDlen, MQTT_MAKE_FH_FLAGS(false, qid, true), MQTTClientMgmt_bmapGet(usrCl));
+        if (MQTTCLIENTMGMT_NO_INDEX != index)
+        {
+            MQTTServerUtil_clMapZero(&map);
+            MQTTServerUtil_clMapSet(&map, index);
+            pub_msg_send(topic, leaf->myData, leaf->myDlen, MQTT_MAKE_FH_FLAGS(false, qid, true), &map);
+        }
     }
 
     return qid;
@@ -1310,7 +1599,7 @@ static uint8_t proc_pub_tree_SUBtop(const char *topSUB, MQTTServerCore_TopicNode
 
     if (NULL != base)
     {
-        stack_add(base, (uint32_t) topSUB, mk_pubtop->offset);
+        stack_add(base, (uintptr_t) topSUB, mk_pubtop->offset);
     }
     while (stack_ref < MQTTServerCore_stackIdx)
     {
@@ -1402,7 +1691,7 @@ static uint8_t proc_sub_ml_wc_tree(char *grandpa_topSUB, char *parent_subtop, MQ
 
     if (NULL != base)
     {
-        stack_add(base, (uint32_t) grandpa_topSUB, mk_pubtop.offset);
+        stack_add(base, (uintptr_t) grandpa_topSUB, mk_pubtop.offset);
     }
     while (stack_ref < MQTTServerCore_stackIdx)
     {
@@ -1659,16 +1948,21 @@ static bool proc_sub_msg_rx_locked(void *usrCl, const MQTT_UTF8StrQOS_t *qosTopi
 static void leaf_un_sub(MQTTServerCore_TopicNode_t *leaf, void *usrCl)
 {
     uint8_t j = 0;
-    uint32_t map = MQTTClientMgmt_bmapGet(usrCl);
+    uint32_t index = MQTTClientMgmt_indexGet(usrCl);
+
+    if (MQTTCLIENTMGMT_NO_INDEX == index)
+    {
+        return;
+    }
 
     for (j = 0; j < 3; j++)
     {
         /* Client: clear QOS of existing sub, if any */
-        if (0 == (leaf->clMap[j] & map))
+        if (false == MQTTServerUtil_clMapTest(&leaf->clMap[j], index))
         {
             continue;
         }
-        leaf->clMap[j] &= ~map;
+        MQTTServerUtil_clMapClr(&leaf->clMap[j], index);
         MQTTClientMgmt_subCountDel(usrCl);
 
         try_node_delete(leaf);
@@ -1743,25 +2037,18 @@ static bool proc_un_sub_msg_locked(void *usrCl, const MQTT_UTF8String_t *topics,
 
 //*****************************************************************************
 //
-//! \brief
+//! \brief Add the subscribers of 'leaf' to 'clMap', by the QOS of delivery, and
+//! present the data to the plugins enrolled for the 'leaf'
 //
 //*****************************************************************************
-static void leaf_msg_send(  const MQTTServerCore_TopicNode_t *leaf, const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
-                            uint32_t dataLen, bool dup, MQTT_QOS qos, bool retain)
+static void leaf_msg_send(  const MQTTServerCore_TopicNode_t *leaf, MQTTServerUtil_ClMap_t *clMap, const MQTT_UTF8String_t *topic,
+                            const uint8_t *dataBuf, uint32_t dataLen, bool dup, MQTT_QOS qos, bool retain)
 {
     uint8_t  qid = 0;
-    uint8_t  fh_fgs = 0;
-    uint32_t map;
 
     for (qid = 0; qid < 3; qid++)
     {
-        map = leaf->clMap[qid];
-        fh_fgs = MQTT_MAKE_FH_FLAGS(dup, MQTT_MIN(qid, QOS_VALUE(qos)), retain);
-
-        if (map)
-        {
-            pub_msg_send(topic, dataBuf, dataLen, fh_fgs, map);
-        }
+        MQTTServerUtil_clMapOr(&clMap[MQTT_MIN(qid, QOS_VALUE(qos))], &leaf->clMap[qid]);
     }
 
     if (enrolls_plugin(leaf))
@@ -1883,21 +2170,78 @@ static void proc_sub_tree_topPUB(   const char *topPUB, const MQTT_UTF8String_t
     MQTTServerCore_TopicNode_t *leaf = NULL;
     uint32_t stack_ref = MQTTServerCore_stackIdx;
     MQTTServerCore_NodeStack_t *stack;
+    MQTTServerCore_PubCache_t *entry;
+    MQTTServerCore_PubCache_t fill;
+    MQTTServerUtil_ClMap_t clMap[3]; /* Subscribers, by QOS of delivery */
+    const char *topstr;
+    const char *next_subtop;
+    uint32_t stack_full = MQTTServerCore_routeStats.stackFull;
+    uint32_t n_leaves = 0;
+    uint32_t toplen;
+    uint8_t i;
 
-    if (NULL != MQTTServerCore_rootNode)
+    MQTTServerCore_routeStats.pubs++;
+
+    MQTTServerUtil_clMapZero(&clMap[0]);
+    MQTTServerUtil_clMapZero(&clMap[1]);
+    MQTTServerUtil_clMapZero(&clMap[2]);
+
+    /* Hot topics: re-use the leaves found by an earlier search */
+    fill.hash = pub_topic_hash(topPUB, &toplen);
+    entry = pub_cache_find(topPUB, toplen, fill.hash);
+    if (NULL != entry)
     {
-        stack_add(MQTTServerCore_rootNode, (uint32_t) topPUB, 0 /* Not used */);
+        MQTTServerCore_routeStats.cacheHits++;
+        for (i = 0; i < entry->nLeaves; i++)
+        {
+            leaf_msg_send(entry->leaves[i], clMap, topic, dataBuf, dataLen, false, qos, retain);
+        }
+        pub_fanout_send(topic, dataBuf, dataLen, false, retain, clMap);
+        return;
     }
-    while (stack_ref < MQTTServerCore_stackIdx)
-    {
-        stack = stack_pop();
 
-        /* Find leaf node of SUB that matches the PUB topic */
-        leaf = SUB_leaf_search((char *)stack->val1, stack->node);
+    fill.gen = MQTTServerCore_treeGen;
+
+    leaf = SUB_level_search(NULL, topPUB);
+    while (true)
+    {
         if (leaf)
         {
-            leaf_msg_send(leaf, topic, dataBuf, dataLen, false, qos, retain);
+            leaf_msg_send(leaf, clMap, topic, dataBuf, dataLen, false, qos, retain);
+
+            if (n_leaves < PUB_CACHE_LEAVES)
+            {
+                fill.leaves[n_leaves] = leaf;
+            }
+            n_leaves++;
+        }
+
+        if (stack_ref == MQTTServerCore_stackIdx)
+        {
+            break;
         }
+        stack = stack_pop();
+        MQTTServerCore_routeStats.nodeVisits++;
+
+        /* The node matches the first sub-topic of 'topstr'; it is the leaf
+           of SUB, if PUB topic ends here, otherwise search its children */
+        topstr = (const char *)stack->val1;
+        next_subtop = next_subtop_get(topstr);
+
+        leaf = (NULL == next_subtop) ? stack->node : SUB_level_search(stack->node, next_subtop);
+    }
+
+    pub_fanout_send(topic, dataBuf, dataLen, false, retain, clMap);
+
+    /* Remember the leaves, unless the tree changed or some were not logged */
+    if ((0 == MQTTServerCore_routeStats.stackFull - stack_full) &&
+        (fill.gen == MQTTServerCore_treeGen) && (n_leaves <= PUB_CACHE_LEAVES) &&
+        (toplen <= PUB_CACHE_TOPLEN))
+    {
+        fill.nLeaves = n_leaves;
+        fill.toplen = toplen;
+        memcpy(fill.topic, topPUB, toplen);
+        MQTTServerCore_pubCache[fill.hash % PUB_CACHE_SIZE] = fill;
     }
 }
 
@@ -1908,7 +2252,7 @@ static void proc_sub_tree_topPUB(   const char *topPUB, const MQTT_UTF8String_t
 //
 //*****************************************************************************
 static bool _proc_pub_msg_rx(void *usrCl, const MQTT_UTF8String_t *topic, const uint8_t *dataBuf,
-                            uint32_t dataLen, uint8_t msgID, MQTT_QOS qos, bool retain)
+                            uint32_t dataLen, uint16_t msgID, MQTT_QOS qos, bool retain)
 {
     int32_t err = -1;
 
@@ -2136,17 +2480,17 @@ static uint16_t proc_connect_rx_locked(void *ctxCl, uint8_t connFlags, MQTT_UTF8
 static void session_hier_delete(MQTTServerCore_TopicNode_t *node, void *usrCl)
 {
     MQTTServerCore_TopicNode_t *prev = NULL;
-    uint32_t clMap = MQTTClientMgmt_bmapGet(usrCl);
+    uint32_t index = MQTTClientMgmt_indexGet(usrCl);
     int32_t i;
 
     while (node)
     {
         i = 0;
-        for (i = 0; i < 3; i++)
+        for (i = 0; (MQTTCLIENTMGMT_NO_INDEX != index) && (i < 3); i++)
         {
-            if (node->clMap[i] & clMap)
+            if (MQTTServerUtil_clMapTest(&node->clMap[i], index))
             {
-                node->clMap[i] &= ~clMap;
+                MQTTServerUtil_clMapClr(&node->clMap[i], index);
                 MQTTClientMgmt_subCountDel(usrCl);
                 /* Client/Topic/QID 1-to-1 map */
                 break;
@@ -2499,6 +2843,9 @@ int32_t MQTTServerCore_init(const MQTTServerPkts_LibCfg_t *libCfg, const MQTTSer
     MQTTServerCore_stackIdx = 0;
     MQTTServerCore_NodesInUse = 0;
     MQTTServerCore_rootNode = NULL;
+    memset(MQTTServerCore_nodeHash, 0, sizeof(MQTTServerCore_nodeHash));
+    memset(MQTTServerCore_pubCache, 0, sizeof(MQTTServerCore_pubCache));
+    memset(&MQTTServerCore_routeStats, 0, sizeof(MQTTServerCore_routeStats));
 
     MQTTServerUtil_setParams(*(libCfg->mutex), libCfg->mutexLockin, libCfg->mutexUnlock);
 
@@ -2512,6 +2859,18 @@ int32_t MQTTServerCore_init(const MQTTServerPkts_LibCfg_t *libCfg, const MQTTSer
 }
 
 
+//*****************************************************************************
+//
+//! \brief Copy the topic routing counters, under the server lock
+//
+//*****************************************************************************
+void MQTTServerCore_routeStatsGet(MQTTServerCore_RouteStats_t *stats)
+{
+    MUTEX_LOCKIN();
+    *stats = MQTTServerCore_routeStats;
+    MUTEX_UNLOCK();
+}
+
 //*****************************************************************************
 //
 //! \brief Clean and free all the allocated memory for the topic nodes
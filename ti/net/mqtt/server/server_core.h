@@ -66,6 +66,14 @@
    - <b> CFG_SR_MAX_NUM_CLIENT: </b> the maximum number of clients to be managed.
    Note this is different from the maximum number of 'contexts'. A large number
    of clients can be managed using fewer number of 'contexts' (connections).
+   Each topic node and each held PUBLISH message carries one bit per client;
+   the limit is 4096 clients.
+   \n\n
+   - <b> CFG_SR_NODE_HASH_SIZE: </b> the number of buckets, a power of 2, in the
+   hashed index used to find the child nodes of a topic node.
+   \n\n
+   - <b> CFG_SR_PUB_CACHE_SIZE: </b> the number of published topics whose
+   matching subscriptions are remembered until the topic tree changes.
    \n\n
 
    @note Any future extensions & development must follow the following guidelines.
@@ -284,6 +292,25 @@ int32_t MQTTServerCore_init(const MQTTServerPkts_LibCfg_t *libCfg,
 
 void MQTTServerCore_topicNodeExit(void);
 
+/** Counters of the routing of PUBLISH topics to the subscribers */
+typedef struct _MQTTServerCore_RouteStats_t_
+{
+    uint32_t pubs;       /**< PUBLISH topics routed                          */
+    uint32_t cacheHits;  /**< Topics routed with the leaves of an earlier search */
+    uint32_t nodeVisits; /**< Matching nodes searched for their children     */
+    uint32_t hashProbes; /**< Nodes compared in the hashed child index       */
+    uint32_t stackFull;  /**< Matching nodes skipped, search stack was full   */
+
+}MQTTServerCore_RouteStats_t;
+
+/** Read the topic routing counters.
+    Dividing hashProbes by the number of routed topics, that were not served
+    from the cache, gives the lookup cost per topic.
+
+    @param[out] stats place-holder for a copy of the counters
+*/
+void MQTTServerCore_routeStatsGet(MQTTServerCore_RouteStats_t *stats);
+
 /** @} */ /* End of server_daemon */
 #ifdef __cplusplus
 }
@@ -288,18 +288,18 @@ int32_t mqtt_connack_send(void *ctxCl, uint8_t *vhBuf)
 
 static int32_t _mqtt_server_pub_dispatch(void *ctxCl, MQTT_Packet_t *mqp, bool dup)
 {
-    int32_t rv = 0;
     uint8_t *buf = MQTT_PACKET_FHEADER_BUF(mqp);
 
-    if (dup)
+    /* The buffer may be shared by MQP(s) of other QOS or MSG ID, so the
+       header of this MQP is written afresh for each send */
+    *buf = mqp->fhByte1 | MQTT_FH_BYTE1_DUP_VAL(dup);
+    if (MQTT_QOS0 != MQTT_FH_BYTE1_QOS(mqp->fhByte1))
     {
-        *buf |= MQTT_FH_BYTE1_DUP_VAL(true);
+        /* MSG ID is the last field of the variable header */
+        MQTT_bufWrNbo2B(MQTT_PACKET_VHEADER_BUF(mqp) + mqp->vhLen - 2, mqp->msgID);
     }
-    rv = cl_ctx_send((MQTT_ClientCtx_t *)ctxCl, buf, MQTT_PACKET_CONTENT_LEN(mqp));
-
-    *buf &= ~MQTT_FH_BYTE1_DUP_VAL(true);
 
-    return rv;
+    return cl_ctx_send((MQTT_ClientCtx_t *)ctxCl, buf, MQTT_PACKET_CONTENT_LEN(mqp));
 }
 
 int32_t MQTTServerPkts_dispatchPub(void *ctxCl, MQTT_Packet_t *mqp, bool dup)
@@ -42,8 +42,24 @@
 #define MQP_SERVER_TX_LEN        CFG_SR_MAX_MQP_TX_LEN
 #endif
 
+/*
+ Placed by server_mqp_alloc() between the MQP and its buffer. A 'view' shares
+ the buffer of its 'stem' MQP; the buffer is freed with the last of them.
+ */
+typedef struct _MQTTServerUtil_MqpTrailer_t_
+{
+    MQTTServerUtil_ClMap_t clMap;   /* Clients yet to receive / ACK the MQP */
+    MQTT_Packet_t         *stem;    /* MQP owning the buffer, NULL for self */
+    uint32_t               nUsers;  /* Owner and views of the buffer        */
+
+}MQTTServerUtil_MqpTrailer_t;
+
+#define MQP_TRAILER(mqp)  ((MQTTServerUtil_MqpTrailer_t *)((mqp) + 1))
+
 static uint16_t MQTTServerUtil_msgID = 0xFFFF;
 
+static MQTTServerUtil_MqpStats_t MQTTServerUtil_mqpStats;
+
 int32_t (*MQTTServerUtil_dbgPrn)(const char *fmt, ...) = NULL;
 bool MQTTServerUtil_prnAux = false;
 
@@ -61,9 +77,25 @@ static inline uint16_t assign_new_msg_id()
     return MQTTServerUtil_msgID += 2;
 }
 
+static void stem_put(MQTT_Packet_t *stem)
+{
+    if (0 == --MQP_TRAILER(stem)->nUsers)
+    {
+        free((void *)stem);
+    }
+}
+
 static void my_pkt_free(MQTT_Packet_t *mqp)
 {
+    stem_put(mqp);
+}
+
+static void view_pkt_free(MQTT_Packet_t *mqp)
+{
+    MQTT_Packet_t *stem = MQP_TRAILER(mqp)->stem;
+
     free((void *)mqp);
+    stem_put(stem);
 }
 
 //*****************************************************************************
@@ -85,18 +117,25 @@ static MQTT_Packet_t *server_mqp_alloc(uint8_t msgType, uint32_t buf_sz, uint8_t
         return NULL;
     }
 
-    /* The size of the message is the size of the MQTT packet + payload (data) */
-    mqp = malloc(mqp_sz + buf_sz);
+    /* The size of the message is the size of the MQTT packet + trailer +
+       payload (data) */
+    mqp = malloc(mqp_sz + sizeof(MQTTServerUtil_MqpTrailer_t) + buf_sz);
     if (NULL != mqp)
     {
         MQTT_packetInit(mqp, offset);
 
         mqp->msgType = msgType;
         mqp->maxlen  = buf_sz;
-        mqp->buffer  = (uint8_t *)mqp + mqp_sz;
+        mqp->buffer  = (uint8_t *)mqp + mqp_sz + sizeof(MQTTServerUtil_MqpTrailer_t);
+
+        MQTTServerUtil_clMapZero(&MQP_TRAILER(mqp)->clMap);
+        MQP_TRAILER(mqp)->stem   = NULL;
+        MQP_TRAILER(mqp)->nUsers = 1;
 
         mqp->free = my_pkt_free;
 
+        MQTTServerUtil_mqpStats.allocs++;
+        MQTTServerUtil_mqpStats.allocBytes += buf_sz;
     }
     /* else - fatal, failed to allocate Server MQP */
 
@@ -128,23 +167,40 @@ MQTT_Packet_t *MQTTServerUtil_mqpAlloc(uint8_t msgType, uint32_t buf_sz)
     return server_mqp_alloc(msgType, buf_sz, MQTT_MAX_FH_LEN);
 }
 
-MQTT_Packet_t *MQTTServerUtil_mqpCopy(const MQTT_Packet_t *mqp)
+MQTT_Packet_t *MQTTServerUtil_mqpView(MQTT_Packet_t *mqp)
 {
-    MQTT_Packet_t *cpy = server_mqp_alloc(mqp->msgType, mqp->maxlen, 0);
-    uint8_t *buffer;
+    MQTT_Packet_t *stem = MQP_TRAILER(mqp)->stem ? MQP_TRAILER(mqp)->stem : mqp;
+    MQTT_Packet_t *view = malloc(sizeof(MQTT_Packet_t) + sizeof(MQTTServerUtil_MqpTrailer_t));
 
-    if (NULL != cpy)
+    if (NULL != view)
     {
-        buffer = cpy->buffer;
+        /* Header of 'mqp', incl. its buffer, and an empty map of clients */
+        MQTT_bufWrNbytes((uint8_t *)view, (uint8_t *)mqp, sizeof(MQTT_Packet_t));
+
+        view->free  = view_pkt_free;
+        view->nRefs = 1;
+        view->next  = NULL;
+
+        MQTTServerUtil_clMapZero(&MQP_TRAILER(view)->clMap);
+        MQP_TRAILER(view)->stem   = stem;
+        MQP_TRAILER(view)->nUsers = 0;
 
-        /* Copy to overwrite everything in 'cpy' from source 'mqp' */
-        MQTT_bufWrNbytes((uint8_t *)cpy, (uint8_t *)mqp, sizeof(MQTT_Packet_t));
+        MQP_TRAILER(stem)->nUsers++;
 
-        cpy->buffer = buffer; /* Restore buffer and copy */
-        MQTT_bufWrNbytes(cpy->buffer, mqp->buffer, mqp->maxlen);
+        MQTTServerUtil_mqpStats.views++;
     }
 
-    return cpy;
+    return view;
+}
+
+MQTTServerUtil_ClMap_t *MQTTServerUtil_mqpClMap(MQTT_Packet_t *mqp)
+{
+    return (&MQP_TRAILER(mqp)->clMap);
+}
+
+void MQTTServerUtil_mqpStatsGet(MQTTServerUtil_MqpStats_t *stats)
+{
+    *stats = MQTTServerUtil_mqpStats;
 }
 
 void MQTTServerUtil_mutexLock(void)
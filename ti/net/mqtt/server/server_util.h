@@ -43,6 +43,15 @@ extern "C" {
 
 #define MQTT_SERVER_VERSTR "1.0.4"
 
+#ifndef CFG_SR_MAX_NUM_CLIENT
+#define MQTTSERVERUTIL_MAX_CLIENTS      16
+#else
+#define MQTTSERVERUTIL_MAX_CLIENTS      CFG_SR_MAX_NUM_CLIENT
+#endif
+
+/* Number of 32bit words needed to hold one bit per client */
+#define MQTTSERVERUTIL_CLMAP_WORDS      ((MQTTSERVERUTIL_MAX_CLIENTS + 31) / 32)
+
 #define MUTEX_LOCKIN()    MQTTServerUtil_mutexLock()
 #define MUTEX_UNLOCK()    MQTTServerUtil_mutexUnlock()
 
@@ -52,6 +61,82 @@ extern "C" {
         if(MQTTServerUtil_prnAux && MQTTServerUtil_dbgPrn)                \
                 MQTTServerUtil_dbgPrn(FMT, ##__VA_ARGS__)
 
+/* Set of clients, bit 'n' refers to the client with index 'n' */
+typedef struct _MQTTServerUtil_ClMap_t_
+{
+    uint32_t word[MQTTSERVERUTIL_CLMAP_WORDS];
+
+}MQTTServerUtil_ClMap_t;
+
+static inline void MQTTServerUtil_clMapZero(MQTTServerUtil_ClMap_t *map)
+{
+    uint32_t w;
+
+    for (w = 0; w < MQTTSERVERUTIL_CLMAP_WORDS; w++)
+    {
+        map->word[w] = 0;
+    }
+}
+
+static inline void MQTTServerUtil_clMapSet(MQTTServerUtil_ClMap_t *map, uint32_t index)
+{
+    map->word[index >> 5] |= ((uint32_t)1 << (index & 31));
+}
+
+static inline void MQTTServerUtil_clMapClr(MQTTServerUtil_ClMap_t *map, uint32_t index)
+{
+    map->word[index >> 5] &= ~((uint32_t)1 << (index & 31));
+}
+
+static inline bool MQTTServerUtil_clMapTest(const MQTTServerUtil_ClMap_t *map, uint32_t index)
+{
+    return ((map->word[index >> 5] & ((uint32_t)1 << (index & 31))) ? true : false);
+}
+
+static inline void MQTTServerUtil_clMapOr(MQTTServerUtil_ClMap_t *map, const MQTTServerUtil_ClMap_t *src)
+{
+    uint32_t w;
+
+    for (w = 0; w < MQTTSERVERUTIL_CLMAP_WORDS; w++)
+    {
+        map->word[w] |= src->word[w];
+    }
+}
+
+static inline void MQTTServerUtil_clMapAndNot(MQTTServerUtil_ClMap_t *map, const MQTTServerUtil_ClMap_t *src)
+{
+    uint32_t w;
+
+    for (w = 0; w < MQTTSERVERUTIL_CLMAP_WORDS; w++)
+    {
+        map->word[w] &= ~src->word[w];
+    }
+}
+
+static inline bool MQTTServerUtil_clMapIsEmpty(const MQTTServerUtil_ClMap_t *map)
+{
+    uint32_t w;
+
+    for (w = 0; w < MQTTSERVERUTIL_CLMAP_WORDS; w++)
+    {
+        if (map->word[w])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Counters of the server MQP(s) */
+typedef struct _MQTTServerUtil_MqpStats_t_
+{
+    uint32_t allocs;      /* MQP(s) allocated with a buffer            */
+    uint32_t allocBytes;  /* size of the buffers of those MQP(s)       */
+    uint32_t views;       /* MQP(s) sharing the buffer of another MQP  */
+
+}MQTTServerUtil_MqpStats_t;
+
 extern int32_t (*MQTTServerUtil_dbgPrn)(const char *fmt, ...);
 extern bool  MQTTServerUtil_prnAux;
 
@@ -64,7 +149,18 @@ void MQTTServerUtil_resetMsgID(void);
 
 MQTT_Packet_t *MQTTServerUtil_mqpAlloc(uint8_t msgType, uint32_t buf_sz);
 
-MQTT_Packet_t *MQTTServerUtil_mqpCopy(const MQTT_Packet_t *mqp);
+/* Create an MQP that shares the buffer, which must not be changed anymore,
+   of 'mqp'. The header of 'mqp' is copied and can then be altered, e.g. the
+   QOS in 'fhByte1' and the 'msgID' which are written to the buffer on send.
+*/
+MQTT_Packet_t *MQTTServerUtil_mqpView(MQTT_Packet_t *mqp);
+
+/* Clients that still have to receive 'mqp'; valid for server MQP(s) only.
+   A new MQP, including a view, starts with an empty map.
+*/
+MQTTServerUtil_ClMap_t *MQTTServerUtil_mqpClMap(MQTT_Packet_t *mqp);
+
+void MQTTServerUtil_mqpStatsGet(MQTTServerUtil_MqpStats_t *stats);
 
 void MQTTServerUtil_setParams(pthread_mutex_t *mutex,
                      void (*mutexLockin)(pthread_mutex_t *),
@@ -142,6 +142,30 @@ typedef enum
     \sa SlNetIf_queryIf()
  */
 #define SLNETIF_QUERY_IF_ALLOW_PARTIAL_MATCH_BIT (1 << 2)
+/*!
+    Steer away from degraded interfaces and balance the sockets over the
+    healthy interfaces of the highest matching priority.
+
+    \sa SlNetIf_queryIf()
+    \sa SlNetIf_getStats()
+ */
+#define SLNETIF_QUERY_IF_HEALTH_BIT              (1 << 3)
+
+/* Consecutive failed socket calls after which an interface is degraded      */
+#ifndef SLNETIF_DEGRADED_ERRORS
+#define SLNETIF_DEGRADED_ERRORS                  (3)
+#endif
+
+/* A degraded interface passed over by that many health queries gets the
+   next socket, to probe whether it recovered                                */
+#ifndef SLNETIF_DEGRADED_PROBE_INTERVAL
+#define SLNETIF_DEGRADED_PROBE_INTERVAL          (8)
+#endif
+
+/* Window in milliseconds over which the send and receive rates are taken    */
+#ifndef SLNETIF_RATE_WINDOW_MS
+#define SLNETIF_RATE_WINDOW_MS                   (1000)
+#endif
 
 /*****************************************************************************/
 /* Structure/Enum declarations                                               */
@@ -203,6 +227,34 @@ typedef struct SlNetIf_t
     void             *ifContext;
 } SlNetIf_t;
 
+/*!
+    \brief Socket events of an interface fed to SlNetIf_updateStats
+*/
+typedef enum
+{
+    SLNETIF_STATS_SOCK_OPEN  = 0,
+    SLNETIF_STATS_SOCK_CLOSE = 1,
+    SLNETIF_STATS_CONNECT    = 2,
+    SLNETIF_STATS_SEND       = 3,
+    SLNETIF_STATS_RECV       = 4
+} SlNetIfStatsEvent_e;
+
+/*!
+    \brief The health statistics of an interface, as seen by its sockets
+*/
+typedef struct SlNetIf_Stats_t
+{
+    uint32_t txBytes;           /*!< Bytes sent                                                        */
+    uint32_t rxBytes;           /*!< Bytes received                                                    */
+    uint32_t errors;            /*!< Failed socket calls, would block and in progress are not failures */
+    uint32_t disconnects;       /*!< Connected to disconnected transitions of the connection status    */
+    uint32_t connectTime;       /*!< Smoothed connect time in milliseconds, zero before the first one  */
+    uint32_t txRate;            /*!< Smoothed send rate in bytes per second, over #SLNETIF_RATE_WINDOW_MS windows */
+    uint32_t rxRate;            /*!< Smoothed receive rate in bytes per second, over the same windows  */
+    uint16_t consecutiveErrors; /*!< Failed socket calls since the last successful one                 */
+    uint16_t openSockets;       /*!< Sockets currently open on the interface                           */
+} SlNetIf_Stats_t;
+
 /*****************************************************************************/
 /* Function prototypes                                                       */
 /*****************************************************************************/
@@ -292,6 +344,21 @@ SlNetIf_t * SlNetIf_getIfByID(uint16_t ifID);
                     - #SLNETIF_QUERY_IF_STATE_BIT
                     - #SLNETIF_QUERY_IF_CONNECTION_STATUS_BIT
                     - #SLNETIF_QUERY_IF_ALLOW_PARTIAL_MATCH_BIT
+                    - #SLNETIF_QUERY_IF_HEALTH_BIT
+
+    \remarks    With #SLNETIF_QUERY_IF_HEALTH_BIT the interfaces that
+                answer the other criteria are ranked by health rather than
+                by priority alone. An interface is degraded after
+                #SLNETIF_DEGRADED_ERRORS consecutive failed socket calls, or
+                when its connection status was seen dropping, until a socket
+                call on it succeeds again. Among the non degraded interfaces
+                of the highest priority, the one a new connection is expected
+                to wait on the least is returned: the open sockets it would
+                share the interface with times the connect time, ties going
+                to the fewer open sockets. A
+                degraded interface is returned when no other one answers,
+                and every #SLNETIF_DEGRADED_PROBE_INTERVAL queries it was
+                passed over by, to probe it.
 
     \return     A pointer to the configuration of a found
                 interface on success, or NULL on failure
@@ -493,6 +560,39 @@ int32_t SlNetIf_getState(uint16_t ifID);
 int32_t SlNetIf_getConnectionStatus(uint16_t ifID);
 
 
+/*!
+    \brief Get the health statistics of an interface
+
+    \param[in]  ifID      Interface ID
+    \param[out] stats     Statistics of the interface since it was added
+
+    \return               Zero on success, or negative error code on failure
+
+    \remark               Statistics are updated by SlNetSock without
+                          locking, counts may be lost to concurrent updates
+
+    \sa     SlNetIf_queryIf()
+*/
+int32_t SlNetIf_getStats(uint16_t ifID, SlNetIf_Stats_t *stats);
+
+
+/*!
+    \brief Record the result of a socket call of an interface
+
+    Called by SlNetSock for the sockets it dispatches to the interface.
+
+    \param[in] netIf     Interface the socket belongs to
+    \param[in] event     Socket call, from ::SlNetIfStatsEvent_e
+    \param[in] retVal    Return value of the call, a byte count for
+                         #SLNETIF_STATS_SEND and #SLNETIF_STATS_RECV
+    \param[in] elapsed   Duration of the call in milliseconds, used for
+                         #SLNETIF_STATS_CONNECT
+
+    \sa     SlNetIf_getStats()
+*/
+void SlNetIf_updateStats(SlNetIf_t *netIf, SlNetIfStatsEvent_e event, int32_t retVal, uint32_t elapsed);
+
+
 /*!
     \brief Get IP Address of specific interface
 
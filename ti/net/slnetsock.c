@@ -47,6 +47,7 @@
 
 /* POSIX Header files */
 #include <semaphore.h>
+#include <time.h>
 
 /*****************************************************************************/
 /* Macro declarations                                                        */
@@ -66,8 +67,30 @@
 #define SLNETSOCK_LOCK()   sem_wait(&VirtualSocketSem)
 #define SLNETSOCK_UNLOCK() sem_post(&VirtualSocketSem)
 
-#define ENABLE_DEFAULT_QUERY_FLAGS()    (SLNETSOCK_CREATE_IF_STATE_ENABLE | SLNETSOCK_CREATE_IF_STATUS_CONNECTED | SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH)
-#define GET_QUERY_FLAGS(flags)          (flags & (SLNETSOCK_CREATE_IF_STATE_ENABLE | SLNETSOCK_CREATE_IF_STATUS_CONNECTED | SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH))
+/* Memory barrier ordering the seq counter of a virtual socket against its
+   fields. Without one the lookups take the lock, as they do when built with
+   SLNETSOCK_LOCKFREE_LOOKUP set to 0                                        */
+#if defined(__GNUC__)
+    #define SLNETSOCK_MEMORY_BARRIER()  __sync_synchronize()
+#elif defined(__IAR_SYSTEMS_ICC__)
+    #include <intrinsics.h>
+    #define SLNETSOCK_MEMORY_BARRIER()  __DMB()
+#endif
+
+#ifndef SLNETSOCK_LOCKFREE_LOOKUP
+    #ifdef SLNETSOCK_MEMORY_BARRIER
+        #define SLNETSOCK_LOCKFREE_LOOKUP   1
+    #else
+        #define SLNETSOCK_LOCKFREE_LOOKUP   0
+    #endif
+#endif
+
+#ifndef SLNETSOCK_MEMORY_BARRIER
+    #define SLNETSOCK_MEMORY_BARRIER()
+#endif
+
+#define ENABLE_DEFAULT_QUERY_FLAGS()    (SLNETSOCK_CREATE_IF_STATE_ENABLE | SLNETSOCK_CREATE_IF_STATUS_CONNECTED | SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH | SLNETSOCK_CREATE_IF_HEALTH)
+#define GET_QUERY_FLAGS(flags)          (flags & (SLNETSOCK_CREATE_IF_STATE_ENABLE | SLNETSOCK_CREATE_IF_STATUS_CONNECTED | SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH | SLNETSOCK_CREATE_IF_HEALTH))
 
 /* Macro which merge the 8bit security flags to the upper bits of the 32 bit
    input flags                                                               */
@@ -79,15 +102,40 @@
 /*****************************************************************************/
 
 
-/* Socket Endpoint */
+/* Socket Endpoint, seq is odd while the fields are written and changes on
+   every write, so a reader without the lock can tell its copy is torn.
+   generation changes each time the endpoint is allocated, so the holder of
+   an sd can tell it was closed and the endpoint reused since              */
 typedef struct SlNetSock_VirtualSocket_t
 {
+    uint32_t   seq;
+    uint16_t   generation;
+    bool       inUse;
     int16_t    realSd;
     uint8_t    sdFlags;
     void      *sdContext;
     SlNetIf_t *netIf;
 } SlNetSock_VirtualSocket_t;
 
+/* Poll set, indexed by virtual sd. The interface sd sets of the registered
+   sockets are kept up to date by SlNetSock_pollCtl, a wait copies them     */
+typedef struct SlNetSock_PollSet_t
+{
+    bool               inUse;
+    bool               waiting;         /* The owner blocks on readySem     */
+    SlNetIf_t         *netIf;           /* Interface of the sockets         */
+    int16_t            numSds;          /* Registered sockets               */
+    int16_t            numReady;        /* Sockets with pushed readiness    */
+    int16_t            ifNsds;
+    SlNetSock_SdSet_t  ifReadsds;
+    SlNetSock_SdSet_t  ifWritesds;
+    SlNetSock_SdSet_t  ifExceptsds;
+    uint8_t            interest[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+    uint8_t            ready[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+    int16_t            realSd[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+    sem_t              readySem;        /* Posted once per blocking wait    */
+} SlNetSock_PollSet_t;
+
 /* Structure which holds the realSd and the virtualSd indexes */
 typedef struct SlNetSock_RealToVirtualIndexes_t
 {
@@ -100,92 +148,201 @@ typedef struct SlNetSock_RealToVirtualIndexes_t
 /* Global declarations                                                       */
 /*****************************************************************************/
 
-static SlNetSock_VirtualSocket_t *VirtualSockets[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+static SlNetSock_VirtualSocket_t VirtualSockets[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
 static uint8_t SlNetSock_Initialized = false;
 
-/* semaphore to protect VirtualSockets[] */
+/* Stack of the free VirtualSockets indexes, the top is popped first         */
+static int16_t  VirtualSocketsFree[SLNETSOCK_MAX_CONCURRENT_SOCKETS];
+static uint16_t VirtualSocketsFreeTop;
+
+/* semaphore to protect the writers of VirtualSockets[] and the free stack,
+   and the poll sets                                                       */
 static sem_t VirtualSocketSem;
 
+static SlNetSock_PollSet_t PollSets[SLNETSOCK_MAX_POLL_SETS];
+
 
 /*****************************************************************************/
 /* Function prototypes                                                       */
 /*****************************************************************************/
 
+static int32_t SlNetSock_copyVirtualSocket(int16_t virtualSdIndex, SlNetSock_VirtualSocket_t *socketCopy);
 static int32_t SlNetSock_getVirtualSdConf(int16_t virtualSdIndex, int16_t *realSd, uint8_t *sdFlags, void **sdContext, SlNetIf_t **netIf);
-static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex, SlNetSock_VirtualSocket_t **newSocketNode);
+static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex);
+static void    SlNetSock_setVirtualSocket(int16_t virtualSdIndex, int16_t realSd, uint8_t sdFlags, void *sdContext, SlNetIf_t *netIf);
 static int32_t SlNetSock_freeVirtualSocket(int16_t virtualSdIndex);
+static uint32_t SlNetSock_getTimeMs(void);
+static void    SlNetSock_pollRebuild(SlNetSock_PollSet_t *pollSet);
+static void    SlNetSock_pollForget(int16_t virtualSdIndex);
+static void    SlNetSock_pollPush(int16_t virtualSdIndex, uint8_t events);
+static void    SlNetSock_pollBlock(SlNetSock_PollSet_t *pollSet, SlNetSock_Timeval_t *timeout);
 
 //*****************************************************************************
 //
-// SlNetSock_getVirtualSdConf - This function search and returns the
-//                              configuration of virtual socket.
+// SlNetSock_getTimeMs - Monotonic time in milliseconds, for the interface
+//                       statistics
 //
 //*****************************************************************************
-static int32_t SlNetSock_getVirtualSdConf(int16_t virtualSdIndex, int16_t *realSd, uint8_t *sdFlags, void **sdContext, SlNetIf_t **netIf)
+static uint32_t SlNetSock_getTimeMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint32_t)ts.tv_sec * 1000U) + (uint32_t)(ts.tv_nsec / 1000000);
+}
+
+//*****************************************************************************
+//
+// SlNetSock_writeBegin/End - Bracket a write of a virtual socket, called
+//                            with the lock taken
+//
+//*****************************************************************************
+static void SlNetSock_writeBegin(SlNetSock_VirtualSocket_t *socketNode)
 {
-    int32_t retVal = SLNETERR_RET_CODE_OK;
+    ((volatile SlNetSock_VirtualSocket_t *)socketNode)->seq++;
+    SLNETSOCK_MEMORY_BARRIER();
+}
 
+static void SlNetSock_writeEnd(SlNetSock_VirtualSocket_t *socketNode)
+{
+    SLNETSOCK_MEMORY_BARRIER();
+    ((volatile SlNetSock_VirtualSocket_t *)socketNode)->seq++;
+}
+
+#if SLNETSOCK_LOCKFREE_LOOKUP
+//*****************************************************************************
+//
+// SlNetSock_readVirtualSocket - Copy a virtual socket without the lock,
+//                               returns false if a writer got in the way
+//
+//*****************************************************************************
+static bool SlNetSock_readVirtualSocket(int16_t virtualSdIndex, SlNetSock_VirtualSocket_t *socketCopy)
+{
+    const volatile SlNetSock_VirtualSocket_t *socketNode = &VirtualSockets[virtualSdIndex];
+    uint32_t seq = socketNode->seq;
+
+    /* Odd seq, the socket is being written                                  */
+    if (seq & 1)
+    {
+        return false;
+    }
+    SLNETSOCK_MEMORY_BARRIER();
+
+    socketCopy->generation = socketNode->generation;
+    socketCopy->inUse     = socketNode->inUse;
+    socketCopy->realSd    = socketNode->realSd;
+    socketCopy->sdFlags   = socketNode->sdFlags;
+    socketCopy->sdContext = socketNode->sdContext;
+    socketCopy->netIf     = socketNode->netIf;
+
+    SLNETSOCK_MEMORY_BARRIER();
+
+    /* The copy holds if no write started or ended meanwhile                 */
+    return (seq == socketNode->seq);
+}
+#endif
+
+//*****************************************************************************
+//
+// SlNetSock_copyVirtualSocket - Copy an allocated virtual socket, a
+//                               consistent copy of one point in time
+//
+//*****************************************************************************
+static int32_t SlNetSock_copyVirtualSocket(int16_t virtualSdIndex, SlNetSock_VirtualSocket_t *socketCopy)
+{
     if (false == SlNetSock_Initialized)
     {
         return SLNETERR_RET_CODE_MUTEX_CREATION_FAILED;
     }
 
-    SLNETSOCK_LOCK();
+    /* Check if the input is valid                                           */
+    if ( (virtualSdIndex >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) || (virtualSdIndex < 0) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
 
-    /* Check if the input is valid and if real socket descriptor exists      */
-    if ( (virtualSdIndex >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) || (virtualSdIndex < 0) || (NULL == netIf) )
+#if SLNETSOCK_LOCKFREE_LOOKUP
+    /* Copy the socket without the lock, when it is being written meanwhile
+       wait for the writer on the lock rather than spin on seq               */
+    if (false == SlNetSock_readVirtualSocket(virtualSdIndex, socketCopy))
+#endif
     {
-        retVal = SLNETERR_RET_CODE_INVALID_INPUT;
+        SLNETSOCK_LOCK();
+        *socketCopy = VirtualSockets[virtualSdIndex];
+        SLNETSOCK_UNLOCK();
     }
-    else if (NULL == VirtualSockets[virtualSdIndex])
+
+    /* Check if real socket descriptor exists                                */
+    if (false == socketCopy->inUse)
     {
         /* Socket was not found, return error code                           */
-        retVal = SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
+        return SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
     }
-    else
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+//*****************************************************************************
+//
+// SlNetSock_getVirtualSdConf - This function search and returns the
+//                              configuration of virtual socket.
+//
+//*****************************************************************************
+static int32_t SlNetSock_getVirtualSdConf(int16_t virtualSdIndex, int16_t *realSd, uint8_t *sdFlags, void **sdContext, SlNetIf_t **netIf)
+{
+    SlNetSock_VirtualSocket_t socketCopy;
+    int32_t                   retVal;
+
+    if (NULL == netIf)
     {
-        /* Socket found, copy and return its content                         */
-        *netIf  = VirtualSockets[virtualSdIndex]->netIf;
-        *realSd = VirtualSockets[virtualSdIndex]->realSd;
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
 
-        /* If sdContext pointer supplied, copy into it the sdContext of the
-           socket                                                            */
-        if ( NULL != sdContext )
-        {
-            *sdContext = VirtualSockets[virtualSdIndex]->sdContext;
-        }
+    retVal = SlNetSock_copyVirtualSocket(virtualSdIndex, &socketCopy);
+    if (SLNETERR_RET_CODE_OK != retVal)
+    {
+        return retVal;
+    }
 
-        /* If sdFlags pointer supplied, copy into it the sdFlags of the
-           socket                                                            */
-        if ( NULL != sdFlags )
-        {
-            *sdFlags = VirtualSockets[virtualSdIndex]->sdFlags;
-        }
+    /* Socket found, return its content                                      */
+    *netIf  = socketCopy.netIf;
+    *realSd = socketCopy.realSd;
 
-        /* Check if the interface of the socket is declared                  */
-        if ( (NULL == (*netIf)) || (NULL == (*netIf)->ifConf) )
-        {
-            /* Interface was not found or config list is missing,
-               return error code                                             */
-            retVal = SLNETERR_RET_CODE_SOCKET_CREATION_IN_PROGRESS;
-        }
+    /* If sdContext pointer supplied, copy into it the sdContext of the
+       socket                                                                */
+    if ( NULL != sdContext )
+    {
+        *sdContext = socketCopy.sdContext;
     }
 
-    SLNETSOCK_UNLOCK();
+    /* If sdFlags pointer supplied, copy into it the sdFlags of the
+       socket                                                                */
+    if ( NULL != sdFlags )
+    {
+        *sdFlags = socketCopy.sdFlags;
+    }
 
-    return retVal;
+    /* Check if the interface of the socket is declared                      */
+    if ( (NULL == (*netIf)) || (NULL == (*netIf)->ifConf) )
+    {
+        /* Interface was not found or config list is missing,
+           return error code                                                 */
+        return SLNETERR_RET_CODE_SOCKET_CREATION_IN_PROGRESS;
+    }
+
+    return SLNETERR_RET_CODE_OK;
 }
 
 //*****************************************************************************
 //
-// SlNetSock_AllocVirtualSocket - Search for free space in the VirtualSockets
+// SlNetSock_AllocVirtualSocket - Pop a free index of the VirtualSockets
 //                                array and allocate a socket in this location
 //
 //*****************************************************************************
-static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex, SlNetSock_VirtualSocket_t **newSocketNode)
+static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex)
 {
-    uint16_t arrayIndex = 0;
-    int32_t  retVal     = SLNETERR_RET_CODE_NO_FREE_SPACE;
+    SlNetSock_VirtualSocket_t *socketNode;
+    int32_t                    retVal = SLNETERR_RET_CODE_NO_FREE_SPACE;
 
     if (false == SlNetSock_Initialized)
     {
@@ -194,38 +351,23 @@ static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex, SlNetSock_V
 
     SLNETSOCK_LOCK();
 
-    /* Search for free space in the VirtualSockets array                     */
-    while ( arrayIndex < SLNETSOCK_MAX_CONCURRENT_SOCKETS )
+    /* Check if there is a free location in the VirtualSockets array         */
+    if ( VirtualSocketsFreeTop > 0 )
     {
-        /* Check if the arrayIndex in VirtualSockets is free                 */
-        if ( NULL == VirtualSockets[arrayIndex] )
-        {
-            /* Allocate memory for new socket node for the socket list       */
-            *newSocketNode = (SlNetSock_VirtualSocket_t *)calloc(1, sizeof(SlNetSock_VirtualSocket_t));
+        *virtualSdIndex = VirtualSocketsFree[--VirtualSocketsFreeTop];
+        socketNode      = &VirtualSockets[*virtualSdIndex];
 
-            /* Check if the memory allocated successfully                    */
-            if (NULL == *newSocketNode)
-            {
-                /* Allocation failed, return error code                      */
-                retVal = SLNETERR_RET_CODE_MALLOC_ERROR;
-                break;
-            }
-            else
-            {
-                /* Location free, return the Index and function success      */
-                *virtualSdIndex = arrayIndex;
-
-                VirtualSockets[arrayIndex] = *newSocketNode;
+        /* Until the socket is set, lookups return creation in progress      */
+        SlNetSock_writeBegin(socketNode);
+        socketNode->generation++;
+        socketNode->inUse     = true;
+        socketNode->realSd    = -1;
+        socketNode->sdFlags   = 0;
+        socketNode->sdContext = NULL;
+        socketNode->netIf     = NULL;
+        SlNetSock_writeEnd(socketNode);
 
-                retVal = SLNETERR_RET_CODE_OK;
-                break;
-            }
-        }
-        else
-        {
-            /* Location isn't free, continue to next location                */
-            arrayIndex++;
-        }
+        retVal = SLNETERR_RET_CODE_OK;
     }
 
     SLNETSOCK_UNLOCK();
@@ -235,48 +377,86 @@ static int32_t SlNetSock_AllocVirtualSocket(int16_t *virtualSdIndex, SlNetSock_V
 
 //*****************************************************************************
 //
-// SlNetSock_freeVirtualSocket - free allocated socket and initialize the array
-//                               in the virtual socket location
+// SlNetSock_setVirtualSocket - Fill an allocated socket once its real socket
+//                              is created
+//
+//*****************************************************************************
+static void SlNetSock_setVirtualSocket(int16_t virtualSdIndex, int16_t realSd, uint8_t sdFlags, void *sdContext, SlNetIf_t *netIf)
+{
+    SlNetSock_VirtualSocket_t *socketNode = &VirtualSockets[virtualSdIndex];
+
+    SLNETSOCK_LOCK();
+
+    SlNetSock_writeBegin(socketNode);
+    socketNode->realSd    = realSd;
+    socketNode->sdFlags   = sdFlags;
+    socketNode->sdContext = sdContext;
+    socketNode->netIf     = netIf;
+    SlNetSock_writeEnd(socketNode);
+
+    SLNETSOCK_UNLOCK();
+}
+
+//*****************************************************************************
+//
+// SlNetSock_freeVirtualSocket - free allocated socket and return its location
+//                               in the VirtualSockets array to the free stack
 //
 //*****************************************************************************
 static int32_t SlNetSock_freeVirtualSocket(int16_t virtualSdIndex)
 {
-    int32_t retVal = SLNETERR_RET_CODE_OK;
+    SlNetSock_VirtualSocket_t *socketNode;
+    void                      *sdContext = NULL;
+    int32_t                    retVal    = SLNETERR_RET_CODE_OK;
 
     if (false == SlNetSock_Initialized)
     {
         return SLNETERR_RET_CODE_MUTEX_CREATION_FAILED;
     }
 
-    SLNETSOCK_LOCK();
-
-    /* Check if the input is valid and if real socket descriptor exists      */
+    /* Check if the input is valid                                           */
     if ( (virtualSdIndex >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) || (virtualSdIndex < 0) )
     {
-        retVal = SLNETERR_RET_CODE_INVALID_INPUT;
+        return SLNETERR_RET_CODE_INVALID_INPUT;
     }
-    else if (NULL == VirtualSockets[virtualSdIndex])
+
+    socketNode = &VirtualSockets[virtualSdIndex];
+
+    SLNETSOCK_LOCK();
+
+    /* Check if real socket descriptor exists                                */
+    if (false == socketNode->inUse)
     {
         /* Socket was not found, return error code                           */
         retVal = SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
     }
     else
     {
-        /* Free Socket Context allocated memory                              */
-        if (NULL != VirtualSockets[virtualSdIndex]->sdContext)
-        {
-            free((void *)VirtualSockets[virtualSdIndex]->sdContext);
-        }
+        sdContext = socketNode->sdContext;
+
+        /* Clear the socket and push its location to the free stack          */
+        SlNetSock_writeBegin(socketNode);
+        socketNode->inUse     = false;
+        socketNode->realSd    = -1;
+        socketNode->sdFlags   = 0;
+        socketNode->sdContext = NULL;
+        socketNode->netIf     = NULL;
+        SlNetSock_writeEnd(socketNode);
 
-        /* Free Socket Node allocated memory and delete it from the
-           VirtualSockets array                                              */
-        free((void *)VirtualSockets[virtualSdIndex]);
+        VirtualSocketsFree[VirtualSocketsFreeTop++] = virtualSdIndex;
 
-        VirtualSockets[virtualSdIndex] = NULL;
+        /* The index may be reused, drop it from the poll sets               */
+        SlNetSock_pollForget(virtualSdIndex);
     }
 
     SLNETSOCK_UNLOCK();
 
+    /* Free Socket Context allocated memory                                  */
+    if (NULL != sdContext)
+    {
+        free(sdContext);
+    }
+
     return retVal;
 }
 
@@ -300,10 +480,13 @@ int32_t SlNetSock_init(int32_t flags)
         }
         else
         {
-            /* Initialize the VirtualSockets array                           */
+            /* Initialize the VirtualSockets array and stack its indexes
+               so that the lowest index is allocated first                   */
+            memset(VirtualSockets, 0, sizeof(VirtualSockets));
+            VirtualSocketsFreeTop = 0;
             while (Index--)
             {
-                VirtualSockets[Index] = NULL;
+                VirtualSocketsFree[VirtualSocketsFreeTop++] = Index;
             }
             SlNetSock_Initialized = true;
         }
@@ -320,7 +503,7 @@ int32_t SlNetSock_init(int32_t flags)
 int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_t ifBitmap, int16_t flags)
 {
     SlNetIf_t                 *netIf;
-    SlNetSock_VirtualSocket_t *sdNode;
+    void                      *sdContext = NULL;
     int16_t                    socketIndex;
     int16_t                    createdSd;
     int16_t                    queryFlags;
@@ -338,7 +521,7 @@ int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_
     }
 
     /* Search for free place in the array */
-    retVal = SlNetSock_AllocVirtualSocket(&socketIndex, &sdNode);
+    retVal = SlNetSock_AllocVirtualSocket(&socketIndex);
 
     /* Before creating a socket, check if there is a free place in the array */
     if ( retVal < SLNETERR_RET_CODE_OK )
@@ -384,6 +567,7 @@ int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_
         if (NULL == netIf)
         {
             /* Free the captured VirtualSockets location                     */
+            free(sdContext);
             SlNetSock_freeVirtualSocket(socketIndex);
 
             /* Interface doesn't exists, save error code                     */
@@ -397,7 +581,8 @@ int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_
             ifBitmap &= ~(netIf->ifID);
 
             /* Interface exists, try to create new socket                    */
-            createdSd = (netIf->ifConf)->sockCreate(netIf->ifContext, domain, type, protocol, &(sdNode->sdContext));
+            createdSd = (netIf->ifConf)->sockCreate(netIf->ifContext, domain, type, protocol, &sdContext);
+            SlNetIf_updateStats(netIf, SLNETIF_STATS_SOCK_OPEN, createdSd, 0);
 
             /* Check createdSd for error codes                               */
             if (createdSd < 0)
@@ -408,8 +593,7 @@ int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_
             else
             {
                 /* Real socket created, fill the allocated socket node       */
-                sdNode->realSd    = createdSd;
-                sdNode->netIf     = netIf;
+                SlNetSock_setVirtualSocket(socketIndex, createdSd, 0, sdContext, netIf);
 
                 /* Socket created, allocated and connected to the
                    VirtualSockets array, return VirtualSockets index         */
@@ -419,6 +603,7 @@ int16_t SlNetSock_create(int16_t domain, int16_t type, int16_t protocol, uint32_
     }
 
     /* Free the captured VirtualSockets location                             */
+    free(sdContext);
     SlNetSock_freeVirtualSocket(socketIndex);
 
     /* There isn't a free space in the array or socket couldn't be opened,
@@ -453,6 +638,7 @@ int32_t SlNetSock_close(int16_t sd)
        the Close command                                                     */
     retVal = (netIf->ifConf)->sockClose(realSd, sdContext);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKCLOSE_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_SOCK_CLOSE, retVal, 0);
 
     /* When freeing the virtual socket, it will free allocated memory
        of the sdContext and of the socket node, if other threads will
@@ -510,14 +696,16 @@ int32_t SlNetSock_shutdown(int16_t sd, int16_t how)
 //*****************************************************************************
 int16_t SlNetSock_accept(int16_t sd, SlNetSock_Addr_t *addr, SlNetSocklen_t *addrlen)
 {
-    SlNetSock_VirtualSocket_t *allocSdNode;
+    SlNetIf_t                 *netIf;
     void                      *sdContext;
+    void                      *newSdContext = NULL;
     int16_t                    realSd;
+    uint8_t                    sdFlags;
     int16_t                    socketIndex;
     int32_t                    retVal = SLNETERR_RET_CODE_OK;
 
     /* Search for free place in the array */
-    retVal = SlNetSock_AllocVirtualSocket(&socketIndex, &allocSdNode);
+    retVal = SlNetSock_AllocVirtualSocket(&socketIndex);
 
     /* Before creating a socket, check if there is a free place in the array */
     if ( retVal < SLNETERR_RET_CODE_OK )
@@ -527,14 +715,17 @@ int16_t SlNetSock_accept(int16_t sd, SlNetSock_Addr_t *addr, SlNetSocklen_t *add
     }
 
     /* Check if the sd input exists and return it                            */
-    retVal = SlNetSock_getVirtualSdConf(sd, &realSd, &(allocSdNode->sdFlags), &sdContext, &(allocSdNode->netIf));
+    retVal = SlNetSock_getVirtualSdConf(sd, &realSd, &sdFlags, &sdContext, &netIf);
 
     /* Check if sd found or if the non mandatory function exists             */
     if (SLNETERR_RET_CODE_OK != retVal)
     {
+        /* Free the captured VirtualSockets location                         */
+        SlNetSock_freeVirtualSocket(socketIndex);
+
         return retVal;
     }
-    if (NULL == ((allocSdNode->netIf)->ifConf)->sockAccept)
+    if (NULL == (netIf->ifConf)->sockAccept)
     {
         /* Free the captured VirtualSockets location                         */
         SlNetSock_freeVirtualSocket(socketIndex);
@@ -545,12 +736,14 @@ int16_t SlNetSock_accept(int16_t sd, SlNetSock_Addr_t *addr, SlNetSocklen_t *add
 
     /* Function exists in the interface of the socket descriptor, dispatch
        the Accept command                                                    */
-    retVal = ((allocSdNode->netIf)->ifConf)->sockAccept(realSd, sdContext, addr, addrlen, allocSdNode->sdFlags, &(allocSdNode->sdContext));
+    retVal = (netIf->ifConf)->sockAccept(realSd, sdContext, addr, addrlen, sdFlags, &newSdContext);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_SOCK_OPEN, retVal, 0);
 
     /* Check retVal for error codes                                          */
     if (retVal < SLNETERR_RET_CODE_OK)
     {
         /* Free the captured VirtualSockets location                         */
+        free(newSdContext);
         SlNetSock_freeVirtualSocket(socketIndex);
 
         /* sockAccept failed, return error code                              */
@@ -559,7 +752,7 @@ int16_t SlNetSock_accept(int16_t sd, SlNetSock_Addr_t *addr, SlNetSocklen_t *add
     else
     {
         /* Real socket created, fill the allocated socket node               */
-        allocSdNode->realSd = retVal;
+        SlNetSock_setVirtualSocket(socketIndex, retVal, sdFlags, newSdContext, netIf);
 
         /* Socket created, allocated and connected to the
            VirtualSockets array, return VirtualSockets index                 */
@@ -651,6 +844,7 @@ int32_t SlNetSock_connect(int16_t sd, const SlNetSock_Addr_t *addr, SlNetSocklen
     uint8_t    sdFlags;
     SlNetIf_t *netIf;
     void      *sdContext;
+    uint32_t   startTime;
 
     /* Check if the sd input exists and return it                            */
     retVal = SlNetSock_getVirtualSdConf(sd, &realSd, &sdFlags, &sdContext, &netIf);
@@ -668,8 +862,10 @@ int32_t SlNetSock_connect(int16_t sd, const SlNetSock_Addr_t *addr, SlNetSocklen
 
     /* Function exists in the interface of the socket descriptor, dispatch
        the Connect command                                                   */
+    startTime = SlNetSock_getTimeMs();
     retVal = (netIf->ifConf)->sockConnect(realSd, sdContext, addr, addrlen, sdFlags);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKCONNECT_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_CONNECT, retVal, SlNetSock_getTimeMs() - startTime);
 
     return retVal;
 }
@@ -690,6 +886,7 @@ int32_t SlNetSock_connectUrl(int16_t sd, const char *url)
     uint8_t             sdFlags;
     SlNetIf_t          *netIf;
     void               *sdContext;
+    uint32_t            startTime;
     int32_t             retVal = SLNETERR_RET_CODE_OK;
 
     /* Check if the sd input exists and return it                            */
@@ -740,8 +937,10 @@ int32_t SlNetSock_connectUrl(int16_t sd, const char *url)
 
     /* Function exists in the interface of the socket descriptor, dispatch
        the Connect command                                                   */
+    startTime = SlNetSock_getTimeMs();
     retVal = (netIf->ifConf)->sockConnect(realSd, sdContext, (const SlNetSock_Addr_t *)&localAddr, localAddrSize, sdFlags);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKCONNECT_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_CONNECT, retVal, SlNetSock_getTimeMs() - startTime);
 
     return retVal;
 }
@@ -1053,7 +1252,7 @@ int32_t SlNetSock_sdsClrAll(SlNetSock_SdSet_t *sdset)
     }
 
     /* Check the size of the sdArrayIndex                                    */
-    sdArrayIndex = (((sizeof(sdset)*8)-1) / SLNETSOCK_SIZEOF_ONE_SDSETBITMAP_SLOT_IN_BITS);
+    sdArrayIndex = (sizeof(sdset->sdSetBitmap) / sizeof(sdset->sdSetBitmap[0])) - 1;
 
     while (sdArrayIndex >= 0)
     {
@@ -1100,6 +1299,501 @@ int32_t SlNetSock_sdsIsSet(int16_t sd, SlNetSock_SdSet_t *sdset)
 }
 
 
+//*****************************************************************************
+//
+// SlNetSock_pollRebuild - Rebuild the interface sd sets of a poll set, called
+//                         with the lock taken
+//
+//*****************************************************************************
+static void SlNetSock_pollRebuild(SlNetSock_PollSet_t *pollSet)
+{
+    int16_t sdIndex;
+
+    SlNetSock_sdsClrAll(&(pollSet->ifReadsds));
+    SlNetSock_sdsClrAll(&(pollSet->ifWritesds));
+    SlNetSock_sdsClrAll(&(pollSet->ifExceptsds));
+    pollSet->ifNsds = 0;
+
+    for (sdIndex = 0; sdIndex < SLNETSOCK_MAX_CONCURRENT_SOCKETS; sdIndex++)
+    {
+        /* Pushed sockets are left out of the interface select               */
+        if ( (0 == pollSet->interest[sdIndex]) || (pollSet->interest[sdIndex] & SLNETSOCK_POLL_PUSH) )
+        {
+            continue;
+        }
+        if (pollSet->interest[sdIndex] & SLNETSOCK_POLL_IN)
+        {
+            SlNetSock_sdsSet(pollSet->realSd[sdIndex], &(pollSet->ifReadsds));
+        }
+        if (pollSet->interest[sdIndex] & SLNETSOCK_POLL_OUT)
+        {
+            SlNetSock_sdsSet(pollSet->realSd[sdIndex], &(pollSet->ifWritesds));
+        }
+        if (pollSet->interest[sdIndex] & SLNETSOCK_POLL_ERR)
+        {
+            SlNetSock_sdsSet(pollSet->realSd[sdIndex], &(pollSet->ifExceptsds));
+        }
+        if (pollSet->ifNsds <= pollSet->realSd[sdIndex])
+        {
+            pollSet->ifNsds = pollSet->realSd[sdIndex] + 1;
+        }
+    }
+
+    /* Without sockets, the next registration may use any interface          */
+    if (0 == pollSet->numSds)
+    {
+        pollSet->netIf = NULL;
+    }
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollForget - Remove a socket from all the poll sets, called with
+//                        the lock taken
+//
+//*****************************************************************************
+static void SlNetSock_pollForget(int16_t virtualSdIndex)
+{
+    SlNetSock_PollSet_t *pollSet;
+
+    for (pollSet = PollSets; pollSet < &PollSets[SLNETSOCK_MAX_POLL_SETS]; pollSet++)
+    {
+        if ( (true == pollSet->inUse) && (0 != pollSet->interest[virtualSdIndex]) )
+        {
+            if (0 != pollSet->ready[virtualSdIndex])
+            {
+                pollSet->ready[virtualSdIndex] = 0;
+                pollSet->numReady--;
+            }
+            pollSet->interest[virtualSdIndex] = 0;
+            pollSet->numSds--;
+            SlNetSock_pollRebuild(pollSet);
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollPush - Add readiness to the poll sets of a socket and wake
+//                      their blocked waiters, called with the lock taken
+//
+//*****************************************************************************
+static void SlNetSock_pollPush(int16_t virtualSdIndex, uint8_t events)
+{
+    SlNetSock_PollSet_t *pollSet;
+    uint8_t              setEvents;
+
+    for (pollSet = PollSets; pollSet < &PollSets[SLNETSOCK_MAX_POLL_SETS]; pollSet++)
+    {
+        if (false == pollSet->inUse)
+        {
+            continue;
+        }
+
+        /* Errors are reported to every registered socket                    */
+        setEvents = events & (pollSet->interest[virtualSdIndex] | SLNETSOCK_POLL_ERR);
+        if ( (0 == pollSet->interest[virtualSdIndex]) || (0 == setEvents) )
+        {
+            continue;
+        }
+        if (0 == pollSet->ready[virtualSdIndex])
+        {
+            pollSet->numReady++;
+        }
+        pollSet->ready[virtualSdIndex] |= setEvents;
+
+        if (true == pollSet->waiting)
+        {
+            pollSet->waiting = false;
+            sem_post(&(pollSet->readySem));
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollBlock - Block until readiness is pushed or the timeout
+//                       expires
+//
+//*****************************************************************************
+static void SlNetSock_pollBlock(SlNetSock_PollSet_t *pollSet, SlNetSock_Timeval_t *timeout)
+{
+    struct timespec deadline;
+
+    if (NULL == timeout)
+    {
+        sem_wait(&(pollSet->readySem));
+        return;
+    }
+
+    /* sem_timedwait takes an absolute realtime deadline                     */
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec  += timeout->tv_sec + (timeout->tv_usec / 1000000);
+    deadline.tv_nsec += (timeout->tv_usec % 1000000) * 1000;
+    if (deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    sem_timedwait(&(pollSet->readySem), &deadline);
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollCreate - Create a poll set
+//
+//*****************************************************************************
+int16_t SlNetSock_pollCreate(void)
+{
+    SlNetSock_PollSet_t *pollSet;
+    int16_t              pollSd;
+
+    if (false == SlNetSock_Initialized)
+    {
+        return SLNETERR_RET_CODE_MUTEX_CREATION_FAILED;
+    }
+
+    SLNETSOCK_LOCK();
+
+    for (pollSd = 0; pollSd < SLNETSOCK_MAX_POLL_SETS; pollSd++)
+    {
+        pollSet = &PollSets[pollSd];
+        if (false == pollSet->inUse)
+        {
+            memset(pollSet, 0, sizeof(SlNetSock_PollSet_t));
+            if (0 != sem_init(&(pollSet->readySem), 0, 0))
+            {
+                SLNETSOCK_UNLOCK();
+                return SLNETERR_RET_CODE_MUTEX_CREATION_FAILED;
+            }
+            pollSet->inUse = true;
+
+            SLNETSOCK_UNLOCK();
+            return pollSd;
+        }
+    }
+
+    SLNETSOCK_UNLOCK();
+
+    /* There isn't a free poll set, return error code                        */
+    return SLNETERR_RET_CODE_NO_FREE_SPACE;
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollClose - Close a poll set
+//
+//*****************************************************************************
+int32_t SlNetSock_pollClose(int16_t pollSd)
+{
+    SlNetSock_PollSet_t *pollSet;
+
+    /* Check if the input is valid                                           */
+    if ( (false == SlNetSock_Initialized) || (pollSd < 0) || (pollSd >= SLNETSOCK_MAX_POLL_SETS) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    pollSet = &PollSets[pollSd];
+
+    SLNETSOCK_LOCK();
+
+    if (false == pollSet->inUse)
+    {
+        SLNETSOCK_UNLOCK();
+        return SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
+    }
+    pollSet->inUse = false;
+    sem_destroy(&(pollSet->readySem));
+
+    SLNETSOCK_UNLOCK();
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollCtl - Register, modify or remove the interest of a poll set
+//                     in a socket
+//
+//*****************************************************************************
+int32_t SlNetSock_pollCtl(int16_t pollSd, int16_t sd, uint8_t events)
+{
+    SlNetSock_PollSet_t *pollSet;
+    SlNetIf_t           *netIf  = NULL;
+    int16_t              realSd = -1;
+    int32_t              retVal = SLNETERR_RET_CODE_OK;
+
+    /* Check if the input is valid                                           */
+    if ( (pollSd < 0) || (pollSd >= SLNETSOCK_MAX_POLL_SETS) ||
+         (sd < 0) || (sd >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) ||
+         (0 != (events & ~(SLNETSOCK_POLL_IN | SLNETSOCK_POLL_OUT | SLNETSOCK_POLL_ERR | SLNETSOCK_POLL_PUSH))) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    pollSet = &PollSets[pollSd];
+
+    if (0 != events)
+    {
+        /* Check if the sd input exists and return it                        */
+        retVal = SlNetSock_getVirtualSdConf(sd, &realSd, NULL, NULL, &netIf);
+        if (SLNETERR_RET_CODE_OK != retVal)
+        {
+            return retVal;
+        }
+    }
+
+    SLNETSOCK_LOCK();
+
+    if (false == pollSet->inUse)
+    {
+        retVal = SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    else if (0 == events)
+    {
+        /* Remove the socket, if it is registered                            */
+        if (0 != pollSet->interest[sd])
+        {
+            if (0 != pollSet->ready[sd])
+            {
+                pollSet->ready[sd] = 0;
+                pollSet->numReady--;
+            }
+            pollSet->interest[sd] = 0;
+            pollSet->numSds--;
+            SlNetSock_pollRebuild(pollSet);
+        }
+    }
+    else if ( (NULL != pollSet->netIf) && (netIf != pollSet->netIf) &&
+              ( (1 != pollSet->numSds) || (0 == pollSet->interest[sd]) ) )
+    {
+        /* The interface select can't monitor the sockets of another
+           interface                                                         */
+        retVal = SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    else
+    {
+        if (0 == pollSet->interest[sd])
+        {
+            pollSet->numSds++;
+        }
+        pollSet->interest[sd] = events;
+        pollSet->realSd[sd]   = realSd;
+        pollSet->netIf        = netIf;
+        SlNetSock_pollRebuild(pollSet);
+    }
+
+    SLNETSOCK_UNLOCK();
+
+    return retVal;
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollWait - Wait for the sockets of a poll set to become ready
+//
+//*****************************************************************************
+int32_t SlNetSock_pollWait(int16_t pollSd, SlNetSock_PollEvent_t *events, uint16_t maxEvents, SlNetSock_Timeval_t *timeout)
+{
+    SlNetSock_PollSet_t *pollSet;
+    SlNetIf_t           *netIf    = NULL;
+    int16_t              ifNsds   = 0;
+    int16_t              numReady;
+    int16_t              sdIndex;
+    int32_t              retVal   = 0;
+    int32_t              count    = 0;
+    bool                 blocking = false;
+    uint8_t              sdEvents;
+    SlNetSock_SdSet_t    ifReadsds;
+    SlNetSock_SdSet_t    ifWritesds;
+    SlNetSock_SdSet_t    ifExceptsds;
+
+    /* Check if the input is valid                                           */
+    if ( (pollSd < 0) || (pollSd >= SLNETSOCK_MAX_POLL_SETS) || (NULL == events) || (0 == maxEvents) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+    pollSet = &PollSets[pollSd];
+
+    SLNETSOCK_LOCK();
+
+    if (false == pollSet->inUse)
+    {
+        SLNETSOCK_UNLOCK();
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    /* Copy the interface sd sets, the interface select writes to them       */
+    numReady = pollSet->numReady;
+    if (0 == numReady)
+    {
+        ifNsds      = pollSet->ifNsds;
+        ifReadsds   = pollSet->ifReadsds;
+        ifWritesds  = pollSet->ifWritesds;
+        ifExceptsds = pollSet->ifExceptsds;
+        if (ifNsds > 0)
+        {
+            netIf = pollSet->netIf;
+        }
+
+        /* Without sockets to select, only pushed readiness can end the wait */
+        if ( (NULL == netIf) &&
+             ( (NULL == timeout) || (0 != timeout->tv_sec) || (0 != timeout->tv_usec) ) )
+        {
+            pollSet->waiting = true;
+            blocking         = true;
+        }
+    }
+
+    SLNETSOCK_UNLOCK();
+
+    if (true == blocking)
+    {
+        SlNetSock_pollBlock(pollSet, timeout);
+    }
+    else if (NULL != netIf)
+    {
+        if (NULL == (netIf->ifConf)->sockSelect)
+        {
+            /* Non mandatory function doesn't exists, return error code      */
+            return SLNETERR_RET_CODE_DOESNT_SUPPORT_NON_MANDATORY_FXN;
+        }
+
+        /* Function exists in the interface of the sockets, dispatch the
+           Select command                                                    */
+        retVal = (netIf->ifConf)->sockSelect(netIf->ifContext, ifNsds, &ifReadsds, &ifWritesds, &ifExceptsds, timeout);
+        SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKSELECT_FAILED);
+
+        if (retVal < 0)
+        {
+            return retVal;
+        }
+    }
+
+    SLNETSOCK_LOCK();
+
+    /* A push that came after the timeout posted for nothing, take it back   */
+    if (true == blocking)
+    {
+        if (true == pollSet->waiting)
+        {
+            pollSet->waiting = false;
+        }
+        else
+        {
+            sem_trywait(&(pollSet->readySem));
+        }
+    }
+
+    /* Merge the selected sockets with the pushed readiness                  */
+    for (sdIndex = 0; (sdIndex < SLNETSOCK_MAX_CONCURRENT_SOCKETS) && (count < maxEvents); sdIndex++)
+    {
+        if (0 == pollSet->interest[sdIndex])
+        {
+            continue;
+        }
+        sdEvents = pollSet->ready[sdIndex];
+        if (retVal > 0)
+        {
+            if (SlNetSock_sdsIsSet(pollSet->realSd[sdIndex], &ifReadsds) == 1)
+            {
+                sdEvents |= SLNETSOCK_POLL_IN;
+            }
+            if (SlNetSock_sdsIsSet(pollSet->realSd[sdIndex], &ifWritesds) == 1)
+            {
+                sdEvents |= SLNETSOCK_POLL_OUT;
+            }
+            if (SlNetSock_sdsIsSet(pollSet->realSd[sdIndex], &ifExceptsds) == 1)
+            {
+                sdEvents |= SLNETSOCK_POLL_ERR;
+            }
+            sdEvents &= (pollSet->interest[sdIndex] | pollSet->ready[sdIndex]);
+        }
+        if (0 != sdEvents)
+        {
+            events[count].sd     = sdIndex;
+            events[count].events = sdEvents;
+            count++;
+
+            if (0 != pollSet->ready[sdIndex])
+            {
+                pollSet->ready[sdIndex] = 0;
+                pollSet->numReady--;
+            }
+        }
+    }
+
+    SLNETSOCK_UNLOCK();
+
+    return count;
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollNotify - Push readiness of a socket to its poll sets
+//
+//*****************************************************************************
+int32_t SlNetSock_pollNotify(int16_t sd, uint8_t events)
+{
+    /* Check if the input is valid                                           */
+    if ( (false == SlNetSock_Initialized) || (sd < 0) || (sd >= SLNETSOCK_MAX_CONCURRENT_SOCKETS) )
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    SLNETSOCK_LOCK();
+    SlNetSock_pollPush(sd, events & (SLNETSOCK_POLL_IN | SLNETSOCK_POLL_OUT | SLNETSOCK_POLL_ERR));
+    SLNETSOCK_UNLOCK();
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+
+//*****************************************************************************
+//
+// SlNetSock_pollNotifyIf - Push readiness of a socket given by its interface
+//                          descriptor
+//
+//*****************************************************************************
+int32_t SlNetSock_pollNotifyIf(uint16_t ifID, int16_t realSd, uint8_t events)
+{
+    int32_t retVal = SLNETERR_RET_CODE_COULDNT_FIND_RESOURCE;
+    int16_t sdIndex;
+
+    if (false == SlNetSock_Initialized)
+    {
+        return SLNETERR_RET_CODE_MUTEX_CREATION_FAILED;
+    }
+
+    SLNETSOCK_LOCK();
+
+    /* Find the virtual socket of the interface socket                       */
+    for (sdIndex = 0; sdIndex < SLNETSOCK_MAX_CONCURRENT_SOCKETS; sdIndex++)
+    {
+        if ( (true == VirtualSockets[sdIndex].inUse) &&
+             (NULL != VirtualSockets[sdIndex].netIf) &&
+             (ifID == VirtualSockets[sdIndex].netIf->ifID) &&
+             (realSd == VirtualSockets[sdIndex].realSd) )
+        {
+            SlNetSock_pollPush(sdIndex, events & (SLNETSOCK_POLL_IN | SLNETSOCK_POLL_OUT | SLNETSOCK_POLL_ERR));
+            retVal = SLNETERR_RET_CODE_OK;
+            break;
+        }
+    }
+
+    SLNETSOCK_UNLOCK();
+
+    return retVal;
+}
+
+
 //*****************************************************************************
 //
 // SlNetSock_setOpt - Set socket options
@@ -1210,6 +1904,7 @@ int32_t SlNetSock_recv(int16_t sd, void *buf, uint32_t len, uint32_t flags)
        the Recv command                                                      */
     retVal = (netIf->ifConf)->sockRecv(realSd, sdContext, buf, len, flags);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKRECV_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_RECV, retVal, 0);
 
     return retVal;
 }
@@ -1251,6 +1946,7 @@ int32_t SlNetSock_recvFrom(int16_t sd, void *buf, uint32_t len, uint32_t flags,
        the RecvFrom command                                                  */
     retVal = (netIf->ifConf)->sockRecvFrom(realSd, sdContext, buf, len, flags, from, fromlen);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKRECVFROM_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_RECV, retVal, 0);
 
     return retVal;
 }
@@ -1296,6 +1992,7 @@ int32_t SlNetSock_send(int16_t sd, const void *buf, uint32_t len, uint32_t flags
        the Send command                                                      */
     retVal = (netIf->ifConf)->sockSend(realSd, sdContext, buf, len, flags);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKSEND_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_SEND, retVal, 0);
 
     return retVal;
 }
@@ -1337,6 +2034,7 @@ int32_t SlNetSock_sendTo(int16_t sd, const void *buf, uint32_t len, uint32_t fla
        the SendTo command                                                    */
     retVal = (netIf->ifConf)->sockSendTo(realSd, sdContext, buf, len, flags, to, tolen);
     SLNETSOCK_NORMALIZE_RET_VAL(retVal,SLNETSOCK_ERR_SOCKSENDTO_FAILED);
+    SlNetIf_updateStats(netIf, SLNETIF_STATS_SEND, retVal, 0);
 
     return retVal;
 }
@@ -1368,6 +2066,59 @@ int32_t SlNetSock_getIfID(uint16_t sd)
 }
 
 
+//*****************************************************************************
+//
+// SlNetSock_getGeneration - Get the generation of the socket an sd names
+//
+//*****************************************************************************
+int32_t SlNetSock_getGeneration(int16_t sd, uint16_t *generation)
+{
+    SlNetSock_VirtualSocket_t socketCopy;
+    int32_t                   retVal;
+
+    if (NULL == generation)
+    {
+        return SLNETERR_RET_CODE_INVALID_INPUT;
+    }
+
+    retVal = SlNetSock_copyVirtualSocket(sd, &socketCopy);
+    if (SLNETERR_RET_CODE_OK != retVal)
+    {
+        return retVal;
+    }
+
+    *generation = socketCopy.generation;
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+//*****************************************************************************
+//
+// SlNetSock_checkGeneration - Check an sd still names the socket of the
+//                             generation taken when it was opened
+//
+//*****************************************************************************
+int32_t SlNetSock_checkGeneration(int16_t sd, uint16_t generation)
+{
+    SlNetSock_VirtualSocket_t socketCopy;
+    int32_t                   retVal;
+
+    retVal = SlNetSock_copyVirtualSocket(sd, &socketCopy);
+    if (SLNETERR_RET_CODE_OK != retVal)
+    {
+        return retVal;
+    }
+
+    /* The socket was closed, and its sd given to a new one                  */
+    if (generation != socketCopy.generation)
+    {
+        return SLNETERR_BSD_EBADF;
+    }
+
+    return SLNETERR_RET_CODE_OK;
+}
+
+
 //*****************************************************************************
 //
 // SlNetSock_secAttribCreate - Creates a security attributes object
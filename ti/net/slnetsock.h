@@ -215,7 +215,19 @@ extern "C" {
 /* Macro declarations                                                        */
 /*****************************************************************************/
 
-#define SLNETSOCK_MAX_CONCURRENT_SOCKETS                                    (32)  /**< Declares the maximum sockets that can be opened */
+#ifndef SLNETSOCK_MAX_CONCURRENT_SOCKETS
+#define SLNETSOCK_MAX_CONCURRENT_SOCKETS                                    (32)  /**< Declares the maximum sockets that can be opened, a host build may raise it */
+#endif
+
+#ifndef SLNETSOCK_MAX_POLL_SETS
+#define SLNETSOCK_MAX_POLL_SETS                                             (2)   /**< Declares the maximum poll sets that can be created     */
+#endif
+
+/* Readiness events of the SlNetSock_poll functions */
+#define SLNETSOCK_POLL_IN                                                   (1 << 0) /**< Data to read, or a connection to accept              */
+#define SLNETSOCK_POLL_OUT                                                  (1 << 1) /**< Connected, as reported by the write sd set of select  */
+#define SLNETSOCK_POLL_ERR                                                  (1 << 2) /**< Exception, or a failure pushed by the interface       */
+#define SLNETSOCK_POLL_PUSH                                                 (1 << 3) /**< Readiness is only pushed, the socket isn't selected   */
 
 /* Address families.  */
 #define SLNETSOCK_AF_UNSPEC                                                 (0)   /**< Unspecified address family      */
@@ -407,6 +419,8 @@ typedef enum
 #define SLNETSOCK_CREATE_IF_STATUS_CONNECTED                                (1 << 1) /**< Creation of the socket will be on status connected   */
 #define SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH                                (1 << 2) /**< Creation of the socket will be on the interface with
                                                                                         the highest priority if the other flags will fail    */
+#define SLNETSOCK_CREATE_IF_HEALTH                                          (1 << 3) /**< Creation of the socket will avoid degraded interfaces
+                                                                                        and balance over the healthy ones, see SlNetIf_queryIf */
 
 /* Definitions for shutting down some or all parts of a full duplex connection */
 #define SLNETSOCK_SHUT_RD                                                   (0) /**< Further receptions will be disallowed                   */
@@ -697,6 +711,15 @@ typedef struct SlNetSock_SdSet_t         /**< The select socket array manager */
     uint32_t sdSetBitmap[(SLNETSOCK_MAX_CONCURRENT_SOCKETS + (uint8_t)31)/(uint8_t)32]; /* Bitmap of SOCKET Descriptors */
 } SlNetSock_SdSet_t;
 
+/*!
+    \brief The SlNetSock_PollEvent_t structure holds a ready socket returned by SlNetSock_pollWait function
+*/
+typedef struct SlNetSock_PollEvent_t
+{
+    int16_t sd;                          /**< Ready socket descriptor                        */
+    uint8_t events;                      /**< Bitwise OR of the SLNETSOCK_POLL_ events ready */
+} SlNetSock_PollEvent_t;
+
 
 /*!
     \brief The SlNetSock_TransceiverRxOverHead_t structure holds the data for Rx transceiver mode using a raw socket when using SlNetSock_recv function
@@ -777,9 +800,13 @@ int32_t SlNetSock_init(int32_t flags);
                                    - #SLNETSOCK_CREATE_IF_STATUS_CONNECTED - Creation of the socket will be on status connected
                                    - #SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH - Creation of the socket will be on the interface with
                                                                             the highest priority if the other flags will fail
+                                   - #SLNETSOCK_CREATE_IF_HEALTH           - Creation of the socket will avoid degraded interfaces
+                                                                            and balance over the healthy ones
                                 The value 0 may be used in order to run the default flags:
                                    - #SLNETSOCK_CREATE_IF_STATE_ENABLE
                                    - #SLNETSOCK_CREATE_IF_STATUS_CONNECTED
+                                   - #SLNETSOCK_CREATE_ALLOW_PARTIAL_MATCH
+                                   - #SLNETSOCK_CREATE_IF_HEALTH
 
     \return                     On success, socket descriptor (handle) that is used for consequent socket operations. \n
                                 A successful return code should be a positive number\n
@@ -1161,6 +1188,114 @@ int32_t SlNetSock_sdsClrAll(SlNetSock_SdSet_t *sdset);
 int32_t SlNetSock_sdsIsSet(int16_t sd, SlNetSock_SdSet_t *sdset);
 
 
+/*!
+    \brief Create a poll set
+
+    A poll set is the registration based alternative to SlNetSock_select().
+    Sockets are registered once with SlNetSock_pollCtl(), the interface sd
+    sets are kept up to date on registration rather than rebuilt on every
+    wait. Readiness can also be pushed with SlNetSock_pollNotify(), from an
+    interface event handler for instance, and is then returned by
+    SlNetSock_pollWait() without a round trip to the interface select.
+
+    \return                    Poll set descriptor on success, or negative
+                               error code on failure
+
+    \slnetsock_init_precondition
+
+    \sa         SlNetSock_pollCtl()
+    \sa         SlNetSock_pollWait()
+    \sa         SlNetSock_pollClose()
+*/
+int16_t SlNetSock_pollCreate(void);
+
+
+/*!
+    \brief Close a poll set
+
+    \param[in] pollSd          Poll set descriptor from SlNetSock_pollCreate()
+
+    \return                    Zero on success, or negative error code on failure
+
+    \remark     The poll set must not be waited on while it is closed
+*/
+int32_t SlNetSock_pollClose(int16_t pollSd);
+
+
+/*!
+    \brief Register, modify or remove the interest of a poll set in a socket
+
+    \param[in] pollSd          Poll set descriptor from SlNetSock_pollCreate()
+    \param[in] sd              Socket handle
+    \param[in] events          Bitwise OR of #SLNETSOCK_POLL_IN,
+                               #SLNETSOCK_POLL_OUT, #SLNETSOCK_POLL_ERR and
+                               #SLNETSOCK_POLL_PUSH, zero removes the socket
+                               from the poll set
+
+    \return                    Zero on success, or negative error code on failure
+
+    \remark     As with SlNetSock_select(), the sockets of a poll set must
+                belong to the same interface.
+    \remark     A closed socket leaves the poll sets it was registered in.
+*/
+int32_t SlNetSock_pollCtl(int16_t pollSd, int16_t sd, uint8_t events);
+
+
+/*!
+    \brief Wait for the sockets of a poll set to become ready
+
+    Readiness already pushed with SlNetSock_pollNotify() is returned at once.
+    Otherwise the interface select is called with the registered sockets,
+    or, when all of them are registered with #SLNETSOCK_POLL_PUSH, the wait
+    blocks until readiness is pushed.
+
+    \param[in]  pollSd         Poll set descriptor from SlNetSock_pollCreate()
+    \param[out] events         Ready sockets
+    \param[in]  maxEvents      Number of entries of @c events
+    \param[in]  timeout        Upper bound on the wait as for
+                               SlNetSock_select(), NULL waits forever
+
+    \return                    Number of ready sockets written to @c events,
+                               zero on timeout, or negative error code on
+                               failure
+
+    \remark     Readiness pushed while the interface select is blocked is
+                returned when the select returns.
+    \remark     Only one thread may wait on a poll set at a time.
+*/
+int32_t SlNetSock_pollWait(int16_t pollSd, SlNetSock_PollEvent_t *events, uint16_t maxEvents, SlNetSock_Timeval_t *timeout);
+
+
+/*!
+    \brief Push readiness of a socket to the poll sets registered for it
+
+    \param[in] sd              Socket handle
+    \param[in] events          Bitwise OR of SLNETSOCK_POLL_ events,
+                               #SLNETSOCK_POLL_ERR is reported whatever the
+                               registered interest
+
+    \return                    Zero on success, or negative error code on failure
+
+    \sa         SlNetSock_pollNotifyIf()
+*/
+int32_t SlNetSock_pollNotify(int16_t sd, uint8_t events);
+
+
+/*!
+    \brief Push readiness of a socket, given by its interface descriptor
+
+    For the event handlers of an interface, which know its sockets by their
+    real descriptors, e.g. the SimpleLink SimpleLinkSockEventHandler.
+
+    \param[in] ifID            Interface identifier, SLNETIF_ID_
+    \param[in] realSd          Socket descriptor of the interface
+    \param[in] events          Bitwise OR of SLNETSOCK_POLL_ events
+
+    \return                    Zero on success, or negative error code on failure
+*/
+int32_t SlNetSock_pollNotifyIf(uint16_t ifID, int16_t realSd, uint8_t events);
+
+
 /*!
     \brief Set socket options
 
@@ -1666,6 +1801,47 @@ int32_t SlNetSock_sendTo(int16_t sd, const void *buf, uint32_t len, uint32_t fla
 int32_t SlNetSock_getIfID(uint16_t sd);
 
 
+/*!
+    \brief Get the generation of the socket a socket descriptor (sd) names
+
+    The sd of a closed socket is given to the next socket created. The
+    generation of a socket changes each time its sd is reused, so a task
+    that keeps an sd another task may close can take the generation when
+    the socket is created and check it with SlNetSock_checkGeneration()
+    before using the sd again.
+
+    \param[in]  sd          Socket descriptor
+    \param[out] generation  Generation of the socket sd names
+
+    \return                 Zero on success, or negative error code on
+                            failure
+
+    \slnetsock_init_precondition
+
+    \sa         SlNetSock_checkGeneration()
+*/
+int32_t SlNetSock_getGeneration(int16_t sd, uint16_t *generation);
+
+
+/*!
+    \brief Check a socket descriptor (sd) still names the same socket
+
+    \param[in] sd           Socket descriptor
+    \param[in] generation   Generation of the socket, from
+                            SlNetSock_getGeneration()
+
+    \return                 Zero if sd names the socket of that generation,
+                            #SLNETERR_BSD_EBADF if the socket was closed and
+                            sd reused, or another negative error code if sd
+                            is not open
+
+    \slnetsock_init_precondition
+
+    \sa         SlNetSock_getGeneration()
+*/
+int32_t SlNetSock_checkGeneration(int16_t sd, uint16_t generation);
+
+
 /*!
     \brief Creates a security attributes object
 
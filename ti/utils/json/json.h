@@ -360,6 +360,58 @@ int16_t Json_createTemplate(Json_Handle *templateHandle,
  */
 int16_t Json_destroyTemplate(Json_Handle templateHandle);
 
+/*!
+ *  @brief      This function exports a template in its compiled form:
+ *              the internal template, preceded by its property lookup.
+ *
+ *  @param[in]    templateHandle        template handle
+ *  @param[out]   compiledTemplate      buffer for the compiled template,
+ *                                       or @c NULL to query the size
+ *  @param[inout] compiledTemplateLen   on call - buffer size, on return -
+ *                                       compiled template size
+ *
+ *  @remark     Run it once (e.g. on the host) and keep the output as a
+ *              @c const array, to be used by
+ *              Json_createTemplateFromCompiled() without parsing the
+ *              template text or hashing it at run time.
+ *
+ *  @return     Success: #JSON_RC__OK
+ *  @return     Failure: negative error code
+ *
+ *  @sa Json_createTemplateFromCompiled()
+ */
+int16_t Json_getCompiledTemplate(Json_Handle templateHandle,
+    void *compiledTemplate, uint16_t *compiledTemplateLen);
+
+/*!
+ *  @brief      This function creates a template from a compiled template
+ *
+ *  @param[out] templateHandle          template handle
+ *  @param[in]  compiledTemplate        output of Json_getCompiledTemplate()
+ *  @param[in]  compiledTemplateLen     compiled template length
+ *
+ *  @remark     The compiled template is used in place (it may reside in
+ *              flash) and must outlive the template handle.
+ *              Json_destroyTemplate() doesn't free it.
+ *
+ *  @return     Success: #JSON_RC__OK
+ *  @return     Failure: negative error code
+ *
+ *  @par        Example
+ *  @code
+ *  static const uint8_t compiledTemplate[] = { ... };
+ *  Json_Handle templateHandle1;
+ *
+ *  ret = Json_createTemplateFromCompiled(&templateHandle1,
+ *          compiledTemplate, sizeof(compiledTemplate));
+ *  @endcode
+ *
+ *  @sa Json_getCompiledTemplate()
+ *  @sa Json_destroyTemplate()
+ */
+int16_t Json_createTemplateFromCompiled(Json_Handle *templateHandle,
+    const void *compiledTemplate, uint16_t compiledTemplateLen);
+
 /*!
  *  @brief      This function creates an empty Json object
  *
@@ -433,6 +485,77 @@ int16_t Json_destroyObject(Json_Handle objHandle);
  */
 int16_t Json_parse(Json_Handle objHandle, char *jsonText, uint16_t jsonTextLen);
 
+/*!
+ *  @brief This function starts converting a json text that arrives in
+ *         chunks into internal representation
+ *
+ *  @param[in]  objHandle       json object handle
+ *  @param[in]  windowSize      size of the window the chunks go through,
+ *                              or 0 for a 128 bytes window.  It must hold
+ *                              the longest string (with its quotes), number
+ *                              or raw value of the json text
+ *
+ *  @remark     Unlike Json_parse(), the json text doesn't have to be in
+ *              RAM at once, and may be larger than 64KB.  Values are
+ *              stored in the object as soon as they are complete.
+ *
+ *  @return     Success: #JSON_RC__OK
+ *  @return     Failure: negative error code
+ *
+ *  @par        Example
+ *  @code
+ *  uint16_t ret;
+ *
+ *  ret = Json_parseStreamBegin(h, 0);
+ *  while ((ret == JSON_RC__OK) && ((len = recv(sd, chunk, sizeof(chunk), 0)) > 0))
+ *  {
+ *      ret = Json_parseStreamFeed(h, chunk, len);
+ *  }
+ *  ret = Json_parseStreamEnd(h, NULL, NULL);
+ *  @endcode
+ *
+ *  @sa     Json_parseStreamFeed()
+ *  @sa     Json_parseStreamEnd()
+ */
+int16_t Json_parseStreamBegin(Json_Handle objHandle, uint16_t windowSize);
+
+/*!
+ *  @brief This function converts the next chunk of a json text
+ *
+ *  @param[in]  objHandle       json object handle
+ *  @param[in]  jsonChunk       pointer to the chunk, which may be cut
+ *                              anywhere
+ *  @param[in]  jsonChunkLen    chunk size
+ *
+ *  @return     Success: #JSON_RC__OK
+ *  @return     Failure: negative error code.
+ *              #JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED - a token larger
+ *              than the window
+ *
+ *  @sa     Json_parseStreamBegin()
+ */
+int16_t Json_parseStreamFeed(Json_Handle objHandle, const char *jsonChunk,
+        uint16_t jsonChunkLen);
+
+/*!
+ *  @brief This function ends converting a json text that arrived in chunks
+ *
+ *  @param[in]  objHandle       json object handle
+ *  @param[out] jsonTextLen     total json text size, or NULL
+ *  @param[out] peakWindowLen   most of the window ever used, or NULL
+ *
+ *  @remark     jsonTextLen and peakWindowLen tell how much RAM the one-shot
+ *              Json_parse() would have needed for the text, and what the
+ *              window may be cut to for similar texts.
+ *
+ *  @return     Success: #JSON_RC__OK
+ *  @return     Failure: negative error code
+ *
+ *  @sa     Json_parseStreamBegin()
+ */
+int16_t Json_parseStreamEnd(Json_Handle objHandle, uint32_t *jsonTextLen,
+        uint16_t *peakWindowLen);
+
 
 /*!
  *  @brief      Retrieve the number of array elements in the provided key
@@ -108,6 +108,7 @@ typedef enum json_rc_TAG
 /** @cond INTERNAL */
 
 #define JSON_PARSE_FLAGS__ESTIMATE_ONLY             0x80000000u
+#define JSON_PARSE_FLAGS__KEEP_LOOKUP               0x40000000u
 
 /*!
     \brief     External function for initializing internal representation buffer
@@ -145,7 +146,8 @@ json_rc_T __JSON_Init(__O void *   json_internal,
     \param[in]    json_text_size        JSON text string size
     \param[in]    json_template         Buffer containing template describing the JSON.  This function can use either the minimal template or the full template
     \param[in]    json_template_size    Size of template
-    \param[in]    flags                 May be 0 or JSON_PARSE_FLAGS__ESTIMATE_ONLY
+    \param[in]    flags                 May be 0, JSON_PARSE_FLAGS__ESTIMATE_ONLY and/or JSON_PARSE_FLAGS__KEEP_LOOKUP.
+                                        The latter keeps a lookup attached to json_internal by __JSON_AttachLookup()
 
     \sa
     \note
@@ -165,6 +167,109 @@ json_rc_T __JSON_Parse(__O void *   json_internal,
                        _I_ uint16_t json_template_size,
                        _I_ uint32_t flags);
 
+/*!
+    \brief     External function for starting a streaming parse of a JSON text into internal representation
+
+    \return    json_rc_T
+
+    \param[out]   json_stream           Buffer for the parser's state and window.  In case of NULL, just the needed size is returned in json_stream_size
+    \param[inout] json_stream_size      On call - max buffer size.  On return - used buffer size
+    \param[out]   json_internal         Buffer for internal representation of data.  Must stay in place until __JSON_ParseStreamEnd()
+    \param[in]    json_internal_size    Max buffer size
+    \param[in]    json_template         Buffer containing template describing the JSON.  This function can use either the minimal template or the full template
+    \param[in]    json_template_size    Size of template
+    \param[in]    window_size           Size of the window the chunks go through.  Must hold the longest token (a string with its quotes, a number, a raw value)
+    \param[in]    flags                 As for __JSON_Parse()
+
+    \sa
+    \note
+                        The JSON text is then given chunk by chunk to __JSON_ParseStreamFeed(), and
+                        the internal representation is complete after __JSON_ParseStreamEnd().
+                        Values are stored in the internal representation as soon as they are complete,
+                        so the text may be larger than any buffer.
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_ParseStreamBegin(__O void *   json_stream,
+                                  _IO_ uint16_t * json_stream_size,
+                                  __O void *   json_internal,
+                                  _I_ uint16_t json_internal_size,
+                                  _I_ void *   json_template,
+                                  _I_ uint16_t json_template_size,
+                                  _I_ uint16_t window_size,
+                                  _I_ uint32_t flags);
+
+/*!
+    \brief     External function for parsing the next chunk of a streamed JSON text
+
+    \return    json_rc_T
+
+    \param[inout] json_stream           State started by __JSON_ParseStreamBegin()
+    \param[in]    json_text             Chunk of the JSON text.  May be cut anywhere
+    \param[in]    json_text_size        Chunk size
+
+    \sa
+    \note
+                        JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED - a token doesn't fit the window
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_ParseStreamFeed(_IO_ void *   json_stream,
+                                 _I_ char *   json_text,
+                                 _I_ uint16_t json_text_size);
+
+/*!
+    \brief     External function for ending a streaming parse
+
+    \return    json_rc_T
+
+    \param[inout] json_stream           State started by __JSON_ParseStreamBegin()
+    \param[out]   json_internal_size    Used buffer size of the internal representation
+
+    \sa
+    \note
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_ParseStreamEnd(_IO_ void *   json_stream,
+                                __O uint16_t * json_internal_size);
+
+/*!
+    \brief     External function for the statistics of a streaming parse
+
+    \param[in]    json_stream           State started by __JSON_ParseStreamBegin()
+    \param[out]   json_text_size        Total size of the text fed so far, or NULL
+    \param[out]   peak_window_used      Most of the window ever used - what the window could be cut to for similar documents, or NULL
+
+    \sa
+    \note
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+void __JSON_ParseStreamStats(_I_ void *   json_stream,
+                             __O uint32_t * json_text_size,
+                             __O uint16_t * peak_window_used);
+
 /*!
     \brief     External function for building a JSON text-buffer from internal representation
 
@@ -349,6 +454,89 @@ json_rc_T __JSON_Templetize(__O void *      output_template,
                             _I_ char *      partly_templetized_json,
                             _I_ uint16_t partly_templetized_json_size);
 
+/*!
+    \brief     External function for compiling a template's property lookup
+
+    \return    json_rc_T
+
+    \param[out]   json_lookup           Buffer for the lookup.  In case of NULL, just the needed size is returned in json_lookup_size
+    \param[inout] json_lookup_size      On call - max buffer size.  On return - used buffer size
+    \param[in]    json_template         Buffer containing template describing the JSON.  Either the minimal template or the full template
+    \param[in]    json_template_size    Size of template
+
+    \sa
+    \note
+                        The lookup is a perfect hash of all the properties that have no array ancestor.
+                        It depends on the template only, so it may be compiled offline and kept in flash
+                        next to the template (see __JSON_SplitCompiledTemplate()).
+                        JSON_RC__NO_HASH_FOUND - no perfect hash found.  Objects simply work without a lookup then.
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_CompileLookup(__O void *     json_lookup,
+                               _IO_ uint16_t *   json_lookup_size,
+                               _I_ void *     json_template,
+                               _I_ uint16_t json_template_size);
+
+/*!
+    \brief     External function for attaching a compiled lookup to an internal representation
+
+    \return    json_rc_T
+
+    \param[inout] json_internal         Internal representation of data, initialized from the lookup's template
+    \param[out]   json_lookup_cb        Buffer for the per-object part of the lookup.  In case of NULL, just the needed size is returned in json_lookup_cb_size
+    \param[inout] json_lookup_cb_size   On call - max buffer size.  On return - used buffer size
+    \param[in]    json_lookup           Lookup compiled by __JSON_CompileLookup().  NULL detaches
+
+    \sa
+    \note
+                        json_lookup and json_lookup_cb must outlive json_internal.
+                        __JSON_Init() detaches the lookup, __JSON_Parse() too, unless given JSON_PARSE_FLAGS__KEEP_LOOKUP.
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_AttachLookup(_IO_ void *    json_internal,
+                              __O void *    json_lookup_cb,
+                              _IO_ uint16_t *  json_lookup_cb_size,
+                              _I_ void *    json_lookup);
+
+/*!
+    \brief     External function for locating the parts of a compiled template
+
+    \return    json_rc_T
+
+    \param[out]   json_lookup               The lookup, or NULL if the compiled template has none
+    \param[out]   json_template             The template
+    \param[out]   json_template_size        Size of the template
+    \param[in]    compiled_template         An optional lookup, immediately followed by a template
+    \param[in]    compiled_template_size    Size of compiled_template
+
+    \sa
+    \note
+    \warning
+    \par
+    \code
+         //@ TBD code sample
+
+
+    \endcode
+ */
+json_rc_T __JSON_SplitCompiledTemplate(__O const void **  json_lookup,
+                                       __O const void **  json_template,
+                                       __O uint16_t *       json_template_size,
+                                       _I_ void *        compiled_template,
+                                       _I_ uint16_t compiled_template_size);
+
 /** @endcond */
 
 /*! @} */
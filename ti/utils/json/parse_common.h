@@ -52,8 +52,16 @@ extern "C" {
 #define JSON_DATA_MASK__DATA_TYPE               0xF000u
 #define JSON_DATA_TYPE__TEMPLATE                0x1000u /*@ Full/Minimal template - same or different data-type? */
 #define JSON_DATA_TYPE__INTERNAL_REPRESENTATION 0x2000u
+#define JSON_DATA_TYPE__LOOKUP                  0x3000u
 
 #define JSON_DATA_STRUCTURE_VERSION__TEMPLATE   0x0002u
+#define JSON_DATA_STRUCTURE_VERSION__LOOKUP     0x0001u
+
+#define JSON_LOOKUP__EMPTY_SLOT                 0xFFFFu /* Both hashes of an unused slot.  Never a real key (a property is not its own parent) */
+#define JSON_LOOKUP__NO_OFFSET                  0xFFFFu
+#define JSON_LOOKUP__MAX_BUCKET_SIZE            16u
+#define JSON_LOOKUP__MAX_DISPLACEMENT           0x0FFFu
+#define JSON_LOOKUP__ROOT_PARENT(root_hash)     ((uint16_t)~(root_hash))
 
 #define JSON_VALUE__TRUE                        0x0001u
 #define JSON_VALUE__FALSE                       0x0000u
@@ -166,6 +174,52 @@ typedef struct json_template_TAG
     /*******************************************************************************/
 } json_template_T;
 
+/*******************************************************************************/
+/* Perfect hash over the properties of a template that have no array ancestor  */
+/* (hash and displace).  A key is (propertyHash, parentHash), the root's       */
+/* parent being JSON_LOOKUP__ROOT_PARENT.  Keys don't depend on the layout of  */
+/* the table, so a lookup compiled from a template may be kept in flash and    */
+/* shared by all of its objects.                                               */
+/*******************************************************************************/
+typedef struct json_lookup_header_TAG
+{
+    uint16_t version;
+    uint16_t templateTableSize;     /* propertyTableSize of the template it was compiled from */
+    uint16_t bucketsCount;          /* Power of 2 */
+    uint16_t slotsCount;            /* Power of 2 */
+} json_lookup_header_T;
+
+typedef struct json_lookup_key_TAG
+{
+    uint16_t propertyHash;
+    uint16_t parentHash;
+} json_lookup_key_T;
+
+typedef struct json_lookup_TAG
+{
+    json_lookup_header_T header;
+
+    /***************************************************************/
+    /* Then - A displacement per bucket     (uint16_t)             */
+    /* Then - A key per slot                (json_lookup_key_T)    */
+    /***************************************************************/
+} json_lookup_T;
+
+/*******************************************************************************/
+/* Per-object part of the lookup:  Where each slot's property currently sits.  */
+/* Arrays grow inside the internal representation, so the offsets are re-taken */
+/* whenever propertyTableSize no longer matches.                               */
+/*******************************************************************************/
+typedef struct json_lookup_cb_TAG
+{
+    const json_lookup_header_T *lookup;
+    uint16_t propertyTableSize;     /* Of the internal representation the offsets were taken from.  0 - stale */
+
+    /***************************************************************************/
+    /* Then - An offset into the property table per slot  (uint16_t)           */
+    /***************************************************************************/
+} json_lookup_cb_T;
+
 typedef struct json_internal_header_TAG
 {
     uint16_t version;
@@ -173,6 +227,7 @@ typedef struct json_internal_header_TAG
     uint16_t propertyTableSize;
     uint16_t maximumSize;
     uint16_t currentSize;
+    json_lookup_cb_T *lookupCb;     /* NULL - no lookup, walk the table */
 } json_internal_header_T;
 
 typedef struct json_internal_TAG
@@ -315,6 +370,24 @@ json_rc_T ParseCommon(_I_ parse_pass_T parse_pass_type,
                       _I_ char *input_text,               /* JSON OR partly templetized JSON */
                       _I_ uint16_t input_text_size);
 
+json_rc_T ParseStreamBegin(__O void *stream_buf,
+                           _IO_ uint16_t *stream_buf_size,     /* NULL stream_buf - just the needed size */
+                           _IO_ void *json_internal,           /* Already initialized by __JSON_Init() */
+                           _I_ uint16_t json_internal_size,
+                           _I_ uint16_t window_size,           /* Must hold the longest token */
+                           _I_ parse_pass_T parse_pass_type);
+
+json_rc_T ParseStreamFeed(_IO_ void *stream_buf,
+                          _I_ char *input_text,
+                          _I_ uint16_t input_text_size);
+
+json_rc_T ParseStreamEnd(_IO_ void *stream_buf,
+                         __O uint16_t *json_internal_size);
+
+void ParseStreamStats(_I_ void *stream_buf,
+                      __O uint32_t *text_size,
+                      __O uint16_t *peak_window_used);
+
 #ifdef __cplusplus
 }
 #endif
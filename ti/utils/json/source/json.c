@@ -36,6 +36,9 @@ typedef struct
 {
     char *  data;
     uint16_t len;
+    char *  lookup;         /* Perfect hash of the properties, NULL if none */
+    uint16_t lookupLen;
+    bool    isCompiled;     /* data and lookup belong to the caller (Json_createTemplateFromCompiled) */
     uint32_t validNum;
 }JSON_templateInternal;
 
@@ -45,6 +48,9 @@ typedef struct
     uint16_t jsonInternalSize;
     uint16_t jsonInternalSizeMAX;
     JSON_templateInternal *jsonTemplate;
+    char *  lookupCb;       /* Per-object part of the template's lookup, NULL if none */
+    char *  parseStream;    /* Streaming parse in progress, NULL if none */
+    uint8_t parseStreamWrap;
     uint32_t validNum;
 }JSON_objectInternal;
 
@@ -53,6 +59,15 @@ typedef struct
 #define VALIDATION_NUMBER                       (0xDEADFACE)
 
 #define ARRAY_TO_OBJ_EXTRA_CHARS_NUM            (6)
+#define ARRAY_TO_OBJ_PREFIX                     "{\"#\":"
+#define ARRAY_TO_OBJ_SUFFIX                     "}"
+
+/* Whether a streamed Json array is converted to an object (see Json_parse) - known at the first non-white space */
+#define PARSE_STREAM_WRAP_UNKNOWN               (0)
+#define PARSE_STREAM_WRAP_NONE                  (1)
+#define PARSE_STREAM_WRAP_ARRAY                 (2)
+
+#define PARSE_STREAM_DEFAULT_WINDOW_SIZE        (128u)
 
 extern int sprintf(char *str, const char *format, ...);
 
@@ -70,6 +85,56 @@ static void skipWS(char **input_text, uint16_t *length)
     *input_text += position;
 }
 
+/* Utility function - Compile the template's property lookup.  Failing is not an error: the properties are then searched linearly */
+static void compileLookup(JSON_templateInternal *pInternalTemplate)
+{
+    uint16_t lookupLen = 0;
+
+    pInternalTemplate->lookup = NULL;
+    pInternalTemplate->lookupLen = 0;
+
+    if (__JSON_CompileLookup(NULL, &lookupLen, pInternalTemplate->data, pInternalTemplate->len) == JSON_RC__OK)
+    {
+        pInternalTemplate->lookup = (char *)malloc(lookupLen);
+        if (pInternalTemplate->lookup != NULL)
+        {
+            if (__JSON_CompileLookup(pInternalTemplate->lookup, &lookupLen, pInternalTemplate->data, pInternalTemplate->len) == JSON_RC__OK)
+            {
+                pInternalTemplate->lookupLen = lookupLen;
+            }
+            else
+            {
+                free(pInternalTemplate->lookup);
+                pInternalTemplate->lookup = NULL;
+            }
+        }
+    }
+}
+
+/* Utility function - Attach the template's lookup to a freshly initialized object.  Without memory, the object just goes without it */
+static void attachLookup(JSON_objectInternal *jsonObject)
+{
+    uint16_t lookupCbLen = 0;
+
+    jsonObject->lookupCb = NULL;
+
+    if (jsonObject->jsonTemplate->lookup != NULL)
+    {
+        if (__JSON_AttachLookup(jsonObject->jsonInternal, NULL, &lookupCbLen, jsonObject->jsonTemplate->lookup) == JSON_RC__OK)
+        {
+            jsonObject->lookupCb = (char *)malloc(lookupCbLen);
+            if (jsonObject->lookupCb != NULL)
+            {
+                if (__JSON_AttachLookup(jsonObject->jsonInternal, jsonObject->lookupCb, &lookupCbLen, jsonObject->jsonTemplate->lookup) != JSON_RC__OK)
+                {
+                    free(jsonObject->lookupCb);
+                    jsonObject->lookupCb = NULL;
+                }
+            }
+        }
+    }
+}
+
 int16_t Json_createTemplate(Json_Handle *templateHandle,
         const char *templateString, uint16_t templateStringLen)
 {
@@ -88,6 +153,8 @@ int16_t Json_createTemplate(Json_Handle *templateHandle,
             rcode = __JSON_Templetize (pInternalTemplate->data, &pInternalTemplate->len, &minimalTemplateSize, templateString, templateStringLen);
             if (rcode == JSON_RC__OK)
             {
+                pInternalTemplate->isCompiled = false;
+                compileLookup(pInternalTemplate);
                 /* Setting the validNum with validation number to validate the Json_Handle */
                 pInternalTemplate->validNum = VALIDATION_NUMBER;
                 /* Returning the template handle we created */
@@ -117,11 +184,17 @@ int16_t Json_destroyTemplate(Json_Handle templateHandle)
     {
         JSON_templateInternal *pInternalTemplate = (JSON_templateInternal *)templateHandle;
 
-        free(pInternalTemplate->data);
+        if (!pInternalTemplate->isCompiled)
+        {
+            free(pInternalTemplate->data);
+            free(pInternalTemplate->lookup);
+        }
 
         /* pessimistically clear the template's state before freeing it */
         pInternalTemplate->data = NULL;
         pInternalTemplate->len = 0;
+        pInternalTemplate->lookup = NULL;
+        pInternalTemplate->lookupLen = 0;
         /* initialize magic number to 0 */
         pInternalTemplate->validNum = 0;
 
@@ -132,6 +205,71 @@ int16_t Json_destroyTemplate(Json_Handle templateHandle)
     return(JSON_RC__INVALID_TEMPLATE_HANDLE);
 }
 
+int16_t Json_createTemplateFromCompiled(Json_Handle *templateHandle,
+        const void *compiledTemplate, uint16_t compiledTemplateLen)
+{
+    json_rc_T rcode;
+    const void *lookup;
+    const void *data;
+    uint16_t len;
+    JSON_templateInternal *pInternalTemplate;
+
+    rcode = __JSON_SplitCompiledTemplate(&lookup, &data, &len, compiledTemplate, compiledTemplateLen);
+    if (rcode != JSON_RC__OK)
+    {
+        return(rcode);
+    }
+
+    pInternalTemplate = (JSON_templateInternal *)(malloc(sizeof(JSON_templateInternal)));
+    if (pInternalTemplate)
+    {
+        /* The compiled template is used in place - typically in flash */
+        pInternalTemplate->data = (char *)data;
+        pInternalTemplate->len = len;
+        pInternalTemplate->lookup = (char *)lookup;
+        pInternalTemplate->lookupLen = (lookup != NULL) ? (uint16_t)(compiledTemplateLen - len) : 0;
+        pInternalTemplate->isCompiled = true;
+        /* Setting the validNum with validation number to validate the Json_Handle */
+        pInternalTemplate->validNum = VALIDATION_NUMBER;
+        /* Returning the template handle we created */
+        *templateHandle = (Json_Handle)pInternalTemplate;
+        return(JSON_RC__OK);
+    }
+    return(JSON_RC__MEMORY_ALLOCATION_ERROR);
+}
+
+int16_t Json_getCompiledTemplate(Json_Handle templateHandle,
+        void *compiledTemplate, uint16_t *compiledTemplateLen)
+{
+    /* Validating template handle */
+    if ((templateHandle != 0) && (((JSON_templateInternal *)templateHandle)->validNum == VALIDATION_NUMBER))
+    {
+        JSON_templateInternal *pInternalTemplate = (JSON_templateInternal *)templateHandle;
+        uint32_t len = (uint32_t)pInternalTemplate->lookupLen + pInternalTemplate->len;
+
+        if (len > 0xFFFFu)
+        {
+            return(JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+        }
+        if (compiledTemplate != NULL)
+        {
+            if (*compiledTemplateLen < len)
+            {
+                return(JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+            }
+            /* The lookup goes first, so that the template part needs no length of its own */
+            if (pInternalTemplate->lookup != NULL)
+            {
+                memcpy(compiledTemplate, pInternalTemplate->lookup, pInternalTemplate->lookupLen);
+            }
+            memcpy((char *)compiledTemplate + pInternalTemplate->lookupLen, pInternalTemplate->data, pInternalTemplate->len);
+        }
+        *compiledTemplateLen = (uint16_t)len;
+        return(JSON_RC__OK);
+    }
+    return(JSON_RC__INVALID_TEMPLATE_HANDLE);
+}
+
 int16_t Json_createObject(Json_Handle *objHandle, Json_Handle templateHandle,
         uint16_t maxObjectSize)
 {
@@ -152,6 +290,7 @@ int16_t Json_createObject(Json_Handle *objHandle, Json_Handle templateHandle,
         {
             jsonObject->jsonInternal = (char * )(malloc(maxObjectSize));
             jsonObject->jsonInternalSizeMAX = maxObjectSize;
+            jsonObject->parseStream = NULL;
             /* Setting the validNum with validation number to validate the handle */
             jsonObject->validNum = VALIDATION_NUMBER;
             jsonObject->jsonTemplate = (JSON_templateInternal *)templateHandle;
@@ -162,6 +301,7 @@ int16_t Json_createObject(Json_Handle *objHandle, Json_Handle templateHandle,
             if (rcode == JSON_RC__OK)
             {
                 jsonObject->jsonInternalSize = internalInitBuffSize;
+                attachLookup(jsonObject);
                 /* Returning the Json object handle we created */
                 *objHandle = (Json_Handle)jsonObject;
             }
@@ -186,6 +326,8 @@ int16_t Json_destroyObject(Json_Handle objHandle)
     {
         JSON_objectInternal * pJsonInternal = (JSON_objectInternal *)objHandle;
         free(pJsonInternal->jsonInternal);
+        free(pJsonInternal->lookupCb);
+        free(pJsonInternal->parseStream);
         /* initialize the validation number to 0 */
         pJsonInternal->validNum = 0;
         free(pJsonInternal);
@@ -232,7 +374,7 @@ int16_t Json_parse(Json_Handle objHandle, char *jsonText, uint16_t jsonTextLen)
             }
 
             /* Parsing the json text and filling the internal lib representation */
-            rcode = __JSON_Parse(pJsonInfo->jsonInternal,&jsonInternalBuffSize,jsonText,jsonTextLen,pJsonInfo->jsonTemplate->data ,pJsonInfo->jsonTemplate->len , 0);
+            rcode = __JSON_Parse(pJsonInfo->jsonInternal,&jsonInternalBuffSize,jsonText,jsonTextLen,pJsonInfo->jsonTemplate->data ,pJsonInfo->jsonTemplate->len , JSON_PARSE_FLAGS__KEEP_LOOKUP);
 
             if (ArrayToObj != NULL)
             {
@@ -255,6 +397,134 @@ int16_t Json_parse(Json_Handle objHandle, char *jsonText, uint16_t jsonTextLen)
     return(JSON_RC__INVALID_OBJECT_HANDLE);
 }
 
+int16_t Json_parseStreamBegin(Json_Handle objHandle, uint16_t windowSize)
+{
+    json_rc_T rcode;
+    /* Validating object handle */
+    if ((objHandle != 0) && (((JSON_objectInternal *)objHandle)->validNum == VALIDATION_NUMBER))
+    {
+        JSON_objectInternal *pJsonInfo = (JSON_objectInternal *) objHandle;
+        /* Validating that the template pointer in the Json object is valid */
+        if (pJsonInfo->jsonTemplate->validNum == VALIDATION_NUMBER)
+        {
+            uint16_t streamSize = 0;
+
+            if (windowSize == 0)
+            {
+                windowSize = PARSE_STREAM_DEFAULT_WINDOW_SIZE;
+            }
+            /* A stream left unfinished is simply dropped */
+            free(pJsonInfo->parseStream);
+            pJsonInfo->parseStream = NULL;
+
+            rcode = __JSON_ParseStreamBegin(NULL, &streamSize, NULL, 0, NULL, 0, windowSize, 0);
+            if (rcode != JSON_RC__OK)
+            {
+                return(rcode);
+            }
+            pJsonInfo->parseStream = (char *)malloc(streamSize);
+            if (pJsonInfo->parseStream == NULL)
+            {
+                return(JSON_RC__MEMORY_ALLOCATION_ERROR);
+            }
+            pJsonInfo->parseStreamWrap = PARSE_STREAM_WRAP_UNKNOWN;
+
+            rcode = __JSON_ParseStreamBegin(pJsonInfo->parseStream, &streamSize, pJsonInfo->jsonInternal, pJsonInfo->jsonInternalSizeMAX,
+                    pJsonInfo->jsonTemplate->data, pJsonInfo->jsonTemplate->len, windowSize, JSON_PARSE_FLAGS__KEEP_LOOKUP);
+            if (rcode != JSON_RC__OK)
+            {
+                free(pJsonInfo->parseStream);
+                pJsonInfo->parseStream = NULL;
+            }
+            return(rcode);
+        }
+        return(JSON_RC__INVALID_TEMPLATE_HANDLE);
+    }
+    return(JSON_RC__INVALID_OBJECT_HANDLE);
+}
+
+int16_t Json_parseStreamFeed(Json_Handle objHandle, const char *jsonChunk, uint16_t jsonChunkLen)
+{
+    json_rc_T rcode;
+    /* Validating object handle */
+    if ((objHandle != 0) && (((JSON_objectInternal *)objHandle)->validNum == VALIDATION_NUMBER))
+    {
+        JSON_objectInternal *pJsonInfo = (JSON_objectInternal *) objHandle;
+
+        if (pJsonInfo->parseStream == NULL)
+        {
+            return(JSON_RC__INVALID_OBJECT_HANDLE);
+        }
+        if (pJsonInfo->parseStreamWrap == PARSE_STREAM_WRAP_UNKNOWN)
+        {
+            /* In case the jsonChunk contains white spaces at the beginning, skip it */
+            skipWS ((char **)&jsonChunk, &jsonChunkLen);
+            if (jsonChunkLen == 0)
+            {
+                return(JSON_RC__OK);
+            }
+            /* As Json_parse does, convert a Json array to be a value of an object name "#" */
+            if (jsonChunk[0] == '[')
+            {
+                pJsonInfo->parseStreamWrap = PARSE_STREAM_WRAP_ARRAY;
+                rcode = __JSON_ParseStreamFeed(pJsonInfo->parseStream, ARRAY_TO_OBJ_PREFIX, sizeof(ARRAY_TO_OBJ_PREFIX) - 1);
+                if (rcode < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+                {
+                    return(rcode);
+                }
+            }
+            else
+            {
+                pJsonInfo->parseStreamWrap = PARSE_STREAM_WRAP_NONE;
+            }
+        }
+        rcode = __JSON_ParseStreamFeed(pJsonInfo->parseStream, jsonChunk, jsonChunkLen);
+        if (rcode > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+        {
+            return(JSON_RC__OK);
+        }
+        return(rcode);
+    }
+    return(JSON_RC__INVALID_OBJECT_HANDLE);
+}
+
+int16_t Json_parseStreamEnd(Json_Handle objHandle, uint32_t *jsonTextLen, uint16_t *peakWindowLen)
+{
+    json_rc_T rcode = JSON_RC__OK;
+    /* Validating object handle */
+    if ((objHandle != 0) && (((JSON_objectInternal *)objHandle)->validNum == VALIDATION_NUMBER))
+    {
+        JSON_objectInternal *pJsonInfo = (JSON_objectInternal *) objHandle;
+        uint16_t jsonInternalBuffSize;
+
+        if (pJsonInfo->parseStream == NULL)
+        {
+            return(JSON_RC__INVALID_OBJECT_HANDLE);
+        }
+        if (pJsonInfo->parseStreamWrap == PARSE_STREAM_WRAP_ARRAY)
+        {
+            rcode = __JSON_ParseStreamFeed(pJsonInfo->parseStream, ARRAY_TO_OBJ_SUFFIX, sizeof(ARRAY_TO_OBJ_SUFFIX) - 1);
+        }
+        if (rcode > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+        {
+            rcode = __JSON_ParseStreamEnd(pJsonInfo->parseStream, &jsonInternalBuffSize);
+        }
+        /* Optional statistics - to size the window, and compare against a one-shot Json_parse */
+        __JSON_ParseStreamStats(pJsonInfo->parseStream, jsonTextLen, peakWindowLen);
+        free(pJsonInfo->parseStream);
+        pJsonInfo->parseStream = NULL;
+
+        if (rcode > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+        {
+            /* Update current json internal representation size */
+            pJsonInfo->jsonInternalSize = jsonInternalBuffSize;
+            return(JSON_RC__OK);
+        }
+        return(rcode);
+    }
+    return(JSON_RC__INVALID_OBJECT_HANDLE);
+}
+
 int16_t Json_getArrayMembersCount(Json_Handle objHandle, const char *pKey)
 {
     json_rc_T rcode;
@@ -335,6 +335,37 @@ json_rc_T __JSON_Init(__O void *   json_internal,
     return (rc);
 }
 
+/*****************************************************************************/
+static json_rc_T InitForParse(__O void *   json_internal,
+                              _I_ uint16_t json_internal_size,
+                              _I_ void *   json_template,
+                              _I_ uint16_t json_template_size,
+                              _I_ uint32_t flags)
+{
+    uint16_t minimal_internal_size = json_internal_size;
+    json_lookup_cb_T *  lookup_cb = NULL;
+    json_rc_T rc;
+
+    if((flags & JSON_PARSE_FLAGS__KEEP_LOOKUP)  &&  (json_internal != NULL))
+    {
+        lookup_cb = ((json_internal_header_T *)json_internal)->lookupCb;
+    }
+
+    rc = __JSON_Init (json_internal,
+                      &minimal_internal_size,
+                      json_template,
+                      json_template_size);
+
+    if((rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)  &&  (lookup_cb != NULL))
+    {
+        lookup_cb->propertyTableSize = 0u;      /* Offsets are re-taken on first use */
+
+        ((json_internal_header_T *)json_internal)->lookupCb = lookup_cb;
+    }
+
+    return (rc);
+}
+
 /*****************************************************************************/
 json_rc_T __JSON_Parse(__O void *   json_internal,
                        _IO_ uint16_t * json_internal_size,
@@ -345,13 +376,13 @@ json_rc_T __JSON_Parse(__O void *   json_internal,
                        _I_ uint32_t flags)
 {
     parse_pass_T parse_pass_type;
-    uint16_t minimal_internal_size = *json_internal_size;
     json_rc_T rc;
 
-    rc = __JSON_Init (json_internal,
-                      &minimal_internal_size,
-                      json_template,
-                      json_template_size);
+    rc = InitForParse (json_internal,
+                       *json_internal_size,
+                       json_template,
+                       json_template_size,
+                       flags);
 
     if(rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
     {
@@ -374,6 +405,73 @@ json_rc_T __JSON_Parse(__O void *   json_internal,
     return (rc);
 }
 
+/*****************************************************************************/
+json_rc_T __JSON_ParseStreamBegin(__O void *   json_stream,
+                                  _IO_ uint16_t * json_stream_size,
+                                  __O void *   json_internal,
+                                  _I_ uint16_t json_internal_size,
+                                  _I_ void *   json_template,
+                                  _I_ uint16_t json_template_size,
+                                  _I_ uint16_t window_size,
+                                  _I_ uint32_t flags)
+{
+    parse_pass_T parse_pass_type;
+    json_rc_T rc = JSON_RC__OK;
+
+    if(flags & JSON_PARSE_FLAGS__ESTIMATE_ONLY)
+    {
+        parse_pass_type = PARSE_PASS__JSON_ESTIMATE_ONLY;
+    }
+    else
+    {
+        parse_pass_type = PARSE_PASS__JSON;
+    }
+
+    if(json_stream != NULL)
+    {
+        rc = InitForParse (json_internal,
+                           json_internal_size,
+                           json_template,
+                           json_template_size,
+                           flags);
+    }
+
+    if(rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+    {
+        rc = ParseStreamBegin (json_stream,
+                               json_stream_size,
+                               json_internal,
+                               json_internal_size,
+                               window_size,
+                               parse_pass_type);
+    }
+
+    return (rc);
+}
+
+/*****************************************************************************/
+json_rc_T __JSON_ParseStreamFeed(_IO_ void *   json_stream,
+                                 _I_ char *   json_text,
+                                 _I_ uint16_t json_text_size)
+{
+    return (ParseStreamFeed (json_stream, json_text, json_text_size));
+}
+
+/*****************************************************************************/
+json_rc_T __JSON_ParseStreamEnd(_IO_ void *   json_stream,
+                                __O uint16_t * json_internal_size)
+{
+    return (ParseStreamEnd (json_stream, json_internal_size));
+}
+
+/*****************************************************************************/
+void __JSON_ParseStreamStats(_I_ void *   json_stream,
+                             __O uint32_t * json_text_size,
+                             __O uint16_t * peak_window_used)
+{
+    ParseStreamStats (json_stream, json_text_size, peak_window_used);
+}
+
 /*****************************************************************************/
 static _INLINE_ json_rc_T EmitCharacter(_IO_ io_data_stream_cb_T *  output,
                                         _I_ char character_to_emit)
@@ -1639,6 +1737,68 @@ json_rc_T SetValueInProperty(
     return (rc);
 }
 
+/*****************************************************************************/
+json_rc_T __JSON_AttachLookup(_IO_ void *    json_internal,
+                              __O void *    json_lookup_cb,
+                              _IO_ uint16_t *  json_lookup_cb_size,
+                              _I_ void *    json_lookup)
+{
+    json_internal_header_T *      json_header =
+        (json_internal_header_T *)json_internal;
+    const json_lookup_header_T *  lookup =
+        (const json_lookup_header_T *)json_lookup;
+    json_lookup_cb_T *            lookup_cb =
+        (json_lookup_cb_T *)json_lookup_cb;
+    uint16_t lookup_cb_size;
+
+    if(lookup == NULL)
+    {
+        if(json_header != NULL)
+        {
+            json_header->lookupCb = NULL;
+        }
+
+        *json_lookup_cb_size = 0u;
+
+        return (JSON_RC__OK);
+    }
+
+    if((lookup->version & JSON_DATA_MASK__DATA_TYPE) != JSON_DATA_TYPE__LOOKUP)
+    {
+        return (JSON_RC__NOT_SUPPORTED);
+    }
+
+    lookup_cb_size = (uint16_t)(sizeof(*lookup_cb)
+                                + lookup->slotsCount * sizeof(uint16_t));
+
+    if((lookup_cb == NULL)  ||  (json_header == NULL))
+    {
+        *json_lookup_cb_size = lookup_cb_size;
+
+        return (JSON_RC__OK);
+    }
+
+    if(*json_lookup_cb_size < lookup_cb_size)
+    {
+        return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+    }
+
+    if((json_header->version & JSON_DATA_MASK__DATA_TYPE) !=
+       JSON_DATA_TYPE__INTERNAL_REPRESENTATION)
+    {
+        return (JSON_RC__NOT_SUPPORTED);
+    }
+
+    lookup_cb->lookup = lookup;
+    lookup_cb->propertyTableSize = 0u;
+
+    json_header->lookupCb = lookup_cb;
+
+    *json_lookup_cb_size = lookup_cb_size;
+
+    return (JSON_RC__OK);
+}
+
 /*****************************************************************************/
 #endif /* defined(ALLOW_PARSING__JSON) */
 /*****************************************************************************/
@@ -1755,3 +1915,286 @@ json_rc_T __JSON_Templetize(__O void *     output_template,
 }
 
 #endif /* defined(ALLOW_PARSING__TEMPLATE) */
+
+/*****************************************************************************/
+/* Hash-and-displace:  Keys are spread into buckets, and each bucket - the   */
+/* largest first - gets the first displacement that drops all of its keys    */
+/* into free slots.  Done once per template, so simplicity beats speed.      */
+/*****************************************************************************/
+static json_rc_T PlaceLookupBucket(_IO_ json_lookup_header_T *  lookup,
+                                   _I_ json_template_header_T * template_header,
+                                   _I_ uint16_t bucket)
+{
+    uint16_t *                displacements = (uint16_t *)(lookup + 1);
+    json_lookup_key_T *     keys =
+        (json_lookup_key_T *)(displacements + lookup->bucketsCount);
+    json_lookup_key_T bucket_keys[JSON_LOOKUP__MAX_BUCKET_SIZE];
+    uint16_t bucket_slots[JSON_LOOKUP__MAX_BUCKET_SIZE];
+    uint16_t bucket_size = 0;
+    uint16_t displacement;
+    uint16_t i;
+    uint16_t j;
+    bool fits = false;
+    lookup_walker_T walker;
+    json_lookup_key_T key;
+    uint16_t entry_offset;
+    json_rc_T rc;
+
+    LookupWalkerInit (&walker,
+                      (const uint8_t *)(template_header + 1),
+                      template_header->propertyTableSize,
+                      true);
+
+    while((rc = LookupWalkerNext (&walker, &key, &entry_offset)) == JSON_RC__OK)
+    {
+        if(LookupHash (&key, 0, lookup->bucketsCount - 1u) == bucket)
+        {
+            if(bucket_size >= JSON_LOOKUP__MAX_BUCKET_SIZE)
+            {
+                return (JSON_RC__NO_HASH_FOUND);
+            }
+
+            bucket_keys[bucket_size++] = key;
+        }
+    }
+
+    if(rc != JSON_RC__NOT_FOUND)
+    {
+        return (rc);
+    }
+
+    for(displacement = 1;
+        (displacement <= JSON_LOOKUP__MAX_DISPLACEMENT)  &&  (!fits);
+        displacement++)
+    {
+        fits = true;
+
+        for(i = 0; (i < bucket_size)  &&  fits; i++)
+        {
+            bucket_slots[i] = LookupHash (&bucket_keys[i],
+                                          displacement,
+                                          lookup->slotsCount - 1u);
+
+            if((keys[bucket_slots[i]].propertyHash != JSON_LOOKUP__EMPTY_SLOT)  ||
+               (keys[bucket_slots[i]].parentHash != JSON_LOOKUP__EMPTY_SLOT))
+            {
+                fits = false;
+            }
+
+            for(j = 0; (j < i)  &&  fits; j++)
+            {
+                if(bucket_slots[j] == bucket_slots[i])
+                {
+                    fits = false;
+                }
+            }
+        }
+
+        if(fits)
+        {
+            for(i = 0; i < bucket_size; i++)
+            {
+                keys[bucket_slots[i]] = bucket_keys[i];
+            }
+
+            displacements[bucket] = displacement;
+        }
+    }
+
+    if(!fits)
+    {
+        return (JSON_RC__NO_HASH_FOUND);
+    }
+
+    return (JSON_RC__OK);
+}
+
+/*****************************************************************************/
+json_rc_T __JSON_CompileLookup(__O void *     json_lookup,
+                               _IO_ uint16_t *   json_lookup_size,
+                               _I_ void *     json_template,
+                               _I_ uint16_t json_template_size)
+{
+    const json_template_header_T *  template_header =
+        (const json_template_header_T *)json_template;
+    json_lookup_header_T *          lookup =
+        (json_lookup_header_T *)json_lookup;
+    json_lookup_header_T lookup_header;
+    uint16_t *                        displacements;
+    json_lookup_key_T *             keys;
+    lookup_walker_T walker;
+    json_lookup_key_T key;
+    uint16_t entry_offset;
+    uint16_t keys_count = 0;
+    uint16_t bucket_size;
+    uint16_t bucket;
+    uint32_t size;
+    json_rc_T rc;
+
+    if((json_template_size < sizeof(*template_header))  ||
+       ((template_header->version & JSON_DATA_MASK__DATA_TYPE) !=
+        JSON_DATA_TYPE__TEMPLATE)  ||
+       (template_header->propertyTableSize >
+        json_template_size - sizeof(*template_header)))
+    {
+        return (JSON_RC__BUILDING_PARSED_DATA_EXHAUSTED);
+    }
+
+    LookupWalkerInit (&walker,
+                      (const uint8_t *)(template_header + 1),
+                      template_header->propertyTableSize,
+                      true);
+
+    while((rc = LookupWalkerNext (&walker, &key, &entry_offset)) == JSON_RC__OK)
+    {
+        keys_count++;
+    }
+
+    if(rc != JSON_RC__NOT_FOUND)
+    {
+        return (rc);
+    }
+
+    /*************************************************************************/
+    /* Up to 2/3 of the slots are used, about 4 keys per bucket              */
+    /*************************************************************************/
+    lookup_header.version = JSON_DATA_STRUCTURE_VERSION__LOOKUP
+                            | JSON_DATA_TYPE__LOOKUP;
+    lookup_header.templateTableSize = template_header->propertyTableSize;
+    lookup_header.bucketsCount = 1u;
+    lookup_header.slotsCount = 1u;
+
+    while(lookup_header.bucketsCount * 4u < keys_count)
+    {
+        lookup_header.bucketsCount <<= 1;
+    }
+
+    while(lookup_header.slotsCount < keys_count + keys_count / 2u)
+    {
+        lookup_header.slotsCount <<= 1;
+    }
+
+    size = sizeof(lookup_header)
+           + (uint32_t)lookup_header.bucketsCount * sizeof(uint16_t)
+           + (uint32_t)lookup_header.slotsCount * sizeof(json_lookup_key_T);
+
+    if(size > 0xFFFFu)
+    {
+        return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+    }
+
+    if(lookup == NULL)
+    {
+        *json_lookup_size = (uint16_t)size;
+
+        return (JSON_RC__OK);
+    }
+
+    if(*json_lookup_size < size)
+    {
+        return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+    }
+
+    *lookup = lookup_header;
+
+    displacements = (uint16_t *)(lookup + 1);
+    keys = (json_lookup_key_T *)(displacements + lookup->bucketsCount);
+
+    MemSet (displacements, 0, lookup->bucketsCount * sizeof(uint16_t));
+    MemSet (keys, 0xFF, lookup->slotsCount * sizeof(json_lookup_key_T));
+
+    /*************************************************************************/
+    /* Count the keys per bucket into the displacements, then place the      */
+    /* buckets from the largest down.  A placed bucket's displacement gets   */
+    /* the top bit, so it's never taken for a count                          */
+    /*************************************************************************/
+    LookupWalkerInit (&walker,
+                      (const uint8_t *)(template_header + 1),
+                      template_header->propertyTableSize,
+                      true);
+
+    while(LookupWalkerNext (&walker, &key, &entry_offset) == JSON_RC__OK)
+    {
+        displacements[LookupHash (&key, 0, lookup->bucketsCount - 1u)]++;
+    }
+
+    for(bucket_size = keys_count; bucket_size > 0; bucket_size--)
+    {
+        for(bucket = 0; bucket < lookup->bucketsCount; bucket++)
+        {
+            if(displacements[bucket] == bucket_size)
+            {
+                rc = PlaceLookupBucket (lookup, template_header, bucket);
+
+                if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+                {
+                    return (rc);
+                }
+
+                displacements[bucket] |= 0x8000u;
+            }
+        }
+    }
+
+    for(bucket = 0; bucket < lookup->bucketsCount; bucket++)
+    {
+        displacements[bucket] &= (uint16_t)~0x8000u;
+    }
+
+    *json_lookup_size = (uint16_t)size;
+
+    return (JSON_RC__OK);
+}
+
+/*****************************************************************************/
+json_rc_T __JSON_SplitCompiledTemplate(__O const void * *  json_lookup,
+                                       __O const void * *  json_template,
+                                       __O uint16_t *       json_template_size,
+                                       _I_ void *        compiled_template,
+                                       _I_ uint16_t compiled_template_size)
+{
+    const json_lookup_header_T *    lookup =
+        (const json_lookup_header_T *)compiled_template;
+    const json_template_header_T *  template_header;
+    uint16_t lookup_size = 0;
+
+    *json_lookup = NULL;
+
+    if((compiled_template_size >= sizeof(*lookup))  &&
+       ((lookup->version & JSON_DATA_MASK__DATA_TYPE) == JSON_DATA_TYPE__LOOKUP))
+    {
+        lookup_size = LookupSize (lookup);
+
+        if(lookup_size > compiled_template_size)
+        {
+            return (JSON_RC__BUILDING_PARSED_DATA_EXHAUSTED);
+        }
+
+        *json_lookup = lookup;
+    }
+
+    template_header =
+        (const json_template_header_T *)((const uint8_t *)compiled_template +
+                                         lookup_size);
+
+    if(((uint16_t)(compiled_template_size - lookup_size) <
+        sizeof(*template_header))  ||
+       ((template_header->version & JSON_DATA_MASK__DATA_TYPE) !=
+        JSON_DATA_TYPE__TEMPLATE)  ||
+       (template_header->propertyTableSize >
+        compiled_template_size - lookup_size - sizeof(*template_header)))
+    {
+        return (JSON_RC__BUILDING_PARSED_DATA_EXHAUSTED);
+    }
+
+    if((*json_lookup != NULL)  &&
+       (lookup->templateTableSize != template_header->propertyTableSize))
+    {
+        return (JSON_RC__BUILDING_PARSED_DATA_EXHAUSTED);
+    }
+
+    *json_template = template_header;
+    *json_template_size = compiled_template_size - lookup_size;
+
+    return (JSON_RC__OK);
+}
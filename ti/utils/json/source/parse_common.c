@@ -180,6 +180,7 @@ typedef struct sm_state_TAG
     property_in_map_T propertyFromTemplate;
 #endif
     bool bFullParse;
+    uint16_t ignoredLeavesNesting;      /* Non-0 - input ended while ignoring leaves.  Streaming resumes from here */
 } sm_state_T;
 
 #ifdef _MSC_VER
@@ -332,9 +333,10 @@ static _INLINE_ json_rc_T ExpectCharacter(
 
 /*****************************************************************************/
 static _INLINE_ void IgnoreCurrentAndHigherNestingLeaves(
-    _IO_ in_data_stream_cb_T *   input_text)
+    _IO_ in_data_stream_cb_T *   input_text,
+    _IO_ uint16_t *               ignored_leaves_nesting)
 {
-    int32_t nesting_level = 0;
+    int32_t nesting_level = (int32_t)*ignored_leaves_nesting - 1;
 
     while((nesting_level >= 0)
           && (input_text->position < input_text->dataBufSize))
@@ -352,6 +354,98 @@ static _INLINE_ void IgnoreCurrentAndHigherNestingLeaves(
 
         input_text->position++;
     }
+
+    *ignored_leaves_nesting = (uint16_t)(nesting_level + 1);
+}
+
+/*****************************************************************************/
+/* Resolves the array-free head of the branch through the template's lookup, */
+/* so that only the levels under the first array are walked                  */
+/*****************************************************************************/
+static json_rc_T SkipBranchHeadByLookup(
+    __O uint16_t *                        first_nesting_level,
+    __O const uint8_t * *                 property_table_position,
+    __O const uint8_t * *                 end_of_object,
+    _I_ void *                            json_internal,
+    _I_ parser_nesting_cb_T *             parser_nesting,
+    _I_ uint16_t parent_branch_nesting_level,
+    _I_ uint16_t sought_hash)
+{
+    const property_table_entry_T *  property_table_entry = NULL;
+    uint16_t last_nesting_level = 0;
+    uint16_t nesting_level;
+    uint16_t hash;
+    uint16_t parent_hash;
+    json_rc_T rc;
+
+    if(((const json_internal_header_T *)json_internal)->lookupCb == NULL)
+    {
+        return (JSON_RC__OK);
+    }
+
+    while((last_nesting_level <= parent_branch_nesting_level)  &&
+          (!parser_nesting->stack[last_nesting_level].isArray))
+    {
+        ++last_nesting_level;
+    }
+
+    if(last_nesting_level == 0)
+    {
+        return (JSON_RC__OK);
+    }
+
+    for(nesting_level = 0; nesting_level <= last_nesting_level;
+        nesting_level++)
+    {
+        if(nesting_level <= parent_branch_nesting_level)
+        {
+            hash = parser_nesting->stack[nesting_level].hash;
+        }
+        else
+        {
+            hash = sought_hash;
+        }
+
+        if(nesting_level == 0)
+        {
+            parent_hash = JSON_LOOKUP__ROOT_PARENT (hash);
+        }
+        else
+        {
+            parent_hash = parser_nesting->stack[nesting_level - 1].hash;
+        }
+
+        rc = FindPropertyByLookup (&property_table_entry,
+                                   json_internal,
+                                   hash,
+                                   parent_hash);
+
+        if(rc == JSON_RC__NOT_SUPPORTED)
+        {
+            return (JSON_RC__OK);       /* Walk the whole branch */
+        }
+
+        if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+        {
+            return (rc);
+        }
+
+        if((nesting_level < last_nesting_level)  &&
+           IS_SINGLE_VALUE (property_table_entry->common.propertyType))
+        {
+            return (JSON_RC__UNEXPECTED_ERROR);
+        }
+    }
+
+    /*************************************************************************/
+    /* The walk below resumes at the found entry, and matches it right away  */
+    /*************************************************************************/
+    *first_nesting_level = last_nesting_level;
+    *property_table_position = (const uint8_t *)property_table_entry;
+    *end_of_object = *property_table_position +
+                     sizeof(property_table_entry->common);
+
+    return (JSON_RC__OK);
 }
 
 /*****************************************************************************/
@@ -379,6 +473,7 @@ json_rc_T FindPropertyInBranch(
                                                       internal_header->
                                                       propertyTableSize;
     uint16_t nesting_level;
+    uint16_t first_nesting_level = 0;
     bool found_item_in_branch = false;
     uint16_t sought_hash_in_branch;
     uint16_t sought_index_in_branch = 0;
@@ -388,7 +483,20 @@ json_rc_T FindPropertyInBranch(
     *found_array_start = NULL;
     *found_property = NULL;
 
-    for(nesting_level = 0;
+    rc = SkipBranchHeadByLookup (&first_nesting_level,
+                                 &property_table_position,
+                                 &end_of_object,
+                                 json_internal,
+                                 parser_nesting,
+                                 parent_branch_nesting_level,
+                                 sought_hash);
+
+    if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+    {
+        return (rc);
+    }
+
+    for(nesting_level = first_nesting_level;
         (nesting_level <= parent_branch_nesting_level + 1)  &&
         (rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE);
         nesting_level++)
@@ -642,10 +750,12 @@ static _INLINE_ json_rc_T Real_PreAnalyzeNumber(
 
         SkipWhitespace (&input_copy);
 
-        while((input_copy.dataBuf[input_copy.position] == '.')
-              ||
-              ((input_copy.dataBuf[input_copy.position] >= '0')
-               && (input_copy.dataBuf[input_copy.position] <= '9')))
+        while((input_copy.position < input_copy.dataBufSize)
+              &&
+              ((input_copy.dataBuf[input_copy.position] == '.')
+               ||
+               ((input_copy.dataBuf[input_copy.position] >= '0')
+                && (input_copy.dataBuf[input_copy.position] <= '9'))))
         {
             if(input_copy.dataBuf[input_copy.position] == '.')
             {
@@ -733,13 +843,15 @@ static _INLINE_ json_rc_T Real_AnalyzeNumber(
         whole_digits_remaining = 0u;
     }
 
-    while(
+    while((input_text->position < input_text->dataBufSize)
+          &&
+          (
 #ifdef SUPPORT_REAL_NUMBERS
-        (input_text->dataBuf[input_text->position] == '.')
-        ||
+              (input_text->dataBuf[input_text->position] == '.')
+              ||
 #endif
-        ((input_text->dataBuf[input_text->position] >= '0')
-         && (input_text->dataBuf[input_text->position] <= '9')))
+              ((input_text->dataBuf[input_text->position] >= '0')
+               && (input_text->dataBuf[input_text->position] <= '9'))))
     {
 #ifdef SUPPORT_REAL_NUMBERS
         if(input_text->dataBuf[input_text->position] == '.')
@@ -952,15 +1064,17 @@ static _INLINE_ json_rc_T IdentifyAndSkip_LiteralNumber(
         return (rc);
     }
 
-    while((input_text->dataBuf[input_text->position] == 'E')
-          || (input_text->dataBuf[input_text->position] == 'e')
-          || (input_text->dataBuf[input_text->position] == '+')
-          || (input_text->dataBuf[input_text->position] == '-')
-          || (input_text->dataBuf[input_text->position] == '.')
-          || (input_text->dataBuf[input_text->position] <= ' ')/* All whitespace */
-          ||
-          ((input_text->dataBuf[input_text->position] >= '0')
-           && (input_text->dataBuf[input_text->position] <= '9')))
+    while((input_text->position < input_text->dataBufSize)
+          &&
+          ((input_text->dataBuf[input_text->position] == 'E')
+           || (input_text->dataBuf[input_text->position] == 'e')
+           || (input_text->dataBuf[input_text->position] == '+')
+           || (input_text->dataBuf[input_text->position] == '-')
+           || (input_text->dataBuf[input_text->position] == '.')
+           || (input_text->dataBuf[input_text->position] <= ' ')/* All whitespace */
+           ||
+           ((input_text->dataBuf[input_text->position] >= '0')
+            && (input_text->dataBuf[input_text->position] <= '9'))))
     {
         ++input_text->position;/* Skip exponent.  It was already considered  */
     }
@@ -1285,7 +1399,10 @@ static sm_func_rc_T IncreaseNesting_Common(_IO_ sm_state_T *   state)
 {
     if(state->nesting.position + 1 >= JSON_MAXIMUM_NESTING)
     {
-        IgnoreCurrentAndHigherNestingLeaves (&state->input);
+        state->ignoredLeavesNesting = 1u;
+
+        IgnoreCurrentAndHigherNestingLeaves (&state->input,
+                                             &state->ignoredLeavesNesting);
 
         UpdateBestCaseRc (&state->bestCaseRc,
                           JSON_RC__RECOVERED__NESTING_EXCEEDED__IGNORING_LEAVES);
@@ -2581,6 +2698,254 @@ json_rc_T ParseCommon(_I_ parse_pass_T parse_pass_type,
     return (state.bestCaseRc);
 }
 /*****************************************************************************/
+#if defined(ALLOW_PARSING__JSON)
+/*****************************************************************************/
+/* Streaming parse:  The text arrives in chunks, through a window that only  */
+/* has to hold the longest single token.  Tokens are consumed as soon as the */
+/* window holds them entirely - values are copied into the internal          */
+/* representation right away - and the rest is moved to the window's start. */
+/*****************************************************************************/
+#ifdef _MSC_VER
+    #pragma warning(disable:4820) /* bytes padding added after data member */
+#endif
+
+typedef struct parse_stream_cb_TAG
+{
+    sm_state_T state;
+    uint16_t windowSize;
+    uint16_t peakWindowUsed;
+    uint32_t textSize;
+
+    /**********************************/
+    /* Then - The window (windowSize) */
+    /**********************************/
+} parse_stream_cb_T;
+
+#ifdef _MSC_VER
+    #pragma warning(default:4820)
+#endif
+
+/*****************************************************************************/
+static json_rc_T ParseStreamProcess(_IO_ parse_stream_cb_T *   stream,
+                                    _I_ bool is_last_chunk)
+{
+    sm_state_T *    state = &stream->state;
+    uint8_t token;
+    uint16_t token_start;
+    json_rc_T best_case_rc_before_token;
+    sm_func_rc_T transition_rc;
+    json_rc_T rc;
+
+    while((state->stateID != STATE_END)
+          && (state->bestCaseRc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE))
+    {
+        if(state->ignoredLeavesNesting > 0u)
+        {
+            IgnoreCurrentAndHigherNestingLeaves (&state->input,
+                                                 &state->ignoredLeavesNesting);
+
+            if(state->ignoredLeavesNesting > 0u)
+            {
+                break;      /* Ignore the rest with the next chunk */
+            }
+        }
+
+        SkipWhitespace (&state->input);
+
+        if((!is_last_chunk)
+           && (state->input.position == state->input.dataBufSize))
+        {
+            break;
+        }
+
+        token_start = state->input.position;
+        best_case_rc_before_token = state->bestCaseRc;
+
+        rc = IdentifyToken (state, &token);
+
+        /*********************************************************************/
+        /* A token that reaches the end of the window, or fails, may just be */
+        /* cut by the chunk's end:  Re-identify it when more text arrives.   */
+        /* Only the input position and the best-case rc outlive a token -    */
+        /* all else is set anew by the next IdentifyToken().                 */
+        /*********************************************************************/
+        if((!is_last_chunk)
+           && ((rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+               || (state->input.position == state->input.dataBufSize)))
+        {
+            state->input.position = token_start;
+            state->bestCaseRc = best_case_rc_before_token;
+
+            break;
+        }
+
+        if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+        {
+            return (rc);
+        }
+
+        UpdateBestCaseRc (&state->bestCaseRc, rc);
+
+        transition_rc = StateMachineClick (state, token);
+
+        if(transition_rc != SM_TRANSITION__SUCCEEDED)
+        {
+            if(state->bestCaseRc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+            {
+                return (state->bestCaseRc);
+            }
+
+            return (JSON_RC__PARSING_FAILURE);
+        }
+    }
+
+    return (state->bestCaseRc);
+}
+
+/*****************************************************************************/
+json_rc_T ParseStreamBegin(__O void *        stream_buf,
+                           _IO_ uint16_t *      stream_buf_size,
+                           _IO_ void *        json_internal,
+                           _I_ uint16_t json_internal_size,
+                           _I_ uint16_t window_size,
+                           _I_ parse_pass_T parse_pass_type)
+{
+    parse_stream_cb_T *   stream = (parse_stream_cb_T *)stream_buf;
+    uint32_t needed_size = sizeof(*stream) + (uint32_t)window_size;
+
+    if((needed_size > 0xFFFFu)  ||  (window_size == 0u))
+    {
+        return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+    }
+
+    if(stream == NULL)
+    {
+        *stream_buf_size = (uint16_t)needed_size;
+
+        return (JSON_RC__OK);
+    }
+
+    if((*stream_buf_size < needed_size)  ||
+       (json_internal_size < sizeof(json_internal_header_T)))
+    {
+        return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);
+    }
+
+    InitializeState (&stream->state,
+                     json_internal,
+                     json_internal_size,
+                     (const char *)(stream + 1),
+                     0u,
+                     parse_pass_type);
+
+    stream->windowSize = window_size;
+    stream->peakWindowUsed = 0u;
+    stream->textSize = 0uL;
+
+    *stream_buf_size = (uint16_t)needed_size;
+
+    return (JSON_RC__OK);
+}
+
+/*****************************************************************************/
+json_rc_T ParseStreamFeed(_IO_ void *    stream_buf,
+                          _I_ char *    input_text,
+                          _I_ uint16_t input_text_size)
+{
+    parse_stream_cb_T *   stream = (parse_stream_cb_T *)stream_buf;
+    sm_state_T *          state = &stream->state;
+    uint8_t *               window = (uint8_t *)(stream + 1);
+    uint16_t fed = 0u;
+    uint16_t to_copy;
+    json_rc_T rc = state->bestCaseRc;
+
+    while((fed < input_text_size)
+          && (rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE))
+    {
+        /*********************************************************************/
+        /* Drop what was consumed, then top the window up                    */
+        /*********************************************************************/
+        if(state->input.position > 0u)
+        {
+            MemMove (window,
+                     &window[state->input.position],
+                     state->input.dataBufSize - state->input.position);
+
+            state->input.dataBufSize -= state->input.position;
+            state->input.position = 0u;
+        }
+
+        if(state->input.dataBufSize == stream->windowSize)
+        {
+            return (JSON_RC__PARSING_BUFFER_SIZE_EXCEEDED);     /* A token larger than the window */
+        }
+
+        to_copy = stream->windowSize - state->input.dataBufSize;
+
+        if(to_copy > input_text_size - fed)
+        {
+            to_copy = input_text_size - fed;
+        }
+
+        MemCpy (&window[state->input.dataBufSize], &input_text[fed], to_copy);
+
+        state->input.dataBufSize += to_copy;
+        fed += to_copy;
+
+        if(state->input.dataBufSize > stream->peakWindowUsed)
+        {
+            stream->peakWindowUsed = state->input.dataBufSize;
+        }
+
+        rc = ParseStreamProcess (stream, false);
+    }
+
+    stream->textSize += fed;
+
+    return (rc);
+}
+
+/*****************************************************************************/
+json_rc_T ParseStreamEnd(_IO_ void *        stream_buf,
+                         __O uint16_t *      json_internal_size)
+{
+    parse_stream_cb_T *       stream = (parse_stream_cb_T *)stream_buf;
+    json_internal_header_T *  json_header =
+        (json_internal_header_T *)stream->state.output.dataBuf;
+    json_rc_T rc;
+
+    rc = ParseStreamProcess (stream, true);
+
+    *json_internal_size = json_header->currentSize;
+
+    if((rc > JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+       && (stream->state.stateID != STATE_END))
+    {
+        return (JSON_RC__PARSING_FAILURE);
+    }
+
+    return (rc);
+}
+
+/*****************************************************************************/
+void ParseStreamStats(_I_ void *        stream_buf,
+                      __O uint32_t *      text_size,
+                      __O uint16_t *      peak_window_used)
+{
+    const parse_stream_cb_T *   stream = (const parse_stream_cb_T *)stream_buf;
+
+    if (text_size != NULL)
+    {
+        *text_size = stream->textSize;
+    }
+    if (peak_window_used != NULL)
+    {
+        *peak_window_used = stream->peakWindowUsed;
+    }
+}
+
+#endif /* defined(ALLOW_PARSING__JSON) */
+/*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
@@ -1009,34 +1009,37 @@ json_rc_T FindLastExplicitlySpecifiedMember(
     _I_ property_table_entry__array_T *
     array_ptr)
 {
-    const property_table_entry_T *  after_default_member;
+    /* Walked as bytes, not through 'default_member': an entry pointer     */
+    /*   written through a byte pointer may be read back stale under the   */
+    /*   strict aliasing rules the optimizer applies.                       */
+    const uint8_t *  member_position;
+    const uint8_t *  after_default_member;
     uint8_t array_index;
     json_rc_T rc = JSON_RC__OK;
 
-    *default_member =
-        (const property_table_entry_T *)((const uint8_t *)array_ptr +
-                                         sizeof(*array_ptr));
+    member_position = (const uint8_t *)array_ptr + sizeof(*array_ptr);
+    *default_member = (const property_table_entry_T *)member_position;
 
     for(array_index = 0;
         array_index < array_ptr->membersCount_expectedByTemplate - 1;
         array_index++)
     {
         UpdateBestCaseRc (&rc,
-                          SkipPropertyTableEntry ((const uint8_t **)
-                                                  default_member,
+                          SkipPropertyTableEntry (&member_position,
                                                   SKIP_COMPLEX_OBJECTS));
 
         if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
         {
+            *default_member = (const property_table_entry_T *)member_position;
             return (rc);
         }
     }
 
-    after_default_member = *default_member;
+    *default_member = (const property_table_entry_T *)member_position;
+    after_default_member = member_position;
 
     UpdateBestCaseRc (&rc,
-                      SkipPropertyTableEntry ((const uint8_t **)&
-                                              after_default_member,
+                      SkipPropertyTableEntry (&after_default_member,
                                               SKIP_COMPLEX_OBJECTS));
 
     UpdateBestCaseRc (&rc,
@@ -1240,6 +1243,267 @@ void UpdateBestCaseRc(_IO_ json_rc_T *  best_case_rc,
     }
 }
 
+/*---------------------------------------------------------------------------*/
+void LookupWalkerInit(__O lookup_walker_T *   walker,
+                      _I_ uint8_t *            property_table,
+                      _I_ uint16_t property_table_size,
+                      _I_ bool is_template)
+{
+    walker->table = property_table;
+    walker->tableSize = property_table_size;
+    walker->position = 0;
+    walker->isTemplate = is_template;
+    walker->depth = 0;
+}
+
+/*****************************************************************************/
+/* Advances to the next property that has no array ancestor.                 */
+/* Returns JSON_RC__NOT_FOUND once the table is exhausted.                   */
+/*****************************************************************************/
+json_rc_T LookupWalkerNext(_IO_ lookup_walker_T *    walker,
+                           __O json_lookup_key_T *  key,
+                           __O uint16_t *            entry_offset)
+{
+    const property_table_entry_T *  property_table_entry;
+    const lookup_walker_node_T *    parent;
+    lookup_walker_node_T *          node;
+    const uint8_t *                   property_table_position;
+    bool is_indexed;
+    json_rc_T rc;
+
+    while(walker->position < walker->tableSize)
+    {
+        while((walker->depth > 0)  &&
+              (walker->position >=
+               walker->stack[walker->depth - 1].endPosition))
+        {
+            --walker->depth;
+        }
+
+        property_table_entry =
+            (const property_table_entry_T *)&walker->table[walker->position];
+
+        key->propertyHash = property_table_entry->common.propertyHash;
+
+        if(walker->depth == 0)
+        {
+            key->parentHash = JSON_LOOKUP__ROOT_PARENT (key->propertyHash);
+            is_indexed = true;
+        }
+        else
+        {
+            parent = &walker->stack[walker->depth - 1];
+
+            key->parentHash = parent->hash;
+            is_indexed = parent->isIndexed  &&  !parent->isArray;
+        }
+
+        *entry_offset = walker->position;
+
+        if(!IS_SINGLE_VALUE (property_table_entry->common.propertyType))
+        {
+            if(walker->depth >= JSON_MAXIMUM_NESTING)
+            {
+                return (JSON_RC__NESTING_EXCEEDED);
+            }
+
+            node = &walker->stack[walker->depth++];
+
+            node->endPosition = walker->position + COMPLEX_OBJECT_LENGTH (
+                property_table_entry->common.propertyType);
+            node->hash = key->propertyHash;
+            node->isArray =
+                IS_ARRAY (property_table_entry->common.propertyType);
+            node->isIndexed = is_indexed;
+        }
+
+        if(walker->isTemplate)
+        {
+            if(IS_ARRAY (property_table_entry->common.propertyType))
+            {
+                walker->position += sizeof(property_table_entry->array);
+            }
+            else
+            {
+                walker->position += sizeof(property_table_entry->common);
+            }
+        }
+        else
+        {
+            property_table_position = (const uint8_t *)property_table_entry;
+
+            rc = SkipPropertyTableEntry (&property_table_position,
+                                         GO_INTO_COMPLEX_OBJECTS);
+
+            if(rc < JSON_RC__RECOVERABLE_ERROR__MINIMUM_VALUE)
+            {
+                return (rc);
+            }
+
+            walker->position =
+                (uint16_t)(property_table_position - walker->table);
+        }
+
+        if(is_indexed)
+        {
+            return (JSON_RC__OK);
+        }
+    }
+
+    return (JSON_RC__NOT_FOUND);
+}
+
+/*****************************************************************************/
+uint16_t LookupHash(_I_ json_lookup_key_T * key,
+                    _I_ uint16_t seed,
+                    _I_ uint16_t mask)
+{
+    uint32_t mix = ((uint32_t)key->parentHash << 16) | key->propertyHash;
+
+    mix ^= (uint32_t)seed * 0x9E3779B1uL;
+    mix ^= mix >> 16;
+    mix *= 0x85EBCA6BuL;
+    mix ^= mix >> 13;
+    mix *= 0xC2B2AE35uL;
+    mix ^= mix >> 16;
+
+    return ((uint16_t)(mix & mask));
+}
+
+/*****************************************************************************/
+uint16_t LookupSize(_I_ json_lookup_header_T * lookup)
+{
+    return ((uint16_t)(sizeof(*lookup)
+                       + lookup->bucketsCount * sizeof(uint16_t)
+                       + lookup->slotsCount * sizeof(json_lookup_key_T)));
+}
+
+/*****************************************************************************/
+static _INLINE_ uint16_t LookupSlot(_I_ json_lookup_header_T *   lookup,
+                                    _I_ json_lookup_key_T *      key)
+{
+    const uint16_t *  displacements = (const uint16_t *)(lookup + 1);
+
+    return (LookupHash (key,
+                        displacements[LookupHash (key, 0,
+                                                  lookup->bucketsCount - 1u)],
+                        lookup->slotsCount - 1u));
+}
+
+/*****************************************************************************/
+/* Re-takes the offset of every indexed property after the table was         */
+/* (re)initialized or an array grew.  A property the lookup doesn't know     */
+/* means it was compiled for another template:  It is detached then.         */
+/*****************************************************************************/
+static json_rc_T RefreshLookupOffsets(_IO_ json_internal_header_T *  header)
+{
+    json_lookup_cb_T *            lookup_cb = header->lookupCb;
+    const json_lookup_header_T *  lookup = lookup_cb->lookup;
+    const json_lookup_key_T *     keys =
+        (const json_lookup_key_T *)((const uint16_t *)(lookup + 1)
+                                    + lookup->bucketsCount);
+    uint16_t *                      offsets = (uint16_t *)(lookup_cb + 1);
+    lookup_walker_T walker;
+    json_lookup_key_T key;
+    uint16_t entry_offset;
+    uint16_t slot;
+    json_rc_T rc;
+
+    for(slot = 0; slot < lookup->slotsCount; slot++)
+    {
+        offsets[slot] = JSON_LOOKUP__NO_OFFSET;
+    }
+
+    LookupWalkerInit (&walker,
+                      (const uint8_t *)(header + 1),
+                      header->propertyTableSize,
+                      false);
+
+    while((rc = LookupWalkerNext (&walker, &key, &entry_offset)) == JSON_RC__OK)
+    {
+        slot = LookupSlot (lookup, &key);
+
+        if((keys[slot].propertyHash != key.propertyHash)  ||
+           (keys[slot].parentHash != key.parentHash))
+        {
+            rc = JSON_RC__UNEXPECTED_ERROR;
+
+            break;
+        }
+
+        offsets[slot] = entry_offset;
+    }
+
+    if(rc != JSON_RC__NOT_FOUND)
+    {
+        header->lookupCb = NULL;
+
+        return (JSON_RC__NOT_SUPPORTED);
+    }
+
+    lookup_cb->propertyTableSize = header->propertyTableSize;
+
+    return (JSON_RC__OK);
+}
+
+/*****************************************************************************/
+/* O(1) alternative to walking the table for a property that has no array    */
+/* ancestor.  JSON_RC__NOT_SUPPORTED - no usable lookup, walk the table.     */
+/*****************************************************************************/
+json_rc_T FindPropertyByLookup(
+    __O const property_table_entry_T * *    found_property,
+    _I_ void *                               json_internal,
+    _I_ uint16_t sought_hash,
+    _I_ uint16_t parent_hash)
+{
+    json_internal_header_T *      header =
+        (json_internal_header_T *)json_internal;                /* Losing 'const'.  Only the lookup's own state is refreshed */
+    const json_lookup_header_T *  lookup;
+    const json_lookup_key_T *     keys;
+    const uint16_t *                offsets;
+    json_lookup_key_T key;
+    uint16_t slot;
+    json_rc_T rc;
+
+    if(header->lookupCb == NULL)
+    {
+        return (JSON_RC__NOT_SUPPORTED);
+    }
+
+    if(header->lookupCb->propertyTableSize != header->propertyTableSize)
+    {
+        rc = RefreshLookupOffsets (header);
+
+        if(rc != JSON_RC__OK)
+        {
+            return (rc);
+        }
+    }
+
+    lookup = header->lookupCb->lookup;
+    keys = (const json_lookup_key_T *)((const uint16_t *)(lookup + 1)
+                                       + lookup->bucketsCount);
+    offsets = (const uint16_t *)(header->lookupCb + 1);
+
+    key.propertyHash = sought_hash;
+    key.parentHash = parent_hash;
+
+    slot = LookupSlot (lookup, &key);
+
+    if((keys[slot].propertyHash != sought_hash)  ||
+       (keys[slot].parentHash != parent_hash)  ||
+       (offsets[slot] == JSON_LOOKUP__NO_OFFSET))
+    {
+        return (JSON_RC__NOT_FOUND);
+    }
+
+    *found_property =
+        (const property_table_entry_T *)((const uint8_t *)(header + 1)
+                                         + offsets[slot]);
+
+    return (JSON_RC__OK);
+}
+
 /*---------------------------------------------------------------------------*/
 #if defined(ALLOW_PARSING__TEMPLATE)
 
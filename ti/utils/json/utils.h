@@ -113,6 +113,24 @@ typedef struct  in_data_stream_cb_TAG
     uint16_t position;
 } in_data_stream_cb_T;
 
+typedef struct  lookup_walker_node_TAG
+{
+    uint16_t endPosition;
+    uint16_t hash;
+    bool isArray;
+    bool isIndexed;
+} lookup_walker_node_T;
+
+typedef struct  lookup_walker_TAG
+{
+    const uint8_t *table;
+    uint16_t tableSize;
+    uint16_t position;
+    bool isTemplate;
+    uint16_t depth;
+    lookup_walker_node_T stack[JSON_MAXIMUM_NESTING];
+} lookup_walker_T;
+
 #ifdef USE__STANDARD_LIBS
     #ifdef _MSC_VER
         #pragma warning(disable:4001)   /* nonstandard extension 'single line comment' was used */
@@ -265,6 +283,28 @@ json_rc_T EnsureArrayAccomodatesIndex(
 
 void UpdateBestCaseRc(_IO_ json_rc_T *best_case_rc,
                       _I_ json_rc_T new_rc);
+
+void LookupWalkerInit(__O lookup_walker_T *walker,
+                      _I_ uint8_t *property_table,
+                      _I_ uint16_t property_table_size,
+                      _I_ bool is_template);
+
+json_rc_T LookupWalkerNext(_IO_ lookup_walker_T *walker,
+                           __O json_lookup_key_T *key,
+                           __O uint16_t *entry_offset);
+
+uint16_t LookupHash(_I_ json_lookup_key_T *key,
+                    _I_ uint16_t seed,
+                    _I_ uint16_t mask);
+
+uint16_t LookupSize(_I_ json_lookup_header_T *lookup);
+
+json_rc_T FindPropertyByLookup(
+    __O const property_table_entry_T **found_property,
+    _I_ void *json_internal,
+    _I_ uint16_t sought_hash,
+    _I_ uint16_t parent_hash);
+
 uint8_t SizeOfTemplateEntry(_I_ uint16_t property_type);
 
 